@@ -8,6 +8,10 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#if defined(__unix__) || defined(__APPLE__)
+#  include <sys/uio.h>
+#endif
+
 #if !defined(MEM_DISABLE_ASAN)
 #  if defined(__SANITIZE_ADDRESS__)
 #    if defined(_MSC_VER) && !defined(__clang__)
@@ -55,13 +59,215 @@ MEM_API size_t MemFind(const void* ptr, size_t size, uint8_t value);
 // returns first offset of byte not equal to "value", or "size" if not found
 MEM_API size_t MemFindNot(const void* ptr, size_t size, uint8_t value);
 
+// returns last offset of "value" byte, or "size" if not found
+MEM_API size_t MemFindLast(const void* ptr, size_t size, uint8_t value);
+
+// returns last offset of byte not equal to "value", or "size" if not found
+MEM_API size_t MemFindLastNot(const void* ptr, size_t size, uint8_t value);
+
+// returns first offset of any byte from "set" array with "setlen" bytes, or "size" if not found
+MEM_API size_t MemFindAny(const void* ptr, size_t size, const void* set, size_t setlen);
+
+// returns first offset of "needle" array with "needlelen" bytes, or "size" if not found
+// empty needle is found at offset 0
+MEM_API size_t MemFindBytes(const void* ptr, size_t size, const void* needle, size_t needlelen);
+
+// returns count of "value" bytes
+MEM_API size_t MemCount(const void* ptr, size_t size, uint8_t value);
+
+// returns offset of first byte that is different in ptr1 and ptr2, or "size" if all bytes are equal
+MEM_API size_t MemMismatch(const void* ptr1, const void* ptr2, size_t size);
+
+// returns length of common prefix of ptr1 with size1 bytes and ptr2 with size2 bytes
+MEM_API size_t MemCommonPrefix(const void* ptr1, size_t size1, const void* ptr2, size_t size2);
+
+// converts ASCII letters to lowercase, writing "size" bytes from src to dst
+// dst can be the same as src for in-place conversion, otherwise buffers must not overlap
+MEM_API void MemToLower(void* dst, const void* src, size_t size);
+
+// same as above, but converts ASCII letters to uppercase
+MEM_API void MemToUpper(void* dst, const void* src, size_t size);
+
+// same as MemFind, but case insensitive for ASCII characters
+MEM_API size_t MemFindI(const void* ptr, size_t size, uint8_t value);
+
+// same as MemFindBytes, but case insensitive for ASCII characters
+MEM_API size_t MemFindBytesI(const void* ptr, size_t size, const void* needle, size_t needlelen);
+
+// returns index of first byte in [lo, hi] range (inclusive), or size if not found
+MEM_API size_t MemFindInRange(const void* ptr, size_t size, uint8_t lo, uint8_t hi);
+
+// returns index of first byte outside of [lo, hi] range (inclusive), or size if all bytes are inside it
+MEM_API size_t MemFindNotInRange(const void* ptr, size_t size, uint8_t lo, uint8_t hi);
+
+// returns index of first byte of first invalid or truncated UTF-8 sequence, or size if whole buffer is valid UTF-8
+// overlong encodings, surrogates and values above U+10FFFF are invalid
+MEM_API size_t MemValidateUTF8(const void* ptr, size_t size);
+
+// for every 64-byte block writes 64-bit mask to masks array, with bit set for every byte that is in set
+// masks array must have space for (size + 63) / 64 entries, bits past the end of buffer are 0
+MEM_API void MemClassify(const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks);
+
+// returns index of first 16/32/64-bit element equal to value, or count if not found
+// count is number of elements, ptr does not need to be aligned to element size
+MEM_API size_t MemFind16(const void* ptr, size_t count, uint16_t value);
+MEM_API size_t MemFind32(const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemFind64(const void* ptr, size_t count, uint64_t value);
+
+// returns index of first 16/32/64-bit element not equal to value, or count if all elements are equal to it
+MEM_API size_t MemFindNot16(const void* ptr, size_t count, uint16_t value);
+MEM_API size_t MemFindNot32(const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemFindNot64(const void* ptr, size_t count, uint64_t value);
+
+// returns index of first 32/64-bit element that is not less than value in array sorted in ascending order, or count if all elements are less
+// count is number of elements, ptr does not need to be aligned to element size
+MEM_API size_t MemLowerBound32(const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemLowerBound64(const void* ptr, size_t count, uint64_t value);
+
+// replaces every byte of src with table[byte] and writes result to dst, dst can be same as src
+MEM_API void MemTranslate(void* dst, const void* src, size_t size, const uint8_t table[256]);
+
+// returns 64-bit hash of bytes, it is fast but not suitable for cryptographic purposes
+// seed value changes hash result, result is the same with every instruction set
+MEM_API uint64_t MemHash64(const void* ptr, size_t size, uint64_t seed);
+
+// pair of buffers with same size for batched functions below
+typedef struct
+{
+    const void* ptr1;
+    const void* ptr2;
+    size_t size;
+}
+MemPair;
+
+// same as MemIsEqual for each of "count" pairs, sets results[i] to 1 if buffers of pairs[i] are equal, or 0 if not
+// much faster than separate calls when comparing many short buffers
+MEM_API void MemIsEqualBatch(const MemPair* pairs, size_t count, uint8_t* results);
+
+// same as MemCompare for each of "count" pairs, writes comparison result of pairs[i] to results[i]
+MEM_API void MemCompareBatch(const MemPair* pairs, size_t count, int* results);
+
+// same as MemIsEqual, but execution time depends only on size and not on contents of buffers
+// use it for comparing secret values like MAC tags or tokens, as it does not exit early on first difference
+MEM_API bool MemIsEqualConstTime(const void* ptr1, const void* ptr2, size_t size);
+
+// max needle length for streaming search below
+#define MEM_SEARCH_MAX_NEEDLE 64
+
+// state for searching needle in stream of data that arrives in multiple chunks
+// keeps last "needlelen - 1" bytes of previous chunks, so match can start in one chunk and end in next one
+typedef struct
+{
+    const void* needle;
+    size_t needlelen;
+    uint64_t offset; // count of stream bytes consumed so far
+    size_t tailsize;
+    uint8_t tail[MEM_SEARCH_MAX_NEEDLE - 1];
+}
+MemSearchState;
+
+// initializes state for searching "needle" with "needlelen" bytes, needlelen must be in [1, MEM_SEARCH_MAX_NEEDLE] range
+// for needlelen outside of this range state never finds a match
+// needle is not copied, its memory must stay valid while state is used
+MEM_API void MemSearchInit(MemSearchState* state, const void* needle, size_t needlelen);
+
+// continues search with next "size" bytes of stream, returns offset in ptr right after end of first match, or 0 if not found
+// match can start in bytes from previous calls, its offset in whole stream is "state->offset - needlelen" after return
+// search continues after end of match, pass bytes after returned offset to next call to find next match
+MEM_API size_t MemSearchNext(MemSearchState* state, const void* ptr, size_t size);
+
+// buffer segment for scatter-gather functions below, this is "struct iovec" on POSIX systems
+// so arrays from readv or io_uring can be passed directly, on other systems it has same member names
+#if defined(__unix__) || defined(__APPLE__)
+typedef struct iovec MemSegment;
+#else
+typedef struct
+{
+    void* iov_base;
+    size_t iov_len;
+}
+MemSegment;
+#endif
+
+// position of byte in array of segments
+typedef struct
+{
+    size_t segment;
+    size_t offset;
+}
+MemPosition;
+
+// same as MemFind for bytes of "count" segments, returns segment index and offset in it of first "value" byte
+// or position with segment index equal to "count" and offset 0 if not found
+MEM_API MemPosition MemFindV(const MemSegment* segments, size_t count, uint8_t value);
+
+// returns true if bytes of "count1" segments are the same as bytes of "count2" segments
+// segments can have different sizes, only total size and bytes in them are compared
+MEM_API bool MemIsEqualV(const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2);
 
-// use functions below directly if you want to avoid dynamic dispatch (only relevant on x64)
+#if defined(MEM_PARALLEL)
+
+// functions below are available only when MEM_PARALLEL is defined, they use pthreads or Win32 threads
+// there is no thread pool, every call creates its worker threads and waits for them to finish before returning
+// buffer is split into cache line aligned chunks that worker threads process with functions above
+// "threads" is max count of threads to use including calling thread, 0 means count of CPU cores
+// every thread gets at least one 256KB chunk, so small buffers are processed on calling thread only
+
+// same as MemFind, once match is found, chunks after it are not processed anymore
+MEM_API size_t MemFindParallel(const void* ptr, size_t size, uint8_t value, size_t threads);
+
+// same as MemCount
+MEM_API size_t MemCountParallel(const void* ptr, size_t size, uint8_t value, size_t threads);
+
+#endif
+
+// on x64 and on arm64 Linux with SVE every function above checks cpuid flags on each call, on x64 define one of these
+// together with MEM_STATIC or MEM_IMPLEMENTATION to select implementation only once:
+//   MEM_DISPATCH_IFUNC - GNU ifunc resolved by dynamic loader at startup, Linux with GCC or Clang only
+//   MEM_DISPATCH_TABLE - table of function pointers filled by constructor before main
+
+// instruction sets, only x64 and arm64 on Linux select between them at runtime
+#define MEM_ISA_SSE2   (1 << 0)
+#define MEM_ISA_AVX2   (1 << 1)
+#define MEM_ISA_AVX512 (1 << 2)
+#define MEM_ISA_NEON   (1 << 3)
+#define MEM_ISA_RVV    (1 << 4)
+#define MEM_ISA_AVX10  (1 << 5)
+#define MEM_ISA_SVE    (1 << 6)
+
+// returns bitmask of MEM_ISA_* instruction sets supported by CPU, 0 if only generic implementation is available
+// MEM_ISA_AVX512 is reported without AVX512VBMI too, then few functions use avx2 implementation
+// MEM_ISA_SVE is reported together with MEM_ISA_NEON, without SVE2 MemFindAny uses neon implementation
+MEM_API int MemGetFeatures(void);
+
+// returns MEM_ISA_* instruction set currently used by functions above, 0 for generic implementation
+MEM_API int MemGetISA(void);
+
+// limits functions above to "isa" and older instruction sets, 0 restores automatic selection
+// initial preference can be set with MEMFUN_ISA environment variable to "sse2", "avx2", "avx10" or "avx512"
+// on x64, or to "neon" or "sve" on arm64
+// for testing "avx512bw" selects avx512 without AVX512VBMI, same as on Skylake-SP or Cascade Lake CPUs
+// MEM_ISA_AVX10 is between MEM_ISA_AVX2 and MEM_ISA_AVX512, on AVX-512 CPUs it selects 256-bit EVEX code
+// returns false if "isa" is not supported by CPU, or selection is fixed when instruction sets are enabled
+// at compile time (-mavx2, -march=armv8-a+sve or similar) or with MEM_DISPATCH_IFUNC, which reads only environment variable
+// call it before other threads use functions above
+MEM_API bool MemSetPreferredISA(int isa);
+
+
+// use functions below directly if you want to avoid dynamic dispatch (only relevant on x64 and arm64 with SVE)
+// _avx2 functions need AVX2, _avx512 functions need AVX512F, AVX512BW, BMI1 and BMI2
+// _avx512 functions of MemFindAny, MemClassify and MemTranslate also need AVX512VBMI
+// _avx10 functions need AVX10 with 256-bit vectors (or AVX512F, AVX512BW and AVX512VL), BMI1 and BMI2
+// _avx10 functions exist only for MemCompare, MemIsEqual, MemFind*, MemCount and MemMismatch, others use avx2 implementation
+// _sve functions need SVE, they exist only for MemCompare, MemIsEqual, MemFind*, MemCount and MemMismatch, others use neon implementation
+// _sve function of MemFindAny also needs SVE2
 
 MEM_API int MemCompare_sse2   (const void* ptr1, const void* ptr2, size_t size);
 MEM_API int MemCompare_avx2   (const void* ptr1, const void* ptr2, size_t size);
+MEM_API int MemCompare_avx10  (const void* ptr1, const void* ptr2, size_t size);
 MEM_API int MemCompare_avx512 (const void* ptr1, const void* ptr2, size_t size);
 MEM_API int MemCompare_neon   (const void* ptr1, const void* ptr2, size_t size);
+MEM_API int MemCompare_sve    (const void* ptr1, const void* ptr2, size_t size);
 MEM_API int MemCompare_rvv    (const void* ptr1, const void* ptr2, size_t size);
 MEM_API int MemCompare_generic(const void* ptr1, const void* ptr2, size_t size);
 
@@ -74,25 +280,243 @@ MEM_API int MemCompareI_generic(const void* ptr1, const void* ptr2, size_t size)
 
 MEM_API bool MemIsEqual_sse2   (const void* ptr1, const void* ptr2, size_t size);
 MEM_API bool MemIsEqual_avx2   (const void* ptr1, const void* ptr2, size_t size);
+MEM_API bool MemIsEqual_avx10  (const void* ptr1, const void* ptr2, size_t size);
 MEM_API bool MemIsEqual_avx512 (const void* ptr1, const void* ptr2, size_t size);
 MEM_API bool MemIsEqual_neon   (const void* ptr1, const void* ptr2, size_t size);
+MEM_API bool MemIsEqual_sve    (const void* ptr1, const void* ptr2, size_t size);
 MEM_API bool MemIsEqual_rvv    (const void* ptr1, const void* ptr2, size_t size);
 MEM_API bool MemIsEqual_generic(const void* ptr1, const void* ptr2, size_t size);
 
 MEM_API size_t MemFind_sse2   (const void* ptr, size_t size, uint8_t value);
 MEM_API size_t MemFind_avx2   (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFind_avx10  (const void* ptr, size_t size, uint8_t value);
 MEM_API size_t MemFind_avx512 (const void* ptr, size_t size, uint8_t value);
 MEM_API size_t MemFind_neon   (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFind_sve    (const void* ptr, size_t size, uint8_t value);
 MEM_API size_t MemFind_rvv    (const void* ptr, size_t size, uint8_t value);
 MEM_API size_t MemFind_generic(const void* ptr, size_t size, uint8_t value);
 
 MEM_API size_t MemFindNot_sse2   (const void* ptr, size_t size, uint8_t value);
 MEM_API size_t MemFindNot_avx2   (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindNot_avx10  (const void* ptr, size_t size, uint8_t value);
 MEM_API size_t MemFindNot_avx512 (const void* ptr, size_t size, uint8_t value);
 MEM_API size_t MemFindNot_neon   (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindNot_sve    (const void* ptr, size_t size, uint8_t value);
 MEM_API size_t MemFindNot_rvv    (const void* ptr, size_t size, uint8_t value);
 MEM_API size_t MemFindNot_generic(const void* ptr, size_t size, uint8_t value);
 
+MEM_API size_t MemFindLast_sse2   (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindLast_avx2   (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindLast_avx10  (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindLast_avx512 (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindLast_neon   (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindLast_sve    (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindLast_rvv    (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindLast_generic(const void* ptr, size_t size, uint8_t value);
+
+MEM_API size_t MemFindLastNot_sse2   (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindLastNot_avx2   (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindLastNot_avx10  (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindLastNot_avx512 (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindLastNot_neon   (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindLastNot_sve    (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindLastNot_rvv    (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindLastNot_generic(const void* ptr, size_t size, uint8_t value);
+
+MEM_API size_t MemFindAny_sse2   (const void* ptr, size_t size, const void* set, size_t setlen);
+MEM_API size_t MemFindAny_avx2   (const void* ptr, size_t size, const void* set, size_t setlen);
+MEM_API size_t MemFindAny_avx512 (const void* ptr, size_t size, const void* set, size_t setlen);
+MEM_API size_t MemFindAny_neon   (const void* ptr, size_t size, const void* set, size_t setlen);
+MEM_API size_t MemFindAny_sve    (const void* ptr, size_t size, const void* set, size_t setlen);
+MEM_API size_t MemFindAny_rvv    (const void* ptr, size_t size, const void* set, size_t setlen);
+MEM_API size_t MemFindAny_generic(const void* ptr, size_t size, const void* set, size_t setlen);
+
+MEM_API size_t MemFindBytes_sse2   (const void* ptr, size_t size, const void* needle, size_t needlelen);
+MEM_API size_t MemFindBytes_avx2   (const void* ptr, size_t size, const void* needle, size_t needlelen);
+MEM_API size_t MemFindBytes_avx512 (const void* ptr, size_t size, const void* needle, size_t needlelen);
+MEM_API size_t MemFindBytes_neon   (const void* ptr, size_t size, const void* needle, size_t needlelen);
+MEM_API size_t MemFindBytes_rvv    (const void* ptr, size_t size, const void* needle, size_t needlelen);
+MEM_API size_t MemFindBytes_generic(const void* ptr, size_t size, const void* needle, size_t needlelen);
+
+MEM_API size_t MemCount_sse2   (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemCount_avx2   (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemCount_avx10  (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemCount_avx512 (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemCount_neon   (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemCount_sve    (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemCount_rvv    (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemCount_generic(const void* ptr, size_t size, uint8_t value);
+
+MEM_API size_t MemMismatch_sse2   (const void* ptr1, const void* ptr2, size_t size);
+MEM_API size_t MemMismatch_avx2   (const void* ptr1, const void* ptr2, size_t size);
+MEM_API size_t MemMismatch_avx10  (const void* ptr1, const void* ptr2, size_t size);
+MEM_API size_t MemMismatch_avx512 (const void* ptr1, const void* ptr2, size_t size);
+MEM_API size_t MemMismatch_neon   (const void* ptr1, const void* ptr2, size_t size);
+MEM_API size_t MemMismatch_sve    (const void* ptr1, const void* ptr2, size_t size);
+MEM_API size_t MemMismatch_rvv    (const void* ptr1, const void* ptr2, size_t size);
+MEM_API size_t MemMismatch_generic(const void* ptr1, const void* ptr2, size_t size);
+
+MEM_API void MemToLower_sse2   (void* dst, const void* src, size_t size);
+MEM_API void MemToLower_avx2   (void* dst, const void* src, size_t size);
+MEM_API void MemToLower_avx512 (void* dst, const void* src, size_t size);
+MEM_API void MemToLower_neon   (void* dst, const void* src, size_t size);
+MEM_API void MemToLower_rvv    (void* dst, const void* src, size_t size);
+MEM_API void MemToLower_generic(void* dst, const void* src, size_t size);
+
+MEM_API void MemToUpper_sse2   (void* dst, const void* src, size_t size);
+MEM_API void MemToUpper_avx2   (void* dst, const void* src, size_t size);
+MEM_API void MemToUpper_avx512 (void* dst, const void* src, size_t size);
+MEM_API void MemToUpper_neon   (void* dst, const void* src, size_t size);
+MEM_API void MemToUpper_rvv    (void* dst, const void* src, size_t size);
+MEM_API void MemToUpper_generic(void* dst, const void* src, size_t size);
+
+MEM_API size_t MemFindI_sse2   (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindI_avx2   (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindI_avx512 (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindI_neon   (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindI_rvv    (const void* ptr, size_t size, uint8_t value);
+MEM_API size_t MemFindI_generic(const void* ptr, size_t size, uint8_t value);
+
+MEM_API size_t MemFindBytesI_sse2   (const void* ptr, size_t size, const void* needle, size_t needlelen);
+MEM_API size_t MemFindBytesI_avx2   (const void* ptr, size_t size, const void* needle, size_t needlelen);
+MEM_API size_t MemFindBytesI_avx512 (const void* ptr, size_t size, const void* needle, size_t needlelen);
+MEM_API size_t MemFindBytesI_neon   (const void* ptr, size_t size, const void* needle, size_t needlelen);
+MEM_API size_t MemFindBytesI_rvv    (const void* ptr, size_t size, const void* needle, size_t needlelen);
+MEM_API size_t MemFindBytesI_generic(const void* ptr, size_t size, const void* needle, size_t needlelen);
+
+MEM_API size_t MemFindInRange_sse2   (const void* ptr, size_t size, uint8_t lo, uint8_t hi);
+MEM_API size_t MemFindInRange_avx2   (const void* ptr, size_t size, uint8_t lo, uint8_t hi);
+MEM_API size_t MemFindInRange_avx512 (const void* ptr, size_t size, uint8_t lo, uint8_t hi);
+MEM_API size_t MemFindInRange_neon   (const void* ptr, size_t size, uint8_t lo, uint8_t hi);
+MEM_API size_t MemFindInRange_rvv    (const void* ptr, size_t size, uint8_t lo, uint8_t hi);
+MEM_API size_t MemFindInRange_generic(const void* ptr, size_t size, uint8_t lo, uint8_t hi);
+
+MEM_API size_t MemFindNotInRange_sse2   (const void* ptr, size_t size, uint8_t lo, uint8_t hi);
+MEM_API size_t MemFindNotInRange_avx2   (const void* ptr, size_t size, uint8_t lo, uint8_t hi);
+MEM_API size_t MemFindNotInRange_avx512 (const void* ptr, size_t size, uint8_t lo, uint8_t hi);
+MEM_API size_t MemFindNotInRange_neon   (const void* ptr, size_t size, uint8_t lo, uint8_t hi);
+MEM_API size_t MemFindNotInRange_rvv    (const void* ptr, size_t size, uint8_t lo, uint8_t hi);
+MEM_API size_t MemFindNotInRange_generic(const void* ptr, size_t size, uint8_t lo, uint8_t hi);
+
+MEM_API size_t MemValidateUTF8_sse2   (const void* ptr, size_t size);
+MEM_API size_t MemValidateUTF8_avx2   (const void* ptr, size_t size);
+MEM_API size_t MemValidateUTF8_avx512 (const void* ptr, size_t size);
+MEM_API size_t MemValidateUTF8_neon   (const void* ptr, size_t size);
+MEM_API size_t MemValidateUTF8_rvv    (const void* ptr, size_t size);
+MEM_API size_t MemValidateUTF8_generic(const void* ptr, size_t size);
+
+MEM_API void MemClassify_sse2   (const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks);
+MEM_API void MemClassify_avx2   (const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks);
+MEM_API void MemClassify_avx512 (const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks);
+MEM_API void MemClassify_neon   (const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks);
+MEM_API void MemClassify_rvv    (const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks);
+MEM_API void MemClassify_generic(const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks);
+
+MEM_API size_t MemFind16_sse2   (const void* ptr, size_t count, uint16_t value);
+MEM_API size_t MemFind16_avx2   (const void* ptr, size_t count, uint16_t value);
+MEM_API size_t MemFind16_avx512 (const void* ptr, size_t count, uint16_t value);
+MEM_API size_t MemFind16_neon   (const void* ptr, size_t count, uint16_t value);
+MEM_API size_t MemFind16_rvv    (const void* ptr, size_t count, uint16_t value);
+MEM_API size_t MemFind16_generic(const void* ptr, size_t count, uint16_t value);
+
+MEM_API size_t MemFind32_sse2   (const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemFind32_avx2   (const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemFind32_avx512 (const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemFind32_neon   (const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemFind32_rvv    (const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemFind32_generic(const void* ptr, size_t count, uint32_t value);
+
+MEM_API size_t MemFind64_sse2   (const void* ptr, size_t count, uint64_t value);
+MEM_API size_t MemFind64_avx2   (const void* ptr, size_t count, uint64_t value);
+MEM_API size_t MemFind64_avx512 (const void* ptr, size_t count, uint64_t value);
+MEM_API size_t MemFind64_neon   (const void* ptr, size_t count, uint64_t value);
+MEM_API size_t MemFind64_rvv    (const void* ptr, size_t count, uint64_t value);
+MEM_API size_t MemFind64_generic(const void* ptr, size_t count, uint64_t value);
+
+MEM_API size_t MemFindNot16_sse2   (const void* ptr, size_t count, uint16_t value);
+MEM_API size_t MemFindNot16_avx2   (const void* ptr, size_t count, uint16_t value);
+MEM_API size_t MemFindNot16_avx512 (const void* ptr, size_t count, uint16_t value);
+MEM_API size_t MemFindNot16_neon   (const void* ptr, size_t count, uint16_t value);
+MEM_API size_t MemFindNot16_rvv    (const void* ptr, size_t count, uint16_t value);
+MEM_API size_t MemFindNot16_generic(const void* ptr, size_t count, uint16_t value);
+
+MEM_API size_t MemFindNot32_sse2   (const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemFindNot32_avx2   (const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemFindNot32_avx512 (const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemFindNot32_neon   (const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemFindNot32_rvv    (const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemFindNot32_generic(const void* ptr, size_t count, uint32_t value);
+
+MEM_API size_t MemFindNot64_sse2   (const void* ptr, size_t count, uint64_t value);
+MEM_API size_t MemFindNot64_avx2   (const void* ptr, size_t count, uint64_t value);
+MEM_API size_t MemFindNot64_avx512 (const void* ptr, size_t count, uint64_t value);
+MEM_API size_t MemFindNot64_neon   (const void* ptr, size_t count, uint64_t value);
+MEM_API size_t MemFindNot64_rvv    (const void* ptr, size_t count, uint64_t value);
+MEM_API size_t MemFindNot64_generic(const void* ptr, size_t count, uint64_t value);
+
+MEM_API size_t MemLowerBound32_sse2   (const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemLowerBound32_avx2   (const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemLowerBound32_avx512 (const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemLowerBound32_neon   (const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemLowerBound32_rvv    (const void* ptr, size_t count, uint32_t value);
+MEM_API size_t MemLowerBound32_generic(const void* ptr, size_t count, uint32_t value);
+
+MEM_API size_t MemLowerBound64_sse2   (const void* ptr, size_t count, uint64_t value);
+MEM_API size_t MemLowerBound64_avx2   (const void* ptr, size_t count, uint64_t value);
+MEM_API size_t MemLowerBound64_avx512 (const void* ptr, size_t count, uint64_t value);
+MEM_API size_t MemLowerBound64_neon   (const void* ptr, size_t count, uint64_t value);
+MEM_API size_t MemLowerBound64_rvv    (const void* ptr, size_t count, uint64_t value);
+MEM_API size_t MemLowerBound64_generic(const void* ptr, size_t count, uint64_t value);
+
+MEM_API void MemTranslate_sse2   (void* dst, const void* src, size_t size, const uint8_t table[256]);
+MEM_API void MemTranslate_avx2   (void* dst, const void* src, size_t size, const uint8_t table[256]);
+MEM_API void MemTranslate_avx512 (void* dst, const void* src, size_t size, const uint8_t table[256]);
+MEM_API void MemTranslate_neon   (void* dst, const void* src, size_t size, const uint8_t table[256]);
+MEM_API void MemTranslate_rvv    (void* dst, const void* src, size_t size, const uint8_t table[256]);
+MEM_API void MemTranslate_generic(void* dst, const void* src, size_t size, const uint8_t table[256]);
+
+MEM_API uint64_t MemHash64_sse2   (const void* ptr, size_t size, uint64_t seed);
+MEM_API uint64_t MemHash64_avx2   (const void* ptr, size_t size, uint64_t seed);
+MEM_API uint64_t MemHash64_avx512 (const void* ptr, size_t size, uint64_t seed);
+MEM_API uint64_t MemHash64_neon   (const void* ptr, size_t size, uint64_t seed);
+MEM_API uint64_t MemHash64_rvv    (const void* ptr, size_t size, uint64_t seed);
+MEM_API uint64_t MemHash64_generic(const void* ptr, size_t size, uint64_t seed);
+
+MEM_API void MemIsEqualBatch_sse2   (const MemPair* pairs, size_t count, uint8_t* results);
+MEM_API void MemIsEqualBatch_avx2   (const MemPair* pairs, size_t count, uint8_t* results);
+MEM_API void MemIsEqualBatch_avx512 (const MemPair* pairs, size_t count, uint8_t* results);
+MEM_API void MemIsEqualBatch_neon   (const MemPair* pairs, size_t count, uint8_t* results);
+MEM_API void MemIsEqualBatch_rvv    (const MemPair* pairs, size_t count, uint8_t* results);
+MEM_API void MemIsEqualBatch_generic(const MemPair* pairs, size_t count, uint8_t* results);
+
+MEM_API void MemCompareBatch_sse2   (const MemPair* pairs, size_t count, int* results);
+MEM_API void MemCompareBatch_avx2   (const MemPair* pairs, size_t count, int* results);
+MEM_API void MemCompareBatch_avx512 (const MemPair* pairs, size_t count, int* results);
+MEM_API void MemCompareBatch_neon   (const MemPair* pairs, size_t count, int* results);
+MEM_API void MemCompareBatch_rvv    (const MemPair* pairs, size_t count, int* results);
+MEM_API void MemCompareBatch_generic(const MemPair* pairs, size_t count, int* results);
+
+MEM_API bool MemIsEqualConstTime_sse2   (const void* ptr1, const void* ptr2, size_t size);
+MEM_API bool MemIsEqualConstTime_avx2   (const void* ptr1, const void* ptr2, size_t size);
+MEM_API bool MemIsEqualConstTime_avx512 (const void* ptr1, const void* ptr2, size_t size);
+MEM_API bool MemIsEqualConstTime_neon   (const void* ptr1, const void* ptr2, size_t size);
+MEM_API bool MemIsEqualConstTime_rvv    (const void* ptr1, const void* ptr2, size_t size);
+MEM_API bool MemIsEqualConstTime_generic(const void* ptr1, const void* ptr2, size_t size);
+
+MEM_API MemPosition MemFindV_sse2   (const MemSegment* segments, size_t count, uint8_t value);
+MEM_API MemPosition MemFindV_avx2   (const MemSegment* segments, size_t count, uint8_t value);
+MEM_API MemPosition MemFindV_avx512 (const MemSegment* segments, size_t count, uint8_t value);
+MEM_API MemPosition MemFindV_neon   (const MemSegment* segments, size_t count, uint8_t value);
+MEM_API MemPosition MemFindV_rvv    (const MemSegment* segments, size_t count, uint8_t value);
+MEM_API MemPosition MemFindV_generic(const MemSegment* segments, size_t count, uint8_t value);
+
+MEM_API bool MemIsEqualV_sse2   (const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2);
+MEM_API bool MemIsEqualV_avx2   (const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2);
+MEM_API bool MemIsEqualV_avx512 (const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2);
+MEM_API bool MemIsEqualV_neon   (const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2);
+MEM_API bool MemIsEqualV_rvv    (const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2);
+MEM_API bool MemIsEqualV_generic(const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2);
+
 
 #ifdef __cplusplus
 }
@@ -123,12 +547,18 @@ MEM_API size_t MemFindNot_generic(const void* ptr, size_t size, uint8_t value);
 #elif defined(__aarch64__) || defined(_M_ARM64)
 #  define MEM_ARCH_ARM64 1
 #  include <arm_neon.h>
+// SVE is detected at runtime only on Linux, GCC before 14 and Clang before 18 cannot use SVE intrinsics in functions
+// with target attribute, so with them SVE is used only when it is enabled for whole program
+#  if defined(__linux__) && (defined(__ARM_FEATURE_SVE) || (MEM_COMPILER_CLANG && __clang_major__ >= 18) || (MEM_COMPILER_GCC && __GNUC__ >= 14))
+#    define MEM_ARCH_SVE 1
+#    include <arm_sve.h>
+#  endif
 #elif defined(__riscv) && __riscv_v >= 1000000
 #  define MEM_ARCH_RVV 1
 #  include <riscv_vector.h>
 #endif
 
-// cpuid, only for x64
+// cpuid, only for x64 and for SVE on arm64
 #if MEM_ARCH_X64
 #  if MEM_COMPILER_CLANG || MEM_COMPILER_GCC
 #    include <cpuid.h>
@@ -144,6 +574,44 @@ MEM_API size_t MemFindNot_generic(const void* ptr, size_t size, uint8_t value);
 #    define MEM_GET32_RELAXED(ptr)        __iso_volatile_load32(ptr)
 #    define MEM_SET32_RELAXED(ptr, value) __iso_volatile_store32(ptr, value)
 #  endif
+#elif MEM_ARCH_SVE
+#  include <sys/auxv.h>
+#  if !defined(HWCAP_SVE)
+#    define HWCAP_SVE (1 << 22)
+#  endif
+#  if !defined(HWCAP2_SVE2)
+#    define HWCAP2_SVE2 (1 << 1)
+#  endif
+#  define MEM_GET32_RELAXED(ptr)        __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#  define MEM_SET32_RELAXED(ptr, value) __atomic_store_n(ptr, value, __ATOMIC_RELAXED)
+#endif
+
+// environment variable with preferred instruction set, only for x64 and for SVE on arm64
+#if MEM_ARCH_X64 && defined(MEM_DISPATCH_IFUNC)
+#  include <fcntl.h>
+#  include <sys/syscall.h>
+#elif MEM_ARCH_X64 || MEM_ARCH_SVE
+#  include <stdlib.h>
+#endif
+
+// threads & atomics, only for parallel functions
+#if defined(MEM_PARALLEL)
+#  if defined(_WIN32)
+#    include <windows.h>
+#  else
+#    include <pthread.h>
+#    include <unistd.h>
+#  endif
+// MEM_ATOMIC_CMPXCHG64 returns value observed in memory, new value is stored only if observed one was equal to cmp
+#  if MEM_COMPILER_CLANG || MEM_COMPILER_GCC
+#    define MEM_ATOMIC_ADD64(ptr, value)           __atomic_fetch_add(ptr, value, __ATOMIC_RELAXED)
+#    define MEM_ATOMIC_GET64(ptr)                  __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#    define MEM_ATOMIC_CMPXCHG64(ptr, cmp, value)  __extension__({ uint64_t mem_expected = (cmp); __atomic_compare_exchange_n(ptr, &mem_expected, value, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED); mem_expected; })
+#  elif MEM_COMPILER_MSVC
+#    define MEM_ATOMIC_ADD64(ptr, value)           (uint64_t)_InterlockedExchangeAdd64((volatile long long*)(ptr), (long long)(value))
+#    define MEM_ATOMIC_GET64(ptr)                  (uint64_t)__iso_volatile_load64((const volatile long long*)(ptr))
+#    define MEM_ATOMIC_CMPXCHG64(ptr, cmp, value)  (uint64_t)_InterlockedCompareExchange64((volatile long long*)(ptr), (long long)(value), (long long)(cmp))
+#  endif
 #endif
 
 // unaligned memory access
@@ -156,12 +624,16 @@ typedef struct { uint64_t value; } MemUnalignedPtr64;
 #define MEM_PTR64U(ptr) (((MemUnalignedPtr64*)(ptr))->value)
 #pragma pack(pop)
 
-// big-endian load, only for x64, compiles to movbe
+// big-endian load, only for x64, compiles to movbe when it is available
 #if MEM_ARCH_X64
-#  if MEM_COMPILER_MSVC
+#  if MEM_COMPILER_MSVC && defined(__AVX2__)
 #    define MEM_GET16BE(ptr) _load_be_u16(ptr)
 #    define MEM_GET32BE(ptr) _load_be_u32(ptr)
 #    define MEM_GET64BE(ptr) _load_be_u64(ptr)
+#  elif MEM_COMPILER_MSVC
+#    define MEM_GET16BE(ptr) _byteswap_ushort(MEM_PTR16U(ptr))
+#    define MEM_GET32BE(ptr) _byteswap_ulong(MEM_PTR32U(ptr))
+#    define MEM_GET64BE(ptr) _byteswap_uint64(MEM_PTR64U(ptr))
 #  elif MEM_COMPILER_CLANG || MEM_COMPILER_GCC
 #    define MEM_GET16BE(ptr) __builtin_bswap16(MEM_PTR16U(ptr))
 #    define MEM_GET32BE(ptr) __builtin_bswap32(MEM_PTR32U(ptr))
@@ -192,24 +664,93 @@ typedef struct { uint64_t value; } MemUnalignedPtr64;
 #  endif
 #endif
 
-// shrx for x64
+// index of highest bit set, input must be non-zero
+#if MEM_COMPILER_CLANG || MEM_COMPILER_GCC
+#  define MEM_BSR32(x) (size_t)(31 - __builtin_clz(x))
+#  define MEM_BSR64(x) (size_t)(63 - __builtin_clzll(x))
+#elif MEM_COMPILER_MSVC
+static inline size_t MemBitScanReverse32(uint32_t x) { unsigned long index; _BitScanReverse(&index, x); return index; }
+static inline size_t MemBitScanReverse64(uint64_t x) { unsigned long index; _BitScanReverse64(&index, x); return index; }
+#  define MEM_BSR32(x) MemBitScanReverse32(x)
+#  define MEM_BSR64(x) MemBitScanReverse64(x)
+#endif
+
+// population count
+#if MEM_COMPILER_CLANG || MEM_COMPILER_GCC
+#  define MEM_POPCNT32(x) (size_t)__builtin_popcount(x)
+#  define MEM_POPCNT64(x) (size_t)__builtin_popcountll(x)
+#elif MEM_COMPILER_MSVC
+// popcnt instruction is not guaranteed to be available on all CPUs
+static inline size_t MemPopCount64(uint64_t x)
+{
+    x = x - ((x >> 1) & 0x5555555555555555);
+    x = (x & 0x3333333333333333) + ((x >> 2) & 0x3333333333333333);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0f;
+    return (size_t)((x * 0x0101010101010101) >> 56);
+}
+#  define MEM_POPCNT32(x) MemPopCount64(x)
+#  define MEM_POPCNT64(x) MemPopCount64(x)
+#endif
+
+// prefetch memory for reading
+#if MEM_COMPILER_CLANG || MEM_COMPILER_GCC
+#  define MEM_PREFETCH(ptr) __builtin_prefetch(ptr)
+#elif MEM_COMPILER_MSVC && MEM_ARCH_X64
+#  define MEM_PREFETCH(ptr) _mm_prefetch((const char*)(ptr), _MM_HINT_T0)
+#elif MEM_COMPILER_MSVC && MEM_ARCH_ARM64
+#  define MEM_PREFETCH(ptr) __prefetch(ptr)
+#else
+#  define MEM_PREFETCH(ptr) ((void)(ptr))
+#endif
+
+// shrx for x64, MSVC emits BMI2 instruction only when it is enabled for whole program
 #if MEM_ARCH_X64
-#  if MEM_COMPILER_MSVC
+#  if MEM_COMPILER_MSVC && defined(__AVX2__)
 #    define MEM_SHRX_32(x, n)   _shrx_u32(x, n)
-#  elif MEM_COMPILER_CLANG || MEM_COMPILER_GCC
+#  else
 #    define MEM_SHRX_32(x, n)   ((x) >> (n))
 #  endif
 #endif
 
+// tzcnt and bzhi for x64, avx2 kernels use these instead of BMI intrinsics to run on CPUs without BMI
+// compilers emit tzcnt and bzhi instructions for them when BMI is enabled
+#if MEM_ARCH_X64
+static inline uint32_t MemTzcnt32(uint32_t x) { return x ? (uint32_t)MEM_CTZ32(x) : 32; }
+static inline uint64_t MemTzcnt64(uint64_t x) { return x ? (uint64_t)MEM_CTZ64(x) : 64; }
+static inline uint32_t MemBzhi32(uint32_t x, uint32_t n) { return n < 32 ? x & ((1U << n) - 1) : x; }
+static inline uint64_t MemBzhi64(uint64_t x, uint32_t n) { return n < 64 ? x & ((1ULL << n) - 1) : x; }
+#  define MEM_TZCNT32(x)    MemTzcnt32(x)
+#  define MEM_TZCNT64(x)    MemTzcnt64(x)
+#  define MEM_BZHI32(x, n)  MemBzhi32(x, n)
+#  define MEM_BZHI64(x, n)  MemBzhi64(x, n)
+#endif
+
 // x64 function attributes
 #if MEM_ARCH_X64 && (MEM_COMPILER_CLANG || MEM_COMPILER_GCC)
 #  define MEM_TARGET_XSAVE  __attribute__((target("xsave")))
-#  define MEM_TARGET_AVX2   __attribute__((target("avx2,bmi,bmi2,movbe")))
-#  define MEM_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vbmi,bmi,bmi2")))
+#  define MEM_TARGET_AVX2       __attribute__((target("avx2")))
+#  define MEM_TARGET_AVX512     __attribute__((target("avx512f,avx512bw,bmi,bmi2")))
+#  define MEM_TARGET_AVX512VBMI __attribute__((target("avx512f,avx512bw,avx512vbmi,bmi,bmi2")))
+// AVX10/256 has same instructions as AVX512VL with AVX512BW, older compilers do not know avx10 target
+#  define MEM_TARGET_AVX10      __attribute__((target("avx512f,avx512bw,avx512vl,bmi,bmi2")))
 #else
 #  define MEM_TARGET_XSAVE
 #  define MEM_TARGET_AVX2
 #  define MEM_TARGET_AVX512
+#  define MEM_TARGET_AVX512VBMI
+#  define MEM_TARGET_AVX10
+#endif
+
+// arm64 function attributes, not needed when SVE is enabled for whole program
+#if MEM_ARCH_SVE && !defined(__ARM_FEATURE_SVE)
+#  define MEM_TARGET_SVE  __attribute__((target("+sve")))
+#else
+#  define MEM_TARGET_SVE
+#endif
+#if MEM_ARCH_SVE && !defined(__ARM_FEATURE_SVE2)
+#  define MEM_TARGET_SVE2 __attribute__((target("+sve2")))
+#else
+#  define MEM_TARGET_SVE2
 #endif
 
 #if MEM_COMPILER_MSVC
@@ -224,6 +765,13 @@ static inline uint8_t MemToLower1(uint8_t x)
     return (uint8_t)(x - 'A') <= ('Z' - 'A') ? (x + 'a' - 'A') : x;
 }
 
+// returns 0x20 for ASCII letters, or 0 for other bytes
+// or'ing it into input byte and letter makes them equal only for both cases of same letter
+static inline uint8_t MemCaseBit1(uint8_t x)
+{
+    return (uint8_t)((x | 0x20) - 'a') <= ('z' - 'a') ? 0x20 : 0x00;
+}
+
 static inline uint64_t MemToLower8(uint64_t x)
 {
     const uint64_t splat = ~0ULL / 255;
@@ -235,260 +783,613 @@ static inline uint64_t MemToLower8(uint64_t x)
     return x | (is_upper >> 2);
 }
 
+// returns offset of first byte that is different for 0 < size <= 16, without reading past the end of buffers
+static inline size_t MemMismatchSmall(const uint8_t* p1, const uint8_t* p2, size_t size)
+{
+    if (size < 2) // size == 1
+    {
+        return p1[0] == p2[0] ? 1 : 0;
+    }
 
-#if MEM_ARCH_X64
+    // will load pair of 2, 4 or 8 overlapping bytes
+    // a/b0 from beginning of buffer
+    // a/b1 from end of buffers
+    uint64_t a0, b0, a1, b1;
+    size_t width;
 
-static inline __m128i MemToLower16(__m128i x)
-{
-    __m128i tmp = _mm_sub_epi8(x, _mm_set1_epi8('A' - 128));
-    tmp = _mm_cmpgt_epi8(tmp, _mm_set1_epi8('Z' - 'A' - 128));
-    tmp = _mm_andnot_si128(tmp, _mm_set1_epi8('a' - 'A'));
-    return _mm_add_epi8(x, tmp);
+    if (size < 4) // 2 <= size < 4
+    {
+        a0 = MEM_PTR16U(p1);
+        b0 = MEM_PTR16U(p2);
+        a1 = MEM_PTR16U(p1 + size - 2);
+        b1 = MEM_PTR16U(p2 + size - 2);
+        width = 2;
+    }
+    else if (size < 8) // 4 <= size < 8
+    {
+        a0 = MEM_PTR32U(p1);
+        b0 = MEM_PTR32U(p2);
+        a1 = MEM_PTR32U(p1 + size - 4);
+        b1 = MEM_PTR32U(p2 + size - 4);
+        width = 4;
+    }
+    else // 8 <= size <= 16
+    {
+        a0 = MEM_PTR64U(p1);
+        b0 = MEM_PTR64U(p2);
+        a1 = MEM_PTR64U(p1 + size - 8);
+        b1 = MEM_PTR64U(p2 + size - 8);
+        width = 8;
+    }
+
+    // in little-endian first different byte is lowest non-zero byte of xor
+    uint64_t x0 = a0 ^ b0;
+    uint64_t x1 = a1 ^ b1;
+
+    if (x0)
+    {
+        return MEM_CTZ64(x0) / 8;
+    }
+    else if (x1)
+    {
+        return MEM_CTZ64(x1) / 8 + size - width;
+    }
+    return size;
 }
 
-MEM_TARGET_AVX2
-static inline __m256i MemToLower32(__m256i x)
+// flips ASCII case of letters in [first, first + 'Z' - 'A'] range, first is either 'A' or 'a'
+static inline uint64_t MemConvertCase8(uint64_t x, uint8_t first)
 {
-    __m256i tmp = _mm256_sub_epi8(x, _mm256_set1_epi8('A' - 128));
-    tmp = _mm256_cmpgt_epi8(tmp, _mm256_set1_epi8('Z' - 'A' - 128));
-    tmp = _mm256_andnot_si256(tmp, _mm256_set1_epi8('a' - 'A'));
-    return _mm256_add_epi8(x, tmp);
+    const uint64_t splat = ~0ULL / 255;
+    uint64_t heptets = x & (0x7F * splat);
+    uint64_t is_ascii = ~x & (0x80 * splat);
+    uint64_t is_gt_last = heptets + (uint64_t)(0x7F - (first + 'Z' - 'A')) * splat;
+    uint64_t is_ge_first = heptets + (uint64_t)(0x80 - first) * splat;
+    uint64_t is_letter = (is_ge_first ^ is_gt_last) & is_ascii;
+    return x ^ (is_letter >> 2);
 }
 
-MEM_TARGET_AVX512
-static inline __m512i MemToLower64(__m512i x)
+// converts case for 0 < size < 16, without reading or writing past the end of buffers
+static inline void MemConvertCaseSmall(uint8_t* dst, const uint8_t* src, size_t size, uint8_t first)
 {
-#if 0 // version without VBMI
-    __m512i tmp = _mm512_sub_epi8(x, _mm512_set1_epi8('A'));
-    __mmask64 mask = _mm512_cmple_epu8_mask(tmp, _mm512_set1_epi8('Z' - 'A'));
-    return _mm512_mask_add_epi8(x, mask, x, _mm512_set1_epi8('a' - 'A'));
-#else
-    static const uint8_t table[] =
+    // loads pair of 2, 4 or 8 overlapping bytes before storing anything, so dst can be same as src
+    if (size >= 8) // 8 <= size < 16
     {
-        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
-        0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
-        0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f,
-        0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f,
-        0x40,  'a',  'b',  'c',  'd',  'e',  'f',  'g',  'h',  'i',  'j',  'k',  'l',  'm',  'n',  'o',
-         'p',  'q',  'r',  's',  't',  'u',  'v',  'w',  'x',  'y',  'z', 0x5b, 0x5c, 0x5d, 0x5e, 0x5f,
-        0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f,
-        0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x7b, 0x7c, 0x7d, 0x7e, 0x7f,
-    };
-    const __m512i c0 = _mm512_loadu_epi8(table + 0x00);
-    const __m512i c1 = _mm512_loadu_epi8(table + 0x40);
-    __mmask64 mask = _mm512_cmplt_epu8_mask(x, _mm512_set1_epi8((char)0x80));
-    return _mm512_mask2_permutex2var_epi8(c0, x, mask, c1);
-#endif
+        uint64_t a0 = MEM_PTR64U(src);
+        uint64_t a1 = MEM_PTR64U(src + size - 8);
+        MEM_PTR64U(dst) = MemConvertCase8(a0, first);
+        MEM_PTR64U(dst + size - 8) = MemConvertCase8(a1, first);
+    }
+    else if (size >= 4) // 4 <= size < 8
+    {
+        uint64_t a0 = MEM_PTR32U(src);
+        uint64_t a1 = MEM_PTR32U(src + size - 4);
+        uint64_t a = MemConvertCase8(a0 | (a1 << 32), first);
+        MEM_PTR32U(dst) = (uint32_t)a;
+        MEM_PTR32U(dst + size - 4) = (uint32_t)(a >> 32);
+    }
+    else if (size >= 2) // 2 <= size < 4
+    {
+        uint64_t a0 = MEM_PTR16U(src);
+        uint64_t a1 = MEM_PTR16U(src + size - 2);
+        uint64_t a = MemConvertCase8(a0 | (a1 << 16), first);
+        MEM_PTR16U(dst) = (uint16_t)a;
+        MEM_PTR16U(dst + size - 2) = (uint16_t)(a >> 16);
+    }
+    else if (size) // size == 1
+    {
+        dst[0] = (uint8_t)MemConvertCase8(src[0], first);
+    }
 }
 
-
-MEM_DISABLE_ASAN
-int MemCompare_sse2(const void* ptr1, const void* ptr2, size_t size)
+// UTF-8 validation with lookup tables from "Validating UTF-8 In Less Than One Instruction Per Byte"
+// by John Keiser and Daniel Lemire, each bit is one kind of error for pair of previous and current byte
+// error is present only when bit is set in lookups of all three nibbles
+#define MEM_UTF8_TOO_SHORT  (1 << 0) // lead byte followed by another lead byte or ASCII
+#define MEM_UTF8_TOO_LONG   (1 << 1) // ASCII followed by continuation byte
+#define MEM_UTF8_OVERLONG_3 (1 << 2) // 3 byte sequence for value that fits in 2 bytes
+#define MEM_UTF8_TOO_LARGE  (1 << 3) // 4 byte sequence for value above U+10FFFF
+#define MEM_UTF8_SURROGATE  (1 << 4) // 3 byte sequence for value in U+D800..U+DFFF range
+#define MEM_UTF8_OVERLONG_2 (1 << 5) // 2 byte sequence for value that fits in 1 byte
+#define MEM_UTF8_TOO_LARGE2 (1 << 6) // 4 byte sequence with lead byte 0xf5 or above
+#define MEM_UTF8_OVERLONG_4 (1 << 6) // 4 byte sequence for value that fits in 3 bytes
+#define MEM_UTF8_TWO_CONTS  (1 << 7) // two continuation bytes, valid only for 3rd and 4th byte
+#define MEM_UTF8_CARRY      (MEM_UTF8_TOO_SHORT | MEM_UTF8_TOO_LONG | MEM_UTF8_TWO_CONTS)
+
+// indexed by high nibble of previous byte
+static const uint8_t MemUTF8Byte1High[16] =
 {
-    const uint8_t* p1 = (const uint8_t*)ptr1;
-    const uint8_t* p2 = (const uint8_t*)ptr2;
+    // 0___ ASCII
+    MEM_UTF8_TOO_LONG, MEM_UTF8_TOO_LONG, MEM_UTF8_TOO_LONG, MEM_UTF8_TOO_LONG,
+    MEM_UTF8_TOO_LONG, MEM_UTF8_TOO_LONG, MEM_UTF8_TOO_LONG, MEM_UTF8_TOO_LONG,
+    // 10__ continuation
+    MEM_UTF8_TWO_CONTS, MEM_UTF8_TWO_CONTS, MEM_UTF8_TWO_CONTS, MEM_UTF8_TWO_CONTS,
+    // 1100 and 1101 two byte lead
+    MEM_UTF8_TOO_SHORT | MEM_UTF8_OVERLONG_2,
+    MEM_UTF8_TOO_SHORT,
+    // 1110 three byte lead
+    MEM_UTF8_TOO_SHORT | MEM_UTF8_OVERLONG_3 | MEM_UTF8_SURROGATE,
+    // 1111 four byte lead
+    MEM_UTF8_TOO_SHORT | MEM_UTF8_TOO_LARGE | MEM_UTF8_TOO_LARGE2 | MEM_UTF8_OVERLONG_4,
+};
+
+// indexed by low nibble of previous byte
+static const uint8_t MemUTF8Byte1Low[16] =
+{
+    MEM_UTF8_CARRY | MEM_UTF8_OVERLONG_3 | MEM_UTF8_OVERLONG_2 | MEM_UTF8_OVERLONG_4,
+    MEM_UTF8_CARRY | MEM_UTF8_OVERLONG_2,
+    MEM_UTF8_CARRY,
+    MEM_UTF8_CARRY,
+    MEM_UTF8_CARRY | MEM_UTF8_TOO_LARGE,
+    MEM_UTF8_CARRY | MEM_UTF8_TOO_LARGE | MEM_UTF8_TOO_LARGE2,
+    MEM_UTF8_CARRY | MEM_UTF8_TOO_LARGE | MEM_UTF8_TOO_LARGE2,
+    MEM_UTF8_CARRY | MEM_UTF8_TOO_LARGE | MEM_UTF8_TOO_LARGE2,
+    MEM_UTF8_CARRY | MEM_UTF8_TOO_LARGE | MEM_UTF8_TOO_LARGE2,
+    MEM_UTF8_CARRY | MEM_UTF8_TOO_LARGE | MEM_UTF8_TOO_LARGE2,
+    MEM_UTF8_CARRY | MEM_UTF8_TOO_LARGE | MEM_UTF8_TOO_LARGE2,
+    MEM_UTF8_CARRY | MEM_UTF8_TOO_LARGE | MEM_UTF8_TOO_LARGE2,
+    MEM_UTF8_CARRY | MEM_UTF8_TOO_LARGE | MEM_UTF8_TOO_LARGE2,
+    MEM_UTF8_CARRY | MEM_UTF8_TOO_LARGE | MEM_UTF8_TOO_LARGE2 | MEM_UTF8_SURROGATE,
+    MEM_UTF8_CARRY | MEM_UTF8_TOO_LARGE | MEM_UTF8_TOO_LARGE2,
+    MEM_UTF8_CARRY | MEM_UTF8_TOO_LARGE | MEM_UTF8_TOO_LARGE2,
+};
+
+// indexed by high nibble of current byte
+static const uint8_t MemUTF8Byte2High[16] =
+{
+    // 0___ ASCII
+    MEM_UTF8_TOO_SHORT, MEM_UTF8_TOO_SHORT, MEM_UTF8_TOO_SHORT, MEM_UTF8_TOO_SHORT,
+    MEM_UTF8_TOO_SHORT, MEM_UTF8_TOO_SHORT, MEM_UTF8_TOO_SHORT, MEM_UTF8_TOO_SHORT,
+    // 1000 continuation
+    MEM_UTF8_TOO_LONG | MEM_UTF8_OVERLONG_2 | MEM_UTF8_TWO_CONTS | MEM_UTF8_OVERLONG_3 | MEM_UTF8_TOO_LARGE2 | MEM_UTF8_OVERLONG_4,
+    // 1001 continuation
+    MEM_UTF8_TOO_LONG | MEM_UTF8_OVERLONG_2 | MEM_UTF8_TWO_CONTS | MEM_UTF8_OVERLONG_3 | MEM_UTF8_TOO_LARGE,
+    // 101_ continuation
+    MEM_UTF8_TOO_LONG | MEM_UTF8_OVERLONG_2 | MEM_UTF8_TWO_CONTS | MEM_UTF8_SURROGATE | MEM_UTF8_TOO_LARGE,
+    MEM_UTF8_TOO_LONG | MEM_UTF8_OVERLONG_2 | MEM_UTF8_TWO_CONTS | MEM_UTF8_SURROGATE | MEM_UTF8_TOO_LARGE,
+    // 11__ lead
+    MEM_UTF8_TOO_SHORT, MEM_UTF8_TOO_SHORT, MEM_UTF8_TOO_SHORT, MEM_UTF8_TOO_SHORT,
+};
+
+// last bytes of block greater than these values start sequence that must continue in next block
+static const uint8_t MemUTF8Incomplete[64] =
+{
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf0 - 1, 0xe0 - 1, 0xc0 - 1,
+};
+
+// returns length of valid UTF-8 sequence at start of buffer, or 0 if it is invalid or truncated
+static inline size_t MemUTF8Sequence(const uint8_t* p, size_t size)
+{
+    uint8_t lead = p[0];
+    if (lead < 0x80)
+    {
+        return 1;
+    }
 
-    if (size == 0)
+    // range of second byte depends on lead byte, this rejects overlong encodings, surrogates and values above U+10FFFF
+    size_t length;
+    uint8_t lo = 0x80;
+    uint8_t hi = 0xbf;
+    if (lead < 0xc2)
+    {
+        return 0;
+    }
+    else if (lead < 0xe0)
+    {
+        length = 2;
+    }
+    else if (lead < 0xf0)
+    {
+        length = 3;
+        lo = lead == 0xe0 ? 0xa0 : 0x80;
+        hi = lead == 0xed ? 0x9f : 0xbf;
+    }
+    else if (lead < 0xf5)
+    {
+        length = 4;
+        lo = lead == 0xf0 ? 0x90 : 0x80;
+        hi = lead == 0xf4 ? 0x8f : 0xbf;
+    }
+    else
     {
         return 0;
     }
 
-    if (size <= 16)
+    if (size < length || p[1] < lo || p[1] > hi)
     {
-        const uint32_t PAGE_SIZE = 4096;
+        return 0;
+    }
 
-        // if 16 bytes from each pointer does not cross page boundary, can safely load them as 16-byte vector
-        uint32_t address = (uint32_t)(uintptr_t)p1 | (uint32_t)(uintptr_t)p2;
-        if ((address & (PAGE_SIZE - 1)) <= PAGE_SIZE - 16)
+    for (size_t i=2; i<length; i++)
+    {
+        if ((p[i] & 0xc0) != 0x80)
         {
-            __m128i a0 = _mm_loadu_si128((const __m128i*)p1);
-            __m128i b0 = _mm_loadu_si128((const __m128i*)p2);
-
-            // set lanes to 0xff if bytes are equal, or 0x00 if not
-            __m128i r0 = _mm_cmpeq_epi8(a0, b0);
-
-            // extract top bit of each lane to mask
-            // it will have bit value 0 in positions where bytes are not equal
-            // adding 1 will flip lowest bit with value 0 to value 1
-            // and change all bits with value 1 below it to 0
-            uint32_t m = 1U + (uint16_t)_mm_movemask_epi8(r0);
+            return 0;
+        }
+    }
 
-            // get index of byte that's different, m is guaranteed non-zero, because there are only max 16 bytes here
-            size_t index = MEM_CTZ32(m);
+    return length;
+}
 
-            // return comparison result, or 0 if inputs are equal
-            return index < size ? p1[index] - p2[index] : 0;
-        }
+// returns how many of "offset" bytes before p belong to last sequence before p, which may continue past p
+// used only when all bytes before p are known to be valid UTF-8, except for last sequence not finishing
+static inline size_t MemUTF8Back(const uint8_t* p, size_t offset)
+{
+    size_t back = 0;
 
-        // cannot overread buffers, need to load exactly "size" bytes only
+    // step back over at most 3 continuation bytes, and then lead byte of sequence
+    while (back < 3 && back < offset && (*(p - back - 1) & 0xc0) == 0x80)
+    {
+        back++;
+    }
+    if (back < offset && *(p - back - 1) >= 0xc0)
+    {
+        back++;
+    }
 
-        if (size < 2) // size == 1
-        {
-            return p1[0] - p2[0];
-        }
+    return back;
+}
 
-        // will load pair of 4, 8 or 16 overlapping bytes
-        // a/b0 from beginning of buffer
-        // a/b1 from end of buffers
-        uint64_t a0, b0, a1, b1;
+// branchless binary search in sorted array of 32-bit or 64-bit elements, count must be >= window
+// returns start of "window" elements that contain first element >= value, all elements before it are less than value
+static inline size_t MemLowerBoundWindow(const uint8_t* p, size_t count, uint64_t value, size_t width, size_t window)
+{
+    size_t base = 0;
+    size_t n = count;
 
-        if (size < 4) // 2 <= size < 4
-        {
-            a0 = MEM_PTR16U(p1);
-            b0 = MEM_PTR16U(p2);
-            a1 = MEM_PTR16U(p1 + size - 2);
-            b1 = MEM_PTR16U(p2 + size - 2);
-        }
-        else if (size < 8) // 4 <= size < 8
-        {
-            a0 = MEM_PTR32U(p1);
-            b0 = MEM_PTR32U(p2);
-            a1 = MEM_PTR32U(p1 + size - 4);
-            b1 = MEM_PTR32U(p2 + size - 4);
-        }
-        else // 8 <= size <= 16
-        {
-            a0 = MEM_PTR64U(p1);
-            b0 = MEM_PTR64U(p2);
-            a1 = MEM_PTR64U(p1 + size - 8);
-            b1 = MEM_PTR64U(p2 + size - 8);
-        }
+    while (n > window)
+    {
+        size_t half = n / 2;
+        size_t next = (n - half) / 2;
 
-        // use a0/b0 if they are not equal, otherwise a1/b1
-        // byte swap because in big-endian bytes can be compared as uint64 numbers
-        uint64_t a = MEM_BSWAP64(a0 != b0 ? a0 : a1);
-        uint64_t b = MEM_BSWAP64(a0 != b0 ? b0 : b1);
+        // prefetch middle element for both possible halves of next step
+        MEM_PREFETCH(p + (base + next) * width);
+        MEM_PREFETCH(p + (base + half + next) * width);
 
-        return (a > b) - (a < b);
+        // compilers generate conditional move here
+        uint64_t element = width == 4 ? MEM_PTR32U(p + (base + half) * width) : MEM_PTR64U(p + (base + half) * width);
+        base = element < value ? base + half : base;
+        n -= half;
     }
 
-    // process 64-byte blocks as much as possible
-    while (size >= 64)
-    {
-        __m128i a0 = _mm_loadu_si128((const __m128i*)(p1 + 0x00));
-        __m128i b0 = _mm_loadu_si128((const __m128i*)(p2 + 0x00));
-        __m128i a1 = _mm_loadu_si128((const __m128i*)(p1 + 0x10));
-        __m128i b1 = _mm_loadu_si128((const __m128i*)(p2 + 0x10));
-        __m128i a2 = _mm_loadu_si128((const __m128i*)(p1 + 0x20));
-        __m128i b2 = _mm_loadu_si128((const __m128i*)(p2 + 0x20));
-        __m128i a3 = _mm_loadu_si128((const __m128i*)(p1 + 0x30));
-        __m128i b3 = _mm_loadu_si128((const __m128i*)(p2 + 0x30));
-
-        // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m128i r0 = _mm_cmpeq_epi8(a0, b0);
-        __m128i r1 = _mm_cmpeq_epi8(a1, b1);
-        __m128i r2 = _mm_cmpeq_epi8(a2, b2);
-        __m128i r3 = _mm_cmpeq_epi8(a3, b3);
+    // elements after first element >= value are also >= value, so window can be moved back to fit in array
+    return base < count - window ? base : count - window;
+}
 
-        // combine comparisons - leave 0x00 in all lanes that were not equal
-        __m128i r = _mm_and_si128(_mm_and_si128(r0, r1), _mm_and_si128(r2, r3));
+// random values for MemHash64, every part of hash uses different ones
+static const uint64_t MemHashSecret[32] =
+{
+    0x52ceb6ead580629d, 0x9768f514421c2b4a, 0xbd121f9fdcd3af34, 0xdfa7f29efacfb4dd,
+    0xc446e8dc4f1a056c, 0xafd4e60202dcc60d, 0xdf86a4f425b05d4e, 0xbffd40aaa274404d,
+    0xee0263ff04b8f62c, 0x125cb92e1810298d, 0x0909ad422e0bddaf, 0xccfa0210469ce4b9,
+    0x76c8a784fb508149, 0x79910c28dd4b53ef, 0x51c81e3e3e1dde99, 0x9258274726a32692,
+    0xe6e05331cd342bf5, 0x0c1aab9b68ce3569, 0xf14e108a099775d9, 0xbb7f6fb1dc92bb71,
+    0x39be589b3bf5b2f1, 0xe998e41babdede9f, 0xed874b6e69c2c156, 0x19e15df47549ee8b,
+    0x64447e9bb88a9453, 0x5fc65a64034b1c65, 0xd324e6221c6c9bb6, 0xc6700a4467426fec,
+    0x0ee95ab0354eefa0, 0xa8b787ca915a8e03, 0xcd998344c060b801, 0x509ba55cd28fcf58,
+};
+
+// multiplies two 64-bit values, and returns xor of low and high 64 bits of 128-bit result
+static inline uint64_t MemHashMulFold(uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+#elif MEM_COMPILER_MSVC && MEM_ARCH_X64
+    uint64_t hi;
+    uint64_t lo = _umul128(a, b, &hi);
+    return lo ^ hi;
+#elif MEM_COMPILER_MSVC && MEM_ARCH_ARM64
+    return (a * b) ^ __umulh(a, b);
+#else
+    // 128-bit result from four 32x32 bit products
+    uint64_t lolo = (a & 0xffffffff) * (b & 0xffffffff);
+    uint64_t hilo = (a >> 32) * (b & 0xffffffff);
+    uint64_t lohi = (a & 0xffffffff) * (b >> 32);
+    uint64_t hihi = (a >> 32) * (b >> 32);
+    uint64_t cross = (lolo >> 32) + (hilo & 0xffffffff) + lohi;
+    uint64_t hi = hihi + (hilo >> 32) + (cross >> 32);
+    uint64_t lo = (cross << 32) | (lolo & 0xffffffff);
+    return lo ^ hi;
+#endif
+}
 
-        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
-        uint16_t mask = 1 + (uint16_t)_mm_movemask_epi8(r);
-        if (mask)
-        {
-            // if mask is non-zero that means there is difference somewhere
-            // do the same thing as above, but for all r0/r1/r2/r3 comparisons
-            uint64_t m0 = (uint16_t)_mm_movemask_epi8(r0);
-            uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
-            uint64_t m2 = (uint16_t)_mm_movemask_epi8(r2);
-            uint64_t m3 = (uint16_t)_mm_movemask_epi8(r3);
-            uint64_t m4 = 1ULL + (m0 | (m1 << 16) | (m2 << 32) | (m3 << 48));
+// final mix of hash value, makes every input bit affect every output bit
+static inline uint64_t MemHashAvalanche(uint64_t h)
+{
+    h ^= h >> 37;
+    h *= 0x165667919e3779f9;
+    h ^= h >> 32;
+    return h;
+}
 
-            // m4 is guaranteed to be non-zero, extract index and return result
-            size_t index = MEM_CTZ64(m4);
-            return p1[index] - p2[index];
-        }
+// mixes input bytes of hash for size <= 16, lo and hi are zero padded to 16 bytes
+static MEM_FORCE_INLINE uint64_t MemHashSmallMix(uint64_t lo, uint64_t hi, size_t size, uint64_t seed)
+{
+    uint64_t a = lo ^ (MemHashSecret[0] + seed);
+    uint64_t b = hi ^ (MemHashSecret[1] - seed);
+    return MemHashAvalanche((uint64_t)size * 0x9e3779b185ebca87 + MEM_BSWAP64(a) + b + MemHashMulFold(a, b));
+}
 
-        size -= 64;
-        p1 += 64;
-        p2 += 64;
+// hash for size <= 16
+// loads 16 bytes at once if that does not cross page boundary, otherwise loads exactly "size" bytes
+MEM_DISABLE_ASAN
+static MEM_FORCE_INLINE uint64_t MemHashSmall(const uint8_t* p, size_t size, uint64_t seed)
+{
+    const uint32_t PAGE_SIZE = 4096;
+
+    // input bytes as two little-endian numbers, zero padded to 16 bytes
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+
+    if (size == 0)
+    {
+        // nothing to load, pointer may be NULL
     }
+    else if (((uint32_t)(uintptr_t)p & (PAGE_SIZE - 1)) <= PAGE_SIZE - 16)
+    {
+        lo = MEM_PTR64U(p);
+        hi = MEM_PTR64U(p + 8);
 
-    if (size & 32) // 32 <= size < 64
+        // clear bytes loaded past the end of buffer
+        lo = size < 8 ? lo & ((1ULL << (size * 8)) - 1) : lo;
+        hi = size > 8 ? hi & (~0ULL >> ((16 - size) * 8)) : 0;
+    }
+    else if (size >= 8) // 8 <= size <= 16
     {
-        // load 64 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
-        __m128i a0 = _mm_loadu_si128((const __m128i*)(p1 + 0x00));
-        __m128i b0 = _mm_loadu_si128((const __m128i*)(p2 + 0x00));
-        __m128i a1 = _mm_loadu_si128((const __m128i*)(p1 + 0x10));
-        __m128i b1 = _mm_loadu_si128((const __m128i*)(p2 + 0x10));
-        __m128i a2 = _mm_loadu_si128((const __m128i*)(p1 + size - 0x20));
-        __m128i b2 = _mm_loadu_si128((const __m128i*)(p2 + size - 0x20));
-        __m128i a3 = _mm_loadu_si128((const __m128i*)(p1 + size - 0x10));
-        __m128i b3 = _mm_loadu_si128((const __m128i*)(p2 + size - 0x10));
+        lo = MEM_PTR64U(p);
+        hi = size > 8 ? MEM_PTR64U(p + size - 8) >> ((16 - size) * 8) : 0;
+    }
+    else if (size >= 4) // 4 <= size < 8
+    {
+        // two overlapping loads, overlapping bytes are same in both
+        lo = MEM_PTR32U(p) | ((uint64_t)MEM_PTR32U(p + size - 4) << ((size - 4) * 8));
+    }
+    else // 1 <= size < 4
+    {
+        lo = p[0] | ((uint64_t)p[size / 2] << (size / 2 * 8)) | ((uint64_t)p[size - 1] << ((size - 1) * 8));
+    }
 
-        // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m128i r0 = _mm_cmpeq_epi8(a0, b0);
-        __m128i r1 = _mm_cmpeq_epi8(a1, b1);
-        __m128i r2 = _mm_cmpeq_epi8(a2, b2);
-        __m128i r3 = _mm_cmpeq_epi8(a3, b3);
+    return MemHashSmallMix(lo, hi, size, seed);
+}
 
-        // extract top bit masks
-        uint64_t m0 = (uint16_t)_mm_movemask_epi8(r0);
-        uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
-        uint64_t m2 = (uint16_t)_mm_movemask_epi8(r2);
-        uint64_t m3 = (uint16_t)_mm_movemask_epi8(r3);
+// hash for 16 < size <= 256, mixes every 16 bytes with different pair of secret values
+static inline uint64_t MemHashMedium(const uint8_t* p, size_t size, uint64_t seed)
+{
+    uint64_t acc = (uint64_t)size * 0x9e3779b185ebca87;
 
-        // combine masks, handling overlapped ones, flip lowest 0 bit to 1, changing all bits below it to 0
-        uint64_t m = 1ULL + (m0 | (m1 << 16) | (m2 << (size - 32)) | (m3 << (size - 16)));
+    // all 16-byte chunks before last 16 bytes, at most 15 of them
+    for (size_t i=0; i*16 + 16 < size; i++)
+    {
+        uint64_t a = MEM_PTR64U(p + i * 16 + 0) ^ (MemHashSecret[i + 0] + seed);
+        uint64_t b = MEM_PTR64U(p + i * 16 + 8) ^ (MemHashSecret[i + 1] - seed);
+        acc += MemHashMulFold(a, b);
+    }
 
-        // get index of byte that's different, m is guaranteed non-zero, because there only max 63 bytes here
-        size_t index = MEM_CTZ64(m);
+    // last 16 bytes, may overlap with previous chunk
+    uint64_t a = MEM_PTR64U(p + size - 16) ^ (MemHashSecret[16] + seed);
+    uint64_t b = MEM_PTR64U(p + size - 8) ^ (MemHashSecret[17] - seed);
+    acc += MemHashMulFold(a, b);
 
-        // return comparison result, or 0 if inputs are equal
-        return index < size ? p1[index] - p2[index] : 0;
+    return MemHashAvalanche(acc);
+}
+
+// merges 8 accumulators of long input into final hash
+static inline uint64_t MemHashMerge(const uint64_t acc[8], size_t size, uint64_t seed)
+{
+    uint64_t h = (uint64_t)size * 0x9e3779b185ebca87 + seed;
+    for (size_t i=0; i<8; i+=2)
+    {
+        h += MemHashMulFold(acc[i + 0] ^ MemHashSecret[i + 0], acc[i + 1] ^ MemHashSecret[i + 1]);
     }
-    else if (size & 16) // 16 <= size < 32
+    return MemHashAvalanche(h);
+}
+
+// prefetches buffers of pair that will be compared few iterations later
+// pointers are not dereferenced, they can be invalid or NULL, because prefetch does not fault
+static inline void MemPrefetchPair(const MemPair* pairs, size_t index, size_t count)
+{
+    if (index < count)
     {
-        // load 32 bytes, some will overlap
-        __m128i a0 = _mm_loadu_si128((const __m128i*)p1);
-        __m128i b0 = _mm_loadu_si128((const __m128i*)p2);
-        __m128i a1 = _mm_loadu_si128((const __m128i*)(p1 + size - 0x10));
-        __m128i b1 = _mm_loadu_si128((const __m128i*)(p2 + size - 0x10));
+        MEM_PREFETCH(pairs[index].ptr1);
+        MEM_PREFETCH(pairs[index].ptr2);
+    }
+}
 
-        // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m128i r0 = _mm_cmpeq_epi8(a0, b0);
-        __m128i r1 = _mm_cmpeq_epi8(a1, b1);
+// returns true if pair has 0 < size <= bytes, and "bytes" can be loaded from both pointers without crossing page boundary
+static inline bool MemBatchCanLoad(const MemPair* pair, uint32_t bytes)
+{
+    const uint32_t PAGE_SIZE = 4096;
 
-        // extract top bit masks
-        uint32_t m0 = (uint16_t)_mm_movemask_epi8(r0);
-        uint32_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+    // check each pointer separately, or'ing addresses together would fail too often for unrelated pointers
+    uint32_t offset1 = (uint32_t)(uintptr_t)pair->ptr1 & (PAGE_SIZE - 1);
+    uint32_t offset2 = (uint32_t)(uintptr_t)pair->ptr2 & (PAGE_SIZE - 1);
+    return (pair->size - 1 < bytes) & (offset1 <= PAGE_SIZE - bytes) & (offset2 <= PAGE_SIZE - bytes);
+}
 
-        // combine masks, handling overlapped ones, flip lowest 0 bit to 1, changing all bits below it to 0
-        uint32_t m = 1U + (m0 | (m1 << (size - 16)));
+// returns comparison result for byte at index where pair buffers are different, or 0 if index >= size
+// pair size must be > 0, so result can be selected without branch
+static inline int MemBatchCompareAt(const MemPair* pair, size_t index)
+{
+    const uint8_t* p1 = (const uint8_t*)pair->ptr1;
+    const uint8_t* p2 = (const uint8_t*)pair->ptr2;
 
-        // get index of byte that's different, m is guaranteed non-zero, because there only max 31 bytes here
-        size_t index = MEM_CTZ32(m);
+    size_t offset = index < pair->size ? index : 0;
+    int result = p1[offset] - p2[offset];
+    return index < pair->size ? result : 0;
+}
 
-        // return comparison result, or 0 if inputs are equal
-        return index < size ? p1[index] - p2[index] : 0;
+// returns non-zero value if first "size" bytes of buffers are different, size must be < 16
+// loads two overlapping 8, 4, 2 or 1 byte values, branches depend only on size and not on contents of buffers
+static inline uint64_t MemConstTimeDiff(const uint8_t* p1, const uint8_t* p2, size_t size)
+{
+    if (size >= 8)
+    {
+        return (MEM_PTR64U(p1) ^ MEM_PTR64U(p2)) | (MEM_PTR64U(p1 + size - 8) ^ MEM_PTR64U(p2 + size - 8));
     }
-    else if (size) // 0 < size < 16, but initially size > 16
+    else if (size >= 4)
     {
-        // load 16 bytes from end of buffer
-        // this will load previously checked bytes in 64 byte loop (they were equal)
-        __m128i a0 = _mm_loadu_si128((const __m128i*)(p1 + size - 0x10));
-        __m128i b0 = _mm_loadu_si128((const __m128i*)(p2 + size - 0x10));
+        return (MEM_PTR32U(p1) ^ MEM_PTR32U(p2)) | (MEM_PTR32U(p1 + size - 4) ^ MEM_PTR32U(p2 + size - 4));
+    }
+    else if (size >= 2)
+    {
+        return (uint64_t)(MEM_PTR16U(p1) ^ MEM_PTR16U(p2)) | (uint64_t)(MEM_PTR16U(p1 + size - 2) ^ MEM_PTR16U(p2 + size - 2));
+    }
+    else if (size)
+    {
+        return (uint64_t)(p1[0] ^ p2[0]);
+    }
+    return 0;
+}
 
-        // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m128i r0 = _mm_cmpeq_epi8(a0, b0);
+// searches segments one by one with "find" function of specific instruction set, without dispatching for each segment
+// segments shorter than vector are still processed with vector instructions by "find"
+static MEM_FORCE_INLINE MemPosition MemFindSegments(const MemSegment* segments, size_t count, uint8_t value, size_t (*find)(const void*, size_t, uint8_t))
+{
+    MemPosition result;
+    result.segment = count;
+    result.offset = 0;
 
-        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
-        uint32_t m = 1U + (uint16_t)_mm_movemask_epi8(r0);
+    for (size_t i=0; i<count; i++)
+    {
+        size_t size = segments[i].iov_len;
+        size_t index = find(segments[i].iov_base, size, value);
+        if (index != size)
+        {
+            result.segment = i;
+            result.offset = index;
+            break;
+        }
+    }
 
-        // get index of byte that's different, m is guaranteed non-zero, because there only max 15 bytes here
-        size_t index = MEM_CTZ32(m) + size - 16;
+    return result;
+}
 
-        // return comparison result, or 0 if inputs are equal
-        return index < size ? p1[index] - p2[index] : 0;
+// compares overlapping parts of current segments from both arrays with "isequal" function of specific instruction set
+// and moves to next segment in array where current one ends, empty segments are skipped
+static MEM_FORCE_INLINE bool MemIsEqualSegments(const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2, bool (*isequal)(const void*, const void*, size_t))
+{
+    const uint8_t* p1 = NULL;
+    const uint8_t* p2 = NULL;
+    size_t size1 = 0;
+    size_t size2 = 0;
+
+    for (;;)
+    {
+        while (size1 == 0 && count1 != 0)
+        {
+            p1 = (const uint8_t*)segments1->iov_base;
+            size1 = segments1->iov_len;
+            segments1++;
+            count1--;
+        }
+
+        while (size2 == 0 && count2 != 0)
+        {
+            p2 = (const uint8_t*)segments2->iov_base;
+            size2 = segments2->iov_len;
+            segments2++;
+            count2--;
+        }
+
+        // when either array has no more bytes, buffers are equal only if other one also has no more bytes
+        if (size1 == 0 || size2 == 0)
+        {
+            return size1 == size2;
+        }
+
+        size_t size = size1 < size2 ? size1 : size2;
+        if (!isequal(p1, p2, size))
+        {
+            return false;
+        }
+
+        p1 += size;
+        p2 += size;
+        size1 -= size;
+        size2 -= size;
     }
+}
 
-    // no differences found, inputs are equal
-    return 0;
+
+#if MEM_ARCH_X64
+
+static inline __m128i MemToLower16(__m128i x)
+{
+    __m128i tmp = _mm_sub_epi8(x, _mm_set1_epi8('A' - 128));
+    tmp = _mm_cmpgt_epi8(tmp, _mm_set1_epi8('Z' - 'A' - 128));
+    tmp = _mm_andnot_si128(tmp, _mm_set1_epi8('a' - 'A'));
+    return _mm_add_epi8(x, tmp);
+}
+
+MEM_TARGET_AVX2
+static inline __m256i MemToLower32(__m256i x)
+{
+    __m256i tmp = _mm256_sub_epi8(x, _mm256_set1_epi8('A' - 128));
+    tmp = _mm256_cmpgt_epi8(tmp, _mm256_set1_epi8('Z' - 'A' - 128));
+    tmp = _mm256_andnot_si256(tmp, _mm256_set1_epi8('a' - 'A'));
+    return _mm256_add_epi8(x, tmp);
+}
+
+MEM_TARGET_AVX512
+static inline __m512i MemToLower64(__m512i x)
+{
+#if !defined(__AVX512VBMI__)
+    // kernels are compiled without VBMI, unless it is enabled for whole program
+    __m512i tmp = _mm512_sub_epi8(x, _mm512_set1_epi8('A'));
+    __mmask64 mask = _mm512_cmple_epu8_mask(tmp, _mm512_set1_epi8('Z' - 'A'));
+    return _mm512_mask_add_epi8(x, mask, x, _mm512_set1_epi8('a' - 'A'));
+#else
+    static const uint8_t table[] =
+    {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+        0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+        0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f,
+        0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f,
+        0x40,  'a',  'b',  'c',  'd',  'e',  'f',  'g',  'h',  'i',  'j',  'k',  'l',  'm',  'n',  'o',
+         'p',  'q',  'r',  's',  't',  'u',  'v',  'w',  'x',  'y',  'z', 0x5b, 0x5c, 0x5d, 0x5e, 0x5f,
+        0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f,
+        0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x7b, 0x7c, 0x7d, 0x7e, 0x7f,
+    };
+    const __m512i c0 = _mm512_loadu_epi8(table + 0x00);
+    const __m512i c1 = _mm512_loadu_epi8(table + 0x40);
+    __mmask64 mask = _mm512_cmplt_epu8_mask(x, _mm512_set1_epi8((char)0x80));
+    return _mm512_mask2_permutex2var_epi8(c0, x, mask, c1);
+#endif
+}
+
+// flips ASCII case of letters in [first, first + 'Z' - 'A'] range, first is either 'A' or 'a'
+static inline __m128i MemConvertCase16(__m128i x, uint8_t first)
+{
+    __m128i tmp = _mm_sub_epi8(x, _mm_set1_epi8((char)(first - 128)));
+    tmp = _mm_cmpgt_epi8(tmp, _mm_set1_epi8('Z' - 'A' - 128));
+    tmp = _mm_andnot_si128(tmp, _mm_set1_epi8('a' - 'A'));
+    return _mm_xor_si128(x, tmp);
+}
+
+MEM_TARGET_AVX2
+static inline __m256i MemConvertCase32(__m256i x, uint8_t first)
+{
+    __m256i tmp = _mm256_sub_epi8(x, _mm256_set1_epi8((char)(first - 128)));
+    tmp = _mm256_cmpgt_epi8(tmp, _mm256_set1_epi8('Z' - 'A' - 128));
+    tmp = _mm256_andnot_si256(tmp, _mm256_set1_epi8('a' - 'A'));
+    return _mm256_xor_si256(x, tmp);
+}
+
+MEM_TARGET_AVX512
+static inline __m512i MemConvertCase64(__m512i x, uint8_t first)
+{
+    __m512i tmp = _mm512_sub_epi8(x, _mm512_set1_epi8((char)first));
+    __mmask64 mask = _mm512_cmple_epu8_mask(tmp, _mm512_set1_epi8('Z' - 'A'));
+    return _mm512_mask_add_epi8(x, mask, x, _mm512_set1_epi8((char)((first ^ 0x20) - first)));
 }
 
+
 MEM_DISABLE_ASAN
-int MemCompareI_sse2(const void* ptr1, const void* ptr2, size_t size)
+int MemCompare_sse2(const void* ptr1, const void* ptr2, size_t size)
 {
     const uint8_t* p1 = (const uint8_t*)ptr1;
     const uint8_t* p2 = (const uint8_t*)ptr2;
@@ -506,62 +1407,267 @@ int MemCompareI_sse2(const void* ptr1, const void* ptr2, size_t size)
         uint32_t address = (uint32_t)(uintptr_t)p1 | (uint32_t)(uintptr_t)p2;
         if ((address & (PAGE_SIZE - 1)) <= PAGE_SIZE - 16)
         {
-            // load bytes and convert them to lowercase
-            __m128i a0 = MemToLower16(_mm_loadu_si128((const __m128i*)p1));
-            __m128i b0 = MemToLower16(_mm_loadu_si128((const __m128i*)p2));
+            __m128i a0 = _mm_loadu_si128((const __m128i*)p1);
+            __m128i b0 = _mm_loadu_si128((const __m128i*)p2);
 
             // set lanes to 0xff if bytes are equal, or 0x00 if not
             __m128i r0 = _mm_cmpeq_epi8(a0, b0);
 
-            // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+            // extract top bit of each lane to mask
+            // it will have bit value 0 in positions where bytes are not equal
+            // adding 1 will flip lowest bit with value 0 to value 1
+            // and change all bits with value 1 below it to 0
             uint32_t m = 1U + (uint16_t)_mm_movemask_epi8(r0);
 
             // get index of byte that's different, m is guaranteed non-zero, because there are only max 16 bytes here
             size_t index = MEM_CTZ32(m);
 
             // return comparison result, or 0 if inputs are equal
-            return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
+            return index < size ? p1[index] - p2[index] : 0;
         }
 
         // cannot overread buffers, need to load exactly "size" bytes only
 
         if (size < 2) // size == 1
         {
-            return MemToLower1(p1[0]) - MemToLower1(p2[0]);
+            return p1[0] - p2[0];
         }
 
         // will load pair of 4, 8 or 16 overlapping bytes
         // a/b0 from beginning of buffer
         // a/b1 from end of buffers
-        __m128i a0, b0, a1, b1;
-        size_t n;
+        uint64_t a0, b0, a1, b1;
 
         if (size < 4) // 2 <= size < 4
         {
-            a0 = _mm_loadu_si16((const __m128i*)p1);
-            b0 = _mm_loadu_si16((const __m128i*)p2);
-            a1 = _mm_loadu_si16((const __m128i*)(p1 + size - 2));
-            b1 = _mm_loadu_si16((const __m128i*)(p2 + size - 2));
-            n = 2;
+            a0 = MEM_PTR16U(p1);
+            b0 = MEM_PTR16U(p2);
+            a1 = MEM_PTR16U(p1 + size - 2);
+            b1 = MEM_PTR16U(p2 + size - 2);
         }
         else if (size < 8) // 4 <= size < 8
         {
-            a0 = _mm_loadu_si32((const __m128i*)p1);
-            b0 = _mm_loadu_si32((const __m128i*)p2);
-            a1 = _mm_loadu_si32((const __m128i*)(p1 + size - 4));
-            b1 = _mm_loadu_si32((const __m128i*)(p2 + size - 4));
-            n = 4;
+            a0 = MEM_PTR32U(p1);
+            b0 = MEM_PTR32U(p2);
+            a1 = MEM_PTR32U(p1 + size - 4);
+            b1 = MEM_PTR32U(p2 + size - 4);
         }
         else // 8 <= size <= 16
         {
-            a0 = _mm_loadu_si64((const __m128i*)p1);
-            b0 = _mm_loadu_si64((const __m128i*)p2);
-            a1 = _mm_loadu_si64((const __m128i*)(p1 + size - 8));
-            b1 = _mm_loadu_si64((const __m128i*)(p2 + size - 8));
-            n = 8;
-        }
-
-        // pack bytes into 16-byte simd register
+            a0 = MEM_PTR64U(p1);
+            b0 = MEM_PTR64U(p2);
+            a1 = MEM_PTR64U(p1 + size - 8);
+            b1 = MEM_PTR64U(p2 + size - 8);
+        }
+
+        // use a0/b0 if they are not equal, otherwise a1/b1
+        // byte swap because in big-endian bytes can be compared as uint64 numbers
+        uint64_t a = MEM_BSWAP64(a0 != b0 ? a0 : a1);
+        uint64_t b = MEM_BSWAP64(a0 != b0 ? b0 : b1);
+
+        return (a > b) - (a < b);
+    }
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p1 + 0x00));
+        __m128i b0 = _mm_loadu_si128((const __m128i*)(p2 + 0x00));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p1 + 0x10));
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(p2 + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p1 + 0x20));
+        __m128i b2 = _mm_loadu_si128((const __m128i*)(p2 + 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p1 + 0x30));
+        __m128i b3 = _mm_loadu_si128((const __m128i*)(p2 + 0x30));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m128i r0 = _mm_cmpeq_epi8(a0, b0);
+        __m128i r1 = _mm_cmpeq_epi8(a1, b1);
+        __m128i r2 = _mm_cmpeq_epi8(a2, b2);
+        __m128i r3 = _mm_cmpeq_epi8(a3, b3);
+
+        // combine comparisons - leave 0x00 in all lanes that were not equal
+        __m128i r = _mm_and_si128(_mm_and_si128(r0, r1), _mm_and_si128(r2, r3));
+
+        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint16_t mask = 1 + (uint16_t)_mm_movemask_epi8(r);
+        if (mask)
+        {
+            // if mask is non-zero that means there is difference somewhere
+            // do the same thing as above, but for all r0/r1/r2/r3 comparisons
+            uint64_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+            uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+            uint64_t m2 = (uint16_t)_mm_movemask_epi8(r2);
+            uint64_t m3 = (uint16_t)_mm_movemask_epi8(r3);
+            uint64_t m4 = 1ULL + (m0 | (m1 << 16) | (m2 << 32) | (m3 << 48));
+
+            // m4 is guaranteed to be non-zero, extract index and return result
+            size_t index = MEM_CTZ64(m4);
+            return p1[index] - p2[index];
+        }
+
+        size -= 64;
+        p1 += 64;
+        p2 += 64;
+    }
+
+    if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p1 + 0x00));
+        __m128i b0 = _mm_loadu_si128((const __m128i*)(p2 + 0x00));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p1 + 0x10));
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(p2 + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p1 + size - 0x20));
+        __m128i b2 = _mm_loadu_si128((const __m128i*)(p2 + size - 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p1 + size - 0x10));
+        __m128i b3 = _mm_loadu_si128((const __m128i*)(p2 + size - 0x10));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m128i r0 = _mm_cmpeq_epi8(a0, b0);
+        __m128i r1 = _mm_cmpeq_epi8(a1, b1);
+        __m128i r2 = _mm_cmpeq_epi8(a2, b2);
+        __m128i r3 = _mm_cmpeq_epi8(a3, b3);
+
+        // extract top bit masks
+        uint64_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+        uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+        uint64_t m2 = (uint16_t)_mm_movemask_epi8(r2);
+        uint64_t m3 = (uint16_t)_mm_movemask_epi8(r3);
+
+        // combine masks, handling overlapped ones, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint64_t m = 1ULL + (m0 | (m1 << 16) | (m2 << (size - 32)) | (m3 << (size - 16)));
+
+        // get index of byte that's different, m is guaranteed non-zero, because there only max 63 bytes here
+        size_t index = MEM_CTZ64(m);
+
+        // return comparison result, or 0 if inputs are equal
+        return index < size ? p1[index] - p2[index] : 0;
+    }
+    else if (size & 16) // 16 <= size < 32
+    {
+        // load 32 bytes, some will overlap
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p1);
+        __m128i b0 = _mm_loadu_si128((const __m128i*)p2);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p1 + size - 0x10));
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(p2 + size - 0x10));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m128i r0 = _mm_cmpeq_epi8(a0, b0);
+        __m128i r1 = _mm_cmpeq_epi8(a1, b1);
+
+        // extract top bit masks
+        uint32_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+        uint32_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+
+        // combine masks, handling overlapped ones, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint32_t m = 1U + (m0 | (m1 << (size - 16)));
+
+        // get index of byte that's different, m is guaranteed non-zero, because there only max 31 bytes here
+        size_t index = MEM_CTZ32(m);
+
+        // return comparison result, or 0 if inputs are equal
+        return index < size ? p1[index] - p2[index] : 0;
+    }
+    else if (size) // 0 < size < 16, but initially size > 16
+    {
+        // load 16 bytes from end of buffer
+        // this will load previously checked bytes in 64 byte loop (they were equal)
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p1 + size - 0x10));
+        __m128i b0 = _mm_loadu_si128((const __m128i*)(p2 + size - 0x10));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m128i r0 = _mm_cmpeq_epi8(a0, b0);
+
+        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint32_t m = 1U + (uint16_t)_mm_movemask_epi8(r0);
+
+        // get index of byte that's different, m is guaranteed non-zero, because there only max 15 bytes here
+        size_t index = MEM_CTZ32(m) + size - 16;
+
+        // return comparison result, or 0 if inputs are equal
+        return index < size ? p1[index] - p2[index] : 0;
+    }
+
+    // no differences found, inputs are equal
+    return 0;
+}
+
+MEM_DISABLE_ASAN
+int MemCompareI_sse2(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 16)
+    {
+        const uint32_t PAGE_SIZE = 4096;
+
+        // if 16 bytes from each pointer does not cross page boundary, can safely load them as 16-byte vector
+        uint32_t address = (uint32_t)(uintptr_t)p1 | (uint32_t)(uintptr_t)p2;
+        if ((address & (PAGE_SIZE - 1)) <= PAGE_SIZE - 16)
+        {
+            // load bytes and convert them to lowercase
+            __m128i a0 = MemToLower16(_mm_loadu_si128((const __m128i*)p1));
+            __m128i b0 = MemToLower16(_mm_loadu_si128((const __m128i*)p2));
+
+            // set lanes to 0xff if bytes are equal, or 0x00 if not
+            __m128i r0 = _mm_cmpeq_epi8(a0, b0);
+
+            // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+            uint32_t m = 1U + (uint16_t)_mm_movemask_epi8(r0);
+
+            // get index of byte that's different, m is guaranteed non-zero, because there are only max 16 bytes here
+            size_t index = MEM_CTZ32(m);
+
+            // return comparison result, or 0 if inputs are equal
+            return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
+        }
+
+        // cannot overread buffers, need to load exactly "size" bytes only
+
+        if (size < 2) // size == 1
+        {
+            return MemToLower1(p1[0]) - MemToLower1(p2[0]);
+        }
+
+        // will load pair of 4, 8 or 16 overlapping bytes
+        // a/b0 from beginning of buffer
+        // a/b1 from end of buffers
+        __m128i a0, b0, a1, b1;
+        size_t n;
+
+        if (size < 4) // 2 <= size < 4
+        {
+            a0 = _mm_loadu_si16((const __m128i*)p1);
+            b0 = _mm_loadu_si16((const __m128i*)p2);
+            a1 = _mm_loadu_si16((const __m128i*)(p1 + size - 2));
+            b1 = _mm_loadu_si16((const __m128i*)(p2 + size - 2));
+            n = 2;
+        }
+        else if (size < 8) // 4 <= size < 8
+        {
+            a0 = _mm_loadu_si32((const __m128i*)p1);
+            b0 = _mm_loadu_si32((const __m128i*)p2);
+            a1 = _mm_loadu_si32((const __m128i*)(p1 + size - 4));
+            b1 = _mm_loadu_si32((const __m128i*)(p2 + size - 4));
+            n = 4;
+        }
+        else // 8 <= size <= 16
+        {
+            a0 = _mm_loadu_si64((const __m128i*)p1);
+            b0 = _mm_loadu_si64((const __m128i*)p2);
+            a1 = _mm_loadu_si64((const __m128i*)(p1 + size - 8));
+            b1 = _mm_loadu_si64((const __m128i*)(p2 + size - 8));
+            n = 8;
+        }
+
+        // pack bytes into 16-byte simd register
         // a/b0 goes into low 64-bit lane
         // a/b1 goes into high 64-bit lane
         __m128i a = _mm_unpacklo_epi64(a0, a1);
@@ -1177,1446 +2283,1229 @@ size_t MemFindNot_sse2(const void* ptr, size_t size, uint8_t value)
 }
 
 MEM_DISABLE_ASAN
-MEM_TARGET_AVX2
-int MemCompare_avx2(const void* ptr1, const void* ptr2, size_t size)
+size_t MemFindLast_sse2(const void* ptr, size_t size, uint8_t value)
 {
-    const uint8_t* p1 = (const uint8_t*)ptr1;
-    const uint8_t* p2 = (const uint8_t*)ptr2;
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    const __m128i value16 = _mm_set1_epi8((char)value);
 
     if (size == 0)
     {
         return 0;
     }
 
-    if (size <= 32)
+    if (size <= 16)
     {
-        const uint32_t PAGE_SIZE = 4096;
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
 
-        // if 32 bytes from each pointer does not cross page boundary, can safely load them as 16-byte vector
-        uint32_t address = (uint32_t)(uintptr_t)p1 | (uint32_t)(uintptr_t)p2;
-        if ((address & (PAGE_SIZE - 1)) <= PAGE_SIZE - 32)
-        {
-            __m256i a0 = _mm256_loadu_si256((const __m256i*)p1);
-            __m256i b0 = _mm256_loadu_si256((const __m256i*)p2);
+        // will load before the beginning buffer (16-byte aligned) if end is too close
+        // to 16-byte boundary, otherwise will load past the end of buffer
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p - extra));
 
-            // set lanes to 0xff if bytes are equal, or 0x00 if not
-            __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        __m128i r0 = _mm_cmpeq_epi8(a0, value16);
 
-            // extract top bit of each lane to mask
-            // it will have bit value 0 in positions where bytes are not equal
-            // adding 1 will flip lowest bit with value 0 to value 1
-            // and change all bits with value 1 below it to 0
-            uint32_t m = 1U + (uint32_t)_mm256_movemask_epi8(r0);
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        uint32_t m = (uint32_t)(uint16_t)_mm_movemask_epi8(r0) >> extra;
 
-            // get index of byte that's different, evaluates to 32 if all bytes are equal
-            size_t index = _tzcnt_u32(m);
+        // clear high bits (due to loading bytes after end of buffer)
+        m &= (1U << size) - 1;
 
-            // return comparison result, or 0 if inputs are equal
-            return index < size ? p1[index] - p2[index] : 0;
-        }
+        // return index of last bit set, which will be index of last byte matching input value
+        return m ? MEM_BSR32(m) : size;
+    }
 
-        // cannot overread buffers, need to load exactly "size" bytes only
+    // remember original size to return when input value is not found
+    const size_t total = size;
 
-        if (size < 2) // size == 1
-        {
-            return p1[0] - p2[0];
-        }
-        else if (size < 4) // 2 <= size < 4
-        {
-            // load two pairs of 2 overlapping bytes, in big-endian
-            uint32_t a0 = MEM_GET16BE(p1);
-            uint32_t b0 = MEM_GET16BE(p2);
-            uint32_t a1 = MEM_GET16BE(p1 + size - 2);
-            uint32_t b1 = MEM_GET16BE(p2 + size - 2);
-            // use a0/b0 if they are not equal, otherwise a1/b1
-            uint32_t a = (a0 != b0 ? a0 : a1);
-            uint32_t b = (a0 != b0 ? b0 : b1);
-            // big-endian numbers can be subtracted to get their order
-            // as long as numbers are small so subtraction does not overflow 32-bit int
-            return (int)a - (int)b;
-        }
-        else if (size < 8) // 4 <= size < 8
-        {
-            // load two pairs of 4 overlapping bytes, in big-endian
-            uint32_t a0 = MEM_GET32BE(p1);
-            uint32_t b0 = MEM_GET32BE(p2);
-            uint32_t a1 = MEM_GET32BE(p1 + size - 4);
-            uint32_t b1 = MEM_GET32BE(p2 + size - 4);
-            // use a0/b0 if they are not equal, otherwise a1/b1
-            uint32_t a = (a0 != b0 ? a0 : a1);
-            uint32_t b = (a0 != b0 ? b0 : b1);
-            // big-endian numbers can be compared directly
-            return (a > b) - (a < b);
-        }
-        else if (size <= 16) // 8 <= size <= 16
-        {
-            // load two pairs of 8 overlapping bytes, in big-endian
-            uint64_t a0 = MEM_GET64BE(p1);
-            uint64_t b0 = MEM_GET64BE(p2);
-            uint64_t a1 = MEM_GET64BE(p1 + size - 8);
-            uint64_t b1 = MEM_GET64BE(p2 + size - 8);
-            // use a0/b0 if they are not equal, otherwise a1/b1
-            uint64_t a = (a0 != b0 ? a0 : a1);
-            uint64_t b = (a0 != b0 ? b0 : b1);
-            // big-endian numbers can be compared directly
-            return (a > b) - (a < b);
-        }
-        else // 16 < size <= 32
-        {
-            // load two pairs of 16 overlapping bytes
-            __m128i a0 = _mm_loadu_si128((const __m128i*)p1);
-            __m128i b0 = _mm_loadu_si128((const __m128i*)p2);
-            __m128i a1 = _mm_loadu_si128((const __m128i*)(p1 + size - 0x10));
-            __m128i b1 = _mm_loadu_si128((const __m128i*)(p2 + size - 0x10));
-
-            // combine them into 32-byte registers
-            __m256i a = _mm256_inserti128_si256(_mm256_castsi128_si256(a0), a1, 1);
-            __m256i b = _mm256_inserti128_si256(_mm256_castsi128_si256(b0), b1, 1);
-
-            // set lanes to 0xff if bytes are equal, or 0x00 if not
-            __m256i r = _mm256_cmpeq_epi8(a, b);
-
-            // extract top bit masks, flip lowest 0 bit to 1, changing all bits below it to 0
-            uint32_t m = 1U + (uint32_t)_mm256_movemask_epi8(r);
-
-            // get index of byte that's different, evaluates to 32 if all bytes are equal
-            size_t index = _tzcnt_u32(m);
-
-            // adjust index to correct byte position (due to how they were packed with _mm256_inserti128_si256)
-            // index = (index < 16) ? index : (index - 16) + (size - 16);
-            index += (index >= 16) * (size - 32);
-
-            // return comparison result, or 0 if inputs are equal
-            return index < size ? p1[index] - p2[index] : 0;
-        }
-    }
-
-    // process 128-byte blocks as much as possible
-    while (size >= 128)
+    // process 64-byte blocks from the end of buffer as much as possible
+    while (size >= 64)
     {
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + 0x00));
-        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + 0x00));
-        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + 0x20));
-        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + 0x20));
-        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p1 + 0x40));
-        __m256i b2 = _mm256_loadu_si256((const __m256i*)(p2 + 0x40));
-        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p1 + 0x60));
-        __m256i b3 = _mm256_loadu_si256((const __m256i*)(p2 + 0x60));
+        size -= 64;
 
-        // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
-        __m256i r1 = _mm256_cmpeq_epi8(a1, b1);
-        __m256i r2 = _mm256_cmpeq_epi8(a2, b2);
-        __m256i r3 = _mm256_cmpeq_epi8(a3, b3);
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + size + 0x00));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + size + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p + size + 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p + size + 0x30));
 
-        // combine comparisons - leave 0x00 in all lanes that were not equal
-        __m256i r = _mm256_and_si256(_mm256_and_si256(r0, r1), _mm256_and_si256(r2, r3));
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        __m128i r0 = _mm_cmpeq_epi8(value16, a0);
+        __m128i r1 = _mm_cmpeq_epi8(value16, a1);
+        __m128i r2 = _mm_cmpeq_epi8(value16, a2);
+        __m128i r3 = _mm_cmpeq_epi8(value16, a3);
 
-        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
-        uint32_t mask = 1U + (uint32_t)_mm256_movemask_epi8(r);
+        // combine comparisons - leave 0xff in lanes there equal to input value
+        __m128i r = _mm_or_si128(_mm_or_si128(r0, r1), _mm_or_si128(r2, r3));
+
+        // extract top bit mask, it will be non-zero if there is at least one matching lane to input value
+        uint16_t mask = (uint16_t)_mm_movemask_epi8(r);
         if (mask)
         {
-            // extract top bit masks from individual comparisons
-            uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
-            uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
-            uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
-            uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
-
-            // combine masks, flip lowest 0 bit to 1, changing all bits below it to 0
-            uint64_t m01 = 1ULL + (m0 | (m1 << 32));
-            uint64_t m23 = 1ULL + (m2 | (m3 << 32));
-
-            // find index of byte with difference
-            size_t idx0 = _tzcnt_u64(m01);
-            size_t idx1 = _tzcnt_u64(m23);
+            // extract top bit masks for each comparison
+            uint64_t m0 = mask; // if r1=r2=r3=0, then r0=r
+            uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+            uint64_t m2 = (uint16_t)_mm_movemask_epi8(r2);
+            uint64_t m3 = (uint16_t)_mm_movemask_epi8(r3);
 
-            // combine both indices to actual index across both comparisons
-            size_t index = 0;
-            index += idx0;
-            index += m01 ? 0 : idx1;
+            // combine them into one mask, m4 is guaranteed to be non-zero
+            uint64_t m4 = m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
 
-            return p1[index] - p2[index];
+            // find last bit set, and return index
+            return size + MEM_BSR64(m4);
         }
-
-        size -= 128;
-        p1 += 128;
-        p2 += 128;
     }
 
-    if (size & 64) // 64 <= size < 128
+    if (size & 32) // 32 <= size < 64
     {
-        // load 128 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + 0x00));
-        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + 0x00));
-        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + 0x20));
-        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + 0x20));
-        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x40));
-        __m256i b2 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x40));
-        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x20));
-        __m256i b3 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x20));
+        // load 64 bytes, some will overlap
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p + size - 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p + size - 0x10));
 
         // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
-        __m256i r1 = _mm256_cmpeq_epi8(a1, b1);
-        __m256i r2 = _mm256_cmpeq_epi8(a2, b2);
-        __m256i r3 = _mm256_cmpeq_epi8(a3, b3);
-
-        // extract top bit masks
-        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
-        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
-        uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
-        uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
-
-        // combine masks, flip lowest 0 bit to 1, changing all bits below it to 0
-        uint64_t m01 = 1ULL + (m0 | (m1 << 32));
-        uint64_t m23 = 1ULL + (m2 | (m3 << 32));
+        __m128i r0 = _mm_cmpeq_epi8(value16, a0);
+        __m128i r1 = _mm_cmpeq_epi8(value16, a1);
+        __m128i r2 = _mm_cmpeq_epi8(value16, a2);
+        __m128i r3 = _mm_cmpeq_epi8(value16, a3);
 
-        // get index of byte with difference, plus adjust due to overlap
-        size_t idx0 = _tzcnt_u64(m01);
-        size_t idx1 = _tzcnt_u64(m23) + (size - 64) - 64; // 64 will be already in idx0
+        // extract top bit masks for each comparison
+        uint64_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+        uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+        uint64_t m2 = (uint16_t)_mm_movemask_epi8(r2);
+        uint64_t m3 = (uint16_t)_mm_movemask_epi8(r3);
 
-        // combine both indices to actual index across both comparisons
-        size_t index = 0;
-        index += idx0;
-        index += m01 ? 0 : idx1;
+        // combine masks, handling overlapped ones
+        uint64_t m = m0 | (m1 << 16) | (m2 << (size - 32)) | (m3 << (size - 16));
 
-        // return comparison result, or 0 if inputs are equal
-        return index < size ? p1[index] - p2[index] : 0;
+        // find last bit set, and return index
+        return m ? MEM_BSR64(m) : total;
     }
-    else if (size & 32) // 32 <= size < 64
+    else if (size & 16) // 16 <= size < 32
     {
-        // load 64 bytes, some will overlap
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)p1);
-        __m256i b0 = _mm256_loadu_si256((const __m256i*)p2);
-        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x20));
-        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x20));
+        // load 32 bytes, some will overlap
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + size - 0x10));
 
         // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
-        __m256i r1 = _mm256_cmpeq_epi8(a1, b1);
-
-        // extract top bit masks
-        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
-        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+        __m128i r0 = _mm_cmpeq_epi8(value16, a0);
+        __m128i r1 = _mm_cmpeq_epi8(value16, a1);
 
-        // combine masks, handling overlapped ones, flip lowest 0 bit to 1, changing all bits below it to 0
-        uint64_t m = 1ULL + (m0 | (m1 << (size - 32)));
+        // extract top bit masks for each comparison
+        uint32_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+        uint32_t m1 = (uint16_t)_mm_movemask_epi8(r1);
 
-        // get index of byte that's different
-        size_t index = _tzcnt_u64(m);
+        // combine masks, handling overlapped ones
+        uint32_t m = m0 | (m1 << (size - 16));
 
-        // return comparison result, or 0 if inputs are equal
-        return index < size ? p1[index] - p2[index] : 0;
+        // find last bit set, and return index
+        return m ? MEM_BSR32(m) : total;
     }
-    else if (size) // 0 < size < 32, but initially size > 32
+    else if (size) // 0 < size < 16, but initially size > 16
     {
-        // load 32 bytes from end of buffer
-        // this will load previously checked bytes in 128 byte loop (they were equal)
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x20));
-        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x20));
+        // load 16 bytes from beginning of buffer
+        // this will load previously checked bytes in 64 byte loop (they did not match input value)
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p);
 
         // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
-
-        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
-        uint32_t m = 1U + (uint32_t)_mm256_movemask_epi8(r0);
+        __m128i r0 = _mm_cmpeq_epi8(value16, a0);
 
-        // get index of byte that's different
-        size_t index = _tzcnt_u32(m) + size - 32;
+        // extract top bit mask
+        uint32_t m = (uint16_t)_mm_movemask_epi8(r0);
 
-        // return comparison result, or 0 if inputs are equal
-        return index < size ? p1[index] - p2[index] : 0;
+        // find last bit set, and return index
+        return m ? MEM_BSR32(m) : total;
     }
 
-    // no differences found, inputs are equal
-    return 0;
+    // no input value found
+    return total;
 }
 
 MEM_DISABLE_ASAN
-MEM_TARGET_AVX2
-int MemCompareI_avx2(const void* ptr1, const void* ptr2, size_t size)
+size_t MemFindLastNot_sse2(const void* ptr, size_t size, uint8_t value)
 {
-    const uint8_t* p1 = (const uint8_t*)ptr1;
-    const uint8_t* p2 = (const uint8_t*)ptr2;
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    const __m128i value16 = _mm_set1_epi8((char)value);
 
     if (size == 0)
     {
         return 0;
     }
 
-    if (size <= 32)
+    if (size <= 16)
     {
-        const uint32_t PAGE_SIZE = 4096;
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
 
-        // if 32 bytes from each pointer does not cross page boundary, can safely load them as 16-byte vector
-        uint32_t address = (uint32_t)(uintptr_t)p1 | (uint32_t)(uintptr_t)p2;
-        if ((address & (PAGE_SIZE - 1)) <= PAGE_SIZE - 32)
-        {
-            // load bytes and convert them to lowercase
-            __m256i a0 = MemToLower32(_mm256_loadu_si256((const __m256i*)p1));
-            __m256i b0 = MemToLower32(_mm256_loadu_si256((const __m256i*)p2));
+        // will load before the beginning buffer (16-byte aligned) if end is too close
+        // to 16-byte boundary, otherwise will load past the end of buffer
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p - extra));
 
-            // set lanes to 0xff if bytes are equal, or 0x00 if not
-            __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        __m128i r0 = _mm_cmpeq_epi8(a0, value16);
 
-            // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
-            uint32_t m = 1U + (uint32_t)_mm256_movemask_epi8(r0);
+        // invert mask to have bits set for bytes not matching input value
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        uint32_t m = (uint32_t)(uint16_t)~_mm_movemask_epi8(r0) >> extra;
 
-            // get index of byte that's different, evaluates to 32 if all bytes are equal
-            size_t index = _tzcnt_u32(m);
+        // clear high bits (due to loading bytes after end of buffer)
+        m &= (1U << size) - 1;
 
-            // return comparison result, or 0 if inputs are equal
-            return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
-        }
+        // return index of last bit set, which will be index of last byte not matching input value
+        return m ? MEM_BSR32(m) : size;
+    }
 
-        // cannot overread buffers, need to load exactly "size" bytes only
+    // remember original size to return when all bytes are same as input value
+    const size_t total = size;
 
-        if (size < 2) // size == 1
-        {
-            return MemToLower1(p1[0]) - MemToLower1(p2[0]);
-        }
-
-        // will load pair of 4, 8, 16 or 32 overlapping bytes
-        // a/b0 from beginning of buffer
-        // a/b1 from end of buffers
-        __m128i a0, b0, a1, b1;
-        size_t n;
-
-        if (size < 4) // 2 <= size < 4
-        {
-            a0 = _mm_loadu_si16((const __m128i*)p1);
-            b0 = _mm_loadu_si16((const __m128i*)p2);
-            a1 = _mm_loadu_si16((const __m128i*)(p1 + size - 2));
-            b1 = _mm_loadu_si16((const __m128i*)(p2 + size - 2));
-            n = 2;
-        }
-        else if (size < 8) // 4 <= size < 8
-        {
-            a0 = _mm_loadu_si32((const __m128i*)p1);
-            b0 = _mm_loadu_si32((const __m128i*)p2);
-            a1 = _mm_loadu_si32((const __m128i*)(p1 + size - 4));
-            b1 = _mm_loadu_si32((const __m128i*)(p2 + size - 4));
-            n = 4;
-        }
-        else if (size < 16) // 8 <= size < 16
-        {
-            a0 = _mm_loadu_si64((const __m128i*)p1);
-            b0 = _mm_loadu_si64((const __m128i*)p2);
-            a1 = _mm_loadu_si64((const __m128i*)(p1 + size - 8));
-            b1 = _mm_loadu_si64((const __m128i*)(p2 + size - 8));
-            n = 8;
-        }
-        else // 16 <= size <= 32
-        {
-            a0 = _mm_loadu_si128((const __m128i*)p1);
-            b0 = _mm_loadu_si128((const __m128i*)p2);
-            a1 = _mm_loadu_si128((const __m128i*)(p1 + size - 16));
-            b1 = _mm_loadu_si128((const __m128i*)(p2 + size - 16));
-            n = 16;
-        }
-
-        // pack bytes into 16-byte simd register
-        // a/b0 goes into low 128-bit part
-        // a/b1 goes into high 128-bit part
-        __m256i a = _mm256_inserti128_si256(_mm256_castsi128_si256(a0), a1, 1);
-        __m256i b = _mm256_inserti128_si256(_mm256_castsi128_si256(b0), b1, 1);
-
-        // lowercase, and set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m256i r = _mm256_cmpeq_epi8(MemToLower32(a), MemToLower32(b));
-
-        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
-        uint32_t m = 1U + (uint32_t)_mm256_movemask_epi8(r);
-
-        // get index of byte that's different, evaluates to 32 if all bytes are equal
-        size_t index = _tzcnt_u32(m);
-
-        // adjust index to correct byte position (due to how they were packed with _mm256_inserti128_si256)
-        // index = (index < 16) ? index : (index - 16) + (size - n);
-        index += (index >= 16) * (size - 16 - n);
-
-        // return comparison result, or 0 if inputs are equal
-        return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
-    }
-
-    // process 128-byte blocks as much as possible
-    while (size >= 128)
+    // process 64-byte blocks from the end of buffer as much as possible
+    while (size >= 64)
     {
-        __m256i a0 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + 0x00)));
-        __m256i b0 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + 0x00)));
-        __m256i a1 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + 0x20)));
-        __m256i b1 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + 0x20)));
-        __m256i a2 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + 0x40)));
-        __m256i b2 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + 0x40)));
-        __m256i a3 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + 0x60)));
-        __m256i b3 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + 0x60)));
+        size -= 64;
+
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + size + 0x00));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + size + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p + size + 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p + size + 0x30));
 
         // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
-        __m256i r1 = _mm256_cmpeq_epi8(a1, b1);
-        __m256i r2 = _mm256_cmpeq_epi8(a2, b2);
-        __m256i r3 = _mm256_cmpeq_epi8(a3, b3);
+        __m128i r0 = _mm_cmpeq_epi8(value16, a0);
+        __m128i r1 = _mm_cmpeq_epi8(value16, a1);
+        __m128i r2 = _mm_cmpeq_epi8(value16, a2);
+        __m128i r3 = _mm_cmpeq_epi8(value16, a3);
 
         // combine comparisons - leave 0x00 in lanes that were not equal
-        __m256i r = _mm256_and_si256(_mm256_and_si256(r0, r1), _mm256_and_si256(r2, r3));
+        __m128i r = _mm_and_si128(_mm_and_si128(r0, r1), _mm_and_si128(r2, r3));
 
-        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
-        uint32_t mask = 1U + (uint32_t)_mm256_movemask_epi8(r);
+        // extract inverted top bit mask, it will be non-zero if there is at least one lane not matching input value
+        uint16_t mask = (uint16_t)~_mm_movemask_epi8(r);
         if (mask)
         {
-            // extract top bit masks for each comparison
-            uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
-            uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
-            uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
-            uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+            // extract inverted top bit masks for each comparison
+            uint64_t m0 = mask; // if r1=r2=r3=0xff, then r0=r
+            uint64_t m1 = (uint16_t)~_mm_movemask_epi8(r1);
+            uint64_t m2 = (uint16_t)~_mm_movemask_epi8(r2);
+            uint64_t m3 = (uint16_t)~_mm_movemask_epi8(r3);
 
-            // combine masks, and flip lowest 0 bit to 1, changing all bits below it to 0
-            uint64_t m01 = 1ULL + (m0 | (m1 << 32));
-            uint64_t m23 = 1ULL + (m2 | (m3 << 32));
-
-            // find index of byte with difference
-            size_t idx0 = _tzcnt_u64(m01);
-            size_t idx1 = _tzcnt_u64(m23);
-
-            // combine both indices to actual index across both comparisons
-            size_t index = 0;
-            index += idx0;
-            index += m01 ? 0 : idx1;
+            // combine them into one mask, m4 is guaranteed to be non-zero
+            uint64_t m4 = m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
 
-            return MemToLower1(p1[index]) - MemToLower1(p2[index]);
+            // find last bit set, and return index
+            return size + MEM_BSR64(m4);
         }
-
-        size -= 128;
-        p1 += 128;
-        p2 += 128;
     }
 
-    if (size & 64) // 64 <= size < 128
+    if (size & 32) // 32 <= size < 64
     {
-        // load 128 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
-        __m256i a0 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + 0x00)));
-        __m256i b0 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + 0x00)));
-        __m256i a1 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + 0x20)));
-        __m256i b1 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + 0x20)));
-        __m256i a2 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + size - 0x40)));
-        __m256i b2 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + size - 0x40)));
-        __m256i a3 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + size - 0x20)));
-        __m256i b3 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + size - 0x20)));
+        // load 64 bytes, some will overlap
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p + size - 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p + size - 0x10));
 
         // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
-        __m256i r1 = _mm256_cmpeq_epi8(a1, b1);
-        __m256i r2 = _mm256_cmpeq_epi8(a2, b2);
-        __m256i r3 = _mm256_cmpeq_epi8(a3, b3);
-
-        // extract top bit masks
-        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
-        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
-        uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
-        uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
-
-        // combine masks, flip lowest 0 bit to 1, changing all bits below it to 0
-        uint64_t m01 = 1ULL + (m0 | (m1 << 32));
-        uint64_t m23 = 1ULL + (m2 | (m3 << 32));
+        __m128i r0 = _mm_cmpeq_epi8(value16, a0);
+        __m128i r1 = _mm_cmpeq_epi8(value16, a1);
+        __m128i r2 = _mm_cmpeq_epi8(value16, a2);
+        __m128i r3 = _mm_cmpeq_epi8(value16, a3);
 
-        // get index of byte with difference, plus adjust due to overlap
-        size_t idx0 = _tzcnt_u64(m01);
-        size_t idx1 = _tzcnt_u64(m23) + (size - 64) - 64; // 64 will be already in idx0
+        // extract inverted top bit masks
+        uint64_t m0 = (uint16_t)~_mm_movemask_epi8(r0);
+        uint64_t m1 = (uint16_t)~_mm_movemask_epi8(r1);
+        uint64_t m2 = (uint16_t)~_mm_movemask_epi8(r2);
+        uint64_t m3 = (uint16_t)~_mm_movemask_epi8(r3);
 
-        // combine both indices to actual index across both comparisons
-        size_t index = 0;
-        index += idx0;
-        index += m01 ? 0 : idx1;
+        // combine masks, handling overlapped ones
+        uint64_t m = m0 | (m1 << 16) | (m2 << (size - 32)) | (m3 << (size - 16));
 
-        // return comparison result, or 0 if inputs are equal
-        return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
+        // find last bit set, and return index
+        return m ? MEM_BSR64(m) : total;
     }
-    else if (size & 32) // 32 <= size < 64
+    else if (size & 16) // 16 <= size < 32
     {
-        // load 64 bytes, some will overlap
-        __m256i a0 = MemToLower32(_mm256_loadu_si256((const __m256i*)p1));
-        __m256i b0 = MemToLower32(_mm256_loadu_si256((const __m256i*)p2));
-        __m256i a1 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + size - 0x20)));
-        __m256i b1 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + size - 0x20)));
+        // load 32 bytes, some will overlap
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + size - 0x10));
 
         // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
-        __m256i r1 = _mm256_cmpeq_epi8(a1, b1);
-
-        // extract top bit masks
-        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
-        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+        __m128i r0 = _mm_cmpeq_epi8(value16, a0);
+        __m128i r1 = _mm_cmpeq_epi8(value16, a1);
 
-        // combine masks, handling overlapped ones, flip lowest 0 bit to 1, changing all bits below it to 0
-        uint64_t m = 1ULL + (m0 | (m1 << (size - 32)));
+        // extract inverted top bit masks
+        uint32_t m0 = (uint16_t)~_mm_movemask_epi8(r0);
+        uint32_t m1 = (uint16_t)~_mm_movemask_epi8(r1);
 
-        // get index of byte that's different
-        size_t index = _tzcnt_u64(m);
+        // combine masks, handling overlapped ones
+        uint32_t m = m0 | (m1 << (size - 16));
 
-        // return comparison result, or 0 if inputs are equal
-        return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
+        // find last bit set, and return index
+        return m ? MEM_BSR32(m) : total;
     }
-    else if (size) // 0 < size < 32, but initially size > 32
+    else if (size) // 0 < size < 16, but initially size > 16
     {
-        // load 32 bytes from end of buffer
-        // this will load previously checked bytes in 128 byte loop (they were equal)
-        __m256i a0 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + size - 0x20)));
-        __m256i b0 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + size - 0x20)));
+        // load 16 bytes from beginning of buffer
+        // this will load previously checked bytes in 64 byte loop (they matched input value)
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p);
 
         // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
-
-        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
-        uint32_t m = 1U + (uint32_t)_mm256_movemask_epi8(r0);
+        __m128i r0 = _mm_cmpeq_epi8(value16, a0);
 
-        // get index of byte that's different
-        size_t index = _tzcnt_u32(m) + size - 32;
+        // extract inverted top bit mask
+        uint32_t m = (uint16_t)~_mm_movemask_epi8(r0);
 
-        // return comparison result, or 0 if inputs are equal
-        return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
+        // find last bit set, and return index
+        return m ? MEM_BSR32(m) : total;
     }
 
-    // no differences found, inputs are equal
-    return 0;
+    // all bytes are same as input value
+    return total;
 }
 
 MEM_DISABLE_ASAN
-MEM_TARGET_AVX2
-bool MemIsEqual_avx2(const void* ptr1, const void* ptr2, size_t size)
+static MEM_FORCE_INLINE __m128i MemFindAnyMatch_sse2(__m128i a, __m128i v0, __m128i v1, __m128i v2)
 {
-    const uint8_t* p1 = (const uint8_t*)ptr1;
-    const uint8_t* p2 = (const uint8_t*)ptr2;
+    // set lane to 0xff if lane matches any of input values, or 0x00 if not
+    __m128i r0 = _mm_cmpeq_epi8(a, v0);
+    __m128i r1 = _mm_cmpeq_epi8(a, v1);
+    __m128i r2 = _mm_cmpeq_epi8(a, v2);
+    return _mm_or_si128(_mm_or_si128(r0, r1), r2);
+}
+
+MEM_DISABLE_ASAN
+size_t MemFindAny_sse2(const void* ptr, size_t size, const void* set, size_t setlen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* s = (const uint8_t*)set;
+
+    if (setlen == 0)
+    {
+        return size;
+    }
+    else if (setlen == 1)
+    {
+        return MemFind_sse2(ptr, size, s[0]);
+    }
+    else if (setlen > 3)
+    {
+        // no byte shuffle in sse2 for table lookup
+        return MemFindAny_generic(ptr, size, set, setlen);
+    }
 
     if (size == 0)
     {
-        return true;
+        return 0;
     }
 
-    if (size <= 32)
+    // for 2 byte set third value is same as second one
+    const __m128i v0 = _mm_set1_epi8((char)s[0]);
+    const __m128i v1 = _mm_set1_epi8((char)s[1]);
+    const __m128i v2 = _mm_set1_epi8((char)s[setlen - 1]);
+
+    if (size <= 16)
     {
-        const uint32_t PAGE_SIZE = 4096;
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
 
-        // if 32 bytes from each pointer does not cross page boundary, can safely load them as 32-byte vector
-        uint32_t address = (uint32_t)(uintptr_t)p1 | (uint32_t)(uintptr_t)p2;
-        if ((address & (PAGE_SIZE - 1)) <= PAGE_SIZE - 32)
-        {
-            __m256i a0 = _mm256_loadu_si256((const __m256i*)p1);
-            __m256i b0 = _mm256_loadu_si256((const __m256i*)p2);
+        // will load before the beginning buffer (16-byte aligned) if end is too close
+        // to 16-byte boundary, otherwise will load past the end of buffer
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p - extra));
 
-            // set lanes to 0xff if bytes are equal, or 0x00 if not
-            __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+        // set lane to 0xff if lane matches any of input values, or 0x00 if not
+        __m128i r0 = MemFindAnyMatch_sse2(a0, v0, v1, v2);
 
-            // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
-            uint32_t mask = 1U + (uint32_t)_mm256_movemask_epi8(r0);
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        uint32_t m = (uint32_t)_mm_movemask_epi8(r0) >> extra;
 
-            // need to ignore top "32 - size" bits, only low bits matter
-            // return "true" if they are zero, otherwise "false"
-            return _bzhi_u32(mask, (uint32_t)size) == 0;
-        }
+        // mask out high bits (due to loading bytes after end of buffer)
+        // this will result in returning "size" value if no byte matches
+        m |= 1U << size;
 
-        // cannot overread buffers, need to load exactly "size" bytes only
+        // return index of first bit set, which will be index of first byte matching any of input values
+        return MEM_CTZ32(m);
+    }
 
-        if (size < 2) // size == 1
+    size_t offset = 0;
+
+    // process 32-byte blocks as much as possible
+    while (size >= 32)
+    {
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + 0x00));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+
+        __m128i r0 = MemFindAnyMatch_sse2(a0, v0, v1, v2);
+        __m128i r1 = MemFindAnyMatch_sse2(a1, v0, v1, v2);
+
+        // extract top bit mask, it will be non-zero if there is at least one matching lane
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_or_si128(r0, r1));
+        if (mask)
         {
-            return p1[0] == p2[0];
-        }
-        else if (size < 4) // 2 <= size < 4
-        {
-            // load two pairs of 2 overlapping bytes
-            uint32_t a0 = MEM_PTR16U(p1);
-            uint32_t b0 = MEM_PTR16U(p2);
-            uint32_t a1 = MEM_PTR16U(p1 + size - 2);
-            uint32_t b1 = MEM_PTR16U(p2 + size - 2);
-            // return "true" if both are equal
-            return (a0 == b0) & (a1 == b1);
-        }
-        else if (size < 8) // 4 <= size < 8
-        {
-            // load two pairs of 4 overlapping bytes
-            uint32_t a0 = MEM_PTR32U(p1);
-            uint32_t b0 = MEM_PTR32U(p2);
-            uint32_t a1 = MEM_PTR32U(p1 + size - 4);
-            uint32_t b1 = MEM_PTR32U(p2 + size - 4);
-            // return "true" if both are equal
-            return (a0 == b0) & (a1 == b1);
-        }
-        else if (size <= 16) // 8 <= size <= 16
-        {
-            // load two pairs of 8 overlapping bytes
-            uint64_t a0 = MEM_PTR64U(p1);
-            uint64_t b0 = MEM_PTR64U(p2);
-            uint64_t a1 = MEM_PTR64U(p1 + size - 8);
-            uint64_t b1 = MEM_PTR64U(p2 + size - 8);
-            // return "true" if both are equal
-            return (a0 == b0) & (a1 == b1);
+            uint32_t m0 = (uint32_t)_mm_movemask_epi8(r0);
+            uint32_t m1 = (uint32_t)_mm_movemask_epi8(r1);
+
+            // find first bit set, and return index
+            return offset + MEM_CTZ32(m0 | (m1 << 16));
         }
-        else // 16 < size <= 32
+
+        offset += 32;
+        size -= 32;
+        p += 32;
+    }
+
+    if (size & 16) // 16 <= size < 32
+    {
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p);
+        __m128i r0 = MemFindAnyMatch_sse2(a0, v0, v1, v2);
+
+        uint32_t m = (uint32_t)_mm_movemask_epi8(r0);
+        if (m)
         {
-            // load two pairs of 16 overlapping bytes
-            __m128i a0 = _mm_loadu_si128((const __m128i*)p1);
-            __m128i b0 = _mm_loadu_si128((const __m128i*)p2);
-            __m128i a1 = _mm_loadu_si128((const __m128i*)(p1 + size - 16));
-            __m128i b1 = _mm_loadu_si128((const __m128i*)(p2 + size - 16));
-            // combine them into simd register (low lane & high lane)
-            __m256i a = _mm256_inserti128_si256(_mm256_castsi128_si256(a1), a0, 1);
-            __m256i b = _mm256_inserti128_si256(_mm256_castsi128_si256(b1), b0, 1);
-            // produce 0 if all of them are equal
-            __m256i r = _mm256_xor_si256(a, b);
-            // return true, if whole simd register is 0
-            return !!_mm256_testz_si256(r, r);
+            return offset + MEM_CTZ32(m);
         }
+
+        offset += 16;
+        size -= 16;
+        p += 16;
     }
 
-    // process 128-byte blocks as much as possible
-    while (size >= 128)
+    if (size) // 0 < size < 16, but initially size > 16
     {
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + 0x00));
-        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + 0x00));
-        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + 0x20));
-        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + 0x20));
-        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p1 + 0x40));
-        __m256i b2 = _mm256_loadu_si256((const __m256i*)(p2 + 0x40));
-        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p1 + 0x60));
-        __m256i b3 = _mm256_loadu_si256((const __m256i*)(p2 + 0x60));
+        // load 16 bytes from end of buffer
+        // this will load previously checked bytes (they did not match input values)
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + size - 16));
+        __m128i r0 = MemFindAnyMatch_sse2(a0, v0, v1, v2);
 
-        // produce 0 if all of them are equal
-        __m256i r0 = _mm256_xor_si256(a0, b0);
-        __m256i r1 = _mm256_xor_si256(a1, b1);
-        __m256i r2 = _mm256_xor_si256(a2, b2);
-        __m256i r3 = _mm256_xor_si256(a3, b3);
+        // make sure mask is non-zero, this will result in returning original size if nothing matches
+        uint32_t m = (uint32_t)_mm_movemask_epi8(r0) | 0x10000;
 
-        // combine results - leave non-zero value in any lane if they were not equal
-        __m256i r = _mm256_or_si256(_mm256_or_si256(r0, r1), _mm256_or_si256(r2, r3));
-        if (!_mm256_testz_si256(r, r))
+        // find first bit set, adjust it due to reused bytes in load, and return index
+        return offset + MEM_CTZ32(m) + size - 16;
+    }
+
+    // no input values found
+    return offset;
+}
+
+MEM_DISABLE_ASAN
+static MEM_FORCE_INLINE size_t MemFindBytesCheck_sse2(const uint8_t* p, const uint8_t* n, size_t nlen, uint64_t mask)
+{
+    // first and last bytes are already matching for every bit set in mask, verify rest of the needle
+    while (mask)
+    {
+        size_t index = MEM_CTZ64(mask);
+        if (MemIsEqual_sse2(p + index + 1, n + 1, nlen - 2))
         {
-            // if simd register is not fully 0, then inputs are not equal
-            return false;
+            return index;
         }
+        mask &= mask - 1;
+    }
+    return 64;
+}
 
-        size -= 128;
-        p1 += 128;
-        p2 += 128;
+MEM_DISABLE_ASAN
+size_t MemFindBytes_sse2(const void* ptr, size_t size, const void* needle, size_t needlelen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* n = (const uint8_t*)needle;
+
+    if (needlelen == 0)
+    {
+        return 0;
+    }
+    else if (needlelen == 1)
+    {
+        return MemFind_sse2(ptr, size, n[0]);
+    }
+    else if (needlelen > size)
+    {
+        return size;
     }
 
-    if (size & 64) // 64 <= size < 128
+    // offset of last needle byte, and amount of positions where needle can start
+    size_t last = needlelen - 1;
+    size_t count = size - last;
+
+    const __m128i first16 = _mm_set1_epi8((char)n[0]);
+    const __m128i last16 = _mm_set1_epi8((char)n[last]);
+
+    if (size <= 16)
     {
-        // load 128 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + 0x00));
-        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + 0x00));
-        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + 0x20));
-        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + 0x20));
-        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x40));
-        __m256i b2 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x40));
-        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x20));
-        __m256i b3 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x20));
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
 
-        // produce 0 if all of them are equal
-        __m256i r0 = _mm256_xor_si256(a0, b0);
-        __m256i r1 = _mm256_xor_si256(a1, b1);
-        __m256i r2 = _mm256_xor_si256(a2, b2);
-        __m256i r3 = _mm256_xor_si256(a3, b3);
+        // whole buffer fits in one load, it will load before the beginning buffer (16-byte aligned)
+        // if end is too close to 16-byte boundary, otherwise will load past the end of buffer
+        __m128i a = _mm_loadu_si128((const __m128i*)(p - extra));
 
-        // combine results - leave non-zero value in any lane if they were not equal
-        __m256i r = _mm256_or_si256(_mm256_or_si256(r0, r1), _mm256_or_si256(r2, r3));
+        // set lane to 0xff if lane matches first/last needle byte, or 0x00 if not
+        __m128i r0 = _mm_cmpeq_epi8(a, first16);
+        __m128i r1 = _mm_cmpeq_epi8(a, last16);
 
-        // return true, if simd register is fully 0, meaning inputs are equal
-        return !!_mm256_testz_si256(r, r);
+        // drop any lowest "extra" bits, and shift last byte matches down to their starting position
+        uint32_t m0 = (uint32_t)_mm_movemask_epi8(r0) >> extra;
+        uint32_t m1 = (uint32_t)_mm_movemask_epi8(r1) >> (extra + last);
+
+        // keep only positions where whole needle fits in buffer
+        uint32_t mask = m0 & m1 & ((1U << count) - 1);
+
+        size_t index = MemFindBytesCheck_sse2(p, n, needlelen, mask);
+        return index < 64 ? index : size;
     }
-    else if (size & 32) // 32 <= size < 64
+
+    size_t offset = 0;
+
+    // process 64 starting positions at a time
+    while (count - offset >= 64)
     {
-        // load 64 bytes, some will overlap
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)p1);
-        __m256i b0 = _mm256_loadu_si256((const __m256i*)p2);
-        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x20));
-        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x20));
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + offset + 0x00));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + offset + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p + offset + 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p + offset + 0x30));
+        __m128i b0 = _mm_loadu_si128((const __m128i*)(p + offset + last + 0x00));
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(p + offset + last + 0x10));
+        __m128i b2 = _mm_loadu_si128((const __m128i*)(p + offset + last + 0x20));
+        __m128i b3 = _mm_loadu_si128((const __m128i*)(p + offset + last + 0x30));
+
+        // set lane to 0xff if both first and last needle bytes match, or 0x00 if not
+        __m128i r0 = _mm_and_si128(_mm_cmpeq_epi8(a0, first16), _mm_cmpeq_epi8(b0, last16));
+        __m128i r1 = _mm_and_si128(_mm_cmpeq_epi8(a1, first16), _mm_cmpeq_epi8(b1, last16));
+        __m128i r2 = _mm_and_si128(_mm_cmpeq_epi8(a2, first16), _mm_cmpeq_epi8(b2, last16));
+        __m128i r3 = _mm_and_si128(_mm_cmpeq_epi8(a3, first16), _mm_cmpeq_epi8(b3, last16));
+
+        // combine comparisons, it will be non-zero if there is at least one candidate position
+        __m128i r = _mm_or_si128(_mm_or_si128(r0, r1), _mm_or_si128(r2, r3));
 
-        // produce 0 if all of them are equal
-        __m256i r0 = _mm256_xor_si256(a0, b0);
-        __m256i r1 = _mm256_xor_si256(a1, b1);
+        if (_mm_movemask_epi8(r))
+        {
+            // extract top bit masks for each comparison
+            uint64_t m0 = (uint32_t)_mm_movemask_epi8(r0);
+            uint64_t m1 = (uint32_t)_mm_movemask_epi8(r1);
+            uint64_t m2 = (uint32_t)_mm_movemask_epi8(r2);
+            uint64_t m3 = (uint32_t)_mm_movemask_epi8(r3);
+            uint64_t m = m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+
+            size_t index = MemFindBytesCheck_sse2(p + offset, n, needlelen, m);
+            if (index < 64)
+            {
+                return offset + index;
+            }
+        }
 
-        // combine results - leave non-zero value in any lane if they were not equal
-        __m256i r = _mm256_or_si256(r0, r1);
+        offset += 64;
+    }
 
-        // return true, if simd register is fully 0, meaning inputs are equal
-        return !!_mm256_testz_si256(r, r);
+    // process rest of 16 starting position blocks
+    while (count - offset >= 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(p + offset));
+        __m128i b = _mm_loadu_si128((const __m128i*)(p + offset + last));
+
+        // set lane to 0xff if both first and last needle bytes match, or 0x00 if not
+        __m128i r = _mm_and_si128(_mm_cmpeq_epi8(a, first16), _mm_cmpeq_epi8(b, last16));
+
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(r);
+        if (mask)
+        {
+            size_t index = MemFindBytesCheck_sse2(p + offset, n, needlelen, mask);
+            if (index < 64)
+            {
+                return offset + index;
+            }
+        }
+
+        offset += 16;
     }
-    else if (size) // 0 < size < 32, but initially size > 32
+
+    if (offset < count) // 0 < tail < 16
     {
-        // load 64 bytes, some will overlap
-        // this will load previously checked bytes in 128 byte loop (they were equal)
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x20));
-        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x20));
+        size_t tail = count - offset;
 
-        // produce 0 if all of them are equal
-        __m256i r0 = _mm256_xor_si256(a0, b0);
+        // load first bytes ending at last starting position (or from beginning of buffer if there are
+        // less than 16 starting positions), and last bytes ending at end of buffer
+        // this will load previously checked positions, they will be shifted out from masks
+        size_t start = count >= 16 ? count - 16 : 0;
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + start));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + size - 16));
 
-        // return true, if simd register is fully 0, meaning inputs are equal
-        return !!_mm256_testz_si256(r0, r0);
+        // set lane to 0xff if lane matches first/last needle byte, or 0x00 if not
+        __m128i r0 = _mm_cmpeq_epi8(a0, first16);
+        __m128i r1 = _mm_cmpeq_epi8(a1, last16);
+
+        // align both masks to current offset, shift of last byte mask also leaves only "tail" bits
+        uint32_t m0 = (uint32_t)_mm_movemask_epi8(r0) >> (offset - start);
+        uint32_t m1 = (uint32_t)_mm_movemask_epi8(r1) >> (16 - tail);
+
+        size_t index = MemFindBytesCheck_sse2(p + offset, n, needlelen, m0 & m1);
+        if (index < 64)
+        {
+            return offset + index;
+        }
     }
 
-    // no differences found, inputs are equal
-    return true;
+    // needle not found
+    return size;
 }
 
 MEM_DISABLE_ASAN
-MEM_TARGET_AVX2
-size_t MemFind_avx2(const void* ptr, size_t size, uint8_t value)
+size_t MemCount_sse2(const void* ptr, size_t size, uint8_t value)
 {
     const uint8_t* p = (const uint8_t*)ptr;
 
-    __m256i value32 = _mm256_set1_epi8((char)value);
+    const __m128i value16 = _mm_set1_epi8((char)value);
 
     if (size == 0)
     {
         return 0;
     }
 
-    if (size <= 32)
+    if (size <= 16)
     {
-        size_t address = (uint32_t)(uintptr_t)p % 32;
-        size_t extra = (address + size) <= 32 ? address : 0;
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
 
-        // will load before the beginning buffer (32-byte aligned) if end is too close
-        // to 32-byte boundary, otherwise will load past the end of buffer
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p - extra));
+        // will load before the beginning buffer (16-byte aligned) if end is too close
+        // to 16-byte boundary, otherwise will load past the end of buffer
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p - extra));
 
         // set lane to 0xff if lane matches input value, or 0x00 if not
-        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+        __m128i r0 = _mm_cmpeq_epi8(a0, value16);
 
         // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
-        uint32_t m = MEM_SHRX_32((uint32_t)_mm256_movemask_epi8(r0), (uint32_t)extra);
+        uint32_t m = (uint32_t)_mm_movemask_epi8(r0) >> extra;
 
         // mask out high bits (due to loading bytes after end of buffer)
-        // this will result in returning "size" value if all bytes are same as input value
-        m |= (uint32_t)(1ULL << size);
+        m &= (1U << size) - 1;
 
-        // return index of first bit set, which will be index of first byte different from input value
-        return _tzcnt_u32(m);
+        return MEM_POPCNT32(m);
     }
 
-    size_t offset = 0;
+    const __m128i zero = _mm_setzero_si128();
 
-    // process 128-byte blocks as much as possible
-    while (size >= 128)
+    // 64-bit counters in two lanes
+    __m128i total = zero;
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
     {
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
-        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
-        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + 0x40));
-        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + 0x60));
+        // every block adds at most 4 to byte lane counters, so they can accumulate 63 blocks before overflowing
+        size_t count = size / 64 < 63 ? size / 64 : 63;
 
-        // set lane to 0xff if lane matches input value, or 0x00 if not
-        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
-        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
-        __m256i r2 = _mm256_cmpeq_epi8(value32, a2);
-        __m256i r3 = _mm256_cmpeq_epi8(value32, a3);
+        __m128i sum = zero;
+        for (size_t i=0; i<count; i++)
+        {
+            __m128i a0 = _mm_loadu_si128((const __m128i*)(p + 0x00));
+            __m128i a1 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+            __m128i a2 = _mm_loadu_si128((const __m128i*)(p + 0x20));
+            __m128i a3 = _mm_loadu_si128((const __m128i*)(p + 0x30));
+
+            // set lane to 0xff (-1) if lane matches input value, or 0x00 if not
+            __m128i r0 = _mm_cmpeq_epi8(a0, value16);
+            __m128i r1 = _mm_cmpeq_epi8(a1, value16);
+            __m128i r2 = _mm_cmpeq_epi8(a2, value16);
+            __m128i r3 = _mm_cmpeq_epi8(a3, value16);
+
+            // subtracting -1 increments byte lane counter
+            __m128i s01 = _mm_add_epi8(r0, r1);
+            __m128i s23 = _mm_add_epi8(r2, r3);
+            sum = _mm_sub_epi8(sum, _mm_add_epi8(s01, s23));
+
+            p += 64;
+        }
 
-        // combine comparisons - leave 0xff in lanes there equal to input value
-        __m256i r = _mm256_or_si256(_mm256_or_si256(r0, r1), _mm256_or_si256(r2, r3));
+        // horizontal sum of byte lane counters into 64-bit counters
+        total = _mm_add_epi64(total, _mm_sad_epu8(sum, zero));
 
-        // extract top bit mask, it will be non-zero if there is at least one matching lane to input value
-        uint32_t mask = (uint32_t)_mm256_movemask_epi8(r);
-        if (mask)
-        {
-            // extract top bit masks for each comparison
-            uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
-            uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
-            uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
-            uint64_t m3 = mask; // if r0=r1=r2=0, then r3=r
+        size -= count * 64;
+    }
 
-            // combine masks
-            uint64_t m01 = m0 | (m1 << 32);
-            uint64_t m23 = m2 | (m3 << 32);
+    // process rest of 16-byte blocks, at most 3
+    {
+        __m128i sum = zero;
+        while (size >= 16)
+        {
+            __m128i a0 = _mm_loadu_si128((const __m128i*)p);
 
-            // find index of byte with difference
-            size_t idx0 = _tzcnt_u64(m01);
-            size_t idx1 = _tzcnt_u64(m23);
+            // subtracting -1 increments byte lane counter
+            sum = _mm_sub_epi8(sum, _mm_cmpeq_epi8(a0, value16));
 
-            // combine both indices to actual index across both comparisons
-            offset += idx0;
-            offset += m01 ? 0 : idx1;
-            return offset;
+            p += 16;
+            size -= 16;
         }
-
-        offset += 128;
-        size -= 128;
-        p += 128;
+        total = _mm_add_epi64(total, _mm_sad_epu8(sum, zero));
     }
 
-    if (size & 64) // 64 <= size < 128
+    total = _mm_add_epi64(total, _mm_unpackhi_epi64(total, total));
+    size_t result = (size_t)_mm_cvtsi128_si64(total);
+
+    if (size) // 0 < size < 16, but initially size > 16
     {
-        // load 128 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
-        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
-        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + size - 0x40));
-        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+        // load 16 bytes from end of buffer
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + size - 16));
 
-        // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
-        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
-        __m256i r2 = _mm256_cmpeq_epi8(value32, a2);
-        __m256i r3 = _mm256_cmpeq_epi8(value32, a3);
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        __m128i r0 = _mm_cmpeq_epi8(a0, value16);
 
-        // extract top bit masks for each comparison
-        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
-        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
-        uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
-        uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+        // drop lowest bits for bytes that were already counted
+        uint32_t m = (uint32_t)_mm_movemask_epi8(r0) >> (16 - size);
 
-        // combine masks
-        uint64_t m01 = m0 | (m1 << 32);
-        uint64_t m23 = m2 | (m3 << 32);
-
-        // get index of byte with difference, plus adjust due to overlap
-        size_t idx0 = _tzcnt_u64(m01);
-        size_t idx1 = _tzcnt_u64(m23) + (size - 64) - 64; // 64 will be already in idx0
-
-        // combine both indices to actual index across both comparisons
-        offset += idx0;
-        offset += m01 ? 0 : idx1;
-        return offset;
-    }
-    else if (size & 32) // 32 <= size < 64
-    {
-        // load 64 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)p);
-        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
-
-        // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
-        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
-
-        // extract top bit masks for each comparison
-        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
-        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
-
-        // combine masks, handling overlapped ones
-        uint64_t m = m0 | (m1 << (size - 32));
-
-        // make sure mask is non-zero, this will result in returning "size" value if inputs are equal
-        m |= 1ULL << size;
-
-        // find first bit set, and return index
-        return offset + _tzcnt_u64(m);
-    }
-    else if (size) // 0 < size < 32, but initially size > 32
-    {
-        // load 32 bytes from end of buffer
-        // this will load previously checked bytes in 128 byte loop (they did not match input value)
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
-
-        // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
-
-        // extract top bit mask
-        uint32_t m = (uint32_t)_mm256_movemask_epi8(r0);
-
-        // find first bit set, adjust it due to reused bytes in load, and return index
-        return offset + _tzcnt_u32(m) + size - 32;
+        result += MEM_POPCNT32(m);
     }
 
-    // no input value found, return original size (current offset plus pending tail size)
-    return offset + size;
+    return result;
 }
 
 MEM_DISABLE_ASAN
-MEM_TARGET_AVX2
-size_t MemFindNot_avx2(const void* ptr, size_t size, uint8_t value)
+size_t MemMismatch_sse2(const void* ptr1, const void* ptr2, size_t size)
 {
-    const uint8_t* p = (const uint8_t*)ptr;
-
-    __m256i value32 = _mm256_set1_epi8((char)value);
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
 
     if (size == 0)
     {
         return 0;
     }
 
-    if (size <= 32)
+    if (size <= 16)
     {
-        size_t address = (uint32_t)(uintptr_t)p % 32;
-        size_t extra = (address + size) <= 32 ? address : 0;
+        const uint32_t PAGE_SIZE = 4096;
 
-        // will load before the beginning buffer (32-byte aligned) if end is too close
-        // to 32-byte boundary, otherwise will load past the end of buffer
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p - extra));
-        // set lane to 0xff if lane matches input value, or 0x00 if not
+        // if 16 bytes from each pointer does not cross page boundary, can safely load them as 16-byte vector
+        uint32_t address = (uint32_t)(uintptr_t)p1 | (uint32_t)(uintptr_t)p2;
+        if ((address & (PAGE_SIZE - 1)) <= PAGE_SIZE - 16)
+        {
+            __m128i a0 = _mm_loadu_si128((const __m128i*)p1);
+            __m128i b0 = _mm_loadu_si128((const __m128i*)p2);
 
-        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+            // set lanes to 0xff if bytes are equal, or 0x00 if not
+            __m128i r0 = _mm_cmpeq_epi8(a0, b0);
 
-        // add 1 to flip lowest 0 bit (non-equal position) to 1, changing all bits below it to 0
-        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
-        uint32_t m = 1U + MEM_SHRX_32((uint32_t)_mm256_movemask_epi8(r0), (uint32_t)extra);
+            // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+            uint32_t m = 1U + (uint16_t)_mm_movemask_epi8(r0);
 
-        // mask out high bits (due to loading bytes after end of buffer)
-        // this will result in returning "size" value if inputs are equal
-        m |= (uint32_t)(1ULL << size);
+            // get index of byte that's different, m is guaranteed non-zero, because there are only max 16 bytes here
+            size_t index = MEM_CTZ32(m);
 
-        // return index of first bit set, which will be index of first byte matching input value
-        return _tzcnt_u32(m);
+            // ignore differences past the end of buffers
+            return index < size ? index : size;
+        }
+
+        // cannot overread buffers, need to load exactly "size" bytes only
+        return MemMismatchSmall(p1, p2, size);
     }
 
     size_t offset = 0;
 
-    // process 128-byte blocks as much as possible
-    while (size >= 128)
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
     {
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
-        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
-        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + 0x40));
-        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + 0x60));
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p1 + 0x00));
+        __m128i b0 = _mm_loadu_si128((const __m128i*)(p2 + 0x00));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p1 + 0x10));
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(p2 + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p1 + 0x20));
+        __m128i b2 = _mm_loadu_si128((const __m128i*)(p2 + 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p1 + 0x30));
+        __m128i b3 = _mm_loadu_si128((const __m128i*)(p2 + 0x30));
 
         // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
-        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
-        __m256i r2 = _mm256_cmpeq_epi8(value32, a2);
-        __m256i r3 = _mm256_cmpeq_epi8(value32, a3);
+        __m128i r0 = _mm_cmpeq_epi8(a0, b0);
+        __m128i r1 = _mm_cmpeq_epi8(a1, b1);
+        __m128i r2 = _mm_cmpeq_epi8(a2, b2);
+        __m128i r3 = _mm_cmpeq_epi8(a3, b3);
 
         // combine comparisons - leave 0x00 in lanes that were not equal
-        __m256i r = _mm256_and_si256(_mm256_and_si256(r0, r1), _mm256_and_si256(r2, r3));
+        __m128i r = _mm_and_si128(_mm_and_si128(r0, r1), _mm_and_si128(r2, r3));
 
         // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
-        uint32_t mask = 1U + (uint32_t)_mm256_movemask_epi8(r);
+        uint16_t mask = 1 + (uint16_t)_mm_movemask_epi8(r);
         if (mask)
         {
             // extract top bit masks for comparisons
-            uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
-            uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
-            uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
-            uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+            uint64_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+            uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+            uint64_t m2 = (uint16_t)_mm_movemask_epi8(r2);
+            uint64_t m3 = (uint16_t)_mm_movemask_epi8(r3);
 
             // combine masks, and flip lowest 0 bit(non - equal position) to 1, changing all bits below it to 0
-            uint64_t m01 = 1ULL + (m0 | (m1 << 32));
-            uint64_t m23 = 1ULL + (m2 | (m3 << 32));
-
-            // find index of byte with difference
-            size_t idx0 = _tzcnt_u64(m01);
-            size_t idx1 = _tzcnt_u64(m23);
+            uint64_t m4 = 1ULL + (m0 | (m1 << 16) | (m2 << 32) | (m3 << 48));
 
-            // combine both indices to actual index across both comparisons
-            offset += idx0;
-            offset += m01 ? 0 : idx1;
-            return offset;
+            // m4 is guaranteed to be non-zero, extract index and return result
+            return offset + MEM_CTZ64(m4);
         }
 
-        offset += 128;
-        size -= 128;
-        p += 128;
+        offset += 64;
+        size -= 64;
+        p1 += 64;
+        p2 += 64;
     }
 
-    if (size & 64) // 64 <= size < 128
+    if (size & 32) // 32 <= size < 64
     {
-        // load 128 bytes, some will overlap
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
-        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
-        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + size - 0x40));
-        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+        // load 64 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p1);
+        __m128i b0 = _mm_loadu_si128((const __m128i*)p2);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p1 + 0x10));
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(p2 + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p1 + size - 0x20));
+        __m128i b2 = _mm_loadu_si128((const __m128i*)(p2 + size - 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p1 + size - 0x10));
+        __m128i b3 = _mm_loadu_si128((const __m128i*)(p2 + size - 0x10));
 
         // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
-        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
-        __m256i r2 = _mm256_cmpeq_epi8(value32, a2);
-        __m256i r3 = _mm256_cmpeq_epi8(value32, a3);
+        __m128i r0 = _mm_cmpeq_epi8(a0, b0);
+        __m128i r1 = _mm_cmpeq_epi8(a1, b1);
+        __m128i r2 = _mm_cmpeq_epi8(a2, b2);
+        __m128i r3 = _mm_cmpeq_epi8(a3, b3);
 
         // extract top bit masks
-        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
-        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
-        uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
-        uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
-
-        // combine masks, flip lowest 0 bit to 1, changing all bits below it to 0
-        uint64_t m01 = 1ULL + (m0 | (m1 << 32));
-        uint64_t m23 = 1ULL + (m2 | (m3 << 32));
+        uint64_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+        uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+        uint64_t m2 = (uint16_t)_mm_movemask_epi8(r2);
+        uint64_t m3 = (uint16_t)_mm_movemask_epi8(r3);
 
-        // get index of byte with difference, plus adjust due to overlap
-        size_t idx0 = _tzcnt_u64(m01);
-        size_t idx1 = _tzcnt_u64(m23) + (size - 64) - 64; // 64 will be already in idx0
+        // combine masks, handling overlapped ones, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint64_t m = 1ULL + (m0 | (m1 << 16) | (m2 << (size - 32)) | (m3 << (size - 16)));
 
-        // combine both indices to actual index across both comparisons
-        offset += idx0;
-        offset += m01 ? 0 : idx1;
-        return offset;
+        // return index of byte that's different, m is guaranteed non-zero, because there only max 63 bytes here
+        return offset + MEM_CTZ64(m);
     }
-    else if (size & 32) // 32 <= size < 64
+    else if (size & 16) // 16 <= size < 32
     {
-        // load 64 bytes, some will overlap
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)p);
-        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+        // load 32 bytes, some will overlap
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p1);
+        __m128i b0 = _mm_loadu_si128((const __m128i*)p2);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p1 + size - 0x10));
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(p2 + size - 0x10));
 
         // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
-        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
+        __m128i r0 = _mm_cmpeq_epi8(a0, b0);
+        __m128i r1 = _mm_cmpeq_epi8(a1, b1);
 
         // extract top bit masks
-        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
-        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+        uint32_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+        uint32_t m1 = (uint16_t)_mm_movemask_epi8(r1);
 
         // combine masks, handling overlapped ones, flip lowest 0 bit to 1, changing all bits below it to 0
-        uint64_t m = 1ULL + (m0 | (m1 << (size - 32)));
+        uint32_t m = 1U + (m0 | (m1 << (size - 16)));
 
-        // return index of byte that's different, m is guaranteed non-zero, because there only max 63 bytes here
-        return offset + _tzcnt_u64(m);
+        // return index of byte that's different, m is guaranteed non-zero, because there only max 31 bytes here
+        return offset + MEM_CTZ32(m);
     }
-    else if (size) // 0 < size < 32, but initially size > 32
+    else if (size) // 0 < size < 16, but initially size > 16
     {
-        // load 32 bytes from end of buffer
-        // this will load previously checked bytes in 64 byte loop (they did match input value)
-        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+        // load 16 bytes from end of buffer
+        // this will load previously checked bytes in 64 byte loop (they were equal)
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p1 + size - 0x10));
+        __m128i b0 = _mm_loadu_si128((const __m128i*)(p2 + size - 0x10));
 
         // set lanes to 0xff if bytes are equal, or 0x00 if not
-        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+        __m128i r0 = _mm_cmpeq_epi8(a0, b0);
 
-        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
-        uint32_t mask = 1U + (uint32_t)_mm256_movemask_epi8(r0);
+        // extract top bit mask, flip lowest 0 bit (non-equal position) to 1, changing all bits below it to 0
+        uint32_t m = 1U + (uint16_t)_mm_movemask_epi8(r0);
 
-        // get index of byte that's different, m is guaranteed non-zero, because there only max 31 bytes here
-        return offset + _tzcnt_u32(mask) + size - 32;
+        // get index of byte that's different, m is guaranteed non-zero, because there only max 15 bytes here
+        return offset + MEM_CTZ32(m) + size - 16;
     }
 
-    // all bytes are same as input value, return original size (current offset plus pending tail size)
+    // no differences found, return original size (current offset plus pending tail size)
     return offset + size;
 }
 
-MEM_TARGET_AVX512
-int MemCompare_avx512(const void* ptr1, const void* ptr2, size_t size)
+MEM_DISABLE_ASAN
+static MEM_FORCE_INLINE void MemConvertCase_sse2(uint8_t* dst, const uint8_t* src, size_t size, uint8_t first)
 {
-    const uint8_t* p1 = (const uint8_t*)ptr1;
-    const uint8_t* p2 = (const uint8_t*)ptr2;
+    if (size < 16)
+    {
+        MemConvertCaseSmall(dst, src, size, first);
+        return;
+    }
 
-    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
-    size_t extra = size & 63;
-    if (extra)
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
     {
-        //  mask to load "extra" amount of bytes
-        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(src + 0x00));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(src + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(src + 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(src + 0x30));
 
-        // do masked load
-        __m512i a = _mm512_maskz_loadu_epi8(mask, p1);
-        __m512i b = _mm512_maskz_loadu_epi8(mask, p2);
+        _mm_storeu_si128((__m128i*)(dst + 0x00), MemConvertCase16(a0, first));
+        _mm_storeu_si128((__m128i*)(dst + 0x10), MemConvertCase16(a1, first));
+        _mm_storeu_si128((__m128i*)(dst + 0x20), MemConvertCase16(a2, first));
+        _mm_storeu_si128((__m128i*)(dst + 0x30), MemConvertCase16(a3, first));
 
-        // check if any bytes are different
-        __mmask64 m = _mm512_cmpneq_epu8_mask(a, b);
-        if (!_kortestz_mask64_u8(m, m))
-        {
-            // if they are different, then find position of byte that is less than other value
-            int r1 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(a, b)));
-            int r2 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(b, a)));
+        size -= 64;
+        src += 64;
+        dst += 64;
+    }
 
-            // return signed difference which is comparison result
-            return r1 - r2;
-        }
+    // process 16-byte blocks
+    while (size >= 16)
+    {
+        __m128i a0 = _mm_loadu_si128((const __m128i*)src);
+        _mm_storeu_si128((__m128i*)dst, MemConvertCase16(a0, first));
 
-        size -= extra;
-        p1 += extra;
-        p2 += extra;
+        size -= 16;
+        src += 16;
+        dst += 16;
     }
 
-    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
-    if (size & 64)
+    if (size) // 0 < size < 16, but initially size >= 16
     {
-        // 64 byte loads
-        __m512i a = _mm512_loadu_epi8(p1);
-        __m512i b = _mm512_loadu_epi8(p2);
+        // convert last 16 bytes, this will convert again some of already converted bytes
+        // which is fine, because converting letters to same case twice gives same result
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(src + size - 16));
+        _mm_storeu_si128((__m128i*)(dst + size - 16), MemConvertCase16(a0, first));
+    }
+}
 
-        // check if any bytes are different
-        __mmask64 m = _mm512_cmpneq_epu8_mask(a, b);
-        if (!_kortestz_mask64_u8(m, m))
-        {
-            // if they are different, then find position of byte that is less than other value
-            int r1 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(a, b)));
-            int r2 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(b, a)));
+MEM_DISABLE_ASAN
+void MemToLower_sse2(void* dst, const void* src, size_t size)
+{
+    MemConvertCase_sse2((uint8_t*)dst, (const uint8_t*)src, size, 'A');
+}
 
-            // return signed difference which is comparison result
-            return r1 - r2;
-        }
+MEM_DISABLE_ASAN
+void MemToUpper_sse2(void* dst, const void* src, size_t size)
+{
+    MemConvertCase_sse2((uint8_t*)dst, (const uint8_t*)src, size, 'a');
+}
 
-        size -= 64;
-        p1 += 64;
-        p2 += 64;
+MEM_DISABLE_ASAN
+size_t MemFindI_sse2(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    // letters are matched by setting 0x20 bit in input bytes, which maps uppercase letters to lowercase
+    const uint8_t fold = MemCaseBit1(value);
+    const __m128i fold16 = _mm_set1_epi8((char)fold);
+    const __m128i value16 = _mm_set1_epi8((char)(value | fold));
+
+    if (size == 0)
+    {
+        return 0;
     }
 
-    // now size is 128-byte multiple, process rest of them in 128-byte blocks
-    while (size)
+    if (size <= 16)
     {
-        __m512i a0 = _mm512_loadu_epi8(p1 + 0x00);
-        __m512i b0 = _mm512_loadu_epi8(p2 + 0x00);
-        __m512i a1 = _mm512_loadu_epi8(p1 + 0x40);
-        __m512i b1 = _mm512_loadu_epi8(p2 + 0x40);
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
 
-        // check if any bytes are different
-        __mmask64 m0 = _mm512_cmpneq_epu8_mask(a0, b0);
-        __mmask64 m1 = _mm512_cmpneq_epu8_mask(a1, b1);
-        if (!_kortestz_mask64_u8(m0, m1))
-        {
-            // if they are different, then find position of byte that is less than other value
-            int r10 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(a0, b0)));
-            int r20 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(b0, a0)));
-            int r11 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(a1, b1)));
-            int r21 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(b1, a1)));
+        // will load before the beginning buffer (16-byte aligned) if end is too close
+        // to 16-byte boundary, otherwise will load past the end of buffer
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p - extra));
 
-            // if low 64 bytes are the same, use indices for high 64 bytes
-            int r1 = (r10 == r20) ? r11 : r10;
-            int r2 = (r10 == r20) ? r21 : r20;
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        __m128i r0 = _mm_cmpeq_epi8(value16, _mm_or_si128(a0, fold16));
 
-            // return signed difference which is comparison result
-            return r1 - r2;
-        }
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        uint32_t m = (uint16_t)_mm_movemask_epi8(r0) >> extra;
 
-        size -= 128;
-        p1 += 128;
-        p2 += 128;
-    }
+        // mask out high bits (due to loading bytes after end of buffer)
+        // this will make mask non-zero, and will result in returning "size" value if inputs are equal
+        m |= 1U << size;
 
-    // no differences found, inputs are equal
-    return 0;
-}
+        // return index of first bit set, which will be index of first byte matching input value
+        return MEM_CTZ32(m);
+    }
 
-MEM_TARGET_AVX512
-int MemCompareI_avx512(const void* ptr1, const void* ptr2, size_t size)
-{
-    const uint8_t* p1 = (const uint8_t*)ptr1;
-    const uint8_t* p2 = (const uint8_t*)ptr2;
+    size_t offset = 0;
 
-    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
-    size_t extra = size & 63;
-    if (extra)
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
     {
-        //  mask to load "extra" amount of bytes
-        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + 0x00));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p + 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p + 0x30));
 
-        // do masked load & convert to lowercase
-        __m512i a = MemToLower64(_mm512_maskz_loadu_epi8(mask, p1));
-        __m512i b = MemToLower64(_mm512_maskz_loadu_epi8(mask, p2));
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        __m128i r0 = _mm_cmpeq_epi8(value16, _mm_or_si128(a0, fold16));
+        __m128i r1 = _mm_cmpeq_epi8(value16, _mm_or_si128(a1, fold16));
+        __m128i r2 = _mm_cmpeq_epi8(value16, _mm_or_si128(a2, fold16));
+        __m128i r3 = _mm_cmpeq_epi8(value16, _mm_or_si128(a3, fold16));
 
-        // check if any bytes are different
-        __mmask64 m = _mm512_cmpneq_epu8_mask(a, b);
-        if (!_kortestz_mask64_u8(m, m))
+        // combine comparisons - leave 0xff in lanes there equal to input value
+        __m128i r = _mm_or_si128(_mm_or_si128(r0, r1), _mm_or_si128(r2, r3));
+
+        // extract top bit mask, it will be non-zero if there is at least one matching lane to input value
+        uint16_t mask = (uint16_t)_mm_movemask_epi8(r);
+        if (mask)
         {
-            // if they are different, then find position of byte that is less than other value
-            int r1 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(a, b)));
-            int r2 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(b, a)));
+            // extract top bit masks for each comparison
+            uint64_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+            uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+            uint64_t m2 = (uint16_t)_mm_movemask_epi8(r2);
+            uint64_t m3 = mask; // if r0=r1=r2=0, then r3=r
 
-            // return signed difference which is comparison result
-            return r1 - r2;
+            // combine them into one mask, m4 is guaranteed to be non-zero
+            uint64_t m4 = m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+
+            // find first bit set, and return index
+            return offset + MEM_CTZ64(m4);
         }
 
-        size -= extra;
-        p1 += extra;
-        p2 += extra;
+        offset += 64;
+        size -= 64;
+        p += 64;
     }
 
-    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
-    if (size & 64)
+    if (size & 32) // 32 <= size < 64
     {
-        // 64 byte loads & convert to lowercase
-        __m512i a = MemToLower64(_mm512_loadu_epi8(p1));
-        __m512i b = MemToLower64(_mm512_loadu_epi8(p2));
+        // load 64 bytes, some will overlap
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p + size - 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p + size - 0x10));
 
-        // check if any bytes are different
-        __mmask64 m = _mm512_cmpneq_epu8_mask(a, b);
-        if (!_kortestz_mask64_u8(m, m))
-        {
-            // if they are different, then find position of byte that is less than other value
-            int r1 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(a, b)));
-            int r2 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(b, a)));
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m128i r0 = _mm_cmpeq_epi8(value16, _mm_or_si128(a0, fold16));
+        __m128i r1 = _mm_cmpeq_epi8(value16, _mm_or_si128(a1, fold16));
+        __m128i r2 = _mm_cmpeq_epi8(value16, _mm_or_si128(a2, fold16));
+        __m128i r3 = _mm_cmpeq_epi8(value16, _mm_or_si128(a3, fold16));
 
-            // return signed difference which is comparison result
-            return r1 - r2;
-        }
+        // extract top bit masks for each comparison
+        uint64_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+        uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+        uint64_t m2 = (uint16_t)_mm_movemask_epi8(r2);
+        uint64_t m3 = (uint16_t)_mm_movemask_epi8(r3);
 
-        size -= 64;
-        p1 += 64;
-        p2 += 64;
-    }
+        // combine masks, handling overlapped ones
+        uint64_t m = m0 | (m1 << 16) | (m2 << (size - 32)) | (m3 << (size - 16));
 
-    // now size is 128-byte multiple, process rest of them in 128-byte blocks
-    while (size)
+        // make sure mask is non-zero, this will result in returning "size" value if inputs are equal
+        m |= 1ULL << size;
+
+        // find first bit set, and return index
+        return offset + MEM_CTZ64(m);
+    }
+    else if (size & 16) // 16 <= size < 32
     {
-        __m512i a0 = MemToLower64(_mm512_loadu_epi8(p1 + 0x00));
-        __m512i b0 = MemToLower64(_mm512_loadu_epi8(p2 + 0x00));
-        __m512i a1 = MemToLower64(_mm512_loadu_epi8(p1 + 0x40));
-        __m512i b1 = MemToLower64(_mm512_loadu_epi8(p2 + 0x40));
+        // load 32 bytes, some will overlap
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + size - 0x10));
 
-        // check if any bytes are different
-        __mmask64 m0 = _mm512_cmpneq_epu8_mask(a0, b0);
-        __mmask64 m1 = _mm512_cmpneq_epu8_mask(a1, b1);
-        if (!_kortestz_mask64_u8(m0, m1))
-        {
-            // if they are different, then find position of byte that is less than other value
-            int r10 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(a0, b0)));
-            int r20 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(b0, a0)));
-            int r11 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(a1, b1)));
-            int r21 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(b1, a1)));
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m128i r0 = _mm_cmpeq_epi8(value16, _mm_or_si128(a0, fold16));
+        __m128i r1 = _mm_cmpeq_epi8(value16, _mm_or_si128(a1, fold16));
 
-            // if low 64 bytes are the same, use indices for high 64 bytes
-            int r1 = (r10 == r20) ? r11 : r10;
-            int r2 = (r10 == r20) ? r21 : r20;
+        // extract top bit masks for each comparison
+        uint32_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+        uint32_t m1 = (uint16_t)_mm_movemask_epi8(r1);
 
-            // return signed difference which is comparison result
-            return r1 - r2;
-        }
+        // combine masks, handling overlapped ones
+        uint32_t m = m0 | (m1 << (size - 16));
 
-        size -= 128;
-        p1 += 128;
-        p2 += 128;
+        // make sure mask is non-zero, this will result in returning "size" value if inputs are equal
+        m |= 1U << size;
+
+        // find first bit set, and return index
+        return offset + MEM_CTZ32(m);
     }
+    else if (size) // 0 < size < 16, but initially size > 16
+    {
+        // load 16 bytes from end of buffer
+        // this will load previously checked bytes in 64 byte loop (they did not match input value)
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + size - 0x10));
 
-    // no differences found, inputs are equal
-    return 0;
-}
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m128i r0 = _mm_cmpeq_epi8(value16, _mm_or_si128(a0, fold16));
 
-MEM_TARGET_AVX512
-bool MemIsEqual_avx512(const void* ptr1, const void* ptr2, size_t size)
-{
-    const uint8_t* p1 = (const uint8_t*)ptr1;
-    const uint8_t* p2 = (const uint8_t*)ptr2;
+        // extract top bit mask, make sure it is non-zero
+        uint32_t m = (uint16_t)_mm_movemask_epi8(r0) | (1U << 16);
 
-    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
-    size_t extra = size & 63;
-    if (extra)
-    {
-        //  mask to load "extra" amount of bytes
-        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+        // find first bit set, adjust it due to reused bytes in load, and return index
+        return offset + MEM_CTZ32(m) + size - 16;
+    }
 
-        // do masked load & convert to lowercase
-        __m512i a = _mm512_maskz_loadu_epi8(mask, p1);
-        __m512i b = _mm512_maskz_loadu_epi8(mask, p2);
+    // no input value found, return original size (current offset plus pending tail size)
+    return offset + size;
+}
 
-        // check if any bytes are different
-        __mmask64 m = _mm512_cmpneq_epu8_mask(a, b);
-        if (!_kortestz_mask64_u8(m, m))
+MEM_DISABLE_ASAN
+static MEM_FORCE_INLINE size_t MemFindBytesICheck_sse2(const uint8_t* p, const uint8_t* n, size_t nlen, uint64_t mask)
+{
+    // first and last bytes are already matching for every bit set in mask, verify rest of the needle
+    while (mask)
+    {
+        size_t index = MEM_CTZ64(mask);
+        if (MemCompareI_sse2(p + index + 1, n + 1, nlen - 2) == 0)
         {
-            // they are different
-            return false;
+            return index;
         }
-
-        size -= extra;
-        p1 += extra;
-        p2 += extra;
+        mask &= mask - 1;
     }
+    return 64;
+}
 
-    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
-    if (size & 64)
-    {
-        // 64 byte loads
-        __m512i a = _mm512_loadu_epi8(p1);
-        __m512i b = _mm512_loadu_epi8(p2);
-
-        // check if any bytes are different
-        __mmask64 m = _mm512_cmpneq_epu8_mask(a, b);
-        if (!_kortestz_mask64_u8(m, m))
-        {
-            // they are different
-            return false;
-        }
+MEM_DISABLE_ASAN
+size_t MemFindBytesI_sse2(const void* ptr, size_t size, const void* needle, size_t needlelen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* n = (const uint8_t*)needle;
 
-        size -= 64;
-        p1 += 64;
-        p2 += 64;
+    if (needlelen == 0)
+    {
+        return 0;
     }
-
-    // now size is 128-byte multiple, process rest of them in 128-byte blocks
-    while (size)
+    else if (needlelen == 1)
     {
-        __m512i a0 = _mm512_loadu_epi8(p1 + 0x00);
-        __m512i b0 = _mm512_loadu_epi8(p2 + 0x00);
-        __m512i a1 = _mm512_loadu_epi8(p1 + 0x40);
-        __m512i b1 = _mm512_loadu_epi8(p2 + 0x40);
-
-        // check if any bytes are different
-        __mmask64 m0 = _mm512_cmpneq_epu8_mask(a0, b0);
-        __mmask64 m1 = _mm512_cmpneq_epu8_mask(a1, b1);
-        if (!_kortestz_mask64_u8(m0, m1))
-        {
-            // they are different
-            return false;
-        }
-
-        size -= 128;
-        p1 += 128;
-        p2 += 128;
+        return MemFindI_sse2(ptr, size, n[0]);
+    }
+    else if (needlelen > size)
+    {
+        return size;
     }
 
-    // no differences found, inputs are equal
-    return true;
-}
+    // offset of last needle byte, and amount of positions where needle can start
+    size_t last = needlelen - 1;
+    size_t count = size - last;
 
-MEM_TARGET_AVX512
-size_t MemFind_avx512(const void* ptr, size_t size, uint8_t value)
-{
-    const uint8_t* p = (const uint8_t*)ptr;
-    const __m512i value64 = _mm512_set1_epi8((char)value);
+    // letters are matched by setting 0x20 bit in input bytes, which maps uppercase letters to lowercase
+    const uint8_t first_fold = MemCaseBit1(n[0]);
+    const uint8_t last_fold = MemCaseBit1(n[last]);
 
-    size_t offset = 0;
+    const __m128i first_fold16 = _mm_set1_epi8((char)first_fold);
+    const __m128i last_fold16 = _mm_set1_epi8((char)last_fold);
+    const __m128i first16 = _mm_set1_epi8((char)(n[0] | first_fold));
+    const __m128i last16 = _mm_set1_epi8((char)(n[last] | last_fold));
 
-    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
-    size_t extra = size & 63;
-    if (extra)
+    if (size <= 16)
     {
-        //  mask to load "extra" amount of bytes
-        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
-
-        // do masked load, zeroing out upper bytes
-        __m512i a = _mm512_maskz_loadu_epi8(mask, p);
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
 
-        // check if any bytes matches input value, only low "extra" bytes
-        __mmask64 m = _mm512_mask_cmpeq_epu8_mask(mask, value64, a);
-        if (!_kortestz_mask64_u8(m, m))
-        {
-            // if it does, return index of lowest byte that matches
-            return (size_t)_tzcnt_u64(_cvtmask64_u64(m));
-        }
+        // whole buffer fits in one load, it will load before the beginning buffer (16-byte aligned)
+        // if end is too close to 16-byte boundary, otherwise will load past the end of buffer
+        __m128i a = _mm_loadu_si128((const __m128i*)(p - extra));
 
-        offset += extra;
-        size -= extra;
-        p += extra;
-    }
+        // set lane to 0xff if lane matches first/last needle byte, or 0x00 if not
+        __m128i r0 = _mm_cmpeq_epi8(_mm_or_si128(a, first_fold16), first16);
+        __m128i r1 = _mm_cmpeq_epi8(_mm_or_si128(a, last_fold16), last16);
 
-    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
-    if (size & 64)
-    {
-        // 64 byte load
-        __m512i a = _mm512_loadu_epi8(p);
+        // drop any lowest "extra" bits, and shift last byte matches down to their starting position
+        uint32_t m0 = (uint32_t)_mm_movemask_epi8(r0) >> extra;
+        uint32_t m1 = (uint32_t)_mm_movemask_epi8(r1) >> (extra + last);
 
-        // check if any bytes matches input value
-        __mmask64 m = _mm512_cmpeq_epu8_mask(value64, a);
-        if (!_kortestz_mask64_u8(m, m))
-        {
-            // if it does, return index of lowest byte that matches
-            return offset + (size_t)_tzcnt_u64(_cvtmask64_u64(m));
-        }
+        // keep only positions where whole needle fits in buffer
+        uint32_t mask = m0 & m1 & ((1U << count) - 1);
 
-        offset += 64;
-        size -= 64;
-        p += 64;
+        size_t index = MemFindBytesICheck_sse2(p, n, needlelen, mask);
+        return index < 64 ? index : size;
     }
 
-    // now size is 128-byte multiple, process rest of them in 128-byte blocks
-    while (size)
+    size_t offset = 0;
+
+    // process 64 starting positions at a time
+    while (count - offset >= 64)
     {
-        __m512i a0 = _mm512_loadu_epi8(p + 0x00);
-        __m512i a1 = _mm512_loadu_epi8(p + 0x40);
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + offset + 0x00));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + offset + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p + offset + 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p + offset + 0x30));
+        __m128i b0 = _mm_loadu_si128((const __m128i*)(p + offset + last + 0x00));
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(p + offset + last + 0x10));
+        __m128i b2 = _mm_loadu_si128((const __m128i*)(p + offset + last + 0x20));
+        __m128i b3 = _mm_loadu_si128((const __m128i*)(p + offset + last + 0x30));
+
+        // set lane to 0xff if both first and last needle bytes match, or 0x00 if not
+        __m128i r0 = _mm_and_si128(_mm_cmpeq_epi8(_mm_or_si128(a0, first_fold16), first16), _mm_cmpeq_epi8(_mm_or_si128(b0, last_fold16), last16));
+        __m128i r1 = _mm_and_si128(_mm_cmpeq_epi8(_mm_or_si128(a1, first_fold16), first16), _mm_cmpeq_epi8(_mm_or_si128(b1, last_fold16), last16));
+        __m128i r2 = _mm_and_si128(_mm_cmpeq_epi8(_mm_or_si128(a2, first_fold16), first16), _mm_cmpeq_epi8(_mm_or_si128(b2, last_fold16), last16));
+        __m128i r3 = _mm_and_si128(_mm_cmpeq_epi8(_mm_or_si128(a3, first_fold16), first16), _mm_cmpeq_epi8(_mm_or_si128(b3, last_fold16), last16));
+
+        // combine comparisons, it will be non-zero if there is at least one candidate position
+        __m128i r = _mm_or_si128(_mm_or_si128(r0, r1), _mm_or_si128(r2, r3));
 
-        // check if any bytes matches input value
-        __mmask64 m0 = _mm512_cmpeq_epu8_mask(value64, a0);
-        __mmask64 m1 = _mm512_cmpeq_epu8_mask(value64, a1);
-        if (!_kortestz_mask64_u8(m0, m1))
+        if (_mm_movemask_epi8(r))
         {
-            // if it does, get index of lowest byte that matches
-            size_t r0 = _tzcnt_u64(_cvtmask64_u64(m0));
-            size_t r1 = _tzcnt_u64(_cvtmask64_u64(m1));
-
-            // combine both indices to actual index across both comparisons
-            offset += r0;
-            offset += r0 == 64 ? r1 : 0;
-            return offset;
+            // extract top bit masks for each comparison
+            uint64_t m0 = (uint32_t)_mm_movemask_epi8(r0);
+            uint64_t m1 = (uint32_t)_mm_movemask_epi8(r1);
+            uint64_t m2 = (uint32_t)_mm_movemask_epi8(r2);
+            uint64_t m3 = (uint32_t)_mm_movemask_epi8(r3);
+            uint64_t m = m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+
+            size_t index = MemFindBytesICheck_sse2(p + offset, n, needlelen, m);
+            if (index < 64)
+            {
+                return offset + index;
+            }
         }
 
-        offset += 128;
-        size -= 128;
-        p += 128;
+        offset += 64;
     }
 
-    // no input value found
-    return offset;
-}
-
-MEM_TARGET_AVX512
-size_t MemFindNot_avx512(const void* ptr, size_t size, uint8_t value)
-{
-    const uint8_t* p = (const uint8_t*)ptr;
-    const __m512i value64 = _mm512_set1_epi8((char)value);
-
-    size_t offset = 0;
-
-    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
-    size_t extra = size & 63;
-    if (extra)
+    // process rest of 16 starting position blocks
+    while (count - offset >= 16)
     {
-        //  mask to load "extra" amount of bytes
-        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+        __m128i a = _mm_loadu_si128((const __m128i*)(p + offset));
+        __m128i b = _mm_loadu_si128((const __m128i*)(p + offset + last));
 
-        // do masked load, zeroing out upper bytes
-        __m512i a = _mm512_maskz_loadu_epi8(mask, p);
+        // set lane to 0xff if both first and last needle bytes match, or 0x00 if not
+        __m128i r = _mm_and_si128(_mm_cmpeq_epi8(_mm_or_si128(a, first_fold16), first16), _mm_cmpeq_epi8(_mm_or_si128(b, last_fold16), last16));
 
-        // check if any bytes are different, only low "extra" bytes
-        __mmask64 m = _mm512_mask_cmpneq_epu8_mask(mask, value64, a);
-        if (!_kortestz_mask64_u8(m, m))
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(r);
+        if (mask)
         {
-            // if they are, return index of lowest byte that does not match
-            return (size_t)_tzcnt_u64(_cvtmask64_u64(m));
+            size_t index = MemFindBytesICheck_sse2(p + offset, n, needlelen, mask);
+            if (index < 64)
+            {
+                return offset + index;
+            }
         }
 
-        offset += extra;
-        size -= extra;
-        p += extra;
+        offset += 16;
     }
 
-    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
-    if (size & 64)
+    if (offset < count) // 0 < tail < 16
     {
-        // 64 byte load
-        __m512i a = _mm512_loadu_epi8(p);
+        size_t tail = count - offset;
 
-        // check if any bytes are different
-        __mmask64 m = _mm512_cmpneq_epu8_mask(value64, a);
-        if (!_kortestz_mask64_u8(m, m))
-        {
-            // if they are, return index of lowest byte that does not match
-            return offset + (size_t)_tzcnt_u64(_cvtmask64_u64(m));
-        }
+        // load first bytes ending at last starting position (or from beginning of buffer if there are
+        // less than 16 starting positions), and last bytes ending at end of buffer
+        // this will load previously checked positions, they will be shifted out from masks
+        size_t start = count >= 16 ? count - 16 : 0;
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + start));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + size - 16));
 
-        offset += 64;
-        size -= 64;
-        p += 64;
-    }
+        // set lane to 0xff if lane matches first/last needle byte, or 0x00 if not
+        __m128i r0 = _mm_cmpeq_epi8(_mm_or_si128(a0, first_fold16), first16);
+        __m128i r1 = _mm_cmpeq_epi8(_mm_or_si128(a1, last_fold16), last16);
 
-    // now size is 128-byte multiple, process rest of them in 128-byte blocks
-    while (size)
-    {
-        __m512i a0 = _mm512_loadu_epi8(p + 0x00);
-        __m512i a1 = _mm512_loadu_epi8(p + 0x40);
+        // align both masks to current offset, shift of last byte mask also leaves only "tail" bits
+        uint32_t m0 = (uint32_t)_mm_movemask_epi8(r0) >> (offset - start);
+        uint32_t m1 = (uint32_t)_mm_movemask_epi8(r1) >> (16 - tail);
 
-        // check if any bytes are different
-        __mmask64 m0 = _mm512_cmpneq_epu8_mask(value64, a0);
-        __mmask64 m1 = _mm512_cmpneq_epu8_mask(value64, a1);
-        if (!_kortestz_mask64_u8(m0, m1))
+        size_t index = MemFindBytesICheck_sse2(p + offset, n, needlelen, m0 & m1);
+        if (index < 64)
         {
-            // if they are, get index of lowest byte that does not match
-            size_t r0 = _tzcnt_u64(_cvtmask64_u64(m0));
-            size_t r1 = _tzcnt_u64(_cvtmask64_u64(m1));
-
-            // combine both indices to actual index across both comparisons
-            offset += r0;
-            offset += r0 == 64 ? r1 : 0;
-            return offset;
+            return offset + index;
         }
-
-        offset += 128;
-        size -= 128;
-        p += 128;
     }
 
-    // all bytes are same as input value
-    return offset;
+    // needle not found
+    return size;
 }
 
-#endif
-
+MEM_DISABLE_ASAN
+size_t MemFindInRange_sse2(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
 
-#if MEM_ARCH_ARM64
+    if (lo > hi)
+    {
+        // empty range, no byte can be inside it
+        return size;
+    }
 
-static inline uint8x16_t MemToLower16(uint8x16_t x)
-{
-    uint8x16_t tmp = vsubq_u8(x, vdupq_n_u8('A'));
-    tmp = vcleq_u8(tmp, vdupq_n_u8('Z' - 'A'));
-    tmp = vandq_u8(tmp, vdupq_n_u8('a' - 'A'));
-    return vaddq_u8(x, tmp);
-}
+    // byte is inside range when unsigned (x - lo) <= (hi - lo)
+    const uint8_t range = (uint8_t)(hi - lo);
 
-MEM_DISABLE_ASAN
-int MemCompare_neon(const void* ptr1, const void* ptr2, size_t size)
-{
-    const uint8_t* p1 = (const uint8_t*)ptr1;
-    const uint8_t* p2 = (const uint8_t*)ptr2;
+    // unsigned comparison is done as signed one by flipping top bit of both sides with 0x80 bias
+    const __m128i lo16 = _mm_set1_epi8((char)(lo ^ 0x80));
+    const __m128i range16 = _mm_set1_epi8((char)(range ^ 0x80));
 
     if (size == 0)
     {
@@ -2625,641 +3514,459 @@ int MemCompare_neon(const void* ptr1, const void* ptr2, size_t size)
 
     if (size <= 16)
     {
-        if (size < 2) // size == 1
-        {
-            return p1[0] - p2[0];
-        }
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
 
-        // will load pair of 4, 8 or 16 overlapping bytes
-        // a/b0 from beginning of buffer
-        // a/b1 from end of buffers
-        uint64_t a0, b0, a1, b1;
+        // will load before the beginning buffer (16-byte aligned) if end is too close
+        // to 16-byte boundary, otherwise will load past the end of buffer
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p - extra));
 
-        if (size < 4) // 2 <= size < 4
-        {
-            a0 = MEM_PTR16U(p1);
-            b0 = MEM_PTR16U(p2);
-            a1 = MEM_PTR16U(p1 + size - 2);
-            b1 = MEM_PTR16U(p2 + size - 2);
-        }
-        else if (size < 8) // 4 <= size < 8
-        {
-            a0 = MEM_PTR32U(p1);
-            b0 = MEM_PTR32U(p2);
-            a1 = MEM_PTR32U(p1 + size - 4);
-            b1 = MEM_PTR32U(p2 + size - 4);
-        }
-        else // 8 <= size <= 16
-        {
-            a0 = MEM_PTR64U(p1);
-            b0 = MEM_PTR64U(p2);
-            a1 = MEM_PTR64U(p1 + size - 8);
-            b1 = MEM_PTR64U(p2 + size - 8);
-        }
+        // set lane to 0xff if lane is outside of range, or 0x00 if not
+        __m128i r0 = _mm_cmpgt_epi8(_mm_sub_epi8(a0, lo16), range16);
 
-        // use a0/b0 if they are not equal, otherwise a1/b1
-        // byte swap because in big-endian bytes can be compared as uint64 numbers
-        uint64_t a = MEM_BSWAP64(a0 != b0 ? a0 : a1);
-        uint64_t b = MEM_BSWAP64(a0 != b0 ? b0 : b1);
+        // add 1 to flip lowest 0 bit (position inside range) to 1, changing all bits below it to 0
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        uint32_t m = 1U + ((uint16_t)_mm_movemask_epi8(r0) >> extra);
 
-        return (a > b) - (a < b);
+        // mask out high bits (due to loading bytes after end of buffer)
+        // this will make mask non-zero, and will result in returning "size" value if no byte inside range found
+        m |= 1U << size;
+
+        // return index of first bit set, which will be index of first byte inside range
+        return MEM_CTZ32(m);
     }
 
-    const uint8x16_t index4 = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201));
+    size_t offset = 0;
 
     // process 64-byte blocks as much as possible
     while (size >= 64)
     {
-        uint8x16x4_t a = vld1q_u8_x4(p1);
-        uint8x16x4_t b = vld1q_u8_x4(p2);
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + 0x00));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p + 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p + 0x30));
 
-        // set lanes to 0xff if bytes are equal, or 0x00 if not
-        uint8x16_t c0 = vceqq_u8(a.val[0], b.val[0]);
-        uint8x16_t c1 = vceqq_u8(a.val[1], b.val[1]);
-        uint8x16_t c2 = vceqq_u8(a.val[2], b.val[2]);
-        uint8x16_t c3 = vceqq_u8(a.val[3], b.val[3]);
+        // set lanes to 0xff if bytes are outside of range, or 0x00 if not
+        __m128i r0 = _mm_cmpgt_epi8(_mm_sub_epi8(a0, lo16), range16);
+        __m128i r1 = _mm_cmpgt_epi8(_mm_sub_epi8(a1, lo16), range16);
+        __m128i r2 = _mm_cmpgt_epi8(_mm_sub_epi8(a2, lo16), range16);
+        __m128i r3 = _mm_cmpgt_epi8(_mm_sub_epi8(a3, lo16), range16);
 
-        // combine comparisons - leave 0xff in lanes that were not equal in at least one of inputs
-        uint8x16_t c = vmvnq_u8(vandq_u8(vandq_u8(c0, c1), vandq_u8(c2, c3)));
+        // combine comparisons - leave 0x00 in lanes that were inside range
+        __m128i r = _mm_and_si128(_mm_and_si128(r0, r1), _mm_and_si128(r2, r3));
 
-        // nibbles will contain 16 masks with 4-bit value 0xf for lanes that were not equal
-        // meaning if nibbles is non-zero, then there is mismatch in input bytes
-        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(c), 4);
-        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
-        if (nibbles)
+        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint16_t mask = 1 + (uint16_t)_mm_movemask_epi8(r);
+        if (mask)
         {
-            // change all lanes with 0xff byte to 0
-            // but for lanes with 0x00 byte keep its index (8 based)
-            uint8x16_t m0 = vbicq_u8(index4, c0);
-            uint8x16_t m1 = vbicq_u8(index4, c1);
-            uint8x16_t m2 = vbicq_u8(index4, c2);
-            uint8x16_t m3 = vbicq_u8(index4, c3);
-
-            // sum pairs of masks, so result fits into 64-bit low lane
-            uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
-            uint8x16_t s2 = vpaddq_u8(s1, s1);
-
-            // now s3 will have bit set 1 in position we want to extract
-            uint64_t s3 = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+            // extract top bit masks for comparisons
+            uint64_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+            uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+            uint64_t m2 = (uint16_t)_mm_movemask_epi8(r2);
+            uint64_t m3 = (uint16_t)_mm_movemask_epi8(r3);
 
-            // get index for byte position that's different in inputs, s3 is non-zero here
-            size_t index = MEM_CTZ64(s3);
+            // combine masks, and flip lowest 0 bit(position inside range) to 1, changing all bits below it to 0
+            uint64_t m4 = 1ULL + (m0 | (m1 << 16) | (m2 << 32) | (m3 << 48));
 
-            return p1[index] - p2[index];
+            // m4 is guaranteed to be non-zero, extract index and return result
+            return offset + MEM_CTZ64(m4);
         }
 
+        offset += 64;
         size -= 64;
-        p1 += 64;
-        p2 += 64;
+        p += 64;
     }
 
     if (size & 32) // 32 <= size < 64
     {
         // load 64 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
-        uint8x16x2_t a0 = vld1q_u8_x2(p1);
-        uint8x16x2_t b0 = vld1q_u8_x2(p2);
-        uint8x16x2_t a1 = vld1q_u8_x2(p1 + size - 0x20);
-        uint8x16x2_t b1 = vld1q_u8_x2(p2 + size - 0x20);
-
-        // set lanes to 0xff if bytes are equal, or 0x00 if not
-        uint8x16_t c0 = vceqq_u8(a0.val[0], b0.val[0]);
-        uint8x16_t c1 = vceqq_u8(a0.val[1], b0.val[1]);
-        uint8x16_t c2 = vceqq_u8(a1.val[0], b1.val[0]);
-        uint8x16_t c3 = vceqq_u8(a1.val[1], b1.val[1]);
-
-        // comparisons to bit index masks
-        uint8x16_t m0 = vbicq_u8(index4, c0);
-        uint8x16_t m1 = vbicq_u8(index4, c1);
-        uint8x16_t m2 = vbicq_u8(index4, c2);
-        uint8x16_t m3 = vbicq_u8(index4, c3);
-
-        // sum pairs of masks, so result fits into 64-bit low lane
-        uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
-        uint8x16_t s2 = vpaddq_u8(s1, s1);
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p + size - 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p + size - 0x10));
 
-        // extract 64-bit index mask
-        uint64_t m = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+        // set lanes to 0xff if bytes are outside of range, or 0x00 if not
+        __m128i r0 = _mm_cmpgt_epi8(_mm_sub_epi8(a0, lo16), range16);
+        __m128i r1 = _mm_cmpgt_epi8(_mm_sub_epi8(a1, lo16), range16);
+        __m128i r2 = _mm_cmpgt_epi8(_mm_sub_epi8(a2, lo16), range16);
+        __m128i r3 = _mm_cmpgt_epi8(_mm_sub_epi8(a3, lo16), range16);
 
-        // get index for byte position that's different in inputs, or 64 if inputs are equal
-        size_t index = m ? MEM_CTZ64(m) : 64;
+        // extract top bit masks
+        uint64_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+        uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+        uint64_t m2 = (uint16_t)_mm_movemask_epi8(r2);
+        uint64_t m3 = (uint16_t)_mm_movemask_epi8(r3);
 
-        // adjust index to correct byte position, due to reused bytes in load
-        // index = (index < 32) ? index : (index - 32) + (size - 32);
-        index += (index >= 32) * (size - 64);
+        // combine masks, handling overlapped ones, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint64_t m = 1ULL + (m0 | (m1 << 16) | (m2 << (size - 32)) | (m3 << (size - 16)));
 
-        // return comparison result, or 0 if inputs are equal
-        return index < size ? p1[index] - p2[index] : 0;
+        // return index of byte inside range, m is guaranteed non-zero, because there only max 63 bytes here
+        return offset + MEM_CTZ64(m);
     }
     else if (size & 16) // 16 <= size < 32
     {
         // load 32 bytes, some will overlap
-        uint8x16_t a0 = vld1q_u8(p1);
-        uint8x16_t b0 = vld1q_u8(p2);
-        uint8x16_t a1 = vld1q_u8(p1 + size - 0x10);
-        uint8x16_t b1 = vld1q_u8(p2 + size - 0x10);
-
-        // set lanes to 0xff if bytes are equal, or 0x00 if not
-        uint8x16_t c0 = vceqq_u8(a0, b0);
-        uint8x16_t c1 = vceqq_u8(a1, b1);
-
-        // comparisons to bit index masks
-        uint8x16_t m0 = vbicq_u8(index4, c0);
-        uint8x16_t m1 = vbicq_u8(index4, c1);
-
-        // sum pairs of masks, so result fits into 64-bit low lane
-        uint8x16_t s1 = vpaddq_u8(m0, m1);
-        uint8x16_t s2 = vpaddq_u8(s1, s1);
-        uint8x16_t s3 = vpaddq_u8(s2, s2);
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + size - 0x10));
 
-        // extract 64-bit index mask
-        uint32_t m = vgetq_lane_u32(vreinterpretq_u32_u8(s3), 0);
+        // set lanes to 0xff if bytes are outside of range, or 0x00 if not
+        __m128i r0 = _mm_cmpgt_epi8(_mm_sub_epi8(a0, lo16), range16);
+        __m128i r1 = _mm_cmpgt_epi8(_mm_sub_epi8(a1, lo16), range16);
 
-        // get index for byte position that's different in inputs, or 32 if inputs are equal
-        size_t index = m ? MEM_CTZ32(m) : 32;
+        // extract top bit masks
+        uint32_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+        uint32_t m1 = (uint16_t)_mm_movemask_epi8(r1);
 
-        // adjust index to correct byte position, due to reused bytes in load
-        // index = (index < 16) ? index : (index - 16) + (size - 16);
-        index += (index >= 16) * (size - 32);
+        // combine masks, handling overlapped ones, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint32_t m = 1U + (m0 | (m1 << (size - 16)));
 
-        // return comparison result, or 0 if inputs are equal
-        return index < size ? p1[index] - p2[index] : 0;
+        // return index of byte inside range, m is guaranteed non-zero, because there only max 31 bytes here
+        return offset + MEM_CTZ32(m);
     }
     else if (size) // 0 < size < 16, but initially size > 16
     {
         // load 16 bytes from end of buffer
-        // this will load previously checked bytes in 64 byte loop (they were equal)
-        uint8x16_t a = vld1q_u8(p1 + size - 16);
-        uint8x16_t b = vld1q_u8(p2 + size - 16);
-
-        // set lanes to 0x00 if bytes are equal, or 0xff if not
-        uint8x16_t c = vmvnq_u8(vceqq_u8(a, b));
-
-        // nibbles will contain 16 masks with 4-bit value 0x0 if lanes were equal
-        // if there is one lane that was not equal, it contains 0xf
-        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(c), 4);
-        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        // this will load previously checked bytes in 64 byte loop (they were outside of range)
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + size - 0x10));
 
-        // get index for byte position that's different in inputs, or 16
-        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+        // set lanes to 0xff if bytes are outside of range, or 0x00 if not
+        __m128i r0 = _mm_cmpgt_epi8(_mm_sub_epi8(a0, lo16), range16);
 
-        // adjust index due to reused bytes in load
-        index += size - 16;
+        // extract top bit mask, flip lowest 0 bit (position inside range) to 1, changing all bits below it to 0
+        uint32_t m = 1U + (uint16_t)_mm_movemask_epi8(r0);
 
-        // return comparison result, or 0 if inputs are equal
-        return index < size ? p1[index] - p2[index] : 0;
+        // get index of byte inside range, m is guaranteed non-zero, because there only max 15 bytes here
+        return offset + MEM_CTZ32(m) + size - 16;
     }
 
-    // no differences found, inputs are equal
-    return 0;
+    // no byte inside range found, return original size (current offset plus pending tail size)
+    return offset + size;
 }
 
 MEM_DISABLE_ASAN
-int MemCompareI_neon(const void* ptr1, const void* ptr2, size_t size)
+size_t MemFindNotInRange_sse2(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
 {
-    const uint8_t* p1 = (const uint8_t*)ptr1;
-    const uint8_t* p2 = (const uint8_t*)ptr2;
+    const uint8_t* p = (const uint8_t*)ptr;
 
-    if (size == 0)
+    if (lo > hi)
     {
+        // empty range, every byte is outside of it
         return 0;
     }
 
-    if (size <= 16)
-    {
-        if (size < 2) // size == 1
-        {
-            return MemToLower1(p1[0]) - MemToLower1(p2[0]);
-        }
+    // byte is inside range when unsigned (x - lo) <= (hi - lo)
+    const uint8_t range = (uint8_t)(hi - lo);
 
-        if (size < 4) // 2 <= size < 4
-        {
-            // load pair of 4 overlapping bytes
-            uint64_t a0 = MEM_PTR16U(p1);
-            uint64_t b0 = MEM_PTR16U(p2);
-            uint64_t a1 = MEM_PTR16U(p1 + size - 2);
-            uint64_t b1 = MEM_PTR16U(p2 + size - 2);
+    // unsigned comparison is done as signed one by flipping top bit of both sides with 0x80 bias
+    const __m128i lo16 = _mm_set1_epi8((char)(lo ^ 0x80));
+    const __m128i range16 = _mm_set1_epi8((char)(range ^ 0x80));
 
-            // combine, lower case them and byteswap to have numbers in big-endian
-            uint64_t tmp = MEM_BSWAP64(MemToLower8(a0 | (a1 << 16) | (b0 << 32) | (b1 << 48)));
-            uint32_t a = (uint32_t)(tmp >> 32);
-            uint32_t b = (uint32_t)tmp;
+    if (size == 0)
+    {
+        return 0;
+    }
 
-            // can compare uint64 numbers if they are big-endian
-            return (a > b) - (a < b);
-        }
-        else if (size < 8) // 4 <= size < 8
-        {
-            // load pair of 8 overlapping bytes
-            uint64_t a0 = MEM_PTR32U(p1);
-            uint64_t b0 = MEM_PTR32U(p2);
-            uint64_t a1 = MEM_PTR32U(p1 + size - 4);
-            uint64_t b1 = MEM_PTR32U(p2 + size - 4);
+    if (size <= 16)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
 
-            // combine, lower case them and byteswap to have numbers in big-endian
-            uint64_t a = MEM_BSWAP64(MemToLower8(a0 | (a1 << 32)));
-            uint64_t b = MEM_BSWAP64(MemToLower8(b0 | (b1 << 32)));
+        // will load before the beginning buffer (16-byte aligned) if end is too close
+        // to 16-byte boundary, otherwise will load past the end of buffer
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p - extra));
 
-            // can compare uint64 numbers if they are big-endian
-            return (a > b) - (a < b);
-        }
-        else // 8 <= size <= 16
-        {
-            // load pair of 16 overlapping bytes
-            uint8x16_t va = vcombine_u8(vld1_u8(p1), vld1_u8(p1 + size - 8));
-            uint8x16_t vb = vcombine_u8(vld1_u8(p2), vld1_u8(p2 + size - 8));
+        // set lane to 0xff if lane is outside of range, or 0x00 if not
+        __m128i r0 = _mm_cmpgt_epi8(_mm_sub_epi8(a0, lo16), range16);
 
-            // lower case them and byteswap to have numbers in big-endian
-            uint64x2_t a64 = vreinterpretq_u64_u8(vrev64q_u8(MemToLower16(va)));
-            uint64x2_t b64 = vreinterpretq_u64_u8(vrev64q_u8(MemToLower16(vb)));
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        uint32_t m = (uint16_t)_mm_movemask_epi8(r0) >> extra;
 
-            // use a0/b0 if they are not equal, otherwise a1/b1
-            uint64_t a0 = vgetq_lane_u64(a64, 0);
-            uint64_t b0 = vgetq_lane_u64(b64, 0);
-            uint64_t a1 = vgetq_lane_u64(a64, 1);
-            uint64_t b1 = vgetq_lane_u64(b64, 1);
-            uint64_t a = (a0 != b0 ? a0 : a1);
-            uint64_t b = (a0 != b0 ? b0 : b1);
+        // mask out high bits (due to loading bytes after end of buffer)
+        // this will make mask non-zero, and will result in returning "size" value if no byte is found
+        m |= 1U << size;
 
-            return (a > b) - (a < b);
-        }
+        // return index of first bit set, which will be index of first byte outside of range
+        return MEM_CTZ32(m);
     }
 
-    const uint8x16_t index4 = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201));
+    size_t offset = 0;
 
     // process 64-byte blocks as much as possible
     while (size >= 64)
     {
-        uint8x16x4_t a = vld1q_u8_x4(p1);
-        uint8x16x4_t b = vld1q_u8_x4(p2);
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + 0x00));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p + 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p + 0x30));
 
-        // set lanes to 0xff if bytes are equal, or 0x00 if not
-        uint8x16_t c0 = vceqq_u8(MemToLower16(a.val[0]), MemToLower16(b.val[0]));
-        uint8x16_t c1 = vceqq_u8(MemToLower16(a.val[1]), MemToLower16(b.val[1]));
-        uint8x16_t c2 = vceqq_u8(MemToLower16(a.val[2]), MemToLower16(b.val[2]));
-        uint8x16_t c3 = vceqq_u8(MemToLower16(a.val[3]), MemToLower16(b.val[3]));
+        // set lane to 0xff if lane is outside of range, or 0x00 if not
+        __m128i r0 = _mm_cmpgt_epi8(_mm_sub_epi8(a0, lo16), range16);
+        __m128i r1 = _mm_cmpgt_epi8(_mm_sub_epi8(a1, lo16), range16);
+        __m128i r2 = _mm_cmpgt_epi8(_mm_sub_epi8(a2, lo16), range16);
+        __m128i r3 = _mm_cmpgt_epi8(_mm_sub_epi8(a3, lo16), range16);
 
-        // combine comparisons - leave 0xff in lanes that were not equal in at least one of inputs
-        uint8x16_t c = vmvnq_u8(vandq_u8(vandq_u8(c0, c1), vandq_u8(c2, c3)));
+        // combine comparisons - leave 0xff in lanes that are outside of range
+        __m128i r = _mm_or_si128(_mm_or_si128(r0, r1), _mm_or_si128(r2, r3));
 
-        // extract 4-bit nibble mask
-        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(c), 4);
-        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
-        if (nibbles)
+        // extract top bit mask, it will be non-zero if there is at least one lane outside of range
+        uint16_t mask = (uint16_t)_mm_movemask_epi8(r);
+        if (mask)
         {
-            // comparisons to bit index masks
-            uint8x16_t m0 = vbicq_u8(index4, c0);
-            uint8x16_t m1 = vbicq_u8(index4, c1);
-            uint8x16_t m2 = vbicq_u8(index4, c2);
-            uint8x16_t m3 = vbicq_u8(index4, c3);
-
-            // sum pairs of masks, so result fits into 64-bit low lane
-            uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
-            uint8x16_t s2 = vpaddq_u8(s1, s1);
+            // extract top bit masks for each comparison
+            uint64_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+            uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+            uint64_t m2 = (uint16_t)_mm_movemask_epi8(r2);
+            uint64_t m3 = mask; // if r0=r1=r2=0, then r3=r
 
-            // extract 64-bit index mask
-            uint64_t s3 = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+            // combine them into one mask, m4 is guaranteed to be non-zero
+            uint64_t m4 = m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
 
-            // get index for byte position that's different in inputs, s3 is non-zero here
-            size_t index = MEM_CTZ64(s3);
-
-            return MemToLower1(p1[index]) - MemToLower1(p2[index]);
-        }
+            // find first bit set, and return index
+            return offset + MEM_CTZ64(m4);
+        }
 
+        offset += 64;
         size -= 64;
-        p1 += 64;
-        p2 += 64;
+        p += 64;
     }
 
     if (size & 32) // 32 <= size < 64
     {
         // load 64 bytes, some will overlap
-        uint8x16x2_t a0 = vld1q_u8_x2(p1);
-        uint8x16x2_t b0 = vld1q_u8_x2(p2);
-        uint8x16x2_t a1 = vld1q_u8_x2(p1 + size - 0x20);
-        uint8x16x2_t b1 = vld1q_u8_x2(p2 + size - 0x20);
-
-        // set lanes to 0xff if bytes are equal, or 0x00 if not
-        uint8x16_t c0 = vceqq_u8(MemToLower16(a0.val[0]), MemToLower16(b0.val[0]));
-        uint8x16_t c1 = vceqq_u8(MemToLower16(a0.val[1]), MemToLower16(b0.val[1]));
-        uint8x16_t c2 = vceqq_u8(MemToLower16(a1.val[0]), MemToLower16(b1.val[0]));
-        uint8x16_t c3 = vceqq_u8(MemToLower16(a1.val[1]), MemToLower16(b1.val[1]));
-
-        // comparisons to bit index masks
-        uint8x16_t m0 = vbicq_u8(index4, c0);
-        uint8x16_t m1 = vbicq_u8(index4, c1);
-        uint8x16_t m2 = vbicq_u8(index4, c2);
-        uint8x16_t m3 = vbicq_u8(index4, c3);
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p + size - 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p + size - 0x10));
 
-        // sum pairs of masks, so result fits into 64-bit low lane
-        uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
-        uint8x16_t s2 = vpaddq_u8(s1, s1);
+        // set lanes to 0xff if bytes are outside of range, or 0x00 if not
+        __m128i r0 = _mm_cmpgt_epi8(_mm_sub_epi8(a0, lo16), range16);
+        __m128i r1 = _mm_cmpgt_epi8(_mm_sub_epi8(a1, lo16), range16);
+        __m128i r2 = _mm_cmpgt_epi8(_mm_sub_epi8(a2, lo16), range16);
+        __m128i r3 = _mm_cmpgt_epi8(_mm_sub_epi8(a3, lo16), range16);
 
-        // extract 64-bit index mask
-        uint64_t m = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+        // extract top bit masks for each comparison
+        uint64_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+        uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+        uint64_t m2 = (uint16_t)_mm_movemask_epi8(r2);
+        uint64_t m3 = (uint16_t)_mm_movemask_epi8(r3);
 
-        // get index for byte position that's different in inputs, or 64 if inputs are equal
-        size_t index = m ? MEM_CTZ64(m) : 64;
+        // combine masks, handling overlapped ones
+        uint64_t m = m0 | (m1 << 16) | (m2 << (size - 32)) | (m3 << (size - 16));
 
-        // adjust index to correct byte position, due to reused bytes in load
-        // index = (index < 32) ? index : (index - 32) + (size - 32);
-        index += (index >= 32) * (size - 64);
+        // make sure mask is non-zero, this will result in returning "size" value if no byte is found
+        m |= 1ULL << size;
 
-        // return comparison result, or 0 if inputs are equal
-        return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
+        // find first bit set, and return index
+        return offset + MEM_CTZ64(m);
     }
     else if (size & 16) // 16 <= size < 32
     {
         // load 32 bytes, some will overlap
-        uint8x16_t a0 = vld1q_u8(p1);
-        uint8x16_t b0 = vld1q_u8(p2);
-        uint8x16_t a1 = vld1q_u8(p1 + size - 0x10);
-        uint8x16_t b1 = vld1q_u8(p2 + size - 0x10);
-
-        // set lanes to 0xff if bytes are equal, or 0x00 if not
-        uint8x16_t c0 = vceqq_u8(MemToLower16(a0), MemToLower16(b0));
-        uint8x16_t c1 = vceqq_u8(MemToLower16(a1), MemToLower16(b1));
-
-        // comparisons to bit index masks
-        uint8x16_t m0 = vbicq_u8(index4, c0);
-        uint8x16_t m1 = vbicq_u8(index4, c1);
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + size - 0x10));
 
-        // sum pairs of masks, so result fits into 64-bit low lane
-        uint8x16_t s1 = vpaddq_u8(m0, m1);
-        uint8x16_t s2 = vpaddq_u8(s1, s1);
-        uint8x16_t s3 = vpaddq_u8(s2, s2);
+        // set lanes to 0xff if bytes are outside of range, or 0x00 if not
+        __m128i r0 = _mm_cmpgt_epi8(_mm_sub_epi8(a0, lo16), range16);
+        __m128i r1 = _mm_cmpgt_epi8(_mm_sub_epi8(a1, lo16), range16);
 
-        // extract 64-bit index mask
-        uint32_t m = vgetq_lane_u32(vreinterpretq_u32_u8(s3), 0);
+        // extract top bit masks for each comparison
+        uint32_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+        uint32_t m1 = (uint16_t)_mm_movemask_epi8(r1);
 
-        // get index for byte position that's different in inputs, or 32 if inputs are equal
-        size_t index = m ? MEM_CTZ32(m) : 32;
+        // combine masks, handling overlapped ones
+        uint32_t m = m0 | (m1 << (size - 16));
 
-        // adjust index to correct byte position, due to reused bytes in load
-        // index = (index < 16) ? index : (index - 16) + (size - 16);
-        index += (index >= 16) * (size - 32);
+        // make sure mask is non-zero, this will result in returning "size" value if no byte is found
+        m |= 1U << size;
 
-        // return comparison result, or 0 if inputs are equal
-        return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
+        // find first bit set, and return index
+        return offset + MEM_CTZ32(m);
     }
     else if (size) // 0 < size < 16, but initially size > 16
     {
         // load 16 bytes from end of buffer
-        // this will load previously checked bytes in 64 byte loop (they were equal)
-        uint8x16_t a = vld1q_u8(p1 + size - 16);
-        uint8x16_t b = vld1q_u8(p2 + size - 16);
-
-        // set lanes to 0x00 if bytes are equal, or 0xff if not
-        uint8x16_t c = vmvnq_u8(vceqq_u8(MemToLower16(a), MemToLower16(b)));
-
-        // nibbles will contain 16 masks with 4-bit value 0x0 if lanes were equal
-        // if there is one lane that was not equal, it contains 0xf
-        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(c), 4);
-        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        // this will load previously checked bytes in 64 byte loop (they were inside range)
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + size - 0x10));
 
-        // get index for byte position that's different in inputs, or 16
-        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+        // set lanes to 0xff if bytes are outside of range, or 0x00 if not
+        __m128i r0 = _mm_cmpgt_epi8(_mm_sub_epi8(a0, lo16), range16);
 
-        // adjust index due to reused bytes in load
-        index += size - 16;
+        // extract top bit mask, make sure it is non-zero
+        uint32_t m = (uint16_t)_mm_movemask_epi8(r0) | (1U << 16);
 
-        // return comparison result, or 0 if inputs are equal
-        return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
+        // find first bit set, adjust it due to reused bytes in load, and return index
+        return offset + MEM_CTZ32(m) + size - 16;
     }
 
-    // no differences found, inputs are equal
-    return 0;
+    // no byte outside of range found, return original size (current offset plus pending tail size)
+    return offset + size;
 }
 
 MEM_DISABLE_ASAN
-bool MemIsEqual_neon(const void* ptr1, const void* ptr2, size_t size)
+size_t MemValidateUTF8_sse2(const void* ptr, size_t size)
 {
-    const uint8_t* p1 = (const uint8_t*)ptr1;
-    const uint8_t* p2 = (const uint8_t*)ptr2;
+    const uint8_t* p = (const uint8_t*)ptr;
 
-    if (size == 0)
-    {
-        return true;
-    }
+    // skip all leading ASCII bytes
+    size_t offset = MemFindInRange_sse2(p, size, 0x80, 0xff);
+    size -= offset;
+    p += offset;
 
-    if (size <= 16)
+    // no byte shuffle in sse2 for table lookup, vector code only skips ASCII bytes
+    while (size >= 64)
     {
-        if (size < 2) // size == 1
-        {
-            return p1[0] == p2[0];
-        }
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + 0x00));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p + 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p + 0x30));
 
-        // will load pair of 4, 8 or 16 overlapping bytes
-        // a/b0 from beginning of buffer
-        // a/b1 from end of buffers
-        uint64_t a0, b0, a1, b1;
+        size_t block = 64;
 
-        if (size < 4) // 2 <= size < 4
-        {
-            a0 = MEM_PTR16U(p1);
-            b0 = MEM_PTR16U(p2);
-            a1 = MEM_PTR16U(p1 + size - 2);
-            b1 = MEM_PTR16U(p2 + size - 2);
-        }
-        else if (size < 8) // 4 <= size < 8
-        {
-            a0 = MEM_PTR32U(p1);
-            b0 = MEM_PTR32U(p2);
-            a1 = MEM_PTR32U(p1 + size - 4);
-            b1 = MEM_PTR32U(p2 + size - 4);
-        }
-        else // 8 <= size <= 16
+        // extract top bit mask, it will be non-zero if there is at least one non-ASCII byte
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a0, a1), _mm_or_si128(a2, a3)));
+        if (mask)
         {
-            a0 = MEM_PTR64U(p1);
-            b0 = MEM_PTR64U(p2);
-            a1 = MEM_PTR64U(p1 + size - 8);
-            b1 = MEM_PTR64U(p2 + size - 8);
+            uint64_t m0 = (uint32_t)_mm_movemask_epi8(a0);
+            uint64_t m1 = (uint32_t)_mm_movemask_epi8(a1);
+            uint64_t m2 = (uint32_t)_mm_movemask_epi8(a2);
+            uint64_t m3 = (uint32_t)_mm_movemask_epi8(a3);
+
+            // validate sequences starting from first non-ASCII byte with scalar code, last one may continue past the block
+            size_t index = MEM_CTZ64(m0 | (m1 << 16) | (m2 << 32) | (m3 << 48));
+            while (index < 64)
+            {
+                size_t length = MemUTF8Sequence(p + index, size - index);
+                if (length == 0)
+                {
+                    return offset + index;
+                }
+                index += length;
+            }
+            block = index;
         }
 
-        // compare loaded bytes on equality, overlapped ones will be checked twice
-        // but result will still be correct
-        return (a0 == b0) & (a1 == b1);
+        offset += block;
+        size -= block;
+        p += block;
+    }
+
+    // validate remaining bytes
+    return offset + MemValidateUTF8_generic(p, size);
+}
+
+MEM_DISABLE_ASAN
+void MemClassify_sse2(const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* s = (const uint8_t*)set;
+
+    if (setlen == 0 || setlen > 3 || size < 64)
+    {
+        // no byte shuffle in sse2 for table lookup
+        MemClassify_generic(ptr, size, set, setlen, masks);
+        return;
     }
 
+    // for smaller sets some values are repeated
+    const __m128i v0 = _mm_set1_epi8((char)s[0]);
+    const __m128i v1 = _mm_set1_epi8((char)s[setlen / 2]);
+    const __m128i v2 = _mm_set1_epi8((char)s[setlen - 1]);
+
     // process 64-byte blocks as much as possible
     while (size >= 64)
     {
-        uint8x16x4_t a = vld1q_u8_x4(p1);
-        uint8x16x4_t b = vld1q_u8_x4(p2);
-
-        // set lanes to 0xff if bytes are equal, or 0x00 if not
-        uint8x16_t c0 = vceqq_u8(a.val[0], b.val[0]);
-        uint8x16_t c1 = vceqq_u8(a.val[1], b.val[1]);
-        uint8x16_t c2 = vceqq_u8(a.val[2], b.val[2]);
-        uint8x16_t c3 = vceqq_u8(a.val[3], b.val[3]);
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + 0x00));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p + 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p + 0x30));
 
-        // combine comparisons - leave 0xff in lanes that were not equal in at least one of inputs
-        uint8x16_t c = vmvnq_u8(vandq_u8(vandq_u8(c0, c1), vandq_u8(c2, c3)));
+        uint64_t m0 = (uint32_t)_mm_movemask_epi8(MemFindAnyMatch_sse2(a0, v0, v1, v2));
+        uint64_t m1 = (uint32_t)_mm_movemask_epi8(MemFindAnyMatch_sse2(a1, v0, v1, v2));
+        uint64_t m2 = (uint32_t)_mm_movemask_epi8(MemFindAnyMatch_sse2(a2, v0, v1, v2));
+        uint64_t m3 = (uint32_t)_mm_movemask_epi8(MemFindAnyMatch_sse2(a3, v0, v1, v2));
 
-        // extract 4-bit nibble mask
-        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(c), 4);
-        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
-        if (nibbles)
-        {
-            // if nibbles is non-zero then there is at least one difference
-            return false;
-        }
+        *masks++ = m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
 
         size -= 64;
-        p1 += 64;
-        p2 += 64;
+        p += 64;
     }
 
-    if (size & 32) // 32 <= size < 64
+    if (size) // 0 < size < 64, but initially size >= 64
     {
-        // load 64 bytes, some will overlap
-        uint8x16x2_t a0 = vld1q_u8_x2(p1);
-        uint8x16x2_t b0 = vld1q_u8_x2(p2);
-        uint8x16x2_t a1 = vld1q_u8_x2(p1 + size - 0x20);
-        uint8x16x2_t b1 = vld1q_u8_x2(p2 + size - 0x20);
-
-        // set lanes to 0xff if bytes are equal, or 0x00 if not
-        uint8x16_t c0 = vceqq_u8(a0.val[0], b0.val[0]);
-        uint8x16_t c1 = vceqq_u8(a0.val[1], b0.val[1]);
-        uint8x16_t c2 = vceqq_u8(a1.val[0], b1.val[0]);
-        uint8x16_t c3 = vceqq_u8(a1.val[1], b1.val[1]);
+        // load 64 bytes from end of buffer, this will load previously classified bytes
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + size - 0x40));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + size - 0x30));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p + size - 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p + size - 0x10));
 
-        // combine comparisons - leave 0xff in lanes that were not equal in at least one of inputs
-        uint8x16_t c = vmvnq_u8(vandq_u8(vandq_u8(c0, c1), vandq_u8(c2, c3)));
+        uint64_t m0 = (uint32_t)_mm_movemask_epi8(MemFindAnyMatch_sse2(a0, v0, v1, v2));
+        uint64_t m1 = (uint32_t)_mm_movemask_epi8(MemFindAnyMatch_sse2(a1, v0, v1, v2));
+        uint64_t m2 = (uint32_t)_mm_movemask_epi8(MemFindAnyMatch_sse2(a2, v0, v1, v2));
+        uint64_t m3 = (uint32_t)_mm_movemask_epi8(MemFindAnyMatch_sse2(a3, v0, v1, v2));
 
-        // extract 4-bit nibble mask
-        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(c), 4);
-        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        // drop bits of previously classified bytes
+        *masks = (m0 | (m1 << 16) | (m2 << 32) | (m3 << 48)) >> (64 - size);
+    }
+}
 
-        // if nibbles are zero, then there were no differences in inputs
-        return nibbles == 0;
+// set all lanes of element to 0xff if element matches input value, or to 0x00 if not (inverted if "invert" is set)
+static MEM_FORCE_INLINE __m128i MemFindWideMatch_sse2(__m128i a, __m128i value16, size_t width, int invert)
+{
+    __m128i r;
+    if (width == 2)
+    {
+        r = _mm_cmpeq_epi16(a, value16);
     }
-    else if (size & 16) // 16 <= size < 32
+    else if (width == 4)
     {
-        // load 32 bytes, some will overlap
-        uint8x16_t a0 = vld1q_u8(p1);
-        uint8x16_t b0 = vld1q_u8(p2);
-        uint8x16_t a1 = vld1q_u8(p1 + size - 0x10);
-        uint8x16_t b1 = vld1q_u8(p2 + size - 0x10);
-
-        // set lanes to 0xff if bytes are equal, or 0x00 if not
-        uint8x16_t c0 = vceqq_u8(a0, b0);
-        uint8x16_t c1 = vceqq_u8(a1, b1);
-
-        // combine comparisons - leave 0xff in lanes that were not equal in at least one of inputs
-        uint8x16_t c = vmvnq_u8(vandq_u8(c0, c1));
-
-        // extract 4-bit nibble mask
-        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(c), 4);
-        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
-
-        // if nibbles are zero, then there were no differences in inputs
-        return nibbles == 0;
+        r = _mm_cmpeq_epi32(a, value16);
     }
-    else if (size) // 0 < size < 16, but initially size > 16
+    else
     {
-        // load 16 bytes from end of buffer
-        // this will load previously checked bytes in 64 byte loop (they were equal)
-        uint8x16_t a = vld1q_u8(p1 + size - 0x10);
-        uint8x16_t b = vld1q_u8(p2 + size - 0x10);
-
-        // combine comparisons - leave 0xff in lanes that were not equal in at least one of inputs
-        uint8x16_t c = vmvnq_u8(vceqq_u8(a, b));
-
-        // extract 4-bit nibble mask
-        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(c), 4);
-        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
-
-        // if nibbles are zero, then there were no differences in inputs
-        return nibbles == 0;
+        // there is no 64-bit comparison in sse2, both 32-bit halves must be equal
+        __m128i r32 = _mm_cmpeq_epi32(a, value16);
+        r = _mm_and_si128(r32, _mm_shuffle_epi32(r32, _MM_SHUFFLE(2, 3, 0, 1)));
     }
-
-    // no differences found, inputs are equal
-    return true;
+    return invert ? _mm_xor_si128(r, _mm_set1_epi32(-1)) : r;
 }
 
+// size is in bytes, must be multiple of width and >= 16, returns element index
 MEM_DISABLE_ASAN
-size_t MemFind_neon(const void* ptr, size_t size, uint8_t value)
+static MEM_FORCE_INLINE size_t MemFindWide_sse2(const uint8_t* p, size_t size, __m128i value16, size_t width, int invert)
 {
-    const uint8_t* p = (const uint8_t*)ptr;
-
-    const uint8x16_t value16 = vdupq_n_u8(value);
-
-    if (size == 0)
-    {
-        return 0;
-    }
-
-    if (size <= 16)
-    {
-        size_t address = (uint32_t)(uintptr_t)p % 16;
-        size_t extra = (address + size) <= 16 ? address : 0;
-
-        // will load before the beginning buffer (16-byte aligned) if end is too close
-        // to 16-byte boundary, otherwise will load past the end of buffer
-        uint8x16_t a = vld1q_u8(p - extra);
-
-        // set lane to 0xff if lane matches input value, or 0x00 if not
-        uint8x16_t b = vceqq_u8(a, value16);
-
-        // nibbles will contain 16 masks with 4-bit value 0xf if lane matches input value
-        // if there is one lane that was not equal, mask contains 0x0
-        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
-        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
-
-        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
-        nibbles >>= (4 * extra);
-
-        // for non-zero nibble find first bit set, which will be index of first byte matching input value
-        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
-
-        // mask out any high bits (due to load past end of buffer)
-        return index < size ? index : size;
-    }
-
-    const uint8x16_t index4 = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201));
-
-    size_t offset = 0;
+    size_t offset = 0;
 
     // process 64-byte blocks as much as possible
     while (size >= 64)
     {
-        uint8x16x4_t a = vld1q_u8_x4(p);
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p + 0x00));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(p + 0x20));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(p + 0x30));
 
-        // set lane to 0xff if lane matches input value, or 0x00 if not
-        uint8x16_t b0 = vceqq_u8(a.val[0], value16);
-        uint8x16_t b1 = vceqq_u8(a.val[1], value16);
-        uint8x16_t b2 = vceqq_u8(a.val[2], value16);
-        uint8x16_t b3 = vceqq_u8(a.val[3], value16);
+        __m128i r0 = MemFindWideMatch_sse2(a0, value16, width, invert);
+        __m128i r1 = MemFindWideMatch_sse2(a1, value16, width, invert);
+        __m128i r2 = MemFindWideMatch_sse2(a2, value16, width, invert);
+        __m128i r3 = MemFindWideMatch_sse2(a3, value16, width, invert);
 
-        // combine comparisons - leave 0xff in lanes there equal to input value
-        uint8x16_t b01 = vorrq_u8(b0, b1);
-        uint8x16_t b23 = vorrq_u8(b2, b3);
-#if defined(__clang__)
-        // without this clang 19+ generates worse code (runs slower)
-        __asm__ __volatile__("" : "+w"(b01), "+w"(b23));
-#endif
-        uint8x16_t b = vorrq_u8(b01, b23);
+        // combine comparisons - leave 0xff in lanes of matching elements
+        __m128i r = _mm_or_si128(_mm_or_si128(r0, r1), _mm_or_si128(r2, r3));
 
-        // extract 4-bit nibble mask
-        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
-        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
-        if (nibbles)
+        // extract top bit mask, it will be non-zero if there is at least one matching element
+        uint16_t mask = (uint16_t)_mm_movemask_epi8(r);
+        if (mask)
         {
-            // comparisons to bit index masks
-            uint8x16_t m0 = vandq_u8(b0, index4);
-            uint8x16_t m1 = vandq_u8(b1, index4);
-            uint8x16_t m2 = vandq_u8(b2, index4);
-            uint8x16_t m3 = vandq_u8(b3, index4);
-
-            // sum pairs of masks, so result fits into 64-bit low lane
-            uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
-            uint8x16_t s2 = vpaddq_u8(s1, s1);
+            // extract top bit masks for each comparison
+            uint64_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+            uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+            uint64_t m2 = (uint16_t)_mm_movemask_epi8(r2);
+            uint64_t m3 = mask; // if r0=r1=r2=0, then r3=r
 
-            // extract 64-bit index mask
-            uint64_t s3 = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+            // combine them into one mask, m4 is guaranteed to be non-zero
+            uint64_t m4 = m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
 
-            // get index for byte position that matches input value
-            return offset + MEM_CTZ64(s3);
+            // find first bit set, and convert byte index to element index
+            return (offset + MEM_CTZ64(m4)) / width;
         }
 
         offset += 64;
@@ -3267,873 +3974,13829 @@ size_t MemFind_neon(const void* ptr, size_t size, uint8_t value)
         p += 64;
     }
 
-    if (size & 32) // 32 <= size < 64
+    // process 16-byte blocks
+    while (size >= 16)
     {
-        // load 64 bytes, some will overlap
-        uint8x16x2_t a0 = vld1q_u8_x2(p);
-        uint8x16x2_t a1 = vld1q_u8_x2(p + size - 0x20);
-
-        // set lane to 0xff if lane matches input value, or 0x00 if not
-        uint8x16_t b0 = vceqq_u8(a0.val[0], value16);
-        uint8x16_t b1 = vceqq_u8(a0.val[1], value16);
-        uint8x16_t b2 = vceqq_u8(a1.val[0], value16);
-        uint8x16_t b3 = vceqq_u8(a1.val[1], value16);
+        __m128i a = _mm_loadu_si128((const __m128i*)p);
+        uint32_t mask = (uint16_t)_mm_movemask_epi8(MemFindWideMatch_sse2(a, value16, width, invert));
+        if (mask)
+        {
+            return (offset + MEM_CTZ32(mask)) / width;
+        }
 
-        // comparisons to bit index masks
-        uint8x16_t m0 = vandq_u8(b0, index4);
-        uint8x16_t m1 = vandq_u8(b1, index4);
-        uint8x16_t m2 = vandq_u8(b2, index4);
-        uint8x16_t m3 = vandq_u8(b3, index4);
+        offset += 16;
+        size -= 16;
+        p += 16;
+    }
 
-        // sum pairs of masks, so result fits into 64-bit low lane
-        uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
-        uint8x16_t s2 = vpaddq_u8(s1, s1);
+    if (size) // 0 < size < 16, but initially size >= 16
+    {
+        // load 16 bytes from end of buffer, this will load previously checked elements
+        __m128i a = _mm_loadu_si128((const __m128i*)(p + size - 16));
 
-        // extract 64-bit index mask
-        uint64_t m = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+        // drop bits of previously checked elements
+        uint32_t mask = (uint16_t)_mm_movemask_epi8(MemFindWideMatch_sse2(a, value16, width, invert));
+        mask >>= 16 - size;
+        if (mask)
+        {
+            return (offset + MEM_CTZ32(mask)) / width;
+        }
 
-        // get index of byte that matches input value, or 64
-        size_t index = m ? MEM_CTZ64(m) : 64;
+        offset += size;
+    }
 
-        // adjust index to correct byte position, due to reused bytes in load
-        // index = (index < 32) ? index : (index - 32) + (size - 32);
-        index += (index >= 32) * (size - 64);
+    // no matching element found
+    return offset / width;
+}
 
-        return offset + index;
-    }
-    else if (size & 16) // 16 <= size < 32
+MEM_DISABLE_ASAN
+size_t MemFind16_sse2(const void* ptr, size_t count, uint16_t value)
+{
+    if (count < 16 / sizeof(value))
     {
-        // load 32 bytes, some will overlap
-        uint8x16_t a0 = vld1q_u8(p);
-        uint8x16_t a1 = vld1q_u8(p + size - 0x10);
+        return MemFind16_generic(ptr, count, value);
+    }
+    return MemFindWide_sse2((const uint8_t*)ptr, count * sizeof(value), _mm_set1_epi16((short)value), sizeof(value), 0);
+}
 
-        // set lane to 0xff if lane matches input value, or 0x00 if not
-        uint8x16_t b0 = vceqq_u8(a0, value16);
-        uint8x16_t b1 = vceqq_u8(a1, value16);
+MEM_DISABLE_ASAN
+size_t MemFind32_sse2(const void* ptr, size_t count, uint32_t value)
+{
+    if (count < 16 / sizeof(value))
+    {
+        return MemFind32_generic(ptr, count, value);
+    }
+    return MemFindWide_sse2((const uint8_t*)ptr, count * sizeof(value), _mm_set1_epi32((int)value), sizeof(value), 0);
+}
 
-        // comparisons to bit index masks
-        uint8x16_t m0 = vandq_u8(b0, index4);
-        uint8x16_t m1 = vandq_u8(b1, index4);
+MEM_DISABLE_ASAN
+size_t MemFind64_sse2(const void* ptr, size_t count, uint64_t value)
+{
+    if (count < 16 / sizeof(value))
+    {
+        return MemFind64_generic(ptr, count, value);
+    }
+    return MemFindWide_sse2((const uint8_t*)ptr, count * sizeof(value), _mm_set1_epi64x((long long)value), sizeof(value), 0);
+}
 
-        // sum pairs of masks, so result fits into 64-bit low lane
-        uint8x16_t s1 = vpaddq_u8(m0, m1);
-        uint8x16_t s2 = vpaddq_u8(s1, s1);
-        uint8x16_t s3 = vpaddq_u8(s2, s2);
+MEM_DISABLE_ASAN
+size_t MemFindNot16_sse2(const void* ptr, size_t count, uint16_t value)
+{
+    if (count < 16 / sizeof(value))
+    {
+        return MemFindNot16_generic(ptr, count, value);
+    }
+    return MemFindWide_sse2((const uint8_t*)ptr, count * sizeof(value), _mm_set1_epi16((short)value), sizeof(value), 1);
+}
 
-        // extract 64-bit index mask
-        uint32_t m = vgetq_lane_u32(vreinterpretq_u32_u8(s3), 0);
+MEM_DISABLE_ASAN
+size_t MemFindNot32_sse2(const void* ptr, size_t count, uint32_t value)
+{
+    if (count < 16 / sizeof(value))
+    {
+        return MemFindNot32_generic(ptr, count, value);
+    }
+    return MemFindWide_sse2((const uint8_t*)ptr, count * sizeof(value), _mm_set1_epi32((int)value), sizeof(value), 1);
+}
 
-        // get index of byte that matches input value, or 32
-        size_t index = m ? MEM_CTZ32(m) : 32;
+MEM_DISABLE_ASAN
+size_t MemFindNot64_sse2(const void* ptr, size_t count, uint64_t value)
+{
+    if (count < 16 / sizeof(value))
+    {
+        return MemFindNot64_generic(ptr, count, value);
+    }
+    return MemFindWide_sse2((const uint8_t*)ptr, count * sizeof(value), _mm_set1_epi64x((long long)value), sizeof(value), 1);
+}
 
-        // adjust index to correct byte position, due to reused bytes in load
-        // index = (index < 16) ? index : (index - 16) + (size - 16);
-        index += (index >= 16) * (size - 32);
+MEM_DISABLE_ASAN
+size_t MemLowerBound32_sse2(const void* ptr, size_t count, uint32_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
 
-        return offset + index;
-    }
-    else if (size) // 0 < size < 16, but initially size > 16
+    if (count < 16)
     {
-        // load 32 bytes from end of buffer
-        // this will load previously checked bytes in 64 byte loop (they did not match input value)
-        uint8x16_t a = vld1q_u8(p + size - 16);
+        return MemLowerBound32_generic(ptr, count, value);
+    }
 
-        // set lane to 0xff if lane matches input value, or 0x00 if not
-        uint8x16_t b = vceqq_u8(a, value16);
+    // binary search down to 16 elements, which are compared all at once
+    size_t start = MemLowerBoundWindow(p, count, value, sizeof(value), 16);
+    p += start * sizeof(value);
+
+    // flip top bit for unsigned comparison with signed compare instruction
+    const __m128i sign = _mm_set1_epi32((int)0x80000000);
+    const __m128i value16 = _mm_xor_si128(_mm_set1_epi32((int)value), sign);
+
+    __m128i a0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(p + 0x00)), sign);
+    __m128i a1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(p + 0x10)), sign);
+    __m128i a2 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(p + 0x20)), sign);
+    __m128i a3 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(p + 0x30)), sign);
+
+    // set lanes to 0xff for elements less than input value
+    __m128i r0 = _mm_cmpgt_epi32(value16, a0);
+    __m128i r1 = _mm_cmpgt_epi32(value16, a1);
+    __m128i r2 = _mm_cmpgt_epi32(value16, a2);
+    __m128i r3 = _mm_cmpgt_epi32(value16, a3);
+
+    // extract top bit masks for each comparison, and combine them into one mask
+    uint64_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+    uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+    uint64_t m2 = (uint16_t)_mm_movemask_epi8(r2);
+    uint64_t m3 = (uint16_t)_mm_movemask_epi8(r3);
+    uint64_t m = m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+
+    // every element less than input value has 4 bits set
+    return start + MEM_POPCNT64(m) / 4;
+}
 
-        // extract 4-bit nibble mask
-        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
-        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+// set lanes to 0xff for 64-bit elements that are less than input value, both with top bit flipped
+static MEM_FORCE_INLINE __m128i MemLess64_sse2(__m128i a, __m128i value16)
+{
+    // there is no 64-bit comparison in sse2, compare high 32-bit halves and use low halves only if high ones are equal
+    __m128i gt = _mm_cmpgt_epi32(value16, a);
+    __m128i eq = _mm_cmpeq_epi32(value16, a);
+    __m128i hi = _mm_shuffle_epi32(gt, _MM_SHUFFLE(3, 3, 1, 1));
+    __m128i lo = _mm_shuffle_epi32(gt, _MM_SHUFFLE(2, 2, 0, 0));
+    return _mm_or_si128(hi, _mm_and_si128(_mm_shuffle_epi32(eq, _MM_SHUFFLE(3, 3, 1, 1)), lo));
+}
 
-        // get index of byte that matches input value, or 16
-        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+MEM_DISABLE_ASAN
+size_t MemLowerBound64_sse2(const void* ptr, size_t count, uint64_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
 
-        // adjust index due to reused bytes in load
-        return offset + index + size - 16;
+    if (count < 8)
+    {
+        return MemLowerBound64_generic(ptr, count, value);
     }
 
-    // no input value found, return original size (current offset plus pending tail size)
-    return offset + size;
+    // binary search down to 8 elements, which are compared all at once
+    size_t start = MemLowerBoundWindow(p, count, value, sizeof(value), 8);
+    p += start * sizeof(value);
+
+    // flip top bit of both 32-bit halves for unsigned comparison with signed compare instruction
+    const __m128i sign = _mm_set1_epi32((int)0x80000000);
+    const __m128i value16 = _mm_xor_si128(_mm_set1_epi64x((long long)value), sign);
+
+    __m128i a0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(p + 0x00)), sign);
+    __m128i a1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(p + 0x10)), sign);
+    __m128i a2 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(p + 0x20)), sign);
+    __m128i a3 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(p + 0x30)), sign);
+
+    // set lanes to 0xff for elements less than input value
+    __m128i r0 = MemLess64_sse2(a0, value16);
+    __m128i r1 = MemLess64_sse2(a1, value16);
+    __m128i r2 = MemLess64_sse2(a2, value16);
+    __m128i r3 = MemLess64_sse2(a3, value16);
+
+    // extract top bit masks for each comparison, and combine them into one mask
+    uint64_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+    uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+    uint64_t m2 = (uint16_t)_mm_movemask_epi8(r2);
+    uint64_t m3 = (uint16_t)_mm_movemask_epi8(r3);
+    uint64_t m = m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+
+    // every element less than input value has 8 bits set
+    return start + MEM_POPCNT64(m) / 8;
 }
 
 MEM_DISABLE_ASAN
-size_t MemFindNot_neon(const void* ptr, size_t size, uint8_t value)
+void MemTranslate_sse2(void* dst, const void* src, size_t size, const uint8_t table[256])
 {
-    const uint8_t* p = (const uint8_t*)ptr;
-
-    const uint8x16_t value16 = vdupq_n_u8(value);
+    // no byte shuffle in sse2 for table lookup
+    MemTranslate_generic(dst, src, size, table);
+}
 
-    if (size == 0)
+// adds 64-byte stripe to accumulators, for every 64-bit lane "i":
+// acc[i] += low32(data[i] ^ key[i]) * high32(data[i] ^ key[i]) + data[i ^ 1]
+MEM_DISABLE_ASAN
+static MEM_FORCE_INLINE void MemHashStripe_sse2(__m128i acc[4], const uint8_t* p, const uint64_t* key)
+{
+    for (size_t i=0; i<4; i++)
     {
-        return 0;
+        __m128i data = _mm_loadu_si128((const __m128i*)(p + i * 16));
+        __m128i mixed = _mm_xor_si128(data, _mm_loadu_si128((const __m128i*)(key + i * 2)));
+        __m128i product = _mm_mul_epu32(mixed, _mm_srli_epi64(mixed, 32));
+        __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+        acc[i] = _mm_add_epi64(acc[i], _mm_add_epi64(product, swapped));
     }
+}
 
-    if (size <= 16)
+// acc = (acc ^ (acc >> 47) ^ key) * prime, where prime is 32-bit value
+static MEM_FORCE_INLINE void MemHashScramble_sse2(__m128i acc[4], const uint64_t* key)
+{
+    const __m128i prime = _mm_set1_epi32((int)0x9e3779b1);
+
+    for (size_t i=0; i<4; i++)
     {
-        size_t address = (uint32_t)(uintptr_t)p % 16;
-        size_t extra = (address + size) <= 16 ? address : 0;
+        __m128i a = _mm_xor_si128(acc[i], _mm_srli_epi64(acc[i], 47));
+        a = _mm_xor_si128(a, _mm_loadu_si128((const __m128i*)(key + i * 2)));
 
-        // will load before the beginning buffer (16-byte aligned) if end is too close
-        // to 16-byte boundary, otherwise will load past the end of buffer
-        uint8x16_t a = vld1q_u8(p - extra);
+        // 64x32 bit multiply from two 32x32 bit multiplies
+        __m128i lo = _mm_mul_epu32(a, prime);
+        __m128i hi = _mm_mul_epu32(_mm_srli_epi64(a, 32), prime);
+        acc[i] = _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+    }
+}
 
-        // set lane to 0x00 if lane matches input value, or 0xff if not
-        uint8x16_t b = vmvnq_u8(vceqq_u8(a, value16));
+MEM_DISABLE_ASAN
+uint64_t MemHash64_sse2(const void* ptr, size_t size, uint64_t seed)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
 
-        // nibbles will contain 16 masks with 4-bit value 0x0 if lane matches input value
-        // if there is one lane that was not equal, it contains 0xf
-        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
-        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+    if (size <= 16)
+    {
+        return MemHashSmall(p, size, seed);
+    }
+    else if (size <= 256)
+    {
+        return MemHashMedium(p, size, seed);
+    }
 
-        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
-        nibbles >>= (4 * extra);
+    __m128i acc[4];
+    for (size_t i=0; i<4; i++)
+    {
+        acc[i] = _mm_add_epi64(_mm_loadu_si128((const __m128i*)(MemHashSecret + 24 + i * 2)), _mm_set1_epi64x((long long)seed));
+    }
 
-        // for non-zero nibble find first bit set, which will be index of first byte different from input value
-        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+    const uint8_t* end = p + size;
 
-        // mask out any high bits (due to load past end of buffer)
-        return index < size ? index : size;
+    // 1024-byte blocks of 16 stripes, each stripe uses key shifted by 8 bytes
+    while (end - p > 1024)
+    {
+        for (size_t i=0; i<16; i++)
+        {
+            MemHashStripe_sse2(acc, p + i * 64, MemHashSecret + i);
+        }
+        MemHashScramble_sse2(acc, MemHashSecret + 16);
+        p += 1024;
     }
 
-    const uint8x16_t index4 = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201));
+    // remaining stripes, there are at most 15 of them
+    for (size_t i=0; end - p > 64; i++)
+    {
+        MemHashStripe_sse2(acc, p, MemHashSecret + i);
+        p += 64;
+    }
 
-    size_t offset = 0;
+    // last 64 bytes, may overlap with previous stripe
+    MemHashStripe_sse2(acc, end - 64, MemHashSecret + 16);
 
-    // process 64-byte blocks as much as possible
-    while (size >= 64)
+    uint64_t result[8];
+    for (size_t i=0; i<4; i++)
     {
-        uint8x16x4_t a = vld1q_u8_x4(p);
+        _mm_storeu_si128((__m128i*)(result + i * 2), acc[i]);
+    }
+    return MemHashMerge(result, size, seed);
+}
 
-        // set lane to 0xff if lane matches input value, or 0x00 if not
-        uint8x16_t b0 = vceqq_u8(a.val[0], value16);
-        uint8x16_t b1 = vceqq_u8(a.val[1], value16);
-        uint8x16_t b2 = vceqq_u8(a.val[2], value16);
-        uint8x16_t b3 = vceqq_u8(a.val[3], value16);
+// returns mask with bit set for every byte that is different in first "size" bytes, size must be <= 32
+MEM_DISABLE_ASAN
+static MEM_FORCE_INLINE uint32_t MemBatchDiff_sse2(const MemPair* pair)
+{
+    const uint8_t* p1 = (const uint8_t*)pair->ptr1;
+    const uint8_t* p2 = (const uint8_t*)pair->ptr2;
+
+    __m128i a0 = _mm_loadu_si128((const __m128i*)(p1 + 0x00));
+    __m128i b0 = _mm_loadu_si128((const __m128i*)(p2 + 0x00));
+    __m128i a1 = _mm_loadu_si128((const __m128i*)(p1 + 0x10));
+    __m128i b1 = _mm_loadu_si128((const __m128i*)(p2 + 0x10));
+
+    uint32_t m0 = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(a0, b0));
+    uint32_t m1 = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(a1, b1));
+    uint32_t mask = ~(m0 | (m1 << 16));
+    return pair->size < 32 ? mask & ((1U << pair->size) - 1) : mask;
+}
 
-        // combine comparisons - leave 0xff in lanes that were not matching in at least one of inputs
-        uint8x16_t b = vmvnq_u8(vandq_u8(vandq_u8(b0, b1), vandq_u8(b2, b3)));
+MEM_DISABLE_ASAN
+void MemIsEqualBatch_sse2(const MemPair* pairs, size_t count, uint8_t* results)
+{
+    for (size_t i=0; i<count; i++)
+    {
+        const MemPair* pair = &pairs[i];
+        MemPrefetchPair(pairs, i + 8, count);
 
-        // extract 4-bit nibble mask
-        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
-        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
-        if (nibbles)
+        // short buffers without page crossing use single branchless comparison,
+        // there are no calls or branches that depend on size, so loads of next pairs can start early
+        if (MemBatchCanLoad(pair, 32))
         {
-            // comparisons to bit index masks
-            uint8x16_t m0 = vbicq_u8(index4, b0);
-            uint8x16_t m1 = vbicq_u8(index4, b1);
-            uint8x16_t m2 = vbicq_u8(index4, b2);
-            uint8x16_t m3 = vbicq_u8(index4, b3);
-
-            // sum pairs of masks, so result fits into 64-bit low lane
-            uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
-            uint8x16_t s2 = vpaddq_u8(s1, s1);
-
-            // extract 64-bit index mask
-            uint64_t s3 = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
-
-            // get index for byte position that's different from input value
-            return offset + MEM_CTZ64(s3);
+            results[i] = MemBatchDiff_sse2(pair) == 0;
+        }
+        else
+        {
+            results[i] = MemIsEqual_sse2(pair->ptr1, pair->ptr2, pair->size);
         }
-
-        offset += 64;
-        size -= 64;
-        p += 64;
-    }
-
-    if (size & 32) // 32 <= size < 64
-    {
-        // load 64 bytes, some will overlap
-        uint8x16x2_t a0 = vld1q_u8_x2(p);
-        uint8x16x2_t a1 = vld1q_u8_x2(p + size - 0x20);
-
-        // set lane to 0xff if lane matches input value, or 0x00 if not
-        uint8x16_t b0 = vceqq_u8(a0.val[0], value16);
-        uint8x16_t b1 = vceqq_u8(a0.val[1], value16);
-        uint8x16_t b2 = vceqq_u8(a1.val[0], value16);
-        uint8x16_t b3 = vceqq_u8(a1.val[1], value16);
-
-        // comparisons to bit index masks
-        uint8x16_t m0 = vbicq_u8(index4, b0);
-        uint8x16_t m1 = vbicq_u8(index4, b1);
-        uint8x16_t m2 = vbicq_u8(index4, b2);
-        uint8x16_t m3 = vbicq_u8(index4, b3);
-
-        // sum pairs of masks, so result fits into 64-bit low lane
-        uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
-        uint8x16_t s2 = vpaddq_u8(s1, s1);
-
-        // extract 64-bit index mask
-        uint64_t m = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
-
-        // get index of byte that does not match input value, or 64
-        size_t index = m ? MEM_CTZ64(m) : 64;
-
-        // adjust index to correct byte position, due to reused bytes in load
-        // index = (index < 32) ? index : (index - 32) + (size - 32);
-        index += (index >= 32) * (size - 64);
-
-        return offset + index;
     }
-    else if (size & 16) // 16 <= size < 32
-    {
-        // load 32 bytes, some will overlap
-        uint8x16_t a0 = vld1q_u8(p);
-        uint8x16_t a1 = vld1q_u8(p + size - 0x10);
-
-        // set lane to 0xff if lane matches input value, or 0x00 if not
-        uint8x16_t b0 = vceqq_u8(a0, value16);
-        uint8x16_t b1 = vceqq_u8(a1, value16);
-
-        // comparisons to bit index masks
-        uint8x16_t m0 = vbicq_u8(index4, b0);
-        uint8x16_t m1 = vbicq_u8(index4, b1);
-
-        // sum pairs of masks, so result fits into 64-bit low lane
-        uint8x16_t s1 = vpaddq_u8(m0, m1);
-        uint8x16_t s2 = vpaddq_u8(s1, s1);
-        uint8x16_t s3 = vpaddq_u8(s2, s2);
-
-        // extract 64-bit index mask
-        uint32_t m = vgetq_lane_u32(vreinterpretq_u32_u8(s3), 0);
-
-        // get index of byte that does not match input value, or 32
-        size_t index = m ? MEM_CTZ32(m) : 32;
-
-        // adjust index to correct byte position, due to reused bytes in load
-        // index = (index < 16) ? index : (index - 16) + (size - 16);
-        index += (index >= 16) * (size - 32);
+}
 
-        return offset + index;
-    }
-    else if (size) // 0 < size < 16, but initially size > 16
+MEM_DISABLE_ASAN
+void MemCompareBatch_sse2(const MemPair* pairs, size_t count, int* results)
+{
+    for (size_t i=0; i<count; i++)
     {
-        // load 16 bytes from end of buffer
-        // this will load previously checked bytes in 64 byte loop (they did match input value)
-        uint8x16_t a = vld1q_u8(p + size - 16);
-
-        // set lane to 0x00 if lane matches input value, or 0xff if not
-        uint8x16_t b = vmvnq_u8(vceqq_u8(a, value16));
-
-        // extract 4-bit nibble mask
-        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
-        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
-
-        // get index of byte that does not match input value, or 16
-        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+        const MemPair* pair = &pairs[i];
+        MemPrefetchPair(pairs, i + 8, count);
 
-        // adjust index due to reused bytes in load
-        return offset + index + size - 16;
+        if (MemBatchCanLoad(pair, 32))
+        {
+            // extra bit set past the mask, so index is 32 when all bytes are equal
+            uint64_t mask = MemBatchDiff_sse2(pair) | (1ULL << 32);
+            results[i] = MemBatchCompareAt(pair, MEM_CTZ64(mask));
+        }
+        else
+        {
+            results[i] = MemCompare_sse2(pair->ptr1, pair->ptr2, pair->size);
+        }
     }
-
-    // all bytes are same as input value, return original size (current offset plus pending tail size)
-    return offset + size;
 }
 
-#endif // MEM_ARCH_ARM64
-
-
-#if MEM_ARCH_RVV
-
-int MemCompare_rvv(const void* ptr1, const void* ptr2, size_t size)
+bool MemIsEqualConstTime_sse2(const void* ptr1, const void* ptr2, size_t size)
 {
     const uint8_t* p1 = (const uint8_t*)ptr1;
     const uint8_t* p2 = (const uint8_t*)ptr2;
 
-    do
+    // all branches below depend only on size, never on contents of buffers
+
+    if (size < 16)
     {
-        size_t vl = __riscv_vsetvl_e8m8(size);
+        return MemConstTimeDiff(p1, p2, size) == 0;
+    }
 
-        vuint8m8_t a = __riscv_vle8_v_u8m8(p1, vl);
-        vuint8m8_t b = __riscv_vle8_v_u8m8(p2, vl);
-        vbool1_t m = __riscv_vmsne_vv_u8m8_b1(a, b, vl);
+    // accumulate bits that are different in each 16-byte lane
+    __m128i r0 = _mm_setzero_si128();
+    __m128i r1 = _mm_setzero_si128();
+    __m128i r2 = _mm_setzero_si128();
+    __m128i r3 = _mm_setzero_si128();
 
-        long index = __riscv_vfirst_m_b1(m, vl);
-        if (index >= 0)
-        {
-            return p1[index] - p2[index];
-        }
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p1 + 0);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)p1 + 1);
+        __m128i a2 = _mm_loadu_si128((const __m128i*)p1 + 2);
+        __m128i a3 = _mm_loadu_si128((const __m128i*)p1 + 3);
 
-        size -= vl;
-        p1 += vl;
-        p2 += vl;
-    }
-    while (size);
+        __m128i b0 = _mm_loadu_si128((const __m128i*)p2 + 0);
+        __m128i b1 = _mm_loadu_si128((const __m128i*)p2 + 1);
+        __m128i b2 = _mm_loadu_si128((const __m128i*)p2 + 2);
+        __m128i b3 = _mm_loadu_si128((const __m128i*)p2 + 3);
 
-    return 0;
-}
+        r0 = _mm_or_si128(r0, _mm_xor_si128(a0, b0));
+        r1 = _mm_or_si128(r1, _mm_xor_si128(a1, b1));
+        r2 = _mm_or_si128(r2, _mm_xor_si128(a2, b2));
+        r3 = _mm_or_si128(r3, _mm_xor_si128(a3, b3));
 
-int MemCompareI_rvv(const void* ptr1, const void* ptr2, size_t size)
-{
-    const uint8_t* p1 = (const uint8_t*)ptr1;
-    const uint8_t* p2 = (const uint8_t*)ptr2;
+        size -= 64;
+        p1 += 64;
+        p2 += 64;
+    }
 
-    do
+    // then 16-byte blocks
+    while (size >= 16)
     {
-        size_t vl = __riscv_vsetvl_e8m8(size);
-
-        vuint8m8_t a = __riscv_vle8_v_u8m8(p1, vl);
-        vuint8m8_t b = __riscv_vle8_v_u8m8(p2, vl);
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p1);
+        __m128i b0 = _mm_loadu_si128((const __m128i*)p2);
+        r0 = _mm_or_si128(r0, _mm_xor_si128(a0, b0));
 
-        // mask = (uint8_t)(x - 'A') <= ('Z' - 'A')
-        vbool1_t am = __riscv_vmsleu_vx_u8m8_b1(__riscv_vsub_vx_u8m8(a, 'A', vl), 'Z' - 'A', vl);
-        vbool1_t bm = __riscv_vmsleu_vx_u8m8_b1(__riscv_vsub_vx_u8m8(b, 'A', vl), 'Z' - 'A', vl);
+        size -= 16;
+        p1 += 16;
+        p2 += 16;
+    }
 
-        // x = mask ? (x + 'a' - 'A') : x
-        a = __riscv_vadd_vx_u8m8_mu(am, a, a, 'a' - 'A', vl);
-        b = __riscv_vadd_vx_u8m8_mu(bm, b, b, 'a' - 'A', vl);
+    // last 16 bytes overlap with already processed ones, original size was >= 16
+    {
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p1 + size - 16));
+        __m128i b0 = _mm_loadu_si128((const __m128i*)(p2 + size - 16));
+        r1 = _mm_or_si128(r1, _mm_xor_si128(a0, b0));
+    }
 
-        vbool1_t m = __riscv_vmsne_vv_u8m8_b1(a, b, vl);
+    r0 = _mm_or_si128(_mm_or_si128(r0, r1), _mm_or_si128(r2, r3));
 
-        long index = __riscv_vfirst_m_b1(m, vl);
-        if (index >= 0)
-        {
-            a = __riscv_vslidedown_vx_u8m8(a, (unsigned long)index, vl);
-            b = __riscv_vslidedown_vx_u8m8(b, (unsigned long)index, vl);
-            return __riscv_vmv_x_s_u8m8_u8(a) - __riscv_vmv_x_s_u8m8_u8(b);
-        }
+    // buffers are equal only if all accumulated bytes are zero
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(r0, _mm_setzero_si128())) == 0xffff;
+}
 
-        size -= vl;
-        p1 += vl;
-        p2 += vl;
-    }
-    while (size);
+MemPosition MemFindV_sse2(const MemSegment* segments, size_t count, uint8_t value)
+{
+    return MemFindSegments(segments, count, value, &MemFind_sse2);
+}
 
-    return 0;
+bool MemIsEqualV_sse2(const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2)
+{
+    return MemIsEqualSegments(segments1, count1, segments2, count2, &MemIsEqual_sse2);
 }
 
-bool MemIsEqual_rvv(const void* ptr1, const void* ptr2, size_t size)
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+int MemCompare_avx2(const void* ptr1, const void* ptr2, size_t size)
 {
     const uint8_t* p1 = (const uint8_t*)ptr1;
     const uint8_t* p2 = (const uint8_t*)ptr2;
 
-    do
+    if (size == 0)
     {
-        size_t vl = __riscv_vsetvl_e8m8(size);
+        return 0;
+    }
 
-        vuint8m8_t a = __riscv_vle8_v_u8m8(p1, vl);
-        vuint8m8_t b = __riscv_vle8_v_u8m8(p2, vl);
-        vbool1_t m = __riscv_vmsne_vv_u8m8_b1(a, b, vl);
+    if (size <= 32)
+    {
+        const uint32_t PAGE_SIZE = 4096;
 
-        if (__riscv_vcpop_m_b1(m, vl))
+        // if 32 bytes from each pointer does not cross page boundary, can safely load them as 16-byte vector
+        uint32_t address = (uint32_t)(uintptr_t)p1 | (uint32_t)(uintptr_t)p2;
+        if ((address & (PAGE_SIZE - 1)) <= PAGE_SIZE - 32)
         {
-            return false;
-        }
+            __m256i a0 = _mm256_loadu_si256((const __m256i*)p1);
+            __m256i b0 = _mm256_loadu_si256((const __m256i*)p2);
 
-        size -= vl;
-        p1 += vl;
-        p2 += vl;
-    }
-    while (size);
+            // set lanes to 0xff if bytes are equal, or 0x00 if not
+            __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
 
-    return true;
-}
+            // extract top bit of each lane to mask
+            // it will have bit value 0 in positions where bytes are not equal
+            // adding 1 will flip lowest bit with value 0 to value 1
+            // and change all bits with value 1 below it to 0
+            uint32_t m = 1U + (uint32_t)_mm256_movemask_epi8(r0);
 
-size_t MemFind_rvv(const void* ptr, size_t size, uint8_t value)
-{
-    const uint8_t* p = (const uint8_t*)ptr;
+            // get index of byte that's different, evaluates to 32 if all bytes are equal
+            size_t index = MEM_TZCNT32(m);
 
-    size_t offset = 0;
-    do
-    {
-        size_t vl = __riscv_vsetvl_e8m8(size);
+            // return comparison result, or 0 if inputs are equal
+            return index < size ? p1[index] - p2[index] : 0;
+        }
 
-        vuint8m8_t a = __riscv_vle8_v_u8m8(p, vl);
-        vbool1_t m = __riscv_vmseq_vx_u8m8_b1(a, value, vl);
+        // cannot overread buffers, need to load exactly "size" bytes only
 
-        long index = __riscv_vfirst_m_b1(m, vl);
-        if (index >= 0)
+        if (size < 2) // size == 1
         {
-            return offset + (unsigned long)index;
+            return p1[0] - p2[0];
         }
+        else if (size < 4) // 2 <= size < 4
+        {
+            // load two pairs of 2 overlapping bytes, in big-endian
+            uint32_t a0 = MEM_GET16BE(p1);
+            uint32_t b0 = MEM_GET16BE(p2);
+            uint32_t a1 = MEM_GET16BE(p1 + size - 2);
+            uint32_t b1 = MEM_GET16BE(p2 + size - 2);
+            // use a0/b0 if they are not equal, otherwise a1/b1
+            uint32_t a = (a0 != b0 ? a0 : a1);
+            uint32_t b = (a0 != b0 ? b0 : b1);
+            // big-endian numbers can be subtracted to get their order
+            // as long as numbers are small so subtraction does not overflow 32-bit int
+            return (int)a - (int)b;
+        }
+        else if (size < 8) // 4 <= size < 8
+        {
+            // load two pairs of 4 overlapping bytes, in big-endian
+            uint32_t a0 = MEM_GET32BE(p1);
+            uint32_t b0 = MEM_GET32BE(p2);
+            uint32_t a1 = MEM_GET32BE(p1 + size - 4);
+            uint32_t b1 = MEM_GET32BE(p2 + size - 4);
+            // use a0/b0 if they are not equal, otherwise a1/b1
+            uint32_t a = (a0 != b0 ? a0 : a1);
+            uint32_t b = (a0 != b0 ? b0 : b1);
+            // big-endian numbers can be compared directly
+            return (a > b) - (a < b);
+        }
+        else if (size <= 16) // 8 <= size <= 16
+        {
+            // load two pairs of 8 overlapping bytes, in big-endian
+            uint64_t a0 = MEM_GET64BE(p1);
+            uint64_t b0 = MEM_GET64BE(p2);
+            uint64_t a1 = MEM_GET64BE(p1 + size - 8);
+            uint64_t b1 = MEM_GET64BE(p2 + size - 8);
+            // use a0/b0 if they are not equal, otherwise a1/b1
+            uint64_t a = (a0 != b0 ? a0 : a1);
+            uint64_t b = (a0 != b0 ? b0 : b1);
+            // big-endian numbers can be compared directly
+            return (a > b) - (a < b);
+        }
+        else // 16 < size <= 32
+        {
+            // load two pairs of 16 overlapping bytes
+            __m128i a0 = _mm_loadu_si128((const __m128i*)p1);
+            __m128i b0 = _mm_loadu_si128((const __m128i*)p2);
+            __m128i a1 = _mm_loadu_si128((const __m128i*)(p1 + size - 0x10));
+            __m128i b1 = _mm_loadu_si128((const __m128i*)(p2 + size - 0x10));
 
-        offset += vl;
-        size -= vl;
-        p += vl;
-    }
-    while (size);
-
-    return offset;
-}
+            // combine them into 32-byte registers
+            __m256i a = _mm256_inserti128_si256(_mm256_castsi128_si256(a0), a1, 1);
+            __m256i b = _mm256_inserti128_si256(_mm256_castsi128_si256(b0), b1, 1);
 
-size_t MemFindNot_rvv(const void* ptr, size_t size, uint8_t value)
-{
-    const uint8_t* p = (const uint8_t*)ptr;
+            // set lanes to 0xff if bytes are equal, or 0x00 if not
+            __m256i r = _mm256_cmpeq_epi8(a, b);
 
-    size_t offset = 0;
-    do
+            // extract top bit masks, flip lowest 0 bit to 1, changing all bits below it to 0
+            uint32_t m = 1U + (uint32_t)_mm256_movemask_epi8(r);
+
+            // get index of byte that's different, evaluates to 32 if all bytes are equal
+            size_t index = MEM_TZCNT32(m);
+
+            // adjust index to correct byte position (due to how they were packed with _mm256_inserti128_si256)
+            // index = (index < 16) ? index : (index - 16) + (size - 16);
+            index += (index >= 16) * (size - 32);
+
+            // return comparison result, or 0 if inputs are equal
+            return index < size ? p1[index] - p2[index] : 0;
+        }
+    }
+
+    // process 128-byte blocks as much as possible
+    while (size >= 128)
     {
-        size_t vl = __riscv_vsetvl_e8m8(size);
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + 0x00));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + 0x20));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p1 + 0x40));
+        __m256i b2 = _mm256_loadu_si256((const __m256i*)(p2 + 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p1 + 0x60));
+        __m256i b3 = _mm256_loadu_si256((const __m256i*)(p2 + 0x60));
 
-        vuint8m8_t a = __riscv_vle8_v_u8m8(p, vl);
-        vbool1_t m = __riscv_vmsne_vx_u8m8_b1(a, value, vl);
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+        __m256i r1 = _mm256_cmpeq_epi8(a1, b1);
+        __m256i r2 = _mm256_cmpeq_epi8(a2, b2);
+        __m256i r3 = _mm256_cmpeq_epi8(a3, b3);
 
-        long index = __riscv_vfirst_m_b1(m, vl);
-        if (index >= 0)
+        // combine comparisons - leave 0x00 in all lanes that were not equal
+        __m256i r = _mm256_and_si256(_mm256_and_si256(r0, r1), _mm256_and_si256(r2, r3));
+
+        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint32_t mask = 1U + (uint32_t)_mm256_movemask_epi8(r);
+        if (mask)
         {
-            return offset + (unsigned long)index;
+            // extract top bit masks from individual comparisons
+            uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+            uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+            uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+            uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+
+            // combine masks, flip lowest 0 bit to 1, changing all bits below it to 0
+            uint64_t m01 = 1ULL + (m0 | (m1 << 32));
+            uint64_t m23 = 1ULL + (m2 | (m3 << 32));
+
+            // find index of byte with difference
+            size_t idx0 = MEM_TZCNT64(m01);
+            size_t idx1 = MEM_TZCNT64(m23);
+
+            // combine both indices to actual index across both comparisons
+            size_t index = 0;
+            index += idx0;
+            index += m01 ? 0 : idx1;
+
+            return p1[index] - p2[index];
         }
 
-        offset += vl;
-        size -= vl;
-        p += vl;
+        size -= 128;
+        p1 += 128;
+        p2 += 128;
     }
-    while (size);
 
-    return offset;
-}
+    if (size & 64) // 64 <= size < 128
+    {
+        // load 128 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + 0x00));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + 0x20));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x40));
+        __m256i b2 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x20));
+        __m256i b3 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x20));
 
-#endif // MEM_ARCH_RVV
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+        __m256i r1 = _mm256_cmpeq_epi8(a1, b1);
+        __m256i r2 = _mm256_cmpeq_epi8(a2, b2);
+        __m256i r3 = _mm256_cmpeq_epi8(a3, b3);
 
+        // extract top bit masks
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+        uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+        uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
 
-#if MEM_ARCH_X64
+        // combine masks, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint64_t m01 = 1ULL + (m0 | (m1 << 32));
+        uint64_t m23 = 1ULL + (m2 | (m3 << 32));
 
-#define MEM_CPUID_INIT   (1 << 0)
-#define MEM_CPUID_AVX2   (1 << 1)
-#define MEM_CPUID_AVX512 (1 << 2)
+        // get index of byte with difference, plus adjust due to overlap
+        size_t idx0 = MEM_TZCNT64(m01);
+        size_t idx1 = MEM_TZCNT64(m23) + (size - 64) - 64; // 64 will be already in idx0
 
-MEM_TARGET_XSAVE
-static int MemDoCPUID(void)
-{
-    int info[4];
+        // combine both indices to actual index across both comparisons
+        size_t index = 0;
+        index += idx0;
+        index += m01 ? 0 : idx1;
 
-    MEM_CPUID(1, info);
-    int movbe = info[2] & (1 << 22);
-    int xsave = info[2] & (1 << 26);
+        // return comparison result, or 0 if inputs are equal
+        return index < size ? p1[index] - p2[index] : 0;
+    }
+    else if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)p1);
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)p2);
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x20));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x20));
 
-    MEM_CPUID2(7, 0, info);
-    int bmi1 = info[1] & (1 << 3);
-    int avx2 = info[1] & (1 << 5);
-    int bmi2 = info[1] & (1 << 8);
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+        __m256i r1 = _mm256_cmpeq_epi8(a1, b1);
 
-    int avx512f    = info[1] & (1 << 16);
-    int avx512bw   = info[1] & (1 << 30);
-    int avx512vbmi = info[2] & (1 << 1);
+        // extract top bit masks
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
 
-    uint64_t xcr0 = xsave ? MEM_XGETBV(0) : 0;
-    int ymm = (xcr0 & 0x04) == 0x04;
-    int zmm = (xcr0 & 0xe0) == 0xe0;
+        // combine masks, handling overlapped ones, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint64_t m = 1ULL + (m0 | (m1 << (size - 32)));
 
-    int cpuid = 0;
-    cpuid |= (ymm && avx2 && bmi1 && bmi2 && movbe)                     ? MEM_CPUID_AVX2   : 0;
-    cpuid |= (zmm && avx512f && avx512bw && avx512vbmi && bmi1 && bmi2) ? MEM_CPUID_AVX512 : 0;
-    return cpuid;
+        // get index of byte that's different
+        size_t index = MEM_TZCNT64(m);
+
+        // return comparison result, or 0 if inputs are equal
+        return index < size ? p1[index] - p2[index] : 0;
+    }
+    else if (size) // 0 < size < 32, but initially size > 32
+    {
+        // load 32 bytes from end of buffer
+        // this will load previously checked bytes in 128 byte loop (they were equal)
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x20));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x20));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+
+        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint32_t m = 1U + (uint32_t)_mm256_movemask_epi8(r0);
+
+        // get index of byte that's different
+        size_t index = MEM_TZCNT32(m) + size - 32;
+
+        // return comparison result, or 0 if inputs are equal
+        return index < size ? p1[index] - p2[index] : 0;
+    }
+
+    // no differences found, inputs are equal
+    return 0;
 }
 
-MEM_FORCE_INLINE
-static int MemCPUID(void)
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+int MemCompareI_avx2(const void* ptr1, const void* ptr2, size_t size)
 {
-    int result = 0;
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
 
-#if (MEM_COMPILER_CLANG || MEM_COMPILER_GCC) && defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512VBMI__) && defined(__BMI__) && defined(__BMI2__)
-    result |= MEM_CPUID_AVX512;
-#endif
-#if MEM_COMPILER_MSVC && defined(__AVX512F__) && defined(__AVX512BW__)
-    result |= MEM_CPUID_AVX512;
-#endif
-#if (MEM_COMPILER_CLANG || MEM_COMPILER_GCC) && defined(__AVX2__) && defined(__BMI__) && defined(__BMI2__) && defined(__MOVBE__)
-    result |= MEM_CPUID_AVX2;
-#endif
-#if MEM_COMPILER_MSVC && defined(__AVX2__)
-    result |= MEM_CPUID_AVX2;
-#endif
+    if (size == 0)
+    {
+        return 0;
+    }
 
-    if (result == 0)
+    if (size <= 32)
     {
-        static int cpuid;
+        const uint32_t PAGE_SIZE = 4096;
 
-        result = MEM_GET32_RELAXED(&cpuid);
-        if (result == 0)
+        // if 32 bytes from each pointer does not cross page boundary, can safely load them as 16-byte vector
+        uint32_t address = (uint32_t)(uintptr_t)p1 | (uint32_t)(uintptr_t)p2;
+        if ((address & (PAGE_SIZE - 1)) <= PAGE_SIZE - 32)
         {
-            result = MEM_CPUID_INIT | MemDoCPUID();
-            MEM_SET32_RELAXED(&cpuid, result);
-        }
+            // load bytes and convert them to lowercase
+            __m256i a0 = MemToLower32(_mm256_loadu_si256((const __m256i*)p1));
+            __m256i b0 = MemToLower32(_mm256_loadu_si256((const __m256i*)p2));
+
+            // set lanes to 0xff if bytes are equal, or 0x00 if not
+            __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+
+            // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+            uint32_t m = 1U + (uint32_t)_mm256_movemask_epi8(r0);
+
+            // get index of byte that's different, evaluates to 32 if all bytes are equal
+            size_t index = MEM_TZCNT32(m);
+
+            // return comparison result, or 0 if inputs are equal
+            return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
+        }
+
+        // cannot overread buffers, need to load exactly "size" bytes only
+
+        if (size < 2) // size == 1
+        {
+            return MemToLower1(p1[0]) - MemToLower1(p2[0]);
+        }
+
+        // will load pair of 4, 8, 16 or 32 overlapping bytes
+        // a/b0 from beginning of buffer
+        // a/b1 from end of buffers
+        __m128i a0, b0, a1, b1;
+        size_t n;
+
+        if (size < 4) // 2 <= size < 4
+        {
+            a0 = _mm_loadu_si16((const __m128i*)p1);
+            b0 = _mm_loadu_si16((const __m128i*)p2);
+            a1 = _mm_loadu_si16((const __m128i*)(p1 + size - 2));
+            b1 = _mm_loadu_si16((const __m128i*)(p2 + size - 2));
+            n = 2;
+        }
+        else if (size < 8) // 4 <= size < 8
+        {
+            a0 = _mm_loadu_si32((const __m128i*)p1);
+            b0 = _mm_loadu_si32((const __m128i*)p2);
+            a1 = _mm_loadu_si32((const __m128i*)(p1 + size - 4));
+            b1 = _mm_loadu_si32((const __m128i*)(p2 + size - 4));
+            n = 4;
+        }
+        else if (size < 16) // 8 <= size < 16
+        {
+            a0 = _mm_loadu_si64((const __m128i*)p1);
+            b0 = _mm_loadu_si64((const __m128i*)p2);
+            a1 = _mm_loadu_si64((const __m128i*)(p1 + size - 8));
+            b1 = _mm_loadu_si64((const __m128i*)(p2 + size - 8));
+            n = 8;
+        }
+        else // 16 <= size <= 32
+        {
+            a0 = _mm_loadu_si128((const __m128i*)p1);
+            b0 = _mm_loadu_si128((const __m128i*)p2);
+            a1 = _mm_loadu_si128((const __m128i*)(p1 + size - 16));
+            b1 = _mm_loadu_si128((const __m128i*)(p2 + size - 16));
+            n = 16;
+        }
+
+        // pack bytes into 16-byte simd register
+        // a/b0 goes into low 128-bit part
+        // a/b1 goes into high 128-bit part
+        __m256i a = _mm256_inserti128_si256(_mm256_castsi128_si256(a0), a1, 1);
+        __m256i b = _mm256_inserti128_si256(_mm256_castsi128_si256(b0), b1, 1);
+
+        // lowercase, and set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r = _mm256_cmpeq_epi8(MemToLower32(a), MemToLower32(b));
+
+        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint32_t m = 1U + (uint32_t)_mm256_movemask_epi8(r);
+
+        // get index of byte that's different, evaluates to 32 if all bytes are equal
+        size_t index = MEM_TZCNT32(m);
+
+        // adjust index to correct byte position (due to how they were packed with _mm256_inserti128_si256)
+        // index = (index < 16) ? index : (index - 16) + (size - n);
+        index += (index >= 16) * (size - 16 - n);
+
+        // return comparison result, or 0 if inputs are equal
+        return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
+    }
+
+    // process 128-byte blocks as much as possible
+    while (size >= 128)
+    {
+        __m256i a0 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + 0x00)));
+        __m256i b0 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + 0x00)));
+        __m256i a1 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + 0x20)));
+        __m256i b1 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + 0x20)));
+        __m256i a2 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + 0x40)));
+        __m256i b2 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + 0x40)));
+        __m256i a3 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + 0x60)));
+        __m256i b3 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + 0x60)));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+        __m256i r1 = _mm256_cmpeq_epi8(a1, b1);
+        __m256i r2 = _mm256_cmpeq_epi8(a2, b2);
+        __m256i r3 = _mm256_cmpeq_epi8(a3, b3);
+
+        // combine comparisons - leave 0x00 in lanes that were not equal
+        __m256i r = _mm256_and_si256(_mm256_and_si256(r0, r1), _mm256_and_si256(r2, r3));
+
+        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint32_t mask = 1U + (uint32_t)_mm256_movemask_epi8(r);
+        if (mask)
+        {
+            // extract top bit masks for each comparison
+            uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+            uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+            uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+            uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+
+            // combine masks, and flip lowest 0 bit to 1, changing all bits below it to 0
+            uint64_t m01 = 1ULL + (m0 | (m1 << 32));
+            uint64_t m23 = 1ULL + (m2 | (m3 << 32));
+
+            // find index of byte with difference
+            size_t idx0 = MEM_TZCNT64(m01);
+            size_t idx1 = MEM_TZCNT64(m23);
+
+            // combine both indices to actual index across both comparisons
+            size_t index = 0;
+            index += idx0;
+            index += m01 ? 0 : idx1;
+
+            return MemToLower1(p1[index]) - MemToLower1(p2[index]);
+        }
+
+        size -= 128;
+        p1 += 128;
+        p2 += 128;
+    }
+
+    if (size & 64) // 64 <= size < 128
+    {
+        // load 128 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
+        __m256i a0 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + 0x00)));
+        __m256i b0 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + 0x00)));
+        __m256i a1 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + 0x20)));
+        __m256i b1 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + 0x20)));
+        __m256i a2 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + size - 0x40)));
+        __m256i b2 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + size - 0x40)));
+        __m256i a3 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + size - 0x20)));
+        __m256i b3 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + size - 0x20)));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+        __m256i r1 = _mm256_cmpeq_epi8(a1, b1);
+        __m256i r2 = _mm256_cmpeq_epi8(a2, b2);
+        __m256i r3 = _mm256_cmpeq_epi8(a3, b3);
+
+        // extract top bit masks
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+        uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+        uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+
+        // combine masks, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint64_t m01 = 1ULL + (m0 | (m1 << 32));
+        uint64_t m23 = 1ULL + (m2 | (m3 << 32));
+
+        // get index of byte with difference, plus adjust due to overlap
+        size_t idx0 = MEM_TZCNT64(m01);
+        size_t idx1 = MEM_TZCNT64(m23) + (size - 64) - 64; // 64 will be already in idx0
+
+        // combine both indices to actual index across both comparisons
+        size_t index = 0;
+        index += idx0;
+        index += m01 ? 0 : idx1;
+
+        // return comparison result, or 0 if inputs are equal
+        return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
+    }
+    else if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap
+        __m256i a0 = MemToLower32(_mm256_loadu_si256((const __m256i*)p1));
+        __m256i b0 = MemToLower32(_mm256_loadu_si256((const __m256i*)p2));
+        __m256i a1 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + size - 0x20)));
+        __m256i b1 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + size - 0x20)));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+        __m256i r1 = _mm256_cmpeq_epi8(a1, b1);
+
+        // extract top bit masks
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+
+        // combine masks, handling overlapped ones, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint64_t m = 1ULL + (m0 | (m1 << (size - 32)));
+
+        // get index of byte that's different
+        size_t index = MEM_TZCNT64(m);
+
+        // return comparison result, or 0 if inputs are equal
+        return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
+    }
+    else if (size) // 0 < size < 32, but initially size > 32
+    {
+        // load 32 bytes from end of buffer
+        // this will load previously checked bytes in 128 byte loop (they were equal)
+        __m256i a0 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p1 + size - 0x20)));
+        __m256i b0 = MemToLower32(_mm256_loadu_si256((const __m256i*)(p2 + size - 0x20)));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+
+        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint32_t m = 1U + (uint32_t)_mm256_movemask_epi8(r0);
+
+        // get index of byte that's different
+        size_t index = MEM_TZCNT32(m) + size - 32;
+
+        // return comparison result, or 0 if inputs are equal
+        return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
+    }
+
+    // no differences found, inputs are equal
+    return 0;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+bool MemIsEqual_avx2(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    if (size == 0)
+    {
+        return true;
+    }
+
+    if (size <= 32)
+    {
+        const uint32_t PAGE_SIZE = 4096;
+
+        // if 32 bytes from each pointer does not cross page boundary, can safely load them as 32-byte vector
+        uint32_t address = (uint32_t)(uintptr_t)p1 | (uint32_t)(uintptr_t)p2;
+        if ((address & (PAGE_SIZE - 1)) <= PAGE_SIZE - 32)
+        {
+            __m256i a0 = _mm256_loadu_si256((const __m256i*)p1);
+            __m256i b0 = _mm256_loadu_si256((const __m256i*)p2);
+
+            // set lanes to 0xff if bytes are equal, or 0x00 if not
+            __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+
+            // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+            uint32_t mask = 1U + (uint32_t)_mm256_movemask_epi8(r0);
+
+            // need to ignore top "32 - size" bits, only low bits matter
+            // return "true" if they are zero, otherwise "false"
+            return MEM_BZHI32(mask, (uint32_t)size) == 0;
+        }
+
+        // cannot overread buffers, need to load exactly "size" bytes only
+
+        if (size < 2) // size == 1
+        {
+            return p1[0] == p2[0];
+        }
+        else if (size < 4) // 2 <= size < 4
+        {
+            // load two pairs of 2 overlapping bytes
+            uint32_t a0 = MEM_PTR16U(p1);
+            uint32_t b0 = MEM_PTR16U(p2);
+            uint32_t a1 = MEM_PTR16U(p1 + size - 2);
+            uint32_t b1 = MEM_PTR16U(p2 + size - 2);
+            // return "true" if both are equal
+            return (a0 == b0) & (a1 == b1);
+        }
+        else if (size < 8) // 4 <= size < 8
+        {
+            // load two pairs of 4 overlapping bytes
+            uint32_t a0 = MEM_PTR32U(p1);
+            uint32_t b0 = MEM_PTR32U(p2);
+            uint32_t a1 = MEM_PTR32U(p1 + size - 4);
+            uint32_t b1 = MEM_PTR32U(p2 + size - 4);
+            // return "true" if both are equal
+            return (a0 == b0) & (a1 == b1);
+        }
+        else if (size <= 16) // 8 <= size <= 16
+        {
+            // load two pairs of 8 overlapping bytes
+            uint64_t a0 = MEM_PTR64U(p1);
+            uint64_t b0 = MEM_PTR64U(p2);
+            uint64_t a1 = MEM_PTR64U(p1 + size - 8);
+            uint64_t b1 = MEM_PTR64U(p2 + size - 8);
+            // return "true" if both are equal
+            return (a0 == b0) & (a1 == b1);
+        }
+        else // 16 < size <= 32
+        {
+            // load two pairs of 16 overlapping bytes
+            __m128i a0 = _mm_loadu_si128((const __m128i*)p1);
+            __m128i b0 = _mm_loadu_si128((const __m128i*)p2);
+            __m128i a1 = _mm_loadu_si128((const __m128i*)(p1 + size - 16));
+            __m128i b1 = _mm_loadu_si128((const __m128i*)(p2 + size - 16));
+            // combine them into simd register (low lane & high lane)
+            __m256i a = _mm256_inserti128_si256(_mm256_castsi128_si256(a1), a0, 1);
+            __m256i b = _mm256_inserti128_si256(_mm256_castsi128_si256(b1), b0, 1);
+            // produce 0 if all of them are equal
+            __m256i r = _mm256_xor_si256(a, b);
+            // return true, if whole simd register is 0
+            return !!_mm256_testz_si256(r, r);
+        }
+    }
+
+    // process 128-byte blocks as much as possible
+    while (size >= 128)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + 0x00));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + 0x20));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p1 + 0x40));
+        __m256i b2 = _mm256_loadu_si256((const __m256i*)(p2 + 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p1 + 0x60));
+        __m256i b3 = _mm256_loadu_si256((const __m256i*)(p2 + 0x60));
+
+        // produce 0 if all of them are equal
+        __m256i r0 = _mm256_xor_si256(a0, b0);
+        __m256i r1 = _mm256_xor_si256(a1, b1);
+        __m256i r2 = _mm256_xor_si256(a2, b2);
+        __m256i r3 = _mm256_xor_si256(a3, b3);
+
+        // combine results - leave non-zero value in any lane if they were not equal
+        __m256i r = _mm256_or_si256(_mm256_or_si256(r0, r1), _mm256_or_si256(r2, r3));
+        if (!_mm256_testz_si256(r, r))
+        {
+            // if simd register is not fully 0, then inputs are not equal
+            return false;
+        }
+
+        size -= 128;
+        p1 += 128;
+        p2 += 128;
+    }
+
+    if (size & 64) // 64 <= size < 128
+    {
+        // load 128 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + 0x00));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + 0x20));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x40));
+        __m256i b2 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x20));
+        __m256i b3 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x20));
+
+        // produce 0 if all of them are equal
+        __m256i r0 = _mm256_xor_si256(a0, b0);
+        __m256i r1 = _mm256_xor_si256(a1, b1);
+        __m256i r2 = _mm256_xor_si256(a2, b2);
+        __m256i r3 = _mm256_xor_si256(a3, b3);
+
+        // combine results - leave non-zero value in any lane if they were not equal
+        __m256i r = _mm256_or_si256(_mm256_or_si256(r0, r1), _mm256_or_si256(r2, r3));
+
+        // return true, if simd register is fully 0, meaning inputs are equal
+        return !!_mm256_testz_si256(r, r);
+    }
+    else if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)p1);
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)p2);
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x20));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x20));
+
+        // produce 0 if all of them are equal
+        __m256i r0 = _mm256_xor_si256(a0, b0);
+        __m256i r1 = _mm256_xor_si256(a1, b1);
+
+        // combine results - leave non-zero value in any lane if they were not equal
+        __m256i r = _mm256_or_si256(r0, r1);
+
+        // return true, if simd register is fully 0, meaning inputs are equal
+        return !!_mm256_testz_si256(r, r);
+    }
+    else if (size) // 0 < size < 32, but initially size > 32
+    {
+        // load 64 bytes, some will overlap
+        // this will load previously checked bytes in 128 byte loop (they were equal)
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x20));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x20));
+
+        // produce 0 if all of them are equal
+        __m256i r0 = _mm256_xor_si256(a0, b0);
+
+        // return true, if simd register is fully 0, meaning inputs are equal
+        return !!_mm256_testz_si256(r0, r0);
+    }
+
+    // no differences found, inputs are equal
+    return true;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemFind_avx2(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    __m256i value32 = _mm256_set1_epi8((char)value);
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 32)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 32;
+        size_t extra = (address + size) <= 32 ? address : 0;
+
+        // will load before the beginning buffer (32-byte aligned) if end is too close
+        // to 32-byte boundary, otherwise will load past the end of buffer
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p - extra));
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        uint32_t m = MEM_SHRX_32((uint32_t)_mm256_movemask_epi8(r0), (uint32_t)extra);
+
+        // mask out high bits (due to loading bytes after end of buffer)
+        // this will result in returning "size" value if all bytes are same as input value
+        m |= (uint32_t)(1ULL << size);
+
+        // return index of first bit set, which will be index of first byte different from input value
+        return MEM_TZCNT32(m);
+    }
+
+    size_t offset = 0;
+
+    // process 128-byte blocks as much as possible
+    while (size >= 128)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + 0x60));
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
+        __m256i r2 = _mm256_cmpeq_epi8(value32, a2);
+        __m256i r3 = _mm256_cmpeq_epi8(value32, a3);
+
+        // combine comparisons - leave 0xff in lanes there equal to input value
+        __m256i r = _mm256_or_si256(_mm256_or_si256(r0, r1), _mm256_or_si256(r2, r3));
+
+        // extract top bit mask, it will be non-zero if there is at least one matching lane to input value
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(r);
+        if (mask)
+        {
+            // extract top bit masks for each comparison
+            uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+            uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+            uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+            uint64_t m3 = mask; // if r0=r1=r2=0, then r3=r
+
+            // combine masks
+            uint64_t m01 = m0 | (m1 << 32);
+            uint64_t m23 = m2 | (m3 << 32);
+
+            // find index of byte with difference
+            size_t idx0 = MEM_TZCNT64(m01);
+            size_t idx1 = MEM_TZCNT64(m23);
+
+            // combine both indices to actual index across both comparisons
+            offset += idx0;
+            offset += m01 ? 0 : idx1;
+            return offset;
+        }
+
+        offset += 128;
+        size -= 128;
+        p += 128;
+    }
+
+    if (size & 64) // 64 <= size < 128
+    {
+        // load 128 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + size - 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
+        __m256i r2 = _mm256_cmpeq_epi8(value32, a2);
+        __m256i r3 = _mm256_cmpeq_epi8(value32, a3);
+
+        // extract top bit masks for each comparison
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+        uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+        uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+
+        // combine masks
+        uint64_t m01 = m0 | (m1 << 32);
+        uint64_t m23 = m2 | (m3 << 32);
+
+        // get index of byte with difference, plus adjust due to overlap
+        size_t idx0 = MEM_TZCNT64(m01);
+        size_t idx1 = MEM_TZCNT64(m23) + (size - 64) - 64; // 64 will be already in idx0
+
+        // combine both indices to actual index across both comparisons
+        offset += idx0;
+        offset += m01 ? 0 : idx1;
+        return offset;
+    }
+    else if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)p);
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
+
+        // extract top bit masks for each comparison
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+
+        // combine masks, handling overlapped ones
+        uint64_t m = m0 | (m1 << (size - 32));
+
+        // make sure mask is non-zero, this will result in returning "size" value if inputs are equal
+        m |= 1ULL << size;
+
+        // find first bit set, and return index
+        return offset + MEM_TZCNT64(m);
+    }
+    else if (size) // 0 < size < 32, but initially size > 32
+    {
+        // load 32 bytes from end of buffer
+        // this will load previously checked bytes in 128 byte loop (they did not match input value)
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+
+        // extract top bit mask
+        uint32_t m = (uint32_t)_mm256_movemask_epi8(r0);
+
+        // find first bit set, adjust it due to reused bytes in load, and return index
+        return offset + MEM_TZCNT32(m) + size - 32;
+    }
+
+    // no input value found, return original size (current offset plus pending tail size)
+    return offset + size;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemFindNot_avx2(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    __m256i value32 = _mm256_set1_epi8((char)value);
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 32)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 32;
+        size_t extra = (address + size) <= 32 ? address : 0;
+
+        // will load before the beginning buffer (32-byte aligned) if end is too close
+        // to 32-byte boundary, otherwise will load past the end of buffer
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p - extra));
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+
+        // add 1 to flip lowest 0 bit (non-equal position) to 1, changing all bits below it to 0
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        uint32_t m = 1U + MEM_SHRX_32((uint32_t)_mm256_movemask_epi8(r0), (uint32_t)extra);
+
+        // mask out high bits (due to loading bytes after end of buffer)
+        // this will result in returning "size" value if inputs are equal
+        m |= (uint32_t)(1ULL << size);
+
+        // return index of first bit set, which will be index of first byte matching input value
+        return MEM_TZCNT32(m);
+    }
+
+    size_t offset = 0;
+
+    // process 128-byte blocks as much as possible
+    while (size >= 128)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + 0x60));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
+        __m256i r2 = _mm256_cmpeq_epi8(value32, a2);
+        __m256i r3 = _mm256_cmpeq_epi8(value32, a3);
+
+        // combine comparisons - leave 0x00 in lanes that were not equal
+        __m256i r = _mm256_and_si256(_mm256_and_si256(r0, r1), _mm256_and_si256(r2, r3));
+
+        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint32_t mask = 1U + (uint32_t)_mm256_movemask_epi8(r);
+        if (mask)
+        {
+            // extract top bit masks for comparisons
+            uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+            uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+            uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+            uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+
+            // combine masks, and flip lowest 0 bit(non - equal position) to 1, changing all bits below it to 0
+            uint64_t m01 = 1ULL + (m0 | (m1 << 32));
+            uint64_t m23 = 1ULL + (m2 | (m3 << 32));
+
+            // find index of byte with difference
+            size_t idx0 = MEM_TZCNT64(m01);
+            size_t idx1 = MEM_TZCNT64(m23);
+
+            // combine both indices to actual index across both comparisons
+            offset += idx0;
+            offset += m01 ? 0 : idx1;
+            return offset;
+        }
+
+        offset += 128;
+        size -= 128;
+        p += 128;
+    }
+
+    if (size & 64) // 64 <= size < 128
+    {
+        // load 128 bytes, some will overlap
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + size - 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
+        __m256i r2 = _mm256_cmpeq_epi8(value32, a2);
+        __m256i r3 = _mm256_cmpeq_epi8(value32, a3);
+
+        // extract top bit masks
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+        uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+        uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+
+        // combine masks, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint64_t m01 = 1ULL + (m0 | (m1 << 32));
+        uint64_t m23 = 1ULL + (m2 | (m3 << 32));
+
+        // get index of byte with difference, plus adjust due to overlap
+        size_t idx0 = MEM_TZCNT64(m01);
+        size_t idx1 = MEM_TZCNT64(m23) + (size - 64) - 64; // 64 will be already in idx0
+
+        // combine both indices to actual index across both comparisons
+        offset += idx0;
+        offset += m01 ? 0 : idx1;
+        return offset;
+    }
+    else if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)p);
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
+
+        // extract top bit masks
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+
+        // combine masks, handling overlapped ones, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint64_t m = 1ULL + (m0 | (m1 << (size - 32)));
+
+        // return index of byte that's different, m is guaranteed non-zero, because there only max 63 bytes here
+        return offset + MEM_TZCNT64(m);
+    }
+    else if (size) // 0 < size < 32, but initially size > 32
+    {
+        // load 32 bytes from end of buffer
+        // this will load previously checked bytes in 64 byte loop (they did match input value)
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+
+        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint32_t mask = 1U + (uint32_t)_mm256_movemask_epi8(r0);
+
+        // get index of byte that's different, m is guaranteed non-zero, because there only max 31 bytes here
+        return offset + MEM_TZCNT32(mask) + size - 32;
+    }
+
+    // all bytes are same as input value, return original size (current offset plus pending tail size)
+    return offset + size;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemFindLast_avx2(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    __m256i value32 = _mm256_set1_epi8((char)value);
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 32)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 32;
+        size_t extra = (address + size) <= 32 ? address : 0;
+
+        // will load before the beginning buffer (32-byte aligned) if end is too close
+        // to 32-byte boundary, otherwise will load past the end of buffer
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p - extra));
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        uint32_t m = MEM_SHRX_32((uint32_t)_mm256_movemask_epi8(r0), (uint32_t)extra);
+
+        // clear high bits (due to loading bytes after end of buffer)
+        m = MEM_BZHI32(m, (uint32_t)size);
+
+        // return index of last bit set, which will be index of last byte matching input value
+        return m ? MEM_BSR32(m) : size;
+    }
+
+    // remember original size to return when input value is not found
+    const size_t total = size;
+
+    // process 128-byte blocks from the end of buffer as much as possible
+    while (size >= 128)
+    {
+        size -= 128;
+
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + size + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + size + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + size + 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + size + 0x60));
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
+        __m256i r2 = _mm256_cmpeq_epi8(value32, a2);
+        __m256i r3 = _mm256_cmpeq_epi8(value32, a3);
+
+        // combine comparisons - leave 0xff in lanes there equal to input value
+        __m256i r = _mm256_or_si256(_mm256_or_si256(r0, r1), _mm256_or_si256(r2, r3));
+
+        // extract top bit mask, it will be non-zero if there is at least one matching lane to input value
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(r);
+        if (mask)
+        {
+            // extract top bit masks for each comparison
+            uint64_t m0 = mask; // if r1=r2=r3=0, then r0=r
+            uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+            uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+            uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+
+            // combine masks
+            uint64_t m01 = m0 | (m1 << 32);
+            uint64_t m23 = m2 | (m3 << 32);
+
+            // find index of last bit set, upper half takes priority
+            return size + (m23 ? 64 + MEM_BSR64(m23) : MEM_BSR64(m01));
+        }
+    }
+
+    if (size & 64) // 64 <= size < 128
+    {
+        // load 128 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + size - 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
+        __m256i r2 = _mm256_cmpeq_epi8(value32, a2);
+        __m256i r3 = _mm256_cmpeq_epi8(value32, a3);
+
+        // extract top bit masks for each comparison
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+        uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+        uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+
+        // combine masks
+        uint64_t m01 = m0 | (m1 << 32);
+        uint64_t m23 = m2 | (m3 << 32);
+
+        // last 64 bytes take priority, adjust index due to overlap
+        if (m23)
+        {
+            return size - 64 + MEM_BSR64(m23);
+        }
+        return m01 ? MEM_BSR64(m01) : total;
+    }
+    else if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)p);
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
+
+        // extract top bit masks for each comparison
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+
+        // combine masks, handling overlapped ones
+        uint64_t m = m0 | (m1 << (size - 32));
+
+        // find last bit set, and return index
+        return m ? MEM_BSR64(m) : total;
+    }
+    else if (size) // 0 < size < 32, but initially size > 32
+    {
+        // load 32 bytes from beginning of buffer
+        // this will load previously checked bytes in 128 byte loop (they did not match input value)
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)p);
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+
+        // extract top bit mask
+        uint32_t m = (uint32_t)_mm256_movemask_epi8(r0);
+
+        // find last bit set, and return index
+        return m ? MEM_BSR32(m) : total;
+    }
+
+    // no input value found
+    return total;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemFindLastNot_avx2(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    __m256i value32 = _mm256_set1_epi8((char)value);
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 32)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 32;
+        size_t extra = (address + size) <= 32 ? address : 0;
+
+        // will load before the beginning buffer (32-byte aligned) if end is too close
+        // to 32-byte boundary, otherwise will load past the end of buffer
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p - extra));
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+
+        // invert mask to have bits set for bytes not matching input value, then drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        uint32_t m = MEM_SHRX_32(~(uint32_t)_mm256_movemask_epi8(r0), (uint32_t)extra);
+
+        // clear high bits (due to loading bytes after end of buffer)
+        m = MEM_BZHI32(m, (uint32_t)size);
+
+        // return index of last bit set, which will be index of last byte not matching input value
+        return m ? MEM_BSR32(m) : size;
+    }
+
+    // remember original size to return when all bytes are same as input value
+    const size_t total = size;
+
+    // process 128-byte blocks from the end of buffer as much as possible
+    while (size >= 128)
+    {
+        size -= 128;
+
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + size + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + size + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + size + 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + size + 0x60));
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
+        __m256i r2 = _mm256_cmpeq_epi8(value32, a2);
+        __m256i r3 = _mm256_cmpeq_epi8(value32, a3);
+
+        // combine comparisons - leave 0x00 in lanes that were not equal
+        __m256i r = _mm256_and_si256(_mm256_and_si256(r0, r1), _mm256_and_si256(r2, r3));
+
+        // extract inverted top bit mask, it will be non-zero if there is at least one lane not matching input value
+        uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(r);
+        if (mask)
+        {
+            // extract inverted top bit masks for each comparison
+            uint64_t m0 = mask; // if r1=r2=r3=0xff, then r0=r
+            uint64_t m1 = ~(uint32_t)_mm256_movemask_epi8(r1);
+            uint64_t m2 = ~(uint32_t)_mm256_movemask_epi8(r2);
+            uint64_t m3 = ~(uint32_t)_mm256_movemask_epi8(r3);
+
+            // combine masks
+            uint64_t m01 = m0 | (m1 << 32);
+            uint64_t m23 = m2 | (m3 << 32);
+
+            // find index of last bit set, upper half takes priority
+            return size + (m23 ? 64 + MEM_BSR64(m23) : MEM_BSR64(m01));
+        }
+    }
+
+    if (size & 64) // 64 <= size < 128
+    {
+        // load 128 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + size - 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
+        __m256i r2 = _mm256_cmpeq_epi8(value32, a2);
+        __m256i r3 = _mm256_cmpeq_epi8(value32, a3);
+
+        // extract inverted top bit masks for each comparison
+        uint64_t m0 = ~(uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = ~(uint32_t)_mm256_movemask_epi8(r1);
+        uint64_t m2 = ~(uint32_t)_mm256_movemask_epi8(r2);
+        uint64_t m3 = ~(uint32_t)_mm256_movemask_epi8(r3);
+
+        // combine masks
+        uint64_t m01 = m0 | (m1 << 32);
+        uint64_t m23 = m2 | (m3 << 32);
+
+        // last 64 bytes take priority, adjust index due to overlap
+        if (m23)
+        {
+            return size - 64 + MEM_BSR64(m23);
+        }
+        return m01 ? MEM_BSR64(m01) : total;
+    }
+    else if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)p);
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+        __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
+
+        // extract inverted top bit masks for each comparison
+        uint64_t m0 = ~(uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = ~(uint32_t)_mm256_movemask_epi8(r1);
+
+        // combine masks, handling overlapped ones
+        uint64_t m = m0 | (m1 << (size - 32));
+
+        // find last bit set, and return index
+        return m ? MEM_BSR64(m) : total;
+    }
+    else if (size) // 0 < size < 32, but initially size > 32
+    {
+        // load 32 bytes from beginning of buffer
+        // this will load previously checked bytes in 128 byte loop (they matched input value)
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)p);
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+
+        // extract inverted top bit mask
+        uint32_t m = ~(uint32_t)_mm256_movemask_epi8(r0);
+
+        // find last bit set, and return index
+        return m ? MEM_BSR32(m) : total;
+    }
+
+    // all bytes are same as input value
+    return total;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+static MEM_FORCE_INLINE __m256i MemFindAnyMatch_avx2(__m256i a, __m256i c0, __m256i c1, __m256i c2, int table)
+{
+    if (!table)
+    {
+        // set lane to 0xff if lane matches any of input values, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(a, c0);
+        __m256i r1 = _mm256_cmpeq_epi8(a, c1);
+        __m256i r2 = _mm256_cmpeq_epi8(a, c2);
+        return _mm256_or_si256(_mm256_or_si256(r0, r1), r2);
+    }
+
+    // c0/c1 contain bitmask of high nibbles for each low nibble, c0 for bytes 0x00..0x7f, c1 for 0x80..0xff
+    // pshufb returns 0 for lanes with top bit set, so each lookup handles only its half of byte values
+    __m256i row0 = _mm256_shuffle_epi8(c0, a);
+    __m256i row1 = _mm256_shuffle_epi8(c1, _mm256_xor_si256(a, _mm256_set1_epi8((char)0x80)));
+    __m256i row = _mm256_or_si256(row0, row1);
+
+    // c2 contains (1 << (high nibble & 7)) table
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(a, 4), _mm256_set1_epi8(0x0f));
+    __m256i bit = _mm256_shuffle_epi8(c2, high);
+
+    // set lane to 0xff if bit for byte value is set
+    return _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+static MEM_FORCE_INLINE size_t MemFindAnyLoop_avx2(const uint8_t* p, size_t size, __m256i c0, __m256i c1, __m256i c2, int table)
+{
+    if (size <= 32)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 32;
+        size_t extra = (address + size) <= 32 ? address : 0;
+
+        // will load before the beginning buffer (32-byte aligned) if end is too close
+        // to 32-byte boundary, otherwise will load past the end of buffer
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p - extra));
+
+        // set lane to 0xff if lane matches any of input values, or 0x00 if not
+        __m256i r0 = MemFindAnyMatch_avx2(a0, c0, c1, c2, table);
+
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        uint32_t m = MEM_SHRX_32((uint32_t)_mm256_movemask_epi8(r0), (uint32_t)extra);
+
+        // mask out high bits (due to loading bytes after end of buffer)
+        // this will result in returning "size" value if no byte matches
+        m |= (uint32_t)(1ULL << size);
+
+        // return index of first bit set, which will be index of first byte matching any of input values
+        return MEM_TZCNT32(m);
+    }
+
+    size_t offset = 0;
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+
+        __m256i r0 = MemFindAnyMatch_avx2(a0, c0, c1, c2, table);
+        __m256i r1 = MemFindAnyMatch_avx2(a1, c0, c1, c2, table);
+
+        // extract top bit mask, it will be non-zero if there is at least one matching lane
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(r0, r1));
+        if (mask)
+        {
+            uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+            uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+
+            // find first bit set, and return index
+            return offset + MEM_TZCNT64(m0 | (m1 << 32));
+        }
+
+        offset += 64;
+        size -= 64;
+        p += 64;
+    }
+
+    if (size & 32) // 32 <= size < 64
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)p);
+        __m256i r0 = MemFindAnyMatch_avx2(a0, c0, c1, c2, table);
+
+        uint32_t m = (uint32_t)_mm256_movemask_epi8(r0);
+        if (m)
+        {
+            return offset + MEM_TZCNT32(m);
+        }
+
+        offset += 32;
+        size -= 32;
+        p += 32;
+    }
+
+    if (size) // 0 < size < 32, but initially size > 32
+    {
+        // load 32 bytes from end of buffer
+        // this will load previously checked bytes (they did not match input values)
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+        __m256i r0 = MemFindAnyMatch_avx2(a0, c0, c1, c2, table);
+
+        // tzcnt returns 32 for zero mask, this will result in returning original size if nothing matches
+        uint32_t m = (uint32_t)_mm256_movemask_epi8(r0);
+
+        // find first bit set, adjust it due to reused bytes in load, and return index
+        return offset + MEM_TZCNT32(m) + size - 32;
+    }
+
+    // no input values found
+    return offset;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemFindAny_avx2(const void* ptr, size_t size, const void* set, size_t setlen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* s = (const uint8_t*)set;
+
+    if (setlen == 0)
+    {
+        return size;
+    }
+    else if (setlen == 1)
+    {
+        return MemFind_avx2(ptr, size, s[0]);
+    }
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (setlen <= 3)
+    {
+        // for 2 byte set third value is same as second one
+        __m256i v0 = _mm256_set1_epi8((char)s[0]);
+        __m256i v1 = _mm256_set1_epi8((char)s[1]);
+        __m256i v2 = _mm256_set1_epi8((char)s[setlen - 1]);
+        return MemFindAnyLoop_avx2(p, size, v0, v1, v2, 0);
+    }
+
+    // for every byte value set bit (high nibble & 7) in table entry for its low nibble
+    // first 16 entries are for bytes 0x00..0x7f, next 16 entries for bytes 0x80..0xff
+    uint8_t nibbles[32] = { 0 };
+    for (size_t i=0; i<setlen; i++)
+    {
+        uint8_t b = s[i];
+        nibbles[(b >> 7) * 16 + (b & 15)] |= (uint8_t)(1 << ((b >> 4) & 7));
+    }
+
+    __m256i t0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(nibbles + 0x00)));
+    __m256i t1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(nibbles + 0x10)));
+    __m256i bits = _mm256_broadcastsi128_si256(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+    return MemFindAnyLoop_avx2(p, size, t0, t1, bits, 1);
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+static MEM_FORCE_INLINE size_t MemFindBytesCheck_avx2(const uint8_t* p, const uint8_t* n, size_t nlen, uint64_t mask)
+{
+    // first and last bytes are already matching for every bit set in mask, verify rest of the needle
+    while (mask)
+    {
+        size_t index = MEM_CTZ64(mask);
+        if (MemIsEqual_avx2(p + index + 1, n + 1, nlen - 2))
+        {
+            return index;
+        }
+        mask &= mask - 1;
+    }
+    return 64;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemFindBytes_avx2(const void* ptr, size_t size, const void* needle, size_t needlelen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* n = (const uint8_t*)needle;
+
+    if (needlelen == 0)
+    {
+        return 0;
+    }
+    else if (needlelen == 1)
+    {
+        return MemFind_avx2(ptr, size, n[0]);
+    }
+    else if (needlelen > size)
+    {
+        return size;
+    }
+
+    // offset of last needle byte, and amount of positions where needle can start
+    size_t last = needlelen - 1;
+    size_t count = size - last;
+
+    const __m256i first32 = _mm256_set1_epi8((char)n[0]);
+    const __m256i last32 = _mm256_set1_epi8((char)n[last]);
+
+    if (size <= 32)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 32;
+        size_t extra = (address + size) <= 32 ? address : 0;
+
+        // whole buffer fits in one load, it will load before the beginning buffer (32-byte aligned)
+        // if end is too close to 32-byte boundary, otherwise will load past the end of buffer
+        __m256i a = _mm256_loadu_si256((const __m256i*)(p - extra));
+
+        // set lane to 0xff if lane matches first/last needle byte, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(a, first32);
+        __m256i r1 = _mm256_cmpeq_epi8(a, last32);
+
+        // drop any lowest "extra" bits, and shift last byte matches down to their starting position
+        uint32_t m0 = (uint32_t)_mm256_movemask_epi8(r0) >> extra;
+        uint32_t m1 = (uint32_t)_mm256_movemask_epi8(r1) >> (extra + last);
+
+        // keep only positions where whole needle fits in buffer
+        uint32_t mask = m0 & m1 & (uint32_t)((1ULL << count) - 1);
+
+        size_t index = MemFindBytesCheck_avx2(p, n, needlelen, mask);
+        return index < 64 ? index : size;
+    }
+
+    size_t offset = 0;
+
+    // process 64 starting positions at a time
+    while (count - offset >= 64)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + offset + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + offset + 0x20));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p + offset + last + 0x00));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p + offset + last + 0x20));
+
+        // set lane to 0xff if both first and last needle bytes match, or 0x00 if not
+        __m256i r0 = _mm256_and_si256(_mm256_cmpeq_epi8(a0, first32), _mm256_cmpeq_epi8(b0, last32));
+        __m256i r1 = _mm256_and_si256(_mm256_cmpeq_epi8(a1, first32), _mm256_cmpeq_epi8(b1, last32));
+
+        // combine comparisons, it will be non-zero if there is at least one candidate position
+        __m256i r = _mm256_or_si256(r0, r1);
+
+        if (_mm256_movemask_epi8(r))
+        {
+            // extract top bit masks for each comparison
+            uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+            uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+            uint64_t m = m0 | (m1 << 32);
+
+            size_t index = MemFindBytesCheck_avx2(p + offset, n, needlelen, m);
+            if (index < 64)
+            {
+                return offset + index;
+            }
+        }
+
+        offset += 64;
+    }
+
+    if (count - offset >= 32) // 32 <= tail < 64
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(p + offset));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(p + offset + last));
+
+        // set lane to 0xff if both first and last needle bytes match, or 0x00 if not
+        __m256i r = _mm256_and_si256(_mm256_cmpeq_epi8(a, first32), _mm256_cmpeq_epi8(b, last32));
+
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(r);
+        if (mask)
+        {
+            size_t index = MemFindBytesCheck_avx2(p + offset, n, needlelen, mask);
+            if (index < 64)
+            {
+                return offset + index;
+            }
+        }
+
+        offset += 32;
+    }
+
+    if (offset < count) // 0 < tail < 32
+    {
+        size_t tail = count - offset;
+
+        // load first bytes ending at last starting position (or from beginning of buffer if there are
+        // less than 32 starting positions), and last bytes ending at end of buffer
+        // this will load previously checked positions, they will be shifted out from masks
+        size_t start = count >= 32 ? count - 32 : 0;
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + start));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + size - 32));
+
+        // set lane to 0xff if lane matches first/last needle byte, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(a0, first32);
+        __m256i r1 = _mm256_cmpeq_epi8(a1, last32);
+
+        // align both masks to current offset, shift of last byte mask also leaves only "tail" bits
+        uint32_t m0 = (uint32_t)_mm256_movemask_epi8(r0) >> (offset - start);
+        uint32_t m1 = (uint32_t)_mm256_movemask_epi8(r1) >> (32 - tail);
+
+        size_t index = MemFindBytesCheck_avx2(p + offset, n, needlelen, m0 & m1);
+        if (index < 64)
+        {
+            return offset + index;
+        }
+    }
+
+    // needle not found
+    return size;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemCount_avx2(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    __m256i value32 = _mm256_set1_epi8((char)value);
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 32)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 32;
+        size_t extra = (address + size) <= 32 ? address : 0;
+
+        // will load before the beginning buffer (32-byte aligned) if end is too close
+        // to 32-byte boundary, otherwise will load past the end of buffer
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p - extra));
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        uint32_t m = MEM_SHRX_32((uint32_t)_mm256_movemask_epi8(r0), (uint32_t)extra);
+
+        // mask out high bits (due to loading bytes after end of buffer)
+        m = MEM_BZHI32(m, (uint32_t)size);
+
+        return MEM_POPCNT32(m);
+    }
+
+    const __m256i zero = _mm256_setzero_si256();
+
+    // 64-bit counters in four lanes
+    __m256i total = zero;
+
+    // process 128-byte blocks as much as possible
+    while (size >= 128)
+    {
+        // every block adds at most 4 to byte lane counters, so they can accumulate 63 blocks before overflowing
+        size_t count = size / 128 < 63 ? size / 128 : 63;
+
+        __m256i sum = zero;
+        for (size_t i=0; i<count; i++)
+        {
+            __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+            __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+            __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + 0x40));
+            __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + 0x60));
+
+            // set lane to 0xff (-1) if lane matches input value, or 0x00 if not
+            __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+            __m256i r1 = _mm256_cmpeq_epi8(value32, a1);
+            __m256i r2 = _mm256_cmpeq_epi8(value32, a2);
+            __m256i r3 = _mm256_cmpeq_epi8(value32, a3);
+
+            // subtracting -1 increments byte lane counter
+            __m256i s01 = _mm256_add_epi8(r0, r1);
+            __m256i s23 = _mm256_add_epi8(r2, r3);
+            sum = _mm256_sub_epi8(sum, _mm256_add_epi8(s01, s23));
+
+            p += 128;
+        }
+
+        // horizontal sum of byte lane counters into 64-bit counters
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(sum, zero));
+
+        size -= count * 128;
+    }
+
+    // process rest of 32-byte blocks, at most 3
+    {
+        __m256i sum = zero;
+        while (size >= 32)
+        {
+            __m256i a0 = _mm256_loadu_si256((const __m256i*)p);
+
+            // subtracting -1 increments byte lane counter
+            sum = _mm256_sub_epi8(sum, _mm256_cmpeq_epi8(value32, a0));
+
+            p += 32;
+            size -= 32;
+        }
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(sum, zero));
+    }
+
+    __m128i total2 = _mm_add_epi64(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+    total2 = _mm_add_epi64(total2, _mm_unpackhi_epi64(total2, total2));
+    size_t result = (size_t)_mm_cvtsi128_si64(total2);
+
+    if (size) // 0 < size < 32, but initially size > 32
+    {
+        // load 32 bytes from end of buffer
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + size - 32));
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, a0);
+
+        // drop lowest bits for bytes that were already counted
+        uint32_t m = (uint32_t)_mm256_movemask_epi8(r0) >> (32 - size);
+
+        result += MEM_POPCNT32(m);
+    }
+
+    return result;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemMismatch_avx2(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 32)
+    {
+        const uint32_t PAGE_SIZE = 4096;
+
+        // if 32 bytes from each pointer does not cross page boundary, can safely load them as 32-byte vector
+        uint32_t address = (uint32_t)(uintptr_t)p1 | (uint32_t)(uintptr_t)p2;
+        if ((address & (PAGE_SIZE - 1)) <= PAGE_SIZE - 32)
+        {
+            __m256i a0 = _mm256_loadu_si256((const __m256i*)p1);
+            __m256i b0 = _mm256_loadu_si256((const __m256i*)p2);
+
+            // set lanes to 0xff if bytes are equal, or 0x00 if not
+            __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+
+            // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+            uint32_t m = 1U + (uint32_t)_mm256_movemask_epi8(r0);
+
+            // get index of byte that's different, evaluates to 32 if all bytes are equal
+            size_t index = MEM_TZCNT32(m);
+
+            // ignore differences past the end of buffers
+            return index < size ? index : size;
+        }
+
+        // cannot overread buffers, need to load exactly "size" bytes only
+
+        if (size <= 16)
+        {
+            return MemMismatchSmall(p1, p2, size);
+        }
+        else // 16 < size <= 32
+        {
+            // load two pairs of 16 overlapping bytes
+            __m128i a0 = _mm_loadu_si128((const __m128i*)p1);
+            __m128i b0 = _mm_loadu_si128((const __m128i*)p2);
+            __m128i a1 = _mm_loadu_si128((const __m128i*)(p1 + size - 0x10));
+            __m128i b1 = _mm_loadu_si128((const __m128i*)(p2 + size - 0x10));
+
+            // set lanes to 0xff if bytes are equal, or 0x00 if not
+            __m128i r0 = _mm_cmpeq_epi8(a0, b0);
+            __m128i r1 = _mm_cmpeq_epi8(a1, b1);
+
+            // extract top bit masks
+            uint64_t m0 = (uint16_t)_mm_movemask_epi8(r0);
+            uint64_t m1 = (uint16_t)_mm_movemask_epi8(r1);
+
+            // combine masks, handling overlapped ones, flip lowest 0 bit to 1, changing all bits below it to 0
+            uint64_t m = 1ULL + (m0 | (m1 << (size - 16)));
+
+            // return index of byte that's different, evaluates to "size" if all bytes are equal
+            return MEM_TZCNT64(m);
+        }
+    }
+
+    size_t offset = 0;
+
+    // process 128-byte blocks as much as possible
+    while (size >= 128)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + 0x00));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + 0x20));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p1 + 0x40));
+        __m256i b2 = _mm256_loadu_si256((const __m256i*)(p2 + 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p1 + 0x60));
+        __m256i b3 = _mm256_loadu_si256((const __m256i*)(p2 + 0x60));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+        __m256i r1 = _mm256_cmpeq_epi8(a1, b1);
+        __m256i r2 = _mm256_cmpeq_epi8(a2, b2);
+        __m256i r3 = _mm256_cmpeq_epi8(a3, b3);
+
+        // combine comparisons - leave 0x00 in lanes that were not equal
+        __m256i r = _mm256_and_si256(_mm256_and_si256(r0, r1), _mm256_and_si256(r2, r3));
+
+        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint32_t mask = 1U + (uint32_t)_mm256_movemask_epi8(r);
+        if (mask)
+        {
+            // extract top bit masks for comparisons
+            uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+            uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+            uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+            uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+
+            // combine masks, and flip lowest 0 bit(non - equal position) to 1, changing all bits below it to 0
+            uint64_t m01 = 1ULL + (m0 | (m1 << 32));
+            uint64_t m23 = 1ULL + (m2 | (m3 << 32));
+
+            // find index of byte with difference
+            size_t idx0 = MEM_TZCNT64(m01);
+            size_t idx1 = MEM_TZCNT64(m23);
+
+            // combine both indices to actual index across both comparisons
+            offset += idx0;
+            offset += m01 ? 0 : idx1;
+            return offset;
+        }
+
+        offset += 128;
+        size -= 128;
+        p1 += 128;
+        p2 += 128;
+    }
+
+    if (size & 64) // 64 <= size < 128
+    {
+        // load 128 bytes, some will overlap
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + 0x00));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + 0x20));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x40));
+        __m256i b2 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x20));
+        __m256i b3 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x20));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+        __m256i r1 = _mm256_cmpeq_epi8(a1, b1);
+        __m256i r2 = _mm256_cmpeq_epi8(a2, b2);
+        __m256i r3 = _mm256_cmpeq_epi8(a3, b3);
+
+        // extract top bit masks
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+        uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+        uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+
+        // combine masks, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint64_t m01 = 1ULL + (m0 | (m1 << 32));
+        uint64_t m23 = 1ULL + (m2 | (m3 << 32));
+
+        // get index of byte with difference, plus adjust due to overlap
+        size_t idx0 = MEM_TZCNT64(m01);
+        size_t idx1 = MEM_TZCNT64(m23) + (size - 64) - 64; // 64 will be already in idx0
+
+        // combine both indices to actual index across both comparisons
+        offset += idx0;
+        offset += m01 ? 0 : idx1;
+        return offset;
+    }
+    else if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)p1);
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)p2);
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x20));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x20));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+        __m256i r1 = _mm256_cmpeq_epi8(a1, b1);
+
+        // extract top bit masks
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+
+        // combine masks, handling overlapped ones, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint64_t m = 1ULL + (m0 | (m1 << (size - 32)));
+
+        // return index of byte that's different, m is guaranteed non-zero, because there only max 63 bytes here
+        return offset + MEM_TZCNT64(m);
+    }
+    else if (size) // 0 < size < 32, but initially size > 32
+    {
+        // load 32 bytes from end of buffer
+        // this will load previously checked bytes in 64 byte loop (they were equal)
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + size - 0x20));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + size - 0x20));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(a0, b0);
+
+        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint32_t mask = 1U + (uint32_t)_mm256_movemask_epi8(r0);
+
+        // get index of byte that's different, m is guaranteed non-zero, because there only max 31 bytes here
+        return offset + MEM_TZCNT32(mask) + size - 32;
+    }
+
+    // no differences found, return original size (current offset plus pending tail size)
+    return offset + size;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+static MEM_FORCE_INLINE void MemConvertCase_avx2(uint8_t* dst, const uint8_t* src, size_t size, uint8_t first)
+{
+    if (size < 16)
+    {
+        MemConvertCaseSmall(dst, src, size, first);
+        return;
+    }
+    else if (size < 32)
+    {
+        // two 16-byte overlapping blocks
+        __m128i a0 = _mm_loadu_si128((const __m128i*)src);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(src + size - 16));
+        _mm_storeu_si128((__m128i*)dst, MemConvertCase16(a0, first));
+        _mm_storeu_si128((__m128i*)(dst + size - 16), MemConvertCase16(a1, first));
+        return;
+    }
+
+    // process 128-byte blocks as much as possible
+    while (size >= 128)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(src + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(src + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(src + 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(src + 0x60));
+
+        _mm256_storeu_si256((__m256i*)(dst + 0x00), MemConvertCase32(a0, first));
+        _mm256_storeu_si256((__m256i*)(dst + 0x20), MemConvertCase32(a1, first));
+        _mm256_storeu_si256((__m256i*)(dst + 0x40), MemConvertCase32(a2, first));
+        _mm256_storeu_si256((__m256i*)(dst + 0x60), MemConvertCase32(a3, first));
+
+        size -= 128;
+        src += 128;
+        dst += 128;
+    }
+
+    // process 32-byte blocks
+    while (size >= 32)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)src);
+        _mm256_storeu_si256((__m256i*)dst, MemConvertCase32(a0, first));
+
+        size -= 32;
+        src += 32;
+        dst += 32;
+    }
+
+    if (size) // 0 < size < 32, but initially size >= 32
+    {
+        // convert last 32 bytes, this will convert again some of already converted bytes
+        // which is fine, because converting letters to same case twice gives same result
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(src + size - 32));
+        _mm256_storeu_si256((__m256i*)(dst + size - 32), MemConvertCase32(a0, first));
+    }
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+void MemToLower_avx2(void* dst, const void* src, size_t size)
+{
+    MemConvertCase_avx2((uint8_t*)dst, (const uint8_t*)src, size, 'A');
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+void MemToUpper_avx2(void* dst, const void* src, size_t size)
+{
+    MemConvertCase_avx2((uint8_t*)dst, (const uint8_t*)src, size, 'a');
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemFindI_avx2(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    // letters are matched by setting 0x20 bit in input bytes, which maps uppercase letters to lowercase
+    const uint8_t fold = MemCaseBit1(value);
+    __m256i fold32 = _mm256_set1_epi8((char)fold);
+    __m256i value32 = _mm256_set1_epi8((char)(value | fold));
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 32)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 32;
+        size_t extra = (address + size) <= 32 ? address : 0;
+
+        // will load before the beginning buffer (32-byte aligned) if end is too close
+        // to 32-byte boundary, otherwise will load past the end of buffer
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p - extra));
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, _mm256_or_si256(a0, fold32));
+
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        uint32_t m = MEM_SHRX_32((uint32_t)_mm256_movemask_epi8(r0), (uint32_t)extra);
+
+        // mask out high bits (due to loading bytes after end of buffer)
+        // this will result in returning "size" value if all bytes are same as input value
+        m |= (uint32_t)(1ULL << size);
+
+        // return index of first bit set, which will be index of first byte different from input value
+        return MEM_TZCNT32(m);
+    }
+
+    size_t offset = 0;
+
+    // process 128-byte blocks as much as possible
+    while (size >= 128)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + 0x60));
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, _mm256_or_si256(a0, fold32));
+        __m256i r1 = _mm256_cmpeq_epi8(value32, _mm256_or_si256(a1, fold32));
+        __m256i r2 = _mm256_cmpeq_epi8(value32, _mm256_or_si256(a2, fold32));
+        __m256i r3 = _mm256_cmpeq_epi8(value32, _mm256_or_si256(a3, fold32));
+
+        // combine comparisons - leave 0xff in lanes there equal to input value
+        __m256i r = _mm256_or_si256(_mm256_or_si256(r0, r1), _mm256_or_si256(r2, r3));
+
+        // extract top bit mask, it will be non-zero if there is at least one matching lane to input value
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(r);
+        if (mask)
+        {
+            // extract top bit masks for each comparison
+            uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+            uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+            uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+            uint64_t m3 = mask; // if r0=r1=r2=0, then r3=r
+
+            // combine masks
+            uint64_t m01 = m0 | (m1 << 32);
+            uint64_t m23 = m2 | (m3 << 32);
+
+            // find index of byte with difference
+            size_t idx0 = MEM_TZCNT64(m01);
+            size_t idx1 = MEM_TZCNT64(m23);
+
+            // combine both indices to actual index across both comparisons
+            offset += idx0;
+            offset += m01 ? 0 : idx1;
+            return offset;
+        }
+
+        offset += 128;
+        size -= 128;
+        p += 128;
+    }
+
+    if (size & 64) // 64 <= size < 128
+    {
+        // load 128 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + size - 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, _mm256_or_si256(a0, fold32));
+        __m256i r1 = _mm256_cmpeq_epi8(value32, _mm256_or_si256(a1, fold32));
+        __m256i r2 = _mm256_cmpeq_epi8(value32, _mm256_or_si256(a2, fold32));
+        __m256i r3 = _mm256_cmpeq_epi8(value32, _mm256_or_si256(a3, fold32));
+
+        // extract top bit masks for each comparison
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+        uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+        uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+
+        // combine masks
+        uint64_t m01 = m0 | (m1 << 32);
+        uint64_t m23 = m2 | (m3 << 32);
+
+        // get index of byte with difference, plus adjust due to overlap
+        size_t idx0 = MEM_TZCNT64(m01);
+        size_t idx1 = MEM_TZCNT64(m23) + (size - 64) - 64; // 64 will be already in idx0
+
+        // combine both indices to actual index across both comparisons
+        offset += idx0;
+        offset += m01 ? 0 : idx1;
+        return offset;
+    }
+    else if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)p);
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, _mm256_or_si256(a0, fold32));
+        __m256i r1 = _mm256_cmpeq_epi8(value32, _mm256_or_si256(a1, fold32));
+
+        // extract top bit masks for each comparison
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+
+        // combine masks, handling overlapped ones
+        uint64_t m = m0 | (m1 << (size - 32));
+
+        // make sure mask is non-zero, this will result in returning "size" value if inputs are equal
+        m |= 1ULL << size;
+
+        // find first bit set, and return index
+        return offset + MEM_TZCNT64(m);
+    }
+    else if (size) // 0 < size < 32, but initially size > 32
+    {
+        // load 32 bytes from end of buffer
+        // this will load previously checked bytes in 128 byte loop (they did not match input value)
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(value32, _mm256_or_si256(a0, fold32));
+
+        // extract top bit mask
+        uint32_t m = (uint32_t)_mm256_movemask_epi8(r0);
+
+        // find first bit set, adjust it due to reused bytes in load, and return index
+        return offset + MEM_TZCNT32(m) + size - 32;
+    }
+
+    // no input value found, return original size (current offset plus pending tail size)
+    return offset + size;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+static MEM_FORCE_INLINE size_t MemFindBytesICheck_avx2(const uint8_t* p, const uint8_t* n, size_t nlen, uint64_t mask)
+{
+    // first and last bytes are already matching for every bit set in mask, verify rest of the needle
+    while (mask)
+    {
+        size_t index = MEM_CTZ64(mask);
+        if (MemCompareI_avx2(p + index + 1, n + 1, nlen - 2) == 0)
+        {
+            return index;
+        }
+        mask &= mask - 1;
+    }
+    return 64;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemFindBytesI_avx2(const void* ptr, size_t size, const void* needle, size_t needlelen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* n = (const uint8_t*)needle;
+
+    if (needlelen == 0)
+    {
+        return 0;
+    }
+    else if (needlelen == 1)
+    {
+        return MemFindI_avx2(ptr, size, n[0]);
+    }
+    else if (needlelen > size)
+    {
+        return size;
+    }
+
+    // offset of last needle byte, and amount of positions where needle can start
+    size_t last = needlelen - 1;
+    size_t count = size - last;
+
+    // letters are matched by setting 0x20 bit in input bytes, which maps uppercase letters to lowercase
+    const uint8_t first_fold = MemCaseBit1(n[0]);
+    const uint8_t last_fold = MemCaseBit1(n[last]);
+
+    const __m256i first_fold32 = _mm256_set1_epi8((char)first_fold);
+    const __m256i last_fold32 = _mm256_set1_epi8((char)last_fold);
+    const __m256i first32 = _mm256_set1_epi8((char)(n[0] | first_fold));
+    const __m256i last32 = _mm256_set1_epi8((char)(n[last] | last_fold));
+
+    if (size <= 32)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 32;
+        size_t extra = (address + size) <= 32 ? address : 0;
+
+        // whole buffer fits in one load, it will load before the beginning buffer (32-byte aligned)
+        // if end is too close to 32-byte boundary, otherwise will load past the end of buffer
+        __m256i a = _mm256_loadu_si256((const __m256i*)(p - extra));
+
+        // set lane to 0xff if lane matches first/last needle byte, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(_mm256_or_si256(a, first_fold32), first32);
+        __m256i r1 = _mm256_cmpeq_epi8(_mm256_or_si256(a, last_fold32), last32);
+
+        // drop any lowest "extra" bits, and shift last byte matches down to their starting position
+        uint32_t m0 = (uint32_t)_mm256_movemask_epi8(r0) >> extra;
+        uint32_t m1 = (uint32_t)_mm256_movemask_epi8(r1) >> (extra + last);
+
+        // keep only positions where whole needle fits in buffer
+        uint32_t mask = m0 & m1 & (uint32_t)((1ULL << count) - 1);
+
+        size_t index = MemFindBytesICheck_avx2(p, n, needlelen, mask);
+        return index < 64 ? index : size;
+    }
+
+    size_t offset = 0;
+
+    // process 64 starting positions at a time
+    while (count - offset >= 64)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + offset + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + offset + 0x20));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p + offset + last + 0x00));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p + offset + last + 0x20));
+
+        // set lane to 0xff if both first and last needle bytes match, or 0x00 if not
+        __m256i r0 = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_or_si256(a0, first_fold32), first32), _mm256_cmpeq_epi8(_mm256_or_si256(b0, last_fold32), last32));
+        __m256i r1 = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_or_si256(a1, first_fold32), first32), _mm256_cmpeq_epi8(_mm256_or_si256(b1, last_fold32), last32));
+
+        // combine comparisons, it will be non-zero if there is at least one candidate position
+        __m256i r = _mm256_or_si256(r0, r1);
+
+        if (_mm256_movemask_epi8(r))
+        {
+            // extract top bit masks for each comparison
+            uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+            uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+            uint64_t m = m0 | (m1 << 32);
+
+            size_t index = MemFindBytesICheck_avx2(p + offset, n, needlelen, m);
+            if (index < 64)
+            {
+                return offset + index;
+            }
+        }
+
+        offset += 64;
+    }
+
+    if (count - offset >= 32) // 32 <= tail < 64
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(p + offset));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(p + offset + last));
+
+        // set lane to 0xff if both first and last needle bytes match, or 0x00 if not
+        __m256i r = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_or_si256(a, first_fold32), first32), _mm256_cmpeq_epi8(_mm256_or_si256(b, last_fold32), last32));
+
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(r);
+        if (mask)
+        {
+            size_t index = MemFindBytesICheck_avx2(p + offset, n, needlelen, mask);
+            if (index < 64)
+            {
+                return offset + index;
+            }
+        }
+
+        offset += 32;
+    }
+
+    if (offset < count) // 0 < tail < 32
+    {
+        size_t tail = count - offset;
+
+        // load first bytes ending at last starting position (or from beginning of buffer if there are
+        // less than 32 starting positions), and last bytes ending at end of buffer
+        // this will load previously checked positions, they will be shifted out from masks
+        size_t start = count >= 32 ? count - 32 : 0;
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + start));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + size - 32));
+
+        // set lane to 0xff if lane matches first/last needle byte, or 0x00 if not
+        __m256i r0 = _mm256_cmpeq_epi8(_mm256_or_si256(a0, first_fold32), first32);
+        __m256i r1 = _mm256_cmpeq_epi8(_mm256_or_si256(a1, last_fold32), last32);
+
+        // align both masks to current offset, shift of last byte mask also leaves only "tail" bits
+        uint32_t m0 = (uint32_t)_mm256_movemask_epi8(r0) >> (offset - start);
+        uint32_t m1 = (uint32_t)_mm256_movemask_epi8(r1) >> (32 - tail);
+
+        size_t index = MemFindBytesICheck_avx2(p + offset, n, needlelen, m0 & m1);
+        if (index < 64)
+        {
+            return offset + index;
+        }
+    }
+
+    // needle not found
+    return size;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemFindInRange_avx2(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (lo > hi)
+    {
+        // empty range, no byte can be inside it
+        return size;
+    }
+
+    // byte is inside range when unsigned (x - lo) <= (hi - lo)
+    const uint8_t range = (uint8_t)(hi - lo);
+
+    // unsigned comparison is done as signed one by flipping top bit of both sides with 0x80 bias
+    const __m256i lo32 = _mm256_set1_epi8((char)(lo ^ 0x80));
+    const __m256i range32 = _mm256_set1_epi8((char)(range ^ 0x80));
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 32)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 32;
+        size_t extra = (address + size) <= 32 ? address : 0;
+
+        // will load before the beginning buffer (32-byte aligned) if end is too close
+        // to 32-byte boundary, otherwise will load past the end of buffer
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p - extra));
+        // set lane to 0xff if lane is outside of range, or 0x00 if not
+
+        __m256i r0 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a0, lo32), range32);
+
+        // add 1 to flip lowest 0 bit (position inside range) to 1, changing all bits below it to 0
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        uint32_t m = 1U + MEM_SHRX_32((uint32_t)_mm256_movemask_epi8(r0), (uint32_t)extra);
+
+        // mask out high bits (due to loading bytes after end of buffer)
+        // this will result in returning "size" value if no byte is found
+        m |= (uint32_t)(1ULL << size);
+
+        // return index of first bit set, which will be index of first byte inside range
+        return MEM_TZCNT32(m);
+    }
+
+    size_t offset = 0;
+
+    // process 128-byte blocks as much as possible
+    while (size >= 128)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + 0x60));
+
+        // set lanes to 0xff if bytes are outside of range, or 0x00 if not
+        __m256i r0 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a0, lo32), range32);
+        __m256i r1 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a1, lo32), range32);
+        __m256i r2 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a2, lo32), range32);
+        __m256i r3 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a3, lo32), range32);
+
+        // combine comparisons - leave 0x00 in lanes that were inside range
+        __m256i r = _mm256_and_si256(_mm256_and_si256(r0, r1), _mm256_and_si256(r2, r3));
+
+        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint32_t mask = 1U + (uint32_t)_mm256_movemask_epi8(r);
+        if (mask)
+        {
+            // extract top bit masks for comparisons
+            uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+            uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+            uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+            uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+
+            // combine masks, and flip lowest 0 bit(position inside range) to 1, changing all bits below it to 0
+            uint64_t m01 = 1ULL + (m0 | (m1 << 32));
+            uint64_t m23 = 1ULL + (m2 | (m3 << 32));
+
+            // find index of byte inside range
+            size_t idx0 = MEM_TZCNT64(m01);
+            size_t idx1 = MEM_TZCNT64(m23);
+
+            // combine both indices to actual index across both comparisons
+            offset += idx0;
+            offset += m01 ? 0 : idx1;
+            return offset;
+        }
+
+        offset += 128;
+        size -= 128;
+        p += 128;
+    }
+
+    if (size & 64) // 64 <= size < 128
+    {
+        // load 128 bytes, some will overlap
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + size - 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are outside of range, or 0x00 if not
+        __m256i r0 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a0, lo32), range32);
+        __m256i r1 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a1, lo32), range32);
+        __m256i r2 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a2, lo32), range32);
+        __m256i r3 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a3, lo32), range32);
+
+        // extract top bit masks
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+        uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+        uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+
+        // combine masks, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint64_t m01 = 1ULL + (m0 | (m1 << 32));
+        uint64_t m23 = 1ULL + (m2 | (m3 << 32));
+
+        // get index of byte inside range, plus adjust due to overlap
+        size_t idx0 = MEM_TZCNT64(m01);
+        size_t idx1 = MEM_TZCNT64(m23) + (size - 64) - 64; // 64 will be already in idx0
+
+        // combine both indices to actual index across both comparisons
+        offset += idx0;
+        offset += m01 ? 0 : idx1;
+        return offset;
+    }
+    else if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)p);
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are outside of range, or 0x00 if not
+        __m256i r0 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a0, lo32), range32);
+        __m256i r1 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a1, lo32), range32);
+
+        // extract top bit masks
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+
+        // combine masks, handling overlapped ones, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint64_t m = 1ULL + (m0 | (m1 << (size - 32)));
+
+        // return index of byte inside range, m is guaranteed non-zero, because there only max 63 bytes here
+        return offset + MEM_TZCNT64(m);
+    }
+    else if (size) // 0 < size < 32, but initially size > 32
+    {
+        // load 32 bytes from end of buffer
+        // this will load previously checked bytes in 64 byte loop (they were outside of range)
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are outside of range, or 0x00 if not
+        __m256i r0 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a0, lo32), range32);
+
+        // extract top bit mask, flip lowest 0 bit to 1, changing all bits below it to 0
+        uint32_t mask = 1U + (uint32_t)_mm256_movemask_epi8(r0);
+
+        // get index of byte inside range, m is guaranteed non-zero, because there only max 31 bytes here
+        return offset + MEM_TZCNT32(mask) + size - 32;
+    }
+
+    // no byte inside range found, return original size (current offset plus pending tail size)
+    return offset + size;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemFindNotInRange_avx2(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (lo > hi)
+    {
+        // empty range, every byte is outside of it
+        return 0;
+    }
+
+    // byte is inside range when unsigned (x - lo) <= (hi - lo)
+    const uint8_t range = (uint8_t)(hi - lo);
+
+    // unsigned comparison is done as signed one by flipping top bit of both sides with 0x80 bias
+    const __m256i lo32 = _mm256_set1_epi8((char)(lo ^ 0x80));
+    const __m256i range32 = _mm256_set1_epi8((char)(range ^ 0x80));
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 32)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 32;
+        size_t extra = (address + size) <= 32 ? address : 0;
+
+        // will load before the beginning buffer (32-byte aligned) if end is too close
+        // to 32-byte boundary, otherwise will load past the end of buffer
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p - extra));
+
+        // set lane to 0xff if lane is outside of range, or 0x00 if not
+        __m256i r0 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a0, lo32), range32);
+
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        uint32_t m = MEM_SHRX_32((uint32_t)_mm256_movemask_epi8(r0), (uint32_t)extra);
+
+        // mask out high bits (due to loading bytes after end of buffer)
+        // this will result in returning "size" value if no byte outside of range found
+        m |= (uint32_t)(1ULL << size);
+
+        // return index of first bit set, which will be index of first byte outside of range
+        return MEM_TZCNT32(m);
+    }
+
+    size_t offset = 0;
+
+    // process 128-byte blocks as much as possible
+    while (size >= 128)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + 0x60));
+
+        // set lane to 0xff if lane is outside of range, or 0x00 if not
+        __m256i r0 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a0, lo32), range32);
+        __m256i r1 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a1, lo32), range32);
+        __m256i r2 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a2, lo32), range32);
+        __m256i r3 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a3, lo32), range32);
+
+        // combine comparisons - leave 0xff in lanes that are outside of range
+        __m256i r = _mm256_or_si256(_mm256_or_si256(r0, r1), _mm256_or_si256(r2, r3));
+
+        // extract top bit mask, it will be non-zero if there is at least one lane outside of range
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(r);
+        if (mask)
+        {
+            // extract top bit masks for each comparison
+            uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+            uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+            uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+            uint64_t m3 = mask; // if r0=r1=r2=0, then r3=r
+
+            // combine masks
+            uint64_t m01 = m0 | (m1 << 32);
+            uint64_t m23 = m2 | (m3 << 32);
+
+            // find index of byte outside of range
+            size_t idx0 = MEM_TZCNT64(m01);
+            size_t idx1 = MEM_TZCNT64(m23);
+
+            // combine both indices to actual index across both comparisons
+            offset += idx0;
+            offset += m01 ? 0 : idx1;
+            return offset;
+        }
+
+        offset += 128;
+        size -= 128;
+        p += 128;
+    }
+
+    if (size & 64) // 64 <= size < 128
+    {
+        // load 128 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + size - 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are outside of range, or 0x00 if not
+        __m256i r0 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a0, lo32), range32);
+        __m256i r1 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a1, lo32), range32);
+        __m256i r2 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a2, lo32), range32);
+        __m256i r3 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a3, lo32), range32);
+
+        // extract top bit masks for each comparison
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+        uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+        uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+
+        // combine masks
+        uint64_t m01 = m0 | (m1 << 32);
+        uint64_t m23 = m2 | (m3 << 32);
+
+        // get index of byte outside of range, plus adjust due to overlap
+        size_t idx0 = MEM_TZCNT64(m01);
+        size_t idx1 = MEM_TZCNT64(m23) + (size - 64) - 64; // 64 will be already in idx0
+
+        // combine both indices to actual index across both comparisons
+        offset += idx0;
+        offset += m01 ? 0 : idx1;
+        return offset;
+    }
+    else if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)p);
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are outside of range, or 0x00 if not
+        __m256i r0 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a0, lo32), range32);
+        __m256i r1 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a1, lo32), range32);
+
+        // extract top bit masks for each comparison
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+
+        // combine masks, handling overlapped ones
+        uint64_t m = m0 | (m1 << (size - 32));
+
+        // make sure mask is non-zero, this will result in returning "size" value if no byte is found
+        m |= 1ULL << size;
+
+        // find first bit set, and return index
+        return offset + MEM_TZCNT64(m);
+    }
+    else if (size) // 0 < size < 32, but initially size > 32
+    {
+        // load 32 bytes from end of buffer
+        // this will load previously checked bytes in 128 byte loop (they were inside range)
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        // set lanes to 0xff if bytes are outside of range, or 0x00 if not
+        __m256i r0 = _mm256_cmpgt_epi8(_mm256_sub_epi8(a0, lo32), range32);
+
+        // extract top bit mask
+        uint32_t m = (uint32_t)_mm256_movemask_epi8(r0);
+
+        // find first bit set, adjust it due to reused bytes in load, and return index
+        return offset + MEM_TZCNT32(m) + size - 32;
+    }
+
+    // no byte outside of range found, return original size (current offset plus pending tail size)
+    return offset + size;
+}
+
+MEM_TARGET_AVX2
+static MEM_FORCE_INLINE __m256i MemValidateUTF8Check_avx2(__m256i a, __m256i prev, __m256i byte1_high, __m256i byte1_low, __m256i byte2_high)
+{
+    const __m256i low4 = _mm256_set1_epi8(0x0f);
+
+    // input shifted by 1, 2 and 3 bytes, with last bytes of previous input shifted in
+    __m256i last = _mm256_permute2x128_si256(prev, a, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(a, last, 15);
+    __m256i prev2 = _mm256_alignr_epi8(a, last, 14);
+    __m256i prev3 = _mm256_alignr_epi8(a, last, 13);
+
+    // look up error bits for both nibbles of previous byte, and high nibble of current byte
+    __m256i e0 = _mm256_shuffle_epi8(byte1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low4));
+    __m256i e1 = _mm256_shuffle_epi8(byte1_low, _mm256_and_si256(prev1, low4));
+    __m256i e2 = _mm256_shuffle_epi8(byte2_high, _mm256_and_si256(_mm256_srli_epi16(a, 4), low4));
+    __m256i special = _mm256_and_si256(_mm256_and_si256(e0, e1), e2);
+
+    // set top bit where byte must be 3rd or 4th byte of sequence, these are reported as two continuations in lookup
+    __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xe0 - 0x80)));
+    __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xf0 - 0x80)));
+    __m256i must23 = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8((char)0x80));
+
+    // non-zero lanes are errors
+    return _mm256_xor_si256(must23, special);
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemValidateUTF8_avx2(const void* ptr, size_t size)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    // skip all leading ASCII bytes
+    size_t offset = MemFindInRange_avx2(p, size, 0x80, 0xff);
+    size -= offset;
+    p += offset;
+
+    const __m256i byte1_high = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)MemUTF8Byte1High));
+    const __m256i byte1_low = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)MemUTF8Byte1Low));
+    const __m256i byte2_high = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)MemUTF8Byte2High));
+    const __m256i incomplete_max = _mm256_loadu_si256((const __m256i*)(MemUTF8Incomplete + 32));
+
+    // bytes before current block are ASCII or complete sequences
+    __m256i prev = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+
+        __m256i error;
+        if (_mm256_movemask_epi8(_mm256_or_si256(a0, a1)) == 0)
+        {
+            // all bytes are ASCII, only error can be sequence from previous block that did not finish
+            error = incomplete;
+        }
+        else
+        {
+            __m256i r0 = MemValidateUTF8Check_avx2(a0, prev, byte1_high, byte1_low, byte2_high);
+            __m256i r1 = MemValidateUTF8Check_avx2(a1, a0, byte1_high, byte1_low, byte2_high);
+            error = _mm256_or_si256(r0, r1);
+
+            // remember if block ends with sequence that must continue in next block
+            incomplete = _mm256_subs_epu8(a1, incomplete_max);
+        }
+
+        if (!_mm256_testz_si256(error, error))
+        {
+            break;
+        }
+
+        prev = a1;
+        offset += 64;
+        size -= 64;
+        p += 64;
+    }
+
+    // validate remaining bytes with scalar code, this also finds exact position of error if loop above found one
+    // start from last sequence before current position, because it may continue into current block
+    size_t back = MemUTF8Back(p, offset);
+    return offset - back + MemValidateUTF8_generic(p - back, size + back);
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+static MEM_FORCE_INLINE void MemClassifyLoop_avx2(const uint8_t* p, size_t size, __m256i c0, __m256i c1, __m256i c2, int table, uint64_t* masks)
+{
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(MemFindAnyMatch_avx2(a0, c0, c1, c2, table));
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(MemFindAnyMatch_avx2(a1, c0, c1, c2, table));
+
+        *masks++ = m0 | (m1 << 32);
+
+        size -= 64;
+        p += 64;
+    }
+
+    if (size) // 0 < size < 64, but initially size >= 64
+    {
+        // load 64 bytes from end of buffer, this will load previously classified bytes
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + size - 0x40));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + size - 0x20));
+
+        uint64_t m0 = (uint32_t)_mm256_movemask_epi8(MemFindAnyMatch_avx2(a0, c0, c1, c2, table));
+        uint64_t m1 = (uint32_t)_mm256_movemask_epi8(MemFindAnyMatch_avx2(a1, c0, c1, c2, table));
+
+        // drop bits of previously classified bytes
+        *masks = (m0 | (m1 << 32)) >> (64 - size);
+    }
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+void MemClassify_avx2(const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* s = (const uint8_t*)set;
+
+    if (setlen == 0 || size < 64)
+    {
+        MemClassify_generic(ptr, size, set, setlen, masks);
+        return;
+    }
+
+    if (setlen <= 3)
+    {
+        // for smaller sets some values are repeated
+        __m256i v0 = _mm256_set1_epi8((char)s[0]);
+        __m256i v1 = _mm256_set1_epi8((char)s[setlen / 2]);
+        __m256i v2 = _mm256_set1_epi8((char)s[setlen - 1]);
+        MemClassifyLoop_avx2(p, size, v0, v1, v2, 0, masks);
+        return;
+    }
+
+    // for every byte value set bit (high nibble & 7) in table entry for its low nibble
+    // first 16 entries are for bytes 0x00..0x7f, next 16 entries for bytes 0x80..0xff
+    uint8_t nibbles[32] = { 0 };
+    for (size_t i=0; i<setlen; i++)
+    {
+        uint8_t b = s[i];
+        nibbles[(b >> 7) * 16 + (b & 15)] |= (uint8_t)(1 << ((b >> 4) & 7));
+    }
+
+    __m256i t0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(nibbles + 0x00)));
+    __m256i t1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(nibbles + 0x10)));
+    __m256i bits = _mm256_broadcastsi128_si256(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+    MemClassifyLoop_avx2(p, size, t0, t1, bits, 1, masks);
+}
+
+// set all lanes of element to 0xff if element matches input value, or to 0x00 if not (inverted if "invert" is set)
+MEM_TARGET_AVX2
+static MEM_FORCE_INLINE __m256i MemFindWideMatch_avx2(__m256i a, __m256i value32, size_t width, int invert)
+{
+    __m256i r;
+    if (width == 2)
+    {
+        r = _mm256_cmpeq_epi16(a, value32);
+    }
+    else if (width == 4)
+    {
+        r = _mm256_cmpeq_epi32(a, value32);
+    }
+    else
+    {
+        r = _mm256_cmpeq_epi64(a, value32);
+    }
+    return invert ? _mm256_xor_si256(r, _mm256_set1_epi32(-1)) : r;
+}
+
+// size is in bytes, must be multiple of width and >= 32, returns element index
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+static MEM_FORCE_INLINE size_t MemFindWide_avx2(const uint8_t* p, size_t size, __m256i value32, size_t width, int invert)
+{
+    size_t offset = 0;
+
+    // process 128-byte blocks as much as possible
+    while (size >= 128)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + 0x60));
+
+        __m256i r0 = MemFindWideMatch_avx2(a0, value32, width, invert);
+        __m256i r1 = MemFindWideMatch_avx2(a1, value32, width, invert);
+        __m256i r2 = MemFindWideMatch_avx2(a2, value32, width, invert);
+        __m256i r3 = MemFindWideMatch_avx2(a3, value32, width, invert);
+
+        // combine comparisons - leave 0xff in lanes of matching elements
+        __m256i r = _mm256_or_si256(_mm256_or_si256(r0, r1), _mm256_or_si256(r2, r3));
+        if (!_mm256_testz_si256(r, r))
+        {
+            // extract top bit masks for each comparison
+            uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+            uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+            uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+            uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+
+            // combine them into two masks, at least one of them is non-zero
+            uint64_t m01 = m0 | (m1 << 32);
+            uint64_t m23 = m2 | (m3 << 32);
+
+            // find first bit set, and convert byte index to element index
+            size_t index = m01 ? MEM_CTZ64(m01) : 64 + MEM_CTZ64(m23);
+            return (offset + index) / width;
+        }
+
+        offset += 128;
+        size -= 128;
+        p += 128;
+    }
+
+    // process 32-byte blocks
+    while (size >= 32)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)p);
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(MemFindWideMatch_avx2(a, value32, width, invert));
+        if (mask)
+        {
+            return (offset + MEM_CTZ32(mask)) / width;
+        }
+
+        offset += 32;
+        size -= 32;
+        p += 32;
+    }
+
+    if (size) // 0 < size < 32, but initially size >= 32
+    {
+        // load 32 bytes from end of buffer, this will load previously checked elements
+        __m256i a = _mm256_loadu_si256((const __m256i*)(p + size - 32));
+
+        // drop bits of previously checked elements
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(MemFindWideMatch_avx2(a, value32, width, invert));
+        mask >>= 32 - size;
+        if (mask)
+        {
+            return (offset + MEM_CTZ32(mask)) / width;
+        }
+
+        offset += size;
+    }
+
+    // no matching element found
+    return offset / width;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemFind16_avx2(const void* ptr, size_t count, uint16_t value)
+{
+    if (count < 32 / sizeof(value))
+    {
+        return MemFind16_generic(ptr, count, value);
+    }
+    return MemFindWide_avx2((const uint8_t*)ptr, count * sizeof(value), _mm256_set1_epi16((short)value), sizeof(value), 0);
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemFind32_avx2(const void* ptr, size_t count, uint32_t value)
+{
+    if (count < 32 / sizeof(value))
+    {
+        return MemFind32_generic(ptr, count, value);
+    }
+    return MemFindWide_avx2((const uint8_t*)ptr, count * sizeof(value), _mm256_set1_epi32((int)value), sizeof(value), 0);
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemFind64_avx2(const void* ptr, size_t count, uint64_t value)
+{
+    if (count < 32 / sizeof(value))
+    {
+        return MemFind64_generic(ptr, count, value);
+    }
+    return MemFindWide_avx2((const uint8_t*)ptr, count * sizeof(value), _mm256_set1_epi64x((long long)value), sizeof(value), 0);
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemFindNot16_avx2(const void* ptr, size_t count, uint16_t value)
+{
+    if (count < 32 / sizeof(value))
+    {
+        return MemFindNot16_generic(ptr, count, value);
+    }
+    return MemFindWide_avx2((const uint8_t*)ptr, count * sizeof(value), _mm256_set1_epi16((short)value), sizeof(value), 1);
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemFindNot32_avx2(const void* ptr, size_t count, uint32_t value)
+{
+    if (count < 32 / sizeof(value))
+    {
+        return MemFindNot32_generic(ptr, count, value);
+    }
+    return MemFindWide_avx2((const uint8_t*)ptr, count * sizeof(value), _mm256_set1_epi32((int)value), sizeof(value), 1);
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemFindNot64_avx2(const void* ptr, size_t count, uint64_t value)
+{
+    if (count < 32 / sizeof(value))
+    {
+        return MemFindNot64_generic(ptr, count, value);
+    }
+    return MemFindWide_avx2((const uint8_t*)ptr, count * sizeof(value), _mm256_set1_epi64x((long long)value), sizeof(value), 1);
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemLowerBound32_avx2(const void* ptr, size_t count, uint32_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (count < 32)
+    {
+        return MemLowerBound32_generic(ptr, count, value);
+    }
+
+    // binary search down to 32 elements, which are compared all at once
+    size_t start = MemLowerBoundWindow(p, count, value, sizeof(value), 32);
+    p += start * sizeof(value);
+
+    // flip top bit for unsigned comparison with signed compare instruction
+    const __m256i sign = _mm256_set1_epi32((int)0x80000000);
+    const __m256i value32 = _mm256_xor_si256(_mm256_set1_epi32((int)value), sign);
+
+    __m256i a0 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(p + 0x00)), sign);
+    __m256i a1 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(p + 0x20)), sign);
+    __m256i a2 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(p + 0x40)), sign);
+    __m256i a3 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(p + 0x60)), sign);
+
+    // set lanes to 0xff for elements less than input value
+    __m256i r0 = _mm256_cmpgt_epi32(value32, a0);
+    __m256i r1 = _mm256_cmpgt_epi32(value32, a1);
+    __m256i r2 = _mm256_cmpgt_epi32(value32, a2);
+    __m256i r3 = _mm256_cmpgt_epi32(value32, a3);
+
+    // extract top bit masks for each comparison, and combine them into two masks
+    uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+    uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+    uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+    uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+    uint64_t m01 = m0 | (m1 << 32);
+    uint64_t m23 = m2 | (m3 << 32);
+
+    // every element less than input value has 4 bits set
+    return start + (MEM_POPCNT64(m01) + MEM_POPCNT64(m23)) / 4;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+size_t MemLowerBound64_avx2(const void* ptr, size_t count, uint64_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (count < 16)
+    {
+        return MemLowerBound64_generic(ptr, count, value);
+    }
+
+    // binary search down to 16 elements, which are compared all at once
+    size_t start = MemLowerBoundWindow(p, count, value, sizeof(value), 16);
+    p += start * sizeof(value);
+
+    // flip top bit for unsigned comparison with signed compare instruction
+    const __m256i sign = _mm256_set1_epi64x((long long)0x8000000000000000ULL);
+    const __m256i value32 = _mm256_xor_si256(_mm256_set1_epi64x((long long)value), sign);
+
+    __m256i a0 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(p + 0x00)), sign);
+    __m256i a1 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(p + 0x20)), sign);
+    __m256i a2 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(p + 0x40)), sign);
+    __m256i a3 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(p + 0x60)), sign);
+
+    // set lanes to 0xff for elements less than input value
+    __m256i r0 = _mm256_cmpgt_epi64(value32, a0);
+    __m256i r1 = _mm256_cmpgt_epi64(value32, a1);
+    __m256i r2 = _mm256_cmpgt_epi64(value32, a2);
+    __m256i r3 = _mm256_cmpgt_epi64(value32, a3);
+
+    // extract top bit masks for each comparison, and combine them into two masks
+    uint64_t m0 = (uint32_t)_mm256_movemask_epi8(r0);
+    uint64_t m1 = (uint32_t)_mm256_movemask_epi8(r1);
+    uint64_t m2 = (uint32_t)_mm256_movemask_epi8(r2);
+    uint64_t m3 = (uint32_t)_mm256_movemask_epi8(r3);
+    uint64_t m01 = m0 | (m1 << 32);
+    uint64_t m23 = m2 | (m3 << 32);
+
+    // every element less than input value has 8 bits set
+    return start + (MEM_POPCNT64(m01) + MEM_POPCNT64(m23)) / 8;
+}
+
+// translates 32 bytes with 256-byte table split into 16 rows of 16 bytes
+MEM_TARGET_AVX2
+static MEM_FORCE_INLINE __m256i MemTranslateLookup_avx2(__m256i a, const __m256i* rows)
+{
+    const __m256i bias = _mm256_set1_epi8(0x70);
+    const __m256i step = _mm256_set1_epi8(0x10);
+
+    // shuffle uses low 4 bits of input, and returns 0 for lanes with top bit set
+    // after subtracting 16 for every row, adding 0x70 with saturation leaves top bit clear only in lanes that are in current row
+    __m256i r = _mm256_setzero_si256();
+    for (size_t i=0; i<16; i++)
+    {
+        r = _mm256_or_si256(r, _mm256_shuffle_epi8(rows[i], _mm256_adds_epu8(a, bias)));
+        a = _mm256_sub_epi8(a, step);
+    }
+    return r;
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+void MemTranslate_avx2(void* dst, const void* src, size_t size, const uint8_t table[256])
+{
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+
+    if (size < 32)
+    {
+        MemTranslate_generic(dst, src, size, table);
+        return;
+    }
+
+    __m256i rows[16];
+    for (size_t i=0; i<16; i++)
+    {
+        rows[i] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(table + i * 16)));
+    }
+
+    // load last 32 bytes before storing anything, so dst can be same as src
+    // translating same bytes twice would not give same result, unlike case conversion
+    __m256i last = _mm256_loadu_si256((const __m256i*)(s + size - 32));
+
+    // process 32-byte blocks, except the last one
+    while (size > 32)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)s);
+        _mm256_storeu_si256((__m256i*)d, MemTranslateLookup_avx2(a, rows));
+
+        size -= 32;
+        s += 32;
+        d += 32;
+    }
+
+    // last 32 bytes, will overwrite some of already translated bytes with same values
+    _mm256_storeu_si256((__m256i*)(d + size - 32), MemTranslateLookup_avx2(last, rows));
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+static MEM_FORCE_INLINE void MemHashStripe_avx2(__m256i acc[2], const uint8_t* p, const uint64_t* key)
+{
+    for (size_t i=0; i<2; i++)
+    {
+        __m256i data = _mm256_loadu_si256((const __m256i*)(p + i * 32));
+        __m256i mixed = _mm256_xor_si256(data, _mm256_loadu_si256((const __m256i*)(key + i * 4)));
+        __m256i product = _mm256_mul_epu32(mixed, _mm256_srli_epi64(mixed, 32));
+        __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+        acc[i] = _mm256_add_epi64(acc[i], _mm256_add_epi64(product, swapped));
+    }
+}
+
+MEM_TARGET_AVX2
+static MEM_FORCE_INLINE void MemHashScramble_avx2(__m256i acc[2], const uint64_t* key)
+{
+    const __m256i prime = _mm256_set1_epi32((int)0x9e3779b1);
+
+    for (size_t i=0; i<2; i++)
+    {
+        __m256i a = _mm256_xor_si256(acc[i], _mm256_srli_epi64(acc[i], 47));
+        a = _mm256_xor_si256(a, _mm256_loadu_si256((const __m256i*)(key + i * 4)));
+
+        __m256i lo = _mm256_mul_epu32(a, prime);
+        __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+        acc[i] = _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+    }
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+uint64_t MemHash64_avx2(const void* ptr, size_t size, uint64_t seed)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (size <= 16)
+    {
+        return MemHashSmall(p, size, seed);
+    }
+    else if (size <= 256)
+    {
+        return MemHashMedium(p, size, seed);
+    }
+
+    __m256i acc[2];
+    for (size_t i=0; i<2; i++)
+    {
+        acc[i] = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(MemHashSecret + 24 + i * 4)), _mm256_set1_epi64x((long long)seed));
+    }
+
+    const uint8_t* end = p + size;
+
+    while (end - p > 1024)
+    {
+        for (size_t i=0; i<16; i++)
+        {
+            MemHashStripe_avx2(acc, p + i * 64, MemHashSecret + i);
+        }
+        MemHashScramble_avx2(acc, MemHashSecret + 16);
+        p += 1024;
+    }
+
+    for (size_t i=0; end - p > 64; i++)
+    {
+        MemHashStripe_avx2(acc, p, MemHashSecret + i);
+        p += 64;
+    }
+
+    MemHashStripe_avx2(acc, end - 64, MemHashSecret + 16);
+
+    uint64_t result[8];
+    for (size_t i=0; i<2; i++)
+    {
+        _mm256_storeu_si256((__m256i*)(result + i * 4), acc[i]);
+    }
+    return MemHashMerge(result, size, seed);
+}
+
+// returns mask with bit set for every byte that is different in first "size" bytes, size must be <= 32
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+static MEM_FORCE_INLINE uint32_t MemBatchDiff_avx2(const MemPair* pair)
+{
+    __m256i a = _mm256_loadu_si256((const __m256i*)pair->ptr1);
+    __m256i b = _mm256_loadu_si256((const __m256i*)pair->ptr2);
+    uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+    return MEM_BZHI32(mask, (uint32_t)pair->size);
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+void MemIsEqualBatch_avx2(const MemPair* pairs, size_t count, uint8_t* results)
+{
+    for (size_t i=0; i<count; i++)
+    {
+        const MemPair* pair = &pairs[i];
+        MemPrefetchPair(pairs, i + 8, count);
+
+        if (MemBatchCanLoad(pair, 32))
+        {
+            results[i] = MemBatchDiff_avx2(pair) == 0;
+        }
+        else
+        {
+            results[i] = MemIsEqual_avx2(pair->ptr1, pair->ptr2, pair->size);
+        }
+    }
+}
+
+MEM_DISABLE_ASAN
+MEM_TARGET_AVX2
+void MemCompareBatch_avx2(const MemPair* pairs, size_t count, int* results)
+{
+    for (size_t i=0; i<count; i++)
+    {
+        const MemPair* pair = &pairs[i];
+        MemPrefetchPair(pairs, i + 8, count);
+
+        if (MemBatchCanLoad(pair, 32))
+        {
+            // tzcnt returns 32 when all bytes are equal
+            uint32_t mask = MemBatchDiff_avx2(pair);
+            results[i] = MemBatchCompareAt(pair, MEM_TZCNT32(mask));
+        }
+        else
+        {
+            results[i] = MemCompare_avx2(pair->ptr1, pair->ptr2, pair->size);
+        }
+    }
+}
+
+MEM_TARGET_AVX2
+bool MemIsEqualConstTime_avx2(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    // all branches below depend only on size, never on contents of buffers
+
+    if (size < 16)
+    {
+        return MemConstTimeDiff(p1, p2, size) == 0;
+    }
+
+    if (size <= 32)
+    {
+        // two 16-byte loads, overlapping when size < 32
+        __m128i a0 = _mm_loadu_si128((const __m128i*)p1);
+        __m128i b0 = _mm_loadu_si128((const __m128i*)p2);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(p1 + size - 16));
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(p2 + size - 16));
+
+        __m128i r0 = _mm_or_si128(_mm_xor_si128(a0, b0), _mm_xor_si128(a1, b1));
+        return _mm_testz_si128(r0, r0);
+    }
+
+    // accumulate bits that are different in each 32-byte lane
+    __m256i r0 = _mm256_setzero_si256();
+    __m256i r1 = _mm256_setzero_si256();
+    __m256i r2 = _mm256_setzero_si256();
+    __m256i r3 = _mm256_setzero_si256();
+
+    // process 128-byte blocks as much as possible
+    while (size >= 128)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)p1 + 0);
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)p1 + 1);
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)p1 + 2);
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)p1 + 3);
+
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)p2 + 0);
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)p2 + 1);
+        __m256i b2 = _mm256_loadu_si256((const __m256i*)p2 + 2);
+        __m256i b3 = _mm256_loadu_si256((const __m256i*)p2 + 3);
+
+        r0 = _mm256_or_si256(r0, _mm256_xor_si256(a0, b0));
+        r1 = _mm256_or_si256(r1, _mm256_xor_si256(a1, b1));
+        r2 = _mm256_or_si256(r2, _mm256_xor_si256(a2, b2));
+        r3 = _mm256_or_si256(r3, _mm256_xor_si256(a3, b3));
+
+        size -= 128;
+        p1 += 128;
+        p2 += 128;
+    }
+
+    // then 32-byte blocks
+    while (size >= 32)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)p1);
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)p2);
+        r0 = _mm256_or_si256(r0, _mm256_xor_si256(a0, b0));
+
+        size -= 32;
+        p1 += 32;
+        p2 += 32;
+    }
+
+    // last 32 bytes overlap with already processed ones, original size was > 32
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + size - 32));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + size - 32));
+        r1 = _mm256_or_si256(r1, _mm256_xor_si256(a0, b0));
+    }
+
+    r0 = _mm256_or_si256(_mm256_or_si256(r0, r1), _mm256_or_si256(r2, r3));
+
+    // buffers are equal only if all accumulated bits are zero
+    return _mm256_testz_si256(r0, r0);
+}
+
+MEM_TARGET_AVX2
+MemPosition MemFindV_avx2(const MemSegment* segments, size_t count, uint8_t value)
+{
+    return MemFindSegments(segments, count, value, &MemFind_avx2);
+}
+
+MEM_TARGET_AVX2
+bool MemIsEqualV_avx2(const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2)
+{
+    return MemIsEqualSegments(segments1, count1, segments2, count2, &MemIsEqual_avx2);
+}
+
+MEM_TARGET_AVX512
+int MemCompare_avx512(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
+    size_t extra = size & 63;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        // do masked load
+        __m512i a = _mm512_maskz_loadu_epi8(mask, p1);
+        __m512i b = _mm512_maskz_loadu_epi8(mask, p2);
+
+        // check if any bytes are different
+        __mmask64 m = _mm512_cmpneq_epu8_mask(a, b);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if they are different, then find position of byte that is less than other value
+            int r1 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(a, b)));
+            int r2 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(b, a)));
+
+            // return signed difference which is comparison result
+            return r1 - r2;
+        }
+
+        size -= extra;
+        p1 += extra;
+        p2 += extra;
+    }
+
+    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
+    if (size & 64)
+    {
+        // 64 byte loads
+        __m512i a = _mm512_loadu_epi8(p1);
+        __m512i b = _mm512_loadu_epi8(p2);
+
+        // check if any bytes are different
+        __mmask64 m = _mm512_cmpneq_epu8_mask(a, b);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if they are different, then find position of byte that is less than other value
+            int r1 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(a, b)));
+            int r2 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(b, a)));
+
+            // return signed difference which is comparison result
+            return r1 - r2;
+        }
+
+        size -= 64;
+        p1 += 64;
+        p2 += 64;
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks
+    while (size)
+    {
+        __m512i a0 = _mm512_loadu_epi8(p1 + 0x00);
+        __m512i b0 = _mm512_loadu_epi8(p2 + 0x00);
+        __m512i a1 = _mm512_loadu_epi8(p1 + 0x40);
+        __m512i b1 = _mm512_loadu_epi8(p2 + 0x40);
+
+        // check if any bytes are different
+        __mmask64 m0 = _mm512_cmpneq_epu8_mask(a0, b0);
+        __mmask64 m1 = _mm512_cmpneq_epu8_mask(a1, b1);
+        if (!_kortestz_mask64_u8(m0, m1))
+        {
+            // if they are different, then find position of byte that is less than other value
+            int r10 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(a0, b0)));
+            int r20 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(b0, a0)));
+            int r11 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(a1, b1)));
+            int r21 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(b1, a1)));
+
+            // if low 64 bytes are the same, use indices for high 64 bytes
+            int r1 = (r10 == r20) ? r11 : r10;
+            int r2 = (r10 == r20) ? r21 : r20;
+
+            // return signed difference which is comparison result
+            return r1 - r2;
+        }
+
+        size -= 128;
+        p1 += 128;
+        p2 += 128;
+    }
+
+    // no differences found, inputs are equal
+    return 0;
+}
+
+MEM_TARGET_AVX512
+int MemCompareI_avx512(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
+    size_t extra = size & 63;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        // do masked load & convert to lowercase
+        __m512i a = MemToLower64(_mm512_maskz_loadu_epi8(mask, p1));
+        __m512i b = MemToLower64(_mm512_maskz_loadu_epi8(mask, p2));
+
+        // check if any bytes are different
+        __mmask64 m = _mm512_cmpneq_epu8_mask(a, b);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if they are different, then find position of byte that is less than other value
+            int r1 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(a, b)));
+            int r2 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(b, a)));
+
+            // return signed difference which is comparison result
+            return r1 - r2;
+        }
+
+        size -= extra;
+        p1 += extra;
+        p2 += extra;
+    }
+
+    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
+    if (size & 64)
+    {
+        // 64 byte loads & convert to lowercase
+        __m512i a = MemToLower64(_mm512_loadu_epi8(p1));
+        __m512i b = MemToLower64(_mm512_loadu_epi8(p2));
+
+        // check if any bytes are different
+        __mmask64 m = _mm512_cmpneq_epu8_mask(a, b);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if they are different, then find position of byte that is less than other value
+            int r1 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(a, b)));
+            int r2 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(b, a)));
+
+            // return signed difference which is comparison result
+            return r1 - r2;
+        }
+
+        size -= 64;
+        p1 += 64;
+        p2 += 64;
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks
+    while (size)
+    {
+        __m512i a0 = MemToLower64(_mm512_loadu_epi8(p1 + 0x00));
+        __m512i b0 = MemToLower64(_mm512_loadu_epi8(p2 + 0x00));
+        __m512i a1 = MemToLower64(_mm512_loadu_epi8(p1 + 0x40));
+        __m512i b1 = MemToLower64(_mm512_loadu_epi8(p2 + 0x40));
+
+        // check if any bytes are different
+        __mmask64 m0 = _mm512_cmpneq_epu8_mask(a0, b0);
+        __mmask64 m1 = _mm512_cmpneq_epu8_mask(a1, b1);
+        if (!_kortestz_mask64_u8(m0, m1))
+        {
+            // if they are different, then find position of byte that is less than other value
+            int r10 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(a0, b0)));
+            int r20 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(b0, a0)));
+            int r11 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(a1, b1)));
+            int r21 = (int)_tzcnt_u64(_cvtmask64_u64(_mm512_cmplt_epu8_mask(b1, a1)));
+
+            // if low 64 bytes are the same, use indices for high 64 bytes
+            int r1 = (r10 == r20) ? r11 : r10;
+            int r2 = (r10 == r20) ? r21 : r20;
+
+            // return signed difference which is comparison result
+            return r1 - r2;
+        }
+
+        size -= 128;
+        p1 += 128;
+        p2 += 128;
+    }
+
+    // no differences found, inputs are equal
+    return 0;
+}
+
+MEM_TARGET_AVX512
+bool MemIsEqual_avx512(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
+    size_t extra = size & 63;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        // do masked load & convert to lowercase
+        __m512i a = _mm512_maskz_loadu_epi8(mask, p1);
+        __m512i b = _mm512_maskz_loadu_epi8(mask, p2);
+
+        // check if any bytes are different
+        __mmask64 m = _mm512_cmpneq_epu8_mask(a, b);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // they are different
+            return false;
+        }
+
+        size -= extra;
+        p1 += extra;
+        p2 += extra;
+    }
+
+    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
+    if (size & 64)
+    {
+        // 64 byte loads
+        __m512i a = _mm512_loadu_epi8(p1);
+        __m512i b = _mm512_loadu_epi8(p2);
+
+        // check if any bytes are different
+        __mmask64 m = _mm512_cmpneq_epu8_mask(a, b);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // they are different
+            return false;
+        }
+
+        size -= 64;
+        p1 += 64;
+        p2 += 64;
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks
+    while (size)
+    {
+        __m512i a0 = _mm512_loadu_epi8(p1 + 0x00);
+        __m512i b0 = _mm512_loadu_epi8(p2 + 0x00);
+        __m512i a1 = _mm512_loadu_epi8(p1 + 0x40);
+        __m512i b1 = _mm512_loadu_epi8(p2 + 0x40);
+
+        // check if any bytes are different
+        __mmask64 m0 = _mm512_cmpneq_epu8_mask(a0, b0);
+        __mmask64 m1 = _mm512_cmpneq_epu8_mask(a1, b1);
+        if (!_kortestz_mask64_u8(m0, m1))
+        {
+            // they are different
+            return false;
+        }
+
+        size -= 128;
+        p1 += 128;
+        p2 += 128;
+    }
+
+    // no differences found, inputs are equal
+    return true;
+}
+
+MEM_TARGET_AVX512
+size_t MemFind_avx512(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const __m512i value64 = _mm512_set1_epi8((char)value);
+
+    size_t offset = 0;
+
+    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
+    size_t extra = size & 63;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        // do masked load, zeroing out upper bytes
+        __m512i a = _mm512_maskz_loadu_epi8(mask, p);
+
+        // check if any bytes matches input value, only low "extra" bytes
+        __mmask64 m = _mm512_mask_cmpeq_epu8_mask(mask, value64, a);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if it does, return index of lowest byte that matches
+            return (size_t)_tzcnt_u64(_cvtmask64_u64(m));
+        }
+
+        offset += extra;
+        size -= extra;
+        p += extra;
+    }
+
+    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
+    if (size & 64)
+    {
+        // 64 byte load
+        __m512i a = _mm512_loadu_epi8(p);
+
+        // check if any bytes matches input value
+        __mmask64 m = _mm512_cmpeq_epu8_mask(value64, a);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if it does, return index of lowest byte that matches
+            return offset + (size_t)_tzcnt_u64(_cvtmask64_u64(m));
+        }
+
+        offset += 64;
+        size -= 64;
+        p += 64;
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks
+    while (size)
+    {
+        __m512i a0 = _mm512_loadu_epi8(p + 0x00);
+        __m512i a1 = _mm512_loadu_epi8(p + 0x40);
+
+        // check if any bytes matches input value
+        __mmask64 m0 = _mm512_cmpeq_epu8_mask(value64, a0);
+        __mmask64 m1 = _mm512_cmpeq_epu8_mask(value64, a1);
+        if (!_kortestz_mask64_u8(m0, m1))
+        {
+            // if it does, get index of lowest byte that matches
+            size_t r0 = _tzcnt_u64(_cvtmask64_u64(m0));
+            size_t r1 = _tzcnt_u64(_cvtmask64_u64(m1));
+
+            // combine both indices to actual index across both comparisons
+            offset += r0;
+            offset += r0 == 64 ? r1 : 0;
+            return offset;
+        }
+
+        offset += 128;
+        size -= 128;
+        p += 128;
+    }
+
+    // no input value found
+    return offset;
+}
+
+MEM_TARGET_AVX512
+size_t MemFindNot_avx512(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const __m512i value64 = _mm512_set1_epi8((char)value);
+
+    size_t offset = 0;
+
+    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
+    size_t extra = size & 63;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        // do masked load, zeroing out upper bytes
+        __m512i a = _mm512_maskz_loadu_epi8(mask, p);
+
+        // check if any bytes are different, only low "extra" bytes
+        __mmask64 m = _mm512_mask_cmpneq_epu8_mask(mask, value64, a);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if they are, return index of lowest byte that does not match
+            return (size_t)_tzcnt_u64(_cvtmask64_u64(m));
+        }
+
+        offset += extra;
+        size -= extra;
+        p += extra;
+    }
+
+    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
+    if (size & 64)
+    {
+        // 64 byte load
+        __m512i a = _mm512_loadu_epi8(p);
+
+        // check if any bytes are different
+        __mmask64 m = _mm512_cmpneq_epu8_mask(value64, a);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if they are, return index of lowest byte that does not match
+            return offset + (size_t)_tzcnt_u64(_cvtmask64_u64(m));
+        }
+
+        offset += 64;
+        size -= 64;
+        p += 64;
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks
+    while (size)
+    {
+        __m512i a0 = _mm512_loadu_epi8(p + 0x00);
+        __m512i a1 = _mm512_loadu_epi8(p + 0x40);
+
+        // check if any bytes are different
+        __mmask64 m0 = _mm512_cmpneq_epu8_mask(value64, a0);
+        __mmask64 m1 = _mm512_cmpneq_epu8_mask(value64, a1);
+        if (!_kortestz_mask64_u8(m0, m1))
+        {
+            // if they are, get index of lowest byte that does not match
+            size_t r0 = _tzcnt_u64(_cvtmask64_u64(m0));
+            size_t r1 = _tzcnt_u64(_cvtmask64_u64(m1));
+
+            // combine both indices to actual index across both comparisons
+            offset += r0;
+            offset += r0 == 64 ? r1 : 0;
+            return offset;
+        }
+
+        offset += 128;
+        size -= 128;
+        p += 128;
+    }
+
+    // all bytes are same as input value
+    return offset;
+}
+
+MEM_TARGET_AVX512
+size_t MemFindLast_avx512(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const __m512i value64 = _mm512_set1_epi8((char)value);
+
+    // remember original size to return when input value is not found
+    const size_t total = size;
+
+    // first handle any non-multiple of 64 size at the end of buffer, so code later can deal with 64-byte multiple sizes
+    size_t extra = size & 63;
+    if (extra)
+    {
+        size -= extra;
+
+        //  mask to load "extra" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        // do masked load, zeroing out upper bytes
+        __m512i a = _mm512_maskz_loadu_epi8(mask, p + size);
+
+        // check if any bytes matches input value, only low "extra" bytes
+        __mmask64 m = _mm512_mask_cmpeq_epu8_mask(mask, value64, a);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if it does, return index of highest byte that matches
+            return size + MEM_BSR64(_cvtmask64_u64(m));
+        }
+    }
+
+    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
+    if (size & 64)
+    {
+        size -= 64;
+
+        // 64 byte load
+        __m512i a = _mm512_loadu_epi8(p + size);
+
+        // check if any bytes matches input value
+        __mmask64 m = _mm512_cmpeq_epu8_mask(value64, a);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if it does, return index of highest byte that matches
+            return size + MEM_BSR64(_cvtmask64_u64(m));
+        }
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks from the end
+    while (size)
+    {
+        size -= 128;
+
+        __m512i a0 = _mm512_loadu_epi8(p + size + 0x00);
+        __m512i a1 = _mm512_loadu_epi8(p + size + 0x40);
+
+        // check if any bytes matches input value
+        __mmask64 m0 = _mm512_cmpeq_epu8_mask(value64, a0);
+        __mmask64 m1 = _mm512_cmpeq_epu8_mask(value64, a1);
+        if (!_kortestz_mask64_u8(m0, m1))
+        {
+            // if it does, get index of highest byte that matches
+            uint64_t r0 = _cvtmask64_u64(m0);
+            uint64_t r1 = _cvtmask64_u64(m1);
+
+            // upper 64 bytes take priority
+            return size + (r1 ? 64 + MEM_BSR64(r1) : MEM_BSR64(r0));
+        }
+    }
+
+    // no input value found
+    return total;
+}
+
+MEM_TARGET_AVX512
+size_t MemFindLastNot_avx512(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const __m512i value64 = _mm512_set1_epi8((char)value);
+
+    // remember original size to return when all bytes are same as input value
+    const size_t total = size;
+
+    // first handle any non-multiple of 64 size at the end of buffer, so code later can deal with 64-byte multiple sizes
+    size_t extra = size & 63;
+    if (extra)
+    {
+        size -= extra;
+
+        //  mask to load "extra" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        // do masked load, zeroing out upper bytes
+        __m512i a = _mm512_maskz_loadu_epi8(mask, p + size);
+
+        // check if any bytes are different, only low "extra" bytes
+        __mmask64 m = _mm512_mask_cmpneq_epu8_mask(mask, value64, a);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if they are, return index of highest byte that does not match
+            return size + MEM_BSR64(_cvtmask64_u64(m));
+        }
+    }
+
+    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
+    if (size & 64)
+    {
+        size -= 64;
+
+        // 64 byte load
+        __m512i a = _mm512_loadu_epi8(p + size);
+
+        // check if any bytes are different
+        __mmask64 m = _mm512_cmpneq_epu8_mask(value64, a);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if they are, return index of highest byte that does not match
+            return size + MEM_BSR64(_cvtmask64_u64(m));
+        }
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks from the end
+    while (size)
+    {
+        size -= 128;
+
+        __m512i a0 = _mm512_loadu_epi8(p + size + 0x00);
+        __m512i a1 = _mm512_loadu_epi8(p + size + 0x40);
+
+        // check if any bytes are different
+        __mmask64 m0 = _mm512_cmpneq_epu8_mask(value64, a0);
+        __mmask64 m1 = _mm512_cmpneq_epu8_mask(value64, a1);
+        if (!_kortestz_mask64_u8(m0, m1))
+        {
+            // if they are, get index of highest byte that does not match
+            uint64_t r0 = _cvtmask64_u64(m0);
+            uint64_t r1 = _cvtmask64_u64(m1);
+
+            // upper 64 bytes take priority
+            return size + (r1 ? 64 + MEM_BSR64(r1) : MEM_BSR64(r0));
+        }
+    }
+
+    // all bytes are same as input value
+    return total;
+}
+
+MEM_TARGET_AVX512VBMI
+static MEM_FORCE_INLINE __mmask64 MemFindAnyMatch_avx512(__m512i a, __m512i c0, __m512i c1, __m512i c2, __m512i c3, int table)
+{
+    if (!table)
+    {
+        // check if any bytes matches any of input values
+        __mmask64 m0 = _mm512_cmpeq_epu8_mask(a, c0);
+        __mmask64 m1 = _mm512_cmpeq_epu8_mask(a, c1);
+        __mmask64 m2 = _mm512_cmpeq_epu8_mask(a, c2);
+        return _kor_mask64(_kor_mask64(m0, m1), m2);
+    }
+
+    // c0..c3 contain 256 byte table with 0x80 for bytes in set, 0x00 otherwise
+    // look up low 7 bits of byte in both 128-byte halves, then select by top bit of byte
+    __m512i r0 = _mm512_permutex2var_epi8(c0, a, c1);
+    __m512i r1 = _mm512_permutex2var_epi8(c2, a, c3);
+    __m512i r = _mm512_mask_blend_epi8(_mm512_movepi8_mask(a), r0, r1);
+    return _mm512_movepi8_mask(r);
+}
+
+MEM_TARGET_AVX512VBMI
+static MEM_FORCE_INLINE size_t MemFindAnyLoop_avx512(const uint8_t* p, size_t size, __m512i c0, __m512i c1, __m512i c2, __m512i c3, int table)
+{
+    size_t offset = 0;
+
+    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
+    size_t extra = size & 63;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        // do masked load, zeroing out upper bytes
+        __m512i a = _mm512_maskz_loadu_epi8(mask, p);
+
+        // check if any bytes matches input values, only low "extra" bytes
+        __mmask64 m = _kand_mask64(mask, MemFindAnyMatch_avx512(a, c0, c1, c2, c3, table));
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if it does, return index of lowest byte that matches
+            return (size_t)_tzcnt_u64(_cvtmask64_u64(m));
+        }
+
+        offset += extra;
+        size -= extra;
+        p += extra;
+    }
+
+    // now size is 64-byte multiple
+    while (size)
+    {
+        __m512i a = _mm512_loadu_epi8(p);
+
+        // check if any bytes matches input values
+        __mmask64 m = MemFindAnyMatch_avx512(a, c0, c1, c2, c3, table);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if it does, return index of lowest byte that matches
+            return offset + (size_t)_tzcnt_u64(_cvtmask64_u64(m));
+        }
+
+        offset += 64;
+        size -= 64;
+        p += 64;
+    }
+
+    // no input values found
+    return offset;
+}
+
+MEM_TARGET_AVX512VBMI
+size_t MemFindAny_avx512(const void* ptr, size_t size, const void* set, size_t setlen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* s = (const uint8_t*)set;
+
+    if (setlen == 0)
+    {
+        return size;
+    }
+    else if (setlen == 1)
+    {
+        return MemFind_avx512(ptr, size, s[0]);
+    }
+    else if (setlen <= 3)
+    {
+        // for 2 byte set third value is same as second one
+        __m512i v0 = _mm512_set1_epi8((char)s[0]);
+        __m512i v1 = _mm512_set1_epi8((char)s[1]);
+        __m512i v2 = _mm512_set1_epi8((char)s[setlen - 1]);
+        return MemFindAnyLoop_avx512(p, size, v0, v1, v2, v2, 0);
+    }
+
+    // 0x80 for every byte value that is in set
+    uint8_t bytes[256] = { 0 };
+    for (size_t i=0; i<setlen; i++)
+    {
+        bytes[s[i]] = 0x80;
+    }
+
+    __m512i t0 = _mm512_loadu_epi8(bytes + 0x00);
+    __m512i t1 = _mm512_loadu_epi8(bytes + 0x40);
+    __m512i t2 = _mm512_loadu_epi8(bytes + 0x80);
+    __m512i t3 = _mm512_loadu_epi8(bytes + 0xc0);
+    return MemFindAnyLoop_avx512(p, size, t0, t1, t2, t3, 1);
+}
+
+MEM_TARGET_AVX512
+static MEM_FORCE_INLINE size_t MemFindBytesCheck_avx512(const uint8_t* p, const uint8_t* n, size_t nlen, uint64_t mask)
+{
+    // first and last bytes are already matching for every bit set in mask, verify rest of the needle
+    while (mask)
+    {
+        size_t index = (size_t)_tzcnt_u64(mask);
+        if (MemIsEqual_avx512(p + index + 1, n + 1, nlen - 2))
+        {
+            return index;
+        }
+        mask &= mask - 1;
+    }
+    return 64;
+}
+
+MEM_TARGET_AVX512
+size_t MemFindBytes_avx512(const void* ptr, size_t size, const void* needle, size_t needlelen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* n = (const uint8_t*)needle;
+
+    if (needlelen == 0)
+    {
+        return 0;
+    }
+    else if (needlelen == 1)
+    {
+        return MemFind_avx512(ptr, size, n[0]);
+    }
+    else if (needlelen > size)
+    {
+        return size;
+    }
+
+    // offset of last needle byte, and amount of positions where needle can start
+    size_t last = needlelen - 1;
+    size_t count = size - last;
+
+    const __m512i first64 = _mm512_set1_epi8((char)n[0]);
+    const __m512i last64 = _mm512_set1_epi8((char)n[last]);
+
+    size_t offset = 0;
+
+    // first handle any non-multiple of 64 starting positions, so code later can deal with 64 position blocks
+    size_t extra = count & 63;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        // do masked loads for first and last needle bytes, zeroing out upper bytes
+        __m512i a0 = _mm512_maskz_loadu_epi8(mask, p);
+        __m512i a1 = _mm512_maskz_loadu_epi8(mask, p + last);
+
+        // check positions where both first and last needle bytes match, only low "extra" bytes
+        __mmask64 m = _mm512_mask_cmpeq_epu8_mask(_mm512_mask_cmpeq_epu8_mask(mask, first64, a0), last64, a1);
+
+        size_t index = MemFindBytesCheck_avx512(p, n, needlelen, _cvtmask64_u64(m));
+        if (index < 64)
+        {
+            return index;
+        }
+
+        offset += extra;
+    }
+
+    // process 64 starting positions at a time
+    while (offset < count)
+    {
+        __m512i a0 = _mm512_loadu_epi8(p + offset);
+        __m512i a1 = _mm512_loadu_epi8(p + offset + last);
+
+        // check positions where both first and last needle bytes match
+        __mmask64 m = _mm512_mask_cmpeq_epu8_mask(_mm512_cmpeq_epu8_mask(first64, a0), last64, a1);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            size_t index = MemFindBytesCheck_avx512(p + offset, n, needlelen, _cvtmask64_u64(m));
+            if (index < 64)
+            {
+                return offset + index;
+            }
+        }
+
+        offset += 64;
+    }
+
+    // needle not found
+    return size;
+}
+
+MEM_TARGET_AVX512
+size_t MemCount_avx512(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const __m512i value64 = _mm512_set1_epi8((char)value);
+
+    size_t result = 0;
+
+    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
+    size_t extra = size & 63;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        // do masked load, zeroing out upper bytes
+        __m512i a = _mm512_maskz_loadu_epi8(mask, p);
+
+        // count bytes matching input value, only low "extra" bytes
+        __mmask64 m = _mm512_mask_cmpeq_epu8_mask(mask, value64, a);
+        result += MEM_POPCNT64(_cvtmask64_u64(m));
+
+        size -= extra;
+        p += extra;
+    }
+
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i minus1 = _mm512_set1_epi8(-1);
+
+    // 64-bit counters in eight lanes
+    __m512i total = zero;
+
+    // now size is 64-byte multiple
+    while (size)
+    {
+        // every block adds at most 2 to byte lane counters, so they can accumulate 127 blocks before overflowing
+        size_t count = size / 128 < 127 ? size / 128 : 127;
+
+        __m512i sum0 = zero;
+        __m512i sum1 = zero;
+        for (size_t i=0; i<count; i++)
+        {
+            __m512i a0 = _mm512_loadu_epi8(p + 0x00);
+            __m512i a1 = _mm512_loadu_epi8(p + 0x40);
+
+            // increment byte lane counters only where input value matches
+            sum0 = _mm512_mask_sub_epi8(sum0, _mm512_cmpeq_epu8_mask(value64, a0), sum0, minus1);
+            sum1 = _mm512_mask_sub_epi8(sum1, _mm512_cmpeq_epu8_mask(value64, a1), sum1, minus1);
+
+            p += 128;
+        }
+        size -= count * 128;
+
+        if (count == 0) // size == 64
+        {
+            __m512i a0 = _mm512_loadu_epi8(p);
+            sum0 = _mm512_mask_sub_epi8(sum0, _mm512_cmpeq_epu8_mask(value64, a0), sum0, minus1);
+
+            p += 64;
+            size -= 64;
+        }
+
+        // horizontal sum of byte lane counters into 64-bit counters
+        total = _mm512_add_epi64(total, _mm512_sad_epu8(sum0, zero));
+        total = _mm512_add_epi64(total, _mm512_sad_epu8(sum1, zero));
+    }
+
+    // sum all 64-bit counters
+    uint64_t counters[8];
+    _mm512_storeu_si512(counters, total);
+    for (size_t i=0; i<8; i++)
+    {
+        result += (size_t)counters[i];
+    }
+
+    return result;
+}
+
+MEM_TARGET_AVX512
+size_t MemMismatch_avx512(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    size_t offset = 0;
+
+    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
+    size_t extra = size & 63;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        // do masked load, zeroing out upper bytes
+        __m512i a = _mm512_maskz_loadu_epi8(mask, p1);
+        __m512i b = _mm512_maskz_loadu_epi8(mask, p2);
+
+        // check if any bytes are different, only low "extra" bytes
+        __mmask64 m = _mm512_mask_cmpneq_epu8_mask(mask, a, b);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if they are, return index of lowest byte that is different
+            return (size_t)_tzcnt_u64(_cvtmask64_u64(m));
+        }
+
+        offset += extra;
+        size -= extra;
+        p1 += extra;
+        p2 += extra;
+    }
+
+    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
+    if (size & 64)
+    {
+        // 64 byte load
+        __m512i a = _mm512_loadu_epi8(p1);
+        __m512i b = _mm512_loadu_epi8(p2);
+
+        // check if any bytes are different
+        __mmask64 m = _mm512_cmpneq_epu8_mask(a, b);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if they are, return index of lowest byte that is different
+            return offset + (size_t)_tzcnt_u64(_cvtmask64_u64(m));
+        }
+
+        offset += 64;
+        size -= 64;
+        p1 += 64;
+        p2 += 64;
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks
+    while (size)
+    {
+        __m512i a0 = _mm512_loadu_epi8(p1 + 0x00);
+        __m512i b0 = _mm512_loadu_epi8(p2 + 0x00);
+        __m512i a1 = _mm512_loadu_epi8(p1 + 0x40);
+        __m512i b1 = _mm512_loadu_epi8(p2 + 0x40);
+
+        // check if any bytes are different
+        __mmask64 m0 = _mm512_cmpneq_epu8_mask(a0, b0);
+        __mmask64 m1 = _mm512_cmpneq_epu8_mask(a1, b1);
+        if (!_kortestz_mask64_u8(m0, m1))
+        {
+            // if they are, get index of lowest byte that is different
+            size_t r0 = _tzcnt_u64(_cvtmask64_u64(m0));
+            size_t r1 = _tzcnt_u64(_cvtmask64_u64(m1));
+
+            // combine both indices to actual index across both comparisons
+            offset += r0;
+            offset += r0 == 64 ? r1 : 0;
+            return offset;
+        }
+
+        offset += 128;
+        size -= 128;
+        p1 += 128;
+        p2 += 128;
+    }
+
+    // no differences found
+    return offset;
+}
+
+MEM_TARGET_AVX512
+static MEM_FORCE_INLINE void MemConvertCase_avx512(uint8_t* dst, const uint8_t* src, size_t size, uint8_t first)
+{
+    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
+    size_t extra = size & 63;
+    if (extra)
+    {
+        //  mask to load & store "extra" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        __m512i a = _mm512_maskz_loadu_epi8(mask, src);
+        _mm512_mask_storeu_epi8(dst, mask, MemConvertCase64(a, first));
+
+        size -= extra;
+        src += extra;
+        dst += extra;
+    }
+
+    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
+    if (size & 64)
+    {
+        __m512i a = _mm512_loadu_epi8(src);
+        _mm512_storeu_epi8(dst, MemConvertCase64(a, first));
+
+        size -= 64;
+        src += 64;
+        dst += 64;
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks
+    while (size)
+    {
+        __m512i a0 = _mm512_loadu_epi8(src + 0x00);
+        __m512i a1 = _mm512_loadu_epi8(src + 0x40);
+
+        _mm512_storeu_epi8(dst + 0x00, MemConvertCase64(a0, first));
+        _mm512_storeu_epi8(dst + 0x40, MemConvertCase64(a1, first));
+
+        size -= 128;
+        src += 128;
+        dst += 128;
+    }
+}
+
+MEM_TARGET_AVX512
+void MemToLower_avx512(void* dst, const void* src, size_t size)
+{
+    MemConvertCase_avx512((uint8_t*)dst, (const uint8_t*)src, size, 'A');
+}
+
+MEM_TARGET_AVX512
+void MemToUpper_avx512(void* dst, const void* src, size_t size)
+{
+    MemConvertCase_avx512((uint8_t*)dst, (const uint8_t*)src, size, 'a');
+}
+
+MEM_TARGET_AVX512
+size_t MemFindI_avx512(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    // letters are matched by setting 0x20 bit in input bytes, which maps uppercase letters to lowercase
+    const uint8_t fold = MemCaseBit1(value);
+    const __m512i fold64 = _mm512_set1_epi8((char)fold);
+    const __m512i value64 = _mm512_set1_epi8((char)(value | fold));
+
+    size_t offset = 0;
+
+    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
+    size_t extra = size & 63;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        // do masked load, zeroing out upper bytes
+        __m512i a = _mm512_maskz_loadu_epi8(mask, p);
+
+        // check if any bytes matches input value, only low "extra" bytes
+        __mmask64 m = _mm512_mask_cmpeq_epu8_mask(mask, value64, _mm512_or_si512(a, fold64));
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if it does, return index of lowest byte that matches
+            return (size_t)_tzcnt_u64(_cvtmask64_u64(m));
+        }
+
+        offset += extra;
+        size -= extra;
+        p += extra;
+    }
+
+    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
+    if (size & 64)
+    {
+        // 64 byte load
+        __m512i a = _mm512_loadu_epi8(p);
+
+        // check if any bytes matches input value
+        __mmask64 m = _mm512_cmpeq_epu8_mask(value64, _mm512_or_si512(a, fold64));
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if it does, return index of lowest byte that matches
+            return offset + (size_t)_tzcnt_u64(_cvtmask64_u64(m));
+        }
+
+        offset += 64;
+        size -= 64;
+        p += 64;
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks
+    while (size)
+    {
+        __m512i a0 = _mm512_loadu_epi8(p + 0x00);
+        __m512i a1 = _mm512_loadu_epi8(p + 0x40);
+
+        // check if any bytes matches input value
+        __mmask64 m0 = _mm512_cmpeq_epu8_mask(value64, _mm512_or_si512(a0, fold64));
+        __mmask64 m1 = _mm512_cmpeq_epu8_mask(value64, _mm512_or_si512(a1, fold64));
+        if (!_kortestz_mask64_u8(m0, m1))
+        {
+            // if it does, get index of lowest byte that matches
+            size_t r0 = _tzcnt_u64(_cvtmask64_u64(m0));
+            size_t r1 = _tzcnt_u64(_cvtmask64_u64(m1));
+
+            // combine both indices to actual index across both comparisons
+            offset += r0;
+            offset += r0 == 64 ? r1 : 0;
+            return offset;
+        }
+
+        offset += 128;
+        size -= 128;
+        p += 128;
+    }
+
+    // no input value found
+    return offset;
+}
+
+MEM_TARGET_AVX512
+static MEM_FORCE_INLINE size_t MemFindBytesICheck_avx512(const uint8_t* p, const uint8_t* n, size_t nlen, uint64_t mask)
+{
+    // first and last bytes are already matching for every bit set in mask, verify rest of the needle
+    while (mask)
+    {
+        size_t index = (size_t)_tzcnt_u64(mask);
+        if (MemCompareI_avx512(p + index + 1, n + 1, nlen - 2) == 0)
+        {
+            return index;
+        }
+        mask &= mask - 1;
+    }
+    return 64;
+}
+
+MEM_TARGET_AVX512
+size_t MemFindBytesI_avx512(const void* ptr, size_t size, const void* needle, size_t needlelen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* n = (const uint8_t*)needle;
+
+    if (needlelen == 0)
+    {
+        return 0;
+    }
+    else if (needlelen == 1)
+    {
+        return MemFindI_avx512(ptr, size, n[0]);
+    }
+    else if (needlelen > size)
+    {
+        return size;
+    }
+
+    // offset of last needle byte, and amount of positions where needle can start
+    size_t last = needlelen - 1;
+    size_t count = size - last;
+
+    // letters are matched by setting 0x20 bit in input bytes, which maps uppercase letters to lowercase
+    const uint8_t first_fold = MemCaseBit1(n[0]);
+    const uint8_t last_fold = MemCaseBit1(n[last]);
+
+    const __m512i first_fold64 = _mm512_set1_epi8((char)first_fold);
+    const __m512i last_fold64 = _mm512_set1_epi8((char)last_fold);
+    const __m512i first64 = _mm512_set1_epi8((char)(n[0] | first_fold));
+    const __m512i last64 = _mm512_set1_epi8((char)(n[last] | last_fold));
+
+    size_t offset = 0;
+
+    // first handle any non-multiple of 64 starting positions, so code later can deal with 64 position blocks
+    size_t extra = count & 63;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        // do masked loads for first and last needle bytes, zeroing out upper bytes
+        __m512i a0 = _mm512_maskz_loadu_epi8(mask, p);
+        __m512i a1 = _mm512_maskz_loadu_epi8(mask, p + last);
+
+        // check positions where both first and last needle bytes match, only low "extra" bytes
+        __mmask64 m = _mm512_mask_cmpeq_epu8_mask(_mm512_mask_cmpeq_epu8_mask(mask, first64, _mm512_or_si512(a0, first_fold64)), last64, _mm512_or_si512(a1, last_fold64));
+
+        size_t index = MemFindBytesICheck_avx512(p, n, needlelen, _cvtmask64_u64(m));
+        if (index < 64)
+        {
+            return index;
+        }
+
+        offset += extra;
+    }
+
+    // process 64 starting positions at a time
+    while (offset < count)
+    {
+        __m512i a0 = _mm512_loadu_epi8(p + offset);
+        __m512i a1 = _mm512_loadu_epi8(p + offset + last);
+
+        // check positions where both first and last needle bytes match
+        __mmask64 m = _mm512_mask_cmpeq_epu8_mask(_mm512_cmpeq_epu8_mask(first64, _mm512_or_si512(a0, first_fold64)), last64, _mm512_or_si512(a1, last_fold64));
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            size_t index = MemFindBytesICheck_avx512(p + offset, n, needlelen, _cvtmask64_u64(m));
+            if (index < 64)
+            {
+                return offset + index;
+            }
+        }
+
+        offset += 64;
+    }
+
+    // needle not found
+    return size;
+}
+
+MEM_TARGET_AVX512
+size_t MemFindInRange_avx512(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    if (lo > hi)
+    {
+        // empty range, no byte can be inside it
+        return size;
+    }
+
+    // byte is inside range when unsigned (x - lo) <= (hi - lo)
+    const uint8_t range = (uint8_t)(hi - lo);
+
+    const __m512i lo64 = _mm512_set1_epi8((char)lo);
+    const __m512i range64 = _mm512_set1_epi8((char)range);
+
+    size_t offset = 0;
+
+    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
+    size_t extra = size & 63;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        // do masked load, zeroing out upper bytes
+        __m512i a = _mm512_maskz_loadu_epi8(mask, p);
+
+        // check if any bytes are inside range, only low "extra" bytes
+        __mmask64 m = _mm512_mask_cmple_epu8_mask(mask, _mm512_sub_epi8(a, lo64), range64);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if they are, return index of lowest byte inside range
+            return (size_t)_tzcnt_u64(_cvtmask64_u64(m));
+        }
+
+        offset += extra;
+        size -= extra;
+        p += extra;
+    }
+
+    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
+    if (size & 64)
+    {
+        // 64 byte load
+        __m512i a = _mm512_loadu_epi8(p);
+
+        // check if any bytes are inside range
+        __mmask64 m = _mm512_cmple_epu8_mask(_mm512_sub_epi8(a, lo64), range64);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if they are, return index of lowest byte inside range
+            return offset + (size_t)_tzcnt_u64(_cvtmask64_u64(m));
+        }
+
+        offset += 64;
+        size -= 64;
+        p += 64;
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks
+    while (size)
+    {
+        __m512i a0 = _mm512_loadu_epi8(p + 0x00);
+        __m512i a1 = _mm512_loadu_epi8(p + 0x40);
+
+        // check if any bytes are inside range
+        __mmask64 m0 = _mm512_cmple_epu8_mask(_mm512_sub_epi8(a0, lo64), range64);
+        __mmask64 m1 = _mm512_cmple_epu8_mask(_mm512_sub_epi8(a1, lo64), range64);
+        if (!_kortestz_mask64_u8(m0, m1))
+        {
+            // if they are, get index of lowest byte inside range
+            size_t r0 = _tzcnt_u64(_cvtmask64_u64(m0));
+            size_t r1 = _tzcnt_u64(_cvtmask64_u64(m1));
+
+            // combine both indices to actual index across both comparisons
+            offset += r0;
+            offset += r0 == 64 ? r1 : 0;
+            return offset;
+        }
+
+        offset += 128;
+        size -= 128;
+        p += 128;
+    }
+
+    // no byte inside range found
+    return offset;
+}
+
+MEM_TARGET_AVX512
+size_t MemFindNotInRange_avx512(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    if (lo > hi)
+    {
+        // empty range, every byte is outside of it
+        return 0;
+    }
+
+    // byte is inside range when unsigned (x - lo) <= (hi - lo)
+    const uint8_t range = (uint8_t)(hi - lo);
+
+    const __m512i lo64 = _mm512_set1_epi8((char)lo);
+    const __m512i range64 = _mm512_set1_epi8((char)range);
+
+    size_t offset = 0;
+
+    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
+    size_t extra = size & 63;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        // do masked load, zeroing out upper bytes
+        __m512i a = _mm512_maskz_loadu_epi8(mask, p);
+
+        // check if any bytes are outside of range, only low "extra" bytes
+        __mmask64 m = _mm512_mask_cmpgt_epu8_mask(mask, _mm512_sub_epi8(a, lo64), range64);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if it does, return index of lowest byte outside of range
+            return (size_t)_tzcnt_u64(_cvtmask64_u64(m));
+        }
+
+        offset += extra;
+        size -= extra;
+        p += extra;
+    }
+
+    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
+    if (size & 64)
+    {
+        // 64 byte load
+        __m512i a = _mm512_loadu_epi8(p);
+
+        // check if any bytes are outside of range
+        __mmask64 m = _mm512_cmpgt_epu8_mask(_mm512_sub_epi8(a, lo64), range64);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            // if it does, return index of lowest byte outside of range
+            return offset + (size_t)_tzcnt_u64(_cvtmask64_u64(m));
+        }
+
+        offset += 64;
+        size -= 64;
+        p += 64;
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks
+    while (size)
+    {
+        __m512i a0 = _mm512_loadu_epi8(p + 0x00);
+        __m512i a1 = _mm512_loadu_epi8(p + 0x40);
+
+        // check if any bytes are outside of range
+        __mmask64 m0 = _mm512_cmpgt_epu8_mask(_mm512_sub_epi8(a0, lo64), range64);
+        __mmask64 m1 = _mm512_cmpgt_epu8_mask(_mm512_sub_epi8(a1, lo64), range64);
+        if (!_kortestz_mask64_u8(m0, m1))
+        {
+            // if it does, get index of lowest byte outside of range
+            size_t r0 = _tzcnt_u64(_cvtmask64_u64(m0));
+            size_t r1 = _tzcnt_u64(_cvtmask64_u64(m1));
+
+            // combine both indices to actual index across both comparisons
+            offset += r0;
+            offset += r0 == 64 ? r1 : 0;
+            return offset;
+        }
+
+        offset += 128;
+        size -= 128;
+        p += 128;
+    }
+
+    // no byte outside of range found
+    return offset;
+}
+
+MEM_TARGET_AVX512
+static MEM_FORCE_INLINE __m512i MemValidateUTF8Check_avx512(__m512i a, __m512i prev, __m512i byte1_high, __m512i byte1_low, __m512i byte2_high)
+{
+    const __m512i low4 = _mm512_set1_epi8(0x0f);
+
+    // input shifted by 1, 2 and 3 bytes, with last bytes of previous input shifted in
+    // last is last 16 bytes of previous input followed by first 48 bytes of current input
+    __m512i last = _mm512_permutex2var_epi64(prev, _mm512_setr_epi64(6, 7, 8, 9, 10, 11, 12, 13), a);
+    __m512i prev1 = _mm512_alignr_epi8(a, last, 15);
+    __m512i prev2 = _mm512_alignr_epi8(a, last, 14);
+    __m512i prev3 = _mm512_alignr_epi8(a, last, 13);
+
+    // look up error bits for both nibbles of previous byte, and high nibble of current byte
+    __m512i e0 = _mm512_shuffle_epi8(byte1_high, _mm512_and_si512(_mm512_srli_epi16(prev1, 4), low4));
+    __m512i e1 = _mm512_shuffle_epi8(byte1_low, _mm512_and_si512(prev1, low4));
+    __m512i e2 = _mm512_shuffle_epi8(byte2_high, _mm512_and_si512(_mm512_srli_epi16(a, 4), low4));
+    __m512i special = _mm512_and_si512(_mm512_and_si512(e0, e1), e2);
+
+    // set top bit where byte must be 3rd or 4th byte of sequence, these are reported as two continuations in lookup
+    __m512i third = _mm512_subs_epu8(prev2, _mm512_set1_epi8((char)(0xe0 - 0x80)));
+    __m512i fourth = _mm512_subs_epu8(prev3, _mm512_set1_epi8((char)(0xf0 - 0x80)));
+    __m512i must23 = _mm512_and_si512(_mm512_or_si512(third, fourth), _mm512_set1_epi8((char)0x80));
+
+    // non-zero lanes are errors
+    return _mm512_xor_si512(must23, special);
+}
+
+MEM_TARGET_AVX512
+size_t MemValidateUTF8_avx512(const void* ptr, size_t size)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    // skip all leading ASCII bytes
+    size_t offset = MemFindInRange_avx512(p, size, 0x80, 0xff);
+    size -= offset;
+    p += offset;
+
+    // tables are broadcast to all four 128-bit lanes, zero mask variant avoids undefined source operand
+    const __m512i byte1_high = _mm512_maskz_broadcast_i32x4(0xffff, _mm_loadu_si128((const __m128i*)MemUTF8Byte1High));
+    const __m512i byte1_low = _mm512_maskz_broadcast_i32x4(0xffff, _mm_loadu_si128((const __m128i*)MemUTF8Byte1Low));
+    const __m512i byte2_high = _mm512_maskz_broadcast_i32x4(0xffff, _mm_loadu_si128((const __m128i*)MemUTF8Byte2High));
+    const __m512i incomplete_max = _mm512_loadu_epi8(MemUTF8Incomplete);
+
+    // bytes before current block are ASCII or complete sequences
+    __m512i prev = _mm512_setzero_si512();
+    __m512i incomplete = _mm512_setzero_si512();
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        __m512i a = _mm512_loadu_epi8(p);
+
+        __m512i error;
+        __mmask64 ascii = _mm512_movepi8_mask(a);
+        if (_kortestz_mask64_u8(ascii, ascii))
+        {
+            // all bytes are ASCII, only error can be sequence from previous block that did not finish
+            error = incomplete;
+        }
+        else
+        {
+            error = MemValidateUTF8Check_avx512(a, prev, byte1_high, byte1_low, byte2_high);
+
+            // remember if block ends with sequence that must continue in next block
+            incomplete = _mm512_subs_epu8(a, incomplete_max);
+        }
+
+        __mmask64 m = _mm512_test_epi8_mask(error, error);
+        if (!_kortestz_mask64_u8(m, m))
+        {
+            break;
+        }
+
+        prev = a;
+        offset += 64;
+        size -= 64;
+        p += 64;
+    }
+
+    if (size < 64)
+    {
+        // do masked load of last block, zeroing out upper bytes
+        // zero bytes are ASCII, so sequence that does not finish before end of buffer is reported as error
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)size));
+        __m512i a = _mm512_maskz_loadu_epi8(mask, p);
+
+        __m512i error = MemValidateUTF8Check_avx512(a, prev, byte1_high, byte1_low, byte2_high);
+        __mmask64 m = _mm512_test_epi8_mask(error, error);
+        if (_kortestz_mask64_u8(m, m))
+        {
+            return offset + size;
+        }
+    }
+
+    // validate remaining bytes with scalar code, this also finds exact position of error if code above found one
+    // start from last sequence before current position, because it may continue into current block
+    size_t back = MemUTF8Back(p, offset);
+    return offset - back + MemValidateUTF8_generic(p - back, size + back);
+}
+
+MEM_TARGET_AVX512VBMI
+static MEM_FORCE_INLINE void MemClassifyLoop_avx512(const uint8_t* p, size_t size, __m512i c0, __m512i c1, __m512i c2, __m512i c3, int table, uint64_t* masks)
+{
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        __m512i a = _mm512_loadu_epi8(p);
+
+        // one bit for every byte in set
+        *masks++ = _cvtmask64_u64(MemFindAnyMatch_avx512(a, c0, c1, c2, c3, table));
+
+        size -= 64;
+        p += 64;
+    }
+
+    if (size) // 0 < size < 64
+    {
+        //  mask to load "size" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)size));
+
+        // do masked load, zeroing out upper bytes
+        __m512i a = _mm512_maskz_loadu_epi8(mask, p);
+
+        // one bit for every byte in set, only low "size" bytes
+        *masks = _cvtmask64_u64(_kand_mask64(mask, MemFindAnyMatch_avx512(a, c0, c1, c2, c3, table)));
+    }
+}
+
+MEM_TARGET_AVX512VBMI
+void MemClassify_avx512(const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* s = (const uint8_t*)set;
+
+    if (setlen == 0)
+    {
+        MemClassify_generic(ptr, size, set, setlen, masks);
+        return;
+    }
+    else if (setlen <= 3)
+    {
+        // for smaller sets some values are repeated
+        __m512i v0 = _mm512_set1_epi8((char)s[0]);
+        __m512i v1 = _mm512_set1_epi8((char)s[setlen / 2]);
+        __m512i v2 = _mm512_set1_epi8((char)s[setlen - 1]);
+        MemClassifyLoop_avx512(p, size, v0, v1, v2, v2, 0, masks);
+        return;
+    }
+
+    // 0x80 for every byte value that is in set
+    uint8_t bytes[256] = { 0 };
+    for (size_t i=0; i<setlen; i++)
+    {
+        bytes[s[i]] = 0x80;
+    }
+
+    __m512i t0 = _mm512_loadu_epi8(bytes + 0x00);
+    __m512i t1 = _mm512_loadu_epi8(bytes + 0x40);
+    __m512i t2 = _mm512_loadu_epi8(bytes + 0x80);
+    __m512i t3 = _mm512_loadu_epi8(bytes + 0xc0);
+    MemClassifyLoop_avx512(p, size, t0, t1, t2, t3, 1, masks);
+}
+
+// returns bit mask of elements that match input value (or do not match if "invert" is set), only elements in "mask" are compared
+MEM_TARGET_AVX512
+static MEM_FORCE_INLINE uint64_t MemFindWideMatch_avx512(__mmask64 mask, __m512i a, __m512i value64, size_t width, int invert)
+{
+    if (width == 2)
+    {
+        __mmask32 k = _cvtu32_mask32((uint32_t)_cvtmask64_u64(mask));
+        return _cvtmask32_u32(invert ? _mm512_mask_cmpneq_epu16_mask(k, a, value64) : _mm512_mask_cmpeq_epu16_mask(k, a, value64));
+    }
+    else if (width == 4)
+    {
+        __mmask16 k = (__mmask16)_cvtmask64_u64(mask);
+        return (uint16_t)(invert ? _mm512_mask_cmpneq_epu32_mask(k, a, value64) : _mm512_mask_cmpeq_epu32_mask(k, a, value64));
+    }
+    else
+    {
+        __mmask8 k = (__mmask8)_cvtmask64_u64(mask);
+        return (uint8_t)(invert ? _mm512_mask_cmpneq_epu64_mask(k, a, value64) : _mm512_mask_cmpeq_epu64_mask(k, a, value64));
+    }
+}
+
+// count is number of elements, returns element index
+MEM_TARGET_AVX512
+static MEM_FORCE_INLINE size_t MemFindWide_avx512(const uint8_t* p, size_t count, __m512i value64, size_t width, int invert)
+{
+    // amount of elements in one 64-byte register
+    const size_t lanes = 64 / width;
+    const __mmask64 all = _cvtu64_mask64(~0ULL);
+
+    size_t offset = 0;
+
+    // first handle any non-multiple of 64 byte size, so code later can deal with 64-byte multiple sizes
+    size_t extra = count & (lanes - 1);
+    if (extra)
+    {
+        //  masks to load "extra" amount of elements, and to compare only them
+        __mmask64 bytes = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)(extra * width)));
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        // do masked load, zeroing out upper bytes
+        __m512i a = _mm512_maskz_loadu_epi8(bytes, p);
+
+        // check if any element matches input value, only low "extra" elements
+        uint64_t m = MemFindWideMatch_avx512(mask, a, value64, width, invert);
+        if (m)
+        {
+            // if it does, return index of lowest element that matches
+            return (size_t)_tzcnt_u64(m);
+        }
+
+        offset += extra;
+        count -= extra;
+        p += extra * width;
+    }
+
+    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
+    if (count & lanes)
+    {
+        // 64 byte load
+        __m512i a = _mm512_loadu_epi8(p);
+
+        // check if any element matches input value
+        uint64_t m = MemFindWideMatch_avx512(all, a, value64, width, invert);
+        if (m)
+        {
+            // if it does, return index of lowest element that matches
+            return offset + (size_t)_tzcnt_u64(m);
+        }
+
+        offset += lanes;
+        count -= lanes;
+        p += 64;
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks
+    while (count)
+    {
+        __m512i a0 = _mm512_loadu_epi8(p + 0x00);
+        __m512i a1 = _mm512_loadu_epi8(p + 0x40);
+
+        // check if any element matches input value
+        uint64_t m0 = MemFindWideMatch_avx512(all, a0, value64, width, invert);
+        uint64_t m1 = MemFindWideMatch_avx512(all, a1, value64, width, invert);
+        if (m0 | m1)
+        {
+            // if it does, return index of lowest element that matches
+            return offset + (m0 ? (size_t)_tzcnt_u64(m0) : lanes + (size_t)_tzcnt_u64(m1));
+        }
+
+        offset += 2 * lanes;
+        count -= 2 * lanes;
+        p += 128;
+    }
+
+    // no matching element found
+    return offset;
+}
+
+MEM_TARGET_AVX512
+size_t MemFind16_avx512(const void* ptr, size_t count, uint16_t value)
+{
+    return MemFindWide_avx512((const uint8_t*)ptr, count, _mm512_set1_epi16((short)value), sizeof(value), 0);
+}
+
+MEM_TARGET_AVX512
+size_t MemFind32_avx512(const void* ptr, size_t count, uint32_t value)
+{
+    return MemFindWide_avx512((const uint8_t*)ptr, count, _mm512_set1_epi32((int)value), sizeof(value), 0);
+}
+
+MEM_TARGET_AVX512
+size_t MemFind64_avx512(const void* ptr, size_t count, uint64_t value)
+{
+    return MemFindWide_avx512((const uint8_t*)ptr, count, _mm512_set1_epi64((long long)value), sizeof(value), 0);
+}
+
+MEM_TARGET_AVX512
+size_t MemFindNot16_avx512(const void* ptr, size_t count, uint16_t value)
+{
+    return MemFindWide_avx512((const uint8_t*)ptr, count, _mm512_set1_epi16((short)value), sizeof(value), 1);
+}
+
+MEM_TARGET_AVX512
+size_t MemFindNot32_avx512(const void* ptr, size_t count, uint32_t value)
+{
+    return MemFindWide_avx512((const uint8_t*)ptr, count, _mm512_set1_epi32((int)value), sizeof(value), 1);
+}
+
+MEM_TARGET_AVX512
+size_t MemFindNot64_avx512(const void* ptr, size_t count, uint64_t value)
+{
+    return MemFindWide_avx512((const uint8_t*)ptr, count, _mm512_set1_epi64((long long)value), sizeof(value), 1);
+}
+
+MEM_TARGET_AVX512
+size_t MemLowerBound32_avx512(const void* ptr, size_t count, uint32_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (count < 32)
+    {
+        return MemLowerBound32_generic(ptr, count, value);
+    }
+
+    // binary search down to 32 elements, which are compared all at once
+    size_t start = MemLowerBoundWindow(p, count, value, sizeof(value), 32);
+    p += start * sizeof(value);
+
+    const __m512i value64 = _mm512_set1_epi32((int)value);
+
+    __m512i a0 = _mm512_loadu_epi8(p + 0x00);
+    __m512i a1 = _mm512_loadu_epi8(p + 0x40);
+
+    // one bit for every element less than input value
+    uint64_t m0 = _mm512_cmplt_epu32_mask(a0, value64);
+    uint64_t m1 = _mm512_cmplt_epu32_mask(a1, value64);
+
+    return start + MEM_POPCNT64(m0 | (m1 << 16));
+}
+
+MEM_TARGET_AVX512
+size_t MemLowerBound64_avx512(const void* ptr, size_t count, uint64_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (count < 16)
+    {
+        return MemLowerBound64_generic(ptr, count, value);
+    }
+
+    // binary search down to 16 elements, which are compared all at once
+    size_t start = MemLowerBoundWindow(p, count, value, sizeof(value), 16);
+    p += start * sizeof(value);
+
+    const __m512i value64 = _mm512_set1_epi64((long long)value);
+
+    __m512i a0 = _mm512_loadu_epi8(p + 0x00);
+    __m512i a1 = _mm512_loadu_epi8(p + 0x40);
+
+    // one bit for every element less than input value
+    uint64_t m0 = _mm512_cmplt_epu64_mask(a0, value64);
+    uint64_t m1 = _mm512_cmplt_epu64_mask(a1, value64);
+
+    return start + MEM_POPCNT64(m0 | (m1 << 8));
+}
+
+// translates 64 bytes with 256-byte table in 4 registers
+MEM_TARGET_AVX512VBMI
+static MEM_FORCE_INLINE __m512i MemTranslateLookup_avx512(__m512i a, __m512i t0, __m512i t1, __m512i t2, __m512i t3)
+{
+    // lookup in low and high 128 bytes of table with low 7 bits of input, and select result by top bit
+    __m512i lo = _mm512_permutex2var_epi8(t0, a, t1);
+    __m512i hi = _mm512_permutex2var_epi8(t2, a, t3);
+    return _mm512_mask_blend_epi8(_mm512_movepi8_mask(a), lo, hi);
+}
+
+MEM_TARGET_AVX512VBMI
+void MemTranslate_avx512(void* dst, const void* src, size_t size, const uint8_t table[256])
+{
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+
+    __m512i t0 = _mm512_loadu_epi8(table + 0x00);
+    __m512i t1 = _mm512_loadu_epi8(table + 0x40);
+    __m512i t2 = _mm512_loadu_epi8(table + 0x80);
+    __m512i t3 = _mm512_loadu_epi8(table + 0xc0);
+
+    // first handle any non-multiple of 64 size, so code later can deal with 64-byte multiple sizes
+    size_t extra = size & 63;
+    if (extra)
+    {
+        //  mask to load & store "extra" amount of bytes
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)extra));
+
+        __m512i a = _mm512_maskz_loadu_epi8(mask, s);
+        _mm512_mask_storeu_epi8(d, mask, MemTranslateLookup_avx512(a, t0, t1, t2, t3));
+
+        size -= extra;
+        s += extra;
+        d += extra;
+    }
+
+    // now size is multiple of 64 bytes, handle case when it is not 128-byte multiple
+    if (size & 64)
+    {
+        __m512i a = _mm512_loadu_epi8(s);
+        _mm512_storeu_epi8(d, MemTranslateLookup_avx512(a, t0, t1, t2, t3));
+
+        size -= 64;
+        s += 64;
+        d += 64;
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks
+    while (size)
+    {
+        __m512i a0 = _mm512_loadu_epi8(s + 0x00);
+        __m512i a1 = _mm512_loadu_epi8(s + 0x40);
+
+        _mm512_storeu_epi8(d + 0x00, MemTranslateLookup_avx512(a0, t0, t1, t2, t3));
+        _mm512_storeu_epi8(d + 0x40, MemTranslateLookup_avx512(a1, t0, t1, t2, t3));
+
+        size -= 128;
+        s += 128;
+        d += 128;
+    }
+}
+
+// g++ warns about uninitialized variable inside unmasked _mm512_mul_epu32 and 64-bit shift intrinsics
+// so masked versions with all lanes enabled are used here, they compile to the same instructions
+
+MEM_TARGET_AVX512
+static MEM_FORCE_INLINE __m512i MemHashStripe_avx512(__m512i acc, const uint8_t* p, const uint64_t* key)
+{
+    const __mmask8 all = 0xff;
+
+    __m512i data = _mm512_loadu_si512(p);
+    __m512i mixed = _mm512_xor_si512(data, _mm512_loadu_si512(key));
+    __m512i product = _mm512_maskz_mul_epu32(all, mixed, _mm512_maskz_srli_epi64(all, mixed, 32));
+    __m512i swapped = _mm512_alignr_epi8(data, data, 8);
+    return _mm512_add_epi64(acc, _mm512_add_epi64(product, swapped));
+}
+
+MEM_TARGET_AVX512
+static MEM_FORCE_INLINE __m512i MemHashScramble_avx512(__m512i acc, const uint64_t* key)
+{
+    const __mmask8 all = 0xff;
+    const __m512i prime = _mm512_set1_epi64(0x9e3779b1);
+    const __m512i prime_odd = _mm512_set1_epi64((long long)0x9e3779b100000000);
+
+    // acc ^ (acc >> 47) ^ key
+    __m512i a = _mm512_ternarylogic_epi64(acc, _mm512_maskz_srli_epi64(all, acc, 47), _mm512_loadu_si512(key), 0x96);
+
+    // 64x32 bit multiply, low 32 bits of high half product are calculated with 32-bit multiply in odd lanes
+    __m512i lo = _mm512_maskz_mul_epu32(all, a, prime);
+    __m512i hi = _mm512_mullo_epi32(a, prime_odd);
+    return _mm512_add_epi64(lo, hi);
+}
+
+MEM_TARGET_AVX512
+uint64_t MemHash64_avx512(const void* ptr, size_t size, uint64_t seed)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (size <= 16)
+    {
+        // masked load does not fault on bytes past the end of buffer, no need to check page boundary
+        __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)size));
+        uint64_t bytes[8];
+        _mm512_storeu_si512(bytes, _mm512_maskz_loadu_epi8(mask, p));
+        return MemHashSmallMix(bytes[0], bytes[1], size, seed);
+    }
+    else if (size <= 256)
+    {
+        return MemHashMedium(p, size, seed);
+    }
+
+    __m512i acc = _mm512_add_epi64(_mm512_loadu_si512(MemHashSecret + 24), _mm512_set1_epi64((long long)seed));
+
+    const uint8_t* end = p + size;
+
+    while (end - p > 1024)
+    {
+        for (size_t i=0; i<16; i++)
+        {
+            acc = MemHashStripe_avx512(acc, p + i * 64, MemHashSecret + i);
+        }
+        acc = MemHashScramble_avx512(acc, MemHashSecret + 16);
+        p += 1024;
+    }
+
+    for (size_t i=0; end - p > 64; i++)
+    {
+        acc = MemHashStripe_avx512(acc, p, MemHashSecret + i);
+        p += 64;
+    }
+
+    acc = MemHashStripe_avx512(acc, end - 64, MemHashSecret + 16);
+
+    uint64_t result[8];
+    _mm512_storeu_si512(result, acc);
+    return MemHashMerge(result, size, seed);
+}
+
+// returns mask with bit set for every byte that is different, size must be <= 64
+MEM_TARGET_AVX512
+static MEM_FORCE_INLINE uint64_t MemBatchDiff_avx512(const MemPair* pair)
+{
+    // masked loads do not fault on bytes past the end of buffer, no need to check page boundary
+    __mmask64 mask = _cvtu64_mask64(_bzhi_u64(~0ULL, (uint32_t)pair->size));
+    __m512i a = _mm512_maskz_loadu_epi8(mask, pair->ptr1);
+    __m512i b = _mm512_maskz_loadu_epi8(mask, pair->ptr2);
+    return _cvtmask64_u64(_mm512_cmpneq_epu8_mask(a, b));
+}
+
+MEM_TARGET_AVX512
+void MemIsEqualBatch_avx512(const MemPair* pairs, size_t count, uint8_t* results)
+{
+    for (size_t i=0; i<count; i++)
+    {
+        const MemPair* pair = &pairs[i];
+        MemPrefetchPair(pairs, i + 8, count);
+
+        if (pair->size <= 64)
+        {
+            results[i] = MemBatchDiff_avx512(pair) == 0;
+        }
+        else
+        {
+            results[i] = MemIsEqual_avx512(pair->ptr1, pair->ptr2, pair->size);
+        }
+    }
+}
+
+MEM_TARGET_AVX512
+void MemCompareBatch_avx512(const MemPair* pairs, size_t count, int* results)
+{
+    for (size_t i=0; i<count; i++)
+    {
+        const MemPair* pair = &pairs[i];
+        MemPrefetchPair(pairs, i + 8, count);
+
+        if (pair->size - 1 < 64)
+        {
+            // tzcnt returns 64 when all bytes are equal
+            uint64_t mask = MemBatchDiff_avx512(pair);
+            results[i] = MemBatchCompareAt(pair, _tzcnt_u64(mask));
+        }
+        else
+        {
+            results[i] = MemCompare_avx512(pair->ptr1, pair->ptr2, pair->size);
+        }
+    }
+}
+
+MEM_TARGET_AVX512
+bool MemIsEqualConstTime_avx512(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    // all branches below depend only on size, never on contents of buffers
+
+    // accumulate bits that are different in each 64-byte lane
+    __m512i r0 = _mm512_setzero_si512();
+    __m512i r1 = _mm512_setzero_si512();
+    __m512i r2 = _mm512_setzero_si512();
+    __m512i r3 = _mm512_setzero_si512();
+
+    // process 256-byte blocks as much as possible
+    while (size >= 256)
+    {
+        __m512i a0 = _mm512_loadu_si512(p1 + 0 * 64);
+        __m512i a1 = _mm512_loadu_si512(p1 + 1 * 64);
+        __m512i a2 = _mm512_loadu_si512(p1 + 2 * 64);
+        __m512i a3 = _mm512_loadu_si512(p1 + 3 * 64);
+
+        __m512i b0 = _mm512_loadu_si512(p2 + 0 * 64);
+        __m512i b1 = _mm512_loadu_si512(p2 + 1 * 64);
+        __m512i b2 = _mm512_loadu_si512(p2 + 2 * 64);
+        __m512i b3 = _mm512_loadu_si512(p2 + 3 * 64);
+
+        // r |= a ^ b
+        r0 = _mm512_ternarylogic_epi64(r0, a0, b0, 0xf6);
+        r1 = _mm512_ternarylogic_epi64(r1, a1, b1, 0xf6);
+        r2 = _mm512_ternarylogic_epi64(r2, a2, b2, 0xf6);
+        r3 = _mm512_ternarylogic_epi64(r3, a3, b3, 0xf6);
+
+        size -= 256;
+        p1 += 256;
+        p2 += 256;
+    }
+
+    // then 64-byte blocks
+    while (size >= 64)
+    {
+        __m512i a0 = _mm512_loadu_si512(p1);
+        __m512i b0 = _mm512_loadu_si512(p2);
+        r0 = _mm512_ternarylogic_epi64(r0, a0, b0, 0xf6);
+
+        size -= 64;
+        p1 += 64;
+        p2 += 64;
+    }
+
+    // masked load of remaining bytes, masked out bytes are loaded as zero in both
+    {
+        __mmask64 mask = _bzhi_u64(~0ULL, (uint32_t)size);
+        __m512i a0 = _mm512_maskz_loadu_epi8(mask, p1);
+        __m512i b0 = _mm512_maskz_loadu_epi8(mask, p2);
+        r1 = _mm512_ternarylogic_epi64(r1, a0, b0, 0xf6);
+    }
+
+    r0 = _mm512_ternarylogic_epi64(r0, r1, r2, 0xfe);
+    r0 = _mm512_or_si512(r0, r3);
+
+    // buffers are equal only if all accumulated bits are zero
+    return _mm512_test_epi64_mask(r0, r0) == 0;
+}
+
+MEM_TARGET_AVX512
+MemPosition MemFindV_avx512(const MemSegment* segments, size_t count, uint8_t value)
+{
+    return MemFindSegments(segments, count, value, &MemFind_avx512);
+}
+
+MEM_TARGET_AVX512
+bool MemIsEqualV_avx512(const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2)
+{
+    return MemIsEqualSegments(segments1, count1, segments2, count2, &MemIsEqual_avx512);
+}
+
+// avx10 kernels use EVEX instructions only on 256-bit vectors, they work on CPUs with AVX10/256 that do not support
+// 512-bit vectors, and on AVX-512 CPUs with AVX512VL where 512-bit instructions would lower clock frequency
+// tails are processed with masked loads, they never access bytes outside of buffers, so no page crossing checks are needed
+
+MEM_TARGET_AVX10
+int MemCompare_avx10(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    // first handle any non-multiple of 32 size, so code later can deal with 32-byte multiple sizes
+    size_t extra = size & 31;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask32 mask = _cvtu32_mask32(_bzhi_u32(~0U, (uint32_t)extra));
+
+        // do masked load, zeroing out upper bytes
+        __m256i a = _mm256_maskz_loadu_epi8(mask, p1);
+        __m256i b = _mm256_maskz_loadu_epi8(mask, p2);
+
+        // check if any bytes are different
+        __mmask32 m = _mm256_cmpneq_epu8_mask(a, b);
+        if (!_kortestz_mask32_u8(m, m))
+        {
+            // if they are, return comparison result of first byte that is different
+            size_t index = _tzcnt_u32(_cvtmask32_u32(m));
+            return p1[index] - p2[index];
+        }
+
+        size -= extra;
+        p1 += extra;
+        p2 += extra;
+    }
+
+    // now size is multiple of 32 bytes, process 32-byte blocks until it is 128-byte multiple
+    while (size & 96)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)p1);
+        __m256i b = _mm256_loadu_si256((const __m256i*)p2);
+
+        // check if any bytes are different
+        __mmask32 m = _mm256_cmpneq_epu8_mask(a, b);
+        if (!_kortestz_mask32_u8(m, m))
+        {
+            // if they are, return comparison result of first byte that is different
+            size_t index = _tzcnt_u32(_cvtmask32_u32(m));
+            return p1[index] - p2[index];
+        }
+
+        size -= 32;
+        p1 += 32;
+        p2 += 32;
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks
+    while (size)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + 0x00));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + 0x20));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p1 + 0x40));
+        __m256i b2 = _mm256_loadu_si256((const __m256i*)(p2 + 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p1 + 0x60));
+        __m256i b3 = _mm256_loadu_si256((const __m256i*)(p2 + 0x60));
+
+        // check if any bytes are different
+        __mmask32 m0 = _mm256_cmpneq_epu8_mask(a0, b0);
+        __mmask32 m1 = _mm256_cmpneq_epu8_mask(a1, b1);
+        __mmask32 m2 = _mm256_cmpneq_epu8_mask(a2, b2);
+        __mmask32 m3 = _mm256_cmpneq_epu8_mask(a3, b3);
+        if (!_kortestz_mask32_u8(_kor_mask32(m0, m1), _kor_mask32(m2, m3)))
+        {
+            // combine masks
+            uint64_t m01 = _cvtmask32_u32(m0) | ((uint64_t)_cvtmask32_u32(m1) << 32);
+            uint64_t m23 = _cvtmask32_u32(m2) | ((uint64_t)_cvtmask32_u32(m3) << 32);
+
+            // get index of first byte that is different, upper 64 bytes are used only if lower are same
+            size_t index = m01 ? _tzcnt_u64(m01) : 64 + _tzcnt_u64(m23);
+            return p1[index] - p2[index];
+        }
+
+        size -= 128;
+        p1 += 128;
+        p2 += 128;
+    }
+
+    // no differences found, inputs are equal
+    return 0;
+}
+
+MEM_TARGET_AVX10
+bool MemIsEqual_avx10(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    // first handle any non-multiple of 32 size, so code later can deal with 32-byte multiple sizes
+    size_t extra = size & 31;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask32 mask = _cvtu32_mask32(_bzhi_u32(~0U, (uint32_t)extra));
+
+        // do masked load, zeroing out upper bytes
+        __m256i a = _mm256_maskz_loadu_epi8(mask, p1);
+        __m256i b = _mm256_maskz_loadu_epi8(mask, p2);
+
+        // check if any bytes are different
+        __mmask32 m = _mm256_cmpneq_epu8_mask(a, b);
+        if (!_kortestz_mask32_u8(m, m))
+        {
+            // they are different
+            return false;
+        }
+
+        size -= extra;
+        p1 += extra;
+        p2 += extra;
+    }
+
+    // now size is multiple of 32 bytes, process 32-byte blocks until it is 128-byte multiple
+    while (size & 96)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)p1);
+        __m256i b = _mm256_loadu_si256((const __m256i*)p2);
+
+        // check if any bytes are different
+        __mmask32 m = _mm256_cmpneq_epu8_mask(a, b);
+        if (!_kortestz_mask32_u8(m, m))
+        {
+            // they are different
+            return false;
+        }
+
+        size -= 32;
+        p1 += 32;
+        p2 += 32;
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks
+    while (size)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + 0x00));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + 0x20));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p1 + 0x40));
+        __m256i b2 = _mm256_loadu_si256((const __m256i*)(p2 + 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p1 + 0x60));
+        __m256i b3 = _mm256_loadu_si256((const __m256i*)(p2 + 0x60));
+
+        // check if any bytes are different
+        __mmask32 m0 = _mm256_cmpneq_epu8_mask(a0, b0);
+        __mmask32 m1 = _mm256_cmpneq_epu8_mask(a1, b1);
+        __mmask32 m2 = _mm256_cmpneq_epu8_mask(a2, b2);
+        __mmask32 m3 = _mm256_cmpneq_epu8_mask(a3, b3);
+        if (!_kortestz_mask32_u8(_kor_mask32(m0, m1), _kor_mask32(m2, m3)))
+        {
+            // they are different
+            return false;
+        }
+
+        size -= 128;
+        p1 += 128;
+        p2 += 128;
+    }
+
+    // no differences found, inputs are equal
+    return true;
+}
+
+// returns mask of bytes that match input value (or do not match if "invert" is set), only bytes in "mask" are compared
+MEM_TARGET_AVX10
+static MEM_FORCE_INLINE __mmask32 MemFindMatch_avx10(__mmask32 mask, __m256i a, __m256i value32, int invert)
+{
+    return invert ? _mm256_mask_cmpneq_epu8_mask(mask, a, value32) : _mm256_mask_cmpeq_epu8_mask(mask, a, value32);
+}
+
+// returns index of first byte that matches input value (or does not match if "invert" is set)
+MEM_TARGET_AVX10
+static MEM_FORCE_INLINE size_t MemFindByte_avx10(const uint8_t* p, size_t size, uint8_t value, int invert)
+{
+    const __m256i value32 = _mm256_set1_epi8((char)value);
+    const __mmask32 all = _cvtu32_mask32(~0U);
+
+    size_t offset = 0;
+
+    // first handle any non-multiple of 32 size, so code later can deal with 32-byte multiple sizes
+    size_t extra = size & 31;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask32 mask = _cvtu32_mask32(_bzhi_u32(~0U, (uint32_t)extra));
+
+        // do masked load, zeroing out upper bytes
+        __m256i a = _mm256_maskz_loadu_epi8(mask, p);
+
+        // compare against input value, only low "extra" bytes
+        __mmask32 m = MemFindMatch_avx10(mask, a, value32, invert);
+        if (!_kortestz_mask32_u8(m, m))
+        {
+            // return index of lowest byte found
+            return (size_t)_tzcnt_u32(_cvtmask32_u32(m));
+        }
+
+        offset += extra;
+        size -= extra;
+        p += extra;
+    }
+
+    // now size is multiple of 32 bytes, process 32-byte blocks until it is 128-byte multiple
+    while (size & 96)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)p);
+
+        // compare against input value
+        __mmask32 m = MemFindMatch_avx10(all, a, value32, invert);
+        if (!_kortestz_mask32_u8(m, m))
+        {
+            // return index of lowest byte found
+            return offset + (size_t)_tzcnt_u32(_cvtmask32_u32(m));
+        }
+
+        offset += 32;
+        size -= 32;
+        p += 32;
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks
+    while (size)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + 0x60));
+
+        // compare against input value
+        __mmask32 m0 = MemFindMatch_avx10(all, a0, value32, invert);
+        __mmask32 m1 = MemFindMatch_avx10(all, a1, value32, invert);
+        __mmask32 m2 = MemFindMatch_avx10(all, a2, value32, invert);
+        __mmask32 m3 = MemFindMatch_avx10(all, a3, value32, invert);
+        if (!_kortestz_mask32_u8(_kor_mask32(m0, m1), _kor_mask32(m2, m3)))
+        {
+            // combine masks
+            uint64_t m01 = _cvtmask32_u32(m0) | ((uint64_t)_cvtmask32_u32(m1) << 32);
+            uint64_t m23 = _cvtmask32_u32(m2) | ((uint64_t)_cvtmask32_u32(m3) << 32);
+
+            // get index of lowest byte found, upper 64 bytes are used only if nothing is found in lower
+            return offset + (m01 ? _tzcnt_u64(m01) : 64 + _tzcnt_u64(m23));
+        }
+
+        offset += 128;
+        size -= 128;
+        p += 128;
+    }
+
+    // nothing found
+    return offset;
+}
+
+// returns index of last byte that matches input value (or does not match if "invert" is set)
+MEM_TARGET_AVX10
+static MEM_FORCE_INLINE size_t MemFindLastByte_avx10(const uint8_t* p, size_t size, uint8_t value, int invert)
+{
+    const __m256i value32 = _mm256_set1_epi8((char)value);
+    const __mmask32 all = _cvtu32_mask32(~0U);
+
+    // remember original size to return when nothing is found
+    const size_t total = size;
+
+    // first handle any non-multiple of 32 size at the end of buffer, so code later can deal with 32-byte multiple sizes
+    size_t extra = size & 31;
+    if (extra)
+    {
+        size -= extra;
+
+        //  mask to load "extra" amount of bytes
+        __mmask32 mask = _cvtu32_mask32(_bzhi_u32(~0U, (uint32_t)extra));
+
+        // do masked load, zeroing out upper bytes
+        __m256i a = _mm256_maskz_loadu_epi8(mask, p + size);
+
+        // compare against input value, only low "extra" bytes
+        __mmask32 m = MemFindMatch_avx10(mask, a, value32, invert);
+        if (!_kortestz_mask32_u8(m, m))
+        {
+            // return index of highest byte found
+            return size + MEM_BSR32(_cvtmask32_u32(m));
+        }
+    }
+
+    // now size is multiple of 32 bytes, process 32-byte blocks from the end until it is 128-byte multiple
+    while (size & 96)
+    {
+        size -= 32;
+
+        __m256i a = _mm256_loadu_si256((const __m256i*)(p + size));
+
+        // compare against input value
+        __mmask32 m = MemFindMatch_avx10(all, a, value32, invert);
+        if (!_kortestz_mask32_u8(m, m))
+        {
+            // return index of highest byte found
+            return size + MEM_BSR32(_cvtmask32_u32(m));
+        }
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks from the end
+    while (size)
+    {
+        size -= 128;
+
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + size + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + size + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + size + 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + size + 0x60));
+
+        // compare against input value
+        __mmask32 m0 = MemFindMatch_avx10(all, a0, value32, invert);
+        __mmask32 m1 = MemFindMatch_avx10(all, a1, value32, invert);
+        __mmask32 m2 = MemFindMatch_avx10(all, a2, value32, invert);
+        __mmask32 m3 = MemFindMatch_avx10(all, a3, value32, invert);
+        if (!_kortestz_mask32_u8(_kor_mask32(m0, m1), _kor_mask32(m2, m3)))
+        {
+            // combine masks
+            uint64_t m01 = _cvtmask32_u32(m0) | ((uint64_t)_cvtmask32_u32(m1) << 32);
+            uint64_t m23 = _cvtmask32_u32(m2) | ((uint64_t)_cvtmask32_u32(m3) << 32);
+
+            // upper 64 bytes take priority
+            return size + (m23 ? 64 + MEM_BSR64(m23) : MEM_BSR64(m01));
+        }
+    }
+
+    // nothing found
+    return total;
+}
+
+MEM_TARGET_AVX10
+size_t MemFind_avx10(const void* ptr, size_t size, uint8_t value)
+{
+    return MemFindByte_avx10((const uint8_t*)ptr, size, value, 0);
+}
+
+MEM_TARGET_AVX10
+size_t MemFindNot_avx10(const void* ptr, size_t size, uint8_t value)
+{
+    return MemFindByte_avx10((const uint8_t*)ptr, size, value, 1);
+}
+
+MEM_TARGET_AVX10
+size_t MemFindLast_avx10(const void* ptr, size_t size, uint8_t value)
+{
+    return MemFindLastByte_avx10((const uint8_t*)ptr, size, value, 0);
+}
+
+MEM_TARGET_AVX10
+size_t MemFindLastNot_avx10(const void* ptr, size_t size, uint8_t value)
+{
+    return MemFindLastByte_avx10((const uint8_t*)ptr, size, value, 1);
+}
+
+MEM_TARGET_AVX10
+size_t MemCount_avx10(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const __m256i value32 = _mm256_set1_epi8((char)value);
+
+    size_t result = 0;
+
+    // first handle any non-multiple of 32 size, so code later can deal with 32-byte multiple sizes
+    size_t extra = size & 31;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask32 mask = _cvtu32_mask32(_bzhi_u32(~0U, (uint32_t)extra));
+
+        // do masked load, zeroing out upper bytes
+        __m256i a = _mm256_maskz_loadu_epi8(mask, p);
+
+        // count bytes matching input value, only low "extra" bytes
+        __mmask32 m = _mm256_mask_cmpeq_epu8_mask(mask, value32, a);
+        result += MEM_POPCNT32(_cvtmask32_u32(m));
+
+        size -= extra;
+        p += extra;
+    }
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i minus1 = _mm256_set1_epi8(-1);
+
+    // 64-bit counters in four lanes
+    __m256i total = zero;
+
+    // now size is 32-byte multiple
+    while (size)
+    {
+        // every block adds at most 2 to byte lane counters, so they can accumulate 127 blocks before overflowing
+        size_t count = size / 128 < 127 ? size / 128 : 127;
+
+        __m256i sum0 = zero;
+        __m256i sum1 = zero;
+        for (size_t i=0; i<count; i++)
+        {
+            __m256i a0 = _mm256_loadu_si256((const __m256i*)(p + 0x00));
+            __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 0x20));
+            __m256i a2 = _mm256_loadu_si256((const __m256i*)(p + 0x40));
+            __m256i a3 = _mm256_loadu_si256((const __m256i*)(p + 0x60));
+
+            // increment byte lane counters only where input value matches
+            sum0 = _mm256_mask_sub_epi8(sum0, _mm256_cmpeq_epu8_mask(value32, a0), sum0, minus1);
+            sum1 = _mm256_mask_sub_epi8(sum1, _mm256_cmpeq_epu8_mask(value32, a1), sum1, minus1);
+            sum0 = _mm256_mask_sub_epi8(sum0, _mm256_cmpeq_epu8_mask(value32, a2), sum0, minus1);
+            sum1 = _mm256_mask_sub_epi8(sum1, _mm256_cmpeq_epu8_mask(value32, a3), sum1, minus1);
+
+            p += 128;
+        }
+        size -= count * 128;
+
+        if (count == 0) // size is 32, 64 or 96
+        {
+            while (size)
+            {
+                __m256i a0 = _mm256_loadu_si256((const __m256i*)p);
+                sum0 = _mm256_mask_sub_epi8(sum0, _mm256_cmpeq_epu8_mask(value32, a0), sum0, minus1);
+
+                p += 32;
+                size -= 32;
+            }
+        }
+
+        // horizontal sum of byte lane counters into 64-bit counters
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(sum0, zero));
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(sum1, zero));
+    }
+
+    // sum all 64-bit counters
+    uint64_t counters[4];
+    _mm256_storeu_si256((__m256i*)counters, total);
+    for (size_t i=0; i<4; i++)
+    {
+        result += (size_t)counters[i];
+    }
+
+    return result;
+}
+
+MEM_TARGET_AVX10
+size_t MemMismatch_avx10(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    size_t offset = 0;
+
+    // first handle any non-multiple of 32 size, so code later can deal with 32-byte multiple sizes
+    size_t extra = size & 31;
+    if (extra)
+    {
+        //  mask to load "extra" amount of bytes
+        __mmask32 mask = _cvtu32_mask32(_bzhi_u32(~0U, (uint32_t)extra));
+
+        // do masked load, zeroing out upper bytes
+        __m256i a = _mm256_maskz_loadu_epi8(mask, p1);
+        __m256i b = _mm256_maskz_loadu_epi8(mask, p2);
+
+        // check if any bytes are different, upper bytes are zero in both
+        __mmask32 m = _mm256_cmpneq_epu8_mask(a, b);
+        if (!_kortestz_mask32_u8(m, m))
+        {
+            // if they are, return index of lowest byte that is different
+            return (size_t)_tzcnt_u32(_cvtmask32_u32(m));
+        }
+
+        offset += extra;
+        size -= extra;
+        p1 += extra;
+        p2 += extra;
+    }
+
+    // now size is multiple of 32 bytes, process 32-byte blocks until it is 128-byte multiple
+    while (size & 96)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)p1);
+        __m256i b = _mm256_loadu_si256((const __m256i*)p2);
+
+        // check if any bytes are different
+        __mmask32 m = _mm256_cmpneq_epu8_mask(a, b);
+        if (!_kortestz_mask32_u8(m, m))
+        {
+            // if they are, return index of lowest byte that is different
+            return offset + (size_t)_tzcnt_u32(_cvtmask32_u32(m));
+        }
+
+        offset += 32;
+        size -= 32;
+        p1 += 32;
+        p2 += 32;
+    }
+
+    // now size is 128-byte multiple, process rest of them in 128-byte blocks
+    while (size)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p1 + 0x00));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(p2 + 0x00));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(p1 + 0x20));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p2 + 0x20));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(p1 + 0x40));
+        __m256i b2 = _mm256_loadu_si256((const __m256i*)(p2 + 0x40));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(p1 + 0x60));
+        __m256i b3 = _mm256_loadu_si256((const __m256i*)(p2 + 0x60));
+
+        // check if any bytes are different
+        __mmask32 m0 = _mm256_cmpneq_epu8_mask(a0, b0);
+        __mmask32 m1 = _mm256_cmpneq_epu8_mask(a1, b1);
+        __mmask32 m2 = _mm256_cmpneq_epu8_mask(a2, b2);
+        __mmask32 m3 = _mm256_cmpneq_epu8_mask(a3, b3);
+        if (!_kortestz_mask32_u8(_kor_mask32(m0, m1), _kor_mask32(m2, m3)))
+        {
+            // combine masks
+            uint64_t m01 = _cvtmask32_u32(m0) | ((uint64_t)_cvtmask32_u32(m1) << 32);
+            uint64_t m23 = _cvtmask32_u32(m2) | ((uint64_t)_cvtmask32_u32(m3) << 32);
+
+            // get index of lowest byte that is different, upper 64 bytes are used only if lower are same
+            return offset + (m01 ? _tzcnt_u64(m01) : 64 + _tzcnt_u64(m23));
+        }
+
+        offset += 128;
+        size -= 128;
+        p1 += 128;
+        p2 += 128;
+    }
+
+    // no differences found
+    return offset;
+}
+
+#endif
+
+
+#if MEM_ARCH_ARM64
+
+static inline uint8x16_t MemToLower16(uint8x16_t x)
+{
+    uint8x16_t tmp = vsubq_u8(x, vdupq_n_u8('A'));
+    tmp = vcleq_u8(tmp, vdupq_n_u8('Z' - 'A'));
+    tmp = vandq_u8(tmp, vdupq_n_u8('a' - 'A'));
+    return vaddq_u8(x, tmp);
+}
+
+// flips ASCII case of letters in [first, first + 'Z' - 'A'] range, first is either 'A' or 'a'
+static inline uint8x16_t MemConvertCase16(uint8x16_t x, uint8_t first)
+{
+    uint8x16_t tmp = vsubq_u8(x, vdupq_n_u8(first));
+    tmp = vcleq_u8(tmp, vdupq_n_u8('Z' - 'A'));
+    tmp = vandq_u8(tmp, vdupq_n_u8('a' - 'A'));
+    return veorq_u8(x, tmp);
+}
+
+MEM_DISABLE_ASAN
+int MemCompare_neon(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 16)
+    {
+        if (size < 2) // size == 1
+        {
+            return p1[0] - p2[0];
+        }
+
+        // will load pair of 4, 8 or 16 overlapping bytes
+        // a/b0 from beginning of buffer
+        // a/b1 from end of buffers
+        uint64_t a0, b0, a1, b1;
+
+        if (size < 4) // 2 <= size < 4
+        {
+            a0 = MEM_PTR16U(p1);
+            b0 = MEM_PTR16U(p2);
+            a1 = MEM_PTR16U(p1 + size - 2);
+            b1 = MEM_PTR16U(p2 + size - 2);
+        }
+        else if (size < 8) // 4 <= size < 8
+        {
+            a0 = MEM_PTR32U(p1);
+            b0 = MEM_PTR32U(p2);
+            a1 = MEM_PTR32U(p1 + size - 4);
+            b1 = MEM_PTR32U(p2 + size - 4);
+        }
+        else // 8 <= size <= 16
+        {
+            a0 = MEM_PTR64U(p1);
+            b0 = MEM_PTR64U(p2);
+            a1 = MEM_PTR64U(p1 + size - 8);
+            b1 = MEM_PTR64U(p2 + size - 8);
+        }
+
+        // use a0/b0 if they are not equal, otherwise a1/b1
+        // byte swap because in big-endian bytes can be compared as uint64 numbers
+        uint64_t a = MEM_BSWAP64(a0 != b0 ? a0 : a1);
+        uint64_t b = MEM_BSWAP64(a0 != b0 ? b0 : b1);
+
+        return (a > b) - (a < b);
+    }
+
+    const uint8x16_t index4 = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201));
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        uint8x16x4_t a = vld1q_u8_x4(p1);
+        uint8x16x4_t b = vld1q_u8_x4(p2);
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        uint8x16_t c0 = vceqq_u8(a.val[0], b.val[0]);
+        uint8x16_t c1 = vceqq_u8(a.val[1], b.val[1]);
+        uint8x16_t c2 = vceqq_u8(a.val[2], b.val[2]);
+        uint8x16_t c3 = vceqq_u8(a.val[3], b.val[3]);
+
+        // combine comparisons - leave 0xff in lanes that were not equal in at least one of inputs
+        uint8x16_t c = vmvnq_u8(vandq_u8(vandq_u8(c0, c1), vandq_u8(c2, c3)));
+
+        // nibbles will contain 16 masks with 4-bit value 0xf for lanes that were not equal
+        // meaning if nibbles is non-zero, then there is mismatch in input bytes
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(c), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        if (nibbles)
+        {
+            // change all lanes with 0xff byte to 0
+            // but for lanes with 0x00 byte keep its index (8 based)
+            uint8x16_t m0 = vbicq_u8(index4, c0);
+            uint8x16_t m1 = vbicq_u8(index4, c1);
+            uint8x16_t m2 = vbicq_u8(index4, c2);
+            uint8x16_t m3 = vbicq_u8(index4, c3);
+
+            // sum pairs of masks, so result fits into 64-bit low lane
+            uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+            uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+            // now s3 will have bit set 1 in position we want to extract
+            uint64_t s3 = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+            // get index for byte position that's different in inputs, s3 is non-zero here
+            size_t index = MEM_CTZ64(s3);
+
+            return p1[index] - p2[index];
+        }
+
+        size -= 64;
+        p1 += 64;
+        p2 += 64;
+    }
+
+    if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap, 0/1 from beginning of buffers, 2/3 from end of buffers
+        uint8x16x2_t a0 = vld1q_u8_x2(p1);
+        uint8x16x2_t b0 = vld1q_u8_x2(p2);
+        uint8x16x2_t a1 = vld1q_u8_x2(p1 + size - 0x20);
+        uint8x16x2_t b1 = vld1q_u8_x2(p2 + size - 0x20);
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        uint8x16_t c0 = vceqq_u8(a0.val[0], b0.val[0]);
+        uint8x16_t c1 = vceqq_u8(a0.val[1], b0.val[1]);
+        uint8x16_t c2 = vceqq_u8(a1.val[0], b1.val[0]);
+        uint8x16_t c3 = vceqq_u8(a1.val[1], b1.val[1]);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vbicq_u8(index4, c0);
+        uint8x16_t m1 = vbicq_u8(index4, c1);
+        uint8x16_t m2 = vbicq_u8(index4, c2);
+        uint8x16_t m3 = vbicq_u8(index4, c3);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+        // extract 64-bit index mask
+        uint64_t m = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+        // get index for byte position that's different in inputs, or 64 if inputs are equal
+        size_t index = m ? MEM_CTZ64(m) : 64;
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 32) ? index : (index - 32) + (size - 32);
+        index += (index >= 32) * (size - 64);
+
+        // return comparison result, or 0 if inputs are equal
+        return index < size ? p1[index] - p2[index] : 0;
+    }
+    else if (size & 16) // 16 <= size < 32
+    {
+        // load 32 bytes, some will overlap
+        uint8x16_t a0 = vld1q_u8(p1);
+        uint8x16_t b0 = vld1q_u8(p2);
+        uint8x16_t a1 = vld1q_u8(p1 + size - 0x10);
+        uint8x16_t b1 = vld1q_u8(p2 + size - 0x10);
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        uint8x16_t c0 = vceqq_u8(a0, b0);
+        uint8x16_t c1 = vceqq_u8(a1, b1);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vbicq_u8(index4, c0);
+        uint8x16_t m1 = vbicq_u8(index4, c1);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(m0, m1);
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+        uint8x16_t s3 = vpaddq_u8(s2, s2);
+
+        // extract 64-bit index mask
+        uint32_t m = vgetq_lane_u32(vreinterpretq_u32_u8(s3), 0);
+
+        // get index for byte position that's different in inputs, or 32 if inputs are equal
+        size_t index = m ? MEM_CTZ32(m) : 32;
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 16) ? index : (index - 16) + (size - 16);
+        index += (index >= 16) * (size - 32);
+
+        // return comparison result, or 0 if inputs are equal
+        return index < size ? p1[index] - p2[index] : 0;
+    }
+    else if (size) // 0 < size < 16, but initially size > 16
+    {
+        // load 16 bytes from end of buffer
+        // this will load previously checked bytes in 64 byte loop (they were equal)
+        uint8x16_t a = vld1q_u8(p1 + size - 16);
+        uint8x16_t b = vld1q_u8(p2 + size - 16);
+
+        // set lanes to 0x00 if bytes are equal, or 0xff if not
+        uint8x16_t c = vmvnq_u8(vceqq_u8(a, b));
+
+        // nibbles will contain 16 masks with 4-bit value 0x0 if lanes were equal
+        // if there is one lane that was not equal, it contains 0xf
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(c), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // get index for byte position that's different in inputs, or 16
+        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+
+        // adjust index due to reused bytes in load
+        index += size - 16;
+
+        // return comparison result, or 0 if inputs are equal
+        return index < size ? p1[index] - p2[index] : 0;
+    }
+
+    // no differences found, inputs are equal
+    return 0;
+}
+
+MEM_DISABLE_ASAN
+int MemCompareI_neon(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 16)
+    {
+        if (size < 2) // size == 1
+        {
+            return MemToLower1(p1[0]) - MemToLower1(p2[0]);
+        }
+
+        if (size < 4) // 2 <= size < 4
+        {
+            // load pair of 4 overlapping bytes
+            uint64_t a0 = MEM_PTR16U(p1);
+            uint64_t b0 = MEM_PTR16U(p2);
+            uint64_t a1 = MEM_PTR16U(p1 + size - 2);
+            uint64_t b1 = MEM_PTR16U(p2 + size - 2);
+
+            // combine, lower case them and byteswap to have numbers in big-endian
+            uint64_t tmp = MEM_BSWAP64(MemToLower8(a0 | (a1 << 16) | (b0 << 32) | (b1 << 48)));
+            uint32_t a = (uint32_t)(tmp >> 32);
+            uint32_t b = (uint32_t)tmp;
+
+            // can compare uint64 numbers if they are big-endian
+            return (a > b) - (a < b);
+        }
+        else if (size < 8) // 4 <= size < 8
+        {
+            // load pair of 8 overlapping bytes
+            uint64_t a0 = MEM_PTR32U(p1);
+            uint64_t b0 = MEM_PTR32U(p2);
+            uint64_t a1 = MEM_PTR32U(p1 + size - 4);
+            uint64_t b1 = MEM_PTR32U(p2 + size - 4);
+
+            // combine, lower case them and byteswap to have numbers in big-endian
+            uint64_t a = MEM_BSWAP64(MemToLower8(a0 | (a1 << 32)));
+            uint64_t b = MEM_BSWAP64(MemToLower8(b0 | (b1 << 32)));
+
+            // can compare uint64 numbers if they are big-endian
+            return (a > b) - (a < b);
+        }
+        else // 8 <= size <= 16
+        {
+            // load pair of 16 overlapping bytes
+            uint8x16_t va = vcombine_u8(vld1_u8(p1), vld1_u8(p1 + size - 8));
+            uint8x16_t vb = vcombine_u8(vld1_u8(p2), vld1_u8(p2 + size - 8));
+
+            // lower case them and byteswap to have numbers in big-endian
+            uint64x2_t a64 = vreinterpretq_u64_u8(vrev64q_u8(MemToLower16(va)));
+            uint64x2_t b64 = vreinterpretq_u64_u8(vrev64q_u8(MemToLower16(vb)));
+
+            // use a0/b0 if they are not equal, otherwise a1/b1
+            uint64_t a0 = vgetq_lane_u64(a64, 0);
+            uint64_t b0 = vgetq_lane_u64(b64, 0);
+            uint64_t a1 = vgetq_lane_u64(a64, 1);
+            uint64_t b1 = vgetq_lane_u64(b64, 1);
+            uint64_t a = (a0 != b0 ? a0 : a1);
+            uint64_t b = (a0 != b0 ? b0 : b1);
+
+            return (a > b) - (a < b);
+        }
+    }
+
+    const uint8x16_t index4 = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201));
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        uint8x16x4_t a = vld1q_u8_x4(p1);
+        uint8x16x4_t b = vld1q_u8_x4(p2);
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        uint8x16_t c0 = vceqq_u8(MemToLower16(a.val[0]), MemToLower16(b.val[0]));
+        uint8x16_t c1 = vceqq_u8(MemToLower16(a.val[1]), MemToLower16(b.val[1]));
+        uint8x16_t c2 = vceqq_u8(MemToLower16(a.val[2]), MemToLower16(b.val[2]));
+        uint8x16_t c3 = vceqq_u8(MemToLower16(a.val[3]), MemToLower16(b.val[3]));
+
+        // combine comparisons - leave 0xff in lanes that were not equal in at least one of inputs
+        uint8x16_t c = vmvnq_u8(vandq_u8(vandq_u8(c0, c1), vandq_u8(c2, c3)));
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(c), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        if (nibbles)
+        {
+            // comparisons to bit index masks
+            uint8x16_t m0 = vbicq_u8(index4, c0);
+            uint8x16_t m1 = vbicq_u8(index4, c1);
+            uint8x16_t m2 = vbicq_u8(index4, c2);
+            uint8x16_t m3 = vbicq_u8(index4, c3);
+
+            // sum pairs of masks, so result fits into 64-bit low lane
+            uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+            uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+            // extract 64-bit index mask
+            uint64_t s3 = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+            // get index for byte position that's different in inputs, s3 is non-zero here
+            size_t index = MEM_CTZ64(s3);
+
+            return MemToLower1(p1[index]) - MemToLower1(p2[index]);
+        }
+
+        size -= 64;
+        p1 += 64;
+        p2 += 64;
+    }
+
+    if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap
+        uint8x16x2_t a0 = vld1q_u8_x2(p1);
+        uint8x16x2_t b0 = vld1q_u8_x2(p2);
+        uint8x16x2_t a1 = vld1q_u8_x2(p1 + size - 0x20);
+        uint8x16x2_t b1 = vld1q_u8_x2(p2 + size - 0x20);
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        uint8x16_t c0 = vceqq_u8(MemToLower16(a0.val[0]), MemToLower16(b0.val[0]));
+        uint8x16_t c1 = vceqq_u8(MemToLower16(a0.val[1]), MemToLower16(b0.val[1]));
+        uint8x16_t c2 = vceqq_u8(MemToLower16(a1.val[0]), MemToLower16(b1.val[0]));
+        uint8x16_t c3 = vceqq_u8(MemToLower16(a1.val[1]), MemToLower16(b1.val[1]));
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vbicq_u8(index4, c0);
+        uint8x16_t m1 = vbicq_u8(index4, c1);
+        uint8x16_t m2 = vbicq_u8(index4, c2);
+        uint8x16_t m3 = vbicq_u8(index4, c3);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+        // extract 64-bit index mask
+        uint64_t m = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+        // get index for byte position that's different in inputs, or 64 if inputs are equal
+        size_t index = m ? MEM_CTZ64(m) : 64;
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 32) ? index : (index - 32) + (size - 32);
+        index += (index >= 32) * (size - 64);
+
+        // return comparison result, or 0 if inputs are equal
+        return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
+    }
+    else if (size & 16) // 16 <= size < 32
+    {
+        // load 32 bytes, some will overlap
+        uint8x16_t a0 = vld1q_u8(p1);
+        uint8x16_t b0 = vld1q_u8(p2);
+        uint8x16_t a1 = vld1q_u8(p1 + size - 0x10);
+        uint8x16_t b1 = vld1q_u8(p2 + size - 0x10);
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        uint8x16_t c0 = vceqq_u8(MemToLower16(a0), MemToLower16(b0));
+        uint8x16_t c1 = vceqq_u8(MemToLower16(a1), MemToLower16(b1));
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vbicq_u8(index4, c0);
+        uint8x16_t m1 = vbicq_u8(index4, c1);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(m0, m1);
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+        uint8x16_t s3 = vpaddq_u8(s2, s2);
+
+        // extract 64-bit index mask
+        uint32_t m = vgetq_lane_u32(vreinterpretq_u32_u8(s3), 0);
+
+        // get index for byte position that's different in inputs, or 32 if inputs are equal
+        size_t index = m ? MEM_CTZ32(m) : 32;
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 16) ? index : (index - 16) + (size - 16);
+        index += (index >= 16) * (size - 32);
+
+        // return comparison result, or 0 if inputs are equal
+        return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
+    }
+    else if (size) // 0 < size < 16, but initially size > 16
+    {
+        // load 16 bytes from end of buffer
+        // this will load previously checked bytes in 64 byte loop (they were equal)
+        uint8x16_t a = vld1q_u8(p1 + size - 16);
+        uint8x16_t b = vld1q_u8(p2 + size - 16);
+
+        // set lanes to 0x00 if bytes are equal, or 0xff if not
+        uint8x16_t c = vmvnq_u8(vceqq_u8(MemToLower16(a), MemToLower16(b)));
+
+        // nibbles will contain 16 masks with 4-bit value 0x0 if lanes were equal
+        // if there is one lane that was not equal, it contains 0xf
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(c), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // get index for byte position that's different in inputs, or 16
+        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+
+        // adjust index due to reused bytes in load
+        index += size - 16;
+
+        // return comparison result, or 0 if inputs are equal
+        return index < size ? MemToLower1(p1[index]) - MemToLower1(p2[index]) : 0;
+    }
+
+    // no differences found, inputs are equal
+    return 0;
+}
+
+MEM_DISABLE_ASAN
+bool MemIsEqual_neon(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    if (size == 0)
+    {
+        return true;
+    }
+
+    if (size <= 16)
+    {
+        if (size < 2) // size == 1
+        {
+            return p1[0] == p2[0];
+        }
+
+        // will load pair of 4, 8 or 16 overlapping bytes
+        // a/b0 from beginning of buffer
+        // a/b1 from end of buffers
+        uint64_t a0, b0, a1, b1;
+
+        if (size < 4) // 2 <= size < 4
+        {
+            a0 = MEM_PTR16U(p1);
+            b0 = MEM_PTR16U(p2);
+            a1 = MEM_PTR16U(p1 + size - 2);
+            b1 = MEM_PTR16U(p2 + size - 2);
+        }
+        else if (size < 8) // 4 <= size < 8
+        {
+            a0 = MEM_PTR32U(p1);
+            b0 = MEM_PTR32U(p2);
+            a1 = MEM_PTR32U(p1 + size - 4);
+            b1 = MEM_PTR32U(p2 + size - 4);
+        }
+        else // 8 <= size <= 16
+        {
+            a0 = MEM_PTR64U(p1);
+            b0 = MEM_PTR64U(p2);
+            a1 = MEM_PTR64U(p1 + size - 8);
+            b1 = MEM_PTR64U(p2 + size - 8);
+        }
+
+        // compare loaded bytes on equality, overlapped ones will be checked twice
+        // but result will still be correct
+        return (a0 == b0) & (a1 == b1);
+    }
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        uint8x16x4_t a = vld1q_u8_x4(p1);
+        uint8x16x4_t b = vld1q_u8_x4(p2);
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        uint8x16_t c0 = vceqq_u8(a.val[0], b.val[0]);
+        uint8x16_t c1 = vceqq_u8(a.val[1], b.val[1]);
+        uint8x16_t c2 = vceqq_u8(a.val[2], b.val[2]);
+        uint8x16_t c3 = vceqq_u8(a.val[3], b.val[3]);
+
+        // combine comparisons - leave 0xff in lanes that were not equal in at least one of inputs
+        uint8x16_t c = vmvnq_u8(vandq_u8(vandq_u8(c0, c1), vandq_u8(c2, c3)));
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(c), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        if (nibbles)
+        {
+            // if nibbles is non-zero then there is at least one difference
+            return false;
+        }
+
+        size -= 64;
+        p1 += 64;
+        p2 += 64;
+    }
+
+    if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap
+        uint8x16x2_t a0 = vld1q_u8_x2(p1);
+        uint8x16x2_t b0 = vld1q_u8_x2(p2);
+        uint8x16x2_t a1 = vld1q_u8_x2(p1 + size - 0x20);
+        uint8x16x2_t b1 = vld1q_u8_x2(p2 + size - 0x20);
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        uint8x16_t c0 = vceqq_u8(a0.val[0], b0.val[0]);
+        uint8x16_t c1 = vceqq_u8(a0.val[1], b0.val[1]);
+        uint8x16_t c2 = vceqq_u8(a1.val[0], b1.val[0]);
+        uint8x16_t c3 = vceqq_u8(a1.val[1], b1.val[1]);
+
+        // combine comparisons - leave 0xff in lanes that were not equal in at least one of inputs
+        uint8x16_t c = vmvnq_u8(vandq_u8(vandq_u8(c0, c1), vandq_u8(c2, c3)));
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(c), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // if nibbles are zero, then there were no differences in inputs
+        return nibbles == 0;
+    }
+    else if (size & 16) // 16 <= size < 32
+    {
+        // load 32 bytes, some will overlap
+        uint8x16_t a0 = vld1q_u8(p1);
+        uint8x16_t b0 = vld1q_u8(p2);
+        uint8x16_t a1 = vld1q_u8(p1 + size - 0x10);
+        uint8x16_t b1 = vld1q_u8(p2 + size - 0x10);
+
+        // set lanes to 0xff if bytes are equal, or 0x00 if not
+        uint8x16_t c0 = vceqq_u8(a0, b0);
+        uint8x16_t c1 = vceqq_u8(a1, b1);
+
+        // combine comparisons - leave 0xff in lanes that were not equal in at least one of inputs
+        uint8x16_t c = vmvnq_u8(vandq_u8(c0, c1));
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(c), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // if nibbles are zero, then there were no differences in inputs
+        return nibbles == 0;
+    }
+    else if (size) // 0 < size < 16, but initially size > 16
+    {
+        // load 16 bytes from end of buffer
+        // this will load previously checked bytes in 64 byte loop (they were equal)
+        uint8x16_t a = vld1q_u8(p1 + size - 0x10);
+        uint8x16_t b = vld1q_u8(p2 + size - 0x10);
+
+        // combine comparisons - leave 0xff in lanes that were not equal in at least one of inputs
+        uint8x16_t c = vmvnq_u8(vceqq_u8(a, b));
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(c), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // if nibbles are zero, then there were no differences in inputs
+        return nibbles == 0;
+    }
+
+    // no differences found, inputs are equal
+    return true;
+}
+
+MEM_DISABLE_ASAN
+size_t MemFind_neon(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    const uint8x16_t value16 = vdupq_n_u8(value);
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 16)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
+
+        // will load before the beginning buffer (16-byte aligned) if end is too close
+        // to 16-byte boundary, otherwise will load past the end of buffer
+        uint8x16_t a = vld1q_u8(p - extra);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b = vceqq_u8(a, value16);
+
+        // nibbles will contain 16 masks with 4-bit value 0xf if lane matches input value
+        // if there is one lane that was not equal, mask contains 0x0
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        nibbles >>= (4 * extra);
+
+        // for non-zero nibble find first bit set, which will be index of first byte matching input value
+        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+
+        // mask out any high bits (due to load past end of buffer)
+        return index < size ? index : size;
+    }
+
+    const uint8x16_t index4 = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201));
+
+    size_t offset = 0;
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        uint8x16x4_t a = vld1q_u8_x4(p);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(a.val[0], value16);
+        uint8x16_t b1 = vceqq_u8(a.val[1], value16);
+        uint8x16_t b2 = vceqq_u8(a.val[2], value16);
+        uint8x16_t b3 = vceqq_u8(a.val[3], value16);
+
+        // combine comparisons - leave 0xff in lanes there equal to input value
+        uint8x16_t b01 = vorrq_u8(b0, b1);
+        uint8x16_t b23 = vorrq_u8(b2, b3);
+#if defined(__clang__)
+        // without this clang 19+ generates worse code (runs slower)
+        __asm__ __volatile__("" : "+w"(b01), "+w"(b23));
+#endif
+        uint8x16_t b = vorrq_u8(b01, b23);
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        if (nibbles)
+        {
+            // comparisons to bit index masks
+            uint8x16_t m0 = vandq_u8(b0, index4);
+            uint8x16_t m1 = vandq_u8(b1, index4);
+            uint8x16_t m2 = vandq_u8(b2, index4);
+            uint8x16_t m3 = vandq_u8(b3, index4);
+
+            // sum pairs of masks, so result fits into 64-bit low lane
+            uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+            uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+            // extract 64-bit index mask
+            uint64_t s3 = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+            // get index for byte position that matches input value
+            return offset + MEM_CTZ64(s3);
+        }
+
+        offset += 64;
+        size -= 64;
+        p += 64;
+    }
+
+    if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap
+        uint8x16x2_t a0 = vld1q_u8_x2(p);
+        uint8x16x2_t a1 = vld1q_u8_x2(p + size - 0x20);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(a0.val[0], value16);
+        uint8x16_t b1 = vceqq_u8(a0.val[1], value16);
+        uint8x16_t b2 = vceqq_u8(a1.val[0], value16);
+        uint8x16_t b3 = vceqq_u8(a1.val[1], value16);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vandq_u8(b0, index4);
+        uint8x16_t m1 = vandq_u8(b1, index4);
+        uint8x16_t m2 = vandq_u8(b2, index4);
+        uint8x16_t m3 = vandq_u8(b3, index4);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+        // extract 64-bit index mask
+        uint64_t m = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+        // get index of byte that matches input value, or 64
+        size_t index = m ? MEM_CTZ64(m) : 64;
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 32) ? index : (index - 32) + (size - 32);
+        index += (index >= 32) * (size - 64);
+
+        return offset + index;
+    }
+    else if (size & 16) // 16 <= size < 32
+    {
+        // load 32 bytes, some will overlap
+        uint8x16_t a0 = vld1q_u8(p);
+        uint8x16_t a1 = vld1q_u8(p + size - 0x10);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(a0, value16);
+        uint8x16_t b1 = vceqq_u8(a1, value16);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vandq_u8(b0, index4);
+        uint8x16_t m1 = vandq_u8(b1, index4);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(m0, m1);
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+        uint8x16_t s3 = vpaddq_u8(s2, s2);
+
+        // extract 64-bit index mask
+        uint32_t m = vgetq_lane_u32(vreinterpretq_u32_u8(s3), 0);
+
+        // get index of byte that matches input value, or 32
+        size_t index = m ? MEM_CTZ32(m) : 32;
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 16) ? index : (index - 16) + (size - 16);
+        index += (index >= 16) * (size - 32);
+
+        return offset + index;
+    }
+    else if (size) // 0 < size < 16, but initially size > 16
+    {
+        // load 32 bytes from end of buffer
+        // this will load previously checked bytes in 64 byte loop (they did not match input value)
+        uint8x16_t a = vld1q_u8(p + size - 16);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b = vceqq_u8(a, value16);
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // get index of byte that matches input value, or 16
+        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+
+        // adjust index due to reused bytes in load
+        return offset + index + size - 16;
+    }
+
+    // no input value found, return original size (current offset plus pending tail size)
+    return offset + size;
+}
+
+MEM_DISABLE_ASAN
+size_t MemFindNot_neon(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    const uint8x16_t value16 = vdupq_n_u8(value);
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 16)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
+
+        // will load before the beginning buffer (16-byte aligned) if end is too close
+        // to 16-byte boundary, otherwise will load past the end of buffer
+        uint8x16_t a = vld1q_u8(p - extra);
+
+        // set lane to 0x00 if lane matches input value, or 0xff if not
+        uint8x16_t b = vmvnq_u8(vceqq_u8(a, value16));
+
+        // nibbles will contain 16 masks with 4-bit value 0x0 if lane matches input value
+        // if there is one lane that was not equal, it contains 0xf
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        nibbles >>= (4 * extra);
+
+        // for non-zero nibble find first bit set, which will be index of first byte different from input value
+        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+
+        // mask out any high bits (due to load past end of buffer)
+        return index < size ? index : size;
+    }
+
+    const uint8x16_t index4 = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201));
+
+    size_t offset = 0;
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        uint8x16x4_t a = vld1q_u8_x4(p);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(a.val[0], value16);
+        uint8x16_t b1 = vceqq_u8(a.val[1], value16);
+        uint8x16_t b2 = vceqq_u8(a.val[2], value16);
+        uint8x16_t b3 = vceqq_u8(a.val[3], value16);
+
+        // combine comparisons - leave 0xff in lanes that were not matching in at least one of inputs
+        uint8x16_t b = vmvnq_u8(vandq_u8(vandq_u8(b0, b1), vandq_u8(b2, b3)));
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        if (nibbles)
+        {
+            // comparisons to bit index masks
+            uint8x16_t m0 = vbicq_u8(index4, b0);
+            uint8x16_t m1 = vbicq_u8(index4, b1);
+            uint8x16_t m2 = vbicq_u8(index4, b2);
+            uint8x16_t m3 = vbicq_u8(index4, b3);
+
+            // sum pairs of masks, so result fits into 64-bit low lane
+            uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+            uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+            // extract 64-bit index mask
+            uint64_t s3 = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+            // get index for byte position that's different from input value
+            return offset + MEM_CTZ64(s3);
+        }
+
+        offset += 64;
+        size -= 64;
+        p += 64;
+    }
+
+    if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap
+        uint8x16x2_t a0 = vld1q_u8_x2(p);
+        uint8x16x2_t a1 = vld1q_u8_x2(p + size - 0x20);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(a0.val[0], value16);
+        uint8x16_t b1 = vceqq_u8(a0.val[1], value16);
+        uint8x16_t b2 = vceqq_u8(a1.val[0], value16);
+        uint8x16_t b3 = vceqq_u8(a1.val[1], value16);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vbicq_u8(index4, b0);
+        uint8x16_t m1 = vbicq_u8(index4, b1);
+        uint8x16_t m2 = vbicq_u8(index4, b2);
+        uint8x16_t m3 = vbicq_u8(index4, b3);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+        // extract 64-bit index mask
+        uint64_t m = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+        // get index of byte that does not match input value, or 64
+        size_t index = m ? MEM_CTZ64(m) : 64;
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 32) ? index : (index - 32) + (size - 32);
+        index += (index >= 32) * (size - 64);
+
+        return offset + index;
+    }
+    else if (size & 16) // 16 <= size < 32
+    {
+        // load 32 bytes, some will overlap
+        uint8x16_t a0 = vld1q_u8(p);
+        uint8x16_t a1 = vld1q_u8(p + size - 0x10);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(a0, value16);
+        uint8x16_t b1 = vceqq_u8(a1, value16);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vbicq_u8(index4, b0);
+        uint8x16_t m1 = vbicq_u8(index4, b1);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(m0, m1);
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+        uint8x16_t s3 = vpaddq_u8(s2, s2);
+
+        // extract 64-bit index mask
+        uint32_t m = vgetq_lane_u32(vreinterpretq_u32_u8(s3), 0);
+
+        // get index of byte that does not match input value, or 32
+        size_t index = m ? MEM_CTZ32(m) : 32;
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 16) ? index : (index - 16) + (size - 16);
+        index += (index >= 16) * (size - 32);
+
+        return offset + index;
+    }
+    else if (size) // 0 < size < 16, but initially size > 16
+    {
+        // load 16 bytes from end of buffer
+        // this will load previously checked bytes in 64 byte loop (they did match input value)
+        uint8x16_t a = vld1q_u8(p + size - 16);
+
+        // set lane to 0x00 if lane matches input value, or 0xff if not
+        uint8x16_t b = vmvnq_u8(vceqq_u8(a, value16));
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // get index of byte that does not match input value, or 16
+        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+
+        // adjust index due to reused bytes in load
+        return offset + index + size - 16;
+    }
+
+    // all bytes are same as input value, return original size (current offset plus pending tail size)
+    return offset + size;
+}
+
+MEM_DISABLE_ASAN
+size_t MemFindLast_neon(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    const uint8x16_t value16 = vdupq_n_u8(value);
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 16)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
+
+        // will load before the beginning buffer (16-byte aligned) if end is too close
+        // to 16-byte boundary, otherwise will load past the end of buffer
+        uint8x16_t a = vld1q_u8(p - extra);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b = vceqq_u8(a, value16);
+
+        // nibbles will contain 16 masks with 4-bit value 0xf for lanes matching input value
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        nibbles >>= (4 * extra);
+
+        // mask out any high bits (due to load past end of buffer)
+        nibbles &= ~0ULL >> (64 - 4 * size);
+
+        // for non-zero nibble find last bit set, which will be index of last byte matching input value
+        return nibbles ? MEM_BSR64(nibbles) / 4 : size;
+    }
+
+    const uint8x16_t index4 = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201));
+
+    // remember original size to return when input value is not found
+    const size_t total = size;
+
+    // process 64-byte blocks from the end of buffer as much as possible
+    while (size >= 64)
+    {
+        size -= 64;
+
+        uint8x16x4_t a = vld1q_u8_x4(p + size);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(a.val[0], value16);
+        uint8x16_t b1 = vceqq_u8(a.val[1], value16);
+        uint8x16_t b2 = vceqq_u8(a.val[2], value16);
+        uint8x16_t b3 = vceqq_u8(a.val[3], value16);
+
+        // combine comparisons - leave 0xff in lanes there equal to input value
+        uint8x16_t b01 = vorrq_u8(b0, b1);
+        uint8x16_t b23 = vorrq_u8(b2, b3);
+#if defined(__clang__)
+        // without this clang 19+ generates worse code (runs slower)
+        __asm__ __volatile__("" : "+w"(b01), "+w"(b23));
+#endif
+        uint8x16_t b = vorrq_u8(b01, b23);
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        if (nibbles)
+        {
+            // comparisons to bit index masks
+            uint8x16_t m0 = vandq_u8(b0, index4);
+            uint8x16_t m1 = vandq_u8(b1, index4);
+            uint8x16_t m2 = vandq_u8(b2, index4);
+            uint8x16_t m3 = vandq_u8(b3, index4);
+
+            // sum pairs of masks, so result fits into 64-bit low lane
+            uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+            uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+            // extract 64-bit index mask
+            uint64_t s3 = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+            // get index for last byte position that matches input value
+            return size + MEM_BSR64(s3);
+        }
+    }
+
+    if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap
+        uint8x16x2_t a0 = vld1q_u8_x2(p);
+        uint8x16x2_t a1 = vld1q_u8_x2(p + size - 0x20);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(a0.val[0], value16);
+        uint8x16_t b1 = vceqq_u8(a0.val[1], value16);
+        uint8x16_t b2 = vceqq_u8(a1.val[0], value16);
+        uint8x16_t b3 = vceqq_u8(a1.val[1], value16);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vandq_u8(b0, index4);
+        uint8x16_t m1 = vandq_u8(b1, index4);
+        uint8x16_t m2 = vandq_u8(b2, index4);
+        uint8x16_t m3 = vandq_u8(b3, index4);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+        // extract 64-bit index mask
+        uint64_t m = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+        if (m == 0)
+        {
+            return total;
+        }
+
+        // get index of last byte that matches input value
+        size_t index = MEM_BSR64(m);
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 32) ? index : (index - 32) + (size - 32);
+        index += (index >= 32) * (size - 64);
+
+        return index;
+    }
+    else if (size & 16) // 16 <= size < 32
+    {
+        // load 32 bytes, some will overlap
+        uint8x16_t a0 = vld1q_u8(p);
+        uint8x16_t a1 = vld1q_u8(p + size - 0x10);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(a0, value16);
+        uint8x16_t b1 = vceqq_u8(a1, value16);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vandq_u8(b0, index4);
+        uint8x16_t m1 = vandq_u8(b1, index4);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(m0, m1);
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+        uint8x16_t s3 = vpaddq_u8(s2, s2);
+
+        // extract 32-bit index mask
+        uint32_t m = vgetq_lane_u32(vreinterpretq_u32_u8(s3), 0);
+        if (m == 0)
+        {
+            return total;
+        }
+
+        // get index of last byte that matches input value
+        size_t index = MEM_BSR32(m);
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 16) ? index : (index - 16) + (size - 16);
+        index += (index >= 16) * (size - 32);
+
+        return index;
+    }
+    else if (size) // 0 < size < 16, but initially size > 16
+    {
+        // load 16 bytes from beginning of buffer
+        // this will load previously checked bytes in 64 byte loop (they did not match input value)
+        uint8x16_t a = vld1q_u8(p);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b = vceqq_u8(a, value16);
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // get index of last byte that matches input value
+        return nibbles ? MEM_BSR64(nibbles) / 4 : total;
+    }
+
+    // no input value found
+    return total;
+}
+
+MEM_DISABLE_ASAN
+size_t MemFindLastNot_neon(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    const uint8x16_t value16 = vdupq_n_u8(value);
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 16)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
+
+        // will load before the beginning buffer (16-byte aligned) if end is too close
+        // to 16-byte boundary, otherwise will load past the end of buffer
+        uint8x16_t a = vld1q_u8(p - extra);
+
+        // set lane to 0x00 if lane matches input value, or 0xff if not
+        uint8x16_t b = vmvnq_u8(vceqq_u8(a, value16));
+
+        // nibbles will contain 16 masks with 4-bit value 0xf for lanes not matching input value
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        nibbles >>= (4 * extra);
+
+        // mask out any high bits (due to load past end of buffer)
+        nibbles &= ~0ULL >> (64 - 4 * size);
+
+        // for non-zero nibble find last bit set, which will be index of last byte not matching input value
+        return nibbles ? MEM_BSR64(nibbles) / 4 : size;
+    }
+
+    const uint8x16_t index4 = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201));
+
+    // remember original size to return when all bytes are same as input value
+    const size_t total = size;
+
+    // process 64-byte blocks from the end of buffer as much as possible
+    while (size >= 64)
+    {
+        size -= 64;
+
+        uint8x16x4_t a = vld1q_u8_x4(p + size);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(a.val[0], value16);
+        uint8x16_t b1 = vceqq_u8(a.val[1], value16);
+        uint8x16_t b2 = vceqq_u8(a.val[2], value16);
+        uint8x16_t b3 = vceqq_u8(a.val[3], value16);
+
+        // combine comparisons - leave 0xff in lanes that were not matching in at least one of inputs
+        uint8x16_t b = vmvnq_u8(vandq_u8(vandq_u8(b0, b1), vandq_u8(b2, b3)));
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        if (nibbles)
+        {
+            // comparisons to bit index masks
+            uint8x16_t m0 = vbicq_u8(index4, b0);
+            uint8x16_t m1 = vbicq_u8(index4, b1);
+            uint8x16_t m2 = vbicq_u8(index4, b2);
+            uint8x16_t m3 = vbicq_u8(index4, b3);
+
+            // sum pairs of masks, so result fits into 64-bit low lane
+            uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+            uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+            // extract 64-bit index mask
+            uint64_t s3 = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+            // get index for last byte position that does not match input value
+            return size + MEM_BSR64(s3);
+        }
+    }
+
+    if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap
+        uint8x16x2_t a0 = vld1q_u8_x2(p);
+        uint8x16x2_t a1 = vld1q_u8_x2(p + size - 0x20);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(a0.val[0], value16);
+        uint8x16_t b1 = vceqq_u8(a0.val[1], value16);
+        uint8x16_t b2 = vceqq_u8(a1.val[0], value16);
+        uint8x16_t b3 = vceqq_u8(a1.val[1], value16);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vbicq_u8(index4, b0);
+        uint8x16_t m1 = vbicq_u8(index4, b1);
+        uint8x16_t m2 = vbicq_u8(index4, b2);
+        uint8x16_t m3 = vbicq_u8(index4, b3);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+        // extract 64-bit index mask
+        uint64_t m = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+        if (m == 0)
+        {
+            return total;
+        }
+
+        // get index of last byte that does not match input value
+        size_t index = MEM_BSR64(m);
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 32) ? index : (index - 32) + (size - 32);
+        index += (index >= 32) * (size - 64);
+
+        return index;
+    }
+    else if (size & 16) // 16 <= size < 32
+    {
+        // load 32 bytes, some will overlap
+        uint8x16_t a0 = vld1q_u8(p);
+        uint8x16_t a1 = vld1q_u8(p + size - 0x10);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(a0, value16);
+        uint8x16_t b1 = vceqq_u8(a1, value16);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vbicq_u8(index4, b0);
+        uint8x16_t m1 = vbicq_u8(index4, b1);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(m0, m1);
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+        uint8x16_t s3 = vpaddq_u8(s2, s2);
+
+        // extract 32-bit index mask
+        uint32_t m = vgetq_lane_u32(vreinterpretq_u32_u8(s3), 0);
+        if (m == 0)
+        {
+            return total;
+        }
+
+        // get index of last byte that does not match input value
+        size_t index = MEM_BSR32(m);
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 16) ? index : (index - 16) + (size - 16);
+        index += (index >= 16) * (size - 32);
+
+        return index;
+    }
+    else if (size) // 0 < size < 16, but initially size > 16
+    {
+        // load 16 bytes from beginning of buffer
+        // this will load previously checked bytes in 64 byte loop (they did match input value)
+        uint8x16_t a = vld1q_u8(p);
+
+        // set lane to 0x00 if lane matches input value, or 0xff if not
+        uint8x16_t b = vmvnq_u8(vceqq_u8(a, value16));
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // get index of last byte that does not match input value
+        return nibbles ? MEM_BSR64(nibbles) / 4 : total;
+    }
+
+    // all bytes are same as input value
+    return total;
+}
+
+MEM_DISABLE_ASAN
+static MEM_FORCE_INLINE uint8x16_t MemFindAnyMatch_neon(uint8x16_t a, uint8x16_t c0, uint8x16_t c1, uint8x16_t c2, int table)
+{
+    if (!table)
+    {
+        // set lane to 0xff if lane matches any of input values, or 0x00 if not
+        uint8x16_t r0 = vceqq_u8(a, c0);
+        uint8x16_t r1 = vceqq_u8(a, c1);
+        uint8x16_t r2 = vceqq_u8(a, c2);
+        return vorrq_u8(vorrq_u8(r0, r1), r2);
+    }
+
+    // c0/c1 contain 256-bit bitmap of set, one byte for every 8 values
+    uint8x16x2_t bitmap;
+    bitmap.val[0] = c0;
+    bitmap.val[1] = c1;
+
+    // load bitmap byte for (value >> 3) and check (value & 7) bit in it
+    uint8x16_t row = vqtbl2q_u8(bitmap, vshrq_n_u8(a, 3));
+    uint8x16_t bit = vshlq_u8(vdupq_n_u8(1), vreinterpretq_s8_u8(vandq_u8(a, vdupq_n_u8(7))));
+
+    // set lane to 0xff if bit for byte value is set
+    return vtstq_u8(row, bit);
+}
+
+MEM_DISABLE_ASAN
+static MEM_FORCE_INLINE size_t MemFindAnyLoop_neon(const uint8_t* p, size_t size, uint8x16_t c0, uint8x16_t c1, uint8x16_t c2, int table)
+{
+    if (size <= 16)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
+
+        // will load before the beginning buffer (16-byte aligned) if end is too close
+        // to 16-byte boundary, otherwise will load past the end of buffer
+        uint8x16_t a = vld1q_u8(p - extra);
+
+        // set lane to 0xff if lane matches any of input values, or 0x00 if not
+        uint8x16_t b = MemFindAnyMatch_neon(a, c0, c1, c2, table);
+
+        // nibbles will contain 16 masks with 4-bit value 0xf for matching lanes
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        nibbles >>= (4 * extra);
+
+        // for non-zero nibble find first bit set, which will be index of first byte matching any of input values
+        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+
+        // mask out any high bits (due to load past end of buffer)
+        return index < size ? index : size;
+    }
+
+    size_t offset = 0;
+
+    // process 32-byte blocks as much as possible
+    while (size >= 32)
+    {
+        uint8x16x2_t a = vld1q_u8_x2(p);
+
+        uint8x16_t b0 = MemFindAnyMatch_neon(a.val[0], c0, c1, c2, table);
+        uint8x16_t b1 = MemFindAnyMatch_neon(a.val[1], c0, c1, c2, table);
+
+        // combine comparisons and extract 4-bit nibble mask
+        uint8x16_t b = vorrq_u8(b0, b1);
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        if (nibbles)
+        {
+            // exact nibble masks for each half
+            uint64_t n0 = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(b0), 4)), 0);
+            uint64_t n1 = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(b1), 4)), 0);
+
+            // get index for byte position that matches any of input values
+            return offset + (n0 ? MEM_CTZ64(n0) / 4 : 16 + MEM_CTZ64(n1) / 4);
+        }
+
+        offset += 32;
+        size -= 32;
+        p += 32;
+    }
+
+    if (size & 16) // 16 <= size < 32
+    {
+        uint8x16_t a = vld1q_u8(p);
+        uint8x16_t b = MemFindAnyMatch_neon(a, c0, c1, c2, table);
+
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        if (nibbles)
+        {
+            return offset + MEM_CTZ64(nibbles) / 4;
+        }
+
+        offset += 16;
+        size -= 16;
+        p += 16;
+    }
+
+    if (size) // 0 < size < 16, but initially size > 16
+    {
+        // load 16 bytes from end of buffer
+        // this will load previously checked bytes (they did not match input values)
+        uint8x16_t a = vld1q_u8(p + size - 16);
+        uint8x16_t b = MemFindAnyMatch_neon(a, c0, c1, c2, table);
+
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // get index of byte that matches input values, or 16
+        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+
+        // adjust index due to reused bytes in load
+        return offset + index + size - 16;
+    }
+
+    // no input values found
+    return offset;
+}
+
+MEM_DISABLE_ASAN
+size_t MemFindAny_neon(const void* ptr, size_t size, const void* set, size_t setlen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* s = (const uint8_t*)set;
+
+    if (setlen == 0)
+    {
+        return size;
+    }
+    else if (setlen == 1)
+    {
+        return MemFind_neon(ptr, size, s[0]);
+    }
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (setlen <= 3)
+    {
+        // for 2 byte set third value is same as second one
+        uint8x16_t v0 = vdupq_n_u8(s[0]);
+        uint8x16_t v1 = vdupq_n_u8(s[1]);
+        uint8x16_t v2 = vdupq_n_u8(s[setlen - 1]);
+        return MemFindAnyLoop_neon(p, size, v0, v1, v2, 0);
+    }
+
+    // 256-bit bitmap of byte values in set
+    uint8_t bitmap[32] = { 0 };
+    for (size_t i=0; i<setlen; i++)
+    {
+        uint8_t b = s[i];
+        bitmap[b >> 3] |= (uint8_t)(1 << (b & 7));
+    }
+
+    uint8x16_t t0 = vld1q_u8(bitmap + 0x00);
+    uint8x16_t t1 = vld1q_u8(bitmap + 0x10);
+    return MemFindAnyLoop_neon(p, size, t0, t1, t1, 1);
+}
+
+MEM_DISABLE_ASAN
+static MEM_FORCE_INLINE size_t MemFindBytesCheck_neon(const uint8_t* p, const uint8_t* n, size_t nlen, uint64_t nibbles)
+{
+    // keep one bit per 4-bit nibble, first and last bytes are already matching for every nibble set
+    nibbles &= 0x8888888888888888;
+
+    // verify rest of the needle
+    while (nibbles)
+    {
+        size_t index = MEM_CTZ64(nibbles) / 4;
+        if (MemIsEqual_neon(p + index + 1, n + 1, nlen - 2))
+        {
+            return index;
+        }
+        nibbles &= nibbles - 1;
+    }
+    return 16;
+}
+
+MEM_DISABLE_ASAN
+size_t MemFindBytes_neon(const void* ptr, size_t size, const void* needle, size_t needlelen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* n = (const uint8_t*)needle;
+
+    if (needlelen == 0)
+    {
+        return 0;
+    }
+    else if (needlelen == 1)
+    {
+        return MemFind_neon(ptr, size, n[0]);
+    }
+    else if (needlelen > size)
+    {
+        return size;
+    }
+
+    // offset of last needle byte, and amount of positions where needle can start
+    size_t last = needlelen - 1;
+    size_t count = size - last;
+
+    const uint8x16_t first16 = vdupq_n_u8(n[0]);
+    const uint8x16_t last16 = vdupq_n_u8(n[last]);
+
+    if (size <= 16)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
+
+        // whole buffer fits in one load, it will load before the beginning buffer (16-byte aligned)
+        // if end is too close to 16-byte boundary, otherwise will load past the end of buffer
+        uint8x16_t a = vld1q_u8(p - extra);
+
+        // set lane to 0xff if lane matches first/last needle byte, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(a, first16);
+        uint8x16_t b1 = vceqq_u8(a, last16);
+
+        // nibbles will contain 16 masks with 4-bit value 0xf if lane matches needle byte
+        uint64_t n0 = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(b0), 4)), 0);
+        uint64_t n1 = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(b1), 4)), 0);
+
+        // drop any lowest "extra" nibbles, and shift last byte matches down to their starting position
+        n0 >>= 4 * extra;
+        n1 >>= 4 * (extra + last);
+
+        // keep only positions where whole needle fits in buffer
+        uint64_t nibbles = n0 & n1 & (~0ULL >> (64 - 4 * count));
+
+        size_t index = MemFindBytesCheck_neon(p, n, needlelen, nibbles);
+        return index < 16 ? index : size;
+    }
+
+    size_t offset = 0;
+
+    // process 16 starting positions at a time
+    while (count - offset >= 16)
+    {
+        uint8x16_t a0 = vld1q_u8(p + offset);
+        uint8x16_t a1 = vld1q_u8(p + offset + last);
+
+        // set lane to 0xff if both first and last needle bytes match, or 0x00 if not
+        uint8x16_t b = vandq_u8(vceqq_u8(a0, first16), vceqq_u8(a1, last16));
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        if (nibbles)
+        {
+            size_t index = MemFindBytesCheck_neon(p + offset, n, needlelen, nibbles);
+            if (index < 16)
+            {
+                return offset + index;
+            }
+        }
+
+        offset += 16;
+    }
+
+    if (offset < count) // 0 < tail < 16
+    {
+        size_t tail = count - offset;
+
+        // load first bytes ending at last starting position (or from beginning of buffer if there are
+        // less than 16 starting positions), and last bytes ending at end of buffer
+        // this will load previously checked positions, they will be shifted out from masks
+        size_t start = count >= 16 ? count - 16 : 0;
+        uint8x16_t a0 = vld1q_u8(p + start);
+        uint8x16_t a1 = vld1q_u8(p + size - 16);
+
+        // set lane to 0xff if lane matches first/last needle byte, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(a0, first16);
+        uint8x16_t b1 = vceqq_u8(a1, last16);
+
+        // extract 4-bit nibble masks
+        uint64_t n0 = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(b0), 4)), 0);
+        uint64_t n1 = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(b1), 4)), 0);
+
+        // align both masks to current offset, shift of last byte mask also leaves only "tail" nibbles
+        n0 >>= 4 * (offset - start);
+        n1 >>= 4 * (16 - tail);
+
+        size_t index = MemFindBytesCheck_neon(p + offset, n, needlelen, n0 & n1);
+        if (index < 16)
+        {
+            return offset + index;
+        }
+    }
+
+    // needle not found
+    return size;
+}
+
+MEM_DISABLE_ASAN
+size_t MemCount_neon(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    const uint8x16_t value16 = vdupq_n_u8(value);
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 16)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
+
+        // will load before the beginning buffer (16-byte aligned) if end is too close
+        // to 16-byte boundary, otherwise will load past the end of buffer
+        uint8x16_t a = vld1q_u8(p - extra);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b = vceqq_u8(a, value16);
+
+        // nibbles will contain 16 masks with 4-bit value 0xf if lane matches input value
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        nibbles >>= (4 * extra);
+
+        // mask out any high bits (due to load past end of buffer)
+        nibbles &= ~0ULL >> (64 - 4 * size);
+
+        return MEM_POPCNT64(nibbles) / 4;
+    }
+
+    size_t result = 0;
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        // every block adds at most 4 to byte lane counters, so they can accumulate 63 blocks before overflowing
+        size_t count = size / 64 < 63 ? size / 64 : 63;
+
+        uint8x16_t sum = vdupq_n_u8(0);
+        for (size_t i=0; i<count; i++)
+        {
+            uint8x16x4_t a = vld1q_u8_x4(p);
+
+            // set lane to 0xff (-1) if lane matches input value, or 0x00 if not
+            uint8x16_t b0 = vceqq_u8(a.val[0], value16);
+            uint8x16_t b1 = vceqq_u8(a.val[1], value16);
+            uint8x16_t b2 = vceqq_u8(a.val[2], value16);
+            uint8x16_t b3 = vceqq_u8(a.val[3], value16);
+
+            // subtracting -1 increments byte lane counter
+            uint8x16_t s01 = vaddq_u8(b0, b1);
+            uint8x16_t s23 = vaddq_u8(b2, b3);
+            sum = vsubq_u8(sum, vaddq_u8(s01, s23));
+
+            p += 64;
+        }
+
+        // horizontal sum of byte lane counters, at most 16*252 which fits in 16 bits
+        result += vaddlvq_u8(sum);
+
+        size -= count * 64;
+    }
+
+    // process rest of 16-byte blocks, at most 3
+    {
+        uint8x16_t sum = vdupq_n_u8(0);
+        while (size >= 16)
+        {
+            uint8x16_t a = vld1q_u8(p);
+
+            // subtracting -1 increments byte lane counter
+            sum = vsubq_u8(sum, vceqq_u8(a, value16));
+
+            p += 16;
+            size -= 16;
+        }
+        result += vaddlvq_u8(sum);
+    }
+
+    if (size) // 0 < size < 16, but initially size > 16
+    {
+        // load 16 bytes from end of buffer
+        uint8x16_t a = vld1q_u8(p + size - 16);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b = vceqq_u8(a, value16);
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // drop lowest nibbles for bytes that were already counted
+        nibbles >>= 4 * (16 - size);
+
+        result += MEM_POPCNT64(nibbles) / 4;
+    }
+
+    return result;
+}
+
+MEM_DISABLE_ASAN
+size_t MemMismatch_neon(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 16)
+    {
+        // cannot overread buffers, need to load exactly "size" bytes only
+        return MemMismatchSmall(p1, p2, size);
+    }
+
+    const uint8x16_t index4 = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201));
+
+    size_t offset = 0;
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        uint8x16x4_t a = vld1q_u8_x4(p1);
+        uint8x16x4_t v = vld1q_u8_x4(p2);
+
+        // set lane to 0xff if bytes are equal, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(a.val[0], v.val[0]);
+        uint8x16_t b1 = vceqq_u8(a.val[1], v.val[1]);
+        uint8x16_t b2 = vceqq_u8(a.val[2], v.val[2]);
+        uint8x16_t b3 = vceqq_u8(a.val[3], v.val[3]);
+
+        // combine comparisons - leave 0xff in lanes that were not equal in at least one of inputs
+        uint8x16_t b = vmvnq_u8(vandq_u8(vandq_u8(b0, b1), vandq_u8(b2, b3)));
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        if (nibbles)
+        {
+            // comparisons to bit index masks
+            uint8x16_t m0 = vbicq_u8(index4, b0);
+            uint8x16_t m1 = vbicq_u8(index4, b1);
+            uint8x16_t m2 = vbicq_u8(index4, b2);
+            uint8x16_t m3 = vbicq_u8(index4, b3);
+
+            // sum pairs of masks, so result fits into 64-bit low lane
+            uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+            uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+            // extract 64-bit index mask
+            uint64_t s3 = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+            // get index for byte position that's different
+            return offset + MEM_CTZ64(s3);
+        }
+
+        offset += 64;
+        size -= 64;
+        p1 += 64;
+        p2 += 64;
+    }
+
+    if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap
+        uint8x16x2_t a0 = vld1q_u8_x2(p1);
+        uint8x16x2_t v0 = vld1q_u8_x2(p2);
+        uint8x16x2_t a1 = vld1q_u8_x2(p1 + size - 0x20);
+        uint8x16x2_t v1 = vld1q_u8_x2(p2 + size - 0x20);
+
+        // set lane to 0xff if bytes are equal, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(a0.val[0], v0.val[0]);
+        uint8x16_t b1 = vceqq_u8(a0.val[1], v0.val[1]);
+        uint8x16_t b2 = vceqq_u8(a1.val[0], v1.val[0]);
+        uint8x16_t b3 = vceqq_u8(a1.val[1], v1.val[1]);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vbicq_u8(index4, b0);
+        uint8x16_t m1 = vbicq_u8(index4, b1);
+        uint8x16_t m2 = vbicq_u8(index4, b2);
+        uint8x16_t m3 = vbicq_u8(index4, b3);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+        // extract 64-bit index mask
+        uint64_t m = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+        // get index of byte that is different, or 64
+        size_t index = m ? MEM_CTZ64(m) : 64;
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 32) ? index : (index - 32) + (size - 32);
+        index += (index >= 32) * (size - 64);
+
+        return offset + index;
+    }
+    else if (size & 16) // 16 <= size < 32
+    {
+        // load 32 bytes, some will overlap
+        uint8x16_t a0 = vld1q_u8(p1);
+        uint8x16_t v0 = vld1q_u8(p2);
+        uint8x16_t a1 = vld1q_u8(p1 + size - 0x10);
+        uint8x16_t v1 = vld1q_u8(p2 + size - 0x10);
+
+        // set lane to 0xff if bytes are equal, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(a0, v0);
+        uint8x16_t b1 = vceqq_u8(a1, v1);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vbicq_u8(index4, b0);
+        uint8x16_t m1 = vbicq_u8(index4, b1);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(m0, m1);
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+        uint8x16_t s3 = vpaddq_u8(s2, s2);
+
+        // extract 64-bit index mask
+        uint32_t m = vgetq_lane_u32(vreinterpretq_u32_u8(s3), 0);
+
+        // get index of byte that is different, or 32
+        size_t index = m ? MEM_CTZ32(m) : 32;
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 16) ? index : (index - 16) + (size - 16);
+        index += (index >= 16) * (size - 32);
+
+        return offset + index;
+    }
+    else if (size) // 0 < size < 16, but initially size > 16
+    {
+        // load 16 bytes from end of buffer
+        // this will load previously checked bytes in 64 byte loop (they were equal)
+        uint8x16_t a = vld1q_u8(p1 + size - 16);
+        uint8x16_t v = vld1q_u8(p2 + size - 16);
+
+        // set lane to 0x00 if bytes are equal, or 0xff if not
+        uint8x16_t b = vmvnq_u8(vceqq_u8(a, v));
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // get index of byte that is different, or 16
+        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+
+        // adjust index due to reused bytes in load
+        return offset + index + size - 16;
+    }
+
+    // no differences found, return original size (current offset plus pending tail size)
+    return offset + size;
+}
+
+MEM_DISABLE_ASAN
+static MEM_FORCE_INLINE void MemConvertCase_neon(uint8_t* dst, const uint8_t* src, size_t size, uint8_t first)
+{
+    if (size < 16)
+    {
+        MemConvertCaseSmall(dst, src, size, first);
+        return;
+    }
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        uint8x16x4_t a = vld1q_u8_x4(src);
+
+        a.val[0] = MemConvertCase16(a.val[0], first);
+        a.val[1] = MemConvertCase16(a.val[1], first);
+        a.val[2] = MemConvertCase16(a.val[2], first);
+        a.val[3] = MemConvertCase16(a.val[3], first);
+
+        vst1q_u8_x4(dst, a);
+
+        size -= 64;
+        src += 64;
+        dst += 64;
+    }
+
+    // process 16-byte blocks
+    while (size >= 16)
+    {
+        uint8x16_t a = vld1q_u8(src);
+        vst1q_u8(dst, MemConvertCase16(a, first));
+
+        size -= 16;
+        src += 16;
+        dst += 16;
+    }
+
+    if (size) // 0 < size < 16, but initially size >= 16
+    {
+        // convert last 16 bytes, this will convert again some of already converted bytes
+        // which is fine, because converting letters to same case twice gives same result
+        uint8x16_t a = vld1q_u8(src + size - 16);
+        vst1q_u8(dst + size - 16, MemConvertCase16(a, first));
+    }
+}
+
+MEM_DISABLE_ASAN
+void MemToLower_neon(void* dst, const void* src, size_t size)
+{
+    MemConvertCase_neon((uint8_t*)dst, (const uint8_t*)src, size, 'A');
+}
+
+MEM_DISABLE_ASAN
+void MemToUpper_neon(void* dst, const void* src, size_t size)
+{
+    MemConvertCase_neon((uint8_t*)dst, (const uint8_t*)src, size, 'a');
+}
+
+MEM_DISABLE_ASAN
+size_t MemFindI_neon(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    // letters are matched by setting 0x20 bit in input bytes, which maps uppercase letters to lowercase
+    const uint8_t fold = MemCaseBit1(value);
+    const uint8x16_t fold16 = vdupq_n_u8(fold);
+    const uint8x16_t value16 = vdupq_n_u8(value | fold);
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 16)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
+
+        // will load before the beginning buffer (16-byte aligned) if end is too close
+        // to 16-byte boundary, otherwise will load past the end of buffer
+        uint8x16_t a = vld1q_u8(p - extra);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b = vceqq_u8(vorrq_u8(a, fold16), value16);
+
+        // nibbles will contain 16 masks with 4-bit value 0xf if lane matches input value
+        // if there is one lane that was not equal, mask contains 0x0
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        nibbles >>= (4 * extra);
+
+        // for non-zero nibble find first bit set, which will be index of first byte matching input value
+        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+
+        // mask out any high bits (due to load past end of buffer)
+        return index < size ? index : size;
+    }
+
+    const uint8x16_t index4 = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201));
+
+    size_t offset = 0;
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        uint8x16x4_t a = vld1q_u8_x4(p);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(vorrq_u8(a.val[0], fold16), value16);
+        uint8x16_t b1 = vceqq_u8(vorrq_u8(a.val[1], fold16), value16);
+        uint8x16_t b2 = vceqq_u8(vorrq_u8(a.val[2], fold16), value16);
+        uint8x16_t b3 = vceqq_u8(vorrq_u8(a.val[3], fold16), value16);
+
+        // combine comparisons - leave 0xff in lanes there equal to input value
+        uint8x16_t b01 = vorrq_u8(b0, b1);
+        uint8x16_t b23 = vorrq_u8(b2, b3);
+#if defined(__clang__)
+        // without this clang 19+ generates worse code (runs slower)
+        __asm__ __volatile__("" : "+w"(b01), "+w"(b23));
+#endif
+        uint8x16_t b = vorrq_u8(b01, b23);
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        if (nibbles)
+        {
+            // comparisons to bit index masks
+            uint8x16_t m0 = vandq_u8(b0, index4);
+            uint8x16_t m1 = vandq_u8(b1, index4);
+            uint8x16_t m2 = vandq_u8(b2, index4);
+            uint8x16_t m3 = vandq_u8(b3, index4);
+
+            // sum pairs of masks, so result fits into 64-bit low lane
+            uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+            uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+            // extract 64-bit index mask
+            uint64_t s3 = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+            // get index for byte position that matches input value
+            return offset + MEM_CTZ64(s3);
+        }
+
+        offset += 64;
+        size -= 64;
+        p += 64;
+    }
+
+    if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap
+        uint8x16x2_t a0 = vld1q_u8_x2(p);
+        uint8x16x2_t a1 = vld1q_u8_x2(p + size - 0x20);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(vorrq_u8(a0.val[0], fold16), value16);
+        uint8x16_t b1 = vceqq_u8(vorrq_u8(a0.val[1], fold16), value16);
+        uint8x16_t b2 = vceqq_u8(vorrq_u8(a1.val[0], fold16), value16);
+        uint8x16_t b3 = vceqq_u8(vorrq_u8(a1.val[1], fold16), value16);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vandq_u8(b0, index4);
+        uint8x16_t m1 = vandq_u8(b1, index4);
+        uint8x16_t m2 = vandq_u8(b2, index4);
+        uint8x16_t m3 = vandq_u8(b3, index4);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+        // extract 64-bit index mask
+        uint64_t m = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+        // get index of byte that matches input value, or 64
+        size_t index = m ? MEM_CTZ64(m) : 64;
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 32) ? index : (index - 32) + (size - 32);
+        index += (index >= 32) * (size - 64);
+
+        return offset + index;
+    }
+    else if (size & 16) // 16 <= size < 32
+    {
+        // load 32 bytes, some will overlap
+        uint8x16_t a0 = vld1q_u8(p);
+        uint8x16_t a1 = vld1q_u8(p + size - 0x10);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(vorrq_u8(a0, fold16), value16);
+        uint8x16_t b1 = vceqq_u8(vorrq_u8(a1, fold16), value16);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vandq_u8(b0, index4);
+        uint8x16_t m1 = vandq_u8(b1, index4);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(m0, m1);
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+        uint8x16_t s3 = vpaddq_u8(s2, s2);
+
+        // extract 64-bit index mask
+        uint32_t m = vgetq_lane_u32(vreinterpretq_u32_u8(s3), 0);
+
+        // get index of byte that matches input value, or 32
+        size_t index = m ? MEM_CTZ32(m) : 32;
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 16) ? index : (index - 16) + (size - 16);
+        index += (index >= 16) * (size - 32);
+
+        return offset + index;
+    }
+    else if (size) // 0 < size < 16, but initially size > 16
+    {
+        // load 32 bytes from end of buffer
+        // this will load previously checked bytes in 64 byte loop (they did not match input value)
+        uint8x16_t a = vld1q_u8(p + size - 16);
+
+        // set lane to 0xff if lane matches input value, or 0x00 if not
+        uint8x16_t b = vceqq_u8(vorrq_u8(a, fold16), value16);
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // get index of byte that matches input value, or 16
+        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+
+        // adjust index due to reused bytes in load
+        return offset + index + size - 16;
+    }
+
+    // no input value found, return original size (current offset plus pending tail size)
+    return offset + size;
+}
+
+MEM_DISABLE_ASAN
+static MEM_FORCE_INLINE size_t MemFindBytesICheck_neon(const uint8_t* p, const uint8_t* n, size_t nlen, uint64_t nibbles)
+{
+    // keep one bit per 4-bit nibble, first and last bytes are already matching for every nibble set
+    nibbles &= 0x8888888888888888;
+
+    // verify rest of the needle
+    while (nibbles)
+    {
+        size_t index = MEM_CTZ64(nibbles) / 4;
+        if (MemCompareI_neon(p + index + 1, n + 1, nlen - 2) == 0)
+        {
+            return index;
+        }
+        nibbles &= nibbles - 1;
+    }
+    return 16;
+}
+
+MEM_DISABLE_ASAN
+size_t MemFindBytesI_neon(const void* ptr, size_t size, const void* needle, size_t needlelen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* n = (const uint8_t*)needle;
+
+    if (needlelen == 0)
+    {
+        return 0;
+    }
+    else if (needlelen == 1)
+    {
+        return MemFindI_neon(ptr, size, n[0]);
+    }
+    else if (needlelen > size)
+    {
+        return size;
+    }
+
+    // offset of last needle byte, and amount of positions where needle can start
+    size_t last = needlelen - 1;
+    size_t count = size - last;
+
+    // letters are matched by setting 0x20 bit in input bytes, which maps uppercase letters to lowercase
+    const uint8_t first_fold = MemCaseBit1(n[0]);
+    const uint8_t last_fold = MemCaseBit1(n[last]);
+
+    const uint8x16_t first_fold16 = vdupq_n_u8(first_fold);
+    const uint8x16_t last_fold16 = vdupq_n_u8(last_fold);
+    const uint8x16_t first16 = vdupq_n_u8(n[0] | first_fold);
+    const uint8x16_t last16 = vdupq_n_u8(n[last] | last_fold);
+
+    if (size <= 16)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
+
+        // whole buffer fits in one load, it will load before the beginning buffer (16-byte aligned)
+        // if end is too close to 16-byte boundary, otherwise will load past the end of buffer
+        uint8x16_t a = vld1q_u8(p - extra);
+
+        // set lane to 0xff if lane matches first/last needle byte, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(vorrq_u8(a, first_fold16), first16);
+        uint8x16_t b1 = vceqq_u8(vorrq_u8(a, last_fold16), last16);
+
+        // nibbles will contain 16 masks with 4-bit value 0xf if lane matches needle byte
+        uint64_t n0 = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(b0), 4)), 0);
+        uint64_t n1 = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(b1), 4)), 0);
+
+        // drop any lowest "extra" nibbles, and shift last byte matches down to their starting position
+        n0 >>= 4 * extra;
+        n1 >>= 4 * (extra + last);
+
+        // keep only positions where whole needle fits in buffer
+        uint64_t nibbles = n0 & n1 & (~0ULL >> (64 - 4 * count));
+
+        size_t index = MemFindBytesICheck_neon(p, n, needlelen, nibbles);
+        return index < 16 ? index : size;
+    }
+
+    size_t offset = 0;
+
+    // process 16 starting positions at a time
+    while (count - offset >= 16)
+    {
+        uint8x16_t a0 = vld1q_u8(p + offset);
+        uint8x16_t a1 = vld1q_u8(p + offset + last);
+
+        // set lane to 0xff if both first and last needle bytes match, or 0x00 if not
+        uint8x16_t b = vandq_u8(vceqq_u8(vorrq_u8(a0, first_fold16), first16), vceqq_u8(vorrq_u8(a1, last_fold16), last16));
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        if (nibbles)
+        {
+            size_t index = MemFindBytesICheck_neon(p + offset, n, needlelen, nibbles);
+            if (index < 16)
+            {
+                return offset + index;
+            }
+        }
+
+        offset += 16;
+    }
+
+    if (offset < count) // 0 < tail < 16
+    {
+        size_t tail = count - offset;
+
+        // load first bytes ending at last starting position (or from beginning of buffer if there are
+        // less than 16 starting positions), and last bytes ending at end of buffer
+        // this will load previously checked positions, they will be shifted out from masks
+        size_t start = count >= 16 ? count - 16 : 0;
+        uint8x16_t a0 = vld1q_u8(p + start);
+        uint8x16_t a1 = vld1q_u8(p + size - 16);
+
+        // set lane to 0xff if lane matches first/last needle byte, or 0x00 if not
+        uint8x16_t b0 = vceqq_u8(vorrq_u8(a0, first_fold16), first16);
+        uint8x16_t b1 = vceqq_u8(vorrq_u8(a1, last_fold16), last16);
+
+        // extract 4-bit nibble masks
+        uint64_t n0 = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(b0), 4)), 0);
+        uint64_t n1 = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(b1), 4)), 0);
+
+        // align both masks to current offset, shift of last byte mask also leaves only "tail" nibbles
+        n0 >>= 4 * (offset - start);
+        n1 >>= 4 * (16 - tail);
+
+        size_t index = MemFindBytesICheck_neon(p + offset, n, needlelen, n0 & n1);
+        if (index < 16)
+        {
+            return offset + index;
+        }
+    }
+
+    // needle not found
+    return size;
+}
+
+MEM_DISABLE_ASAN
+size_t MemFindInRange_neon(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (lo > hi)
+    {
+        // empty range, no byte can be inside it
+        return size;
+    }
+
+    // byte is inside range when unsigned (x - lo) <= (hi - lo)
+    const uint8_t range = (uint8_t)(hi - lo);
+
+    const uint8x16_t lo16 = vdupq_n_u8(lo);
+    const uint8x16_t range16 = vdupq_n_u8(range);
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 16)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
+
+        // will load before the beginning buffer (16-byte aligned) if end is too close
+        // to 16-byte boundary, otherwise will load past the end of buffer
+        uint8x16_t a = vld1q_u8(p - extra);
+
+        // set lane to 0x00 if lane is outside of range, or 0xff if not
+        uint8x16_t b = vmvnq_u8(vcgtq_u8(vsubq_u8(a, lo16), range16));
+
+        // nibbles will contain 16 masks with 4-bit value 0x0 if lane is outside of range
+        // if there is one lane inside range, it contains 0xf
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        nibbles >>= (4 * extra);
+
+        // for non-zero nibble find first bit set, which will be index of first byte inside range
+        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+
+        // mask out any high bits (due to load past end of buffer)
+        return index < size ? index : size;
+    }
+
+    const uint8x16_t index4 = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201));
+
+    size_t offset = 0;
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        uint8x16x4_t a = vld1q_u8_x4(p);
+
+        // set lane to 0xff if lane is outside of range, or 0x00 if not
+        uint8x16_t b0 = vcgtq_u8(vsubq_u8(a.val[0], lo16), range16);
+        uint8x16_t b1 = vcgtq_u8(vsubq_u8(a.val[1], lo16), range16);
+        uint8x16_t b2 = vcgtq_u8(vsubq_u8(a.val[2], lo16), range16);
+        uint8x16_t b3 = vcgtq_u8(vsubq_u8(a.val[3], lo16), range16);
+
+        // combine comparisons - leave 0xff in lanes that were inside range in at least one of inputs
+        uint8x16_t b = vmvnq_u8(vandq_u8(vandq_u8(b0, b1), vandq_u8(b2, b3)));
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        if (nibbles)
+        {
+            // comparisons to bit index masks
+            uint8x16_t m0 = vbicq_u8(index4, b0);
+            uint8x16_t m1 = vbicq_u8(index4, b1);
+            uint8x16_t m2 = vbicq_u8(index4, b2);
+            uint8x16_t m3 = vbicq_u8(index4, b3);
+
+            // sum pairs of masks, so result fits into 64-bit low lane
+            uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+            uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+            // extract 64-bit index mask
+            uint64_t s3 = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+            // get index for byte position that's inside range
+            return offset + MEM_CTZ64(s3);
+        }
+
+        offset += 64;
+        size -= 64;
+        p += 64;
+    }
+
+    if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap
+        uint8x16x2_t a0 = vld1q_u8_x2(p);
+        uint8x16x2_t a1 = vld1q_u8_x2(p + size - 0x20);
+
+        // set lane to 0xff if lane is outside of range, or 0x00 if not
+        uint8x16_t b0 = vcgtq_u8(vsubq_u8(a0.val[0], lo16), range16);
+        uint8x16_t b1 = vcgtq_u8(vsubq_u8(a0.val[1], lo16), range16);
+        uint8x16_t b2 = vcgtq_u8(vsubq_u8(a1.val[0], lo16), range16);
+        uint8x16_t b3 = vcgtq_u8(vsubq_u8(a1.val[1], lo16), range16);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vbicq_u8(index4, b0);
+        uint8x16_t m1 = vbicq_u8(index4, b1);
+        uint8x16_t m2 = vbicq_u8(index4, b2);
+        uint8x16_t m3 = vbicq_u8(index4, b3);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+        // extract 64-bit index mask
+        uint64_t m = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+        // get index of byte that is inside range, or 64
+        size_t index = m ? MEM_CTZ64(m) : 64;
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 32) ? index : (index - 32) + (size - 32);
+        index += (index >= 32) * (size - 64);
+
+        return offset + index;
+    }
+    else if (size & 16) // 16 <= size < 32
+    {
+        // load 32 bytes, some will overlap
+        uint8x16_t a0 = vld1q_u8(p);
+        uint8x16_t a1 = vld1q_u8(p + size - 0x10);
+
+        // set lane to 0xff if lane is outside of range, or 0x00 if not
+        uint8x16_t b0 = vcgtq_u8(vsubq_u8(a0, lo16), range16);
+        uint8x16_t b1 = vcgtq_u8(vsubq_u8(a1, lo16), range16);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vbicq_u8(index4, b0);
+        uint8x16_t m1 = vbicq_u8(index4, b1);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(m0, m1);
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+        uint8x16_t s3 = vpaddq_u8(s2, s2);
+
+        // extract 64-bit index mask
+        uint32_t m = vgetq_lane_u32(vreinterpretq_u32_u8(s3), 0);
+
+        // get index of byte that is inside range, or 32
+        size_t index = m ? MEM_CTZ32(m) : 32;
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 16) ? index : (index - 16) + (size - 16);
+        index += (index >= 16) * (size - 32);
+
+        return offset + index;
+    }
+    else if (size) // 0 < size < 16, but initially size > 16
+    {
+        // load 16 bytes from end of buffer
+        // this will load previously checked bytes in 64 byte loop (they were outside of range)
+        uint8x16_t a = vld1q_u8(p + size - 16);
+
+        // set lane to 0x00 if lane is outside of range, or 0xff if not
+        uint8x16_t b = vmvnq_u8(vcgtq_u8(vsubq_u8(a, lo16), range16));
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // get index of byte that is inside range, or 16
+        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+
+        // adjust index due to reused bytes in load
+        return offset + index + size - 16;
+    }
+
+    // no byte inside range found, return original size (current offset plus pending tail size)
+    return offset + size;
+}
+
+MEM_DISABLE_ASAN
+size_t MemFindNotInRange_neon(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (lo > hi)
+    {
+        // empty range, every byte is outside of it
+        return 0;
+    }
+
+    // byte is inside range when unsigned (x - lo) <= (hi - lo)
+    const uint8_t range = (uint8_t)(hi - lo);
+
+    const uint8x16_t lo16 = vdupq_n_u8(lo);
+    const uint8x16_t range16 = vdupq_n_u8(range);
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size <= 16)
+    {
+        size_t address = (uint32_t)(uintptr_t)p % 16;
+        size_t extra = (address + size) <= 16 ? address : 0;
+
+        // will load before the beginning buffer (16-byte aligned) if end is too close
+        // to 16-byte boundary, otherwise will load past the end of buffer
+        uint8x16_t a = vld1q_u8(p - extra);
+
+        // set lane to 0xff if lane is outside of range, or 0x00 if not
+        uint8x16_t b = vcgtq_u8(vsubq_u8(a, lo16), range16);
+
+        // nibbles will contain 16 masks with 4-bit value 0xf if lane is outside of range
+        // if there is one lane outside of range, mask is non-zero
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // drop any lowest "extra" bits (due to loading bytes before beginning buffer)
+        nibbles >>= (4 * extra);
+
+        // for non-zero nibble find first bit set, which will be index of first byte outside of range
+        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+
+        // mask out any high bits (due to load past end of buffer)
+        return index < size ? index : size;
+    }
+
+    const uint8x16_t index4 = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201));
+
+    size_t offset = 0;
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        uint8x16x4_t a = vld1q_u8_x4(p);
+
+        // set lane to 0xff if lane is outside of range, or 0x00 if not
+        uint8x16_t b0 = vcgtq_u8(vsubq_u8(a.val[0], lo16), range16);
+        uint8x16_t b1 = vcgtq_u8(vsubq_u8(a.val[1], lo16), range16);
+        uint8x16_t b2 = vcgtq_u8(vsubq_u8(a.val[2], lo16), range16);
+        uint8x16_t b3 = vcgtq_u8(vsubq_u8(a.val[3], lo16), range16);
+
+        // combine comparisons - leave 0xff in lanes that are outside of range
+        uint8x16_t b01 = vorrq_u8(b0, b1);
+        uint8x16_t b23 = vorrq_u8(b2, b3);
+#if defined(__clang__)
+        // without this clang 19+ generates worse code (runs slower)
+        __asm__ __volatile__("" : "+w"(b01), "+w"(b23));
+#endif
+        uint8x16_t b = vorrq_u8(b01, b23);
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+        if (nibbles)
+        {
+            // comparisons to bit index masks
+            uint8x16_t m0 = vandq_u8(b0, index4);
+            uint8x16_t m1 = vandq_u8(b1, index4);
+            uint8x16_t m2 = vandq_u8(b2, index4);
+            uint8x16_t m3 = vandq_u8(b3, index4);
+
+            // sum pairs of masks, so result fits into 64-bit low lane
+            uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+            uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+            // extract 64-bit index mask
+            uint64_t s3 = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+            // get index for byte position outside of range
+            return offset + MEM_CTZ64(s3);
+        }
+
+        offset += 64;
+        size -= 64;
+        p += 64;
+    }
+
+    if (size & 32) // 32 <= size < 64
+    {
+        // load 64 bytes, some will overlap
+        uint8x16x2_t a0 = vld1q_u8_x2(p);
+        uint8x16x2_t a1 = vld1q_u8_x2(p + size - 0x20);
+
+        // set lane to 0xff if lane is outside of range, or 0x00 if not
+        uint8x16_t b0 = vcgtq_u8(vsubq_u8(a0.val[0], lo16), range16);
+        uint8x16_t b1 = vcgtq_u8(vsubq_u8(a0.val[1], lo16), range16);
+        uint8x16_t b2 = vcgtq_u8(vsubq_u8(a1.val[0], lo16), range16);
+        uint8x16_t b3 = vcgtq_u8(vsubq_u8(a1.val[1], lo16), range16);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vandq_u8(b0, index4);
+        uint8x16_t m1 = vandq_u8(b1, index4);
+        uint8x16_t m2 = vandq_u8(b2, index4);
+        uint8x16_t m3 = vandq_u8(b3, index4);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+
+        // extract 64-bit index mask
+        uint64_t m = vgetq_lane_u64(vreinterpretq_u64_u8(s2), 0);
+
+        // get index of byte outside of range, or 64
+        size_t index = m ? MEM_CTZ64(m) : 64;
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 32) ? index : (index - 32) + (size - 32);
+        index += (index >= 32) * (size - 64);
+
+        return offset + index;
+    }
+    else if (size & 16) // 16 <= size < 32
+    {
+        // load 32 bytes, some will overlap
+        uint8x16_t a0 = vld1q_u8(p);
+        uint8x16_t a1 = vld1q_u8(p + size - 0x10);
+
+        // set lane to 0xff if lane is outside of range, or 0x00 if not
+        uint8x16_t b0 = vcgtq_u8(vsubq_u8(a0, lo16), range16);
+        uint8x16_t b1 = vcgtq_u8(vsubq_u8(a1, lo16), range16);
+
+        // comparisons to bit index masks
+        uint8x16_t m0 = vandq_u8(b0, index4);
+        uint8x16_t m1 = vandq_u8(b1, index4);
+
+        // sum pairs of masks, so result fits into 64-bit low lane
+        uint8x16_t s1 = vpaddq_u8(m0, m1);
+        uint8x16_t s2 = vpaddq_u8(s1, s1);
+        uint8x16_t s3 = vpaddq_u8(s2, s2);
+
+        // extract 64-bit index mask
+        uint32_t m = vgetq_lane_u32(vreinterpretq_u32_u8(s3), 0);
+
+        // get index of byte outside of range, or 32
+        size_t index = m ? MEM_CTZ32(m) : 32;
+
+        // adjust index to correct byte position, due to reused bytes in load
+        // index = (index < 16) ? index : (index - 16) + (size - 16);
+        index += (index >= 16) * (size - 32);
+
+        return offset + index;
+    }
+    else if (size) // 0 < size < 16, but initially size > 16
+    {
+        // load 32 bytes from end of buffer
+        // this will load previously checked bytes in 64 byte loop (they were inside range)
+        uint8x16_t a = vld1q_u8(p + size - 16);
+
+        // set lane to 0xff if lane is outside of range, or 0x00 if not
+        uint8x16_t b = vcgtq_u8(vsubq_u8(a, lo16), range16);
+
+        // extract 4-bit nibble mask
+        uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(b), 4);
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+
+        // get index of byte outside of range, or 16
+        size_t index = (nibbles ? MEM_CTZ64(nibbles) : 64) / 4;
+
+        // adjust index due to reused bytes in load
+        return offset + index + size - 16;
+    }
+
+    // no byte outside of range found, return original size (current offset plus pending tail size)
+    return offset + size;
+}
+
+MEM_DISABLE_ASAN
+static MEM_FORCE_INLINE uint8x16_t MemValidateUTF8Check_neon(uint8x16_t a, uint8x16_t prev, uint8x16_t byte1_high, uint8x16_t byte1_low, uint8x16_t byte2_high)
+{
+    // input shifted by 1, 2 and 3 bytes, with last bytes of previous input shifted in
+    uint8x16_t prev1 = vextq_u8(prev, a, 15);
+    uint8x16_t prev2 = vextq_u8(prev, a, 14);
+    uint8x16_t prev3 = vextq_u8(prev, a, 13);
+
+    // look up error bits for both nibbles of previous byte, and high nibble of current byte
+    uint8x16_t e0 = vqtbl1q_u8(byte1_high, vshrq_n_u8(prev1, 4));
+    uint8x16_t e1 = vqtbl1q_u8(byte1_low, vandq_u8(prev1, vdupq_n_u8(0x0f)));
+    uint8x16_t e2 = vqtbl1q_u8(byte2_high, vshrq_n_u8(a, 4));
+    uint8x16_t special = vandq_u8(vandq_u8(e0, e1), e2);
+
+    // set top bit where byte must be 3rd or 4th byte of sequence, these are reported as two continuations in lookup
+    uint8x16_t third = vqsubq_u8(prev2, vdupq_n_u8(0xe0 - 0x80));
+    uint8x16_t fourth = vqsubq_u8(prev3, vdupq_n_u8(0xf0 - 0x80));
+    uint8x16_t must23 = vandq_u8(vorrq_u8(third, fourth), vdupq_n_u8(0x80));
+
+    // non-zero lanes are errors
+    return veorq_u8(must23, special);
+}
+
+MEM_DISABLE_ASAN
+size_t MemValidateUTF8_neon(const void* ptr, size_t size)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    // skip all leading ASCII bytes
+    size_t offset = MemFindInRange_neon(p, size, 0x80, 0xff);
+    size -= offset;
+    p += offset;
+
+    const uint8x16_t byte1_high = vld1q_u8(MemUTF8Byte1High);
+    const uint8x16_t byte1_low = vld1q_u8(MemUTF8Byte1Low);
+    const uint8x16_t byte2_high = vld1q_u8(MemUTF8Byte2High);
+    const uint8x16_t incomplete_max = vld1q_u8(MemUTF8Incomplete + 48);
+
+    // bytes before current block are ASCII or complete sequences
+    uint8x16_t prev = vdupq_n_u8(0);
+    uint8x16_t incomplete = vdupq_n_u8(0);
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        uint8x16x4_t a = vld1q_u8_x4(p);
+
+        uint8x16_t error;
+        if (vmaxvq_u8(vorrq_u8(vorrq_u8(a.val[0], a.val[1]), vorrq_u8(a.val[2], a.val[3]))) < 0x80)
+        {
+            // all bytes are ASCII, only error can be sequence from previous block that did not finish
+            error = incomplete;
+        }
+        else
+        {
+            uint8x16_t r0 = MemValidateUTF8Check_neon(a.val[0], prev, byte1_high, byte1_low, byte2_high);
+            uint8x16_t r1 = MemValidateUTF8Check_neon(a.val[1], a.val[0], byte1_high, byte1_low, byte2_high);
+            uint8x16_t r2 = MemValidateUTF8Check_neon(a.val[2], a.val[1], byte1_high, byte1_low, byte2_high);
+            uint8x16_t r3 = MemValidateUTF8Check_neon(a.val[3], a.val[2], byte1_high, byte1_low, byte2_high);
+            error = vorrq_u8(vorrq_u8(r0, r1), vorrq_u8(r2, r3));
+
+            // remember if block ends with sequence that must continue in next block
+            incomplete = vqsubq_u8(a.val[3], incomplete_max);
+        }
+
+        if (vmaxvq_u8(error))
+        {
+            break;
+        }
+
+        prev = a.val[3];
+        offset += 64;
+        size -= 64;
+        p += 64;
+    }
+
+    // validate remaining bytes with scalar code, this also finds exact position of error if loop above found one
+    // start from last sequence before current position, because it may continue into current block
+    size_t back = MemUTF8Back(p, offset);
+    return offset - back + MemValidateUTF8_generic(p - back, size + back);
+}
+
+// combines four 0x00/0xff lane comparison results into 64-bit mask, one bit per lane
+static MEM_FORCE_INLINE uint64_t MemClassifyMask_neon(uint8x16_t r0, uint8x16_t r1, uint8x16_t r2, uint8x16_t r3)
+{
+    static const uint8_t bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    const uint8x16_t b = vld1q_u8(bits);
+
+    // keep one different bit in each lane of 8 lanes, and then add neighbor lanes 3 times to sum 8 lanes together
+    uint8x16_t s0 = vpaddq_u8(vandq_u8(r0, b), vandq_u8(r1, b));
+    uint8x16_t s1 = vpaddq_u8(vandq_u8(r2, b), vandq_u8(r3, b));
+    uint8x16_t s = vpaddq_u8(s0, s1);
+    s = vpaddq_u8(s, s);
+
+    return vgetq_lane_u64(vreinterpretq_u64_u8(s), 0);
+}
+
+MEM_DISABLE_ASAN
+static MEM_FORCE_INLINE void MemClassifyLoop_neon(const uint8_t* p, size_t size, uint8x16_t c0, uint8x16_t c1, uint8x16_t c2, int table, uint64_t* masks)
+{
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        uint8x16x4_t a = vld1q_u8_x4(p);
+
+        uint8x16_t r0 = MemFindAnyMatch_neon(a.val[0], c0, c1, c2, table);
+        uint8x16_t r1 = MemFindAnyMatch_neon(a.val[1], c0, c1, c2, table);
+        uint8x16_t r2 = MemFindAnyMatch_neon(a.val[2], c0, c1, c2, table);
+        uint8x16_t r3 = MemFindAnyMatch_neon(a.val[3], c0, c1, c2, table);
+
+        *masks++ = MemClassifyMask_neon(r0, r1, r2, r3);
+
+        size -= 64;
+        p += 64;
+    }
+
+    if (size) // 0 < size < 64, but initially size >= 64
+    {
+        // load 64 bytes from end of buffer, this will load previously classified bytes
+        uint8x16x4_t a = vld1q_u8_x4(p + size - 64);
+
+        uint8x16_t r0 = MemFindAnyMatch_neon(a.val[0], c0, c1, c2, table);
+        uint8x16_t r1 = MemFindAnyMatch_neon(a.val[1], c0, c1, c2, table);
+        uint8x16_t r2 = MemFindAnyMatch_neon(a.val[2], c0, c1, c2, table);
+        uint8x16_t r3 = MemFindAnyMatch_neon(a.val[3], c0, c1, c2, table);
+
+        // drop bits of previously classified bytes
+        *masks = MemClassifyMask_neon(r0, r1, r2, r3) >> (64 - size);
+    }
+}
+
+MEM_DISABLE_ASAN
+void MemClassify_neon(const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* s = (const uint8_t*)set;
+
+    if (setlen == 0 || size < 64)
+    {
+        MemClassify_generic(ptr, size, set, setlen, masks);
+        return;
+    }
+
+    if (setlen <= 3)
+    {
+        // for smaller sets some values are repeated
+        uint8x16_t v0 = vdupq_n_u8(s[0]);
+        uint8x16_t v1 = vdupq_n_u8(s[setlen / 2]);
+        uint8x16_t v2 = vdupq_n_u8(s[setlen - 1]);
+        MemClassifyLoop_neon(p, size, v0, v1, v2, 0, masks);
+        return;
+    }
+
+    // 256-bit bitmap of byte values in set
+    uint8_t bitmap[32] = { 0 };
+    for (size_t i=0; i<setlen; i++)
+    {
+        uint8_t b = s[i];
+        bitmap[b >> 3] |= (uint8_t)(1 << (b & 7));
+    }
+
+    uint8x16_t t0 = vld1q_u8(bitmap + 0x00);
+    uint8x16_t t1 = vld1q_u8(bitmap + 0x10);
+    MemClassifyLoop_neon(p, size, t0, t1, t1, 1, masks);
+}
+
+// set all lanes of element to 0xff if element matches input value, or to 0x00 if not (inverted if "invert" is set)
+static MEM_FORCE_INLINE uint8x16_t MemFindWideMatch_neon(uint8x16_t a, uint8x16_t value16, size_t width, int invert)
+{
+    uint8x16_t r;
+    if (width == 2)
+    {
+        r = vreinterpretq_u8_u16(vceqq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(value16)));
+    }
+    else if (width == 4)
+    {
+        r = vreinterpretq_u8_u32(vceqq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(value16)));
+    }
+    else
+    {
+        r = vreinterpretq_u8_u64(vceqq_u64(vreinterpretq_u64_u8(a), vreinterpretq_u64_u8(value16)));
+    }
+    return invert ? vmvnq_u8(r) : r;
+}
+
+// returns 4-bit nibble mask with 0xf for every byte lane set to 0xff
+static MEM_FORCE_INLINE uint64_t MemFindWideNibbles_neon(uint8x16_t r)
+{
+    uint8x8_t mask = vshrn_n_u16(vreinterpretq_u16_u8(r), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(mask), 0);
+}
+
+// size is in bytes, must be multiple of width and >= 16, returns element index
+MEM_DISABLE_ASAN
+static MEM_FORCE_INLINE size_t MemFindWide_neon(const uint8_t* p, size_t size, uint8x16_t value16, size_t width, int invert)
+{
+    size_t offset = 0;
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        uint8x16x4_t a = vld1q_u8_x4(p);
+
+        uint8x16_t r0 = MemFindWideMatch_neon(a.val[0], value16, width, invert);
+        uint8x16_t r1 = MemFindWideMatch_neon(a.val[1], value16, width, invert);
+        uint8x16_t r2 = MemFindWideMatch_neon(a.val[2], value16, width, invert);
+        uint8x16_t r3 = MemFindWideMatch_neon(a.val[3], value16, width, invert);
+
+        // combine comparisons - leave 0xff in lanes of matching elements
+        uint8x16_t r = vorrq_u8(vorrq_u8(r0, r1), vorrq_u8(r2, r3));
+        if (MemFindWideNibbles_neon(r))
+        {
+            // find first comparison with matching element, last one is guaranteed to be non-zero
+            uint64_t n0 = MemFindWideNibbles_neon(r0);
+            uint64_t n1 = MemFindWideNibbles_neon(r1);
+            uint64_t n2 = MemFindWideNibbles_neon(r2);
+            uint64_t n3 = MemFindWideNibbles_neon(r3);
+
+            size_t index = n0 ? MEM_CTZ64(n0) / 4
+                         : n1 ? MEM_CTZ64(n1) / 4 + 16
+                         : n2 ? MEM_CTZ64(n2) / 4 + 32
+                         :      MEM_CTZ64(n3) / 4 + 48;
+
+            // convert byte index to element index
+            return (offset + index) / width;
+        }
+
+        offset += 64;
+        size -= 64;
+        p += 64;
+    }
+
+    // process 16-byte blocks
+    while (size >= 16)
+    {
+        uint8x16_t a = vld1q_u8(p);
+        uint64_t nibbles = MemFindWideNibbles_neon(MemFindWideMatch_neon(a, value16, width, invert));
+        if (nibbles)
+        {
+            return (offset + MEM_CTZ64(nibbles) / 4) / width;
+        }
+
+        offset += 16;
+        size -= 16;
+        p += 16;
+    }
+
+    if (size) // 0 < size < 16, but initially size >= 16
+    {
+        // load 16 bytes from end of buffer, this will load previously checked elements
+        uint8x16_t a = vld1q_u8(p + size - 16);
+
+        // drop nibbles of previously checked elements
+        uint64_t nibbles = MemFindWideNibbles_neon(MemFindWideMatch_neon(a, value16, width, invert));
+        nibbles >>= 4 * (16 - size);
+        if (nibbles)
+        {
+            return (offset + MEM_CTZ64(nibbles) / 4) / width;
+        }
+
+        offset += size;
+    }
+
+    // no matching element found
+    return offset / width;
+}
+
+MEM_DISABLE_ASAN
+size_t MemFind16_neon(const void* ptr, size_t count, uint16_t value)
+{
+    if (count < 16 / sizeof(value))
+    {
+        return MemFind16_generic(ptr, count, value);
+    }
+    return MemFindWide_neon((const uint8_t*)ptr, count * sizeof(value), vreinterpretq_u8_u16(vdupq_n_u16(value)), sizeof(value), 0);
+}
+
+MEM_DISABLE_ASAN
+size_t MemFind32_neon(const void* ptr, size_t count, uint32_t value)
+{
+    if (count < 16 / sizeof(value))
+    {
+        return MemFind32_generic(ptr, count, value);
+    }
+    return MemFindWide_neon((const uint8_t*)ptr, count * sizeof(value), vreinterpretq_u8_u32(vdupq_n_u32(value)), sizeof(value), 0);
+}
+
+MEM_DISABLE_ASAN
+size_t MemFind64_neon(const void* ptr, size_t count, uint64_t value)
+{
+    if (count < 16 / sizeof(value))
+    {
+        return MemFind64_generic(ptr, count, value);
+    }
+    return MemFindWide_neon((const uint8_t*)ptr, count * sizeof(value), vreinterpretq_u8_u64(vdupq_n_u64(value)), sizeof(value), 0);
+}
+
+MEM_DISABLE_ASAN
+size_t MemFindNot16_neon(const void* ptr, size_t count, uint16_t value)
+{
+    if (count < 16 / sizeof(value))
+    {
+        return MemFindNot16_generic(ptr, count, value);
+    }
+    return MemFindWide_neon((const uint8_t*)ptr, count * sizeof(value), vreinterpretq_u8_u16(vdupq_n_u16(value)), sizeof(value), 1);
+}
+
+MEM_DISABLE_ASAN
+size_t MemFindNot32_neon(const void* ptr, size_t count, uint32_t value)
+{
+    if (count < 16 / sizeof(value))
+    {
+        return MemFindNot32_generic(ptr, count, value);
+    }
+    return MemFindWide_neon((const uint8_t*)ptr, count * sizeof(value), vreinterpretq_u8_u32(vdupq_n_u32(value)), sizeof(value), 1);
+}
+
+MEM_DISABLE_ASAN
+size_t MemFindNot64_neon(const void* ptr, size_t count, uint64_t value)
+{
+    if (count < 16 / sizeof(value))
+    {
+        return MemFindNot64_generic(ptr, count, value);
+    }
+    return MemFindWide_neon((const uint8_t*)ptr, count * sizeof(value), vreinterpretq_u8_u64(vdupq_n_u64(value)), sizeof(value), 1);
+}
+
+MEM_DISABLE_ASAN
+size_t MemLowerBound32_neon(const void* ptr, size_t count, uint32_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (count < 16)
+    {
+        return MemLowerBound32_generic(ptr, count, value);
+    }
+
+    // binary search down to 16 elements, which are compared all at once
+    size_t start = MemLowerBoundWindow(p, count, value, sizeof(value), 16);
+    p += start * sizeof(value);
+
+    const uint32x4_t value16 = vdupq_n_u32(value);
+
+    uint8x16x4_t a = vld1q_u8_x4(p);
+
+    // set lanes to 0xff for elements less than input value
+    uint8x16_t r0 = vreinterpretq_u8_u32(vcltq_u32(vreinterpretq_u32_u8(a.val[0]), value16));
+    uint8x16_t r1 = vreinterpretq_u8_u32(vcltq_u32(vreinterpretq_u32_u8(a.val[1]), value16));
+    uint8x16_t r2 = vreinterpretq_u8_u32(vcltq_u32(vreinterpretq_u32_u8(a.val[2]), value16));
+    uint8x16_t r3 = vreinterpretq_u8_u32(vcltq_u32(vreinterpretq_u32_u8(a.val[3]), value16));
+
+    // every element less than input value has 16 bits set in nibble masks
+    size_t bits = MEM_POPCNT64(MemFindWideNibbles_neon(r0)) + MEM_POPCNT64(MemFindWideNibbles_neon(r1))
+                + MEM_POPCNT64(MemFindWideNibbles_neon(r2)) + MEM_POPCNT64(MemFindWideNibbles_neon(r3));
+    return start + bits / 16;
+}
+
+MEM_DISABLE_ASAN
+size_t MemLowerBound64_neon(const void* ptr, size_t count, uint64_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (count < 8)
+    {
+        return MemLowerBound64_generic(ptr, count, value);
+    }
+
+    // binary search down to 8 elements, which are compared all at once
+    size_t start = MemLowerBoundWindow(p, count, value, sizeof(value), 8);
+    p += start * sizeof(value);
+
+    const uint64x2_t value16 = vdupq_n_u64(value);
+
+    uint8x16x4_t a = vld1q_u8_x4(p);
+
+    // set lanes to 0xff for elements less than input value
+    uint8x16_t r0 = vreinterpretq_u8_u64(vcltq_u64(vreinterpretq_u64_u8(a.val[0]), value16));
+    uint8x16_t r1 = vreinterpretq_u8_u64(vcltq_u64(vreinterpretq_u64_u8(a.val[1]), value16));
+    uint8x16_t r2 = vreinterpretq_u8_u64(vcltq_u64(vreinterpretq_u64_u8(a.val[2]), value16));
+    uint8x16_t r3 = vreinterpretq_u8_u64(vcltq_u64(vreinterpretq_u64_u8(a.val[3]), value16));
+
+    // every element less than input value has 32 bits set in nibble masks
+    size_t bits = MEM_POPCNT64(MemFindWideNibbles_neon(r0)) + MEM_POPCNT64(MemFindWideNibbles_neon(r1))
+                + MEM_POPCNT64(MemFindWideNibbles_neon(r2)) + MEM_POPCNT64(MemFindWideNibbles_neon(r3));
+    return start + bits / 32;
+}
+
+// translates 16 bytes with 256-byte table in 4 groups of 4 registers
+static MEM_FORCE_INLINE uint8x16_t MemTranslateLookup_neon(uint8x16_t a, uint8x16x4_t t0, uint8x16x4_t t1, uint8x16x4_t t2, uint8x16x4_t t3)
+{
+    // every lookup uses 64 bytes of table, lanes out of its range return 0 or keep previous result
+    uint8x16_t r = vqtbl4q_u8(t0, a);
+    r = vqtbx4q_u8(r, t1, vsubq_u8(a, vdupq_n_u8(0x40)));
+    r = vqtbx4q_u8(r, t2, vsubq_u8(a, vdupq_n_u8(0x80)));
+    r = vqtbx4q_u8(r, t3, vsubq_u8(a, vdupq_n_u8(0xc0)));
+    return r;
+}
+
+MEM_DISABLE_ASAN
+void MemTranslate_neon(void* dst, const void* src, size_t size, const uint8_t table[256])
+{
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+
+    if (size < 16)
+    {
+        MemTranslate_generic(dst, src, size, table);
+        return;
+    }
+
+    uint8x16x4_t t0 = vld1q_u8_x4(table + 0x00);
+    uint8x16x4_t t1 = vld1q_u8_x4(table + 0x40);
+    uint8x16x4_t t2 = vld1q_u8_x4(table + 0x80);
+    uint8x16x4_t t3 = vld1q_u8_x4(table + 0xc0);
+
+    // load last 16 bytes before storing anything, so dst can be same as src
+    // translating same bytes twice would not give same result, unlike case conversion
+    uint8x16_t last = vld1q_u8(s + size - 16);
+
+    // process 64-byte blocks, except the last one
+    while (size > 64)
+    {
+        uint8x16x4_t a = vld1q_u8_x4(s);
+
+        a.val[0] = MemTranslateLookup_neon(a.val[0], t0, t1, t2, t3);
+        a.val[1] = MemTranslateLookup_neon(a.val[1], t0, t1, t2, t3);
+        a.val[2] = MemTranslateLookup_neon(a.val[2], t0, t1, t2, t3);
+        a.val[3] = MemTranslateLookup_neon(a.val[3], t0, t1, t2, t3);
+
+        vst1q_u8_x4(d, a);
+
+        size -= 64;
+        s += 64;
+        d += 64;
+    }
+
+    // process 16-byte blocks, except the last one
+    while (size > 16)
+    {
+        uint8x16_t a = vld1q_u8(s);
+        vst1q_u8(d, MemTranslateLookup_neon(a, t0, t1, t2, t3));
+
+        size -= 16;
+        s += 16;
+        d += 16;
+    }
+
+    // last 16 bytes, will overwrite some of already translated bytes with same values
+    vst1q_u8(d + size - 16, MemTranslateLookup_neon(last, t0, t1, t2, t3));
+}
+
+// adds 64-byte stripe to accumulators, for every 64-bit lane "i":
+// acc[i] += low32(data[i] ^ key[i]) * high32(data[i] ^ key[i]) + data[i ^ 1]
+MEM_DISABLE_ASAN
+static MEM_FORCE_INLINE void MemHashStripe_neon(uint64x2_t acc[4], const uint8_t* p, const uint64_t* key)
+{
+    for (size_t i=0; i<4; i++)
+    {
+        uint64x2_t data = vreinterpretq_u64_u8(vld1q_u8(p + i * 16));
+        uint64x2_t mixed = veorq_u64(data, vld1q_u64(key + i * 2));
+        uint64x2_t swapped = vextq_u64(data, data, 1);
+        acc[i] = vaddq_u64(acc[i], vmlal_u32(swapped, vmovn_u64(mixed), vshrn_n_u64(mixed, 32)));
+    }
+}
+
+// acc = (acc ^ (acc >> 47) ^ key) * prime, where prime is 32-bit value
+static MEM_FORCE_INLINE void MemHashScramble_neon(uint64x2_t acc[4], const uint64_t* key)
+{
+    const uint32x2_t prime = vdup_n_u32(0x9e3779b1);
+
+    for (size_t i=0; i<4; i++)
+    {
+        uint64x2_t a = veorq_u64(acc[i], vshrq_n_u64(acc[i], 47));
+        a = veorq_u64(a, vld1q_u64(key + i * 2));
+
+        uint64x2_t hi = vmull_u32(vshrn_n_u64(a, 32), prime);
+        acc[i] = vmlal_u32(vshlq_n_u64(hi, 32), vmovn_u64(a), prime);
+    }
+}
+
+MEM_DISABLE_ASAN
+uint64_t MemHash64_neon(const void* ptr, size_t size, uint64_t seed)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (size <= 16)
+    {
+        return MemHashSmall(p, size, seed);
+    }
+    else if (size <= 256)
+    {
+        return MemHashMedium(p, size, seed);
+    }
+
+    uint64x2_t acc[4];
+    for (size_t i=0; i<4; i++)
+    {
+        acc[i] = vaddq_u64(vld1q_u64(MemHashSecret + 24 + i * 2), vdupq_n_u64(seed));
+    }
+
+    const uint8_t* end = p + size;
+
+    // 1024-byte blocks of 16 stripes, each stripe uses key shifted by 8 bytes
+    while (end - p > 1024)
+    {
+        for (size_t i=0; i<16; i++)
+        {
+            MemHashStripe_neon(acc, p + i * 64, MemHashSecret + i);
+        }
+        MemHashScramble_neon(acc, MemHashSecret + 16);
+        p += 1024;
+    }
+
+    // remaining stripes, there are at most 15 of them
+    for (size_t i=0; end - p > 64; i++)
+    {
+        MemHashStripe_neon(acc, p, MemHashSecret + i);
+        p += 64;
+    }
+
+    // last 64 bytes, may overlap with previous stripe
+    MemHashStripe_neon(acc, end - 64, MemHashSecret + 16);
+
+    uint64_t result[8];
+    for (size_t i=0; i<4; i++)
+    {
+        vst1q_u64(result + i * 2, acc[i]);
+    }
+    return MemHashMerge(result, size, seed);
+}
+
+// returns index of first byte that is different, or index >= size if all bytes are equal, size must be <= 32
+MEM_DISABLE_ASAN
+static MEM_FORCE_INLINE size_t MemBatchMismatch_neon(const MemPair* pair)
+{
+    const uint8_t* p1 = (const uint8_t*)pair->ptr1;
+    const uint8_t* p2 = (const uint8_t*)pair->ptr2;
+
+    uint8x16_t a0 = vld1q_u8(p1 + 0x00);
+    uint8x16_t b0 = vld1q_u8(p2 + 0x00);
+    uint8x16_t a1 = vld1q_u8(p1 + 0x10);
+    uint8x16_t b1 = vld1q_u8(p2 + 0x10);
+
+    // narrow 16-bit lanes to get 4-bit nibble for each byte, with bits set where bytes are different
+    uint64_t m0 = ~vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(vceqq_u8(a0, b0)), 4)), 0);
+    uint64_t m1 = ~vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(vceqq_u8(a1, b1)), 4)), 0);
+
+    size_t index0 = m0 ? MEM_CTZ64(m0) / 4 : 16;
+    size_t index1 = m1 ? MEM_CTZ64(m1) / 4 : 16;
+    return index0 < 16 ? index0 : 16 + index1;
+}
+
+MEM_DISABLE_ASAN
+void MemIsEqualBatch_neon(const MemPair* pairs, size_t count, uint8_t* results)
+{
+    for (size_t i=0; i<count; i++)
+    {
+        const MemPair* pair = &pairs[i];
+        MemPrefetchPair(pairs, i + 8, count);
+
+        // short buffers without page crossing use single branchless comparison,
+        // there are no calls or branches that depend on size, so loads of next pairs can start early
+        if (MemBatchCanLoad(pair, 32))
+        {
+            results[i] = MemBatchMismatch_neon(pair) >= pair->size;
+        }
+        else
+        {
+            results[i] = MemIsEqual_neon(pair->ptr1, pair->ptr2, pair->size);
+        }
+    }
+}
+
+MEM_DISABLE_ASAN
+void MemCompareBatch_neon(const MemPair* pairs, size_t count, int* results)
+{
+    for (size_t i=0; i<count; i++)
+    {
+        const MemPair* pair = &pairs[i];
+        MemPrefetchPair(pairs, i + 8, count);
+
+        if (MemBatchCanLoad(pair, 32))
+        {
+            results[i] = MemBatchCompareAt(pair, MemBatchMismatch_neon(pair));
+        }
+        else
+        {
+            results[i] = MemCompare_neon(pair->ptr1, pair->ptr2, pair->size);
+        }
+    }
+}
+
+bool MemIsEqualConstTime_neon(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    // all branches below depend only on size, never on contents of buffers
+
+    if (size < 16)
+    {
+        return MemConstTimeDiff(p1, p2, size) == 0;
+    }
+
+    // accumulate bits that are different in each 16-byte lane
+    uint8x16_t r0 = vdupq_n_u8(0);
+    uint8x16_t r1 = vdupq_n_u8(0);
+    uint8x16_t r2 = vdupq_n_u8(0);
+    uint8x16_t r3 = vdupq_n_u8(0);
+
+    // process 64-byte blocks as much as possible
+    while (size >= 64)
+    {
+        uint8x16x4_t a = vld1q_u8_x4(p1);
+        uint8x16x4_t b = vld1q_u8_x4(p2);
+
+        r0 = vorrq_u8(r0, veorq_u8(a.val[0], b.val[0]));
+        r1 = vorrq_u8(r1, veorq_u8(a.val[1], b.val[1]));
+        r2 = vorrq_u8(r2, veorq_u8(a.val[2], b.val[2]));
+        r3 = vorrq_u8(r3, veorq_u8(a.val[3], b.val[3]));
+
+        size -= 64;
+        p1 += 64;
+        p2 += 64;
+    }
+
+    // then 16-byte blocks
+    while (size >= 16)
+    {
+        uint8x16_t a0 = vld1q_u8(p1);
+        uint8x16_t b0 = vld1q_u8(p2);
+        r0 = vorrq_u8(r0, veorq_u8(a0, b0));
+
+        size -= 16;
+        p1 += 16;
+        p2 += 16;
+    }
+
+    // last 16 bytes overlap with already processed ones, original size was >= 16
+    {
+        uint8x16_t a0 = vld1q_u8(p1 + size - 16);
+        uint8x16_t b0 = vld1q_u8(p2 + size - 16);
+        r1 = vorrq_u8(r1, veorq_u8(a0, b0));
+    }
+
+    r0 = vorrq_u8(vorrq_u8(r0, r1), vorrq_u8(r2, r3));
+
+    // buffers are equal only if all accumulated bytes are zero
+    return vmaxvq_u8(r0) == 0;
+}
+
+MemPosition MemFindV_neon(const MemSegment* segments, size_t count, uint8_t value)
+{
+    return MemFindSegments(segments, count, value, &MemFind_neon);
+}
+
+bool MemIsEqualV_neon(const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2)
+{
+    return MemIsEqualSegments(segments1, count1, segments2, count2, &MemIsEqual_neon);
+}
+
+#endif // MEM_ARCH_ARM64
+
+
+#if MEM_ARCH_SVE
+
+// sve kernels do not depend on vector length, every vector has svcntb() bytes, which is from 16 to 256
+// tails are processed with predicated loads, they never access bytes outside of buffers, so no page crossing checks are needed
+// when 4 vectors of main loop contain result, loop stops and tail loop finds exact position in same vectors again
+
+MEM_TARGET_SVE
+int MemCompare_sve(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    const size_t vl = svcntb();
+    const svbool_t all = svptrue_b8();
+
+    // process 4 vectors at once as much as possible
+    while (size >= 4 * vl)
+    {
+        svuint8_t a0 = svld1_vnum_u8(all, p1, 0);
+        svuint8_t b0 = svld1_vnum_u8(all, p2, 0);
+        svuint8_t a1 = svld1_vnum_u8(all, p1, 1);
+        svuint8_t b1 = svld1_vnum_u8(all, p2, 1);
+        svuint8_t a2 = svld1_vnum_u8(all, p1, 2);
+        svuint8_t b2 = svld1_vnum_u8(all, p2, 2);
+        svuint8_t a3 = svld1_vnum_u8(all, p1, 3);
+        svuint8_t b3 = svld1_vnum_u8(all, p2, 3);
+
+        // check if any bytes are different
+        svbool_t m0 = svcmpne_u8(all, a0, b0);
+        svbool_t m1 = svcmpne_u8(all, a1, b1);
+        svbool_t m2 = svcmpne_u8(all, a2, b2);
+        svbool_t m3 = svcmpne_u8(all, a3, b3);
+        if (svptest_any(all, svorr_b_z(all, svorr_b_z(all, m0, m1), svorr_b_z(all, m2, m3))))
+        {
+            break;
+        }
+
+        size -= 4 * vl;
+        p1 += 4 * vl;
+        p2 += 4 * vl;
+    }
+
+    // process rest of bytes one vector at a time, last one loads only remaining bytes
+    for (size_t offset=0; offset<size; offset+=vl)
+    {
+        svbool_t pg = svwhilelt_b8_u64(offset, size);
+        svuint8_t a = svld1_u8(pg, p1 + offset);
+        svuint8_t b = svld1_u8(pg, p2 + offset);
+
+        // check if any bytes are different
+        svbool_t m = svcmpne_u8(pg, a, b);
+        if (svptest_any(pg, m))
+        {
+            // if they are, return comparison result of first byte that is different
+            // count of active lanes before first different byte is its index
+            size_t index = offset + svcntp_b8(pg, svbrkb_b_z(pg, m));
+            return p1[index] - p2[index];
+        }
+    }
+
+    // no differences found, inputs are equal
+    return 0;
+}
+
+MEM_TARGET_SVE
+bool MemIsEqual_sve(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    const size_t vl = svcntb();
+    const svbool_t all = svptrue_b8();
+
+    // process 4 vectors at once as much as possible
+    while (size >= 4 * vl)
+    {
+        svuint8_t a0 = svld1_vnum_u8(all, p1, 0);
+        svuint8_t b0 = svld1_vnum_u8(all, p2, 0);
+        svuint8_t a1 = svld1_vnum_u8(all, p1, 1);
+        svuint8_t b1 = svld1_vnum_u8(all, p2, 1);
+        svuint8_t a2 = svld1_vnum_u8(all, p1, 2);
+        svuint8_t b2 = svld1_vnum_u8(all, p2, 2);
+        svuint8_t a3 = svld1_vnum_u8(all, p1, 3);
+        svuint8_t b3 = svld1_vnum_u8(all, p2, 3);
+
+        // check if any bytes are different
+        svbool_t m0 = svcmpne_u8(all, a0, b0);
+        svbool_t m1 = svcmpne_u8(all, a1, b1);
+        svbool_t m2 = svcmpne_u8(all, a2, b2);
+        svbool_t m3 = svcmpne_u8(all, a3, b3);
+        if (svptest_any(all, svorr_b_z(all, svorr_b_z(all, m0, m1), svorr_b_z(all, m2, m3))))
+        {
+            // they are different
+            return false;
+        }
+
+        size -= 4 * vl;
+        p1 += 4 * vl;
+        p2 += 4 * vl;
+    }
+
+    // process rest of bytes one vector at a time, last one loads only remaining bytes
+    for (size_t offset=0; offset<size; offset+=vl)
+    {
+        svbool_t pg = svwhilelt_b8_u64(offset, size);
+        svuint8_t a = svld1_u8(pg, p1 + offset);
+        svuint8_t b = svld1_u8(pg, p2 + offset);
+
+        // check if any bytes are different
+        if (svptest_any(pg, svcmpne_u8(pg, a, b)))
+        {
+            // they are different
+            return false;
+        }
+    }
+
+    // no differences found, inputs are equal
+    return true;
+}
+
+// returns predicate of bytes that match input value (or do not match if "invert" is set), only bytes in "pg" are compared
+MEM_TARGET_SVE
+static MEM_FORCE_INLINE svbool_t MemFindMatch_sve(svbool_t pg, svuint8_t a, uint8_t value, int invert)
+{
+    return invert ? svcmpne_n_u8(pg, a, value) : svcmpeq_n_u8(pg, a, value);
+}
+
+// returns index of first byte that matches input value (or does not match if "invert" is set)
+MEM_TARGET_SVE
+static MEM_FORCE_INLINE size_t MemFindByte_sve(const uint8_t* p, size_t size, uint8_t value, int invert)
+{
+    const size_t vl = svcntb();
+    const svbool_t all = svptrue_b8();
+
+    size_t offset = 0;
+
+    // process 4 vectors at once as much as possible
+    while (size - offset >= 4 * vl)
+    {
+        svuint8_t a0 = svld1_vnum_u8(all, p + offset, 0);
+        svuint8_t a1 = svld1_vnum_u8(all, p + offset, 1);
+        svuint8_t a2 = svld1_vnum_u8(all, p + offset, 2);
+        svuint8_t a3 = svld1_vnum_u8(all, p + offset, 3);
+
+        // compare against input value
+        svbool_t m0 = MemFindMatch_sve(all, a0, value, invert);
+        svbool_t m1 = MemFindMatch_sve(all, a1, value, invert);
+        svbool_t m2 = MemFindMatch_sve(all, a2, value, invert);
+        svbool_t m3 = MemFindMatch_sve(all, a3, value, invert);
+        if (svptest_any(all, svorr_b_z(all, svorr_b_z(all, m0, m1), svorr_b_z(all, m2, m3))))
+        {
+            break;
+        }
+
+        offset += 4 * vl;
+    }
+
+    // process rest of bytes one vector at a time, last one loads only remaining bytes
+    for (; offset<size; offset+=vl)
+    {
+        svbool_t pg = svwhilelt_b8_u64(offset, size);
+        svuint8_t a = svld1_u8(pg, p + offset);
+
+        // compare against input value
+        svbool_t m = MemFindMatch_sve(pg, a, value, invert);
+        if (svptest_any(pg, m))
+        {
+            // return index of lowest byte found
+            return offset + svcntp_b8(pg, svbrkb_b_z(pg, m));
+        }
+    }
+
+    // nothing found
+    return size;
+}
+
+// returns index of last byte that matches input value (or does not match if "invert" is set)
+MEM_TARGET_SVE
+static MEM_FORCE_INLINE size_t MemFindLastByte_sve(const uint8_t* p, size_t size, uint8_t value, int invert)
+{
+    const size_t vl = svcntb();
+    const svbool_t all = svptrue_b8();
+
+    // lane indices, vector is at most 256 bytes, so they fit in bytes
+    const svuint8_t index = svindex_u8(0, 1);
+
+    // remember original size to return when nothing is found
+    const size_t total = size;
+
+    // process 4 vectors from the end as much as possible
+    while (size >= 4 * vl)
+    {
+        const uint8_t* q = p + size - 4 * vl;
+
+        svuint8_t a0 = svld1_vnum_u8(all, q, 0);
+        svuint8_t a1 = svld1_vnum_u8(all, q, 1);
+        svuint8_t a2 = svld1_vnum_u8(all, q, 2);
+        svuint8_t a3 = svld1_vnum_u8(all, q, 3);
+
+        // compare against input value
+        svbool_t m0 = MemFindMatch_sve(all, a0, value, invert);
+        svbool_t m1 = MemFindMatch_sve(all, a1, value, invert);
+        svbool_t m2 = MemFindMatch_sve(all, a2, value, invert);
+        svbool_t m3 = MemFindMatch_sve(all, a3, value, invert);
+        if (svptest_any(all, svorr_b_z(all, svorr_b_z(all, m0, m1), svorr_b_z(all, m2, m3))))
+        {
+            break;
+        }
+
+        size -= 4 * vl;
+    }
+
+    // process rest of bytes one vector at a time from the end, last one loads only bytes at start of buffer
+    while (size)
+    {
+        size_t start = size > vl ? size - vl : 0;
+
+        svbool_t pg = svwhilelt_b8_u64(start, size);
+        svuint8_t a = svld1_u8(pg, p + start);
+
+        // compare against input value
+        svbool_t m = MemFindMatch_sve(pg, a, value, invert);
+        if (svptest_any(pg, m))
+        {
+            // return index of highest byte found
+            return start + svlastb_u8(m, index);
+        }
+
+        size = start;
+    }
+
+    // nothing found
+    return total;
+}
+
+MEM_TARGET_SVE
+size_t MemFind_sve(const void* ptr, size_t size, uint8_t value)
+{
+    return MemFindByte_sve((const uint8_t*)ptr, size, value, 0);
+}
+
+MEM_TARGET_SVE
+size_t MemFindNot_sve(const void* ptr, size_t size, uint8_t value)
+{
+    return MemFindByte_sve((const uint8_t*)ptr, size, value, 1);
+}
+
+MEM_TARGET_SVE
+size_t MemFindLast_sve(const void* ptr, size_t size, uint8_t value)
+{
+    return MemFindLastByte_sve((const uint8_t*)ptr, size, value, 0);
+}
+
+MEM_TARGET_SVE
+size_t MemFindLastNot_sve(const void* ptr, size_t size, uint8_t value)
+{
+    return MemFindLastByte_sve((const uint8_t*)ptr, size, value, 1);
+}
+
+MEM_TARGET_SVE2
+size_t MemFindAny_sve(const void* ptr, size_t size, const void* set, size_t setlen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* s = (const uint8_t*)set;
+
+    // match instruction compares every byte with 16 bytes of set, larger sets use lookup tables in neon implementation
+    if (setlen == 0 || setlen > 16)
+    {
+        return MemFindAny_neon(ptr, size, set, setlen);
+    }
+
+    // set padded to 16 bytes by repeating its first byte
+    uint8_t bytes[16];
+    for (size_t i=0; i<16; i++)
+    {
+        bytes[i] = s[i < setlen ? i : 0];
+    }
+
+    const size_t vl = svcntb();
+    const svbool_t all = svptrue_b8();
+
+    // every 128-bit segment of vector gets copy of set
+    const svuint8_t n = svld1rq_u8(all, bytes);
+
+    size_t offset = 0;
+
+    // process 4 vectors at once as much as possible
+    while (size - offset >= 4 * vl)
+    {
+        svuint8_t a0 = svld1_vnum_u8(all, p + offset, 0);
+        svuint8_t a1 = svld1_vnum_u8(all, p + offset, 1);
+        svuint8_t a2 = svld1_vnum_u8(all, p + offset, 2);
+        svuint8_t a3 = svld1_vnum_u8(all, p + offset, 3);
+
+        // check which bytes are in set
+        svbool_t m0 = svmatch_u8(all, a0, n);
+        svbool_t m1 = svmatch_u8(all, a1, n);
+        svbool_t m2 = svmatch_u8(all, a2, n);
+        svbool_t m3 = svmatch_u8(all, a3, n);
+        if (svptest_any(all, svorr_b_z(all, svorr_b_z(all, m0, m1), svorr_b_z(all, m2, m3))))
+        {
+            break;
+        }
+
+        offset += 4 * vl;
+    }
+
+    // process rest of bytes one vector at a time, last one loads only remaining bytes
+    for (; offset<size; offset+=vl)
+    {
+        svbool_t pg = svwhilelt_b8_u64(offset, size);
+        svuint8_t a = svld1_u8(pg, p + offset);
+
+        // check which bytes are in set
+        svbool_t m = svmatch_u8(pg, a, n);
+        if (svptest_any(pg, m))
+        {
+            // return index of lowest byte found
+            return offset + svcntp_b8(pg, svbrkb_b_z(pg, m));
+        }
+    }
+
+    // nothing found
+    return size;
+}
+
+MEM_TARGET_SVE
+size_t MemCount_sve(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    const size_t vl = svcntb();
+    const svbool_t all = svptrue_b8();
+
+    size_t result = 0;
+
+    // process 4 vectors at once as much as possible
+    while (size >= 4 * vl)
+    {
+        svuint8_t a0 = svld1_vnum_u8(all, p, 0);
+        svuint8_t a1 = svld1_vnum_u8(all, p, 1);
+        svuint8_t a2 = svld1_vnum_u8(all, p, 2);
+        svuint8_t a3 = svld1_vnum_u8(all, p, 3);
+
+        // count bytes matching input value
+        result += svcntp_b8(all, svcmpeq_n_u8(all, a0, value));
+        result += svcntp_b8(all, svcmpeq_n_u8(all, a1, value));
+        result += svcntp_b8(all, svcmpeq_n_u8(all, a2, value));
+        result += svcntp_b8(all, svcmpeq_n_u8(all, a3, value));
+
+        size -= 4 * vl;
+        p += 4 * vl;
+    }
+
+    // process rest of bytes one vector at a time, last one loads only remaining bytes
+    for (size_t offset=0; offset<size; offset+=vl)
+    {
+        svbool_t pg = svwhilelt_b8_u64(offset, size);
+        svuint8_t a = svld1_u8(pg, p + offset);
+
+        // count bytes matching input value, only active lanes
+        result += svcntp_b8(pg, svcmpeq_n_u8(pg, a, value));
+    }
+
+    return result;
+}
+
+MEM_TARGET_SVE
+size_t MemMismatch_sve(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    const size_t vl = svcntb();
+    const svbool_t all = svptrue_b8();
+
+    size_t offset = 0;
+
+    // process 4 vectors at once as much as possible
+    while (size - offset >= 4 * vl)
+    {
+        svuint8_t a0 = svld1_vnum_u8(all, p1 + offset, 0);
+        svuint8_t b0 = svld1_vnum_u8(all, p2 + offset, 0);
+        svuint8_t a1 = svld1_vnum_u8(all, p1 + offset, 1);
+        svuint8_t b1 = svld1_vnum_u8(all, p2 + offset, 1);
+        svuint8_t a2 = svld1_vnum_u8(all, p1 + offset, 2);
+        svuint8_t b2 = svld1_vnum_u8(all, p2 + offset, 2);
+        svuint8_t a3 = svld1_vnum_u8(all, p1 + offset, 3);
+        svuint8_t b3 = svld1_vnum_u8(all, p2 + offset, 3);
+
+        // check if any bytes are different
+        svbool_t m0 = svcmpne_u8(all, a0, b0);
+        svbool_t m1 = svcmpne_u8(all, a1, b1);
+        svbool_t m2 = svcmpne_u8(all, a2, b2);
+        svbool_t m3 = svcmpne_u8(all, a3, b3);
+        if (svptest_any(all, svorr_b_z(all, svorr_b_z(all, m0, m1), svorr_b_z(all, m2, m3))))
+        {
+            break;
+        }
+
+        offset += 4 * vl;
+    }
+
+    // process rest of bytes one vector at a time, last one loads only remaining bytes
+    for (; offset<size; offset+=vl)
+    {
+        svbool_t pg = svwhilelt_b8_u64(offset, size);
+        svuint8_t a = svld1_u8(pg, p1 + offset);
+        svuint8_t b = svld1_u8(pg, p2 + offset);
+
+        // check if any bytes are different
+        svbool_t m = svcmpne_u8(pg, a, b);
+        if (svptest_any(pg, m))
+        {
+            // if they are, return index of lowest byte that is different
+            return offset + svcntp_b8(pg, svbrkb_b_z(pg, m));
+        }
+    }
+
+    // no differences found
+    return size;
+}
+
+#endif // MEM_ARCH_SVE
+
+
+#if MEM_ARCH_RVV
+
+int MemCompare_rvv(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    do
+    {
+        size_t vl = __riscv_vsetvl_e8m8(size);
+
+        vuint8m8_t a = __riscv_vle8_v_u8m8(p1, vl);
+        vuint8m8_t b = __riscv_vle8_v_u8m8(p2, vl);
+        vbool1_t m = __riscv_vmsne_vv_u8m8_b1(a, b, vl);
+
+        long index = __riscv_vfirst_m_b1(m, vl);
+        if (index >= 0)
+        {
+            return p1[index] - p2[index];
+        }
+
+        size -= vl;
+        p1 += vl;
+        p2 += vl;
+    }
+    while (size);
+
+    return 0;
+}
+
+int MemCompareI_rvv(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    do
+    {
+        size_t vl = __riscv_vsetvl_e8m8(size);
+
+        vuint8m8_t a = __riscv_vle8_v_u8m8(p1, vl);
+        vuint8m8_t b = __riscv_vle8_v_u8m8(p2, vl);
+
+        // mask = (uint8_t)(x - 'A') <= ('Z' - 'A')
+        vbool1_t am = __riscv_vmsleu_vx_u8m8_b1(__riscv_vsub_vx_u8m8(a, 'A', vl), 'Z' - 'A', vl);
+        vbool1_t bm = __riscv_vmsleu_vx_u8m8_b1(__riscv_vsub_vx_u8m8(b, 'A', vl), 'Z' - 'A', vl);
+
+        // x = mask ? (x + 'a' - 'A') : x
+        a = __riscv_vadd_vx_u8m8_mu(am, a, a, 'a' - 'A', vl);
+        b = __riscv_vadd_vx_u8m8_mu(bm, b, b, 'a' - 'A', vl);
+
+        vbool1_t m = __riscv_vmsne_vv_u8m8_b1(a, b, vl);
+
+        long index = __riscv_vfirst_m_b1(m, vl);
+        if (index >= 0)
+        {
+            a = __riscv_vslidedown_vx_u8m8(a, (unsigned long)index, vl);
+            b = __riscv_vslidedown_vx_u8m8(b, (unsigned long)index, vl);
+            return __riscv_vmv_x_s_u8m8_u8(a) - __riscv_vmv_x_s_u8m8_u8(b);
+        }
+
+        size -= vl;
+        p1 += vl;
+        p2 += vl;
+    }
+    while (size);
+
+    return 0;
+}
+
+bool MemIsEqual_rvv(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    do
+    {
+        size_t vl = __riscv_vsetvl_e8m8(size);
+
+        vuint8m8_t a = __riscv_vle8_v_u8m8(p1, vl);
+        vuint8m8_t b = __riscv_vle8_v_u8m8(p2, vl);
+        vbool1_t m = __riscv_vmsne_vv_u8m8_b1(a, b, vl);
+
+        if (__riscv_vcpop_m_b1(m, vl))
+        {
+            return false;
+        }
+
+        size -= vl;
+        p1 += vl;
+        p2 += vl;
+    }
+    while (size);
+
+    return true;
+}
+
+size_t MemFind_rvv(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    size_t offset = 0;
+    do
+    {
+        size_t vl = __riscv_vsetvl_e8m8(size);
+
+        vuint8m8_t a = __riscv_vle8_v_u8m8(p, vl);
+        vbool1_t m = __riscv_vmseq_vx_u8m8_b1(a, value, vl);
+
+        long index = __riscv_vfirst_m_b1(m, vl);
+        if (index >= 0)
+        {
+            return offset + (unsigned long)index;
+        }
+
+        offset += vl;
+        size -= vl;
+        p += vl;
+    }
+    while (size);
+
+    return offset;
+}
+
+size_t MemFindNot_rvv(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    size_t offset = 0;
+    do
+    {
+        size_t vl = __riscv_vsetvl_e8m8(size);
+
+        vuint8m8_t a = __riscv_vle8_v_u8m8(p, vl);
+        vbool1_t m = __riscv_vmsne_vx_u8m8_b1(a, value, vl);
+
+        long index = __riscv_vfirst_m_b1(m, vl);
+        if (index >= 0)
+        {
+            return offset + (unsigned long)index;
+        }
+
+        offset += vl;
+        size -= vl;
+        p += vl;
+    }
+    while (size);
+
+    return offset;
+}
+
+size_t MemFindLast_rvv(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    const size_t total = size;
+    while (size)
+    {
+        // LMUL=4 so element indices fit into 16-bit lanes with LMUL=8
+        size_t vl = __riscv_vsetvl_e8m4(size);
+        size -= vl;
+
+        vuint8m4_t a = __riscv_vle8_v_u8m4(p + size, vl);
+        vbool2_t m = __riscv_vmseq_vx_u8m4_b2(a, value, vl);
+
+        if (__riscv_vcpop_m_b2(m, vl))
+        {
+            // highest index of active mask lane
+            vuint16m8_t index = __riscv_vid_v_u16m8(vl);
+            vuint16m1_t last = __riscv_vredmaxu_vs_u16m8_u16m1_m(m, index, __riscv_vmv_s_x_u16m1(0, 1), vl);
+            return size + __riscv_vmv_x_s_u16m1_u16(last);
+        }
+    }
+
+    return total;
+}
+
+size_t MemFindLastNot_rvv(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    const size_t total = size;
+    while (size)
+    {
+        // LMUL=4 so element indices fit into 16-bit lanes with LMUL=8
+        size_t vl = __riscv_vsetvl_e8m4(size);
+        size -= vl;
+
+        vuint8m4_t a = __riscv_vle8_v_u8m4(p + size, vl);
+        vbool2_t m = __riscv_vmsne_vx_u8m4_b2(a, value, vl);
+
+        if (__riscv_vcpop_m_b2(m, vl))
+        {
+            // highest index of active mask lane
+            vuint16m8_t index = __riscv_vid_v_u16m8(vl);
+            vuint16m1_t last = __riscv_vredmaxu_vs_u16m8_u16m1_m(m, index, __riscv_vmv_s_x_u16m1(0, 1), vl);
+            return size + __riscv_vmv_x_s_u16m1_u16(last);
+        }
+    }
+
+    return total;
+}
+
+size_t MemFindAny_rvv(const void* ptr, size_t size, const void* set, size_t setlen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* s = (const uint8_t*)set;
+
+    if (setlen == 0)
+    {
+        return size;
+    }
+    else if (setlen == 1)
+    {
+        return MemFind_rvv(ptr, size, s[0]);
+    }
+
+    size_t offset = 0;
+
+    if (setlen <= 3)
+    {
+        // for 2 byte set third value is same as second one
+        uint8_t v0 = s[0];
+        uint8_t v1 = s[1];
+        uint8_t v2 = s[setlen - 1];
+
+        do
+        {
+            size_t vl = __riscv_vsetvl_e8m8(size);
+
+            vuint8m8_t a = __riscv_vle8_v_u8m8(p, vl);
+            vbool1_t m0 = __riscv_vmseq_vx_u8m8_b1(a, v0, vl);
+            vbool1_t m1 = __riscv_vmseq_vx_u8m8_b1(a, v1, vl);
+            vbool1_t m2 = __riscv_vmseq_vx_u8m8_b1(a, v2, vl);
+            vbool1_t m = __riscv_vmor_mm_b1(__riscv_vmor_mm_b1(m0, m1, vl), m2, vl);
+
+            long index = __riscv_vfirst_m_b1(m, vl);
+            if (index >= 0)
+            {
+                return offset + (unsigned long)index;
+            }
+
+            offset += vl;
+            size -= vl;
+            p += vl;
+        }
+        while (size);
+
+        return offset;
+    }
+
+    // 256-bit bitmap of byte values in set
+    uint8_t bitmap[32] = { 0 };
+    for (size_t i=0; i<setlen; i++)
+    {
+        uint8_t b = s[i];
+        bitmap[b >> 3] |= (uint8_t)(1 << (b & 7));
+    }
+
+    // VLEN >= 128, so 32 bytes always fit into LMUL=8 register group
+    vuint8m8_t table = __riscv_vle8_v_u8m8(bitmap, __riscv_vsetvl_e8m8(32));
+
+    do
+    {
+        size_t vl = __riscv_vsetvl_e8m8(size);
+
+        vuint8m8_t a = __riscv_vle8_v_u8m8(p, vl);
+
+        // load bitmap byte for (value >> 3) and check (value & 7) bit in it
+        vuint8m8_t row = __riscv_vrgather_vv_u8m8(table, __riscv_vsrl_vx_u8m8(a, 3, vl), vl);
+        vuint8m8_t bit = __riscv_vsll_vv_u8m8(__riscv_vmv_v_x_u8m8(1, vl), __riscv_vand_vx_u8m8(a, 7, vl), vl);
+        vbool1_t m = __riscv_vmsne_vx_u8m8_b1(__riscv_vand_vv_u8m8(row, bit, vl), 0, vl);
+
+        long index = __riscv_vfirst_m_b1(m, vl);
+        if (index >= 0)
+        {
+            return offset + (unsigned long)index;
+        }
+
+        offset += vl;
+        size -= vl;
+        p += vl;
+    }
+    while (size);
+
+    return offset;
+}
+
+size_t MemFindBytes_rvv(const void* ptr, size_t size, const void* needle, size_t needlelen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* n = (const uint8_t*)needle;
+
+    if (needlelen == 0)
+    {
+        return 0;
+    }
+    else if (needlelen == 1)
+    {
+        return MemFind_rvv(ptr, size, n[0]);
+    }
+    else if (needlelen > size)
+    {
+        return size;
+    }
+
+    // offset of last needle byte, and amount of positions where needle can start
+    size_t last = needlelen - 1;
+    size_t count = size - last;
+
+    size_t offset = 0;
+    while (offset < count)
+    {
+        size_t vl = __riscv_vsetvl_e8m8(count - offset);
+
+        vuint8m8_t a0 = __riscv_vle8_v_u8m8(p + offset, vl);
+        vuint8m8_t a1 = __riscv_vle8_v_u8m8(p + offset + last, vl);
+
+        // positions where both first and last needle bytes match
+        vbool1_t m0 = __riscv_vmseq_vx_u8m8_b1(a0, n[0], vl);
+        vbool1_t m1 = __riscv_vmseq_vx_u8m8_b1(a1, n[last], vl);
+        vbool1_t m = __riscv_vmand_mm_b1(m0, m1, vl);
+
+        long index = __riscv_vfirst_m_b1(m, vl);
+        if (index < 0)
+        {
+            offset += vl;
+            continue;
+        }
+
+        // verify rest of the needle
+        offset += (unsigned long)index;
+        if (MemIsEqual_rvv(p + offset + 1, n + 1, needlelen - 2))
+        {
+            return offset;
+        }
+
+        // continue search right after rejected position
+        offset += 1;
+    }
+
+    // needle not found
+    return size;
+}
+
+size_t MemCount_rvv(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    size_t result = 0;
+    while (size)
+    {
+        size_t vl = __riscv_vsetvl_e8m8(size);
+
+        vuint8m8_t a = __riscv_vle8_v_u8m8(p, vl);
+        vbool1_t m = __riscv_vmseq_vx_u8m8_b1(a, value, vl);
+
+        // count set bits in comparison mask
+        result += __riscv_vcpop_m_b1(m, vl);
+
+        size -= vl;
+        p += vl;
+    }
+
+    return result;
+}
+
+size_t MemMismatch_rvv(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    size_t offset = 0;
+    while (size)
+    {
+        size_t vl = __riscv_vsetvl_e8m8(size);
+
+        vuint8m8_t a = __riscv_vle8_v_u8m8(p1, vl);
+        vuint8m8_t b = __riscv_vle8_v_u8m8(p2, vl);
+        vbool1_t m = __riscv_vmsne_vv_u8m8_b1(a, b, vl);
+
+        long index = __riscv_vfirst_m_b1(m, vl);
+        if (index >= 0)
+        {
+            return offset + (unsigned long)index;
+        }
+
+        offset += vl;
+        size -= vl;
+        p1 += vl;
+        p2 += vl;
+    }
+
+    return offset;
+}
+
+static MEM_FORCE_INLINE void MemConvertCase_rvv(uint8_t* dst, const uint8_t* src, size_t size, uint8_t first)
+{
+    while (size)
+    {
+        size_t vl = __riscv_vsetvl_e8m8(size);
+
+        vuint8m8_t a = __riscv_vle8_v_u8m8(src, vl);
+
+        // mask = (uint8_t)(x - first) <= ('Z' - 'A')
+        vbool1_t m = __riscv_vmsleu_vx_u8m8_b1(__riscv_vsub_vx_u8m8(a, first, vl), 'Z' - 'A', vl);
+
+        // x = mask ? (x ^ 0x20) : x
+        a = __riscv_vxor_vx_u8m8_mu(m, a, a, 'a' - 'A', vl);
+
+        __riscv_vse8_v_u8m8(dst, a, vl);
+
+        size -= vl;
+        src += vl;
+        dst += vl;
+    }
+}
+
+void MemToLower_rvv(void* dst, const void* src, size_t size)
+{
+    MemConvertCase_rvv((uint8_t*)dst, (const uint8_t*)src, size, 'A');
+}
+
+void MemToUpper_rvv(void* dst, const void* src, size_t size)
+{
+    MemConvertCase_rvv((uint8_t*)dst, (const uint8_t*)src, size, 'a');
+}
+
+size_t MemFindI_rvv(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    // letters are matched by setting 0x20 bit in input bytes, which maps uppercase letters to lowercase
+    const uint8_t fold = MemCaseBit1(value);
+    value |= fold;
+
+    size_t offset = 0;
+    do
+    {
+        size_t vl = __riscv_vsetvl_e8m8(size);
+
+        vuint8m8_t a = __riscv_vle8_v_u8m8(p, vl);
+        vbool1_t m = __riscv_vmseq_vx_u8m8_b1(__riscv_vor_vx_u8m8(a, fold, vl), value, vl);
+
+        long index = __riscv_vfirst_m_b1(m, vl);
+        if (index >= 0)
+        {
+            return offset + (unsigned long)index;
+        }
+
+        offset += vl;
+        size -= vl;
+        p += vl;
+    }
+    while (size);
+
+    return offset;
+}
+
+size_t MemFindBytesI_rvv(const void* ptr, size_t size, const void* needle, size_t needlelen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* n = (const uint8_t*)needle;
+
+    if (needlelen == 0)
+    {
+        return 0;
+    }
+    else if (needlelen == 1)
+    {
+        return MemFindI_rvv(ptr, size, n[0]);
+    }
+    else if (needlelen > size)
+    {
+        return size;
+    }
+
+    // offset of last needle byte, and amount of positions where needle can start
+    size_t last = needlelen - 1;
+    size_t count = size - last;
+
+    // letters are matched by setting 0x20 bit in input bytes, which maps uppercase letters to lowercase
+    const uint8_t first_fold = MemCaseBit1(n[0]);
+    const uint8_t last_fold = MemCaseBit1(n[last]);
+
+    size_t offset = 0;
+    while (offset < count)
+    {
+        size_t vl = __riscv_vsetvl_e8m8(count - offset);
+
+        vuint8m8_t a0 = __riscv_vle8_v_u8m8(p + offset, vl);
+        vuint8m8_t a1 = __riscv_vle8_v_u8m8(p + offset + last, vl);
+
+        // positions where both first and last needle bytes match
+        vbool1_t m0 = __riscv_vmseq_vx_u8m8_b1(__riscv_vor_vx_u8m8(a0, first_fold, vl), n[0] | first_fold, vl);
+        vbool1_t m1 = __riscv_vmseq_vx_u8m8_b1(__riscv_vor_vx_u8m8(a1, last_fold, vl), n[last] | last_fold, vl);
+        vbool1_t m = __riscv_vmand_mm_b1(m0, m1, vl);
+
+        long index = __riscv_vfirst_m_b1(m, vl);
+        if (index < 0)
+        {
+            offset += vl;
+            continue;
+        }
+
+        // verify rest of the needle
+        offset += (unsigned long)index;
+        if (MemCompareI_rvv(p + offset + 1, n + 1, needlelen - 2) == 0)
+        {
+            return offset;
+        }
+
+        // continue search right after rejected position
+        offset += 1;
+    }
+
+    // needle not found
+    return size;
+}
+
+size_t MemFindInRange_rvv(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (lo > hi)
+    {
+        // empty range, no byte can be inside it
+        return size;
+    }
+
+    // byte is inside range when unsigned (x - lo) <= (hi - lo)
+    const uint8_t range = (uint8_t)(hi - lo);
+
+    size_t offset = 0;
+    do
+    {
+        size_t vl = __riscv_vsetvl_e8m8(size);
+
+        vuint8m8_t a = __riscv_vle8_v_u8m8(p, vl);
+        vbool1_t m = __riscv_vmsleu_vx_u8m8_b1(__riscv_vsub_vx_u8m8(a, lo, vl), range, vl);
+
+        long index = __riscv_vfirst_m_b1(m, vl);
+        if (index >= 0)
+        {
+            return offset + (unsigned long)index;
+        }
+
+        offset += vl;
+        size -= vl;
+        p += vl;
+    }
+    while (size);
+
+    return offset;
+}
+
+size_t MemFindNotInRange_rvv(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (lo > hi)
+    {
+        // empty range, every byte is outside of it
+        return 0;
+    }
+
+    // byte is inside range when unsigned (x - lo) <= (hi - lo)
+    const uint8_t range = (uint8_t)(hi - lo);
+
+    size_t offset = 0;
+    do
+    {
+        size_t vl = __riscv_vsetvl_e8m8(size);
+
+        vuint8m8_t a = __riscv_vle8_v_u8m8(p, vl);
+        vbool1_t m = __riscv_vmsgtu_vx_u8m8_b1(__riscv_vsub_vx_u8m8(a, lo, vl), range, vl);
+
+        long index = __riscv_vfirst_m_b1(m, vl);
+        if (index >= 0)
+        {
+            return offset + (unsigned long)index;
+        }
+
+        offset += vl;
+        size -= vl;
+        p += vl;
+    }
+    while (size);
+
+    return offset;
+}
+
+size_t MemValidateUTF8_rvv(const void* ptr, size_t size)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    size_t offset = 0;
+    while (size)
+    {
+        size_t vl = __riscv_vsetvl_e8m8(size);
+
+        vuint8m8_t a = __riscv_vle8_v_u8m8(p, vl);
+        vbool1_t m = __riscv_vmsgtu_vx_u8m8_b1(a, 0x7f, vl);
+
+        size_t block = vl;
+
+        long index = __riscv_vfirst_m_b1(m, vl);
+        if (index >= 0)
+        {
+            // validate sequences starting from first non-ASCII byte with scalar code, last one may continue past the block
+            size_t i = (unsigned long)index;
+            while (i < vl)
+            {
+                size_t length = MemUTF8Sequence(p + i, size - i);
+                if (length == 0)
+                {
+                    return offset + i;
+                }
+                i += length;
+            }
+            block = i;
+        }
+
+        offset += block;
+        size -= block;
+        p += block;
+    }
+
+    return offset;
+}
+
+void MemClassify_rvv(const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* s = (const uint8_t*)set;
+
+    // 256-bit bitmap of byte values in set
+    uint8_t bitmap[32] = { 0 };
+    for (size_t i=0; i<setlen; i++)
+    {
+        uint8_t b = s[i];
+        bitmap[b >> 3] |= (uint8_t)(1 << (b & 7));
+    }
+
+    // VLEN >= 128, so 32 bytes always fit into LMUL=8 register group
+    vuint8m8_t table = __riscv_vle8_v_u8m8(bitmap, __riscv_vsetvl_e8m8(32));
+
+    while (size)
+    {
+        // VLEN >= 128, so 64-byte block always fits into LMUL=8 register group
+        size_t vl = __riscv_vsetvl_e8m8(size < 64 ? size : 64);
+
+        vuint8m8_t a = __riscv_vle8_v_u8m8(p, vl);
+
+        // load bitmap byte for (value >> 3) and check (value & 7) bit in it
+        vuint8m8_t row = __riscv_vrgather_vv_u8m8(table, __riscv_vsrl_vx_u8m8(a, 3, vl), vl);
+        vuint8m8_t bit = __riscv_vsll_vv_u8m8(__riscv_vmv_v_x_u8m8(1, vl), __riscv_vand_vx_u8m8(a, 7, vl), vl);
+        vbool1_t m = __riscv_vmsne_vx_u8m8_b1(__riscv_vand_vv_u8m8(row, bit, vl), 0, vl);
+
+        // store mask bits, only low "vl" bits are written
+        uint8_t bits[8] = { 0 };
+        __riscv_vsm_v_b1(bits, m, vl);
+        *masks++ = MEM_PTR64U(bits);
+
+        size -= vl;
+        p += vl;
+    }
+}
+
+size_t MemFind16_rvv(const void* ptr, size_t count, uint16_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    size_t offset = 0;
+    while (count)
+    {
+        size_t vl = __riscv_vsetvl_e16m8(count);
+
+        // load as bytes, because ptr may not be aligned to element size
+        vuint16m8_t a = __riscv_vreinterpret_v_u8m8_u16m8(__riscv_vle8_v_u8m8(p, vl * sizeof(value)));
+        vbool2_t m = __riscv_vmseq_vx_u16m8_b2(a, value, vl);
+
+        long index = __riscv_vfirst_m_b2(m, vl);
+        if (index >= 0)
+        {
+            return offset + (unsigned long)index;
+        }
+
+        offset += vl;
+        count -= vl;
+        p += vl * sizeof(value);
+    }
+
+    return offset;
+}
+
+size_t MemFind32_rvv(const void* ptr, size_t count, uint32_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    size_t offset = 0;
+    while (count)
+    {
+        size_t vl = __riscv_vsetvl_e32m8(count);
+
+        // load as bytes, because ptr may not be aligned to element size
+        vuint32m8_t a = __riscv_vreinterpret_v_u8m8_u32m8(__riscv_vle8_v_u8m8(p, vl * sizeof(value)));
+        vbool4_t m = __riscv_vmseq_vx_u32m8_b4(a, value, vl);
+
+        long index = __riscv_vfirst_m_b4(m, vl);
+        if (index >= 0)
+        {
+            return offset + (unsigned long)index;
+        }
+
+        offset += vl;
+        count -= vl;
+        p += vl * sizeof(value);
+    }
+
+    return offset;
+}
+
+size_t MemFind64_rvv(const void* ptr, size_t count, uint64_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    size_t offset = 0;
+    while (count)
+    {
+        size_t vl = __riscv_vsetvl_e64m8(count);
+
+        // load as bytes, because ptr may not be aligned to element size
+        vuint64m8_t a = __riscv_vreinterpret_v_u8m8_u64m8(__riscv_vle8_v_u8m8(p, vl * sizeof(value)));
+        vbool8_t m = __riscv_vmseq_vx_u64m8_b8(a, value, vl);
+
+        long index = __riscv_vfirst_m_b8(m, vl);
+        if (index >= 0)
+        {
+            return offset + (unsigned long)index;
+        }
+
+        offset += vl;
+        count -= vl;
+        p += vl * sizeof(value);
+    }
+
+    return offset;
+}
+
+size_t MemFindNot16_rvv(const void* ptr, size_t count, uint16_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    size_t offset = 0;
+    while (count)
+    {
+        size_t vl = __riscv_vsetvl_e16m8(count);
+
+        // load as bytes, because ptr may not be aligned to element size
+        vuint16m8_t a = __riscv_vreinterpret_v_u8m8_u16m8(__riscv_vle8_v_u8m8(p, vl * sizeof(value)));
+        vbool2_t m = __riscv_vmsne_vx_u16m8_b2(a, value, vl);
+
+        long index = __riscv_vfirst_m_b2(m, vl);
+        if (index >= 0)
+        {
+            return offset + (unsigned long)index;
+        }
+
+        offset += vl;
+        count -= vl;
+        p += vl * sizeof(value);
+    }
+
+    return offset;
+}
+
+size_t MemFindNot32_rvv(const void* ptr, size_t count, uint32_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    size_t offset = 0;
+    while (count)
+    {
+        size_t vl = __riscv_vsetvl_e32m8(count);
+
+        // load as bytes, because ptr may not be aligned to element size
+        vuint32m8_t a = __riscv_vreinterpret_v_u8m8_u32m8(__riscv_vle8_v_u8m8(p, vl * sizeof(value)));
+        vbool4_t m = __riscv_vmsne_vx_u32m8_b4(a, value, vl);
+
+        long index = __riscv_vfirst_m_b4(m, vl);
+        if (index >= 0)
+        {
+            return offset + (unsigned long)index;
+        }
+
+        offset += vl;
+        count -= vl;
+        p += vl * sizeof(value);
+    }
+
+    return offset;
+}
+
+size_t MemFindNot64_rvv(const void* ptr, size_t count, uint64_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    size_t offset = 0;
+    while (count)
+    {
+        size_t vl = __riscv_vsetvl_e64m8(count);
+
+        // load as bytes, because ptr may not be aligned to element size
+        vuint64m8_t a = __riscv_vreinterpret_v_u8m8_u64m8(__riscv_vle8_v_u8m8(p, vl * sizeof(value)));
+        vbool8_t m = __riscv_vmsne_vx_u64m8_b8(a, value, vl);
+
+        long index = __riscv_vfirst_m_b8(m, vl);
+        if (index >= 0)
+        {
+            return offset + (unsigned long)index;
+        }
+
+        offset += vl;
+        count -= vl;
+        p += vl * sizeof(value);
+    }
+
+    return offset;
+}
+
+size_t MemLowerBound32_rvv(const void* ptr, size_t count, uint32_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    // VLEN >= 128, so 32 elements always fit into LMUL=8 register group
+    if (count < 32)
+    {
+        return MemLowerBound32_generic(ptr, count, value);
+    }
+
+    // binary search down to 32 elements, which are compared all at once
+    size_t start = MemLowerBoundWindow(p, count, value, sizeof(value), 32);
+    p += start * sizeof(value);
+
+    size_t vl = __riscv_vsetvl_e32m8(32);
+
+    // load as bytes, because ptr may not be aligned to element size
+    vuint32m8_t a = __riscv_vreinterpret_v_u8m8_u32m8(__riscv_vle8_v_u8m8(p, vl * sizeof(value)));
+    vbool4_t m = __riscv_vmsltu_vx_u32m8_b4(a, value, vl);
+
+    return start + __riscv_vcpop_m_b4(m, vl);
+}
+
+size_t MemLowerBound64_rvv(const void* ptr, size_t count, uint64_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    // VLEN >= 128, so 16 elements always fit into LMUL=8 register group
+    if (count < 16)
+    {
+        return MemLowerBound64_generic(ptr, count, value);
+    }
+
+    // binary search down to 16 elements, which are compared all at once
+    size_t start = MemLowerBoundWindow(p, count, value, sizeof(value), 16);
+    p += start * sizeof(value);
+
+    size_t vl = __riscv_vsetvl_e64m8(16);
+
+    // load as bytes, because ptr may not be aligned to element size
+    vuint64m8_t a = __riscv_vreinterpret_v_u8m8_u64m8(__riscv_vle8_v_u8m8(p, vl * sizeof(value)));
+    vbool8_t m = __riscv_vmsltu_vx_u64m8_b8(a, value, vl);
+
+    return start + __riscv_vcpop_m_b8(m, vl);
+}
+
+void MemTranslate_rvv(void* dst, const void* src, size_t size, const uint8_t table[256])
+{
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+
+    while (size)
+    {
+        size_t vl = __riscv_vsetvl_e8m8(size);
+
+        // every input byte is unsigned offset into table, so indexed load does the lookup
+        // this works for any VLEN, vrgather would need 256 bytes in one register group
+        vuint8m8_t a = __riscv_vle8_v_u8m8(s, vl);
+        vuint8m8_t r = __riscv_vluxei8_v_u8m8(table, a, vl);
+        __riscv_vse8_v_u8m8(d, r, vl);
+
+        size -= vl;
+        s += vl;
+        d += vl;
+    }
+}
+
+// adds 64-byte stripe to 8 accumulators, for every 64-bit lane "i":
+// acc[i] += low32(data[i] ^ key[i]) * high32(data[i] ^ key[i]) + data[i ^ 1]
+static MEM_FORCE_INLINE vuint64m4_t MemHashStripe_rvv(vuint64m4_t acc, const uint8_t* p, const uint64_t* key, vuint64m4_t swap, size_t vl)
+{
+    // load as bytes, because ptr may not be aligned to 8 bytes
+    vuint64m4_t data = __riscv_vreinterpret_v_u8m4_u64m4(__riscv_vle8_v_u8m4(p, 64));
+    vuint64m4_t mixed = __riscv_vxor_vv_u64m4(data, __riscv_vle64_v_u64m4(key, vl), vl);
+
+    vuint64m4_t product = __riscv_vmul_vv_u64m4(__riscv_vand_vx_u64m4(mixed, 0xffffffff, vl), __riscv_vsrl_vx_u64m4(mixed, 32, vl), vl);
+    vuint64m4_t swapped = __riscv_vrgather_vv_u64m4(data, swap, vl);
+    return __riscv_vadd_vv_u64m4(acc, __riscv_vadd_vv_u64m4(product, swapped, vl), vl);
+}
+
+uint64_t MemHash64_rvv(const void* ptr, size_t size, uint64_t seed)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (size <= 16)
+    {
+        return MemHashSmall(p, size, seed);
+    }
+    else if (size <= 256)
+    {
+        return MemHashMedium(p, size, seed);
+    }
+
+    // all 8 accumulators fit in one register group, because VLEN is at least 128 bits
+    size_t vl = __riscv_vsetvl_e64m4(8);
+
+    // indices to swap neighbouring 64-bit lanes
+    vuint64m4_t swap = __riscv_vxor_vx_u64m4(__riscv_vid_v_u64m4(vl), 1, vl);
+
+    vuint64m4_t acc = __riscv_vadd_vx_u64m4(__riscv_vle64_v_u64m4(MemHashSecret + 24, vl), seed, vl);
+
+    const uint8_t* end = p + size;
+
+    // 1024-byte blocks of 16 stripes, each stripe uses key shifted by 8 bytes
+    while (end - p > 1024)
+    {
+        for (size_t i=0; i<16; i++)
+        {
+            acc = MemHashStripe_rvv(acc, p + i * 64, MemHashSecret + i, swap, vl);
+        }
+
+        // acc = (acc ^ (acc >> 47) ^ key) * prime
+        acc = __riscv_vxor_vv_u64m4(acc, __riscv_vsrl_vx_u64m4(acc, 47, vl), vl);
+        acc = __riscv_vxor_vv_u64m4(acc, __riscv_vle64_v_u64m4(MemHashSecret + 16, vl), vl);
+        acc = __riscv_vmul_vx_u64m4(acc, 0x9e3779b1, vl);
+        p += 1024;
+    }
+
+    // remaining stripes, there are at most 15 of them
+    for (size_t i=0; end - p > 64; i++)
+    {
+        acc = MemHashStripe_rvv(acc, p, MemHashSecret + i, swap, vl);
+        p += 64;
+    }
+
+    // last 64 bytes, may overlap with previous stripe
+    acc = MemHashStripe_rvv(acc, end - 64, MemHashSecret + 16, swap, vl);
+
+    uint64_t result[8];
+    __riscv_vse64_v_u64m4(result, acc, vl);
+    return MemHashMerge(result, size, seed);
+}
+
+void MemIsEqualBatch_rvv(const MemPair* pairs, size_t count, uint8_t* results)
+{
+    for (size_t i=0; i<count; i++)
+    {
+        const MemPair* pair = &pairs[i];
+        MemPrefetchPair(pairs, i + 8, count);
+
+        // loads are exactly vl bytes long, short buffers need only one iteration
+        results[i] = MemIsEqual_rvv(pair->ptr1, pair->ptr2, pair->size);
+    }
+}
+
+void MemCompareBatch_rvv(const MemPair* pairs, size_t count, int* results)
+{
+    for (size_t i=0; i<count; i++)
+    {
+        const MemPair* pair = &pairs[i];
+        MemPrefetchPair(pairs, i + 8, count);
+
+        results[i] = MemCompare_rvv(pair->ptr1, pair->ptr2, pair->size);
+    }
+}
+
+bool MemIsEqualConstTime_rvv(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    // count of different bytes is accumulated without branching on it
+    size_t diff = 0;
+    while (size)
+    {
+        size_t vl = __riscv_vsetvl_e8m8(size);
+
+        vuint8m8_t a = __riscv_vle8_v_u8m8(p1, vl);
+        vuint8m8_t b = __riscv_vle8_v_u8m8(p2, vl);
+        vbool1_t m = __riscv_vmsne_vv_u8m8_b1(a, b, vl);
+
+        diff += __riscv_vcpop_m_b1(m, vl);
+
+        size -= vl;
+        p1 += vl;
+        p2 += vl;
+    }
+
+    return diff == 0;
+}
+
+MemPosition MemFindV_rvv(const MemSegment* segments, size_t count, uint8_t value)
+{
+    return MemFindSegments(segments, count, value, &MemFind_rvv);
+}
+
+bool MemIsEqualV_rvv(const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2)
+{
+    return MemIsEqualSegments(segments1, count1, segments2, count2, &MemIsEqual_rvv);
+}
+
+#endif // MEM_ARCH_RVV
+
+
+#if MEM_ARCH_X64
+
+#define MEM_CPUID_INIT       (1 << 0)
+#define MEM_CPUID_AVX2       (1 << 1)
+#define MEM_CPUID_AVX512     (1 << 2)
+#define MEM_CPUID_AVX512VBMI (1 << 3)
+#define MEM_CPUID_AVX10      (1 << 4)
+
+// MEMFUN_ISA=avx512bw value, only for testing AVX-512 dispatch without AVX512VBMI on CPUs that have it
+#define MEM_ISA_AVX512BW (1 << 30)
+
+MEM_TARGET_XSAVE MEM_DISABLE_ASAN
+static int MemDoCPUID(void)
+{
+    int info[4];
+
+    MEM_CPUID(1, info);
+    int xsave = info[2] & (1 << 26);
+
+    MEM_CPUID2(7, 0, info);
+    int bmi1 = info[1] & (1 << 3);
+    int avx2 = info[1] & (1 << 5);
+    int bmi2 = info[1] & (1 << 8);
+
+    int avx512f    = info[1] & (1 << 16);
+    int avx512bw   = info[1] & (1 << 30);
+    int avx512vl   = (info[1] >> 31) & 1;
+    int avx512vbmi = info[2] & (1 << 1);
+
+    MEM_CPUID2(7, 1, info);
+    int avx10 = info[3] & (1 << 19);
+
+    // leaf 0x24 is valid only when AVX10 bit is set
+    int avx10_256 = 0;
+    if (avx10)
+    {
+        MEM_CPUID2(0x24, 0, info);
+        avx10_256 = info[1] & (1 << 17);
+    }
+
+    uint64_t xcr0 = xsave ? MEM_XGETBV(0) : 0;
+    int ymm = (xcr0 & 0x04) == 0x04;
+    int zmm = (xcr0 & 0xe0) == 0xe0;
+
+    int cpuid = 0;
+    // avx2 kernels do not use BMI or MOVBE instructions, so virtualized guests that hide them still get avx2
+    // only few avx512 kernels need VBMI, others work on CPUs without it like Skylake-SP and Cascade Lake
+    cpuid |= (ymm && avx2)                                              ? MEM_CPUID_AVX2       : 0;
+    cpuid |= (zmm && avx512f && avx512bw && bmi1 && bmi2)               ? MEM_CPUID_AVX512     : 0;
+    cpuid |= (zmm && avx512f && avx512bw && avx512vbmi && bmi1 && bmi2) ? MEM_CPUID_AVX512VBMI : 0;
+    // AVX10 needs same OS support for opmask and upper register state as AVX-512, even with only 256-bit vectors
+    cpuid |= (zmm && ((avx512f && avx512bw && avx512vl) || avx10_256) && bmi1 && bmi2) ? MEM_CPUID_AVX10 : 0;
+    return cpuid;
+}
+
+#elif MEM_ARCH_SVE
+
+#define MEM_CPUID_INIT (1 << 0)
+#define MEM_CPUID_SVE  (1 << 1)
+#define MEM_CPUID_SVE2 (1 << 2)
+
+static int MemDoCPUID(void)
+{
+    // kernel reports SVE only when it saves and restores SVE registers on context switch
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    unsigned long hwcap2 = getauxval(AT_HWCAP2);
+
+    int sve = (hwcap & HWCAP_SVE) != 0;
+    int sve2 = (hwcap2 & HWCAP2_SVE2) != 0;
+
+    int cpuid = 0;
+    cpuid |= sve           ? MEM_CPUID_SVE  : 0;
+    cpuid |= (sve && sve2) ? MEM_CPUID_SVE2 : 0;
+    return cpuid;
+}
+
+#endif
+
+#if MEM_ARCH_X64 || MEM_ARCH_SVE
+
+#if MEM_ARCH_X64 && defined(MEM_DISPATCH_IFUNC)
+// ifunc resolvers can run before C runtime sets up errno or sanitizer interceptors, so syscalls are done directly
+MEM_DISABLE_ASAN
+static long MemSyscall3(long number, long arg1, long arg2, long arg3)
+{
+    long result;
+    __asm__ __volatile__("syscall" : "=a"(result) : "a"(number), "D"(arg1), "S"(arg2), "d"(arg3) : "rcx", "r11", "memory");
+    return result;
+}
+#endif
+
+// returns MEM_ISA_* value of MEMFUN_ISA environment variable, or 0 if it is not set
+MEM_DISABLE_ASAN
+static int MemGetEnvISA(void)
+{
+    // longer values are truncated and never match
+    char value[12] = { 0 };
+
+#if MEM_ARCH_X64 && defined(MEM_DISPATCH_IFUNC)
+    // ifunc resolvers run before C runtime sets up environment, so read it directly
+    long fd = MemSyscall3(SYS_open, (long)"/proc/self/environ", O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        return 0;
+    }
+
+    static const char prefix[] = "MEMFUN_ISA=";
+
+    char buffer[1024];
+    long count;
+
+    size_t pos = 0;
+    size_t length = 0;
+    bool match = true;
+    bool found = false;
+
+    // environment is sequence of zero terminated "name=value" entries
+    while (!found && (count = MemSyscall3(SYS_read, fd, (long)buffer, sizeof(buffer))) > 0)
+    {
+        for (long i=0; i<count; i++)
+        {
+            char c = buffer[i];
+            if (c == 0)
+            {
+                if (match && pos >= sizeof(prefix) - 1)
+                {
+                    found = true;
+                    break;
+                }
+                pos = 0;
+                length = 0;
+                match = true;
+                continue;
+            }
+
+            if (pos < sizeof(prefix) - 1)
+            {
+                match = match && c == prefix[pos];
+            }
+            else if (match && length < sizeof(value) - 1)
+            {
+                value[length++] = c;
+            }
+            pos++;
+        }
+    }
+    MemSyscall3(SYS_close, fd, 0, 0);
+
+    if (!found)
+    {
+        return 0;
+    }
+#else
+#if MEM_COMPILER_MSVC
+#pragma warning(suppress : 4996)
+#endif
+    const char* env = getenv("MEMFUN_ISA");
+    if (!env)
+    {
+        return 0;
+    }
+
+    for (size_t i=0; i<sizeof(value) - 1 && env[i]; i++)
+    {
+        value[i] = env[i];
+    }
+#endif
+
+    static const struct
+    {
+        const char* name;
+        int isa;
+    }
+    names[] =
+    {
+#if MEM_ARCH_X64
+        { "sse2",     MEM_ISA_SSE2     },
+        { "avx2",     MEM_ISA_AVX2     },
+        { "avx10",    MEM_ISA_AVX10    },
+        { "avx512",   MEM_ISA_AVX512   },
+        { "avx512bw", MEM_ISA_AVX512BW },
+#else
+        { "neon",     MEM_ISA_NEON     },
+        { "sve",      MEM_ISA_SVE      },
+#endif
+    };
+
+    for (size_t n=0; n<sizeof(names) / sizeof(names[0]); n++)
+    {
+        size_t i = 0;
+        while (names[n].name[i] && names[n].name[i] == value[i])
+        {
+            i++;
+        }
+        if (names[n].name[i] == 0 && value[i] == 0)
+        {
+            return names[n].isa;
+        }
+    }
+    return 0;
+}
+
+// removes instruction sets newer than preferred MEM_ISA_* value "isa" from cpuid flags
+MEM_DISABLE_ASAN
+static int MemLimitCPUID(int cpuid, int isa)
+{
+    switch (isa)
+    {
+#if MEM_ARCH_X64
+    case MEM_ISA_SSE2:     return cpuid & ~(MEM_CPUID_AVX2 | MEM_CPUID_AVX10 | MEM_CPUID_AVX512 | MEM_CPUID_AVX512VBMI);
+    case MEM_ISA_AVX2:     return cpuid & ~(MEM_CPUID_AVX10 | MEM_CPUID_AVX512 | MEM_CPUID_AVX512VBMI);
+    case MEM_ISA_AVX10:    return cpuid & ~(MEM_CPUID_AVX512 | MEM_CPUID_AVX512VBMI);
+    case MEM_ISA_AVX512BW: return cpuid & ~MEM_CPUID_AVX512VBMI;
+#else
+    case MEM_ISA_NEON:     return cpuid & ~(MEM_CPUID_SVE | MEM_CPUID_SVE2);
+#endif
+    default:               return cpuid;
+    }
+}
+
+// instruction sets used by dispatch functions, 0 when not yet initialized
+static int MemCPUIDSelected;
+
+// instruction sets enabled at compile time, these are always used without checking cpuid at runtime
+MEM_FORCE_INLINE
+static int MemCPUIDCompiled(void)
+{
+    int result = 0;
+
+#if (MEM_COMPILER_CLANG || MEM_COMPILER_GCC) && defined(__AVX512F__) && defined(__AVX512BW__) && defined(__BMI__) && defined(__BMI2__)
+    result |= MEM_CPUID_AVX512;
+#  if defined(__AVX512VBMI__)
+    result |= MEM_CPUID_AVX512VBMI;
+#  endif
+#endif
+#if MEM_COMPILER_MSVC && defined(__AVX512F__) && defined(__AVX512BW__)
+    result |= MEM_CPUID_AVX512;
+#endif
+#if (MEM_COMPILER_CLANG || MEM_COMPILER_GCC) && defined(__AVX512VL__) && defined(__AVX512BW__) && defined(__BMI__) && defined(__BMI2__)
+    result |= MEM_CPUID_AVX10;
+#endif
+#if MEM_COMPILER_MSVC && defined(__AVX512VL__) && defined(__AVX512BW__)
+    result |= MEM_CPUID_AVX10;
+#endif
+#if (MEM_COMPILER_CLANG || MEM_COMPILER_GCC) && defined(__AVX2__)
+    result |= MEM_CPUID_AVX2;
+#endif
+#if MEM_COMPILER_MSVC && defined(__AVX2__)
+    result |= MEM_CPUID_AVX2;
+#endif
+#if MEM_ARCH_SVE && defined(__ARM_FEATURE_SVE)
+    result |= MEM_CPUID_SVE;
+#  if defined(__ARM_FEATURE_SVE2)
+    result |= MEM_CPUID_SVE2;
+#  endif
+#endif
+
+    return result;
+}
+
+MEM_FORCE_INLINE
+static int MemCPUID(void)
+{
+    int result = MemCPUIDCompiled();
+
+    if (result == 0)
+    {
+        result = MEM_GET32_RELAXED(&MemCPUIDSelected);
+        if (result == 0)
+        {
+            result = MEM_CPUID_INIT | MemLimitCPUID(MemDoCPUID(), MemGetEnvISA());
+            MEM_SET32_RELAXED(&MemCPUIDSelected, result);
+        }
+    }
+
+    return result;
+}
+
+#endif // MEM_ARCH_X64 || MEM_ARCH_SVE
+
+
+int MemCompare_generic(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    while (size >= 8)
+    {
+        uint64_t a = MEM_PTR64U(p1);
+        uint64_t b = MEM_PTR64U(p2);
+        if (a != b)
+        {
+            a = MEM_BSWAP64(a);
+            b = MEM_BSWAP64(b);
+            return (a > b) - (a < b);
+        }
+
+        size -= 8;
+        p1 += 8;
+        p2 += 8;
+    }
+
+    if (size & 4) // 4 <= size < 8
+    {
+        uint64_t a0 = MEM_PTR32U(p1);
+        uint64_t b0 = MEM_PTR32U(p2);
+        uint64_t a1 = MEM_PTR32U(p1 + size - 4);
+        uint64_t b1 = MEM_PTR32U(p2 + size - 4);
+        uint64_t a = MEM_BSWAP64(a0 | (a1 << 32));
+        uint64_t b = MEM_BSWAP64(b0 | (b1 << 32));
+        return (a > b) - (a < b);
+    }
+
+    if (size & 2) // 2 <= size < 4
+    {
+        uint32_t a0 = MEM_PTR16U(p1);
+        uint32_t b0 = MEM_PTR16U(p2);
+        uint32_t a1 = MEM_PTR16U(p1 + size - 2);
+        uint32_t b1 = MEM_PTR16U(p2 + size - 2);
+        uint32_t a = MEM_BSWAP32(a0 | (a1 << 16));
+        uint32_t b = MEM_BSWAP32(b0 | (b1 << 16));
+        return (a > b) - (a < b);
+    }
+
+    if (size) // 1 <= size < 2
+    {
+        return p1[0] - p2[0];
+    }
+
+    return 0;
+}
+
+int MemCompareI_generic(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    while (size >= 8)
+    {
+        uint64_t a = MemToLower8(MEM_PTR64U(p1));
+        uint64_t b = MemToLower8(MEM_PTR64U(p2));
+        if (a != b)
+        {
+            a = MEM_BSWAP64(a);
+            b = MEM_BSWAP64(b);
+            return (a > b) - (a < b);
+        }
+
+        size -= 8;
+        p1 += 8;
+        p2 += 8;
+    }
+
+    if (size & 4) // 4 <= size < 8
+    {
+        uint64_t a0 = MEM_PTR32U(p1);
+        uint64_t b0 = MEM_PTR32U(p2);
+        uint64_t a1 = MEM_PTR32U(p1 + size - 4);
+        uint64_t b1 = MEM_PTR32U(p2 + size - 4);
+        uint64_t a = MEM_BSWAP64(MemToLower8(a0 | (a1 << 32)));
+        uint64_t b = MEM_BSWAP64(MemToLower8(b0 | (b1 << 32)));
+        return (a > b) - (a < b);
+    }
+
+    if (size & 2) // 2 <= size < 4
+    {
+        uint64_t a0 = MEM_PTR16U(p1);
+        uint64_t b0 = MEM_PTR16U(p2);
+        uint64_t a1 = MEM_PTR16U(p1 + size - 2);
+        uint64_t b1 = MEM_PTR16U(p2 + size - 2);
+        uint64_t tmp = MEM_BSWAP64(MemToLower8(a0 | (a1 << 16) | (b0 << 32) | (b1 << 48)));
+        uint32_t a = (uint32_t)(tmp >> 32);
+        uint32_t b = (uint32_t)tmp;
+        return (a > b) - (a < b);
+    }
+
+    if (size) // 1 <= size < 2
+    {
+        return MemToLower1(p1[0]) - MemToLower1(p2[0]);
+    }
+
+    return 0;
+}
+
+bool MemIsEqual_generic(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    while (size >= 8)
+    {
+        uint64_t a = MEM_PTR64U(p1);
+        uint64_t b = MEM_PTR64U(p2);
+        if (a != b)
+        {
+            return false;
+        }
+
+        size -= 8;
+        p1 += 8;
+        p2 += 8;
+    }
+
+    if (size & 4) // 4 <= size < 8
+    {
+        uint32_t a0 = MEM_PTR32U(p1);
+        uint32_t b0 = MEM_PTR32U(p2);
+        uint32_t a1 = MEM_PTR32U(p1 + size - 4);
+        uint32_t b1 = MEM_PTR32U(p2 + size - 4);
+        return (a0 == b0) & (a1 == b1);
+    }
+
+    if (size & 2) // 2 <= size < 4
+    {
+        uint16_t a0 = MEM_PTR16U(p1);
+        uint16_t b0 = MEM_PTR16U(p2);
+        uint16_t a1 = MEM_PTR16U(p1 + size - 2);
+        uint16_t b1 = MEM_PTR16U(p2 + size - 2);
+        return (a0 == b0) & (a1 == b1);
+    }
+
+    if (size) // 1 <= size < 2
+    {
+        return p1[0] == p2[0];
+    }
+
+    return true;
+}
+
+static inline uint64_t MemByteMask8(uint64_t value, uint8_t byte)
+{
+    const uint64_t splat = ~0ULL / 255;
+    const uint64_t msb = 0x80 * splat;
+    const uint64_t lsb = 0x01 * splat;
+
+    uint64_t x = value ^ (byte * splat);
+    return (x - lsb) & (~x) & msb;
+}
+
+// same as MemByteMask8, but without false positives above matching byte (due to borrow)
+// required when looking for last matching byte, or for bytes not matching input value
+static inline uint64_t MemByteMaskExact8(uint64_t value, uint8_t byte)
+{
+    const uint64_t splat = ~0ULL / 255;
+    const uint64_t low = 0x7f * splat;
+
+    uint64_t x = value ^ (byte * splat);
+    return ~(((x & low) + low) | x | low);
+}
+
+// sets top bit for every byte where unsigned (byte - lo) > range, without false positives
+static inline uint64_t MemByteOutOfRange8(uint64_t value, uint8_t lo, uint8_t range)
+{
+    const uint64_t splat = ~0ULL / 255;
+    const uint64_t high = 0x80 * splat;
+    const uint64_t low = 0x7f * splat;
+
+    // subtract lo from every byte without borrowing across byte boundaries
+    uint64_t lo8 = lo * splat;
+    uint64_t x = ((value | high) - (lo8 & low)) ^ ((value ^ ~lo8) & high);
+
+    // compare low 7 bits against low 7 bits of range, this cannot carry into next byte
+    uint64_t above = (x & low) + (0x7f - (range & 0x7f)) * splat;
+
+    // combine with top bit of every byte
+    return ((range & 0x80) ? (x & above) : (x | above)) & high;
+}
+
+size_t MemFind_generic(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    size_t offset = 0;
+
+    while (size >= 8)
+    {
+        uint64_t a = MEM_PTR64U(p);
+        uint64_t m = MemByteMask8(a, value);
+        if (m)
+        {
+            return offset + (MEM_CTZ64(m) / 8);
+        }
+
+        offset += 8;
+        size -= 8;
+        p += 8;
+    }
+
+    if (size & 4) // 4 <= size < 8
+    {
+        uint64_t a0 = MEM_PTR32U(p);
+        uint64_t a1 = MEM_PTR32U(p + size - 4);
+        uint64_t a = a0 | (a1 << 32);
+        uint64_t m = MemByteMask8(a, value);
+
+        size_t index = (m ? MEM_CTZ64(m) : 64) / 8;
+
+        // index = (index < 4) ? index : (index - 4) + (size - 4);
+        index += (index >= 4) * (size - 8);
+
+        return offset + index;
+    }
+    else if (size & 2) // 2 <= size < 4
+    {
+        uint32_t a0 = MEM_PTR16U(p);
+        uint32_t a1 = MEM_PTR16U(p + size - 2);
+        uint32_t a = a0 | (a1 << 16);
+        uint32_t m = (uint32_t)MemByteMask8(a, value);
+
+        size_t index = (m ? MEM_CTZ32(m) : 32) / 8;
+
+        // index = (index < 2) ? index : (index - 2) + (size - 2);
+        index += (index >= 2) * (size - 4);
+
+        return offset + index;
+    }
+    else if (size) // size == 1
+    {
+        return offset + (p[0] == value ? 0 : 1);
+    }
+
+    return offset + size;
+}
+
+size_t MemFindNot_generic(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    size_t offset = 0;
+
+    while (size >= 8)
+    {
+        uint64_t a = MEM_PTR64U(p);
+        uint64_t m = MemByteMaskExact8(a, value) ^ 0x8080808080808080;
+        if (m)
+        {
+            return offset + (MEM_CTZ64(m) / 8);
+        }
+
+        offset += 8;
+        size -= 8;
+        p += 8;
+    }
+
+    if (size & 4) // 4 <= size < 8
+    {
+        uint64_t a0 = MEM_PTR32U(p);
+        uint64_t a1 = MEM_PTR32U(p + size - 4);
+        uint64_t a = a0 | (a1 << 32);
+        uint64_t m = MemByteMaskExact8(a, value) ^ 0x8080808080808080;
+
+        size_t index = (m ? MEM_CTZ64(m) : 64) / 8;
+
+        // index = (index < 4) ? index : (index - 4) + (size - 4);
+        index += (index >= 4) * (size - 8);
+
+        return offset + index;
+    }
+    else if (size & 2) // 2 <= size < 4
+    {
+        uint32_t a0 = MEM_PTR16U(p);
+        uint32_t a1 = MEM_PTR16U(p + size - 2);
+        uint32_t a = a0 | (a1 << 16);
+        uint32_t m = (uint32_t)MemByteMaskExact8(a, value) ^ 0x80808080;
+
+        size_t index = (m ? MEM_CTZ32(m) : 32) / 8;
+
+        // index = (index < 2) ? index : (index - 2) + (size - 2);
+        index += (index >= 2) * (size - 4);
+
+        return offset + index;
+    }
+    else if (size) // size == 1
+    {
+        return offset + (p[0] != value ? 0 : 1);
+    }
+
+    return offset + size;
+}
+
+size_t MemFindLast_generic(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    const size_t total = size;
+
+    while (size >= 8)
+    {
+        size -= 8;
+
+        uint64_t a = MEM_PTR64U(p + size);
+        uint64_t m = MemByteMaskExact8(a, value);
+        if (m)
+        {
+            return size + (MEM_BSR64(m) / 8);
+        }
+    }
+
+    if (size & 4) // 4 <= size < 8
+    {
+        uint64_t a0 = MEM_PTR32U(p);
+        uint64_t a1 = MEM_PTR32U(p + size - 4);
+        uint64_t a = a0 | (a1 << 32);
+        uint64_t m = MemByteMaskExact8(a, value);
+        if (m == 0)
+        {
+            return total;
+        }
+
+        size_t index = MEM_BSR64(m) / 8;
+
+        // index = (index < 4) ? index : (index - 4) + (size - 4);
+        index += (index >= 4) * (size - 8);
+
+        return index;
+    }
+    else if (size & 2) // 2 <= size < 4
+    {
+        uint32_t a0 = MEM_PTR16U(p);
+        uint32_t a1 = MEM_PTR16U(p + size - 2);
+        uint32_t a = a0 | (a1 << 16);
+        uint32_t m = (uint32_t)MemByteMaskExact8(a, value);
+        if (m == 0)
+        {
+            return total;
+        }
+
+        size_t index = MEM_BSR32(m) / 8;
+
+        // index = (index < 2) ? index : (index - 2) + (size - 2);
+        index += (index >= 2) * (size - 4);
+
+        return index;
+    }
+    else if (size) // size == 1
+    {
+        return p[0] == value ? 0 : total;
+    }
+
+    return total;
+}
+
+size_t MemFindLastNot_generic(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    const size_t total = size;
+
+    while (size >= 8)
+    {
+        size -= 8;
+
+        uint64_t a = MEM_PTR64U(p + size);
+        uint64_t m = MemByteMaskExact8(a, value) ^ 0x8080808080808080;
+        if (m)
+        {
+            return size + (MEM_BSR64(m) / 8);
+        }
+    }
+
+    if (size & 4) // 4 <= size < 8
+    {
+        uint64_t a0 = MEM_PTR32U(p);
+        uint64_t a1 = MEM_PTR32U(p + size - 4);
+        uint64_t a = a0 | (a1 << 32);
+        uint64_t m = MemByteMaskExact8(a, value) ^ 0x8080808080808080;
+        if (m == 0)
+        {
+            return total;
+        }
+
+        size_t index = MEM_BSR64(m) / 8;
+
+        // index = (index < 4) ? index : (index - 4) + (size - 4);
+        index += (index >= 4) * (size - 8);
+
+        return index;
+    }
+    else if (size & 2) // 2 <= size < 4
+    {
+        uint32_t a0 = MEM_PTR16U(p);
+        uint32_t a1 = MEM_PTR16U(p + size - 2);
+        uint32_t a = a0 | (a1 << 16);
+        uint32_t m = (uint32_t)MemByteMaskExact8(a, value) ^ 0x80808080;
+        if (m == 0)
+        {
+            return total;
+        }
+
+        size_t index = MEM_BSR32(m) / 8;
+
+        // index = (index < 2) ? index : (index - 2) + (size - 2);
+        index += (index >= 2) * (size - 4);
+
+        return index;
+    }
+    else if (size) // size == 1
+    {
+        return p[0] != value ? 0 : total;
+    }
+
+    return total;
+}
+
+size_t MemFindAny_generic(const void* ptr, size_t size, const void* set, size_t setlen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* s = (const uint8_t*)set;
+
+    if (setlen == 0)
+    {
+        return size;
+    }
+    else if (setlen == 1)
+    {
+        return MemFind_generic(ptr, size, s[0]);
+    }
+
+    size_t offset = 0;
+
+    if (setlen <= 3)
+    {
+        // for 2 byte set third value is same as second one
+        uint8_t v0 = s[0];
+        uint8_t v1 = s[1];
+        uint8_t v2 = s[setlen - 1];
+
+        // false positives in MemByteMask8 are only above real match, so first bit set is still correct
+        while (size >= 8)
+        {
+            uint64_t a = MEM_PTR64U(p);
+            uint64_t m = MemByteMask8(a, v0) | MemByteMask8(a, v1) | MemByteMask8(a, v2);
+            if (m)
+            {
+                return offset + (MEM_CTZ64(m) / 8);
+            }
+
+            offset += 8;
+            size -= 8;
+            p += 8;
+        }
+
+        while (size)
+        {
+            uint8_t b = *p;
+            if (b == v0 || b == v1 || b == v2)
+            {
+                return offset;
+            }
+
+            offset += 1;
+            size -= 1;
+            p += 1;
+        }
+
+        return offset;
+    }
+
+    // 256-bit bitmap of byte values in set
+    uint64_t bitmap[4] = { 0 };
+    for (size_t i=0; i<setlen; i++)
+    {
+        uint8_t b = s[i];
+        bitmap[b >> 6] |= 1ULL << (b & 63);
+    }
+
+    for (size_t i=0; i<size; i++)
+    {
+        uint8_t b = p[i];
+        if ((bitmap[b >> 6] >> (b & 63)) & 1)
+        {
+            return i;
+        }
+    }
+
+    return size;
+}
+
+size_t MemFindBytes_generic(const void* ptr, size_t size, const void* needle, size_t needlelen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* n = (const uint8_t*)needle;
+
+    if (needlelen == 0)
+    {
+        return 0;
+    }
+    else if (needlelen == 1)
+    {
+        return MemFind_generic(ptr, size, n[0]);
+    }
+    else if (needlelen > size)
+    {
+        return size;
+    }
+
+    // offset of last needle byte, and amount of positions where needle can start
+    size_t last = needlelen - 1;
+    size_t count = size - last;
+
+    uint8_t first_byte = n[0];
+    uint8_t last_byte = n[last];
+
+    size_t offset = 0;
+
+    // process 8 starting positions at a time
+    while (count - offset >= 8)
+    {
+        uint64_t a0 = MEM_PTR64U(p + offset);
+        uint64_t a1 = MEM_PTR64U(p + offset + last);
+
+        // top bit set in every byte where both first and last needle bytes match
+        // exact masks are needed here, as false positive in one of them would be accepted
+        uint64_t mask = MemByteMaskExact8(a0, first_byte) & MemByteMaskExact8(a1, last_byte);
+        while (mask)
+        {
+            size_t index = MEM_CTZ64(mask) / 8;
+            if (MemIsEqual_generic(p + offset + index + 1, n + 1, needlelen - 2))
+            {
+                return offset + index;
+            }
+            mask &= mask - 1;
+        }
+
+        offset += 8;
+    }
+
+    while (offset < count)
+    {
+        if (p[offset] == first_byte && p[offset + last] == last_byte && MemIsEqual_generic(p + offset + 1, n + 1, needlelen - 2))
+        {
+            return offset;
+        }
+        offset++;
+    }
+
+    // needle not found
+    return size;
+}
+
+size_t MemCount_generic(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    // 0x0001 in every 16-bit lane
+    const uint64_t lanes16 = ~0ULL / 0xffff;
+
+    size_t result = 0;
+
+    while (size >= 8)
+    {
+        // every word adds at most 1 to byte lane counters, so they can accumulate 255 words before overflowing
+        size_t count = size / 8 < 255 ? size / 8 : 255;
+
+        uint64_t sum = 0;
+        for (size_t i=0; i<count; i++)
+        {
+            uint64_t a = MEM_PTR64U(p);
+
+            // exact mask is required, as every matching byte is counted
+            sum += MemByteMaskExact8(a, value) >> 7;
+
+            p += 8;
+        }
+
+        // horizontal sum of byte lane counters
+        sum = (sum & (0xff * lanes16)) + ((sum >> 8) & (0xff * lanes16));
+        result += (size_t)((sum * lanes16) >> 48);
+
+        size -= count * 8;
+    }
+
+    while (size)
+    {
+        result += p[0] == value;
+        size -= 1;
+        p += 1;
+    }
+
+    return result;
+}
+
+size_t MemMismatch_generic(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    size_t offset = 0;
+
+    while (size >= 8)
+    {
+        // in little-endian first different byte is lowest non-zero byte of xor
+        uint64_t x = MEM_PTR64U(p1) ^ MEM_PTR64U(p2);
+        if (x)
+        {
+            return offset + (MEM_CTZ64(x) / 8);
+        }
+
+        offset += 8;
+        size -= 8;
+        p1 += 8;
+        p2 += 8;
+    }
+
+    if (size) // 0 < size < 8
+    {
+        return offset + MemMismatchSmall(p1, p2, size);
+    }
+
+    return offset;
+}
+
+static inline void MemConvertCase_generic(uint8_t* dst, const uint8_t* src, size_t size, uint8_t first)
+{
+    while (size >= 8)
+    {
+        uint64_t a = MEM_PTR64U(src);
+        MEM_PTR64U(dst) = MemConvertCase8(a, first);
+
+        size -= 8;
+        src += 8;
+        dst += 8;
+    }
+
+    MemConvertCaseSmall(dst, src, size, first);
+}
+
+void MemToLower_generic(void* dst, const void* src, size_t size)
+{
+    MemConvertCase_generic((uint8_t*)dst, (const uint8_t*)src, size, 'A');
+}
+
+void MemToUpper_generic(void* dst, const void* src, size_t size)
+{
+    MemConvertCase_generic((uint8_t*)dst, (const uint8_t*)src, size, 'a');
+}
+
+size_t MemFindI_generic(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    // letters are matched by setting 0x20 bit in input bytes, which maps uppercase letters to lowercase
+    const uint64_t fold = MemCaseBit1(value) * 0x0101010101010101;
+    value |= (uint8_t)fold;
+
+    size_t offset = 0;
+
+    while (size >= 8)
+    {
+        uint64_t a = MEM_PTR64U(p);
+        uint64_t m = MemByteMask8(a | fold, value);
+        if (m)
+        {
+            return offset + (MEM_CTZ64(m) / 8);
+        }
+
+        offset += 8;
+        size -= 8;
+        p += 8;
+    }
+
+    if (size & 4) // 4 <= size < 8
+    {
+        uint64_t a0 = MEM_PTR32U(p);
+        uint64_t a1 = MEM_PTR32U(p + size - 4);
+        uint64_t a = a0 | (a1 << 32);
+        uint64_t m = MemByteMask8(a | fold, value);
+
+        size_t index = (m ? MEM_CTZ64(m) : 64) / 8;
+
+        // index = (index < 4) ? index : (index - 4) + (size - 4);
+        index += (index >= 4) * (size - 8);
+
+        return offset + index;
+    }
+    else if (size & 2) // 2 <= size < 4
+    {
+        uint32_t a0 = MEM_PTR16U(p);
+        uint32_t a1 = MEM_PTR16U(p + size - 2);
+        uint32_t a = a0 | (a1 << 16);
+        uint32_t m = (uint32_t)MemByteMask8(a | fold, value);
+
+        size_t index = (m ? MEM_CTZ32(m) : 32) / 8;
+
+        // index = (index < 2) ? index : (index - 2) + (size - 2);
+        index += (index >= 2) * (size - 4);
+
+        return offset + index;
+    }
+    else if (size) // size == 1
+    {
+        return offset + ((p[0] | (uint8_t)fold) == value ? 0 : 1);
+    }
+
+    return offset + size;
+}
+
+size_t MemFindBytesI_generic(const void* ptr, size_t size, const void* needle, size_t needlelen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* n = (const uint8_t*)needle;
+
+    if (needlelen == 0)
+    {
+        return 0;
+    }
+    else if (needlelen == 1)
+    {
+        return MemFindI_generic(ptr, size, n[0]);
+    }
+    else if (needlelen > size)
+    {
+        return size;
+    }
+
+    // offset of last needle byte, and amount of positions where needle can start
+    size_t last = needlelen - 1;
+    size_t count = size - last;
+
+    // letters are matched by setting 0x20 bit in input bytes, which maps uppercase letters to lowercase
+    const uint64_t first_fold = MemCaseBit1(n[0]) * 0x0101010101010101;
+    const uint64_t last_fold = MemCaseBit1(n[last]) * 0x0101010101010101;
+
+    uint8_t first_byte = n[0] | (uint8_t)first_fold;
+    uint8_t last_byte = n[last] | (uint8_t)last_fold;
+
+    size_t offset = 0;
+
+    // process 8 starting positions at a time
+    while (count - offset >= 8)
+    {
+        uint64_t a0 = MEM_PTR64U(p + offset);
+        uint64_t a1 = MEM_PTR64U(p + offset + last);
+
+        // top bit set in every byte where both first and last needle bytes match
+        // exact masks are needed here, as false positive in one of them would be accepted
+        uint64_t mask = MemByteMaskExact8(a0 | first_fold, first_byte) & MemByteMaskExact8(a1 | last_fold, last_byte);
+        while (mask)
+        {
+            size_t index = MEM_CTZ64(mask) / 8;
+            if (MemCompareI_generic(p + offset + index + 1, n + 1, needlelen - 2) == 0)
+            {
+                return offset + index;
+            }
+            mask &= mask - 1;
+        }
+
+        offset += 8;
+    }
+
+    while (offset < count)
+    {
+        if ((p[offset] | (uint8_t)first_fold) == first_byte && (p[offset + last] | (uint8_t)last_fold) == last_byte && MemCompareI_generic(p + offset + 1, n + 1, needlelen - 2) == 0)
+        {
+            return offset;
+        }
+        offset++;
+    }
+
+    // needle not found
+    return size;
+}
+
+size_t MemFindInRange_generic(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (lo > hi)
+    {
+        // empty range, no byte can be inside it
+        return size;
+    }
+
+    // byte is inside range when unsigned (x - lo) <= (hi - lo)
+    const uint8_t range = (uint8_t)(hi - lo);
+
+    size_t offset = 0;
+
+    while (size >= 8)
+    {
+        uint64_t a = MEM_PTR64U(p);
+        uint64_t m = MemByteOutOfRange8(a, lo, range) ^ 0x8080808080808080;
+        if (m)
+        {
+            return offset + (MEM_CTZ64(m) / 8);
+        }
+
+        offset += 8;
+        size -= 8;
+        p += 8;
+    }
+
+    if (size & 4) // 4 <= size < 8
+    {
+        uint64_t a0 = MEM_PTR32U(p);
+        uint64_t a1 = MEM_PTR32U(p + size - 4);
+        uint64_t a = a0 | (a1 << 32);
+        uint64_t m = MemByteOutOfRange8(a, lo, range) ^ 0x8080808080808080;
+
+        size_t index = (m ? MEM_CTZ64(m) : 64) / 8;
+
+        // index = (index < 4) ? index : (index - 4) + (size - 4);
+        index += (index >= 4) * (size - 8);
+
+        return offset + index;
+    }
+    else if (size & 2) // 2 <= size < 4
+    {
+        uint32_t a0 = MEM_PTR16U(p);
+        uint32_t a1 = MEM_PTR16U(p + size - 2);
+        uint32_t a = a0 | (a1 << 16);
+        uint32_t m = (uint32_t)MemByteOutOfRange8(a, lo, range) ^ 0x80808080;
+
+        size_t index = (m ? MEM_CTZ32(m) : 32) / 8;
+
+        // index = (index < 2) ? index : (index - 2) + (size - 2);
+        index += (index >= 2) * (size - 4);
+
+        return offset + index;
+    }
+    else if (size) // size == 1
+    {
+        return offset + ((uint8_t)(p[0] - lo) <= range ? 0 : 1);
+    }
+
+    return offset + size;
+}
+
+size_t MemFindNotInRange_generic(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (lo > hi)
+    {
+        // empty range, every byte is outside of it
+        return 0;
+    }
+
+    // byte is inside range when unsigned (x - lo) <= (hi - lo)
+    const uint8_t range = (uint8_t)(hi - lo);
+
+    size_t offset = 0;
+
+    while (size >= 8)
+    {
+        uint64_t a = MEM_PTR64U(p);
+        uint64_t m = MemByteOutOfRange8(a, lo, range);
+        if (m)
+        {
+            return offset + (MEM_CTZ64(m) / 8);
+        }
+
+        offset += 8;
+        size -= 8;
+        p += 8;
+    }
+
+    if (size & 4) // 4 <= size < 8
+    {
+        uint64_t a0 = MEM_PTR32U(p);
+        uint64_t a1 = MEM_PTR32U(p + size - 4);
+        uint64_t a = a0 | (a1 << 32);
+        uint64_t m = MemByteOutOfRange8(a, lo, range);
+
+        size_t index = (m ? MEM_CTZ64(m) : 64) / 8;
+
+        // index = (index < 4) ? index : (index - 4) + (size - 4);
+        index += (index >= 4) * (size - 8);
+
+        return offset + index;
+    }
+    else if (size & 2) // 2 <= size < 4
+    {
+        uint32_t a0 = MEM_PTR16U(p);
+        uint32_t a1 = MEM_PTR16U(p + size - 2);
+        uint32_t a = a0 | (a1 << 16);
+        uint32_t m = (uint32_t)MemByteOutOfRange8(a, lo, range);
+
+        size_t index = (m ? MEM_CTZ32(m) : 32) / 8;
+
+        // index = (index < 2) ? index : (index - 2) + (size - 2);
+        index += (index >= 2) * (size - 4);
+
+        return offset + index;
+    }
+    else if (size) // size == 1
+    {
+        return offset + ((uint8_t)(p[0] - lo) > range ? 0 : 1);
+    }
+
+    return offset + size;
+}
+
+size_t MemValidateUTF8_generic(const void* ptr, size_t size)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    size_t offset = 0;
+    while (size)
+    {
+        size_t length;
+        if (size >= 8 && (MEM_PTR64U(p) & 0x8080808080808080) == 0)
+        {
+            // skip 8 ASCII bytes at once
+            length = 8;
+        }
+        else
+        {
+            length = MemUTF8Sequence(p, size);
+            if (length == 0)
+            {
+                return offset;
+            }
+        }
+
+        offset += length;
+        size -= length;
+        p += length;
+    }
+
+    return offset;
+}
+
+void MemClassify_generic(const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* s = (const uint8_t*)set;
+
+    // 256-bit bitmap of byte values in set
+    uint64_t bitmap[4] = { 0 };
+    for (size_t i=0; i<setlen; i++)
+    {
+        uint8_t b = s[i];
+        bitmap[b >> 6] |= 1ULL << (b & 63);
+    }
+
+    while (size)
+    {
+        size_t count = size < 64 ? size : 64;
+
+        uint64_t m = 0;
+        for (size_t i=0; i<count; i++)
+        {
+            uint8_t b = p[i];
+            m |= ((bitmap[b >> 6] >> (b & 63)) & 1) << i;
+        }
+        *masks++ = m;
+
+        size -= count;
+        p += count;
+    }
+}
+
+size_t MemFind16_generic(const void* ptr, size_t count, uint16_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    for (size_t i=0; i<count; i++)
+    {
+        if (MEM_PTR16U(p + i * sizeof(value)) == value) return i;
+    }
+    return count;
+}
+
+size_t MemFind32_generic(const void* ptr, size_t count, uint32_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    for (size_t i=0; i<count; i++)
+    {
+        if (MEM_PTR32U(p + i * sizeof(value)) == value) return i;
+    }
+    return count;
+}
+
+size_t MemFind64_generic(const void* ptr, size_t count, uint64_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    for (size_t i=0; i<count; i++)
+    {
+        if (MEM_PTR64U(p + i * sizeof(value)) == value) return i;
+    }
+    return count;
+}
+
+size_t MemFindNot16_generic(const void* ptr, size_t count, uint16_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    for (size_t i=0; i<count; i++)
+    {
+        if (MEM_PTR16U(p + i * sizeof(value)) != value) return i;
+    }
+    return count;
+}
+
+size_t MemFindNot32_generic(const void* ptr, size_t count, uint32_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    for (size_t i=0; i<count; i++)
+    {
+        if (MEM_PTR32U(p + i * sizeof(value)) != value) return i;
+    }
+    return count;
+}
+
+size_t MemFindNot64_generic(const void* ptr, size_t count, uint64_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    for (size_t i=0; i<count; i++)
+    {
+        if (MEM_PTR64U(p + i * sizeof(value)) != value) return i;
+    }
+    return count;
+}
+
+size_t MemLowerBound32_generic(const void* ptr, size_t count, uint32_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    // binary search down to 8 elements
+    size_t window = count < 8 ? count : 8;
+    size_t start = MemLowerBoundWindow(p, count, value, sizeof(value), window);
+    p += start * sizeof(value);
+
+    // count elements less than input value without branches
+    size_t result = start;
+    for (size_t i=0; i<window; i++)
+    {
+        result += MEM_PTR32U(p + i * sizeof(value)) < value;
+    }
+    return result;
+}
+
+size_t MemLowerBound64_generic(const void* ptr, size_t count, uint64_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    // binary search down to 8 elements
+    size_t window = count < 8 ? count : 8;
+    size_t start = MemLowerBoundWindow(p, count, value, sizeof(value), window);
+    p += start * sizeof(value);
+
+    // count elements less than input value without branches
+    size_t result = start;
+    for (size_t i=0; i<window; i++)
+    {
+        result += MEM_PTR64U(p + i * sizeof(value)) < value;
+    }
+    return result;
+}
+
+void MemTranslate_generic(void* dst, const void* src, size_t size, const uint8_t table[256])
+{
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+
+    for (size_t i=0; i<size; i++)
+    {
+        d[i] = table[s[i]];
+    }
+}
+
+// adds 64-byte stripe to 8 accumulators, for every 64-bit lane "i":
+// acc[i] += low32(data[i] ^ key[i]) * high32(data[i] ^ key[i]) + data[i ^ 1]
+static inline void MemHashStripe_generic(uint64_t acc[8], const uint8_t* p, const uint64_t* key)
+{
+    for (size_t i=0; i<8; i++)
+    {
+        uint64_t data = MEM_PTR64U(p + i * 8);
+        uint64_t mixed = data ^ key[i];
+        acc[i ^ 1] += data;
+        acc[i] += (mixed & 0xffffffff) * (mixed >> 32);
+    }
+}
+
+// long inputs are processed as 64-byte stripes with 8 independent accumulators
+// after every 1024 bytes accumulators are scrambled, so blocks cannot be reordered
+uint64_t MemHash64_generic(const void* ptr, size_t size, uint64_t seed)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    if (size <= 16)
+    {
+        return MemHashSmall(p, size, seed);
+    }
+    else if (size <= 256)
+    {
+        return MemHashMedium(p, size, seed);
+    }
+
+    uint64_t acc[8];
+    for (size_t i=0; i<8; i++)
+    {
+        acc[i] = MemHashSecret[24 + i] + seed;
+    }
+
+    const uint8_t* end = p + size;
+
+    // 1024-byte blocks of 16 stripes, each stripe uses key shifted by 8 bytes
+    while (end - p > 1024)
+    {
+        for (size_t i=0; i<16; i++)
+        {
+            MemHashStripe_generic(acc, p + i * 64, MemHashSecret + i);
+        }
+
+        // acc = (acc ^ (acc >> 47) ^ key) * prime
+        for (size_t i=0; i<8; i++)
+        {
+            acc[i] = (acc[i] ^ (acc[i] >> 47) ^ MemHashSecret[16 + i]) * 0x9e3779b1;
+        }
+        p += 1024;
+    }
+
+    // remaining stripes, there are at most 15 of them
+    for (size_t i=0; end - p > 64; i++)
+    {
+        MemHashStripe_generic(acc, p, MemHashSecret + i);
+        p += 64;
+    }
+
+    // last 64 bytes, may overlap with previous stripe
+    MemHashStripe_generic(acc, end - 64, MemHashSecret + 16);
+
+    return MemHashMerge(acc, size, seed);
+}
+
+void MemIsEqualBatch_generic(const MemPair* pairs, size_t count, uint8_t* results)
+{
+    for (size_t i=0; i<count; i++)
+    {
+        const MemPair* pair = &pairs[i];
+        MemPrefetchPair(pairs, i + 8, count);
+
+        results[i] = MemIsEqual_generic(pair->ptr1, pair->ptr2, pair->size);
+    }
+}
+
+void MemCompareBatch_generic(const MemPair* pairs, size_t count, int* results)
+{
+    for (size_t i=0; i<count; i++)
+    {
+        const MemPair* pair = &pairs[i];
+        MemPrefetchPair(pairs, i + 8, count);
+
+        results[i] = MemCompare_generic(pair->ptr1, pair->ptr2, pair->size);
+    }
+}
+
+bool MemIsEqualConstTime_generic(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    // accumulate bits that are different, all branches depend only on size
+    uint64_t diff = 0;
+    while (size >= 8)
+    {
+        uint64_t a = MEM_PTR64U(p1);
+        uint64_t b = MEM_PTR64U(p2);
+        diff |= a ^ b;
+
+        size -= 8;
+        p1 += 8;
+        p2 += 8;
+    }
+
+    diff |= MemConstTimeDiff(p1, p2, size);
+    return diff == 0;
+}
+
+MemPosition MemFindV_generic(const MemSegment* segments, size_t count, uint8_t value)
+{
+    return MemFindSegments(segments, count, value, &MemFind_generic);
+}
+
+bool MemIsEqualV_generic(const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2)
+{
+    return MemIsEqualSegments(segments1, count1, segments2, count2, &MemIsEqual_generic);
+}
+
+
+// dispatch mode, only for x64
+#if MEM_ARCH_X64 && (defined(MEM_DISPATCH_IFUNC) || defined(MEM_DISPATCH_TABLE))
+
+#define MEM_DISPATCH_RESOLVED 1
+
+// every function that is dispatched to instruction set specific implementation, V is for functions returning void
+// third argument is cpuid flag required by avx512 implementation, fourth is implementation used with avx10 cpuid flag
+// when adding new dispatched function, it must be added here too
+#define MEM_DISPATCH_LIST(X, V)                                                                                                                                                        \
+    X(int,         MemCompare,          MEM_CPUID_AVX512,     avx10, (const void* ptr1, const void* ptr2, size_t size), (ptr1, ptr2, size))                                            \
+    X(int,         MemCompareI,         MEM_CPUID_AVX512,     avx2,  (const void* ptr1, const void* ptr2, size_t size), (ptr1, ptr2, size))                                            \
+    X(bool,        MemIsEqual,          MEM_CPUID_AVX512,     avx10, (const void* ptr1, const void* ptr2, size_t size), (ptr1, ptr2, size))                                            \
+    X(size_t,      MemFind,             MEM_CPUID_AVX512,     avx10, (const void* ptr, size_t size, uint8_t value), (ptr, size, value))                                                \
+    X(size_t,      MemFindNot,          MEM_CPUID_AVX512,     avx10, (const void* ptr, size_t size, uint8_t value), (ptr, size, value))                                                \
+    X(size_t,      MemFindLast,         MEM_CPUID_AVX512,     avx10, (const void* ptr, size_t size, uint8_t value), (ptr, size, value))                                                \
+    X(size_t,      MemFindLastNot,      MEM_CPUID_AVX512,     avx10, (const void* ptr, size_t size, uint8_t value), (ptr, size, value))                                                \
+    X(size_t,      MemFindAny,          MEM_CPUID_AVX512VBMI, avx2,  (const void* ptr, size_t size, const void* set, size_t setlen), (ptr, size, set, setlen))                         \
+    X(size_t,      MemFindBytes,        MEM_CPUID_AVX512,     avx2,  (const void* ptr, size_t size, const void* needle, size_t needlelen), (ptr, size, needle, needlelen))             \
+    X(size_t,      MemCount,            MEM_CPUID_AVX512,     avx10, (const void* ptr, size_t size, uint8_t value), (ptr, size, value))                                                \
+    X(size_t,      MemMismatch,         MEM_CPUID_AVX512,     avx10, (const void* ptr1, const void* ptr2, size_t size), (ptr1, ptr2, size))                                            \
+    V(void,        MemToLower,          MEM_CPUID_AVX512,     avx2,  (void* dst, const void* src, size_t size), (dst, src, size))                                                      \
+    V(void,        MemToUpper,          MEM_CPUID_AVX512,     avx2,  (void* dst, const void* src, size_t size), (dst, src, size))                                                      \
+    X(size_t,      MemFindI,            MEM_CPUID_AVX512,     avx2,  (const void* ptr, size_t size, uint8_t value), (ptr, size, value))                                                \
+    X(size_t,      MemFindBytesI,       MEM_CPUID_AVX512,     avx2,  (const void* ptr, size_t size, const void* needle, size_t needlelen), (ptr, size, needle, needlelen))             \
+    X(size_t,      MemFindInRange,      MEM_CPUID_AVX512,     avx2,  (const void* ptr, size_t size, uint8_t lo, uint8_t hi), (ptr, size, lo, hi))                                      \
+    X(size_t,      MemFindNotInRange,   MEM_CPUID_AVX512,     avx2,  (const void* ptr, size_t size, uint8_t lo, uint8_t hi), (ptr, size, lo, hi))                                      \
+    X(size_t,      MemValidateUTF8,     MEM_CPUID_AVX512,     avx2,  (const void* ptr, size_t size), (ptr, size))                                                                      \
+    V(void,        MemClassify,         MEM_CPUID_AVX512VBMI, avx2,  (const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks), (ptr, size, set, setlen, masks)) \
+    X(size_t,      MemFind16,           MEM_CPUID_AVX512,     avx2,  (const void* ptr, size_t count, uint16_t value), (ptr, count, value))                                             \
+    X(size_t,      MemFind32,           MEM_CPUID_AVX512,     avx2,  (const void* ptr, size_t count, uint32_t value), (ptr, count, value))                                             \
+    X(size_t,      MemFind64,           MEM_CPUID_AVX512,     avx2,  (const void* ptr, size_t count, uint64_t value), (ptr, count, value))                                             \
+    X(size_t,      MemFindNot16,        MEM_CPUID_AVX512,     avx2,  (const void* ptr, size_t count, uint16_t value), (ptr, count, value))                                             \
+    X(size_t,      MemFindNot32,        MEM_CPUID_AVX512,     avx2,  (const void* ptr, size_t count, uint32_t value), (ptr, count, value))                                             \
+    X(size_t,      MemFindNot64,        MEM_CPUID_AVX512,     avx2,  (const void* ptr, size_t count, uint64_t value), (ptr, count, value))                                             \
+    X(size_t,      MemLowerBound32,     MEM_CPUID_AVX512,     avx2,  (const void* ptr, size_t count, uint32_t value), (ptr, count, value))                                             \
+    X(size_t,      MemLowerBound64,     MEM_CPUID_AVX512,     avx2,  (const void* ptr, size_t count, uint64_t value), (ptr, count, value))                                             \
+    V(void,        MemTranslate,        MEM_CPUID_AVX512VBMI, avx2,  (void* dst, const void* src, size_t size, const uint8_t table[256]), (dst, src, size, table))                     \
+    X(uint64_t,    MemHash64,           MEM_CPUID_AVX512,     avx2,  (const void* ptr, size_t size, uint64_t seed), (ptr, size, seed))                                                 \
+    V(void,        MemIsEqualBatch,     MEM_CPUID_AVX512,     avx2,  (const MemPair* pairs, size_t count, uint8_t* results), (pairs, count, results))                                  \
+    V(void,        MemCompareBatch,     MEM_CPUID_AVX512,     avx2,  (const MemPair* pairs, size_t count, int* results), (pairs, count, results))                                      \
+    X(bool,        MemIsEqualConstTime, MEM_CPUID_AVX512,     avx2,  (const void* ptr1, const void* ptr2, size_t size), (ptr1, ptr2, size))                                            \
+    X(MemPosition, MemFindV,            MEM_CPUID_AVX512,     avx2,  (const MemSegment* segments, size_t count, uint8_t value), (segments, count, value))                              \
+    X(bool,        MemIsEqualV,         MEM_CPUID_AVX512,     avx2,  (const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2), (segments1, count1, segments2, count2))
+
+// selects best implementation for current CPU, same order as in regular dispatch functions below
+#define MEM_DISPATCH_SELECT(cpuid, name, avx512, avx10)                                     \
+    ((cpuid) & (avx512)) ? &name##_avx512 : ((cpuid) & MEM_CPUID_AVX10) ? &name##_##avx10 : \
+    ((cpuid) & MEM_CPUID_AVX2) ? &name##_avx2 : &name##_sse2
+
+#if defined(MEM_DISPATCH_IFUNC)
+
+#if !defined(__linux__) || !(MEM_COMPILER_GCC || MEM_COMPILER_CLANG)
+#  error MEM_DISPATCH_IFUNC is supported only on Linux with GCC or Clang, use MEM_DISPATCH_TABLE instead
+#endif
+
+// dynamic loader calls resolver once when relocating, afterwards every call goes directly to selected
+// implementation (or through PLT when called across shared library boundary)
+// resolver runs before sanitizer runtime is initialized, so it must not be instrumented
+#define MEM_DISPATCH_IFUNC_RESOLVER(ret, name, avx512, avx10, params, args) \
+    MEM_DISABLE_ASAN static ret (*name##_resolve(void)) params              \
+    {                                                                       \
+        int cpuid = MemCPUID();                                             \
+        return MEM_DISPATCH_SELECT(cpuid, name, avx512, avx10);             \
+    }                                                                       \
+    MEM_API ret name params __attribute__((ifunc(#name "_resolve")));
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+MEM_DISPATCH_LIST(MEM_DISPATCH_IFUNC_RESOLVER, MEM_DISPATCH_IFUNC_RESOLVER)
+
+#if defined(__cplusplus)
+}
+#endif
+
+#undef MEM_DISPATCH_IFUNC_RESOLVER
+
+#else // defined(MEM_DISPATCH_TABLE)
+
+// table of function pointers, filled once by constructor before main
+// initially every entry points to stub that fills table and forwards call, so calls from other
+// constructors (or when compiler drops constructor) still work
+typedef struct
+{
+#define MEM_DISPATCH_TABLE_ENTRY(ret, name, avx512, avx10, params, args) ret (*name) params;
+    MEM_DISPATCH_LIST(MEM_DISPATCH_TABLE_ENTRY, MEM_DISPATCH_TABLE_ENTRY)
+#undef MEM_DISPATCH_TABLE_ENTRY
+}
+MemDispatchTable;
+
+#define MEM_DISPATCH_TABLE_STUB(ret, name, avx512, avx10, params, args) static ret name##_stub params;
+MEM_DISPATCH_LIST(MEM_DISPATCH_TABLE_STUB, MEM_DISPATCH_TABLE_STUB)
+#undef MEM_DISPATCH_TABLE_STUB
+
+static MemDispatchTable MemDispatch =
+{
+#define MEM_DISPATCH_TABLE_STUB(ret, name, avx512, avx10, params, args) &name##_stub,
+    MEM_DISPATCH_LIST(MEM_DISPATCH_TABLE_STUB, MEM_DISPATCH_TABLE_STUB)
+#undef MEM_DISPATCH_TABLE_STUB
+};
+
+// every entry is pointer sized and written with same value by all threads, so racing stubs are harmless
+static void MemDispatchInit(void)
+{
+    int cpuid = MemCPUID();
+#define MEM_DISPATCH_TABLE_INIT(ret, name, avx512, avx10, params, args) MemDispatch.name = MEM_DISPATCH_SELECT(cpuid, name, avx512, avx10);
+    MEM_DISPATCH_LIST(MEM_DISPATCH_TABLE_INIT, MEM_DISPATCH_TABLE_INIT)
+#undef MEM_DISPATCH_TABLE_INIT
+}
+
+#if MEM_COMPILER_MSVC
+#pragma section(".CRT$XCU", read)
+__declspec(allocate(".CRT$XCU")) static void (__cdecl* MemDispatchConstructor)(void) = &MemDispatchInit;
+#else
+__attribute__((constructor)) static void MemDispatchConstructor(void)
+{
+    MemDispatchInit();
+}
+#endif
+
+#define MEM_DISPATCH_TABLE_STUB(ret, name, avx512, avx10, params, args) \
+    static ret name##_stub params                                       \
+    {                                                                   \
+        MemDispatchInit();                                              \
+        return MemDispatch.name args;                                   \
+    }
+
+#define MEM_DISPATCH_TABLE_STUB_VOID(ret, name, avx512, avx10, params, args) \
+    static ret name##_stub params                                            \
+    {                                                                        \
+        MemDispatchInit();                                                   \
+        MemDispatch.name args;                                               \
+    }
+
+#define MEM_DISPATCH_TABLE_CALL(ret, name, avx512, avx10, params, args) \
+    ret name params                                                     \
+    {                                                                   \
+        return MemDispatch.name args;                                   \
+    }
+
+#define MEM_DISPATCH_TABLE_CALL_VOID(ret, name, avx512, avx10, params, args) \
+    ret name params                                                          \
+    {                                                                        \
+        MemDispatch.name args;                                               \
+    }
+
+MEM_DISPATCH_LIST(MEM_DISPATCH_TABLE_STUB, MEM_DISPATCH_TABLE_STUB_VOID)
+MEM_DISPATCH_LIST(MEM_DISPATCH_TABLE_CALL, MEM_DISPATCH_TABLE_CALL_VOID)
+
+#undef MEM_DISPATCH_TABLE_STUB
+#undef MEM_DISPATCH_TABLE_STUB_VOID
+#undef MEM_DISPATCH_TABLE_CALL
+#undef MEM_DISPATCH_TABLE_CALL_VOID
+
+#endif // defined(MEM_DISPATCH_IFUNC)
+
+#undef MEM_DISPATCH_SELECT
+#undef MEM_DISPATCH_LIST
+
+#endif // dispatch mode
+
+#if !defined(MEM_DISPATCH_RESOLVED)
+
+int MemCompare(const void* ptr1, const void* ptr2, size_t size)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        return MemCompare_avx512(ptr1, ptr2, size);
+    }
+    else if (cpuid & MEM_CPUID_AVX10)
+    {
+        return MemCompare_avx10(ptr1, ptr2, size);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemCompare_avx2(ptr1, ptr2, size);
+    }
+    return MemCompare_sse2(ptr1, ptr2, size);
+#elif MEM_ARCH_ARM64
+#  if MEM_ARCH_SVE
+    if (MemCPUID() & MEM_CPUID_SVE)
+    {
+        return MemCompare_sve(ptr1, ptr2, size);
+    }
+#  endif
+    return MemCompare_neon(ptr1, ptr2, size);
+#elif MEM_ARCH_RVV
+    return MemCompare_rvv(ptr1, ptr2, size);
+#else
+    return MemCompare_generic(ptr1, ptr2, size);
+#endif
+}
+
+int MemCompareI(const void* ptr1, const void* ptr2, size_t size)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        return MemCompareI_avx512(ptr1, ptr2, size);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemCompareI_avx2(ptr1, ptr2, size);
+    }
+    return MemCompareI_sse2(ptr1, ptr2, size);
+#elif MEM_ARCH_ARM64
+    return MemCompareI_neon(ptr1, ptr2, size);
+#elif MEM_ARCH_RVV
+    return MemCompareI_rvv(ptr1, ptr2, size);
+#else
+    return MemCompareI_generic(ptr1, ptr2, size);
+#endif
+}
+
+bool MemIsEqual(const void* ptr1, const void* ptr2, size_t size)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        return MemIsEqual_avx512(ptr1, ptr2, size);
+    }
+    else if (cpuid & MEM_CPUID_AVX10)
+    {
+        return MemIsEqual_avx10(ptr1, ptr2, size);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemIsEqual_avx2(ptr1, ptr2, size);
+    }
+    return MemIsEqual_sse2(ptr1, ptr2, size);
+#elif MEM_ARCH_ARM64
+#  if MEM_ARCH_SVE
+    if (MemCPUID() & MEM_CPUID_SVE)
+    {
+        return MemIsEqual_sve(ptr1, ptr2, size);
+    }
+#  endif
+    return MemIsEqual_neon(ptr1, ptr2, size);
+#elif MEM_ARCH_RVV
+    return MemIsEqual_rvv(ptr1, ptr2, size);
+#else
+    return MemIsEqual_generic(ptr1, ptr2, size);
+#endif
+}
+
+size_t MemFind(const void* ptr, size_t size, uint8_t value)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        return MemFind_avx512(ptr, size, value);
+    }
+    else if (cpuid & MEM_CPUID_AVX10)
+    {
+        return MemFind_avx10(ptr, size, value);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemFind_avx2(ptr, size, value);
+    }
+    return MemFind_sse2(ptr, size, value);
+#elif MEM_ARCH_ARM64
+#  if MEM_ARCH_SVE
+    if (MemCPUID() & MEM_CPUID_SVE)
+    {
+        return MemFind_sve(ptr, size, value);
+    }
+#  endif
+    return MemFind_neon(ptr, size, value);
+#elif MEM_ARCH_RVV
+    return MemFind_rvv(ptr, size, value);
+#else
+    return MemFind_generic(ptr, size, value);
+#endif
+}
+
+size_t MemFindNot(const void* ptr, size_t size, uint8_t value)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        return MemFindNot_avx512(ptr, size, value);
+    }
+    else if (cpuid & MEM_CPUID_AVX10)
+    {
+        return MemFindNot_avx10(ptr, size, value);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemFindNot_avx2(ptr, size, value);
+    }
+    return MemFindNot_sse2(ptr, size, value);
+#elif MEM_ARCH_ARM64
+#  if MEM_ARCH_SVE
+    if (MemCPUID() & MEM_CPUID_SVE)
+    {
+        return MemFindNot_sve(ptr, size, value);
+    }
+#  endif
+    return MemFindNot_neon(ptr, size, value);
+#elif MEM_ARCH_RVV
+    return MemFindNot_rvv(ptr, size, value);
+#else
+    return MemFindNot_generic(ptr, size, value);
+#endif
+}
+
+size_t MemFindLast(const void* ptr, size_t size, uint8_t value)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        return MemFindLast_avx512(ptr, size, value);
+    }
+    else if (cpuid & MEM_CPUID_AVX10)
+    {
+        return MemFindLast_avx10(ptr, size, value);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemFindLast_avx2(ptr, size, value);
+    }
+    return MemFindLast_sse2(ptr, size, value);
+#elif MEM_ARCH_ARM64
+#  if MEM_ARCH_SVE
+    if (MemCPUID() & MEM_CPUID_SVE)
+    {
+        return MemFindLast_sve(ptr, size, value);
+    }
+#  endif
+    return MemFindLast_neon(ptr, size, value);
+#elif MEM_ARCH_RVV
+    return MemFindLast_rvv(ptr, size, value);
+#else
+    return MemFindLast_generic(ptr, size, value);
+#endif
+}
+
+size_t MemFindLastNot(const void* ptr, size_t size, uint8_t value)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        return MemFindLastNot_avx512(ptr, size, value);
+    }
+    else if (cpuid & MEM_CPUID_AVX10)
+    {
+        return MemFindLastNot_avx10(ptr, size, value);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemFindLastNot_avx2(ptr, size, value);
+    }
+    return MemFindLastNot_sse2(ptr, size, value);
+#elif MEM_ARCH_ARM64
+#  if MEM_ARCH_SVE
+    if (MemCPUID() & MEM_CPUID_SVE)
+    {
+        return MemFindLastNot_sve(ptr, size, value);
+    }
+#  endif
+    return MemFindLastNot_neon(ptr, size, value);
+#elif MEM_ARCH_RVV
+    return MemFindLastNot_rvv(ptr, size, value);
+#else
+    return MemFindLastNot_generic(ptr, size, value);
+#endif
+}
+
+size_t MemFindAny(const void* ptr, size_t size, const void* set, size_t setlen)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512VBMI)
+    {
+        return MemFindAny_avx512(ptr, size, set, setlen);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemFindAny_avx2(ptr, size, set, setlen);
+    }
+    return MemFindAny_sse2(ptr, size, set, setlen);
+#elif MEM_ARCH_ARM64
+#  if MEM_ARCH_SVE
+    if (MemCPUID() & MEM_CPUID_SVE2)
+    {
+        return MemFindAny_sve(ptr, size, set, setlen);
+    }
+#  endif
+    return MemFindAny_neon(ptr, size, set, setlen);
+#elif MEM_ARCH_RVV
+    return MemFindAny_rvv(ptr, size, set, setlen);
+#else
+    return MemFindAny_generic(ptr, size, set, setlen);
+#endif
+}
+
+size_t MemFindBytes(const void* ptr, size_t size, const void* needle, size_t needlelen)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        return MemFindBytes_avx512(ptr, size, needle, needlelen);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemFindBytes_avx2(ptr, size, needle, needlelen);
+    }
+    return MemFindBytes_sse2(ptr, size, needle, needlelen);
+#elif MEM_ARCH_ARM64
+    return MemFindBytes_neon(ptr, size, needle, needlelen);
+#elif MEM_ARCH_RVV
+    return MemFindBytes_rvv(ptr, size, needle, needlelen);
+#else
+    return MemFindBytes_generic(ptr, size, needle, needlelen);
+#endif
+}
+
+size_t MemCount(const void* ptr, size_t size, uint8_t value)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        return MemCount_avx512(ptr, size, value);
+    }
+    else if (cpuid & MEM_CPUID_AVX10)
+    {
+        return MemCount_avx10(ptr, size, value);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemCount_avx2(ptr, size, value);
+    }
+    return MemCount_sse2(ptr, size, value);
+#elif MEM_ARCH_ARM64
+#  if MEM_ARCH_SVE
+    if (MemCPUID() & MEM_CPUID_SVE)
+    {
+        return MemCount_sve(ptr, size, value);
+    }
+#  endif
+    return MemCount_neon(ptr, size, value);
+#elif MEM_ARCH_RVV
+    return MemCount_rvv(ptr, size, value);
+#else
+    return MemCount_generic(ptr, size, value);
+#endif
+}
+
+size_t MemMismatch(const void* ptr1, const void* ptr2, size_t size)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        return MemMismatch_avx512(ptr1, ptr2, size);
+    }
+    else if (cpuid & MEM_CPUID_AVX10)
+    {
+        return MemMismatch_avx10(ptr1, ptr2, size);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemMismatch_avx2(ptr1, ptr2, size);
+    }
+    return MemMismatch_sse2(ptr1, ptr2, size);
+#elif MEM_ARCH_ARM64
+#  if MEM_ARCH_SVE
+    if (MemCPUID() & MEM_CPUID_SVE)
+    {
+        return MemMismatch_sve(ptr1, ptr2, size);
+    }
+#  endif
+    return MemMismatch_neon(ptr1, ptr2, size);
+#elif MEM_ARCH_RVV
+    return MemMismatch_rvv(ptr1, ptr2, size);
+#else
+    return MemMismatch_generic(ptr1, ptr2, size);
+#endif
+}
+
+
+void MemToLower(void* dst, const void* src, size_t size)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        MemToLower_avx512(dst, src, size);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        MemToLower_avx2(dst, src, size);
+    }
+    else
+    {
+        MemToLower_sse2(dst, src, size);
+    }
+#elif MEM_ARCH_ARM64
+    MemToLower_neon(dst, src, size);
+#elif MEM_ARCH_RVV
+    MemToLower_rvv(dst, src, size);
+#else
+    MemToLower_generic(dst, src, size);
+#endif
+}
+
+void MemToUpper(void* dst, const void* src, size_t size)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        MemToUpper_avx512(dst, src, size);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        MemToUpper_avx2(dst, src, size);
+    }
+    else
+    {
+        MemToUpper_sse2(dst, src, size);
+    }
+#elif MEM_ARCH_ARM64
+    MemToUpper_neon(dst, src, size);
+#elif MEM_ARCH_RVV
+    MemToUpper_rvv(dst, src, size);
+#else
+    MemToUpper_generic(dst, src, size);
+#endif
+}
+
+size_t MemFindI(const void* ptr, size_t size, uint8_t value)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        return MemFindI_avx512(ptr, size, value);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemFindI_avx2(ptr, size, value);
+    }
+    return MemFindI_sse2(ptr, size, value);
+#elif MEM_ARCH_ARM64
+    return MemFindI_neon(ptr, size, value);
+#elif MEM_ARCH_RVV
+    return MemFindI_rvv(ptr, size, value);
+#else
+    return MemFindI_generic(ptr, size, value);
+#endif
+}
+
+size_t MemFindBytesI(const void* ptr, size_t size, const void* needle, size_t needlelen)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        return MemFindBytesI_avx512(ptr, size, needle, needlelen);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemFindBytesI_avx2(ptr, size, needle, needlelen);
+    }
+    return MemFindBytesI_sse2(ptr, size, needle, needlelen);
+#elif MEM_ARCH_ARM64
+    return MemFindBytesI_neon(ptr, size, needle, needlelen);
+#elif MEM_ARCH_RVV
+    return MemFindBytesI_rvv(ptr, size, needle, needlelen);
+#else
+    return MemFindBytesI_generic(ptr, size, needle, needlelen);
+#endif
+}
+
+size_t MemFindInRange(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        return MemFindInRange_avx512(ptr, size, lo, hi);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemFindInRange_avx2(ptr, size, lo, hi);
+    }
+    return MemFindInRange_sse2(ptr, size, lo, hi);
+#elif MEM_ARCH_ARM64
+    return MemFindInRange_neon(ptr, size, lo, hi);
+#elif MEM_ARCH_RVV
+    return MemFindInRange_rvv(ptr, size, lo, hi);
+#else
+    return MemFindInRange_generic(ptr, size, lo, hi);
+#endif
+}
+
+size_t MemFindNotInRange(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        return MemFindNotInRange_avx512(ptr, size, lo, hi);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemFindNotInRange_avx2(ptr, size, lo, hi);
+    }
+    return MemFindNotInRange_sse2(ptr, size, lo, hi);
+#elif MEM_ARCH_ARM64
+    return MemFindNotInRange_neon(ptr, size, lo, hi);
+#elif MEM_ARCH_RVV
+    return MemFindNotInRange_rvv(ptr, size, lo, hi);
+#else
+    return MemFindNotInRange_generic(ptr, size, lo, hi);
+#endif
+}
+
+size_t MemValidateUTF8(const void* ptr, size_t size)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        return MemValidateUTF8_avx512(ptr, size);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemValidateUTF8_avx2(ptr, size);
     }
-
-    return result;
+    return MemValidateUTF8_sse2(ptr, size);
+#elif MEM_ARCH_ARM64
+    return MemValidateUTF8_neon(ptr, size);
+#elif MEM_ARCH_RVV
+    return MemValidateUTF8_rvv(ptr, size);
+#else
+    return MemValidateUTF8_generic(ptr, size);
+#endif
 }
 
-#endif // MEM_ARCH_X64
-
-
-int MemCompare_generic(const void* ptr1, const void* ptr2, size_t size)
+void MemClassify(const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks)
 {
-    const uint8_t* p1 = (const uint8_t*)ptr1;
-    const uint8_t* p2 = (const uint8_t*)ptr2;
-
-    while (size >= 8)
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512VBMI)
     {
-        uint64_t a = MEM_PTR64U(p1);
-        uint64_t b = MEM_PTR64U(p2);
-        if (a != b)
-        {
-            a = MEM_BSWAP64(a);
-            b = MEM_BSWAP64(b);
-            return (a > b) - (a < b);
-        }
-
-        size -= 8;
-        p1 += 8;
-        p2 += 8;
+        MemClassify_avx512(ptr, size, set, setlen, masks);
     }
-
-    if (size & 4) // 4 <= size < 8
+    else if (cpuid & MEM_CPUID_AVX2)
     {
-        uint64_t a0 = MEM_PTR32U(p1);
-        uint64_t b0 = MEM_PTR32U(p2);
-        uint64_t a1 = MEM_PTR32U(p1 + size - 4);
-        uint64_t b1 = MEM_PTR32U(p2 + size - 4);
-        uint64_t a = MEM_BSWAP64(a0 | (a1 << 32));
-        uint64_t b = MEM_BSWAP64(b0 | (b1 << 32));
-        return (a > b) - (a < b);
+        MemClassify_avx2(ptr, size, set, setlen, masks);
     }
-
-    if (size & 2) // 2 <= size < 4
+    else
     {
-        uint32_t a0 = MEM_PTR16U(p1);
-        uint32_t b0 = MEM_PTR16U(p2);
-        uint32_t a1 = MEM_PTR16U(p1 + size - 2);
-        uint32_t b1 = MEM_PTR16U(p2 + size - 2);
-        uint32_t a = MEM_BSWAP32(a0 | (a1 << 16));
-        uint32_t b = MEM_BSWAP32(b0 | (b1 << 16));
-        return (a > b) - (a < b);
+        MemClassify_sse2(ptr, size, set, setlen, masks);
     }
+#elif MEM_ARCH_ARM64
+    MemClassify_neon(ptr, size, set, setlen, masks);
+#elif MEM_ARCH_RVV
+    MemClassify_rvv(ptr, size, set, setlen, masks);
+#else
+    MemClassify_generic(ptr, size, set, setlen, masks);
+#endif
+}
 
-    if (size) // 1 <= size < 2
+size_t MemFind16(const void* ptr, size_t count, uint16_t value)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
     {
-        return p1[0] - p2[0];
+        return MemFind16_avx512(ptr, count, value);
     }
-
-    return 0;
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemFind16_avx2(ptr, count, value);
+    }
+    return MemFind16_sse2(ptr, count, value);
+#elif MEM_ARCH_ARM64
+    return MemFind16_neon(ptr, count, value);
+#elif MEM_ARCH_RVV
+    return MemFind16_rvv(ptr, count, value);
+#else
+    return MemFind16_generic(ptr, count, value);
+#endif
 }
 
-int MemCompareI_generic(const void* ptr1, const void* ptr2, size_t size)
+size_t MemFind32(const void* ptr, size_t count, uint32_t value)
 {
-    const uint8_t* p1 = (const uint8_t*)ptr1;
-    const uint8_t* p2 = (const uint8_t*)ptr2;
-
-    while (size >= 8)
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
     {
-        uint64_t a = MemToLower8(MEM_PTR64U(p1));
-        uint64_t b = MemToLower8(MEM_PTR64U(p2));
-        if (a != b)
-        {
-            a = MEM_BSWAP64(a);
-            b = MEM_BSWAP64(b);
-            return (a > b) - (a < b);
-        }
-
-        size -= 8;
-        p1 += 8;
-        p2 += 8;
+        return MemFind32_avx512(ptr, count, value);
     }
-
-    if (size & 4) // 4 <= size < 8
+    else if (cpuid & MEM_CPUID_AVX2)
     {
-        uint64_t a0 = MEM_PTR32U(p1);
-        uint64_t b0 = MEM_PTR32U(p2);
-        uint64_t a1 = MEM_PTR32U(p1 + size - 4);
-        uint64_t b1 = MEM_PTR32U(p2 + size - 4);
-        uint64_t a = MEM_BSWAP64(MemToLower8(a0 | (a1 << 32)));
-        uint64_t b = MEM_BSWAP64(MemToLower8(b0 | (b1 << 32)));
-        return (a > b) - (a < b);
+        return MemFind32_avx2(ptr, count, value);
     }
+    return MemFind32_sse2(ptr, count, value);
+#elif MEM_ARCH_ARM64
+    return MemFind32_neon(ptr, count, value);
+#elif MEM_ARCH_RVV
+    return MemFind32_rvv(ptr, count, value);
+#else
+    return MemFind32_generic(ptr, count, value);
+#endif
+}
 
-    if (size & 2) // 2 <= size < 4
+size_t MemFind64(const void* ptr, size_t count, uint64_t value)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
     {
-        uint64_t a0 = MEM_PTR16U(p1);
-        uint64_t b0 = MEM_PTR16U(p2);
-        uint64_t a1 = MEM_PTR16U(p1 + size - 2);
-        uint64_t b1 = MEM_PTR16U(p2 + size - 2);
-        uint64_t tmp = MEM_BSWAP64(MemToLower8(a0 | (a1 << 16) | (b0 << 32) | (b1 << 48)));
-        uint32_t a = (uint32_t)(tmp >> 32);
-        uint32_t b = (uint32_t)tmp;
-        return (a > b) - (a < b);
+        return MemFind64_avx512(ptr, count, value);
     }
-
-    if (size) // 1 <= size < 2
+    else if (cpuid & MEM_CPUID_AVX2)
     {
-        return MemToLower1(p1[0]) - MemToLower1(p2[0]);
+        return MemFind64_avx2(ptr, count, value);
     }
-
-    return 0;
+    return MemFind64_sse2(ptr, count, value);
+#elif MEM_ARCH_ARM64
+    return MemFind64_neon(ptr, count, value);
+#elif MEM_ARCH_RVV
+    return MemFind64_rvv(ptr, count, value);
+#else
+    return MemFind64_generic(ptr, count, value);
+#endif
 }
 
-bool MemIsEqual_generic(const void* ptr1, const void* ptr2, size_t size)
+size_t MemFindNot16(const void* ptr, size_t count, uint16_t value)
 {
-    const uint8_t* p1 = (const uint8_t*)ptr1;
-    const uint8_t* p2 = (const uint8_t*)ptr2;
-
-    while (size >= 8)
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
     {
-        uint64_t a = MEM_PTR64U(p1);
-        uint64_t b = MEM_PTR64U(p2);
-        if (a != b)
-        {
-            return false;
-        }
-
-        size -= 8;
-        p1 += 8;
-        p2 += 8;
+        return MemFindNot16_avx512(ptr, count, value);
     }
-
-    if (size & 4) // 4 <= size < 8
+    else if (cpuid & MEM_CPUID_AVX2)
     {
-        uint32_t a0 = MEM_PTR32U(p1);
-        uint32_t b0 = MEM_PTR32U(p2);
-        uint32_t a1 = MEM_PTR32U(p1 + size - 4);
-        uint32_t b1 = MEM_PTR32U(p2 + size - 4);
-        return (a0 == b0) & (a1 == b1);
+        return MemFindNot16_avx2(ptr, count, value);
     }
+    return MemFindNot16_sse2(ptr, count, value);
+#elif MEM_ARCH_ARM64
+    return MemFindNot16_neon(ptr, count, value);
+#elif MEM_ARCH_RVV
+    return MemFindNot16_rvv(ptr, count, value);
+#else
+    return MemFindNot16_generic(ptr, count, value);
+#endif
+}
 
-    if (size & 2) // 2 <= size < 4
+size_t MemFindNot32(const void* ptr, size_t count, uint32_t value)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
     {
-        uint16_t a0 = MEM_PTR16U(p1);
-        uint16_t b0 = MEM_PTR16U(p2);
-        uint16_t a1 = MEM_PTR16U(p1 + size - 2);
-        uint16_t b1 = MEM_PTR16U(p2 + size - 2);
-        return (a0 == b0) & (a1 == b1);
+        return MemFindNot32_avx512(ptr, count, value);
     }
-
-    if (size) // 1 <= size < 2
+    else if (cpuid & MEM_CPUID_AVX2)
     {
-        return p1[0] == p2[0];
+        return MemFindNot32_avx2(ptr, count, value);
     }
-
-    return true;
+    return MemFindNot32_sse2(ptr, count, value);
+#elif MEM_ARCH_ARM64
+    return MemFindNot32_neon(ptr, count, value);
+#elif MEM_ARCH_RVV
+    return MemFindNot32_rvv(ptr, count, value);
+#else
+    return MemFindNot32_generic(ptr, count, value);
+#endif
 }
 
-static inline uint64_t MemByteMask8(uint64_t value, uint8_t byte)
+size_t MemFindNot64(const void* ptr, size_t count, uint64_t value)
 {
-    const uint64_t splat = ~0ULL / 255;
-    const uint64_t msb = 0x80 * splat;
-    const uint64_t lsb = 0x01 * splat;
-
-    uint64_t x = value ^ (byte * splat);
-    return (x - lsb) & (~x) & msb;
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        return MemFindNot64_avx512(ptr, count, value);
+    }
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemFindNot64_avx2(ptr, count, value);
+    }
+    return MemFindNot64_sse2(ptr, count, value);
+#elif MEM_ARCH_ARM64
+    return MemFindNot64_neon(ptr, count, value);
+#elif MEM_ARCH_RVV
+    return MemFindNot64_rvv(ptr, count, value);
+#else
+    return MemFindNot64_generic(ptr, count, value);
+#endif
 }
 
-size_t MemFind_generic(const void* ptr, size_t size, uint8_t value)
+size_t MemLowerBound32(const void* ptr, size_t count, uint32_t value)
 {
-    const uint8_t* p = (const uint8_t*)ptr;
-
-    size_t offset = 0;
-
-    while (size >= 8)
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
     {
-        uint64_t a = MEM_PTR64U(p);
-        uint64_t m = MemByteMask8(a, value);
-        if (m)
-        {
-            return offset + (MEM_CTZ64(m) / 8);
-        }
-
-        offset += 8;
-        size -= 8;
-        p += 8;
+        return MemLowerBound32_avx512(ptr, count, value);
     }
-
-    if (size & 4) // 4 <= size < 8
+    else if (cpuid & MEM_CPUID_AVX2)
     {
-        uint64_t a0 = MEM_PTR32U(p);
-        uint64_t a1 = MEM_PTR32U(p + size - 4);
-        uint64_t a = a0 | (a1 << 32);
-        uint64_t m = MemByteMask8(a, value);
-
-        size_t index = (m ? MEM_CTZ64(m) : 64) / 8;
-
-        // index = (index < 4) ? index : (index - 4) + (size - 4);
-        index += (index >= 4) * (size - 8);
-
-        return offset + index;
+        return MemLowerBound32_avx2(ptr, count, value);
     }
-    else if (size & 2) // 2 <= size < 4
-    {
-        uint32_t a0 = MEM_PTR16U(p);
-        uint32_t a1 = MEM_PTR16U(p + size - 2);
-        uint32_t a = a0 | (a1 << 16);
-        uint32_t m = (uint32_t)MemByteMask8(a, value);
-
-        size_t index = (m ? MEM_CTZ32(m) : 32) / 8;
-
-        // index = (index < 2) ? index : (index - 2) + (size - 2);
-        index += (index >= 2) * (size - 4);
+    return MemLowerBound32_sse2(ptr, count, value);
+#elif MEM_ARCH_ARM64
+    return MemLowerBound32_neon(ptr, count, value);
+#elif MEM_ARCH_RVV
+    return MemLowerBound32_rvv(ptr, count, value);
+#else
+    return MemLowerBound32_generic(ptr, count, value);
+#endif
+}
 
-        return offset + index;
-    }
-    else if (size) // size == 1
+size_t MemLowerBound64(const void* ptr, size_t count, uint64_t value)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
     {
-        return offset + (p[0] == value ? 0 : 1);
+        return MemLowerBound64_avx512(ptr, count, value);
     }
-
-    return offset + size;
+    else if (cpuid & MEM_CPUID_AVX2)
+    {
+        return MemLowerBound64_avx2(ptr, count, value);
+    }
+    return MemLowerBound64_sse2(ptr, count, value);
+#elif MEM_ARCH_ARM64
+    return MemLowerBound64_neon(ptr, count, value);
+#elif MEM_ARCH_RVV
+    return MemLowerBound64_rvv(ptr, count, value);
+#else
+    return MemLowerBound64_generic(ptr, count, value);
+#endif
 }
 
-size_t MemFindNot_generic(const void* ptr, size_t size, uint8_t value)
+void MemTranslate(void* dst, const void* src, size_t size, const uint8_t table[256])
 {
-    const uint8_t* p = (const uint8_t*)ptr;
-
-    size_t offset = 0;
-
-    while (size >= 8)
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512VBMI)
     {
-        uint64_t a = MEM_PTR64U(p);
-        uint64_t m = MemByteMask8(a, value) ^ 0x8080808080808080;
-        if (m)
-        {
-            return offset + (MEM_CTZ64(m) / 8);
-        }
-
-        offset += 8;
-        size -= 8;
-        p += 8;
+        MemTranslate_avx512(dst, src, size, table);
     }
-
-    if (size & 4) // 4 <= size < 8
+    else if (cpuid & MEM_CPUID_AVX2)
     {
-        uint64_t a0 = MEM_PTR32U(p);
-        uint64_t a1 = MEM_PTR32U(p + size - 4);
-        uint64_t a = a0 | (a1 << 32);
-        uint64_t m = MemByteMask8(a, value) ^ 0x8080808080808080;
-
-        size_t index = (m ? MEM_CTZ64(m) : 64) / 8;
-
-        // index = (index < 4) ? index : (index - 4) + (size - 4);
-        index += (index >= 4) * (size - 8);
-
-        return offset + index;
+        MemTranslate_avx2(dst, src, size, table);
     }
-    else if (size & 2) // 2 <= size < 4
+    else
     {
-        uint32_t a0 = MEM_PTR16U(p);
-        uint32_t a1 = MEM_PTR16U(p + size - 2);
-        uint32_t a = a0 | (a1 << 16);
-        uint32_t m = (uint32_t)MemByteMask8(a, value) ^ 0x80808080;
-
-        size_t index = (m ? MEM_CTZ32(m) : 32) / 8;
-
-        // index = (index < 2) ? index : (index - 2) + (size - 2);
-        index += (index >= 2) * (size - 4);
+        MemTranslate_sse2(dst, src, size, table);
+    }
+#elif MEM_ARCH_ARM64
+    MemTranslate_neon(dst, src, size, table);
+#elif MEM_ARCH_RVV
+    MemTranslate_rvv(dst, src, size, table);
+#else
+    MemTranslate_generic(dst, src, size, table);
+#endif
+}
 
-        return offset + index;
+uint64_t MemHash64(const void* ptr, size_t size, uint64_t seed)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    if (cpuid & MEM_CPUID_AVX512)
+    {
+        return MemHash64_avx512(ptr, size, seed);
     }
-    else if (size) // size == 1
+    else if (cpuid & MEM_CPUID_AVX2)
     {
-        return offset + (p[0] != value ? 0 : 1);
+        return MemHash64_avx2(ptr, size, seed);
     }
-
-    return offset + size;
+    return MemHash64_sse2(ptr, size, seed);
+#elif MEM_ARCH_ARM64
+    return MemHash64_neon(ptr, size, seed);
+#elif MEM_ARCH_RVV
+    return MemHash64_rvv(ptr, size, seed);
+#else
+    return MemHash64_generic(ptr, size, seed);
+#endif
 }
 
-
-int MemCompare(const void* ptr1, const void* ptr2, size_t size)
+void MemIsEqualBatch(const MemPair* pairs, size_t count, uint8_t* results)
 {
 #if MEM_ARCH_X64
     int cpuid = MemCPUID();
     if (cpuid & MEM_CPUID_AVX512)
     {
-        return MemCompare_avx512(ptr1, ptr2, size);
+        MemIsEqualBatch_avx512(pairs, count, results);
     }
     else if (cpuid & MEM_CPUID_AVX2)
     {
-        return MemCompare_avx2(ptr1, ptr2, size);
+        MemIsEqualBatch_avx2(pairs, count, results);
+    }
+    else
+    {
+        MemIsEqualBatch_sse2(pairs, count, results);
     }
-    return MemCompare_sse2(ptr1, ptr2, size);
 #elif MEM_ARCH_ARM64
-    return MemCompare_neon(ptr1, ptr2, size);
+    MemIsEqualBatch_neon(pairs, count, results);
 #elif MEM_ARCH_RVV
-    return MemCompare_rvv(ptr1, ptr2, size);
+    MemIsEqualBatch_rvv(pairs, count, results);
 #else
-    return MemCompare_generic(ptr1, ptr2, size);
+    MemIsEqualBatch_generic(pairs, count, results);
 #endif
 }
 
-int MemCompareI(const void* ptr1, const void* ptr2, size_t size)
+void MemCompareBatch(const MemPair* pairs, size_t count, int* results)
 {
 #if MEM_ARCH_X64
     int cpuid = MemCPUID();
     if (cpuid & MEM_CPUID_AVX512)
     {
-        return MemCompareI_avx512(ptr1, ptr2, size);
+        MemCompareBatch_avx512(pairs, count, results);
     }
     else if (cpuid & MEM_CPUID_AVX2)
     {
-        return MemCompareI_avx2(ptr1, ptr2, size);
+        MemCompareBatch_avx2(pairs, count, results);
+    }
+    else
+    {
+        MemCompareBatch_sse2(pairs, count, results);
     }
-    return MemCompareI_sse2(ptr1, ptr2, size);
 #elif MEM_ARCH_ARM64
-    return MemCompareI_neon(ptr1, ptr2, size);
+    MemCompareBatch_neon(pairs, count, results);
 #elif MEM_ARCH_RVV
-    return MemCompareI_rvv(ptr1, ptr2, size);
+    MemCompareBatch_rvv(pairs, count, results);
 #else
-    return MemCompareI_generic(ptr1, ptr2, size);
+    MemCompareBatch_generic(pairs, count, results);
 #endif
 }
 
-bool MemIsEqual(const void* ptr1, const void* ptr2, size_t size)
+bool MemIsEqualConstTime(const void* ptr1, const void* ptr2, size_t size)
 {
 #if MEM_ARCH_X64
     int cpuid = MemCPUID();
     if (cpuid & MEM_CPUID_AVX512)
     {
-        return MemIsEqual_avx512(ptr1, ptr2, size);
+        return MemIsEqualConstTime_avx512(ptr1, ptr2, size);
     }
     else if (cpuid & MEM_CPUID_AVX2)
     {
-        return MemIsEqual_avx2(ptr1, ptr2, size);
+        return MemIsEqualConstTime_avx2(ptr1, ptr2, size);
     }
-    return MemIsEqual_sse2(ptr1, ptr2, size);
+    return MemIsEqualConstTime_sse2(ptr1, ptr2, size);
 #elif MEM_ARCH_ARM64
-    return MemIsEqual_neon(ptr1, ptr2, size);
+    return MemIsEqualConstTime_neon(ptr1, ptr2, size);
 #elif MEM_ARCH_RVV
-    return MemIsEqual_rvv(ptr1, ptr2, size);
+    return MemIsEqualConstTime_rvv(ptr1, ptr2, size);
 #else
-    return MemIsEqual_generic(ptr1, ptr2, size);
+    return MemIsEqualConstTime_generic(ptr1, ptr2, size);
 #endif
 }
 
-size_t MemFind(const void* ptr, size_t size, uint8_t value)
+
+MemPosition MemFindV(const MemSegment* segments, size_t count, uint8_t value)
 {
 #if MEM_ARCH_X64
     int cpuid = MemCPUID();
     if (cpuid & MEM_CPUID_AVX512)
     {
-        return MemFind_avx512(ptr, size, value);
+        return MemFindV_avx512(segments, count, value);
     }
     else if (cpuid & MEM_CPUID_AVX2)
     {
-        return MemFind_avx2(ptr, size, value);
+        return MemFindV_avx2(segments, count, value);
     }
-    return MemFind_sse2(ptr, size, value);
+    return MemFindV_sse2(segments, count, value);
 #elif MEM_ARCH_ARM64
-    return MemFind_neon(ptr, size, value);
+    return MemFindV_neon(segments, count, value);
 #elif MEM_ARCH_RVV
-    return MemFind_rvv(ptr, size, value);
+    return MemFindV_rvv(segments, count, value);
 #else
-    return MemFind_generic(ptr, size, value);
+    return MemFindV_generic(segments, count, value);
 #endif
 }
 
-size_t MemFindNot(const void* ptr, size_t size, uint8_t value)
+bool MemIsEqualV(const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2)
 {
 #if MEM_ARCH_X64
     int cpuid = MemCPUID();
     if (cpuid & MEM_CPUID_AVX512)
     {
-        return MemFindNot_avx512(ptr, size, value);
+        return MemIsEqualV_avx512(segments1, count1, segments2, count2);
     }
     else if (cpuid & MEM_CPUID_AVX2)
     {
-        return MemFindNot_avx2(ptr, size, value);
+        return MemIsEqualV_avx2(segments1, count1, segments2, count2);
     }
-    return MemFindNot_sse2(ptr, size, value);
+    return MemIsEqualV_sse2(segments1, count1, segments2, count2);
 #elif MEM_ARCH_ARM64
-    return MemFindNot_neon(ptr, size, value);
+    return MemIsEqualV_neon(segments1, count1, segments2, count2);
 #elif MEM_ARCH_RVV
-    return MemFindNot_rvv(ptr, size, value);
+    return MemIsEqualV_rvv(segments1, count1, segments2, count2);
 #else
-    return MemFindNot_generic(ptr, size, value);
+    return MemIsEqualV_generic(segments1, count1, segments2, count2);
+#endif
+}
+
+#endif // !defined(MEM_DISPATCH_RESOLVED)
+
+size_t MemCommonPrefix(const void* ptr1, size_t size1, const void* ptr2, size_t size2)
+{
+    // common prefix cannot be longer than shorter buffer
+    return MemMismatch(ptr1, ptr2, size1 < size2 ? size1 : size2);
+}
+
+int MemGetFeatures(void)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemDoCPUID() | MemCPUIDCompiled();
+    return MEM_ISA_SSE2
+        | ((cpuid & MEM_CPUID_AVX2)   ? MEM_ISA_AVX2   : 0)
+        | ((cpuid & MEM_CPUID_AVX10)  ? MEM_ISA_AVX10  : 0)
+        | ((cpuid & MEM_CPUID_AVX512) ? MEM_ISA_AVX512 : 0);
+#elif MEM_ARCH_SVE
+    int cpuid = MemDoCPUID() | MemCPUIDCompiled();
+    return MEM_ISA_NEON
+        | ((cpuid & MEM_CPUID_SVE) ? MEM_ISA_SVE : 0);
+#elif MEM_ARCH_ARM64
+    return MEM_ISA_NEON;
+#elif MEM_ARCH_RVV
+    return MEM_ISA_RVV;
+#else
+    return 0;
+#endif
+}
+
+int MemGetISA(void)
+{
+#if MEM_ARCH_X64
+    int cpuid = MemCPUID();
+    return (cpuid & MEM_CPUID_AVX512) ? MEM_ISA_AVX512 : (cpuid & MEM_CPUID_AVX10) ? MEM_ISA_AVX10 : (cpuid & MEM_CPUID_AVX2) ? MEM_ISA_AVX2 : MEM_ISA_SSE2;
+#elif MEM_ARCH_SVE
+    int cpuid = MemCPUID();
+    return (cpuid & MEM_CPUID_SVE) ? MEM_ISA_SVE : MEM_ISA_NEON;
+#else
+    return MemGetFeatures();
+#endif
+}
+
+bool MemSetPreferredISA(int isa)
+{
+#if MEM_ARCH_X64 || MEM_ARCH_SVE
+#if MEM_ARCH_X64
+    if (isa != 0 && isa != MEM_ISA_SSE2 && isa != MEM_ISA_AVX2 && isa != MEM_ISA_AVX10 && isa != MEM_ISA_AVX512)
+    {
+        return false;
+    }
+#else
+    if (isa != 0 && isa != MEM_ISA_NEON && isa != MEM_ISA_SVE)
+    {
+        return false;
+    }
+#endif
+
+    if (isa != 0 && (MemGetFeatures() & isa) == 0)
+    {
+        return false;
+    }
+
+#if MEM_ARCH_X64 && defined(MEM_DISPATCH_IFUNC)
+    // every function was already resolved when program was loaded
+    return isa == MemGetISA();
+#else
+    if (MemCPUIDCompiled() != 0)
+    {
+        // dispatch is resolved at compile time
+        return isa == MemGetISA();
+    }
+
+    MEM_SET32_RELAXED(&MemCPUIDSelected, MEM_CPUID_INIT | MemLimitCPUID(MemDoCPUID(), isa));
+#if MEM_ARCH_X64 && defined(MEM_DISPATCH_TABLE)
+    MemDispatchInit();
+#endif
+    return true;
+#endif
+
+#else
+    return isa == 0 || isa == MemGetFeatures();
+#endif
+}
+
+void MemSearchInit(MemSearchState* state, const void* needle, size_t needlelen)
+{
+    // needle that does not fit in tail would overflow it, zero length marks state that never matches
+    state->needle = needle;
+    state->needlelen = needlelen - 1 < MEM_SEARCH_MAX_NEEDLE ? needlelen : 0;
+    state->offset = 0;
+    state->tailsize = 0;
+}
+
+size_t MemSearchNext(MemSearchState* state, const void* ptr, size_t size)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    size_t needlelen = state->needlelen;
+    size_t tailsize = state->tailsize;
+
+    if (needlelen == 0)
+    {
+        // needle length was out of range in MemSearchInit
+        state->offset += size;
+        return 0;
+    }
+
+    if (tailsize)
+    {
+        // match that starts in tail can end only in first "needlelen - 1" bytes of ptr
+        // so only these are joined with tail, everything else is searched in place
+        uint8_t joined[2 * MEM_SEARCH_MAX_NEEDLE];
+
+        size_t count = size < needlelen - 1 ? size : needlelen - 1;
+        for (size_t i=0; i<tailsize; i++)
+        {
+            joined[i] = state->tail[i];
+        }
+        for (size_t i=0; i<count; i++)
+        {
+            joined[tailsize + i] = p[i];
+        }
+
+        size_t index = MemFindBytes(joined, tailsize + count, state->needle, needlelen);
+        if (index != tailsize + count)
+        {
+            size_t end = index + needlelen - tailsize;
+            state->offset += end;
+            state->tailsize = 0;
+            return end;
+        }
+    }
+
+    size_t index = MemFindBytes(p, size, state->needle, needlelen);
+    if (index != size)
+    {
+        size_t end = index + needlelen;
+        state->offset += end;
+        state->tailsize = 0;
+        return end;
+    }
+
+    // not found, keep last "needlelen - 1" bytes of tail and ptr for next call
+    size_t keep = needlelen - 1;
+    if (size >= keep)
+    {
+        for (size_t i=0; i<keep; i++)
+        {
+            state->tail[i] = p[size - keep + i];
+        }
+        tailsize = keep;
+    }
+    else
+    {
+        // drop oldest bytes from tail to make space for all of ptr bytes
+        size_t drop = tailsize + size > keep ? tailsize + size - keep : 0;
+        for (size_t i=drop; i<tailsize; i++)
+        {
+            state->tail[i - drop] = state->tail[i];
+        }
+        tailsize -= drop;
+
+        for (size_t i=0; i<size; i++)
+        {
+            state->tail[tailsize + i] = p[i];
+        }
+        tailsize += size;
+    }
+
+    state->offset += size;
+    state->tailsize = tailsize;
+    return 0;
+}
+
+#if defined(MEM_PARALLEL)
+
+// chunks are multiple of cache line size, large enough to amortize atomic operations
+// and small enough so that cancellation after match does not waste much work
+#define MEM_PARALLEL_CHUNK (256 * 1024)
+
+// max count of threads started, including calling thread
+#define MEM_PARALLEL_MAX_THREADS 64
+
+typedef struct
+{
+    const uint8_t* ptr;
+    size_t size;
+    uint8_t value;
+    bool count;
+
+    // offset of next chunk, relative to cache line aligned address before ptr
+    uint64_t next;
+
+    // for MemFind lowest offset of matching byte found so far, or total count for MemCount
+    uint64_t result;
+}
+MemParallelTask;
+
+static void MemParallelWork(MemParallelTask* task)
+{
+    const uintptr_t CACHE_LINE = 64;
+
+    const uint8_t* base = (const uint8_t*)((uintptr_t)task->ptr & ~(CACHE_LINE - 1));
+    size_t skip = (size_t)(task->ptr - base);
+
+    uint64_t count = 0;
+    for (;;)
+    {
+        // chunks are taken in increasing order, and first one is shorter to align all other chunks
+        size_t begin = (size_t)MEM_ATOMIC_ADD64(&task->next, MEM_PARALLEL_CHUNK);
+        size_t end = begin + MEM_PARALLEL_CHUNK - skip;
+        begin = begin ? begin - skip : 0;
+
+        if (begin >= task->size)
+        {
+            break;
+        }
+        end = end < task->size ? end : task->size;
+
+        if (task->count)
+        {
+            count += MemCount(task->ptr + begin, end - begin, task->value);
+        }
+        else
+        {
+            // all chunks before this one are already taken by other threads, so if match is already
+            // found before this chunk, there is no need to continue as later chunks cannot produce lower offset
+            if (begin >= MEM_ATOMIC_GET64(&task->result))
+            {
+                break;
+            }
+
+            size_t index = MemFind(task->ptr + begin, end - begin, task->value);
+            if (index != end - begin)
+            {
+                // update result only if it is lower than one found by other threads
+                uint64_t offset = begin + index;
+                uint64_t result = MEM_ATOMIC_GET64(&task->result);
+                while (offset < result)
+                {
+                    uint64_t previous = MEM_ATOMIC_CMPXCHG64(&task->result, result, offset);
+                    if (previous == result)
+                    {
+                        break;
+                    }
+                    result = previous;
+                }
+                break;
+            }
+        }
+    }
+
+    if (task->count)
+    {
+        MEM_ATOMIC_ADD64(&task->result, count);
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI MemParallelThread(LPVOID arg)
+{
+    MemParallelWork((MemParallelTask*)arg);
+    return 0;
+}
+#else
+static void* MemParallelThread(void* arg)
+{
+    MemParallelWork((MemParallelTask*)arg);
+    return NULL;
+}
+#endif
+
+static size_t MemParallelRun(MemParallelTask* task, size_t threads)
+{
+    if (threads == 0)
+    {
+#if defined(_WIN32)
+        threads = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+#else
+        long count = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = count > 0 ? (size_t)count : 1;
+#endif
+    }
+
+    // no point to use more threads than there are chunks
+    size_t chunks = task->size / MEM_PARALLEL_CHUNK;
+    threads = threads < chunks ? threads : chunks;
+    threads = threads < MEM_PARALLEL_MAX_THREADS ? threads : MEM_PARALLEL_MAX_THREADS;
+
+#if defined(_WIN32)
+    HANDLE handles[MEM_PARALLEL_MAX_THREADS];
+#else
+    pthread_t handles[MEM_PARALLEL_MAX_THREADS];
+#endif
+
+    // if some threads fail to start, remaining chunks are processed by threads that did start
+    size_t started = 0;
+    for (size_t i=1; i<threads; i++)
+    {
+#if defined(_WIN32)
+        handles[started] = CreateThread(NULL, 0, &MemParallelThread, task, 0, NULL);
+        started += handles[started] != NULL;
+#else
+        started += pthread_create(&handles[started], NULL, &MemParallelThread, task) == 0;
 #endif
+    }
+
+    // calling thread also processes chunks
+    MemParallelWork(task);
+
+    for (size_t i=0; i<started; i++)
+    {
+#if defined(_WIN32)
+        WaitForSingleObject(handles[i], INFINITE);
+        CloseHandle(handles[i]);
+#else
+        pthread_join(handles[i], NULL);
+#endif
+    }
+
+    return (size_t)task->result;
 }
 
+size_t MemFindParallel(const void* ptr, size_t size, uint8_t value, size_t threads)
+{
+    MemParallelTask task;
+    task.ptr = (const uint8_t*)ptr;
+    task.size = size;
+    task.value = value;
+    task.count = false;
+    task.next = 0;
+    task.result = size;
+
+    return MemParallelRun(&task, threads);
+}
+
+size_t MemCountParallel(const void* ptr, size_t size, uint8_t value, size_t threads)
+{
+    MemParallelTask task;
+    task.ptr = (const uint8_t*)ptr;
+    task.size = size;
+    task.value = value;
+    task.count = true;
+    task.next = 0;
+    task.result = 0;
+
+    return MemParallelRun(&task, threads);
+}
+
+#endif // defined(MEM_PARALLEL)
+
+
 #endif // defined(MEM_STATIC) || defined(MEM_IMPLEMENTATION)
@@ -4,6 +4,9 @@
 #define _GNU_SOURCE 1
 
 #define MEM_STATIC
+#if !defined(__wasi__)
+#  define MEM_PARALLEL
+#endif
 #include "memfun.h"
 
 #if defined(__GNUC__) && !defined(__clang__)
@@ -46,6 +49,12 @@
 #  define BENCH_DO_NOT_OPTIMIZE(var) do { volatile __typeof__(var) __temp__; _ReadWriteBarrier(); __temp__ = var; _ReadWriteBarrier(); } while (0)
 #endif
 
+#if defined(__clang__) || defined(__GNUC__)
+#  define BENCH_NOINLINE __attribute__((noinline))
+#else
+#  define BENCH_NOINLINE __declspec(noinline)
+#endif
+
 #if defined(__x86_64__) || defined(_M_AMD64)
 #  include <emmintrin.h>
 #  define BENCH_MEMORY_BARRIER() _mm_mfence()
@@ -169,8 +178,13 @@ static int64_t bench_read_cycle_counter(void)
 
 #elif defined(__linux__)
 
+// original affinity mask, before pinning to one core
+static cpu_set_t bench_cpu_mask;
+
 static void bench_init(void)
 {
+    sched_getaffinity(0, sizeof(bench_cpu_mask), &bench_cpu_mask);
+
     // pin current thread to one core
     size_t cpu = (size_t)sched_getcpu();
 
@@ -480,33 +494,400 @@ static size_t MemFind_std(const void* ptr, size_t size, uint8_t value)
     return r ? (size_t)((char*)r - (char*)ptr) : size;
 }
 
+static size_t MemFindLast_std(const void* ptr, size_t size, uint8_t value)
+{
+#if defined(__linux__)
+    const void* r = memrchr(ptr, value, size);
+    return r ? (size_t)((char*)r - (char*)ptr) : size;
+#else
+    const uint8_t* p = (const uint8_t*)ptr;
+    for (size_t i=size; i-->0; )
+    {
+        if (p[i] == value) return i;
+    }
+    return size;
+#endif
+}
+
+static size_t MemCount_std(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    size_t count = 0;
+    for (size_t i=0; i<size; i++)
+    {
+        count += p[i] == value;
+    }
+    return count;
+}
+
+static size_t MemMismatch_std(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    for (size_t i=0; i<size; i++)
+    {
+        if (p1[i] != p2[i]) return i;
+    }
+    return size;
+}
+
+static void MemToLower_std(void* dst, const void* src, size_t size)
+{
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+
+    for (size_t i=0; i<size; i++)
+    {
+        d[i] = MemToLower1(s[i]);
+    }
+}
+
+static void MemToUpper_std(void* dst, const void* src, size_t size)
+{
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+
+    for (size_t i=0; i<size; i++)
+    {
+        uint8_t c = s[i];
+        d[i] = (uint8_t)(c - 'a') <= ('z' - 'a') ? (uint8_t)(c - 'a' + 'A') : c;
+    }
+}
+
+static size_t MemFindI_std(const void* ptr, size_t size, uint8_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    value = MemToLower1(value);
+    for (size_t i=0; i<size; i++)
+    {
+        if (MemToLower1(p[i]) == value) return i;
+    }
+    return size;
+}
+
+static size_t MemFindInRange_std(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    for (size_t i=0; i<size; i++)
+    {
+        if (p[i] >= lo && p[i] <= hi) return i;
+    }
+    return size;
+}
+
+static size_t MemFindNotInRange_std(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    for (size_t i=0; i<size; i++)
+    {
+        if (p[i] < lo || p[i] > hi) return i;
+    }
+    return size;
+}
+
+static size_t MemValidateUTF8_std(const void* ptr, size_t size)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    size_t i = 0;
+    while (i < size)
+    {
+        size_t length = MemUTF8Sequence(p + i, size - i);
+        if (length == 0) return i;
+        i += length;
+    }
+    return size;
+}
+
+static size_t MemFind16_std(const void* ptr, size_t count, uint16_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    for (size_t i=0; i<count; i++)
+    {
+        uint16_t element;
+        memcpy(&element, p + i * sizeof(element), sizeof(element));
+        if (element == value) return i;
+    }
+    return count;
+}
+
+static size_t MemFind32_std(const void* ptr, size_t count, uint32_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    for (size_t i=0; i<count; i++)
+    {
+        uint32_t element;
+        memcpy(&element, p + i * sizeof(element), sizeof(element));
+        if (element == value) return i;
+    }
+    return count;
+}
+
+static size_t MemFind64_std(const void* ptr, size_t count, uint64_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    for (size_t i=0; i<count; i++)
+    {
+        uint64_t element;
+        memcpy(&element, p + i * sizeof(element), sizeof(element));
+        if (element == value) return i;
+    }
+    return count;
+}
+
+static size_t MemLowerBound32_std(const void* ptr, size_t count, uint32_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    // same as std::lower_bound
+    size_t first = 0;
+    while (count > 0)
+    {
+        size_t half = count / 2;
+        uint32_t element;
+        memcpy(&element, p + (first + half) * sizeof(element), sizeof(element));
+        if (element < value)
+        {
+            first += half + 1;
+            count -= half + 1;
+        }
+        else
+        {
+            count = half;
+        }
+    }
+    return first;
+}
+
+static size_t MemLowerBound64_std(const void* ptr, size_t count, uint64_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    // same as std::lower_bound
+    size_t first = 0;
+    while (count > 0)
+    {
+        size_t half = count / 2;
+        uint64_t element;
+        memcpy(&element, p + (first + half) * sizeof(element), sizeof(element));
+        if (element < value)
+        {
+            first += half + 1;
+            count -= half + 1;
+        }
+        else
+        {
+            count = half;
+        }
+    }
+    return first;
+}
+
+static void MemTranslate_std(void* dst, const void* src, size_t size, const uint8_t table[256])
+{
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+
+    for (size_t i=0; i<size; i++)
+    {
+        d[i] = table[s[i]];
+    }
+}
+
+static uint64_t MemHash64_std(const void* ptr, size_t size, uint64_t seed)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    // FNV-1a, typical simple scalar hash
+    uint64_t h = 0xcbf29ce484222325 ^ seed;
+    for (size_t i=0; i<size; i++)
+    {
+        h = (h ^ p[i]) * 0x100000001b3;
+    }
+    return h;
+}
+
+static void MemIsEqualBatch_std(const MemPair* pairs, size_t count, uint8_t* results)
+{
+    for (size_t i=0; i<count; i++)
+    {
+        results[i] = MemIsEqual_std(pairs[i].ptr1, pairs[i].ptr2, pairs[i].size);
+    }
+}
+
+static void MemCompareBatch_std(const MemPair* pairs, size_t count, int* results)
+{
+    for (size_t i=0; i<count; i++)
+    {
+        results[i] = memcmp(pairs[i].ptr1, pairs[i].ptr2, pairs[i].size);
+    }
+}
+
+static MemPosition MemFindV_std(const MemSegment* segments, size_t count, uint8_t value)
+{
+    MemPosition result = { count, 0 };
+    for (size_t i=0; i<count; i++)
+    {
+        const void* r = memchr(segments[i].iov_base, value, segments[i].iov_len);
+        if (r)
+        {
+            result.segment = i;
+            result.offset = (size_t)((const char*)r - (const char*)segments[i].iov_base);
+            break;
+        }
+    }
+    return result;
+}
+
+static bool MemIsEqualV_std(const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2)
+{
+    size_t i1 = 0, i2 = 0;
+    size_t offset1 = 0, offset2 = 0;
+    for (;;)
+    {
+        while (i1 < count1 && offset1 == segments1[i1].iov_len) { i1++; offset1 = 0; }
+        while (i2 < count2 && offset2 == segments2[i2].iov_len) { i2++; offset2 = 0; }
+        if (i1 == count1 || i2 == count2)
+        {
+            return i1 == count1 && i2 == count2;
+        }
+
+        size_t size1 = segments1[i1].iov_len - offset1;
+        size_t size2 = segments2[i2].iov_len - offset2;
+        size_t size = size1 < size2 ? size1 : size2;
+        if (memcmp((const char*)segments1[i1].iov_base + offset1, (const char*)segments2[i2].iov_base + offset2, size) != 0)
+        {
+            return false;
+        }
+        offset1 += size;
+        offset2 += size;
+    }
+}
+
+static bool MemIsEqualConstTime_std(const void* ptr1, const void* ptr2, size_t size)
+{
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    // typical byte loop used for comparing secrets
+    uint8_t diff = 0;
+    for (size_t i=0; i<size; i++)
+    {
+        diff |= p1[i] ^ p2[i];
+    }
+    return diff == 0;
+}
+
+static size_t MemFindBytes_std(const void* ptr, size_t size, const void* needle, size_t needlelen)
+{
+#if defined(__linux__) || defined(__APPLE__)
+    const void* r = memmem(ptr, size, needle, needlelen);
+    return r ? (size_t)((char*)r - (char*)ptr) : size;
+#else
+    const uint8_t* p = (const uint8_t*)ptr;
+    for (size_t i=0; i+needlelen<=size; i++)
+    {
+        if (memcmp(p + i, needle, needlelen) == 0) return i;
+    }
+    return size;
+#endif
+}
+
+static size_t MemFindBytesI_std(const void* ptr, size_t size, const void* needle, size_t needlelen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* n = (const uint8_t*)needle;
+
+    for (size_t i=0; i+needlelen<=size; i++)
+    {
+        size_t k = 0;
+        while (k<needlelen && MemToLower1(p[i+k]) == MemToLower1(n[k])) k++;
+        if (k == needlelen) return i;
+    }
+    return size;
+}
+
 typedef int    MemCompareFun(const void* ptr1, const void* ptr2, size_t size);
 typedef bool   MemIsEqualFun(const void* ptr1, const void* ptr2, size_t size);
 typedef size_t MemFindFun   (const void* ptr, size_t size, uint8_t value);
+typedef size_t MemFindAnyFun(const void* ptr, size_t size, const void* set, size_t setlen);
+typedef size_t MemFindBytesFun(const void* ptr, size_t size, const void* needle, size_t needlelen);
+typedef size_t MemMismatchFun(const void* ptr1, const void* ptr2, size_t size);
+typedef void   MemConvertFun(void* dst, const void* src, size_t size);
+typedef size_t MemFindRangeFun(const void* ptr, size_t size, uint8_t lo, uint8_t hi);
+typedef size_t MemValidateFun(const void* ptr, size_t size);
+typedef void   MemClassifyFun(const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks);
+typedef size_t MemFind16Fun (const void* ptr, size_t count, uint16_t value);
+typedef size_t MemFind32Fun (const void* ptr, size_t count, uint32_t value);
+typedef size_t MemFind64Fun (const void* ptr, size_t count, uint64_t value);
+typedef void   MemTranslateFun(void* dst, const void* src, size_t size, const uint8_t table[256]);
+typedef uint64_t MemHashFun (const void* ptr, size_t size, uint64_t seed);
+typedef void   MemBatchEqFun(const MemPair* pairs, size_t count, uint8_t* results);
+typedef void   MemBatchCmpFun(const MemPair* pairs, size_t count, int* results);
+typedef MemPosition MemFindVFun(const MemSegment* segments, size_t count, uint8_t value);
+typedef bool   MemIsEqualVFun(const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2);
 
 static const struct
 {
-    const char*    name;
-    MemCompareFun* compare;
-    MemCompareFun* comparei;
-    MemIsEqualFun* isequal;
-    MemFindFun*    find;
-    MemFindFun*    findnot;
-    int            cpuid;
+    const char*      name;
+    MemCompareFun*   compare;
+    MemCompareFun*   comparei;
+    MemIsEqualFun*   isequal;
+    MemFindFun*      find;
+    MemFindFun*      findnot;
+    MemFindFun*      findlast;
+    MemFindFun*      findlastnot;
+    MemFindAnyFun*   findany;
+    MemFindBytesFun* findbytes;
+    MemFindFun*      count;
+    MemMismatchFun*  mismatch;
+    MemConvertFun*   tolower;
+    MemConvertFun*   toupper;
+    MemFindFun*      findi;
+    MemFindBytesFun* findbytesi;
+    MemFindRangeFun* findinrange;
+    MemFindRangeFun* findnotinrange;
+    MemValidateFun*  validateutf8;
+    MemClassifyFun*  classify;
+    MemFind16Fun*    find16;
+    MemFind32Fun*    find32;
+    MemFind64Fun*    find64;
+    MemFind32Fun*    lowerbound32;
+    MemFind64Fun*    lowerbound64;
+    MemTranslateFun* translate;
+    MemHashFun*      hash64;
+    MemBatchEqFun*   isequalbatch;
+    MemBatchCmpFun*  comparebatch;
+    MemIsEqualFun*   isequalconsttime;
+    MemFindVFun*     findv;
+    MemIsEqualVFun*  isequalv;
+    int              cpuid;
 }
 memfun[] =
 {
-    { "std",            &MemCompare_std,     &MemCompareI_std,           &MemIsEqual_std,     &MemFind_std,       0,                    0                   },
+    { "std",     &MemCompare_std,     &MemCompareI_std,     &MemIsEqual_std,     &MemFind_std,     0,                   &MemFindLast_std,     0,                       0,                   &MemFindBytes_std,     &MemCount_std,     &MemMismatch_std,     &MemToLower_std,     &MemToUpper_std,     &MemFindI_std,     &MemFindBytesI_std,     &MemFindInRange_std,     &MemFindNotInRange_std,     &MemValidateUTF8_std,     0,                    &MemFind16_std,     &MemFind32_std,     &MemFind64_std,     &MemLowerBound32_std,     &MemLowerBound64_std,     &MemTranslate_std,     &MemHash64_std,     &MemIsEqualBatch_std,     &MemCompareBatch_std,     &MemIsEqualConstTime_std,     &MemFindV_std,     &MemIsEqualV_std,     0                },
 #if MEM_ARCH_RVV
-    { "rvv",            &MemCompare_rvv,     &MemCompareI_rvv,           &MemIsEqual_rvv,     &MemFind_rvv,       &MemFindNot_rvv,      0                   },
+    { "rvv",     &MemCompare_rvv,     &MemCompareI_rvv,     &MemIsEqual_rvv,     &MemFind_rvv,     &MemFindNot_rvv,     &MemFindLast_rvv,     &MemFindLastNot_rvv,     &MemFindAny_rvv,     &MemFindBytes_rvv,     &MemCount_rvv,     &MemMismatch_rvv,     &MemToLower_rvv,     &MemToUpper_rvv,     &MemFindI_rvv,     &MemFindBytesI_rvv,     &MemFindInRange_rvv,     &MemFindNotInRange_rvv,     &MemValidateUTF8_rvv,     &MemClassify_rvv,     &MemFind16_rvv,     &MemFind32_rvv,     &MemFind64_rvv,     &MemLowerBound32_rvv,     &MemLowerBound64_rvv,     &MemTranslate_rvv,     &MemHash64_rvv,     &MemIsEqualBatch_rvv,     &MemCompareBatch_rvv,     &MemIsEqualConstTime_rvv,     &MemFindV_rvv,     &MemIsEqualV_rvv,     0                },
 #elif MEM_ARCH_ARM64
-    { "neon",           &MemCompare_neon,    &MemCompareI_neon,          &MemIsEqual_neon,    &MemFind_neon,      &MemFindNot_neon,     0                   },
+    { "neon",    &MemCompare_neon,    &MemCompareI_neon,    &MemIsEqual_neon,    &MemFind_neon,    &MemFindNot_neon,    &MemFindLast_neon,    &MemFindLastNot_neon,    &MemFindAny_neon,    &MemFindBytes_neon,    &MemCount_neon,    &MemMismatch_neon,    &MemToLower_neon,    &MemToUpper_neon,    &MemFindI_neon,    &MemFindBytesI_neon,    &MemFindInRange_neon,    &MemFindNotInRange_neon,    &MemValidateUTF8_neon,    &MemClassify_neon,    &MemFind16_neon,    &MemFind32_neon,    &MemFind64_neon,    &MemLowerBound32_neon,    &MemLowerBound64_neon,    &MemTranslate_neon,    &MemHash64_neon,    &MemIsEqualBatch_neon,    &MemCompareBatch_neon,    &MemIsEqualConstTime_neon,    &MemFindV_neon,    &MemIsEqualV_neon,    0                },
+#  if MEM_ARCH_SVE
+    { "sve",     &MemCompare_sve,     0,                    &MemIsEqual_sve,     &MemFind_sve,     &MemFindNot_sve,     &MemFindLast_sve,     &MemFindLastNot_sve,     &MemFindAny_sve,     0,                     &MemCount_sve,     &MemMismatch_sve,     0,                   0,                   0,                 0,                      0,                       0,                          0,                        0,                    0,                  0,                  0,                  0,                        0,                        0,                     0,                  0,                        0,                        0,                            0,                 0,                    MEM_CPUID_SVE    },
+#  endif
 #elif MEM_ARCH_X64
-    { "sse2",           &MemCompare_sse2,    &MemCompareI_sse2,          &MemIsEqual_sse2,    &MemFind_sse2,      &MemFindNot_sse2,     0                   },
-    { "avx2",           &MemCompare_avx2,    &MemCompareI_avx2,          &MemIsEqual_avx2,    &MemFind_avx2,      &MemFindNot_avx2,     MEM_CPUID_AVX2      },
-    { "avx512",         &MemCompare_avx512,  &MemCompareI_avx512,        &MemIsEqual_avx512,  &MemFind_avx512,    &MemFindNot_avx512,   MEM_CPUID_AVX512    },
+    { "sse2",    &MemCompare_sse2,    &MemCompareI_sse2,    &MemIsEqual_sse2,    &MemFind_sse2,    &MemFindNot_sse2,    &MemFindLast_sse2,    &MemFindLastNot_sse2,    &MemFindAny_sse2,    &MemFindBytes_sse2,    &MemCount_sse2,    &MemMismatch_sse2,    &MemToLower_sse2,    &MemToUpper_sse2,    &MemFindI_sse2,    &MemFindBytesI_sse2,    &MemFindInRange_sse2,    &MemFindNotInRange_sse2,    &MemValidateUTF8_sse2,    &MemClassify_sse2,    &MemFind16_sse2,    &MemFind32_sse2,    &MemFind64_sse2,    &MemLowerBound32_sse2,    &MemLowerBound64_sse2,    &MemTranslate_sse2,    &MemHash64_sse2,    &MemIsEqualBatch_sse2,    &MemCompareBatch_sse2,    &MemIsEqualConstTime_sse2,    &MemFindV_sse2,    &MemIsEqualV_sse2,    0                },
+    { "avx2",    &MemCompare_avx2,    &MemCompareI_avx2,    &MemIsEqual_avx2,    &MemFind_avx2,    &MemFindNot_avx2,    &MemFindLast_avx2,    &MemFindLastNot_avx2,    &MemFindAny_avx2,    &MemFindBytes_avx2,    &MemCount_avx2,    &MemMismatch_avx2,    &MemToLower_avx2,    &MemToUpper_avx2,    &MemFindI_avx2,    &MemFindBytesI_avx2,    &MemFindInRange_avx2,    &MemFindNotInRange_avx2,    &MemValidateUTF8_avx2,    &MemClassify_avx2,    &MemFind16_avx2,    &MemFind32_avx2,    &MemFind64_avx2,    &MemLowerBound32_avx2,    &MemLowerBound64_avx2,    &MemTranslate_avx2,    &MemHash64_avx2,    &MemIsEqualBatch_avx2,    &MemCompareBatch_avx2,    &MemIsEqualConstTime_avx2,    &MemFindV_avx2,    &MemIsEqualV_avx2,    MEM_CPUID_AVX2   },
+    { "avx10",   &MemCompare_avx10,   0,                    &MemIsEqual_avx10,   &MemFind_avx10,   &MemFindNot_avx10,   &MemFindLast_avx10,   &MemFindLastNot_avx10,   0,                   0,                     &MemCount_avx10,   &MemMismatch_avx10,   0,                   0,                   0,                 0,                      0,                       0,                          0,                        0,                    0,                  0,                  0,                  0,                        0,                        0,                     0,                  0,                        0,                        0,                            0,                 0,                    MEM_CPUID_AVX10  },
+    { "avx512",  &MemCompare_avx512,  &MemCompareI_avx512,  &MemIsEqual_avx512,  &MemFind_avx512,  &MemFindNot_avx512,  &MemFindLast_avx512,  &MemFindLastNot_avx512,  &MemFindAny_avx512,  &MemFindBytes_avx512,  &MemCount_avx512,  &MemMismatch_avx512,  &MemToLower_avx512,  &MemToUpper_avx512,  &MemFindI_avx512,  &MemFindBytesI_avx512,  &MemFindInRange_avx512,  &MemFindNotInRange_avx512,  &MemValidateUTF8_avx512,  &MemClassify_avx512,  &MemFind16_avx512,  &MemFind32_avx512,  &MemFind64_avx512,  &MemLowerBound32_avx512,  &MemLowerBound64_avx512,  &MemTranslate_avx512,  &MemHash64_avx512,  &MemIsEqualBatch_avx512,  &MemCompareBatch_avx512,  &MemIsEqualConstTime_avx512,  &MemFindV_avx512,  &MemIsEqualV_avx512,  MEM_CPUID_AVX512 },
 #endif
-    { "generic",        &MemCompare_generic, &MemCompareI_generic,       &MemIsEqual_generic, &MemFind_generic,   &MemFindNot_generic,  0                   },
+    { "generic", &MemCompare_generic, &MemCompareI_generic, &MemIsEqual_generic, &MemFind_generic, &MemFindNot_generic, &MemFindLast_generic, &MemFindLastNot_generic, &MemFindAny_generic, &MemFindBytes_generic, &MemCount_generic, &MemMismatch_generic, &MemToLower_generic, &MemToUpper_generic, &MemFindI_generic, &MemFindBytesI_generic, &MemFindInRange_generic, &MemFindNotInRange_generic, &MemValidateUTF8_generic, &MemClassify_generic, &MemFind16_generic, &MemFind32_generic, &MemFind64_generic, &MemLowerBound32_generic, &MemLowerBound64_generic, &MemTranslate_generic, &MemHash64_generic, &MemIsEqualBatch_generic, &MemCompareBatch_generic, &MemIsEqualConstTime_generic, &MemFindV_generic, &MemIsEqualV_generic, 0                },
 };
 
 #define BENCH_TINY_LIMIT  1024
@@ -539,7 +920,7 @@ static struct
     double bpc;
     double mbps;
 }
-bench_results[5][countof(memfun)][countof(bench_sizes)];
+bench_results[30][countof(memfun)][countof(bench_sizes)];
 
 typedef struct {
 
@@ -560,11 +941,21 @@ typedef struct {
 
 } bench_context;
 
+#if MEM_ARCH_X64
+// avx512 implementation of few functions also needs VBMI
+#  define BENCH_CPUID_VBMI(cpuid) ((cpuid) == MEM_CPUID_AVX512 ? MEM_CPUID_AVX512VBMI : (cpuid))
+#elif MEM_ARCH_SVE
+// sve implementation of MemFindAny also needs SVE2
+#  define BENCH_CPUID_VBMI(cpuid) ((cpuid) == MEM_CPUID_SVE ? MEM_CPUID_SVE2 : (cpuid))
+#else
+#  define BENCH_CPUID_VBMI(cpuid) (cpuid)
+#endif
+
 static bool bench_begin(bench_context* ctx, const char* name, const char* suffix, int cpuid)
 {
     (void)cpuid;
 
-#if MEM_ARCH_X64
+#if MEM_ARCH_X64 || MEM_ARCH_SVE
     if (cpuid && ((MemCPUID() & cpuid) == 0))
     {
         return false;
@@ -690,75 +1081,608 @@ static bool bench_loop(bench_context* ctx, size_t* size, size_t* unroll)
     return false;
 }
 
-int main()
+// random lookups in sorted arrays of sizes from L1 cache to DRAM, prints nanoseconds per lookup
+static void bench_lowerbound(void)
 {
-    size_t max_size = bench_sizes[countof(bench_sizes)-1];
-
-#if defined(_WIN32)
-    char* ptr = (char*)VirtualAlloc(NULL, 2 * max_size, MEM_COMMIT, PAGE_READWRITE);
-    assert(ptr != NULL);
-#elif defined(__linux__) || defined(__APPLE__)
-    char* ptr = (char*)mmap(NULL, 2 * max_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-    assert(ptr != MAP_FAILED);
-#else
-    #error N/A
-#endif
+    static const size_t array_sizes[] = { 16 << 10, 256 << 10, 4 << 20, 64 << 20 };
+    static const char* array_names[] = { "16K", "256K", "4M", "64M" };
 
-    memset(ptr, 0xff, 2 * max_size);
-    char* ptr1 = ptr;
-    char* ptr2 = ptr + max_size;
+    const size_t lookup_count = 1 << 20;
+    const size_t max_size = array_sizes[countof(array_sizes)-1];
 
-    bench_init();
+    uint8_t* array = (uint8_t*)malloc(max_size);
+    uint64_t* values = (uint64_t*)malloc(lookup_count * sizeof(uint64_t));
+    assert(array && values);
 
-    for (size_t i=0; i<countof(memfun); i++)
+    printf("\n%-17s | %5s", "function / ns", "size");
+    for (size_t t=0; t<countof(memfun)-1; t++)
     {
-        MemCompareFun* fun = memfun[i].compare;
-
-        bench_context ctx;
-        if (fun && bench_begin(&ctx, "MemCompare", memfun[i].name, memfun[i].cpuid))
+#if MEM_ARCH_X64 || MEM_ARCH_SVE
+        if (memfun[t].cpuid && ((MemCPUID() & memfun[t].cpuid) == 0))
         {
-            size_t size, unroll;
-            while (bench_loop(&ctx, &size, &unroll))
-            {
-                for (size_t u=0; u<unroll; u++)
-                {
-                    int result = fun(ptr1, ptr2, size);
-                    BENCH_DO_NOT_OPTIMIZE(result);
-                }
-            }
+            continue;
         }
-        bench_variant++;
+#endif
+        printf(" | %9s", t == 0 ? "CRT" : memfun[t].name);
     }
-    bench_variant = 0;
-    bench_index++;
+    printf("\n");
 
-    for (size_t i=0; i<countof(memfun); i++)
+    for (size_t width=4; width<=8; width*=2)
     {
-        MemCompareFun* fun = memfun[i].comparei;
-
-        bench_context ctx;
-        if (fun && bench_begin(&ctx, "MemCompareI", memfun[i].name, memfun[i].cpuid))
+        for (size_t s=0; s<countof(array_sizes); s++)
         {
-            size_t size, unroll;
-            while (bench_loop(&ctx, &size, &unroll))
+            size_t count = array_sizes[s] / width;
+
+            // sorted unique odd elements, values to search are random in whole range of elements
+            for (size_t i=0; i<count; i++)
             {
-                for (size_t u=0; u<unroll; u++)
+                uint64_t element = 2 * i + 1;
+                memcpy(array + i * width, &element, width);
+            }
+            uint64_t seed = 0x9e3779b97f4a7c15;
+            for (size_t i=0; i<lookup_count; i++)
+            {
+                seed ^= seed << 13;
+                seed ^= seed >> 7;
+                seed ^= seed << 17;
+                values[i] = seed % (2 * count + 2);
+            }
+
+            printf("%-17s | %5s", width == 4 ? "MemLowerBound32" : "MemLowerBound64", array_names[s]);
+            for (size_t t=0; t<countof(memfun)-1; t++)
+            {
+#if MEM_ARCH_X64 || MEM_ARCH_SVE
+                if (memfun[t].cpuid && ((MemCPUID() & memfun[t].cpuid) == 0))
                 {
-                    int result = fun(ptr1, ptr2, size);
-                    BENCH_DO_NOT_OPTIMIZE(result);
+                    continue;
+                }
+#endif
+                MemFind32Fun* fun32 = memfun[t].lowerbound32;
+                MemFind64Fun* fun64 = memfun[t].lowerbound64;
+
+                double best = 1e9;
+                for (size_t iter=0; iter<3; iter++)
+                {
+                    size_t sum = 0;
+
+                    int64_t ticks = bench_get_ticks();
+                    for (size_t i=0; i<lookup_count; i++)
+                    {
+                        sum += width == 4 ? fun32(array, count, (uint32_t)values[i]) : fun64(array, count, values[i]);
+                    }
+                    ticks = bench_get_ticks() - ticks;
+                    BENCH_DO_NOT_OPTIMIZE(sum);
+
+                    double ns = bench_ticks_to_seconds(ticks) * 1e9 / (double)lookup_count;
+                    best = ns < best ? ns : best;
                 }
+                printf(" | %9.2f", best);
             }
+            printf("\n");
+            fflush(stdout);
         }
-        bench_variant++;
     }
-    bench_variant = 0;
-    bench_index++;
 
-    for (size_t i=0; i<countof(memfun); i++)
-    {
-        MemIsEqualFun* fun = memfun[i].isequal;
+    free(values);
+    free(array);
+}
 
-        bench_context ctx;
+static void bench_batch(void)
+{
+    static const size_t buffer_sizes[] = { 64 << 10, 64 << 20 };
+    static const char* buffer_names[] = { "64K", "64M" };
+
+    const size_t pair_count = 1 << 16;
+    const size_t max_size = buffer_sizes[countof(buffer_sizes)-1];
+
+    uint8_t* buffer = (uint8_t*)malloc(max_size);
+    MemPair* pairs = (MemPair*)malloc(pair_count * sizeof(MemPair));
+    uint8_t* equal = (uint8_t*)malloc(pair_count);
+    int* order = (int*)malloc(pair_count * sizeof(int));
+    assert(buffer && pairs && equal && order);
+
+    printf("\n%-17s | %5s", "function / ns", "size");
+    for (size_t t=0; t<countof(memfun)-1; t++)
+    {
+#if MEM_ARCH_X64 || MEM_ARCH_SVE
+        if (memfun[t].cpuid && ((MemCPUID() & memfun[t].cpuid) == 0))
+        {
+            continue;
+        }
+#endif
+        printf(" | %9s", t == 0 ? "CRT" : memfun[t].name);
+    }
+    printf("\n");
+
+    for (size_t b=0; b<countof(buffer_sizes); b++)
+    {
+        size_t half = buffer_sizes[b] / 2;
+
+        // second half of buffer is copy of first half, except every 61st byte is different
+        uint64_t seed = 0x9e3779b97f4a7c15;
+        for (size_t i=0; i<half; i++)
+        {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            buffer[i] = (uint8_t)seed;
+            buffer[half + i] = (uint8_t)(seed + (i % 61 == 0));
+        }
+
+        // random short sizes in 1..32 range at random offsets, about a quarter of pairs are different
+        for (size_t i=0; i<pair_count; i++)
+        {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            size_t size = 1 + (size_t)(seed >> 59);
+            size_t offset = (size_t)(seed % (half - size));
+            pairs[i].ptr1 = buffer + offset;
+            pairs[i].ptr2 = buffer + half + offset;
+            pairs[i].size = size;
+        }
+
+        for (size_t f=0; f<4; f++)
+        {
+            static const char* names[] = { "MemIsEqual", "MemIsEqualBatch", "MemCompare", "MemCompareBatch" };
+
+            printf("%-17s | %5s", names[f], buffer_names[b]);
+            for (size_t t=0; t<countof(memfun)-1; t++)
+            {
+#if MEM_ARCH_X64 || MEM_ARCH_SVE
+                if (memfun[t].cpuid && ((MemCPUID() & memfun[t].cpuid) == 0))
+                {
+                    continue;
+                }
+#endif
+                double best = 1e9;
+                for (size_t iter=0; iter<3; iter++)
+                {
+                    int64_t ticks = bench_get_ticks();
+                    switch (f)
+                    {
+                    case 0:
+                        // separate call for every pair
+                        for (size_t i=0; i<pair_count; i++)
+                        {
+                            equal[i] = memfun[t].isequal(pairs[i].ptr1, pairs[i].ptr2, pairs[i].size);
+                        }
+                        break;
+                    case 1:
+                        memfun[t].isequalbatch(pairs, pair_count, equal);
+                        break;
+                    case 2:
+                        for (size_t i=0; i<pair_count; i++)
+                        {
+                            order[i] = memfun[t].compare(pairs[i].ptr1, pairs[i].ptr2, pairs[i].size);
+                        }
+                        break;
+                    case 3:
+                        memfun[t].comparebatch(pairs, pair_count, order);
+                        break;
+                    }
+                    ticks = bench_get_ticks() - ticks;
+                    BENCH_DO_NOT_OPTIMIZE(equal[0]);
+                    BENCH_DO_NOT_OPTIMIZE(order[0]);
+
+                    double ns = bench_ticks_to_seconds(ticks) * 1e9 / (double)pair_count;
+                    best = ns < best ? ns : best;
+                }
+                printf(" | %9.2f", best);
+            }
+            printf("\n");
+            fflush(stdout);
+        }
+    }
+
+    free(order);
+    free(equal);
+    free(pairs);
+    free(buffer);
+}
+
+static void bench_segments(void)
+{
+    const size_t segment_count = 1 << 16;
+    const size_t max_segment = 32;
+    const size_t size = segment_count * max_segment;
+
+    uint8_t* buffer = (uint8_t*)malloc(size);
+    MemSegment* segments1 = (MemSegment*)malloc(segment_count * sizeof(MemSegment));
+    MemSegment* segments2 = (MemSegment*)malloc(2 * segment_count * sizeof(MemSegment));
+    assert(buffer && segments1 && segments2);
+
+    // value 0 is not present, so all segments are searched
+    memset(buffer, 1, size);
+
+    // same bytes split into two different arrays of random 1..32 byte segments
+    uint64_t seed = 0x9e3779b97f4a7c15;
+    size_t total[2] = { 0, 0 };
+    size_t count[2] = { 0, 0 };
+    for (size_t k=0; k<2; k++)
+    {
+        MemSegment* segments = k ? segments2 : segments1;
+        size_t max_count = k ? 2 * segment_count : segment_count;
+        size_t max_total = k ? total[0] : size;
+        while (count[k] < max_count && total[k] < max_total)
+        {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            size_t n = 1 + (size_t)(seed >> 59);
+            n = n < max_total - total[k] ? n : max_total - total[k];
+
+            segments[count[k]].iov_base = buffer + total[k];
+            segments[count[k]].iov_len = n;
+            total[k] += n;
+            count[k]++;
+        }
+    }
+
+    printf("\n%-17s | %5s", "function / ns", "count");
+    for (size_t t=0; t<countof(memfun)-1; t++)
+    {
+#if MEM_ARCH_X64 || MEM_ARCH_SVE
+        if (memfun[t].cpuid && ((MemCPUID() & memfun[t].cpuid) == 0))
+        {
+            continue;
+        }
+#endif
+        printf(" | %9s", t == 0 ? "CRT" : memfun[t].name);
+    }
+    printf("\n");
+
+    for (size_t f=0; f<2; f++)
+    {
+        static const char* names[] = { "MemFindV", "MemIsEqualV" };
+
+        printf("%-17s | %4zuK", names[f], count[0] >> 10);
+        for (size_t t=0; t<countof(memfun)-1; t++)
+        {
+#if MEM_ARCH_X64 || MEM_ARCH_SVE
+            if (memfun[t].cpuid && ((MemCPUID() & memfun[t].cpuid) == 0))
+            {
+                continue;
+            }
+#endif
+            double best = 1e9;
+            for (size_t iter=0; iter<3; iter++)
+            {
+                int64_t ticks = bench_get_ticks();
+                if (f == 0)
+                {
+                    MemPosition result = memfun[t].findv(segments1, count[0], 0);
+                    BENCH_DO_NOT_OPTIMIZE(result.segment);
+                }
+                else
+                {
+                    bool result = memfun[t].isequalv(segments1, count[0], segments2, count[1]);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+                ticks = bench_get_ticks() - ticks;
+
+                double ns = bench_ticks_to_seconds(ticks) * 1e9 / (double)count[0];
+                best = ns < best ? ns : best;
+            }
+            printf(" | %9.2f", best);
+        }
+        printf("\n");
+        fflush(stdout);
+    }
+
+    free(segments2);
+    free(segments1);
+    free(buffer);
+}
+
+static void bench_search(void)
+{
+    static const size_t chunk_sizes[] = { 0, 64 << 10, 1500, 64 };
+    static const char* chunk_names[] = { "MemFindBytes", "MemSearchNext64K", "MemSearchNext1500", "MemSearchNext64" };
+
+    const size_t size = 64 << 20;
+    const char needle[] = "\r\n\r\n";
+    const size_t needlelen = sizeof(needle) - 1;
+
+    uint8_t* buffer = (uint8_t*)malloc(size);
+    assert(buffer);
+
+    // text lines without empty ones, so needle is never found
+    uint64_t seed = 0x9e3779b97f4a7c15;
+    for (size_t i=0; i<size; i++)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        buffer[i] = (uint8_t)(i % 61 == 59 ? '\r' : i % 61 == 60 ? '\n' : 'a' + seed % 26);
+    }
+
+    printf("\n%-17s | %5s | %11s\n", "function / GB/s", "size", "auto");
+
+    for (size_t c=0; c<countof(chunk_sizes); c++)
+    {
+        double best = 1e9;
+        for (size_t iter=0; iter<3; iter++)
+        {
+            size_t result = 0;
+
+            int64_t ticks = bench_get_ticks();
+            if (chunk_sizes[c] == 0)
+            {
+                // whole buffer is contiguous
+                result = MemFindBytes(buffer, size, needle, needlelen);
+            }
+            else
+            {
+                // same buffer received in separate chunks
+                MemSearchState state;
+                MemSearchInit(&state, needle, needlelen);
+                for (size_t offset=0; offset<size; offset+=chunk_sizes[c])
+                {
+                    size_t available = size - offset;
+                    result += MemSearchNext(&state, buffer + offset, available < chunk_sizes[c] ? available : chunk_sizes[c]);
+                }
+            }
+            ticks = bench_get_ticks() - ticks;
+            BENCH_DO_NOT_OPTIMIZE(result);
+
+            double seconds = bench_ticks_to_seconds(ticks);
+            best = seconds < best ? seconds : best;
+        }
+        printf("%-17s | %4zuM | %11.2f\n", chunk_names[c], size >> 20, (double)size / best * 1e-9);
+        fflush(stdout);
+    }
+
+    free(buffer);
+}
+
+#if defined(MEM_PARALLEL)
+static void bench_parallel(void)
+{
+    static const size_t threads[] = { 1, 2, 4, 8, 0 };
+
+    const size_t size = (size_t)1 << 30;
+
+    uint8_t* buffer = (uint8_t*)malloc(size);
+    assert(buffer);
+
+    // no matching byte, so whole buffer is always processed
+    memset(buffer, 0, size);
+
+#if defined(__linux__)
+    // new threads inherit affinity of calling thread, allow them to run on all cores
+    cpu_set_t pinned;
+    sched_getaffinity(0, sizeof(pinned), &pinned);
+    sched_setaffinity(0, sizeof(bench_cpu_mask), &bench_cpu_mask);
+#endif
+
+    printf("\n%-17s | %5s", "function / GB/s", "size");
+    for (size_t t=0; t<countof(threads); t++)
+    {
+        if (threads[t])
+        {
+            printf(" | %3zu thread%s", threads[t], threads[t] == 1 ? " " : "s");
+        }
+        else
+        {
+            printf(" | %11s", "all cores");
+        }
+    }
+    printf("\n");
+
+    for (size_t f=0; f<2; f++)
+    {
+        static const char* names[] = { "MemFindParallel", "MemCountParallel" };
+
+        printf("%-17s | %4zuM", names[f], size >> 20);
+        for (size_t t=0; t<countof(threads); t++)
+        {
+            double best = 1e9;
+            for (size_t iter=0; iter<3; iter++)
+            {
+                int64_t ticks = bench_get_ticks();
+                size_t result = f == 0
+                    ? MemFindParallel(buffer, size, 1, threads[t])
+                    : MemCountParallel(buffer, size, 1, threads[t]);
+                ticks = bench_get_ticks() - ticks;
+                BENCH_DO_NOT_OPTIMIZE(result);
+
+                double seconds = bench_ticks_to_seconds(ticks);
+                best = seconds < best ? seconds : best;
+            }
+            printf(" | %11.2f", (double)size / best * 1e-9);
+        }
+        printf("\n");
+        fflush(stdout);
+    }
+
+#if defined(__linux__)
+    sched_setaffinity(0, sizeof(pinned), &pinned);
+#endif
+
+    free(buffer);
+}
+#endif
+
+#if MEM_ARCH_X64
+
+// for bench_dispatch, these select implementation on every call, same as default dispatch mode
+static BENCH_NOINLINE int MemCompare_cpuid(const void* ptr1, const void* ptr2, size_t size)
+{
+    int cpuid = MemCPUID();
+    return (cpuid & MEM_CPUID_AVX512) ? MemCompare_avx512(ptr1, ptr2, size) : (cpuid & MEM_CPUID_AVX10) ? MemCompare_avx10(ptr1, ptr2, size) : (cpuid & MEM_CPUID_AVX2) ? MemCompare_avx2(ptr1, ptr2, size) : MemCompare_sse2(ptr1, ptr2, size);
+}
+
+static BENCH_NOINLINE size_t MemFind_cpuid(const void* ptr, size_t size, uint8_t value)
+{
+    int cpuid = MemCPUID();
+    return (cpuid & MEM_CPUID_AVX512) ? MemFind_avx512(ptr, size, value) : (cpuid & MEM_CPUID_AVX10) ? MemFind_avx10(ptr, size, value) : (cpuid & MEM_CPUID_AVX2) ? MemFind_avx2(ptr, size, value) : MemFind_sse2(ptr, size, value);
+}
+
+#endif
+
+static void bench_dispatch(void)
+{
+#if MEM_ARCH_X64
+#if defined(MEM_DISPATCH_IFUNC)
+    const char* mode = "ifunc";
+#elif defined(MEM_DISPATCH_TABLE)
+    const char* mode = "table";
+#else
+    const char* mode = "default";
+#endif
+
+    static const size_t sizes[] = { 16, 64 };
+    static const char* names[] = { "auto", "cpuid", "pointer" };
+
+    const size_t calls = 1 << 24;
+
+    uint8_t buffer1[256];
+    uint8_t buffer2[256];
+    memset(buffer1, 'a', sizeof(buffer1));
+    memset(buffer2, 'a', sizeof(buffer2));
+
+    // function pointers selected once, like MEM_DISPATCH_TABLE mode does
+    int cpuid = MemCPUID();
+    int (*volatile compare)(const void* ptr1, const void* ptr2, size_t size) = (cpuid & MEM_CPUID_AVX512) ? &MemCompare_avx512 : (cpuid & MEM_CPUID_AVX10) ? &MemCompare_avx10 : (cpuid & MEM_CPUID_AVX2) ? &MemCompare_avx2 : &MemCompare_sse2;
+    size_t (*volatile find)(const void* ptr, size_t size, uint8_t value) = (cpuid & MEM_CPUID_AVX512) ? &MemFind_avx512 : (cpuid & MEM_CPUID_AVX10) ? &MemFind_avx10 : (cpuid & MEM_CPUID_AVX2) ? &MemFind_avx2 : &MemFind_sse2;
+
+    // "auto" column is public function built in current dispatch mode, its name is printed in header
+    printf("\n%-17s | %5s", "function / ns", "size");
+    for (size_t v=0; v<countof(names); v++)
+    {
+        printf(" | %11s", v == 0 ? mode : names[v]);
+    }
+    printf("\n");
+
+    for (size_t f=0; f<2; f++)
+    {
+        for (size_t s=0; s<countof(sizes); s++)
+        {
+            printf("%-17s | %5zu", f == 0 ? "MemCompare" : "MemFind", sizes[s]);
+
+            for (size_t v=0; v<countof(names); v++)
+            {
+                double best = 1e9;
+                for (size_t iter=0; iter<3; iter++)
+                {
+                    size_t result = 0;
+
+                    int64_t ticks = bench_get_ticks();
+                    for (size_t i=0; i<calls; i++)
+                    {
+                        const uint8_t* ptr1 = buffer1 + (i & 63);
+                        const uint8_t* ptr2 = buffer2 + (i & 63);
+                        if (f == 0)
+                        {
+                            switch (v)
+                            {
+                            case 0: result += (size_t)MemCompare(ptr1, ptr2, sizes[s]); break;
+                            case 1: result += (size_t)MemCompare_cpuid(ptr1, ptr2, sizes[s]); break;
+                            case 2: result += (size_t)compare(ptr1, ptr2, sizes[s]); break;
+                            }
+                        }
+                        else
+                        {
+                            switch (v)
+                            {
+                            case 0: result += MemFind(ptr1, sizes[s], 'b'); break;
+                            case 1: result += MemFind_cpuid(ptr1, sizes[s], 'b'); break;
+                            case 2: result += find(ptr1, sizes[s], 'b'); break;
+                            }
+                        }
+                    }
+                    ticks = bench_get_ticks() - ticks;
+                    BENCH_DO_NOT_OPTIMIZE(result);
+
+                    double seconds = bench_ticks_to_seconds(ticks);
+                    best = seconds < best ? seconds : best;
+                }
+                printf(" | %11.2f", best / (double)calls * 1e9);
+                fflush(stdout);
+            }
+            printf("\n");
+        }
+    }
+#endif
+}
+
+int main()
+{
+    size_t max_size = bench_sizes[countof(bench_sizes)-1];
+
+#if defined(_WIN32)
+    char* ptr = (char*)VirtualAlloc(NULL, 2 * max_size, MEM_COMMIT, PAGE_READWRITE);
+    assert(ptr != NULL);
+#elif defined(__linux__) || defined(__APPLE__)
+    char* ptr = (char*)mmap(NULL, 2 * max_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    assert(ptr != MAP_FAILED);
+#else
+    #error N/A
+#endif
+
+    memset(ptr, 0xff, 2 * max_size);
+
+    // none of these bytes are present in the buffer
+    static const uint8_t set_any[] = { '\r', '\n', '"', '\\', '<', '>', '&', '\'', 0x00, 0x01, 0x09, 0x1f, 0x7f, 0x80, 0xc0, 0xfe };
+
+    // needles not present in the buffer, header boundary and multipart separator
+    static const char needle4[] = "\r\n\r\n";
+    static const char needle16[] = "--boundary-1234\n";
+    char* ptr1 = ptr;
+    char* ptr2 = ptr + max_size;
+
+    bench_init();
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemCompareFun* fun = memfun[i].compare;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemCompare", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    int result = fun(ptr1, ptr2, size);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemCompareFun* fun = memfun[i].comparei;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemCompareI", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    int result = fun(ptr1, ptr2, size);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemIsEqualFun* fun = memfun[i].isequal;
+
+        bench_context ctx;
         if (fun && bench_begin(&ctx, "MemIsEqual", memfun[i].name, memfun[i].cpuid))
         {
             size_t size, unroll;
@@ -766,7 +1690,315 @@ int main()
             {
                 for (size_t u=0; u<unroll; u++)
                 {
-                    bool result = fun(ptr1, ptr2, size);
+                    bool result = fun(ptr1, ptr2, size);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemFindFun* fun = memfun[i].find;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemFind", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr1, size, 0);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemFindFun* fun = memfun[i].count;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemCount", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr1, size, '\n');
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemFindFun* fun = memfun[i].findnot;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemFindNot", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr1, size, 0xff);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemFindFun* fun = memfun[i].findlast;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemFindLast", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr1, size, 0);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemFindFun* fun = memfun[i].findlastnot;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemFindLastNot", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr1, size, 0xff);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemFindAnyFun* fun = memfun[i].findany;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemFindAny2", memfun[i].name, BENCH_CPUID_VBMI(memfun[i].cpuid)))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr1, size, set_any, 2);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemFindAnyFun* fun = memfun[i].findany;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemFindAny3", memfun[i].name, BENCH_CPUID_VBMI(memfun[i].cpuid)))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr1, size, set_any, 3);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemFindAnyFun* fun = memfun[i].findany;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemFindAny16", memfun[i].name, BENCH_CPUID_VBMI(memfun[i].cpuid)))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr1, size, set_any, 16);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemFindBytesFun* fun = memfun[i].findbytes;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemFindBytes4", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr1, size, needle4, sizeof(needle4) - 1);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemFindBytesFun* fun = memfun[i].findbytes;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemFindBytes16", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr1, size, needle16, sizeof(needle16) - 1);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemMismatchFun* fun = memfun[i].mismatch;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemMismatch", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr1, ptr2, size);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemConvertFun* fun = memfun[i].tolower;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemToLower", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    fun(ptr2, ptr1, size);
+                    BENCH_DO_NOT_OPTIMIZE(ptr2[0]);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemConvertFun* fun = memfun[i].toupper;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemToUpper", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    fun(ptr2, ptr1, size);
+                    BENCH_DO_NOT_OPTIMIZE(ptr2[0]);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemFindFun* fun = memfun[i].findi;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemFindI", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr1, size, 'a');
                     BENCH_DO_NOT_OPTIMIZE(result);
                 }
             }
@@ -778,17 +2010,17 @@ int main()
 
     for (size_t i=0; i<countof(memfun); i++)
     {
-        MemFindFun* fun = memfun[i].find;
+        MemFindBytesFun* fun = memfun[i].findbytesi;
 
         bench_context ctx;
-        if (fun && bench_begin(&ctx, "MemFind", memfun[i].name, memfun[i].cpuid))
+        if (fun && bench_begin(&ctx, "MemFindBytesI16", memfun[i].name, memfun[i].cpuid))
         {
             size_t size, unroll;
             while (bench_loop(&ctx, &size, &unroll))
             {
                 for (size_t u=0; u<unroll; u++)
                 {
-                    size_t result = fun(ptr1, size, 0);
+                    size_t result = fun(ptr1, size, needle16, sizeof(needle16) - 1);
                     BENCH_DO_NOT_OPTIMIZE(result);
                 }
             }
@@ -800,17 +2032,282 @@ int main()
 
     for (size_t i=0; i<countof(memfun); i++)
     {
-        MemFindFun* fun = memfun[i].findnot;
+        MemFindRangeFun* fun = memfun[i].findinrange;
 
         bench_context ctx;
-        if (fun && bench_begin(&ctx, "MemFindNot", memfun[i].name, memfun[i].cpuid))
+        if (fun && bench_begin(&ctx, "MemFindInRange", memfun[i].name, memfun[i].cpuid))
         {
             size_t size, unroll;
             while (bench_loop(&ctx, &size, &unroll))
             {
                 for (size_t u=0; u<unroll; u++)
                 {
-                    size_t result = fun(ptr1, size, 0xff);
+                    size_t result = fun(ptr1, size, 0x00, 0x1f);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemFindRangeFun* fun = memfun[i].findnotinrange;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemFindNotInRange", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr1, size, 0x80, 0xff);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    // ASCII text
+    for (size_t i=0; i<max_size; i++)
+    {
+        ptr2[i] = (char)(' ' + i % 95);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemValidateFun* fun = memfun[i].validateutf8;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemValidateUTF8A", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr2, size);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    // mixed text with 1, 2, 3 and 4 byte sequences
+    {
+        static const char text[] = "Text with Gr\xc3\xbc\xc3\x9f\x65, \xd0\xbc\xd0\xb8\xd1\x80, \xe4\xb8\x96\xe7\x95\x8c and \xf0\x9f\x98\x80. ";
+        for (size_t i=0; i<max_size; i++)
+        {
+            ptr2[i] = text[i % (sizeof(text) - 1)];
+        }
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemValidateFun* fun = memfun[i].validateutf8;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemValidateUTF8M", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr2, size);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemClassifyFun* fun = memfun[i].classify;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemClassify3", memfun[i].name, BENCH_CPUID_VBMI(memfun[i].cpuid)))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    fun(ptr1, size, set_any, 3, (uint64_t*)ptr2);
+                    BENCH_DO_NOT_OPTIMIZE(ptr2[0]);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemClassifyFun* fun = memfun[i].classify;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemClassify16", memfun[i].name, BENCH_CPUID_VBMI(memfun[i].cpuid)))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    fun(ptr1, size, set_any, 16, (uint64_t*)ptr2);
+                    BENCH_DO_NOT_OPTIMIZE(ptr2[0]);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemFind16Fun* fun = memfun[i].find16;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemFind16", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr1, size / sizeof(uint16_t), 0);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemFind32Fun* fun = memfun[i].find32;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemFind32", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr1, size / sizeof(uint32_t), 0);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemFind64Fun* fun = memfun[i].find64;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemFind64", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    size_t result = fun(ptr1, size / sizeof(uint64_t), 0);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    // DNA complement, all other bytes stay the same
+    uint8_t complement[256];
+    for (size_t i=0; i<256; i++)
+    {
+        complement[i] = (uint8_t)i;
+    }
+    complement['A'] = 'T'; complement['T'] = 'A'; complement['C'] = 'G'; complement['G'] = 'C';
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemTranslateFun* fun = memfun[i].translate;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemTranslate", memfun[i].name, BENCH_CPUID_VBMI(memfun[i].cpuid)))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    fun(ptr2, ptr1, size, complement);
+                    BENCH_DO_NOT_OPTIMIZE(ptr2[0]);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemHashFun* fun = memfun[i].hash64;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemHash64", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    uint64_t result = fun(ptr1, size, u);
+                    BENCH_DO_NOT_OPTIMIZE(result);
+                }
+            }
+        }
+        bench_variant++;
+    }
+    bench_variant = 0;
+    bench_index++;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        MemIsEqualFun* fun = memfun[i].isequalconsttime;
+
+        bench_context ctx;
+        if (fun && bench_begin(&ctx, "MemIsEqualCT", memfun[i].name, memfun[i].cpuid))
+        {
+            size_t size, unroll;
+            while (bench_loop(&ctx, &size, &unroll))
+            {
+                for (size_t u=0; u<unroll; u++)
+                {
+                    bool result = fun(ptr1, ptr2, size);
                     BENCH_DO_NOT_OPTIMIZE(result);
                 }
             }
@@ -820,18 +2317,20 @@ int main()
     bench_variant = 0;
     bench_index++;
 
+    memset(ptr2, 0xff, max_size);
+
     bench_done();
 
     {
-        static const char* names[] = { "MemCompare", "MemCompareI", "MemIsEqual", "MemFind", "MemFindNot" };
+        static const char* names[] = { "MemCompare", "MemCompareI", "MemIsEqual", "MemFind", "MemCount", "MemFindNot", "MemFindLast", "MemFindLastNot", "MemFindAny2", "MemFindAny3", "MemFindAny16", "MemFindBytes4", "MemFindBytes16", "MemMismatch", "MemToLower", "MemToUpper", "MemFindI", "MemFindBytesI16", "MemFindInRange", "MemFindNotInRange", "MemValidateUTF8A", "MemValidateUTF8M", "MemClassify3", "MemClassify16", "MemFind16", "MemFind32", "MemFind64", "MemTranslate", "MemHash64", "MemIsEqualCT" };
         static const size_t sizes[] = { 15, 63, 1024, 16384 };
 
-        printf("%-14s | %5s", "function / bpc", "size");
+        printf("%-17s | %5s", "function / bpc", "size");
         for (size_t t=0; t<countof(memfun)-1; t++)
         {
             const char* type = (t == 0) ? "CRT" : memfun[t].name;
 
-#if MEM_ARCH_X64
+#if MEM_ARCH_X64 || MEM_ARCH_SVE
             if (memfun[t].cpuid && ((MemCPUID() & memfun[t].cpuid) == 0))
             {
                 continue;
@@ -848,11 +2347,11 @@ int main()
             char delim[256];
             memset(delim, '-', sizeof(delim));
 
-            printf("%.*s+%.*s", 15, delim, 6, delim);
+            printf("%.*s+%.*s", 18, delim, 6, delim);
 
             for (size_t t=0; t<countof(memfun)-1; t++)
             {
-#if MEM_ARCH_X64
+#if MEM_ARCH_X64 || MEM_ARCH_SVE
                 if (memfun[t].cpuid && ((MemCPUID() & memfun[t].cpuid) == 0))
                 {
                     continue;
@@ -872,7 +2371,7 @@ int main()
                 {
                     if (bench_sizes[i] == sizes[s])
                     {
-                        printf("%-14s | %5zu", names[n], sizes[s]);
+                        printf("%-17s | %5zu", names[n], sizes[s]);
 
                         for (size_t t=0; t<countof(memfun)-1; t++)
                         {
@@ -880,7 +2379,7 @@ int main()
                             {
                                 printf(" | %-19s", "(slow)");
                             }
-                            else if (strcmp(names[n], "MemFindNot") == 0 && t == 0)
+                            else if (bench_results[n][t][i].bpc == 0)
                             {
                                 printf(" | %-19s", "(n/a)");
                             }
@@ -897,4 +2396,13 @@ int main()
             }
         }
     }
+
+    bench_lowerbound();
+    bench_batch();
+    bench_segments();
+    bench_search();
+#if defined(MEM_PARALLEL)
+    bench_parallel();
+#endif
+    bench_dispatch();
 }
@@ -3,6 +3,9 @@
 #endif
 
 #define MEM_STATIC
+#if !defined(__wasi__)
+#  define MEM_PARALLEL
+#endif
 #include "memfun.h"
 
 #include <stdio.h>
@@ -23,6 +26,23 @@
 typedef int    MemCompareFun(const void* ptr1, const void* ptr2, size_t size);
 typedef bool   MemIsEqualFun(const void* ptr1, const void* ptr2, size_t size);
 typedef size_t MemFindFun   (const void* ptr, size_t size, uint8_t value);
+typedef size_t MemFindAnyFun(const void* ptr, size_t size, const void* set, size_t setlen);
+typedef size_t MemFindBytesFun(const void* ptr, size_t size, const void* needle, size_t needlelen);
+typedef size_t MemMismatchFun(const void* ptr1, const void* ptr2, size_t size);
+typedef void   MemConvertFun(void* dst, const void* src, size_t size);
+typedef size_t MemFindRangeFun(const void* ptr, size_t size, uint8_t lo, uint8_t hi);
+typedef size_t MemValidateFun(const void* ptr, size_t size);
+typedef void   MemClassifyFun(const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks);
+typedef size_t MemFind16Fun (const void* ptr, size_t count, uint16_t value);
+typedef size_t MemFind32Fun (const void* ptr, size_t count, uint32_t value);
+typedef size_t MemFind64Fun (const void* ptr, size_t count, uint64_t value);
+typedef void   MemTranslateFun(void* dst, const void* src, size_t size, const uint8_t table[256]);
+typedef uint64_t MemHashFun (const void* ptr, size_t size, uint64_t seed);
+typedef void   MemBatchEqFun(const MemPair* pairs, size_t count, uint8_t* results);
+typedef void   MemBatchCmpFun(const MemPair* pairs, size_t count, int* results);
+typedef size_t MemParallelFun(const void* ptr, size_t size, uint8_t value, size_t threads);
+typedef MemPosition MemFindVFun(const MemSegment* segments, size_t count, uint8_t value);
+typedef bool   MemIsEqualVFun(const MemSegment* segments1, size_t count1, const MemSegment* segments2, size_t count2);
 
 static int MemCompare_ref(const void* ptr1, const void* ptr2, size_t size)
 {
@@ -93,347 +113,3253 @@ static size_t MemFindNot_ref(const void* ptr, size_t size, uint8_t value)
     return size;
 }
 
-static int MemCompare_std(const void* ptr1, const void* ptr2, size_t size)
+static size_t MemFindLast_ref(const void* ptr, size_t size, uint8_t value)
 {
-    return memcmp(ptr1, ptr2, size);
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    for (size_t i=size; i-->0; )
+    {
+        if (p[i] == value) return i;
+    }
+
+    return size;
 }
 
-static int MemCompareI_std(const void* ptr1, const void* ptr2, size_t size)
+static size_t MemFindLastNot_ref(const void* ptr, size_t size, uint8_t value)
 {
-#if defined(_WIN32) && !defined(__MINGW32__)
-    return _memicmp(ptr1, ptr2, size);
-#else
-    const uint8_t* p1 = (const uint8_t*)ptr1;
-    const uint8_t* p2 = (const uint8_t*)ptr2;
+    const uint8_t* p = (const uint8_t*)ptr;
 
-    for (size_t i=0; i<size; i++)
+    for (size_t i=size; i-->0; )
     {
-        uint8_t c1 = (uint8_t)tolower(p1[i]);
-        uint8_t c2 = (uint8_t)tolower(p2[i]);
-        if (c1 != c2) return c1 - c2;
+        if (p[i] != value) return i;
     }
 
-    return 0;
-#endif
+    return size;
 }
 
-static bool MemIsEqual_std(const void* ptr1, const void* ptr2, size_t size)
+static size_t MemFindAny_ref(const void* ptr, size_t size, const void* set, size_t setlen)
 {
-#if defined(__linux__)
-    return __memcmpeq(ptr1, ptr2, size) == 0;
-#else
-    return memcmp(ptr1, ptr2, size) == 0;
-#endif
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* s = (const uint8_t*)set;
+
+    bool in_set[256] = { 0 };
+    for (size_t k=0; k<setlen; k++)
+    {
+        in_set[s[k]] = true;
+    }
+
+    for (size_t i=0; i<size; i++)
+    {
+        if (in_set[p[i]]) return i;
+    }
+
+    return size;
 }
 
-static size_t MemFind_std(const void* ptr, size_t size, uint8_t value)
+static size_t MemFindBytes_ref(const void* ptr, size_t size, const void* needle, size_t needlelen)
 {
-    void* r = (void*)memchr(ptr, value, size);
-    return r ? (size_t)((char*)r - (char*)ptr) : size;
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* n = (const uint8_t*)needle;
+
+    for (size_t i=0; i+needlelen<=size; i++)
+    {
+        size_t k = 0;
+        while (k<needlelen && p[i+k] == n[k]) k++;
+        if (k == needlelen) return i;
+    }
+
+    return size;
 }
 
-static bool test_error(int expected, int result, const char* ptr1, const char* ptr2, size_t size)
+static size_t MemFindI_ref(const void* ptr, size_t size, uint8_t value)
 {
-    printf("ERROR\n");
+    const uint8_t* p = (const uint8_t*)ptr;
 
-    printf("size     = %zu\n", size);
-    printf("expected = %d\n", expected);
-    printf("result   = %d\n", result);
+    for (size_t i=0; i<size; i++)
+    {
+        if (tolower(p[i]) == tolower(value)) return i;
+    }
 
-    printf("%s     = ", ptr2 ? "ptr1" : "ptr ");
-    for (size_t i=0; i<size; i++) printf("%02hhx", (uint8_t)ptr1[i]);
-    printf("\n");
+    return size;
+}
 
-    if (ptr2)
+static size_t MemFindBytesI_ref(const void* ptr, size_t size, const void* needle, size_t needlelen)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* n = (const uint8_t*)needle;
+
+    for (size_t i=0; i+needlelen<=size; i++)
     {
-        printf("ptr2     = ");
-        for (size_t i=0; i<size; i++) printf("%02hhx", (uint8_t)ptr2[i]);
-        printf("\n");
+        size_t k = 0;
+        while (k<needlelen && tolower(p[i+k]) == tolower(n[k])) k++;
+        if (k == needlelen) return i;
     }
 
-    return false;
+    return size;
 }
 
-static bool test_compare(const char* ptr1, const char* ptr2, size_t size, MemCompareFun* ref, MemCompareFun* fun)
+static size_t MemCount_ref(const void* ptr, size_t size, uint8_t value)
 {
-    int expected = ref(ptr1, ptr2, size);
-    int result   = fun(ptr1, ptr2, size);
-
-    expected = expected < 0 ? -1 : expected > 0 ? +1 : 0;
-    result   = result   < 0 ? -1 : result   > 0 ? +1 : 0;
+    const uint8_t* p = (const uint8_t*)ptr;
 
-    if (result == expected)
+    size_t count = 0;
+    for (size_t i=0; i<size; i++)
     {
-        return true;
+        count += p[i] == value;
     }
-    return test_error(expected, result, ptr1, ptr2, size);
+
+    return count;
 }
 
-static bool test_isequal(const char* ptr1, const char* ptr2, size_t size, MemIsEqualFun* ref, MemIsEqualFun* fun)
+static size_t MemMismatch_ref(const void* ptr1, const void* ptr2, size_t size)
 {
-    bool expected = ref(ptr1, ptr2, size);
-    bool result   = fun(ptr1, ptr2, size);
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
 
-    if (result == expected)
+    for (size_t i=0; i<size; i++)
     {
-        return true;
+        if (p1[i] != p2[i]) return i;
     }
-    return test_error(expected, result, ptr1, ptr2, size);
+
+    return size;
 }
 
-static bool test_find(const char* ptr, size_t size, uint8_t value, MemFindFun* ref, MemFindFun* fun)
+static void MemToLower_ref(void* dst, const void* src, size_t size)
 {
-    size_t expected = ref(ptr, size, value);
-    size_t result   = fun(ptr, size, value);
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
 
-    if (result == expected)
+    for (size_t i=0; i<size; i++)
     {
-        return true;
+        uint8_t c = s[i];
+        d[i] = c >= 'A' && c <= 'Z' ? (uint8_t)(c + 'a' - 'A') : c;
     }
-    return test_error((int)expected, (int)result, ptr, NULL, size);
 }
 
-static bool run_compare(char* ptr, size_t page_size, MemCompareFun* ref, MemCompareFun* fun)
+static void MemToUpper_ref(void* dst, const void* src, size_t size)
 {
-    if (!test_compare(NULL, NULL, 0, ref, fun)) return false;
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
 
-    // max size to test
-    const size_t size = 256;
+    for (size_t i=0; i<size; i++)
+    {
+        uint8_t c = s[i];
+        d[i] = c >= 'a' && c <= 'z' ? (uint8_t)(c - 'a' + 'A') : c;
+    }
+}
 
-    memset(ptr + page_size, 0, 2 * page_size);
+static size_t MemFindInRange_ref(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
 
-    // test all sizes
-    for (size_t n=1; n<size; n++)
+    for (size_t i=0; i<size; i++)
     {
-        char* ptr1 = ptr + page_size;               // ptr1 is at start of page boundary (no reading before it)
-        char* ptr2 = ptr + 3 * page_size - n;       // ptr2 is at end of page boundary (no reading after it)
-        char* ptr3 = ptr + page_size + page_size/2; // ptr3 is in middle, can be written before & after
+        if (p[i] >= lo && p[i] <= hi) return i;
+    }
 
-        // strings are equal by default
-        for (size_t i=0; i<n; i++)
-        {
-            if (ref == &MemCompare_ref)
-            {
-                ptr1[i] = ptr2[i] = ptr3[i] = (char)(31 * i + 13);
-            }
-            else
-            {
-                ptr1[i] = ptr2[i] = (char)('A' + (i % ('Z'-'A'+1)));
-                ptr3[i] = i%2 ? ptr1[i] : (char)tolower(ptr1[i]);
-            }
-        }
+    return size;
+}
 
-        for (size_t t=0; t<2; t++)
-        {
-            if (!test_compare(ptr1, ptr3, n, ref, fun)) return false;
-            if (!test_compare(ptr3, ptr1, n, ref, fun)) return false;
+static size_t MemFindNotInRange_ref(const void* ptr, size_t size, uint8_t lo, uint8_t hi)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
 
-            // will mismatch if ptr1 is read past the end
-            ptr1[n] ^= (char)0xff;
-        }
+    for (size_t i=0; i<size; i++)
+    {
+        if (p[i] < lo || p[i] > hi) return i;
+    }
 
-        for (size_t t=0; t<2; t++)
-        {
-            if (!test_compare(ptr2, ptr3, n, ref, fun)) return false;
-            if (!test_compare(ptr3, ptr2, n, ref, fun)) return false;
+    return size;
+}
 
-            // will mismatch if ptr2 is read past the beginning
-            ptr2[-1] ^= (char)0xff;
-        }
+static size_t MemValidateUTF8_ref(const void* ptr, size_t size)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
 
-        // test a difference in each position in [0,n] interval
-        for (size_t k=0; k<n; k++)
+    // smallest code point for each sequence length
+    static const uint32_t min[] = { 0, 0, 0x80, 0x800, 0x10000 };
+
+    size_t i = 0;
+    while (i < size)
+    {
+        uint32_t c = p[i];
+        size_t n = c < 0x80 ? 1 : c < 0xc0 ? 0 : c < 0xe0 ? 2 : c < 0xf0 ? 3 : c < 0xf8 ? 4 : 0;
+        if (n == 0 || i + n > size) return i;
+
+        uint32_t cp = n == 1 ? c : c & (0x7f >> n);
+        for (size_t k=1; k<n; k++)
         {
-            ptr3[k] ^= (char)0xff;
-            if (!test_compare(ptr1, ptr3, n, ref, fun)) return false;
-            if (!test_compare(ptr1, ptr3, n, ref, fun)) return false;
-            if (!test_compare(ptr3, ptr1, n, ref, fun)) return false;
-            if (!test_compare(ptr3, ptr2, n, ref, fun)) return false;
-            ptr3[k] ^= (char)0xff;
+            if ((p[i+k] & 0xc0) != 0x80) return i;
+            cp = (cp << 6) | (p[i+k] & 0x3f);
         }
+        if (cp < min[n] || cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff)) return i;
+
+        i += n;
     }
 
-    printf("OK\n");
-    return true;
+    return size;
 }
 
-static bool run_isequal(char* ptr, size_t page_size, MemIsEqualFun* ref, MemIsEqualFun* fun)
+static void MemClassify_ref(const void* ptr, size_t size, const void* set, size_t setlen, uint64_t* masks)
 {
-    if (!test_isequal(NULL, NULL, 0, ref, fun)) return false;
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint8_t* s = (const uint8_t*)set;
 
-    // max size to test
-    const size_t size = 256;
+    bool in_set[256] = { 0 };
+    for (size_t k=0; k<setlen; k++)
+    {
+        in_set[s[k]] = true;
+    }
 
-    memset(ptr + page_size, 0, 2 * page_size);
+    for (size_t i=0; i<size; i+=64)
+    {
+        masks[i / 64] = 0;
+    }
+    for (size_t i=0; i<size; i++)
+    {
+        if (in_set[p[i]]) masks[i / 64] |= 1ULL << (i % 64);
+    }
+}
 
-    // test all sizes
-    for (size_t n=1; n<size; n++)
+static size_t MemFind16_ref(const void* ptr, size_t count, uint16_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    for (size_t i=0; i<count; i++)
     {
-        char* ptr1 = ptr + page_size;               // ptr1 is at start of page boundary (no reading before it)
-        char* ptr2 = ptr + 3 * page_size - n;       // ptr2 is at end of page boundary (no reading after it)
-        char* ptr3 = ptr + page_size + page_size/2; // ptr3 is in middle, can be written before & after
+        uint16_t element;
+        memcpy(&element, p + i * sizeof(element), sizeof(element));
+        if (element == value) return i;
+    }
 
-        // strings are equal by default
-        for (size_t i=0; i<n; i++)
-        {
-            ptr1[i] = ptr2[i] = ptr3[i] = (char)(31 * i + 13);
-        }
+    return count;
+}
 
-        for (size_t t=0; t<2; t++)
-        {
-            if (!test_isequal(ptr1, ptr3, n, ref, fun)) return false;
-            if (!test_isequal(ptr3, ptr1, n, ref, fun)) return false;
+static size_t MemFind32_ref(const void* ptr, size_t count, uint32_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
 
-            // will mismatch if ptr1 is read past the end
-            ptr1[n] ^= (char)0xff;
-        }
+    for (size_t i=0; i<count; i++)
+    {
+        uint32_t element;
+        memcpy(&element, p + i * sizeof(element), sizeof(element));
+        if (element == value) return i;
+    }
 
-        for (size_t t=0; t<2; t++)
-        {
-            if (!test_isequal(ptr2, ptr3, n, ref, fun)) return false;
-            if (!test_isequal(ptr3, ptr2, n, ref, fun)) return false;
+    return count;
+}
 
-            // will mismatch if ptr2 is read past the beginning
-            ptr2[-1] ^= (char)0xff;
-        }
+static size_t MemFind64_ref(const void* ptr, size_t count, uint64_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
 
-        // test a difference in each position in [0,n] interval
-        for (size_t k=0; k<n; k++)
-        {
-            ptr3[k] ^= (char)0xff;
-            if (!test_isequal(ptr1, ptr3, n, ref, fun)) return false;
-            if (!test_isequal(ptr1, ptr3, n, ref, fun)) return false;
-            if (!test_isequal(ptr3, ptr1, n, ref, fun)) return false;
-            if (!test_isequal(ptr3, ptr2, n, ref, fun)) return false;
-            ptr3[k] ^= (char)0xff;
-        }
+    for (size_t i=0; i<count; i++)
+    {
+        uint64_t element;
+        memcpy(&element, p + i * sizeof(element), sizeof(element));
+        if (element == value) return i;
     }
 
-    printf("OK\n");
-    return true;
+    return count;
 }
 
-static bool run_find(char* ptr, size_t page_size, MemFindFun* ref, MemFindFun* fun)
+static size_t MemFindNot16_ref(const void* ptr, size_t count, uint16_t value)
 {
-    if (!test_find(NULL, 0, 0xff, ref, fun)) return false;
+    const uint8_t* p = (const uint8_t*)ptr;
 
-    // max size to test
-    const size_t size = 256;
+    for (size_t i=0; i<count; i++)
+    {
+        uint16_t element;
+        memcpy(&element, p + i * sizeof(element), sizeof(element));
+        if (element != value) return i;
+    }
 
-    uint8_t initial = (ref == &MemFind_ref) ? 0x00 : 0xff;
+    return count;
+}
 
-    memset(ptr + page_size, initial, 2 * page_size);
+static size_t MemFindNot32_ref(const void* ptr, size_t count, uint32_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
 
-    // test when page boundary can be crossed, and difference is on next page
-    for (size_t i=2; i<32; i++)
+    for (size_t i=0; i<count; i++)
     {
-        ptr[2*page_size] ^= (char)0xff;
-        if (!test_find(ptr + 2*page_size - 1, i, 0xff, ref, fun)) return false;
-        ptr[2*page_size] ^= (char)0xff;
+        uint32_t element;
+        memcpy(&element, p + i * sizeof(element), sizeof(element));
+        if (element != value) return i;
     }
 
-    // test all sizes
-    for (size_t n=1; n<size; n++)
-    {
+    return count;
+}
+
+static size_t MemFindNot64_ref(const void* ptr, size_t count, uint64_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    for (size_t i=0; i<count; i++)
+    {
+        uint64_t element;
+        memcpy(&element, p + i * sizeof(element), sizeof(element));
+        if (element != value) return i;
+    }
+
+    return count;
+}
+
+static size_t MemLowerBound32_ref(const void* ptr, size_t count, uint32_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    for (size_t i=0; i<count; i++)
+    {
+        uint32_t element;
+        memcpy(&element, p + i * sizeof(element), sizeof(element));
+        if (element >= value) return i;
+    }
+
+    return count;
+}
+
+static size_t MemLowerBound64_ref(const void* ptr, size_t count, uint64_t value)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+
+    for (size_t i=0; i<count; i++)
+    {
+        uint64_t element;
+        memcpy(&element, p + i * sizeof(element), sizeof(element));
+        if (element >= value) return i;
+    }
+
+    return count;
+}
+
+static void MemTranslate_ref(void* dst, const void* src, size_t size, const uint8_t table[256])
+{
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+
+    for (size_t i=0; i<size; i++)
+    {
+        d[i] = table[s[i]];
+    }
+}
+
+static uint64_t MemHash64Load_ref(const uint8_t* p, size_t size)
+{
+    // little-endian number from up to 8 bytes
+    uint64_t r = 0;
+    for (size_t i=0; i<size; i++)
+    {
+        r |= (uint64_t)p[i] << (i * 8);
+    }
+    return r;
+}
+
+static uint64_t MemHash64Mul_ref(uint64_t a, uint64_t b)
+{
+    // 128-bit product by 16-bit digits, returns low ^ high 64 bits
+    uint32_t r[8] = { 0 };
+    for (size_t i=0; i<4; i++)
+    {
+        uint32_t carry = 0;
+        for (size_t j=0; j<4; j++)
+        {
+            uint32_t t = (uint32_t)((a >> (i * 16)) & 0xffff) * (uint32_t)((b >> (j * 16)) & 0xffff) + r[i + j] + carry;
+            r[i + j] = t & 0xffff;
+            carry = t >> 16;
+        }
+        r[i + 4] = carry;
+    }
+    uint64_t lo = r[0] | ((uint64_t)r[1] << 16) | ((uint64_t)r[2] << 32) | ((uint64_t)r[3] << 48);
+    uint64_t hi = r[4] | ((uint64_t)r[5] << 16) | ((uint64_t)r[6] << 32) | ((uint64_t)r[7] << 48);
+    return lo ^ hi;
+}
+
+static uint64_t MemHash64Avalanche_ref(uint64_t h)
+{
+    h ^= h >> 37;
+    h *= 0x165667919e3779f9;
+    return h ^ (h >> 32);
+}
+
+static uint64_t MemHash64_ref(const void* ptr, size_t size, uint64_t seed)
+{
+    const uint8_t* p = (const uint8_t*)ptr;
+    const uint64_t* secret = MemHashSecret;
+    const uint64_t prime = 0x9e3779b185ebca87;
+
+    if (size <= 16)
+    {
+        uint64_t a = MemHash64Load_ref(p, size < 8 ? size : 8) ^ (secret[0] + seed);
+        uint64_t b = MemHash64Load_ref(p + 8, size < 8 ? 0 : size - 8) ^ (secret[1] - seed);
+
+        uint64_t swapped = 0;
+        for (size_t i=0; i<8; i++)
+        {
+            swapped |= ((a >> (i * 8)) & 0xff) << (56 - i * 8);
+        }
+        return MemHash64Avalanche_ref(size * prime + swapped + b + MemHash64Mul_ref(a, b));
+    }
+
+    if (size <= 256)
+    {
+        uint64_t h = size * prime;
+        size_t chunks = (size - 1) / 16;
+        for (size_t i=0; i<=chunks; i++)
+        {
+            // last chunk is always last 16 bytes of input
+            size_t offset = i < chunks ? i * 16 : size - 16;
+            size_t s = i < chunks ? i : 16;
+            uint64_t a = MemHash64Load_ref(p + offset + 0, 8) ^ (secret[s + 0] + seed);
+            uint64_t b = MemHash64Load_ref(p + offset + 8, 8) ^ (secret[s + 1] - seed);
+            h += MemHash64Mul_ref(a, b);
+        }
+        return MemHash64Avalanche_ref(h);
+    }
+
+    uint64_t acc[8];
+    for (size_t i=0; i<8; i++)
+    {
+        acc[i] = secret[24 + i] + seed;
+    }
+
+    size_t stripes = (size - 1) / 64;
+    for (size_t n=0; n<=stripes; n++)
+    {
+        // last stripe is always last 64 bytes of input
+        size_t offset = n < stripes ? n * 64 : size - 64;
+        size_t s = n < stripes ? n % 16 : 16;
+
+        for (size_t i=0; i<8; i++)
+        {
+            uint64_t data = MemHash64Load_ref(p + offset + i * 8, 8);
+            uint64_t mixed = data ^ secret[s + i];
+            acc[i] += (mixed & 0xffffffff) * (mixed >> 32);
+            acc[i ^ 1] += data;
+        }
+
+        // scramble after every 16 stripes, except after last one
+        if (n < stripes && n % 16 == 15)
+        {
+            for (size_t i=0; i<8; i++)
+            {
+                acc[i] = (acc[i] ^ (acc[i] >> 47) ^ secret[16 + i]) * 0x9e3779b1;
+            }
+        }
+    }
+
+    uint64_t h = size * prime + seed;
+    for (size_t i=0; i<8; i+=2)
+    {
+        h += MemHash64Mul_ref(acc[i] ^ secret[i], acc[i + 1] ^ secret[i + 1]);
+    }
+    return MemHash64Avalanche_ref(h);
+}
+
+static int MemCompare_std(const void* ptr1, const void* ptr2, size_t size)
+{
+    return memcmp(ptr1, ptr2, size);
+}
+
+static int MemCompareI_std(const void* ptr1, const void* ptr2, size_t size)
+{
+#if defined(_WIN32) && !defined(__MINGW32__)
+    return _memicmp(ptr1, ptr2, size);
+#else
+    const uint8_t* p1 = (const uint8_t*)ptr1;
+    const uint8_t* p2 = (const uint8_t*)ptr2;
+
+    for (size_t i=0; i<size; i++)
+    {
+        uint8_t c1 = (uint8_t)tolower(p1[i]);
+        uint8_t c2 = (uint8_t)tolower(p2[i]);
+        if (c1 != c2) return c1 - c2;
+    }
+
+    return 0;
+#endif
+}
+
+static bool MemIsEqual_std(const void* ptr1, const void* ptr2, size_t size)
+{
+#if defined(__linux__)
+    return __memcmpeq(ptr1, ptr2, size) == 0;
+#else
+    return memcmp(ptr1, ptr2, size) == 0;
+#endif
+}
+
+static size_t MemFind_std(const void* ptr, size_t size, uint8_t value)
+{
+    void* r = (void*)memchr(ptr, value, size);
+    return r ? (size_t)((char*)r - (char*)ptr) : size;
+}
+
+static bool test_error(int expected, int result, const char* ptr1, const char* ptr2, size_t size)
+{
+    printf("ERROR\n");
+
+    printf("size     = %zu\n", size);
+    printf("expected = %d\n", expected);
+    printf("result   = %d\n", result);
+
+    printf("%s     = ", ptr2 ? "ptr1" : "ptr ");
+    for (size_t i=0; i<size; i++) printf("%02hhx", (uint8_t)ptr1[i]);
+    printf("\n");
+
+    if (ptr2)
+    {
+        printf("ptr2     = ");
+        for (size_t i=0; i<size; i++) printf("%02hhx", (uint8_t)ptr2[i]);
+        printf("\n");
+    }
+
+    return false;
+}
+
+static bool test_compare(const char* ptr1, const char* ptr2, size_t size, MemCompareFun* ref, MemCompareFun* fun)
+{
+    int expected = ref(ptr1, ptr2, size);
+    int result   = fun(ptr1, ptr2, size);
+
+    expected = expected < 0 ? -1 : expected > 0 ? +1 : 0;
+    result   = result   < 0 ? -1 : result   > 0 ? +1 : 0;
+
+    if (result == expected)
+    {
+        return true;
+    }
+    return test_error(expected, result, ptr1, ptr2, size);
+}
+
+static bool test_isequal(const char* ptr1, const char* ptr2, size_t size, MemIsEqualFun* ref, MemIsEqualFun* fun)
+{
+    bool expected = ref(ptr1, ptr2, size);
+    bool result   = fun(ptr1, ptr2, size);
+
+    if (result == expected)
+    {
+        return true;
+    }
+    return test_error(expected, result, ptr1, ptr2, size);
+}
+
+static bool test_find(const char* ptr, size_t size, uint8_t value, MemFindFun* ref, MemFindFun* fun)
+{
+    size_t expected = ref(ptr, size, value);
+    size_t result   = fun(ptr, size, value);
+
+    if (result == expected)
+    {
+        return true;
+    }
+    return test_error((int)expected, (int)result, ptr, NULL, size);
+}
+
+static bool test_findrange(const char* ptr, size_t size, uint8_t lo, uint8_t hi, MemFindRangeFun* ref, MemFindRangeFun* fun)
+{
+    size_t expected = ref(ptr, size, lo, hi);
+    size_t result   = fun(ptr, size, lo, hi);
+
+    if (result == expected)
+    {
+        return true;
+    }
+    return test_error((int)expected, (int)result, ptr, NULL, size);
+}
+
+static bool test_validate(const char* ptr, size_t size, MemValidateFun* ref, MemValidateFun* fun)
+{
+    size_t expected = ref(ptr, size);
+    size_t result   = fun(ptr, size);
+
+    if (result == expected)
+    {
+        return true;
+    }
+    return test_error((int)expected, (int)result, ptr, NULL, size);
+}
+
+static bool test_findany(const char* ptr, size_t size, const uint8_t* set, size_t setlen, MemFindAnyFun* ref, MemFindAnyFun* fun)
+{
+    size_t expected = ref(ptr, size, set, setlen);
+    size_t result   = fun(ptr, size, set, setlen);
+
+    if (result == expected)
+    {
+        return true;
+    }
+    return test_error((int)expected, (int)result, ptr, NULL, size);
+}
+
+static bool test_classify(const char* ptr, size_t size, const uint8_t* set, size_t setlen, MemClassifyFun* ref, MemClassifyFun* fun)
+{
+    uint64_t expected[8];
+    uint64_t result[8 + 1];
+    assert((size + 63) / 64 < countof(result));
+
+    // will mismatch if more than (size + 63) / 64 masks are written
+    memset(result, 0xcc, sizeof(result));
+
+    ref(ptr, size, set, setlen, expected);
+    fun(ptr, size, set, setlen, result);
+
+    size_t count = (size + 63) / 64;
+    for (size_t k=0; k<count; k++)
+    {
+        if (result[k] != expected[k])
+        {
+            size_t bit = MEM_CTZ64(result[k] ^ expected[k]);
+            return test_error((int)((expected[k] >> bit) & 1), (int)((result[k] >> bit) & 1), ptr, NULL, size);
+        }
+    }
+    if (result[count] != 0xccccccccccccccccULL)
+    {
+        return test_error(0, 1, ptr, NULL, size);
+    }
+    return true;
+}
+
+// wide element find function of one of 16/32/64-bit element sizes
+typedef struct
+{
+    size_t        width;
+    MemFind16Fun* find16;
+    MemFind32Fun* find32;
+    MemFind64Fun* find64;
+}
+MemFindWideFun;
+
+static size_t call_findwide(const MemFindWideFun* fun, const void* ptr, size_t count, uint64_t value)
+{
+    switch (fun->width)
+    {
+    case 2: return fun->find16(ptr, count, (uint16_t)value);
+    case 4: return fun->find32(ptr, count, (uint32_t)value);
+    default: return fun->find64(ptr, count, value);
+    }
+}
+
+static bool test_findwide(const char* ptr, size_t count, uint64_t value, const MemFindWideFun* ref, const MemFindWideFun* fun)
+{
+    size_t expected = call_findwide(ref, ptr, count, value);
+    size_t result   = call_findwide(fun, ptr, count, value);
+
+    if (result == expected)
+    {
+        return true;
+    }
+    return test_error((int)expected, (int)result, ptr, NULL, count * fun->width);
+}
+
+static bool test_hash(const char* ptr, size_t size, uint64_t seed, MemHashFun* ref, MemHashFun* fun)
+{
+    uint64_t expected = ref(ptr, size, seed);
+    uint64_t result   = fun(ptr, size, seed);
+
+    if (result == expected)
+    {
+        return true;
+    }
+
+    printf("ERROR\n");
+    printf("size     = %zu\n", size);
+    printf("seed     = %016llx\n", (unsigned long long)seed);
+    printf("expected = %016llx\n", (unsigned long long)expected);
+    printf("result   = %016llx\n", (unsigned long long)result);
+    return false;
+}
+
+static bool test_findbytes(const char* ptr, size_t size, const uint8_t* needle, size_t needlelen, MemFindBytesFun* ref, MemFindBytesFun* fun)
+{
+    size_t expected = ref(ptr, size, needle, needlelen);
+    size_t result   = fun(ptr, size, needle, needlelen);
+
+    if (result == expected)
+    {
+        return true;
+    }
+    return test_error((int)expected, (int)result, ptr, NULL, size);
+}
+
+static bool test_mismatch(const char* ptr1, const char* ptr2, size_t size, MemMismatchFun* ref, MemMismatchFun* fun)
+{
+    size_t expected = ref(ptr1, ptr2, size);
+    size_t result   = fun(ptr1, ptr2, size);
+
+    if (result == expected)
+    {
+        return true;
+    }
+    return test_error((int)expected, (int)result, ptr1, ptr2, size);
+}
+
+static bool test_convert(char* dst, const char* src, size_t size, MemConvertFun* ref, MemConvertFun* fun)
+{
+    char expected[512];
+    assert(size <= sizeof(expected));
+
+    // calculate expected result first, because src can be same as dst
+    ref(expected, src, size);
+    fun(dst, src, size);
+
+    for (size_t i=0; i<size; i++)
+    {
+        if (dst[i] != expected[i])
+        {
+            return test_error((uint8_t)expected[i], (uint8_t)dst[i], expected, dst, size);
+        }
+    }
+    return true;
+}
+
+static bool test_translate(char* dst, const char* src, size_t size, const uint8_t* table, MemTranslateFun* ref, MemTranslateFun* fun)
+{
+    char expected[512];
+    assert(size <= sizeof(expected));
+
+    // calculate expected result first, because src can be same as dst
+    ref(expected, src, size, table);
+    fun(dst, src, size, table);
+
+    for (size_t i=0; i<size; i++)
+    {
+        if (dst[i] != expected[i])
+        {
+            return test_error((uint8_t)expected[i], (uint8_t)dst[i], expected, dst, size);
+        }
+    }
+    return true;
+}
+
+static bool run_compare(char* ptr, size_t page_size, MemCompareFun* ref, MemCompareFun* fun)
+{
+    if (!test_compare(NULL, NULL, 0, ref, fun)) return false;
+
+    // max size to test
+    const size_t size = 256;
+
+    memset(ptr + page_size, 0, 2 * page_size);
+
+    // test all sizes
+    for (size_t n=1; n<size; n++)
+    {
+        char* ptr1 = ptr + page_size;               // ptr1 is at start of page boundary (no reading before it)
+        char* ptr2 = ptr + 3 * page_size - n;       // ptr2 is at end of page boundary (no reading after it)
+        char* ptr3 = ptr + page_size + page_size/2; // ptr3 is in middle, can be written before & after
+
+        // strings are equal by default
+        for (size_t i=0; i<n; i++)
+        {
+            if (ref == &MemCompare_ref)
+            {
+                ptr1[i] = ptr2[i] = ptr3[i] = (char)(31 * i + 13);
+            }
+            else
+            {
+                ptr1[i] = ptr2[i] = (char)('A' + (i % ('Z'-'A'+1)));
+                ptr3[i] = i%2 ? ptr1[i] : (char)tolower(ptr1[i]);
+            }
+        }
+
+        for (size_t t=0; t<2; t++)
+        {
+            if (!test_compare(ptr1, ptr3, n, ref, fun)) return false;
+            if (!test_compare(ptr3, ptr1, n, ref, fun)) return false;
+
+            // will mismatch if ptr1 is read past the end
+            ptr1[n] ^= (char)0xff;
+        }
+
+        for (size_t t=0; t<2; t++)
+        {
+            if (!test_compare(ptr2, ptr3, n, ref, fun)) return false;
+            if (!test_compare(ptr3, ptr2, n, ref, fun)) return false;
+
+            // will mismatch if ptr2 is read past the beginning
+            ptr2[-1] ^= (char)0xff;
+        }
+
+        // test a difference in each position in [0,n] interval
+        for (size_t k=0; k<n; k++)
+        {
+            ptr3[k] ^= (char)0xff;
+            if (!test_compare(ptr1, ptr3, n, ref, fun)) return false;
+            if (!test_compare(ptr1, ptr3, n, ref, fun)) return false;
+            if (!test_compare(ptr3, ptr1, n, ref, fun)) return false;
+            if (!test_compare(ptr3, ptr2, n, ref, fun)) return false;
+            ptr3[k] ^= (char)0xff;
+        }
+    }
+
+    // buffers starting at every offset before end of page, with few or no bytes left until page boundary
+    char* end = ptr + 3 * page_size;
+    char* mid = ptr + page_size + page_size/2;
+    for (size_t i=1; i<=128; i++)
+    {
+        end[-(ptrdiff_t)i] = mid[-(ptrdiff_t)i] = (char)(31 * i + 13);
+    }
+    for (size_t k=1; k<=128; k++)
+    {
+        for (size_t n=1; n<=k; n++)
+        {
+            char* ptr1 = end - k;
+            char* ptr2 = mid - k;
+
+            if (!test_compare(ptr1, ptr2, n, ref, fun)) return false;
+            if (!test_compare(ptr2, ptr1, n, ref, fun)) return false;
+
+            // will mismatch if last byte is not compared
+            ptr2[n - 1] ^= (char)0xff;
+            if (!test_compare(ptr1, ptr2, n, ref, fun)) return false;
+            if (!test_compare(ptr2, ptr1, n, ref, fun)) return false;
+            ptr2[n - 1] ^= (char)0xff;
+
+            // will mismatch if ptr2 is read past the end
+            ptr2[n] ^= (char)0xff;
+            if (!test_compare(ptr1, ptr2, n, ref, fun)) return false;
+            if (!test_compare(ptr2, ptr1, n, ref, fun)) return false;
+            ptr2[n] ^= (char)0xff;
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_isequal(char* ptr, size_t page_size, MemIsEqualFun* ref, MemIsEqualFun* fun)
+{
+    if (!test_isequal(NULL, NULL, 0, ref, fun)) return false;
+
+    // max size to test
+    const size_t size = 256;
+
+    memset(ptr + page_size, 0, 2 * page_size);
+
+    // test all sizes
+    for (size_t n=1; n<size; n++)
+    {
+        char* ptr1 = ptr + page_size;               // ptr1 is at start of page boundary (no reading before it)
+        char* ptr2 = ptr + 3 * page_size - n;       // ptr2 is at end of page boundary (no reading after it)
+        char* ptr3 = ptr + page_size + page_size/2; // ptr3 is in middle, can be written before & after
+
+        // strings are equal by default
+        for (size_t i=0; i<n; i++)
+        {
+            ptr1[i] = ptr2[i] = ptr3[i] = (char)(31 * i + 13);
+        }
+
+        for (size_t t=0; t<2; t++)
+        {
+            if (!test_isequal(ptr1, ptr3, n, ref, fun)) return false;
+            if (!test_isequal(ptr3, ptr1, n, ref, fun)) return false;
+
+            // will mismatch if ptr1 is read past the end
+            ptr1[n] ^= (char)0xff;
+        }
+
+        for (size_t t=0; t<2; t++)
+        {
+            if (!test_isequal(ptr2, ptr3, n, ref, fun)) return false;
+            if (!test_isequal(ptr3, ptr2, n, ref, fun)) return false;
+
+            // will mismatch if ptr2 is read past the beginning
+            ptr2[-1] ^= (char)0xff;
+        }
+
+        // test a difference in each position in [0,n] interval
+        for (size_t k=0; k<n; k++)
+        {
+            ptr3[k] ^= (char)0xff;
+            if (!test_isequal(ptr1, ptr3, n, ref, fun)) return false;
+            if (!test_isequal(ptr1, ptr3, n, ref, fun)) return false;
+            if (!test_isequal(ptr3, ptr1, n, ref, fun)) return false;
+            if (!test_isequal(ptr3, ptr2, n, ref, fun)) return false;
+            ptr3[k] ^= (char)0xff;
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_mismatch(char* ptr, size_t page_size, MemMismatchFun* ref, MemMismatchFun* fun)
+{
+    if (!test_mismatch(NULL, NULL, 0, ref, fun)) return false;
+
+    // max size to test
+    const size_t size = 256;
+
+    memset(ptr + page_size, 0, 2 * page_size);
+
+    // test all sizes
+    for (size_t n=1; n<size; n++)
+    {
+        char* ptr1 = ptr + page_size;               // ptr1 is at start of page boundary (no reading before it)
+        char* ptr2 = ptr + 3 * page_size - n;       // ptr2 is at end of page boundary (no reading after it)
+        char* ptr3 = ptr + page_size + page_size/2; // ptr3 is in middle, can be written before & after
+
+        // strings are equal by default
+        for (size_t i=0; i<n; i++)
+        {
+            ptr1[i] = ptr2[i] = ptr3[i] = (char)(31 * i + 13);
+        }
+
+        for (size_t t=0; t<2; t++)
+        {
+            if (!test_mismatch(ptr1, ptr3, n, ref, fun)) return false;
+            if (!test_mismatch(ptr3, ptr1, n, ref, fun)) return false;
+
+            // will mismatch if ptr1 is read past the end
+            ptr1[n] ^= (char)0xff;
+        }
+
+        for (size_t t=0; t<2; t++)
+        {
+            if (!test_mismatch(ptr2, ptr3, n, ref, fun)) return false;
+            if (!test_mismatch(ptr3, ptr2, n, ref, fun)) return false;
+
+            // will mismatch if ptr2 is read past the beginning
+            ptr2[-1] ^= (char)0xff;
+        }
+
+        // test a difference in each position in [0,n] interval, with and without a later difference at the end
+        for (size_t k=0; k<n; k++)
+        {
+            ptr3[k] ^= (char)0xff;
+            if (!test_mismatch(ptr1, ptr3, n, ref, fun)) return false;
+            if (!test_mismatch(ptr3, ptr1, n, ref, fun)) return false;
+            if (!test_mismatch(ptr3, ptr2, n, ref, fun)) return false;
+            ptr3[n-1] ^= (char)0x01;
+            if (!test_mismatch(ptr1, ptr3, n, ref, fun)) return false;
+            if (!test_mismatch(ptr2, ptr3, n, ref, fun)) return false;
+            ptr3[n-1] ^= (char)0x01;
+            ptr3[k] ^= (char)0xff;
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool test_commonprefix(const char* ptr1, size_t size1, const char* ptr2, size_t size2, size_t expected)
+{
+    size_t result = MemCommonPrefix(ptr1, size1, ptr2, size2);
+
+    if (result == expected)
+    {
+        return true;
+    }
+    return test_error((int)expected, (int)result, ptr1, ptr2, size1 < size2 ? size1 : size2);
+}
+
+static bool run_commonprefix(char* ptr, size_t page_size)
+{
+    // max size to test
+    const size_t size = 64;
+
+    char* ptr1 = ptr + 3 * page_size - size;    // ptr1 is at end of page boundary (no reading after it)
+    char* ptr2 = ptr + page_size + page_size/2; // ptr2 is in middle, can be written before & after
+
+    for (size_t i=0; i<size; i++)
+    {
+        ptr1[i] = ptr2[i] = (char)(31 * i + 13);
+    }
+
+    // equal bytes, common prefix is limited by shorter buffer
+    for (size_t n1=0; n1<=size; n1++)
+    {
+        for (size_t n2=0; n2<=size; n2++)
+        {
+            if (!test_commonprefix(ptr1 + size - n1, n1, ptr2 + size - n1, n2, n1 < n2 ? n1 : n2)) return false;
+            if (!test_commonprefix(ptr2 + size - n1, n2, ptr1 + size - n1, n1, n1 < n2 ? n1 : n2)) return false;
+        }
+    }
+
+    // test a difference in each position
+    for (size_t k=0; k<size; k++)
+    {
+        ptr2[k] ^= (char)0xff;
+        if (!test_commonprefix(ptr1, size, ptr2, size, k)) return false;
+        if (!test_commonprefix(ptr1, k, ptr2, size, k)) return false;
+        if (!test_commonprefix(ptr1, size, ptr2, k + 1, k)) return false;
+        ptr2[k] ^= (char)0xff;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_convert(char* ptr, size_t page_size, MemConvertFun* ref, MemConvertFun* fun)
+{
+    if (!test_convert(NULL, NULL, 0, ref, fun)) return false;
+
+    // max size to test
+    const size_t size = 300;
+
+    // guard bytes around destination buffer in the middle
+    const size_t guard = 64;
+
+    char* src = ptr + page_size + page_size/2; // src in middle
+    for (size_t i=0; i<size; i++)
+    {
+        // all byte values, with letter boundaries at different offsets
+        src[i] = (char)(i * 7 + 3);
+    }
+
+    // test all sizes
+    for (size_t n=1; n<size; n++)
+    {
+        char* ptr1 = ptr + page_size;                 // ptr1 is at start of page boundary (no access before it)
+        char* ptr2 = ptr + 3 * page_size - n;         // ptr2 is at end of page boundary (no access after it)
+        char* ptr3 = ptr + page_size + page_size / 4; // ptr3 is in middle, can check bytes before & after
+
+        // src to buffers at page boundaries
+        if (!test_convert(ptr1, src, n, ref, fun)) return false;
+        if (!test_convert(ptr2, src, n, ref, fun)) return false;
+
+        // in-place conversion at page boundaries
+        memcpy(ptr1, src, n);
+        memcpy(ptr2, src, n);
+        if (!test_convert(ptr1, ptr1, n, ref, fun)) return false;
+        if (!test_convert(ptr2, ptr2, n, ref, fun)) return false;
+
+        // buffers at page boundaries to middle, must not write outside of destination
+        memset(ptr3 - guard, 0xcc, n + 2 * guard);
+        memcpy(ptr1, src, n);
+        memcpy(ptr2, src, n);
+        if (!test_convert(ptr3, ptr1, n, ref, fun)) return false;
+        if (!test_convert(ptr3, ptr2, n, ref, fun)) return false;
+
+        for (size_t i=0; i<guard; i++)
+        {
+            if ((uint8_t)ptr3[-1 - (ptrdiff_t)i] != 0xcc || (uint8_t)ptr3[n + i] != 0xcc)
+            {
+                return test_error(0xcc, (uint8_t)((uint8_t)ptr3[-1 - (ptrdiff_t)i] != 0xcc ? ptr3[-1 - (ptrdiff_t)i] : ptr3[n + i]), src, ptr3, n);
+            }
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_translate(char* ptr, size_t page_size, MemTranslateFun* ref, MemTranslateFun* fun)
+{
+    uint8_t tables[3][256];
+    for (size_t i=0; i<256; i++)
+    {
+        // every byte value maps to different one, bijection
+        tables[0][i] = (uint8_t)(i * 167 + 13);
+
+        // DNA complement, all other bytes stay the same
+        tables[1][i] = (uint8_t)i;
+
+        // translating twice gives different result, also for bytes with top bit set
+        tables[2][i] = (uint8_t)(i + 1);
+    }
+    tables[1]['A'] = 'T'; tables[1]['T'] = 'A'; tables[1]['C'] = 'G'; tables[1]['G'] = 'C';
+    tables[1]['a'] = 't'; tables[1]['t'] = 'a'; tables[1]['c'] = 'g'; tables[1]['g'] = 'c';
+
+    if (!test_translate(NULL, NULL, 0, tables[0], ref, fun)) return false;
+
+    // max size to test
+    const size_t size = 300;
+
+    // guard bytes around destination buffer in the middle
+    const size_t guard = 64;
+
+    char* src = ptr + page_size + page_size/2; // src in middle
+    for (size_t i=0; i<size; i++)
+    {
+        // all byte values, and DNA letters in every position
+        src[i] = (i % 3) ? "ACGT"[i % 4] : (char)(i * 7 + 3);
+    }
+
+    for (size_t t=0; t<countof(tables); t++)
+    {
+        const uint8_t* table = tables[t];
+
+        // test all sizes
+        for (size_t n=1; n<size; n++)
+        {
+            char* ptr1 = ptr + page_size;                 // ptr1 is at start of page boundary (no access before it)
+            char* ptr2 = ptr + 3 * page_size - n;         // ptr2 is at end of page boundary (no access after it)
+            char* ptr3 = ptr + page_size + page_size / 4; // ptr3 is in middle, can check bytes before & after
+
+            // src to buffers at page boundaries
+            if (!test_translate(ptr1, src, n, table, ref, fun)) return false;
+            if (!test_translate(ptr2, src, n, table, ref, fun)) return false;
+
+            // in-place translation at page boundaries
+            memcpy(ptr1, src, n);
+            memcpy(ptr2, src, n);
+            if (!test_translate(ptr1, ptr1, n, table, ref, fun)) return false;
+            if (!test_translate(ptr2, ptr2, n, table, ref, fun)) return false;
+
+            // buffers at page boundaries to middle, must not write outside of destination
+            memset(ptr3 - guard, 0xcc, n + 2 * guard);
+            memcpy(ptr1, src, n);
+            memcpy(ptr2, src, n);
+            if (!test_translate(ptr3, ptr1, n, table, ref, fun)) return false;
+            if (!test_translate(ptr3, ptr2, n, table, ref, fun)) return false;
+
+            for (size_t i=0; i<guard; i++)
+            {
+                if ((uint8_t)ptr3[-1 - (ptrdiff_t)i] != 0xcc || (uint8_t)ptr3[n + i] != 0xcc)
+                {
+                    return test_error(0xcc, (uint8_t)((uint8_t)ptr3[-1 - (ptrdiff_t)i] != 0xcc ? ptr3[-1 - (ptrdiff_t)i] : ptr3[n + i]), src, ptr3, n);
+                }
+            }
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_hash(char* ptr, size_t page_size, MemHashFun* ref, MemHashFun* fun)
+{
+    static const uint64_t seeds[] = { 0, 0x0123456789abcdef, ~0ULL };
+
+    for (size_t s=0; s<countof(seeds); s++)
+    {
+        if (!test_hash(NULL, 0, seeds[s], ref, fun)) return false;
+    }
+
+    // random bytes in both pages
+    uint32_t state = 1;
+    for (size_t i=0; i<2*page_size; i++)
+    {
+        state = state * 1664525 + 1013904223;
+        ptr[page_size + i] = (char)(state >> 24);
+    }
+
+    // max size to test, more than 4 blocks of 1024 bytes
+    const size_t size = 4200;
+
+    for (size_t n=1; n<size; n += (n < 1100 ? 1 : 61))
+    {
+        char* ptr1 = ptr + page_size;         // ptr1 is at start of page boundary (no access before it)
+        char* ptr2 = ptr + 3 * page_size - n; // ptr2 is at end of page boundary (no access after it)
+
+        for (size_t s=0; s<countof(seeds); s++)
+        {
+            if (!test_hash(ptr1, n, seeds[s], ref, fun)) return false;
+            if (!test_hash(ptr2, n, seeds[s], ref, fun)) return false;
+        }
+    }
+
+    // small sizes close to end of page, but with more bytes after them
+    for (size_t n=1; n<=16; n++)
+    {
+        for (size_t i=0; i<32; i++)
+        {
+            if (!test_hash(ptr + 2 * page_size - i, n, 0, ref, fun)) return false;
+        }
+    }
+
+    // small sizes starting at every offset before end of page, with few or no bytes left until page boundary
+    for (size_t k=1; k<=32; k++)
+    {
+        for (size_t n=0; n<=k && n<=16; n++)
+        {
+            if (!test_hash(ptr + 3 * page_size - k, n, 0, ref, fun)) return false;
+        }
+    }
+
+    // zero bytes must not give same hash for different sizes
+    memset(ptr + page_size, 0, 2 * page_size);
+
+    static uint64_t hashes[1100];
+    for (size_t n=0; n<countof(hashes); n++)
+    {
+        hashes[n] = fun(ptr + page_size, n, 0);
+        for (size_t k=0; k<n; k++)
+        {
+            if (hashes[k] == hashes[n])
+            {
+                printf("ERROR\n");
+                printf("same hash for %zu and %zu zero bytes\n", k, n);
+                return false;
+            }
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+// fills "pairs" array with pairs of buffers from two pages, returns count of pairs
+// second page has same bytes as first page, except every 97th byte is smaller or larger
+static size_t make_pairs(char* ptr, size_t page_size, MemPair* pairs, size_t max_count)
+{
+    char* page1 = ptr + page_size;
+    char* page2 = ptr + 2 * page_size;
+
+    uint32_t state = 1;
+    for (size_t i=0; i<page_size; i++)
+    {
+        state = state * 1664525 + 1013904223;
+        page1[i] = (char)(state >> 24);
+        page2[i] = (i % 97 == 96) ? (char)(page1[i] + ((i & 1) ? 1 : -1)) : page1[i];
+    }
+
+    size_t count = 0;
+
+    // empty buffers can be NULL
+    pairs[count].ptr1 = NULL;
+    pairs[count].ptr2 = NULL;
+    pairs[count].size = 0;
+    count++;
+
+    for (size_t n=0; n<200; n++)
+    {
+        // first pointer at start of first page, or second pointer at end of second page, and some offsets in middle
+        size_t offsets[] = { 0, 1, 15, 16, 31, 32, 63, 90, page_size - n - 3, page_size - n - 1, page_size - n };
+        for (size_t k=0; k<countof(offsets); k++)
+        {
+            assert(count < max_count);
+            pairs[count].ptr1 = page1 + offsets[k];
+            pairs[count].ptr2 = page2 + offsets[k];
+            pairs[count].size = n;
+            count++;
+        }
+
+        // different offsets in both pages
+        assert(count < max_count);
+        pairs[count].ptr1 = page1 + n;
+        pairs[count].ptr2 = page2 + page_size - n;
+        pairs[count].size = n;
+        count++;
+    }
+
+    return count;
+}
+
+static bool run_isequalbatch(char* ptr, size_t page_size, MemIsEqualFun* ref, MemBatchEqFun* fun)
+{
+    static MemPair pairs[4096];
+    static uint8_t results[4096 + 1];
+
+    size_t count = make_pairs(ptr, page_size, pairs, countof(pairs));
+
+    // call with 0..32 pairs, and then with all of them, result after last pair must not be written
+    for (size_t n=0; n<=count; n = (n < 32 || n == count) ? n + 1 : count)
+    {
+        memset(results, 0xcc, sizeof(results));
+        fun(pairs, n, results);
+
+        for (size_t i=0; i<n; i++)
+        {
+            uint8_t expected = ref(pairs[i].ptr1, pairs[i].ptr2, pairs[i].size);
+            if (results[i] != expected)
+            {
+                return test_error(expected, results[i], (const char*)pairs[i].ptr1, (const char*)pairs[i].ptr2, pairs[i].size);
+            }
+        }
+        if (results[n] != 0xcc)
+        {
+            return test_error(0xcc, results[n], NULL, NULL, 0);
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_comparebatch(char* ptr, size_t page_size, MemCompareFun* ref, MemBatchCmpFun* fun)
+{
+    static MemPair pairs[4096];
+    static int results[4096 + 1];
+
+    size_t count = make_pairs(ptr, page_size, pairs, countof(pairs));
+
+    for (size_t n=0; n<=count; n = (n < 32 || n == count) ? n + 1 : count)
+    {
+        for (size_t i=0; i<countof(results); i++)
+        {
+            results[i] = 0x1234;
+        }
+        fun(pairs, n, results);
+
+        for (size_t i=0; i<n; i++)
+        {
+            int expected = ref(pairs[i].ptr1, pairs[i].ptr2, pairs[i].size);
+            if ((results[i] < 0) != (expected < 0) || (results[i] > 0) != (expected > 0))
+            {
+                return test_error(expected, results[i], (const char*)pairs[i].ptr1, (const char*)pairs[i].ptr2, pairs[i].size);
+            }
+        }
+        if (results[n] != 0x1234)
+        {
+            return test_error(0x1234, results[n], NULL, NULL, 0);
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_isequalconsttime(char* ptr, size_t page_size, MemIsEqualFun* ref, MemIsEqualFun* fun)
+{
+    if (!test_isequal(NULL, NULL, 0, ref, fun)) return false;
+
+    // max size to test, covers multiple iterations of unrolled loops with every tail size after them
+    const size_t size = 1100;
+
+    memset(ptr + page_size, 0, 2 * page_size);
+
+    for (size_t n=1; n<size; n++)
+    {
+        char* ptr1 = ptr + page_size;                   // ptr1 is at start of page boundary (no reading before it)
+        char* ptr2 = ptr + 3 * page_size - n;           // ptr2 is at end of page boundary (no reading after it)
+        char* ptr3 = ptr + page_size + size + n % 64;   // ptr3 is in middle with different alignments
+
+        for (size_t i=0; i<n; i++)
+        {
+            ptr1[i] = ptr2[i] = ptr3[i] = (char)(31 * i + 13);
+        }
+
+        if (!test_isequal(ptr1, ptr2, n, ref, fun)) return false;
+        if (!test_isequal(ptr2, ptr3, n, ref, fun)) return false;
+
+        // test a difference in each position near beginning and end, and in some positions in the middle
+        for (size_t k=0; k<n; k += (k < 64 || k + 64 >= n) ? 1 : 61)
+        {
+            ptr3[k] ^= (char)(1 << (k % 8));
+            if (!test_isequal(ptr1, ptr3, n, ref, fun)) return false;
+            if (!test_isequal(ptr3, ptr2, n, ref, fun)) return false;
+            ptr3[k] ^= (char)(1 << (k % 8));
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+// splits "size" bytes into random segments, mostly short ones and sometimes empty, returns count of segments
+static size_t make_segments(char* data, size_t size, MemSegment* segments, size_t max_count, size_t max_size, uint32_t* state)
+{
+    size_t count = 0;
+    for (size_t offset=0; offset<size; )
+    {
+        *state = *state * 1664525 + 1013904223;
+        size_t n = (*state >> 8) % (max_size + 1);
+        n = count + 1 == max_count || n > size - offset ? size - offset : n;
+
+        segments[count].iov_base = data + offset;
+        segments[count].iov_len = n;
+        count++;
+        offset += n;
+    }
+    return count;
+}
+
+static bool run_findv(char* ptr, size_t page_size, MemFindFun* ref, MemFindVFun* fun)
+{
+    static MemSegment segments[1024];
+
+    // max total size of segments
+    const size_t size = 1024;
+
+    uint32_t state = 1;
+    for (size_t iter=0; iter<4096; iter++)
+    {
+        // segments are at start or end of page boundary
+        size_t total = iter % 2 ? size : size - (iter / 2) % 64;
+        char* data = iter % 4 < 2 ? ptr + page_size : ptr + 3 * page_size - total;
+
+        for (size_t i=0; i<total; i++)
+        {
+            data[i] = (char)(i % 255 + 1);
+        }
+
+        // zero, one or few matching bytes
+        for (size_t i=0; i<iter % 3; i++)
+        {
+            state = state * 1664525 + 1013904223;
+            data[(state >> 8) % total] = 0;
+        }
+
+        size_t count = make_segments(data, total, segments, countof(segments), iter % 8 == 0 ? 200 : 1 + iter % 32, &state);
+
+        // reverse order of segments in some iterations, so they are not contiguous in memory
+        if (iter % 5 == 0)
+        {
+            for (size_t i=0; i<count/2; i++)
+            {
+                MemSegment temp = segments[i];
+                segments[i] = segments[count - 1 - i];
+                segments[count - 1 - i] = temp;
+            }
+        }
+
+        MemPosition expected;
+        expected.segment = count;
+        expected.offset = 0;
+        for (size_t i=0; i<count; i++)
+        {
+            size_t index = ref(segments[i].iov_base, segments[i].iov_len, 0);
+            if (index != segments[i].iov_len)
+            {
+                expected.segment = i;
+                expected.offset = index;
+                break;
+            }
+        }
+
+        MemPosition result = fun(segments, count, 0);
+        if (result.segment != expected.segment || result.offset != expected.offset)
+        {
+            printf("ERROR\n");
+            printf("count    = %zu\n", count);
+            printf("expected = %zu, %zu\n", expected.segment, expected.offset);
+            printf("result   = %zu, %zu\n", result.segment, result.offset);
+            return false;
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_isequalv(char* ptr, size_t page_size, MemIsEqualFun* ref, MemIsEqualVFun* fun)
+{
+    static MemSegment segments1[1024];
+    static MemSegment segments2[1024];
+
+    // max total size of segments
+    const size_t size = 1024;
+
+    if (fun(NULL, 0, NULL, 0) != true)
+    {
+        printf("ERROR\n");
+        printf("empty segments are not equal\n");
+        return false;
+    }
+
+    uint32_t state = 1;
+    for (size_t iter=0; iter<4096; iter++)
+    {
+        size_t total1 = size - (iter / 2) % 64;
+        size_t total2 = total1;
+
+        // different total size in some iterations
+        if (iter % 7 == 0)
+        {
+            total2 -= (iter / 7) % 2 ? 1 : 0;
+            total1 -= (iter / 7) % 2 ? 0 : 1;
+        }
+
+        // one buffer is at start of page boundary, and other one at end of page boundary
+        char* data1 = ptr + page_size;
+        char* data2 = ptr + 3 * page_size - total2;
+
+        for (size_t i=0; i<size; i++)
+        {
+            state = state * 1664525 + 1013904223;
+            data1[i] = (char)(state >> 24);
+        }
+        for (size_t i=0; i<total2; i++)
+        {
+            data2[i] = data1[i];
+        }
+
+        // one different byte in some iterations
+        if (iter % 3 == 0)
+        {
+            state = state * 1664525 + 1013904223;
+            data2[(state >> 8) % total2] ^= (char)(1 << (iter % 8));
+        }
+
+        size_t count1 = make_segments(data1, total1, segments1, countof(segments1), iter % 8 == 0 ? 200 : 1 + iter % 32, &state);
+        size_t count2 = make_segments(data2, total2, segments2, countof(segments2), iter % 4 == 0 ? 200 : 1 + iter % 17, &state);
+
+        bool expected = total1 == total2 && ref(data1, data2, total1);
+        bool result = fun(segments1, count1, segments2, count2);
+        if (result != expected)
+        {
+            printf("ERROR\n");
+            printf("count1   = %zu\n", count1);
+            printf("count2   = %zu\n", count2);
+            printf("expected = %d\n", expected);
+            printf("result   = %d\n", result);
+            return false;
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_search(void)
+{
+    static uint8_t data[32768];
+    static size_t expected[countof(data)];
+    static size_t result[countof(data)];
+
+    static const size_t lengths[] = { 1, 2, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 63, MEM_SEARCH_MAX_NEEDLE };
+
+    uint32_t state = 1;
+    for (size_t l=0; l<countof(lengths); l++)
+    {
+        size_t needlelen = lengths[l];
+
+        // two letter alphabet makes many partial matches
+        // array is larger than max needle only to silence gcc false positive array-bounds warning for inlined avx512 code
+        uint8_t needle[2 * MEM_SEARCH_MAX_NEEDLE];
+        for (size_t i=0; i<needlelen; i++)
+        {
+            state = state * 1664525 + 1013904223;
+            needle[i] = (uint8_t)('a' + (state >> 31));
+        }
+        for (size_t i=0; i<countof(data); i++)
+        {
+            state = state * 1664525 + 1013904223;
+            data[i] = (uint8_t)('a' + (state >> 31));
+        }
+
+        // place needle at random places, sometimes overlapping with previous one
+        for (size_t i=0; i<countof(data)/256; i++)
+        {
+            state = state * 1664525 + 1013904223;
+            size_t offset = (state >> 8) % (countof(data) - needlelen);
+            memcpy(data + offset, needle, needlelen);
+        }
+
+        // non-overlapping matches in whole buffer
+        size_t expected_count = 0;
+        for (size_t offset=0; ; )
+        {
+            size_t index = MemFindBytes_ref(data + offset, countof(data) - offset, needle, needlelen);
+            if (index == countof(data) - offset) break;
+            expected[expected_count++] = offset + index;
+            offset += index + needlelen;
+        }
+
+        // same buffer split in chunks, mostly shorter than needle, and sometimes empty or longer
+        for (size_t t=0; t<4; t++)
+        {
+            MemSearchState search;
+            MemSearchInit(&search, needle, needlelen);
+
+            size_t result_count = 0;
+            for (size_t offset=0; offset<countof(data); )
+            {
+                state = state * 1664525 + 1013904223;
+                size_t size = (state >> 8) % (t == 3 ? 4096 : needlelen * (t + 1) + 1);
+                size = size < countof(data) - offset ? size : countof(data) - offset;
+
+                const uint8_t* ptr = data + offset;
+                offset += size;
+
+                for (;;)
+                {
+                    size_t end = MemSearchNext(&search, ptr, size);
+                    if (end == 0) break;
+
+                    result[result_count++] = (size_t)search.offset - needlelen;
+                    ptr += end;
+                    size -= end;
+                }
+            }
+
+            bool ok = search.offset <= countof(data) && result_count == expected_count;
+            for (size_t i=0; ok && i<result_count; i++)
+            {
+                ok = result[i] == expected[i];
+            }
+
+            if (!ok)
+            {
+                printf("ERROR\n");
+                printf("needlelen = %zu\n", needlelen);
+                printf("expected  = %zu matches\n", expected_count);
+                printf("result    = %zu matches\n", result_count);
+                for (size_t i=0; i<expected_count || i<result_count; i++)
+                {
+                    if (i >= expected_count || i >= result_count || result[i] != expected[i])
+                    {
+                        printf("first different match %zu: expected at %zu, result at %zu\n", i,
+                            i < expected_count ? expected[i] : countof(data), i < result_count ? result[i] : countof(data));
+                        break;
+                    }
+                }
+                return false;
+            }
+        }
+    }
+
+    // needle lengths out of range never match, and must not overflow tail of state
+    static const size_t invalid[] = { 0, MEM_SEARCH_MAX_NEEDLE + 1 };
+    for (size_t l=0; l<countof(invalid); l++)
+    {
+        MemSearchState search;
+        MemSearchInit(&search, data, invalid[l]);
+
+        for (size_t offset=0; offset<countof(data); offset+=1000)
+        {
+            size_t size = countof(data) - offset < 1000 ? countof(data) - offset : 1000;
+            size_t end = MemSearchNext(&search, data + offset, size);
+            if (end != 0 || search.offset != offset + size)
+            {
+                printf("ERROR\n");
+                printf("needlelen = %zu\n", invalid[l]);
+                printf("expected  = no match\n");
+                printf("result    = match at %zu\n", (size_t)search.offset - invalid[l]);
+                return false;
+            }
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+#if defined(MEM_PARALLEL)
+static bool run_parallel(MemFindFun* ref, MemParallelFun* fun)
+{
+    // multiple chunks per thread, with partial chunks at both ends
+    const size_t size = 12 * MEM_PARALLEL_CHUNK + 123;
+
+    uint8_t* buffer = (uint8_t*)malloc(size + 64);
+    if (!buffer)
+    {
+        printf("ERROR\n");
+        return false;
+    }
+
+    static const size_t threads[] = { 0, 1, 2, 3, 8, 100 };
+
+    bool ok = true;
+    for (size_t align=0; align<64 && ok; align+=17)
+    {
+        uint8_t* ptr = buffer + align;
+
+        // sizes for single chunk, few chunks and all of them
+        const size_t sizes[] = { 0, 1, 1000, MEM_PARALLEL_CHUNK - 1, 2 * MEM_PARALLEL_CHUNK + 5, 5 * MEM_PARALLEL_CHUNK, size };
+
+        // matches around chunk boundaries, first and last byte, and no match at all
+        size_t positions[] = { 0, 63, 64, MEM_PARALLEL_CHUNK - 64, MEM_PARALLEL_CHUNK, 3 * MEM_PARALLEL_CHUNK + 1, 7 * MEM_PARALLEL_CHUNK - 1, size - 1, size };
+
+        for (size_t p=0; p<countof(positions) && ok; p++)
+        {
+            memset(ptr, 0, size);
+
+            // one more match later to verify that first one is returned, and every other one is counted
+            for (size_t k=positions[p]; k<size; k+=4 * MEM_PARALLEL_CHUNK + 7)
+            {
+                ptr[k] = 1;
+            }
+
+            for (size_t s=0; s<countof(sizes) && ok; s++)
+            {
+                size_t expected = ref(ptr, sizes[s], 1);
+
+                for (size_t t=0; t<countof(threads) && ok; t++)
+                {
+                    size_t result = fun(ptr, sizes[s], 1, threads[t]);
+                    if (result != expected)
+                    {
+                        printf("ERROR\n");
+                        printf("size     = %zu\n", sizes[s]);
+                        printf("threads  = %zu\n", threads[t]);
+                        printf("align    = %zu\n", align);
+                        printf("expected = %zu\n", expected);
+                        printf("result   = %zu\n", result);
+                        ok = false;
+                    }
+                }
+            }
+        }
+    }
+
+    free(buffer);
+
+    if (ok)
+    {
+        printf("OK\n");
+    }
+    return ok;
+}
+#endif
+
+static bool run_preferred_isa(void)
+{
+    // ordered from older to newer for each architecture
+    static const int isas[] = { MEM_ISA_SSE2, MEM_ISA_AVX2, MEM_ISA_AVX10, MEM_ISA_AVX512, MEM_ISA_NEON, MEM_ISA_SVE, MEM_ISA_RVV };
+
+#if MEM_ARCH_X64 && defined(MEM_DISPATCH_IFUNC)
+    // functions are resolved at load time
+    bool changeable = false;
+#elif MEM_ARCH_X64 || MEM_ARCH_SVE
+    // functions are resolved at compile time when building with -mavx2, -march=armv8-a+sve or similar
+    bool changeable = MemCPUIDCompiled() == 0;
+#else
+    bool changeable = true;
+#endif
+
+    int features = MemGetFeatures();
+    int initial = MemGetISA();
+
+    int best = 0;
+    for (size_t i=0; i<countof(isas); i++)
+    {
+        best = (features & isas[i]) ? isas[i] : best;
+    }
+
+    // buffers are larger than vector size, so compiler does not warn about loads past string literal
+    char abc[64] = "abc";
+    char abd[64] = "abd";
+
+    bool ok = true;
+
+#if MEM_ARCH_X64
+    // with MEMFUN_ISA=avx512bw functions that need AVX512VBMI must use avx2 implementation, other ones avx512
+    // check it before preference is changed below, as it can be set only with environment variable
+    if (MemGetEnvISA() == MEM_ISA_AVX512BW && (MemCPUID() & MEM_CPUID_AVX512) && !(MemCPUIDCompiled() & MEM_CPUID_AVX512VBMI))
+    {
+#  if defined(MEM_DISPATCH_IFUNC)
+        bool avx2 = MemFindAny_resolve() == &MemFindAny_avx2 && MemClassify_resolve() == &MemClassify_avx2 && MemTranslate_resolve() == &MemTranslate_avx2;
+        bool avx512 = MemCompare_resolve() == &MemCompare_avx512;
+#  elif defined(MEM_DISPATCH_TABLE)
+        bool avx2 = MemDispatch.MemFindAny == &MemFindAny_avx2 && MemDispatch.MemClassify == &MemClassify_avx2 && MemDispatch.MemTranslate == &MemTranslate_avx2;
+        bool avx512 = MemDispatch.MemCompare == &MemCompare_avx512;
+#  else
+        bool avx2 = (MemCPUID() & MEM_CPUID_AVX512VBMI) == 0;
+        bool avx512 = initial == MEM_ISA_AVX512;
+#  endif
+        if (!avx2 || !avx512)
+        {
+            printf("ERROR\n");
+            printf("MEMFUN_ISA=avx512bw does not select %s implementation\n", avx2 ? "avx512" : "avx2");
+            ok = false;
+        }
+    }
+#endif
+    if (initial != 0 && (features & initial) == 0)
+    {
+        printf("ERROR\n");
+        printf("features = 0x%x\n", features);
+        printf("isa      = 0x%x\n", initial);
+        ok = false;
+    }
+
+    for (size_t i=0; i<countof(isas) && ok; i++)
+    {
+        bool expected = changeable ? (features & isas[i]) != 0 : isas[i] == initial;
+        bool result = MemSetPreferredISA(isas[i]);
+        int current = MemGetISA();
+
+        if (result != expected || current != (result ? isas[i] : initial) || MemCompare(abc, abd, 3) >= 0)
+        {
+            printf("ERROR\n");
+            printf("features = 0x%x\n", features);
+            printf("isa      = 0x%x\n", isas[i]);
+            printf("expected = %s\n", expected ? "true" : "false");
+            printf("result   = %s\n", result ? "true" : "false");
+            printf("current  = 0x%x\n", current);
+            ok = false;
+        }
+
+#if MEM_ARCH_X64 && defined(MEM_DISPATCH_TABLE)
+        // table must be filled again after changing preference
+        if (ok && result && MemDispatch.MemCompare != (isas[i] == MEM_ISA_AVX512 ? &MemCompare_avx512 : isas[i] == MEM_ISA_AVX10 ? &MemCompare_avx10 : isas[i] == MEM_ISA_AVX2 ? &MemCompare_avx2 : &MemCompare_sse2))
+        {
+            printf("ERROR\n");
+            printf("isa      = 0x%x\n", isas[i]);
+            printf("dispatch table was not updated\n");
+            ok = false;
+        }
+
+        // functions without avx10 implementation use avx2 one
+        if (ok && result && isas[i] == MEM_ISA_AVX10 && MemDispatch.MemCompareI != &MemCompareI_avx2)
+        {
+            printf("ERROR\n");
+            printf("MemCompareI does not use avx2 implementation\n");
+            ok = false;
+        }
+#endif
+
+        // restore initial selection, it can come from environment variable
+        if (result && changeable)
+        {
+            MemSetPreferredISA(initial);
+        }
+    }
+
+    // invalid values are rejected
+    if (ok && (MemSetPreferredISA(MEM_ISA_SSE2 | MEM_ISA_AVX2) || MemSetPreferredISA(-1)))
+    {
+        printf("ERROR\n");
+        printf("invalid isa accepted\n");
+        ok = false;
+    }
+
+    // automatic selection uses newest supported instruction set
+    if (ok && changeable && (!MemSetPreferredISA(0) || MemGetISA() != best))
+    {
+        printf("ERROR\n");
+        printf("features = 0x%x\n", features);
+        printf("expected = 0x%x\n", best);
+        printf("current  = 0x%x\n", MemGetISA());
+        ok = false;
+    }
+
+    if (ok)
+    {
+        printf("OK\n");
+    }
+    return ok;
+}
+
+static bool run_find(char* ptr, size_t page_size, MemFindFun* ref, MemFindFun* fun)
+{
+    if (!test_find(NULL, 0, 0xff, ref, fun)) return false;
+
+    // max size to test
+    const size_t size = 256;
+
+    uint8_t initial = (ref == &MemFind_ref || ref == &MemFindLast_ref) ? 0x00 : 0xff;
+
+    memset(ptr + page_size, initial, 2 * page_size);
+
+    // test when page boundary can be crossed, and difference is on next page
+    for (size_t i=2; i<32; i++)
+    {
+        ptr[2*page_size] ^= (char)0xff;
+        if (!test_find(ptr + 2*page_size - 1, i, 0xff, ref, fun)) return false;
+        ptr[2*page_size] ^= (char)0xff;
+    }
+
+    // test all sizes
+    for (size_t n=1; n<size; n++)
+    {
+        char* ptr1 = ptr + page_size;               // ptr1 is at start of page boundary (no reading before it)
+        char* ptr2 = ptr + 3 * page_size - n;       // ptr2 is at end of page boundary (no reading after it)
+        char* ptr3 = ptr + page_size + page_size/2; // ptr3 is in middle, can be written before & after
+
+        for (size_t t=0; t<2; t++)
+        {
+            if (!test_find(ptr1, n, 0xff, ref, fun)) return false;
+            if (!test_find(ptr2, n, 0xff, ref, fun)) return false;
+
+            // will mismatch if ptr1 is read past the end
+            ptr1[n] ^= (char)0xff;
+
+            // will mismatch if ptr2 is read past the beginning
+            ptr2[-1] ^= (char)0xff;
+        }
+
+        // test a difference in each position in [0,n] interval
+        for (size_t k=0; k<n; k++)
+        {
+            ptr1[k] ^= (char)0xff;
+            ptr2[k] ^= (char)0xff;
+            ptr3[k] ^= (char)0xff;
+            if (!test_find(ptr1, n, 0xff, ref, fun)) return false;
+            if (!test_find(ptr2, n, 0xff, ref, fun)) return false;
+            if (!test_find(ptr3, n, 0xff, ref, fun)) return false;
+            ptr1[k] ^= (char)0xff;
+            ptr2[k] ^= (char)0xff;
+            ptr3[k] ^= (char)0xff;
+        }
+
+        // test two differences, at k/2 and k positions, and differences only in lowest bit
+        for (size_t k=0; k<n; k++)
+        {
+            ptr1[k/2] ^= (char)0xff;
+            ptr2[k/2] ^= (char)0xff;
+            ptr3[k/2] ^= (char)0xff;
+            ptr1[k] ^= (char)0xff;
+            ptr2[k] ^= (char)0xff;
+            ptr3[k] ^= (char)0xff;
+            if (!test_find(ptr1, n, 0xff, ref, fun)) return false;
+            if (!test_find(ptr2, n, 0xff, ref, fun)) return false;
+            if (!test_find(ptr3, n, 0xff, ref, fun)) return false;
+            ptr1[k/2] ^= (char)0xfe;
+            ptr2[k/2] ^= (char)0xfe;
+            ptr3[k/2] ^= (char)0xfe;
+            ptr1[k] ^= (char)0xfe;
+            ptr2[k] ^= (char)0xfe;
+            ptr3[k] ^= (char)0xfe;
+            if (!test_find(ptr1, n, 0xff, ref, fun)) return false;
+            if (!test_find(ptr2, n, 0xff, ref, fun)) return false;
+            if (!test_find(ptr3, n, 0xff, ref, fun)) return false;
+            ptr1[k/2] ^= (char)0x01;
+            ptr2[k/2] ^= (char)0x01;
+            ptr3[k/2] ^= (char)0x01;
+            ptr1[k] ^= (char)0x01;
+            ptr2[k] ^= (char)0x01;
+            ptr3[k] ^= (char)0x01;
+        }
+    }
+
+    // buffers starting at every offset before end of page, with few or no bytes left until page boundary
+    char* end = ptr + 3 * page_size;
+    for (size_t k=1; k<=128; k++)
+    {
+        for (size_t n=0; n<=k; n++)
+        {
+            char* ptr1 = end - k;
+
+            if (!test_find(ptr1, n, 0xff, ref, fun)) return false;
+
+            // will mismatch if first or last byte is not checked
+            for (size_t i=0; i<n; i+=(n > 1 ? n - 1 : 1))
+            {
+                ptr1[i] ^= (char)0xff;
+                if (!test_find(ptr1, n, 0xff, ref, fun)) return false;
+                ptr1[i] ^= (char)0xff;
+            }
+
+            // will mismatch if ptr1 is read past the end
+            if (n < k)
+            {
+                ptr1[n] ^= (char)0xff;
+                if (!test_find(ptr1, n, 0xff, ref, fun)) return false;
+                ptr1[n] ^= (char)0xff;
+            }
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_count(char* ptr, size_t page_size, MemFindFun* ref, MemFindFun* fun)
+{
+    if (!test_find(NULL, 0, 0xff, ref, fun)) return false;
+
+    // max size to test
+    const size_t size = 256;
+
+    // all bytes matching, for overflow of any internal counters
+    memset(ptr + page_size, 0xff, 2 * page_size);
+    for (size_t n=2*page_size-300; n<=2*page_size; n++)
+    {
+        if (!test_find(ptr + page_size, n, 0xff, ref, fun)) return false;
+        if (!test_find(ptr + 3 * page_size - n, n, 0xff, ref, fun)) return false;
+    }
+
+    // random mix of matching and non-matching bytes, including ones different only in lowest bit
+    uint32_t seed = 1;
+    for (size_t i=0; i<2*page_size; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        ptr[page_size + i] = (char)(0xfc | ((seed >> 16) & 3));
+    }
+
+    // test all sizes
+    for (size_t n=1; n<size; n++)
+    {
         char* ptr1 = ptr + page_size;               // ptr1 is at start of page boundary (no reading before it)
         char* ptr2 = ptr + 3 * page_size - n;       // ptr2 is at end of page boundary (no reading after it)
         char* ptr3 = ptr + page_size + page_size/2; // ptr3 is in middle, can be written before & after
 
-        for (size_t t=0; t<2; t++)
+        for (size_t t=0; t<2; t++)
+        {
+            for (size_t i=0; i<n; i++)
+            {
+                if (!test_find(ptr1 + i, n - i, 0xff, ref, fun)) return false;
+                if (!test_find(ptr2 + i, n - i, 0xff, ref, fun)) return false;
+                if (!test_find(ptr3 + i, n - i, 0xff, ref, fun)) return false;
+            }
+
+            // will mismatch if ptr1 is read past the end
+            ptr1[n] ^= 0x01;
+
+            // will mismatch if ptr2 is read past the beginning
+            ptr2[-1] ^= 0x01;
+        }
+    }
+
+    // large sizes
+    for (size_t n=size; n<=2*page_size; n+=n/4)
+    {
+        if (!test_find(ptr + page_size, n, 0xff, ref, fun)) return false;
+        if (!test_find(ptr + 3 * page_size - n, n, 0xff, ref, fun)) return false;
+        if (!test_find(ptr + page_size + 1, n - 1, 0xfe, ref, fun)) return false;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_findany(char* ptr, size_t page_size, MemFindAnyFun* ref, MemFindAnyFun* fun)
+{
+    static const uint8_t set_any[] =
+    {
+        '\r', '\n', ':', '"', '\\', 0x00, 0x01, 0x1f, 0x7f, 0x80, 0x81, 0xfe, 0xff,
+        0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70, 0x90, 0xa0, 0xb0, 0xc0, 0xd0, 0xe0, 0xf0,
+    };
+
+    // set sizes to test, first 2 and 3 bytes use different code path than larger sets
+    static const size_t set_sizes[] = { 2, 3, 4, 5, 13, countof(set_any) };
+
+    if (!test_findany(NULL, 0, set_any, 0, ref, fun)) return false;
+    if (!test_findany(NULL, 0, set_any, 2, ref, fun)) return false;
+    if (!test_findany(NULL, 0, set_any, countof(set_any), ref, fun)) return false;
+
+    // max size to test
+    const size_t size = 256;
+
+    for (size_t s=0; s<countof(set_sizes); s++)
+    {
+        size_t setlen = set_sizes[s];
+
+        // all byte values not in set, used to fill buffers
+        uint8_t other[256];
+        size_t other_count = 0;
+        for (size_t v=0; v<256; v++)
+        {
+            uint8_t value = (uint8_t)v;
+            if (ref(&value, 1, set_any, setlen) != 0)
+            {
+                other[other_count++] = (uint8_t)v;
+            }
+        }
+
+        for (size_t i=0; i<2*page_size; i++)
+        {
+            ptr[page_size + i] = (char)other[(i * 7) % other_count];
+        }
+
+        // test all sizes
+        for (size_t n=1; n<size; n++)
+        {
+            char* ptr1 = ptr + page_size;               // ptr1 is at start of page boundary (no reading before it)
+            char* ptr2 = ptr + 3 * page_size - n;       // ptr2 is at end of page boundary (no reading after it)
+            char* ptr3 = ptr + page_size + page_size/2; // ptr3 is in middle, can be written before & after
+
+            for (size_t t=0; t<2; t++)
+            {
+                if (!test_findany(ptr1, n, set_any, setlen, ref, fun)) return false;
+                if (!test_findany(ptr2, n, set_any, setlen, ref, fun)) return false;
+                if (!test_findany(ptr3, n, set_any, setlen, ref, fun)) return false;
+
+                // will mismatch if ptr1 or ptr3 is read past the end
+                char saved1 = ptr1[n];
+                char saved3 = ptr3[n];
+                ptr1[n] = (char)set_any[t];
+                ptr3[n] = (char)set_any[t];
+                if (!test_findany(ptr1, n, set_any, setlen, ref, fun)) return false;
+                if (!test_findany(ptr3, n, set_any, setlen, ref, fun)) return false;
+                ptr1[n] = saved1;
+                ptr3[n] = saved3;
+            }
+
+            // test set byte in every position in [0,n) interval, cycling through all bytes of set
+            for (size_t k=0; k<n; k++)
+            {
+                char saved1 = ptr1[k];
+                char saved2 = ptr2[k];
+                char saved3 = ptr3[k];
+                ptr1[k] = ptr2[k] = ptr3[k] = (char)set_any[(n + k) % setlen];
+                if (!test_findany(ptr1, n, set_any, setlen, ref, fun)) return false;
+                if (!test_findany(ptr2, n, set_any, setlen, ref, fun)) return false;
+                if (!test_findany(ptr3, n, set_any, setlen, ref, fun)) return false;
+                ptr1[k] = saved1;
+                ptr2[k] = saved2;
+                ptr3[k] = saved3;
+            }
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_findi(char* ptr, size_t page_size, MemFindFun* ref, MemFindFun* fun)
+{
+    if (!test_find(NULL, 0, 'a', ref, fun)) return false;
+
+    // max size to test
+    const size_t size = 256;
+
+    // letters in both cases, and non-letters that differ from letters or each other only in 0x20 bit
+    static const uint8_t values[] = { 'a', 'Z', '@', '`', '[', '{', 0xc1, 0xe1 };
+
+    uint32_t seed = 1;
+    for (size_t v=0; v<countof(values); v++)
+    {
+        uint8_t value = values[v];
+
+        // random bytes that do not match input value
+        for (size_t i=0; i<2*page_size; i++)
+        {
+            uint8_t x;
+            do
+            {
+                seed = seed * 1103515245 + 12345;
+                x = (uint8_t)(seed >> 16);
+            }
+            while (tolower(x) == tolower(value));
+            ptr[page_size + i] = (char)x;
+        }
+
+        // matching byte in both cases, for letters
+        uint8_t other = (uint8_t)(isalpha(value) ? value ^ 0x20 : value);
+
+        // test all sizes
+        for (size_t n=1; n<size; n++)
+        {
+            char* ptr1 = ptr + page_size;               // ptr1 is at start of page boundary (no reading before it)
+            char* ptr2 = ptr + 3 * page_size - n;       // ptr2 is at end of page boundary (no reading after it)
+            char* ptr3 = ptr + page_size + page_size/2; // ptr3 is in middle, can be written before & after
+
+            if (!test_find(ptr1, n, value, ref, fun)) return false;
+            if (!test_find(ptr2, n, value, ref, fun)) return false;
+            if (!test_find(ptr3, n, value, ref, fun)) return false;
+
+            // test matching byte in each position in [0,n) interval
+            for (size_t k=0; k<n; k++)
+            {
+                char saved1 = ptr1[k];
+                char saved2 = ptr2[k];
+                char saved3 = ptr3[k];
+                ptr1[k] = ptr2[k] = ptr3[k] = (char)(k & 1 ? other : value);
+                if (!test_find(ptr1, n, value, ref, fun)) return false;
+                if (!test_find(ptr2, n, value, ref, fun)) return false;
+                if (!test_find(ptr3, n, value, ref, fun)) return false;
+                ptr1[k] = saved1;
+                ptr2[k] = saved2;
+                ptr3[k] = saved3;
+            }
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_findrange(char* ptr, size_t page_size, MemFindRangeFun* ref, MemFindRangeFun* fun)
+{
+    if (!test_findrange(NULL, 0, 'a', 'z', ref, fun)) return false;
+
+    // max size to test
+    const size_t size = 256;
+
+    // ranges below, above and across 0x80, single byte, full and empty ranges
+    static const uint8_t ranges[][2] =
+    {
+        { '0', '9' }, { 'a', 'z' }, { 0x00, 0x1f }, { 0x80, 0xff }, { 0x7f, 0x80 },
+        { 0x20, 0x7e }, { 'x', 'x' }, { 0x00, 0xff }, { 0x10, 0x00 },
+    };
+
+    uint32_t seed = 1;
+    for (size_t r=0; r<countof(ranges); r++)
+    {
+        uint8_t lo = ranges[r][0];
+        uint8_t hi = ranges[r][1];
+
+        // split all byte values into ones found by function, and ones that are not
+        uint8_t found[256];
+        uint8_t other[256];
+        size_t found_count = 0;
+        size_t other_count = 0;
+        for (size_t x=0; x<256; x++)
+        {
+            uint8_t b = (uint8_t)x;
+            if (ref(&b, 1, lo, hi) == 0)
+            {
+                found[found_count++] = b;
+            }
+            else
+            {
+                other[other_count++] = b;
+            }
+        }
+
+        // random bytes that will not be found, if there are any
+        for (size_t i=0; i<2*page_size; i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            uint8_t x = (uint8_t)(seed >> 16);
+            ptr[page_size + i] = (char)(other_count ? other[x % other_count] : x);
+        }
+
+        // test all sizes
+        for (size_t n=1; n<size; n++)
+        {
+            char* ptr1 = ptr + page_size;               // ptr1 is at start of page boundary (no reading before it)
+            char* ptr2 = ptr + 3 * page_size - n;       // ptr2 is at end of page boundary (no reading after it)
+            char* ptr3 = ptr + page_size + page_size/2; // ptr3 is in middle, can be written before & after
+
+            if (!test_findrange(ptr1, n, lo, hi, ref, fun)) return false;
+            if (!test_findrange(ptr2, n, lo, hi, ref, fun)) return false;
+            if (!test_findrange(ptr3, n, lo, hi, ref, fun)) return false;
+
+            if (found_count == 0) continue;
+
+            // test byte that will be found in each position in [0,n) interval
+            for (size_t k=0; k<n; k++)
+            {
+                char saved1 = ptr1[k];
+                char saved2 = ptr2[k];
+                char saved3 = ptr3[k];
+                ptr1[k] = ptr2[k] = ptr3[k] = (char)found[(k + n) % found_count];
+                if (!test_findrange(ptr1, n, lo, hi, ref, fun)) return false;
+                if (!test_findrange(ptr2, n, lo, hi, ref, fun)) return false;
+                if (!test_findrange(ptr3, n, lo, hi, ref, fun)) return false;
+                ptr1[k] = saved1;
+                ptr2[k] = saved2;
+                ptr3[k] = saved3;
+            }
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_validate(char* ptr, size_t page_size, MemValidateFun* ref, MemValidateFun* fun)
+{
+    if (!test_validate(NULL, 0, ref, fun)) return false;
+
+    // max size to test
+    const size_t size = 300;
+
+    // bytes that make sequence invalid, or start new one
+    static const uint8_t bad[] = { 0x80, 0xbf, 0xc0, 0xc1, 0xc2, 0xe0, 0xed, 0xef, 0xf0, 0xf4, 0xf5, 0xff, 'a' };
+
+    uint32_t seed = 1;
+
+    // percentage of ASCII code points in text
+    static const uint32_t ascii[] = { 0, 50, 95, 100 };
+    for (size_t t=0; t<countof(ascii); t++)
+    {
+        // fill two pages with valid UTF-8 text of random code points
+        uint8_t* p = (uint8_t*)ptr + page_size;
+        uint8_t* end = p + 2 * page_size;
+        while (p < end)
+        {
+            seed = seed * 1103515245 + 12345;
+            uint32_t r = seed >> 8;
+
+            uint32_t cp;
+            if (r % 100 < ascii[t])
+            {
+                cp = (r >> 8) % 0x80;
+            }
+            else
+            {
+                seed = seed * 1103515245 + 12345;
+                uint32_t x = seed >> 4;
+                switch (r % 4)
+                {
+                case 0:  cp = 0x80 + x % (0x800 - 0x80); break;
+                case 1:  cp = 0x800 + x % (0x10000 - 0x800); break;
+                case 2:  cp = 0x10000 + x % (0x110000 - 0x10000); break;
+                default: cp = (r & 0x100) ? 0xd7ff + (r >> 9) % 2 * 0x801 : 0x10ffff; break; // around surrogates and max
+                }
+                if (cp >= 0xd800 && cp <= 0xdfff) cp = 0xfffd;
+            }
+
+            uint8_t buffer[4];
+            size_t n;
+            if (cp < 0x80)
+            {
+                buffer[0] = (uint8_t)cp;
+                n = 1;
+            }
+            else if (cp < 0x800)
+            {
+                buffer[0] = (uint8_t)(0xc0 | (cp >> 6));
+                buffer[1] = (uint8_t)(0x80 | (cp & 0x3f));
+                n = 2;
+            }
+            else if (cp < 0x10000)
+            {
+                buffer[0] = (uint8_t)(0xe0 | (cp >> 12));
+                buffer[1] = (uint8_t)(0x80 | ((cp >> 6) & 0x3f));
+                buffer[2] = (uint8_t)(0x80 | (cp & 0x3f));
+                n = 3;
+            }
+            else
+            {
+                buffer[0] = (uint8_t)(0xf0 | (cp >> 18));
+                buffer[1] = (uint8_t)(0x80 | ((cp >> 12) & 0x3f));
+                buffer[2] = (uint8_t)(0x80 | ((cp >> 6) & 0x3f));
+                buffer[3] = (uint8_t)(0x80 | (cp & 0x3f));
+                n = 4;
+            }
+
+            for (size_t i=0; i<n && p<end; i++)
+            {
+                *p++ = buffer[i];
+            }
+        }
+
+        // test all sizes
+        for (size_t n=1; n<size; n++)
+        {
+            char* ptr1 = ptr + page_size;               // ptr1 is at start of page boundary (no reading before it)
+            char* ptr2 = ptr + 3 * page_size - n;       // ptr2 is at end of page boundary (no reading after it)
+            char* ptr3 = ptr + page_size + page_size/2; // ptr3 is in middle, can be written before & after
+
+            // for ASCII text start with two byte sequence, so vector blocks are checked without skipping ASCII prefix
+            const bool prefix = ascii[t] == 100 && n >= 2;
+            char prefix1[2] = { 0 }, prefix2[2] = { 0 }, prefix3[2] = { 0 };
+            if (prefix)
+            {
+                memcpy(prefix1, ptr1, 2);
+                memcpy(prefix2, ptr2, 2);
+                memcpy(prefix3, ptr3, 2);
+                memcpy(ptr1, "\xc3\xa9", 2);
+                memcpy(ptr2, "\xc3\xa9", 2);
+                memcpy(ptr3, "\xc3\xa9", 2);
+            }
+
+            if (!test_validate(ptr1, n, ref, fun)) return false;
+            if (!test_validate(ptr2, n, ref, fun)) return false;
+            if (!test_validate(ptr3, n, ref, fun)) return false;
+
+            // test invalid byte in each position in [0,n) interval
+            for (size_t k=0; k<n; k++)
+            {
+                char saved1 = ptr1[k];
+                char saved2 = ptr2[k];
+                char saved3 = ptr3[k];
+                ptr1[k] = ptr2[k] = ptr3[k] = (char)bad[(k + n) % countof(bad)];
+                if (!test_validate(ptr1, n, ref, fun)) return false;
+                if (!test_validate(ptr2, n, ref, fun)) return false;
+                if (!test_validate(ptr3, n, ref, fun)) return false;
+                ptr1[k] = saved1;
+                ptr2[k] = saved2;
+                ptr3[k] = saved3;
+            }
+
+            if (prefix)
+            {
+                memcpy(ptr1, prefix1, 2);
+                memcpy(ptr2, prefix2, 2);
+                memcpy(ptr3, prefix3, 2);
+            }
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_classify(char* ptr, size_t page_size, MemClassifyFun* ref, MemClassifyFun* fun)
+{
+    static const uint8_t set_any[] =
+    {
+        ',', '"', '\n', '\\', 0x00, 0x01, 0x1f, 0x7f, 0x80, 0x81, 0xfe, 0xff,
+        0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70, 0x90, 0xa0, 0xb0, 0xc0, 0xd0, 0xe0, 0xf0,
+    };
+
+    // set sizes to test, up to 3 bytes use different code path than larger sets
+    static const size_t set_sizes[] = { 0, 1, 2, 3, 4, 12, countof(set_any) };
+
+    if (!test_classify(NULL, 0, set_any, 0, ref, fun)) return false;
+    if (!test_classify(NULL, 0, set_any, 3, ref, fun)) return false;
+    if (!test_classify(NULL, 0, set_any, countof(set_any), ref, fun)) return false;
+
+    // max size to test
+    const size_t size = 320;
+
+    for (size_t s=0; s<countof(set_sizes); s++)
+    {
+        size_t setlen = set_sizes[s];
+
+        // all byte values not in set, used to fill buffers
+        uint8_t other[256];
+        size_t other_count = 0;
+        for (size_t v=0; v<256; v++)
+        {
+            uint8_t value = (uint8_t)v;
+            uint64_t mask;
+            ref(&value, 1, set_any, setlen, &mask);
+            if (mask == 0)
+            {
+                other[other_count++] = (uint8_t)v;
+            }
+        }
+
+        // bytes to place in buffer, for empty set use any byte
+        const uint8_t* found = setlen ? set_any : other;
+        size_t found_count = setlen ? setlen : other_count;
+
+        for (size_t i=0; i<2*page_size; i++)
+        {
+            ptr[page_size + i] = (char)other[(i * 7) % other_count];
+        }
+
+        // test all sizes
+        for (size_t n=1; n<size; n++)
+        {
+            char* ptr1 = ptr + page_size;               // ptr1 is at start of page boundary (no reading before it)
+            char* ptr2 = ptr + 3 * page_size - n;       // ptr2 is at end of page boundary (no reading after it)
+            char* ptr3 = ptr + page_size + page_size/2; // ptr3 is in middle, can be written before & after
+
+            if (!test_classify(ptr1, n, set_any, setlen, ref, fun)) return false;
+            if (!test_classify(ptr2, n, set_any, setlen, ref, fun)) return false;
+            if (!test_classify(ptr3, n, set_any, setlen, ref, fun)) return false;
+
+            // will mismatch if ptr1 or ptr3 is read past the end
+            char saved1 = ptr1[n];
+            char saved3 = ptr3[n];
+            ptr1[n] = (char)found[n % found_count];
+            ptr3[n] = (char)found[n % found_count];
+            if (!test_classify(ptr1, n, set_any, setlen, ref, fun)) return false;
+            if (!test_classify(ptr3, n, set_any, setlen, ref, fun)) return false;
+            ptr1[n] = saved1;
+            ptr3[n] = saved3;
+
+            // test set byte in every position in [0,n) interval, cycling through all bytes of set
+            for (size_t k=0; k<n; k++)
+            {
+                saved1 = ptr1[k];
+                char saved2 = ptr2[k];
+                saved3 = ptr3[k];
+                ptr1[k] = ptr2[k] = ptr3[k] = (char)found[(n + k) % found_count];
+                if (!test_classify(ptr1, n, set_any, setlen, ref, fun)) return false;
+                if (!test_classify(ptr2, n, set_any, setlen, ref, fun)) return false;
+                if (!test_classify(ptr3, n, set_any, setlen, ref, fun)) return false;
+                ptr1[k] = saved1;
+                ptr2[k] = saved2;
+                ptr3[k] = saved3;
+            }
+        }
+
+        // place set bytes in every third position, so every mask has many bits set
+        for (size_t i=0; i<2*page_size; i+=3)
+        {
+            ptr[page_size + i] = (char)found[i % found_count];
+        }
+
+        for (size_t n=1; n<size; n++)
+        {
+            char* ptr1 = ptr + page_size;
+            char* ptr2 = ptr + 3 * page_size - n;
+            char* ptr3 = ptr + page_size + page_size/2;
+
+            if (!test_classify(ptr1, n, set_any, setlen, ref, fun)) return false;
+            if (!test_classify(ptr2, n, set_any, setlen, ref, fun)) return false;
+            if (!test_classify(ptr3, n, set_any, setlen, ref, fun)) return false;
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_findwide(char* ptr, size_t page_size, const MemFindWideFun* ref, const MemFindWideFun* fun)
+{
+    const size_t width = fun->width;
+
+    // every byte of value is different, and zero to check that masked out lanes are not compared
+    static const uint64_t values[] = { 0x8877665544332211, 0 };
+
+    if (!test_findwide(NULL, 0, values[0], ref, fun)) return false;
+
+    // max element count to test
+    const size_t size = 160;
+
+    for (size_t v=0; v<countof(values); v++)
+    {
+        const uint64_t value = values[v];
+
+        // for every pass one of elements is placed in buffer filled with other ones
+        // other element differs from value only in one byte, so byte comparison cannot find it
+        for (size_t pass=0; pass<2; pass++)
+        {
+            for (size_t i=0; i<2*page_size/width; i++)
+            {
+                uint64_t other = value ^ (0x80ULL << (8 * (i % width)));
+                uint64_t fill = pass == 0 ? other : value;
+                memcpy(ptr + page_size + i * width, &fill, width);
+            }
+
+            // test all sizes
+            for (size_t n=1; n<size; n++)
+            {
+                char* ptr1 = ptr + page_size;                   // ptr1 is at start of page boundary (no reading before it)
+                char* ptr2 = ptr + 3 * page_size - n * width;   // ptr2 is at end of page boundary (no reading after it)
+                char* ptr3 = ptr + page_size + page_size/2 + 1; // ptr3 is in middle and not aligned, can be written before & after
+
+                uint64_t element = pass == 0 ? value : value ^ 0x80;
+                uint64_t saved1, saved2, saved3;
+
+                if (!test_findwide(ptr1, n, value, ref, fun)) return false;
+                if (!test_findwide(ptr2, n, value, ref, fun)) return false;
+                if (!test_findwide(ptr3, n, value, ref, fun)) return false;
+
+                // will mismatch if ptr1 or ptr3 is read past the end
+                memcpy(&saved1, ptr1 + n * width, width);
+                memcpy(&saved3, ptr3 + n * width, width);
+                memcpy(ptr1 + n * width, &element, width);
+                memcpy(ptr3 + n * width, &element, width);
+                if (!test_findwide(ptr1, n, value, ref, fun)) return false;
+                if (!test_findwide(ptr3, n, value, ref, fun)) return false;
+                memcpy(ptr1 + n * width, &saved1, width);
+                memcpy(ptr3 + n * width, &saved3, width);
+
+                // test element in every position in [0,n) interval
+                for (size_t k=0; k<n; k++)
+                {
+                    memcpy(&saved1, ptr1 + k * width, width);
+                    memcpy(&saved2, ptr2 + k * width, width);
+                    memcpy(&saved3, ptr3 + k * width, width);
+                    memcpy(ptr1 + k * width, &element, width);
+                    memcpy(ptr2 + k * width, &element, width);
+                    memcpy(ptr3 + k * width, &element, width);
+                    if (!test_findwide(ptr1, n, value, ref, fun)) return false;
+                    if (!test_findwide(ptr2, n, value, ref, fun)) return false;
+                    if (!test_findwide(ptr3, n, value, ref, fun)) return false;
+                    memcpy(ptr1 + k * width, &saved1, width);
+                    memcpy(ptr2 + k * width, &saved2, width);
+                    memcpy(ptr3 + k * width, &saved3, width);
+                }
+            }
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_lowerbound(char* ptr, size_t page_size, const MemFindWideFun* ref, const MemFindWideFun* fun)
+{
+    const size_t width = fun->width;
+
+    // elements cross top bit of element (and of low 32-bit half for 64-bit elements), to check unsigned comparison
+    static const uint64_t bases32[] = { 0x7fffff00, 0 };
+    static const uint64_t bases64[] = { 0x7fffffffffffff00, 0x17fffff00 };
+    const uint64_t* bases = width == 4 ? bases32 : bases64;
+
+    if (!test_findwide(NULL, 0, 0, ref, fun)) return false;
+
+    // max element count to test, larger than search windows of all implementations
+    const size_t size = 300;
+
+    for (size_t b=0; b<2; b++)
+    {
+        // test all sizes
+        for (size_t n=1; n<size; n++)
+        {
+            char* ptr1 = ptr + page_size;                   // ptr1 is at start of page boundary (no reading before it)
+            char* ptr2 = ptr + 3 * page_size - n * width;   // ptr2 is at end of page boundary (no reading after it)
+            char* ptr3 = ptr1 + size * width + 1;           // ptr3 is after ptr1 and not aligned
+
+            // sorted elements with pairs of duplicates and gaps between them
+            for (size_t i=0; i<n; i++)
+            {
+                uint64_t element = bases[b] + (i / 2) * 3;
+                memcpy(ptr1 + i * width, &element, width);
+                memcpy(ptr2 + i * width, &element, width);
+                memcpy(ptr3 + i * width, &element, width);
+            }
+
+            // search for every element, and values right before and after it
+            for (size_t i=0; i<n; i++)
+            {
+                for (uint64_t d=0; d<3; d++)
+                {
+                    uint64_t value = bases[b] + (i / 2) * 3 + d - 1;
+                    if (!test_findwide(ptr1, n, value, ref, fun)) return false;
+                    if (!test_findwide(ptr2, n, value, ref, fun)) return false;
+                    if (!test_findwide(ptr3, n, value, ref, fun)) return false;
+                }
+            }
+
+            // smallest and largest values
+            if (!test_findwide(ptr1, n, 0, ref, fun)) return false;
+            if (!test_findwide(ptr2, n, ~0ULL, ref, fun)) return false;
+            if (!test_findwide(ptr3, n, ~0ULL, ref, fun)) return false;
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool run_findbytes(char* ptr, size_t page_size, MemFindBytesFun* ref, MemFindBytesFun* fun)
+{
+    // needle lengths to test, around 8/16/32/64 sizes where code paths change
+    static const size_t needle_sizes[] = { 1, 2, 3, 4, 5, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100 };
+
+    uint8_t needle[128];
+
+    if (!test_findbytes(NULL, 0, NULL, 0, ref, fun)) return false;
+    if (!test_findbytes(ptr + page_size, 0, (const uint8_t*)"a", 1, ref, fun)) return false;
+    if (!test_findbytes(ptr + page_size, 0, (const uint8_t*)"ab", 2, ref, fun)) return false;
+
+    // max size to test
+    const size_t size = 192;
+
+    // case insensitive search gets letters in random case
+    char flip = ref == &MemFindBytesI_ref ? 0x20 : 0x00;
+
+    // random mix of two bytes produces a lot of partial matches
+    uint32_t seed = 1;
+    for (size_t i=0; i<2*page_size; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        ptr[page_size + i] = (char)(((seed >> 16) & 3 ? 'a' : 'b') ^ ((seed >> 20) & 1 ? flip : 0));
+    }
+
+    for (size_t s=0; s<countof(needle_sizes); s++)
+    {
+        size_t needlelen = needle_sizes[s];
+
+        // needle starts & ends with different bytes than most of buffer, to test verification of candidates
+        for (size_t i=0; i<needlelen; i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            needle[i] = (uint8_t)(((seed >> 16) & 3 ? 'a' : 'b') ^ ((seed >> 20) & 1 ? flip : 0));
+        }
+        needle[0] = (uint8_t)('b' ^ flip);
+        needle[needlelen - 1] = 'b';
+
+        // test all sizes
+        for (size_t n=0; n<size; n++)
+        {
+            char* ptr1 = ptr + page_size;               // ptr1 is at start of page boundary (no reading before it)
+            char* ptr2 = ptr + 3 * page_size - n;       // ptr2 is at end of page boundary (no reading after it)
+            char* ptr3 = ptr + page_size + page_size/2; // ptr3 is in middle, can be written before & after
+
+            if (!test_findbytes(ptr1, n, needle, needlelen, ref, fun)) return false;
+            if (!test_findbytes(ptr2, n, needle, needlelen, ref, fun)) return false;
+            if (!test_findbytes(ptr3, n, needle, needlelen, ref, fun)) return false;
+
+            // will mismatch if ptr1 or ptr3 is read past the end, needle is placed so its last byte is past the end
+            if (n + 1 >= needlelen)
+            {
+                char saved1[128];
+                char saved3[128];
+                memcpy(saved1, ptr1 + n + 1 - needlelen, needlelen);
+                memcpy(saved3, ptr3 + n + 1 - needlelen, needlelen);
+                memcpy(ptr1 + n + 1 - needlelen, needle, needlelen);
+                memcpy(ptr3 + n + 1 - needlelen, needle, needlelen);
+                if (!test_findbytes(ptr1, n, needle, needlelen, ref, fun)) return false;
+                if (!test_findbytes(ptr3, n, needle, needlelen, ref, fun)) return false;
+                memcpy(ptr1 + n + 1 - needlelen, saved1, needlelen);
+                memcpy(ptr3 + n + 1 - needlelen, saved3, needlelen);
+            }
+
+            // test needle in every position in [0,n) interval where it fits
+            for (size_t k=0; k+needlelen<=n; k++)
+            {
+                char saved1[128];
+                char saved2[128];
+                char saved3[128];
+                memcpy(saved1, ptr1 + k, needlelen);
+                memcpy(saved2, ptr2 + k, needlelen);
+                memcpy(saved3, ptr3 + k, needlelen);
+                memcpy(ptr1 + k, needle, needlelen);
+                memcpy(ptr2 + k, needle, needlelen);
+                memcpy(ptr3 + k, needle, needlelen);
+                if (!test_findbytes(ptr1, n, needle, needlelen, ref, fun)) return false;
+                if (!test_findbytes(ptr2, n, needle, needlelen, ref, fun)) return false;
+                if (!test_findbytes(ptr3, n, needle, needlelen, ref, fun)) return false;
+                memcpy(ptr1 + k, saved1, needlelen);
+                memcpy(ptr2 + k, saved2, needlelen);
+                memcpy(ptr3 + k, saved3, needlelen);
+            }
+        }
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static const struct
+{
+    const char*      name;
+    MemCompareFun*   compare;
+    MemCompareFun*   comparei;
+    MemIsEqualFun*   isequal;
+    MemFindFun*      find;
+    MemFindFun*      findnot;
+    MemFindFun*      findlast;
+    MemFindFun*      findlastnot;
+    MemFindAnyFun*   findany;
+    MemFindBytesFun* findbytes;
+    MemFindFun*      count;
+    MemMismatchFun*  mismatch;
+    MemConvertFun*   tolower;
+    MemConvertFun*   toupper;
+    MemFindFun*      findi;
+    MemFindBytesFun* findbytesi;
+    MemFindRangeFun* findinrange;
+    MemFindRangeFun* findnotinrange;
+    MemValidateFun*  validateutf8;
+    MemClassifyFun*  classify;
+    MemFind16Fun*    find16;
+    MemFind32Fun*    find32;
+    MemFind64Fun*    find64;
+    MemFind16Fun*    findnot16;
+    MemFind32Fun*    findnot32;
+    MemFind64Fun*    findnot64;
+    MemFind32Fun*    lowerbound32;
+    MemFind64Fun*    lowerbound64;
+    MemTranslateFun* translate;
+    MemHashFun*      hash64;
+    MemBatchEqFun*   isequalbatch;
+    MemBatchCmpFun*  comparebatch;
+    MemIsEqualFun*   isequalconsttime;
+    MemFindVFun*     findv;
+    MemIsEqualVFun*  isequalv;
+    int              cpuid;
+}
+memfun[] =
+{
+    { "std",     &MemCompare_std,     &MemCompareI_std,     &MemIsEqual_std,     &MemFind_std,     0,                   0,                    0,                       0,                   0,                     0,                 0,                    0,                   0,                   0,                 0,                      0,                       0,                          0,                        0,                    0,                  0,                  0,                  0,                     0,                     0,                     0,                        0,                        0,                     0,                  0,                        0,                        0,                            0,                 0,                    0                },
+    { "generic", &MemCompare_generic, &MemCompareI_generic, &MemIsEqual_generic, &MemFind_generic, &MemFindNot_generic, &MemFindLast_generic, &MemFindLastNot_generic, &MemFindAny_generic, &MemFindBytes_generic, &MemCount_generic, &MemMismatch_generic, &MemToLower_generic, &MemToUpper_generic, &MemFindI_generic, &MemFindBytesI_generic, &MemFindInRange_generic, &MemFindNotInRange_generic, &MemValidateUTF8_generic, &MemClassify_generic, &MemFind16_generic, &MemFind32_generic, &MemFind64_generic, &MemFindNot16_generic, &MemFindNot32_generic, &MemFindNot64_generic, &MemLowerBound32_generic, &MemLowerBound64_generic, &MemTranslate_generic, &MemHash64_generic, &MemIsEqualBatch_generic, &MemCompareBatch_generic, &MemIsEqualConstTime_generic, &MemFindV_generic, &MemIsEqualV_generic, 0                },
+    { "auto",    &MemCompare,         &MemCompareI,         &MemIsEqual,         &MemFind,         &MemFindNot,         &MemFindLast,         &MemFindLastNot,         &MemFindAny,         &MemFindBytes,         &MemCount,         &MemMismatch,         &MemToLower,         &MemToUpper,         &MemFindI,         &MemFindBytesI,         &MemFindInRange,         &MemFindNotInRange,         &MemValidateUTF8,         &MemClassify,         &MemFind16,         &MemFind32,         &MemFind64,         &MemFindNot16,         &MemFindNot32,         &MemFindNot64,         &MemLowerBound32,         &MemLowerBound64,         &MemTranslate,         &MemHash64,         &MemIsEqualBatch,         &MemCompareBatch,         &MemIsEqualConstTime,         &MemFindV,         &MemIsEqualV,         0                },
+#if MEM_ARCH_RVV
+    { "rvv",     &MemCompare_rvv,     &MemCompareI_rvv,     &MemIsEqual_rvv,     &MemFind_rvv,     &MemFindNot_rvv,     &MemFindLast_rvv,     &MemFindLastNot_rvv,     &MemFindAny_rvv,     &MemFindBytes_rvv,     &MemCount_rvv,     &MemMismatch_rvv,     &MemToLower_rvv,     &MemToUpper_rvv,     &MemFindI_rvv,     &MemFindBytesI_rvv,     &MemFindInRange_rvv,     &MemFindNotInRange_rvv,     &MemValidateUTF8_rvv,     &MemClassify_rvv,     &MemFind16_rvv,     &MemFind32_rvv,     &MemFind64_rvv,     &MemFindNot16_rvv,     &MemFindNot32_rvv,     &MemFindNot64_rvv,     &MemLowerBound32_rvv,     &MemLowerBound64_rvv,     &MemTranslate_rvv,     &MemHash64_rvv,     &MemIsEqualBatch_rvv,     &MemCompareBatch_rvv,     &MemIsEqualConstTime_rvv,     &MemFindV_rvv,     &MemIsEqualV_rvv,     0                },
+#elif MEM_ARCH_ARM64
+    { "neon",    &MemCompare_neon,    &MemCompareI_neon,    &MemIsEqual_neon,    &MemFind_neon,    &MemFindNot_neon,    &MemFindLast_neon,    &MemFindLastNot_neon,    &MemFindAny_neon,    &MemFindBytes_neon,    &MemCount_neon,    &MemMismatch_neon,    &MemToLower_neon,    &MemToUpper_neon,    &MemFindI_neon,    &MemFindBytesI_neon,    &MemFindInRange_neon,    &MemFindNotInRange_neon,    &MemValidateUTF8_neon,    &MemClassify_neon,    &MemFind16_neon,    &MemFind32_neon,    &MemFind64_neon,    &MemFindNot16_neon,    &MemFindNot32_neon,    &MemFindNot64_neon,    &MemLowerBound32_neon,    &MemLowerBound64_neon,    &MemTranslate_neon,    &MemHash64_neon,    &MemIsEqualBatch_neon,    &MemCompareBatch_neon,    &MemIsEqualConstTime_neon,    &MemFindV_neon,    &MemIsEqualV_neon,    0                },
+#  if MEM_ARCH_SVE
+    { "sve",     &MemCompare_sve,     0,                    &MemIsEqual_sve,     &MemFind_sve,     &MemFindNot_sve,     &MemFindLast_sve,     &MemFindLastNot_sve,     &MemFindAny_sve,     0,                     &MemCount_sve,     &MemMismatch_sve,     0,                   0,                   0,                 0,                      0,                       0,                          0,                        0,                    0,                  0,                  0,                  0,                     0,                     0,                     0,                        0,                        0,                     0,                  0,                        0,                        0,                            0,                 0,                    MEM_CPUID_SVE    },
+#  endif
+#elif MEM_ARCH_X64
+    { "sse2",    &MemCompare_sse2,    &MemCompareI_sse2,    &MemIsEqual_sse2,    &MemFind_sse2,    &MemFindNot_sse2,    &MemFindLast_sse2,    &MemFindLastNot_sse2,    &MemFindAny_sse2,    &MemFindBytes_sse2,    &MemCount_sse2,    &MemMismatch_sse2,    &MemToLower_sse2,    &MemToUpper_sse2,    &MemFindI_sse2,    &MemFindBytesI_sse2,    &MemFindInRange_sse2,    &MemFindNotInRange_sse2,    &MemValidateUTF8_sse2,    &MemClassify_sse2,    &MemFind16_sse2,    &MemFind32_sse2,    &MemFind64_sse2,    &MemFindNot16_sse2,    &MemFindNot32_sse2,    &MemFindNot64_sse2,    &MemLowerBound32_sse2,    &MemLowerBound64_sse2,    &MemTranslate_sse2,    &MemHash64_sse2,    &MemIsEqualBatch_sse2,    &MemCompareBatch_sse2,    &MemIsEqualConstTime_sse2,    &MemFindV_sse2,    &MemIsEqualV_sse2,    0                },
+    { "avx2",    &MemCompare_avx2,    &MemCompareI_avx2,    &MemIsEqual_avx2,    &MemFind_avx2,    &MemFindNot_avx2,    &MemFindLast_avx2,    &MemFindLastNot_avx2,    &MemFindAny_avx2,    &MemFindBytes_avx2,    &MemCount_avx2,    &MemMismatch_avx2,    &MemToLower_avx2,    &MemToUpper_avx2,    &MemFindI_avx2,    &MemFindBytesI_avx2,    &MemFindInRange_avx2,    &MemFindNotInRange_avx2,    &MemValidateUTF8_avx2,    &MemClassify_avx2,    &MemFind16_avx2,    &MemFind32_avx2,    &MemFind64_avx2,    &MemFindNot16_avx2,    &MemFindNot32_avx2,    &MemFindNot64_avx2,    &MemLowerBound32_avx2,    &MemLowerBound64_avx2,    &MemTranslate_avx2,    &MemHash64_avx2,    &MemIsEqualBatch_avx2,    &MemCompareBatch_avx2,    &MemIsEqualConstTime_avx2,    &MemFindV_avx2,    &MemIsEqualV_avx2,    MEM_CPUID_AVX2   },
+    { "avx10",   &MemCompare_avx10,   0,                    &MemIsEqual_avx10,   &MemFind_avx10,   &MemFindNot_avx10,   &MemFindLast_avx10,   &MemFindLastNot_avx10,   0,                   0,                     &MemCount_avx10,   &MemMismatch_avx10,   0,                   0,                   0,                 0,                      0,                       0,                          0,                        0,                    0,                  0,                  0,                  0,                     0,                     0,                     0,                        0,                        0,                     0,                  0,                        0,                        0,                            0,                 0,                    MEM_CPUID_AVX10  },
+    { "avx512",  &MemCompare_avx512,  &MemCompareI_avx512,  &MemIsEqual_avx512,  &MemFind_avx512,  &MemFindNot_avx512,  &MemFindLast_avx512,  &MemFindLastNot_avx512,  &MemFindAny_avx512,  &MemFindBytes_avx512,  &MemCount_avx512,  &MemMismatch_avx512,  &MemToLower_avx512,  &MemToUpper_avx512,  &MemFindI_avx512,  &MemFindBytesI_avx512,  &MemFindInRange_avx512,  &MemFindNotInRange_avx512,  &MemValidateUTF8_avx512,  &MemClassify_avx512,  &MemFind16_avx512,  &MemFind32_avx512,  &MemFind64_avx512,  &MemFindNot16_avx512,  &MemFindNot32_avx512,  &MemFindNot64_avx512,  &MemLowerBound32_avx512,  &MemLowerBound64_avx512,  &MemTranslate_avx512,  &MemHash64_avx512,  &MemIsEqualBatch_avx512,  &MemCompareBatch_avx512,  &MemIsEqualConstTime_avx512,  &MemFindV_avx512,  &MemIsEqualV_avx512,  MEM_CPUID_AVX512 },
+#endif
+};
+
+#if MEM_ARCH_X64
+// checks what CPU supports, not what MEMFUN_ISA environment variable selected for dispatch
+#    define MEMFUN_CPU_SKIP(cpuid) ((cpuid) && ((MemDoCPUID() | MemCPUIDCompiled()) & (cpuid)) == 0)
+// avx512 implementation of few functions also needs VBMI
+#    define MEMFUN_CPUID_VBMI(cpuid) ((cpuid) == MEM_CPUID_AVX512 ? MEM_CPUID_AVX512VBMI : (cpuid))
+#elif MEM_ARCH_SVE
+#    define MEMFUN_CPU_SKIP(cpuid) ((cpuid) && ((MemDoCPUID() | MemCPUIDCompiled()) & (cpuid)) == 0)
+// sve implementation of MemFindAny also needs SVE2
+#    define MEMFUN_CPUID_VBMI(cpuid) ((cpuid) == MEM_CPUID_SVE ? MEM_CPUID_SVE2 : (cpuid))
+#else
+#    define MEMFUN_CPU_SKIP(cpuid) (0)
+#    define MEMFUN_CPUID_VBMI(cpuid) (cpuid)
+#endif
+
+int main()
+{
+    // allocate 4 pages where first and last page is not accessible
+    // only two middle pages are valid to read/write
+#if defined(_WIN32)
+    size_t page_size = 4096;
+    char* ptr = (char*)VirtualAlloc(NULL, 4 * page_size, MEM_RESERVE, PAGE_NOACCESS);
+    assert(ptr);
+    char* commit = (char*)VirtualAlloc(ptr + page_size, 2 * page_size, MEM_COMMIT, PAGE_READWRITE);
+    assert(commit);
+#elif defined(__linux__) || defined(__APPLE__)
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    char* ptr = (char*)mmap(NULL, 4 * page_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    assert(ptr != MAP_FAILED);
+    int protect = mprotect(ptr + page_size, 2 * page_size, PROT_READ | PROT_WRITE);
+    assert(protect == 0);
+#elif defined(__wasm__)
+    size_t page_size = 4096;
+    static char buffer[4*4096];
+    char* ptr = buffer;
+#else
+    #error N/A
+#endif
+
+    int ret = EXIT_SUCCESS;
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].compare) continue;
+
+        int n = printf("MemCompare_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_compare(ptr, page_size, &MemCompare_ref, memfun[i].compare))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].comparei) continue;
+
+        int n = printf("MemCompareI_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_compare(ptr, page_size, &MemCompareI_ref, memfun[i].comparei))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].isequal) continue;
+
+        int n = printf("MemIsEqual_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_isequal(ptr, page_size, &MemIsEqual_ref, memfun[i].isequal))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].find) continue;
+
+        int n = printf("MemFind_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_find(ptr, page_size, &MemFind_ref, memfun[i].find))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].findnot) continue;
+
+        int n = printf("MemFindNot_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_find(ptr, page_size, &MemFindNot_ref, memfun[i].findnot))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].findlast) continue;
+
+        int n = printf("MemFindLast_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_find(ptr, page_size, &MemFindLast_ref, memfun[i].findlast))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].findlastnot) continue;
+
+        int n = printf("MemFindLastNot_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_find(ptr, page_size, &MemFindLastNot_ref, memfun[i].findlastnot))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].findany) continue;
+
+        int n = printf("MemFindAny_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(MEMFUN_CPUID_VBMI(memfun[i].cpuid)))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_findany(ptr, page_size, &MemFindAny_ref, memfun[i].findany))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].findbytes) continue;
+
+        int n = printf("MemFindBytes_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_findbytes(ptr, page_size, &MemFindBytes_ref, memfun[i].findbytes))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].count) continue;
+
+        int n = printf("MemCount_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_count(ptr, page_size, &MemCount_ref, memfun[i].count))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].mismatch) continue;
+
+        int n = printf("MemMismatch_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_mismatch(ptr, page_size, &MemMismatch_ref, memfun[i].mismatch))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    {
+        int n = printf("MemCommonPrefix");
+        printf("%*s", 28 - n, ": ");
+
+        if (!run_commonprefix(ptr, page_size))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].tolower) continue;
+
+        int n = printf("MemToLower_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_convert(ptr, page_size, &MemToLower_ref, memfun[i].tolower))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].toupper) continue;
+
+        int n = printf("MemToUpper_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_convert(ptr, page_size, &MemToUpper_ref, memfun[i].toupper))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].findi) continue;
+
+        int n = printf("MemFindI_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_findi(ptr, page_size, &MemFindI_ref, memfun[i].findi))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].findbytesi) continue;
+
+        int n = printf("MemFindBytesI_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_findbytes(ptr, page_size, &MemFindBytesI_ref, memfun[i].findbytesi))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].findinrange) continue;
+
+        int n = printf("MemFindInRange_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_findrange(ptr, page_size, &MemFindInRange_ref, memfun[i].findinrange))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].findnotinrange) continue;
+
+        int n = printf("MemFindNotInRange_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_findrange(ptr, page_size, &MemFindNotInRange_ref, memfun[i].findnotinrange))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].validateutf8) continue;
+
+        int n = printf("MemValidateUTF8_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_validate(ptr, page_size, &MemValidateUTF8_ref, memfun[i].validateutf8))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].classify) continue;
+
+        int n = printf("MemClassify_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(MEMFUN_CPUID_VBMI(memfun[i].cpuid)))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_classify(ptr, page_size, &MemClassify_ref, memfun[i].classify))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].find16) continue;
+
+        int n = printf("MemFind16_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
         {
-            if (!test_find(ptr1, n, 0xff, ref, fun)) return false;
-            if (!test_find(ptr2, n, 0xff, ref, fun)) return false;
+            printf("N/A\n");
+            continue;
+        }
 
-            // will mismatch if ptr1 is read past the end
-            ptr1[n] ^= (char)0xff;
+        MemFindWideFun ref = { 2, NULL, NULL, NULL };
+        MemFindWideFun fun = { 2, NULL, NULL, NULL };
+        ref.find16 = &MemFind16_ref;
+        fun.find16 = memfun[i].find16;
+        if (!run_findwide(ptr, page_size, &ref, &fun))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
 
-            // will mismatch if ptr2 is read past the beginning
-            ptr2[-1] ^= (char)0xff;
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].find32) continue;
+
+        int n = printf("MemFind32_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
         }
 
-        // test a difference in each position in [0,n] interval
-        for (size_t k=0; k<n; k++)
+        MemFindWideFun ref = { 4, NULL, NULL, NULL };
+        MemFindWideFun fun = { 4, NULL, NULL, NULL };
+        ref.find32 = &MemFind32_ref;
+        fun.find32 = memfun[i].find32;
+        if (!run_findwide(ptr, page_size, &ref, &fun))
         {
-            ptr1[k] ^= (char)0xff;
-            ptr2[k] ^= (char)0xff;
-            ptr3[k] ^= (char)0xff;
-            if (!test_find(ptr1, n, 0xff, ref, fun)) return false;
-            if (!test_find(ptr2, n, 0xff, ref, fun)) return false;
-            if (!test_find(ptr3, n, 0xff, ref, fun)) return false;
-            ptr1[k] ^= (char)0xff;
-            ptr2[k] ^= (char)0xff;
-            ptr3[k] ^= (char)0xff;
+            ret = EXIT_FAILURE;
         }
+        fflush(stdout);
     }
 
-    printf("OK\n");
-    return true;
-}
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].find64) continue;
 
-static const struct
-{
-    const char*    name;
-    MemCompareFun* compare;
-    MemCompareFun* comparei;
-    MemIsEqualFun* isequal;
-    MemFindFun*    find;
-    MemFindFun*    findnot;
-    int            cpuid;
-}
-memfun[] =
-{
-    { "std",            &MemCompare_std,     &MemCompareI_std,           &MemIsEqual_std,     &MemFind_std,       0,                    0                   },
-    { "generic",        &MemCompare_generic, &MemCompareI_generic,       &MemIsEqual_generic, &MemFind_generic,   &MemFindNot_generic,  0                   },
-    { "auto",           &MemCompare,         &MemCompareI,               &MemIsEqual,         &MemFind,           &MemFindNot,          0                   },
-#if MEM_ARCH_RVV
-    { "rvv",            &MemCompare_rvv,     &MemCompareI_rvv,           &MemIsEqual_rvv,     &MemFind_rvv,       &MemFindNot_rvv,      0                   },
-#elif MEM_ARCH_ARM64
-    { "neon",           &MemCompare_neon,    &MemCompareI_neon,          &MemIsEqual_neon,    &MemFind_neon,      &MemFindNot_neon,     0                   },
-#elif MEM_ARCH_X64
-    { "sse2",           &MemCompare_sse2,    &MemCompareI_sse2,          &MemIsEqual_sse2,    &MemFind_sse2,      &MemFindNot_sse2,     0                   },
-    { "avx2",           &MemCompare_avx2,    &MemCompareI_avx2,          &MemIsEqual_avx2,    &MemFind_avx2,      &MemFindNot_avx2,     MEM_CPUID_AVX2      },
-    { "avx512",         &MemCompare_avx512,  &MemCompareI_avx512,        &MemIsEqual_avx512,  &MemFind_avx512,    &MemFindNot_avx512,   MEM_CPUID_AVX512    },
-#endif
-};
+        int n = printf("MemFind64_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
 
-#if MEM_ARCH_X64
-#    define MEMFUN_CPU_SKIP(cpuid) ((cpuid) && (MemCPUID() & (cpuid)) == 0)
-#else
-#    define MEMFUN_CPU_SKIP(cpuid) (0)
-#endif
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
 
-int main()
-{
-    // allocate 4 pages where first and last page is not accessible
-    // only two middle pages are valid to read/write
-#if defined(_WIN32)
-    size_t page_size = 4096;
-    char* ptr = (char*)VirtualAlloc(NULL, 4 * page_size, MEM_RESERVE, PAGE_NOACCESS);
-    assert(ptr);
-    char* commit = (char*)VirtualAlloc(ptr + page_size, 2 * page_size, MEM_COMMIT, PAGE_READWRITE);
-    assert(commit);
-#elif defined(__linux__) || defined(__APPLE__)
-    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
-    char* ptr = (char*)mmap(NULL, 4 * page_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-    assert(ptr != MAP_FAILED);
-    int protect = mprotect(ptr + page_size, 2 * page_size, PROT_READ | PROT_WRITE);
-    assert(protect == 0);
-#elif defined(__wasm__)
-    size_t page_size = 4096;
-    static char buffer[4*4096];
-    char* ptr = buffer;
-#else
-    #error N/A
-#endif
+        MemFindWideFun ref = { 8, NULL, NULL, NULL };
+        MemFindWideFun fun = { 8, NULL, NULL, NULL };
+        ref.find64 = &MemFind64_ref;
+        fun.find64 = memfun[i].find64;
+        if (!run_findwide(ptr, page_size, &ref, &fun))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
 
-    int ret = EXIT_SUCCESS;
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].findnot16) continue;
+
+        int n = printf("MemFindNot16_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        MemFindWideFun ref = { 2, NULL, NULL, NULL };
+        MemFindWideFun fun = { 2, NULL, NULL, NULL };
+        ref.find16 = &MemFindNot16_ref;
+        fun.find16 = memfun[i].findnot16;
+        if (!run_findwide(ptr, page_size, &ref, &fun))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
 
     for (size_t i=0; i<countof(memfun); i++)
     {
-        if (!memfun[i].compare) continue;
+        if (!memfun[i].findnot32) continue;
 
-        int n = printf("MemCompare_%s", memfun[i].name);
-        printf("%*s", 25 - n, ": ");
+        int n = printf("MemFindNot32_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
 
         if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
         {
@@ -441,7 +3367,11 @@ int main()
             continue;
         }
 
-        if (!run_compare(ptr, page_size, &MemCompare_ref, memfun[i].compare))
+        MemFindWideFun ref = { 4, NULL, NULL, NULL };
+        MemFindWideFun fun = { 4, NULL, NULL, NULL };
+        ref.find32 = &MemFindNot32_ref;
+        fun.find32 = memfun[i].findnot32;
+        if (!run_findwide(ptr, page_size, &ref, &fun))
         {
             ret = EXIT_FAILURE;
         }
@@ -450,10 +3380,10 @@ int main()
 
     for (size_t i=0; i<countof(memfun); i++)
     {
-        if (!memfun[i].comparei) continue;
+        if (!memfun[i].findnot64) continue;
 
-        int n = printf("MemCompareI_%s", memfun[i].name);
-        printf("%*s", 25 - n, ": ");
+        int n = printf("MemFindNot64_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
 
         if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
         {
@@ -461,7 +3391,11 @@ int main()
             continue;
         }
 
-        if (!run_compare(ptr, page_size, &MemCompareI_ref, memfun[i].comparei))
+        MemFindWideFun ref = { 8, NULL, NULL, NULL };
+        MemFindWideFun fun = { 8, NULL, NULL, NULL };
+        ref.find64 = &MemFindNot64_ref;
+        fun.find64 = memfun[i].findnot64;
+        if (!run_findwide(ptr, page_size, &ref, &fun))
         {
             ret = EXIT_FAILURE;
         }
@@ -470,10 +3404,10 @@ int main()
 
     for (size_t i=0; i<countof(memfun); i++)
     {
-        if (!memfun[i].isequal) continue;
+        if (!memfun[i].lowerbound32) continue;
 
-        int n = printf("MemIsEqual_%s", memfun[i].name);
-        printf("%*s", 25 - n, ": ");
+        int n = printf("MemLowerBound32_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
 
         if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
         {
@@ -481,7 +3415,9 @@ int main()
             continue;
         }
 
-        if (!run_isequal(ptr, page_size, &MemIsEqual_ref, memfun[i].isequal))
+        MemFindWideFun ref = { 4, NULL, &MemLowerBound32_ref, NULL };
+        MemFindWideFun fun = { 4, NULL, memfun[i].lowerbound32, NULL };
+        if (!run_lowerbound(ptr, page_size, &ref, &fun))
         {
             ret = EXIT_FAILURE;
         }
@@ -490,10 +3426,10 @@ int main()
 
     for (size_t i=0; i<countof(memfun); i++)
     {
-        if (!memfun[i].find) continue;
+        if (!memfun[i].lowerbound64) continue;
 
-        int n = printf("MemFind_%s", memfun[i].name);
-        printf("%*s", 25 - n, ": ");
+        int n = printf("MemLowerBound64_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
 
         if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
         {
@@ -501,7 +3437,9 @@ int main()
             continue;
         }
 
-        if (!run_find(ptr, page_size, &MemFind_ref, memfun[i].find))
+        MemFindWideFun ref = { 8, NULL, NULL, &MemLowerBound64_ref };
+        MemFindWideFun fun = { 8, NULL, NULL, memfun[i].lowerbound64 };
+        if (!run_lowerbound(ptr, page_size, &ref, &fun))
         {
             ret = EXIT_FAILURE;
         }
@@ -510,10 +3448,30 @@ int main()
 
     for (size_t i=0; i<countof(memfun); i++)
     {
-        if (!memfun[i].findnot) continue;
+        if (!memfun[i].translate) continue;
 
-        int n = printf("MemFindNot_%s", memfun[i].name);
-        printf("%*s", 25 - n, ": ");
+        int n = printf("MemTranslate_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(MEMFUN_CPUID_VBMI(memfun[i].cpuid)))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_translate(ptr, page_size, &MemTranslate_ref, memfun[i].translate))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].hash64) continue;
+
+        int n = printf("MemHash64_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
 
         if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
         {
@@ -521,7 +3479,153 @@ int main()
             continue;
         }
 
-        if (!run_find(ptr, page_size, &MemFindNot_ref, memfun[i].findnot))
+        if (!run_hash(ptr, page_size, &MemHash64_ref, memfun[i].hash64))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].isequalbatch) continue;
+
+        int n = printf("MemIsEqualBatch_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_isequalbatch(ptr, page_size, &MemIsEqual_ref, memfun[i].isequalbatch))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].comparebatch) continue;
+
+        int n = printf("MemCompareBatch_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_comparebatch(ptr, page_size, &MemCompare_ref, memfun[i].comparebatch))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].isequalconsttime) continue;
+
+        int n = printf("MemIsEqualConstTime_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_isequalconsttime(ptr, page_size, &MemIsEqual_ref, memfun[i].isequalconsttime))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].findv) continue;
+
+        int n = printf("MemFindV_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_findv(ptr, page_size, &MemFind_ref, memfun[i].findv))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i=0; i<countof(memfun); i++)
+    {
+        if (!memfun[i].isequalv) continue;
+
+        int n = printf("MemIsEqualV_%s", memfun[i].name);
+        printf("%*s", 28 - n, ": ");
+
+        if (MEMFUN_CPU_SKIP(memfun[i].cpuid))
+        {
+            printf("N/A\n");
+            continue;
+        }
+
+        if (!run_isequalv(ptr, page_size, &MemIsEqual_ref, memfun[i].isequalv))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    {
+        int n = printf("MemSearchNext");
+        printf("%*s", 28 - n, ": ");
+
+        if (!run_search())
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+#if defined(MEM_PARALLEL)
+    {
+        int n = printf("MemFindParallel");
+        printf("%*s", 28 - n, ": ");
+
+        if (!run_parallel(&MemFind_ref, &MemFindParallel))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+
+    {
+        int n = printf("MemCountParallel");
+        printf("%*s", 28 - n, ": ");
+
+        if (!run_parallel(&MemCount_ref, &MemCountParallel))
+        {
+            ret = EXIT_FAILURE;
+        }
+        fflush(stdout);
+    }
+#endif
+
+    {
+        int n = printf("MemSetPreferredISA");
+        printf("%*s", 28 - n, ": ");
+
+        if (!run_preferred_isa())
         {
             ret = EXIT_FAILURE;
         }
@@ -103,6 +103,7 @@ if "%CC%" equ "msvc" (
     if "!X!" equ "sse4"   set BUILD=!BUILD! -msse4.2
     if "!X!" equ "avx2"   set BUILD=!BUILD! -mavx2 -mfma
     if "!X!" equ "avx512" set BUILD=!BUILD! -mavx512f -mavx512cd -mavx512bw -mavx512dq -mavx512vl
+    if "!X!" equ "avx512vbmi" set BUILD=!BUILD! -mavx512f -mavx512cd -mavx512bw -mavx512dq -mavx512vl -mavx512vbmi
     if "!X!" equ "ubsan"  set BUILD=!BUILD! -fsanitize=undefined
     if "!X:~0,1!" equ "-" set OTHER=!OTHER! %%x
   )
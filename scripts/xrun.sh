@@ -106,6 +106,8 @@ function xrun()
 
       RUN+=("qemu-${ARCH_VALUE}")
       [[ ${ARCH} == "rv64" ]] && RUN+=("-cpu rva23u64,vlen=128,elen=64,vext_spec=v1.0,rvv_ta_all_1s=true,rvv_ma_all_1s=true")
+      # max cpu has SVE and SVE2, set SVE_VL to vector length in bytes to test other than default 64
+      [[ ${ARCH} == "arm64" ]] && RUN+=("-cpu max${SVE_VL:+,sve-default-vector-length=${SVE_VL}}")
 
       ${RUN[0]} --version | head -1
     elif [[ ${SDE:-} != "" ]]; then
@@ -149,6 +151,8 @@ function xrun()
   arg "sse4"   && BUILD+=("-msse4.2")
   arg "avx2"   && BUILD+=("-mavx2 -mfma")
   arg "avx512" && BUILD+=("-mavx512f -mavx512cd -mavx512bw -mavx512dq -mavx512vl")
+  arg "avx512vbmi" && BUILD+=("-mavx512f -mavx512cd -mavx512bw -mavx512dq -mavx512vl -mavx512vbmi")
+  arg "sve"    && BUILD+=("-march=armv8.2-a+sve2")
   arg "ubsan"  && BUILD+=("-fsanitize=undefined")
   BUILD+=(${CFLAGS})
   BUILD+=(${INPUT})